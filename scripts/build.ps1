@@ -60,6 +60,9 @@ This script provides helpers for building msquic.
 .PARAMETER UseXdp
     Enables XDP support (Linux-only).
 
+.PARAMETER UseIoUring
+    Uses the io_uring socket datapath instead of epoll (Linux-only).
+
 .PARAMETER Generator
     Specifies a specific cmake generator (Only supported on unix)
 
@@ -172,6 +175,9 @@ param (
     [Parameter(Mandatory = $false)]
     [switch]$UseXdp = $false,
 
+    [Parameter(Mandatory = $false)]
+    [switch]$UseIoUring = $false,
+
     [Parameter(Mandatory = $false)]
     [string]$Generator = "",
 
@@ -277,6 +283,15 @@ if ($IsLinux -And $Arch -ne "x64") {
     }
 }
 
+if ($UseIoUring) {
+    if (!$IsLinux) {
+        Write-Error "io_uring is supported only on Linux"
+    }
+    if ($UseXdp) {
+        Write-Error "io_uring cannot be combined with XDP"
+    }
+}
+
 if ($Platform -eq "ios" -and !$Static) {
     $Static = $true
     Write-Host "iOS can only be built as static"
@@ -472,6 +487,9 @@ function CMake-Generate {
     if ($UseXdp) {
         $Arguments += " -DQUIC_LINUX_XDP_ENABLED=on"
     }
+    if ($UseIoUring) {
+        $Arguments += " -DQUIC_LINUX_IOURING_ENABLED=on"
+    }
     if ($Platform -eq "uwp") {
         $Arguments += " -DCMAKE_SYSTEM_NAME=WindowsStore -DCMAKE_SYSTEM_VERSION=10.0 -DQUIC_UWP_BUILD=on"
     }
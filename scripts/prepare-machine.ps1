@@ -76,6 +76,9 @@ param (
     [Parameter(Mandatory = $false)]
     [switch]$ForceXdpInstall,
 
+    [Parameter(Mandatory = $false)]
+    [switch]$UseIoUring,
+
     [Parameter(Mandatory = $false)]
     [switch]$InstallArm64Toolchain,
 
@@ -549,6 +552,11 @@ if ($IsLinux) {
             sudo apt-get -y install libxdp-dev libbpf-dev
             sudo apt-get -y install libnl-3-dev libnl-genl-3-dev libnl-route-3-dev zlib1g-dev zlib1g pkg-config m4 clang libpcap-dev libelf-dev
         }
+
+        # io_uring dependencies
+        if ($UseIoUring) {
+            sudo apt-get install -y liburing-dev
+        }
     }
 
     if ($ForTest) {
@@ -567,6 +575,9 @@ if ($IsLinux) {
             sudo apt-get install -y iproute2 iptables
             Install-DuoNic
         }
+        if ($UseIoUring) {
+            sudo apt-get install -y liburing2
+        }
 
         # Enable core dumps for the system.
         Write-Host "Setting core dump size limit"
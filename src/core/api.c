@@ -61,9 +61,15 @@ MsQuicConnectionOpen(
 #pragma prefast(suppress: __WARNING_25024, "Pointer cast already validated.")
     Registration = (QUIC_REGISTRATION*)RegistrationHandle;
 
+    //
+    // The datapath partitioning info is not known yet, so just use the current
+    // processor for now. Once the connection receives a packet the partition
+    // can be updated accordingly.
+    //
     Status =
         QuicConnAlloc(
             Registration,
+            QuicLibraryGetCurrentPartition(),
             NULL,
             NULL,
             &Connection);
@@ -990,56 +996,36 @@ Error:
     return Status;
 }
 
+//
+// Validates a send request and appends it to the stream's API send queue.
+// On success, QueueOper indicates whether the caller is responsible for
+// getting the queue flushed, i.e. no previous send is still waiting to be. If
+// that flush isn't going to be done inline, a stream operation reference is
+// taken for it.
+//
 _IRQL_requires_max_(DISPATCH_LEVEL)
+static
 QUIC_STATUS
-QUIC_API
-MsQuicStreamSend(
-    _In_ _Pre_defensive_ HQUIC Handle,
-    _In_reads_(BufferCount) _Pre_defensive_
+QuicStreamApiQueueSend(
+    _In_ QUIC_STREAM* Stream,
+    _In_reads_(BufferCount)
         const QUIC_BUFFER * const Buffers,
     _In_ uint32_t BufferCount,
     _In_ QUIC_SEND_FLAGS Flags,
-    _In_opt_ void* ClientSendContext
+    _In_opt_ void* ClientSendContext,
+    _In_ BOOLEAN SendInline,
+    _Out_ BOOLEAN* QueueOper
     )
 {
     QUIC_STATUS Status;
-    QUIC_STREAM* Stream;
-    QUIC_CONNECTION* Connection;
+    QUIC_CONNECTION* Connection = Stream->Connection;
     uint64_t TotalLength;
     QUIC_SEND_REQUEST* SendRequest;
-    BOOLEAN QueueOper = TRUE;
-    const BOOLEAN IsPriority = !!(Flags & QUIC_SEND_FLAG_PRIORITY_WORK);
-    BOOLEAN SendInline;
-    QUIC_OPERATION* Oper;
 
-    QuicTraceEvent(
-        ApiEnter,
-        "[ api] Enter %u (%p).",
-        QUIC_TRACE_API_STREAM_SEND,
-        Handle);
-
-    if (!IS_STREAM_HANDLE(Handle) ||
-        (Buffers == NULL && BufferCount != 0)) {
-        Status = QUIC_STATUS_INVALID_PARAMETER;
-        goto Exit;
-    }
-
-#pragma prefast(suppress: __WARNING_25024, "Pointer cast already validated.")
-    Stream = (QUIC_STREAM*)Handle;
-
-    CXPLAT_TEL_ASSERT(!Stream->Flags.HandleClosed);
-    CXPLAT_TEL_ASSERT(!Stream->Flags.Freed);
-
-    Connection = Stream->Connection;
-
-    QUIC_CONN_VERIFY(Connection, !Connection->State.Freed);
-    QUIC_CONN_VERIFY(Connection,
-        (Connection->WorkerThreadID == CxPlatCurThreadID()) ||
-        !Connection->State.HandleClosed);
+    *QueueOper = TRUE;
 
     if (Connection->State.ClosedRemotely) {
-        Status = QUIC_STATUS_ABORTED;
-        goto Exit;
+        return QUIC_STATUS_ABORTED;
     }
 
     TotalLength = 0;
@@ -1053,20 +1039,18 @@ MsQuicStreamSend(
             "[strm][%p] ERROR, %s.",
             Stream,
             "Send request total length exceeds max");
-        Status = QUIC_STATUS_INVALID_PARAMETER;
-        goto Exit;
+        return QUIC_STATUS_INVALID_PARAMETER;
     }
 
 #pragma prefast(suppress: __WARNING_6014, "Memory is correctly freed (QuicStreamCompleteSendRequest).")
     SendRequest = CxPlatPoolAlloc(&Connection->Worker->SendRequestPool);
     if (SendRequest == NULL) {
-        Status = QUIC_STATUS_OUT_OF_MEMORY;
         QuicTraceEvent(
             AllocFailure,
             "Allocation of '%s' failed. (%llu bytes)",
             "Stream Send request",
             0);
-        goto Exit;
+        return QUIC_STATUS_OUT_OF_MEMORY;
     }
 
     QuicTraceEvent(
@@ -1084,14 +1068,6 @@ MsQuicStreamSend(
     SendRequest->TotalLength = TotalLength;
     SendRequest->ClientContext = ClientSendContext;
 
-#pragma warning(push)
-#pragma warning(disable:6240) // CXPLAT_AT_DISPATCH only really does anything for kernel mode
-    SendInline =
-        !Connection->Settings.SendBufferingEnabled &&
-        !CXPLAT_AT_DISPATCH() && // Never run inline if at DISPATCH
-        Connection->WorkerThreadID == CxPlatCurThreadID();
-#pragma warning(pop)
-
     CxPlatDispatchLockAcquire(&Stream->ApiSendRequestLock);
     if (!Stream->Flags.SendEnabled) {
         Status =
@@ -1102,12 +1078,12 @@ MsQuicStreamSend(
         QUIC_SEND_REQUEST** ApiSendRequestsTail = &Stream->ApiSendRequests;
         while (*ApiSendRequestsTail != NULL) {
             ApiSendRequestsTail = &((*ApiSendRequestsTail)->Next);
-            QueueOper = FALSE; // Not necessary if the previous send hasn't been flushed yet.
+            *QueueOper = FALSE; // Not necessary if the previous send hasn't been flushed yet.
         }
         *ApiSendRequestsTail = SendRequest;
         Status = QUIC_STATUS_SUCCESS;
 
-        if (!SendInline && QueueOper) {
+        if (!SendInline && *QueueOper) {
             //
             // Async stream operations need to hold a ref on the stream so that
             // the stream isn't freed before the operation can be processed. The
@@ -1120,6 +1096,102 @@ MsQuicStreamSend(
 
     if (QUIC_FAILED(Status)) {
         CxPlatPoolFree(&Connection->Worker->SendRequestPool, SendRequest);
+    }
+
+    return Status;
+}
+
+//
+// Called when the operation to flush already queued sends couldn't be
+// allocated. The sends can't be failed at that point, so the whole connection
+// is aborted instead.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+static
+void
+QuicConnApiSendOperAllocFailure(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    if (InterlockedCompareExchange16(
+            (short*)&Connection->BackUpOperUsed, 1, 0) != 0) {
+        return; // It's already started the shutdown.
+    }
+    QUIC_OPERATION* Oper = &Connection->BackUpOper;
+    Oper->FreeAfterProcess = FALSE;
+    Oper->Type = QUIC_OPER_TYPE_API_CALL;
+    Oper->API_CALL.Context = &Connection->BackupApiContext;
+    Oper->API_CALL.Context->Type = QUIC_API_TYPE_CONN_SHUTDOWN;
+    Oper->API_CALL.Context->CONN_SHUTDOWN.Flags = QUIC_CONNECTION_SHUTDOWN_FLAG_SILENT;
+    Oper->API_CALL.Context->CONN_SHUTDOWN.ErrorCode = (QUIC_VAR_INT)QUIC_STATUS_OUT_OF_MEMORY;
+    Oper->API_CALL.Context->CONN_SHUTDOWN.RegistrationShutdown = FALSE;
+    Oper->API_CALL.Context->CONN_SHUTDOWN.TransportShutdown = TRUE;
+    QuicConnQueueHighestPriorityOper(Connection, Oper);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QUIC_API
+MsQuicStreamSend(
+    _In_ _Pre_defensive_ HQUIC Handle,
+    _In_reads_(BufferCount) _Pre_defensive_
+        const QUIC_BUFFER * const Buffers,
+    _In_ uint32_t BufferCount,
+    _In_ QUIC_SEND_FLAGS Flags,
+    _In_opt_ void* ClientSendContext
+    )
+{
+    QUIC_STATUS Status;
+    QUIC_STREAM* Stream;
+    QUIC_CONNECTION* Connection;
+    BOOLEAN QueueOper;
+    const BOOLEAN IsPriority = !!(Flags & QUIC_SEND_FLAG_PRIORITY_WORK);
+    BOOLEAN SendInline;
+    QUIC_OPERATION* Oper;
+
+    QuicTraceEvent(
+        ApiEnter,
+        "[ api] Enter %u (%p).",
+        QUIC_TRACE_API_STREAM_SEND,
+        Handle);
+
+    if (!IS_STREAM_HANDLE(Handle) ||
+        (Buffers == NULL && BufferCount != 0)) {
+        Status = QUIC_STATUS_INVALID_PARAMETER;
+        goto Exit;
+    }
+
+#pragma prefast(suppress: __WARNING_25024, "Pointer cast already validated.")
+    Stream = (QUIC_STREAM*)Handle;
+
+    CXPLAT_TEL_ASSERT(!Stream->Flags.HandleClosed);
+    CXPLAT_TEL_ASSERT(!Stream->Flags.Freed);
+
+    Connection = Stream->Connection;
+
+    QUIC_CONN_VERIFY(Connection, !Connection->State.Freed);
+    QUIC_CONN_VERIFY(Connection,
+        (Connection->WorkerThreadID == CxPlatCurThreadID()) ||
+        !Connection->State.HandleClosed);
+
+#pragma warning(push)
+#pragma warning(disable:6240) // CXPLAT_AT_DISPATCH only really does anything for kernel mode
+    SendInline =
+        !Connection->Settings.SendBufferingEnabled &&
+        !CXPLAT_AT_DISPATCH() && // Never run inline if at DISPATCH
+        Connection->WorkerThreadID == CxPlatCurThreadID();
+#pragma warning(pop)
+
+    Status =
+        QuicStreamApiQueueSend(
+            Stream,
+            Buffers,
+            BufferCount,
+            Flags,
+            ClientSendContext,
+            SendInline,
+            &QueueOper);
+    if (QUIC_FAILED(Status)) {
         goto Exit;
     }
 
@@ -1162,20 +1234,7 @@ MsQuicStreamSend(
             // the send above. So instead, we're just going to abort the whole
             // connection.
             //
-            if (InterlockedCompareExchange16(
-                    (short*)&Connection->BackUpOperUsed, 1, 0) != 0) {
-                goto Exit; // It's already started the shutdown.
-            }
-            Oper = &Connection->BackUpOper;
-            Oper->FreeAfterProcess = FALSE;
-            Oper->Type = QUIC_OPER_TYPE_API_CALL;
-            Oper->API_CALL.Context = &Connection->BackupApiContext;
-            Oper->API_CALL.Context->Type = QUIC_API_TYPE_CONN_SHUTDOWN;
-            Oper->API_CALL.Context->CONN_SHUTDOWN.Flags = QUIC_CONNECTION_SHUTDOWN_FLAG_SILENT;
-            Oper->API_CALL.Context->CONN_SHUTDOWN.ErrorCode = (QUIC_VAR_INT)QUIC_STATUS_OUT_OF_MEMORY;
-            Oper->API_CALL.Context->CONN_SHUTDOWN.RegistrationShutdown = FALSE;
-            Oper->API_CALL.Context->CONN_SHUTDOWN.TransportShutdown = TRUE;
-            QuicConnQueueHighestPriorityOper(Connection, Oper);
+            QuicConnApiSendOperAllocFailure(Connection);
             goto Exit;
         }
 
@@ -1351,6 +1410,133 @@ Exit:
         "[ api] Exit");
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QUIC_API
+MsQuicStreamProvideReceiveBuffers(
+    _In_ _Pre_defensive_ HQUIC Handle,
+    _In_ uint32_t BufferCount,
+    _In_reads_(BufferCount) _Pre_defensive_
+        const QUIC_BUFFER* Buffers
+    )
+{
+    QUIC_STATUS Status;
+    QUIC_STREAM* Stream;
+    QUIC_CONNECTION* Connection;
+    QUIC_OPERATION* Oper;
+    CXPLAT_LIST_ENTRY ChunkList;
+
+    CxPlatListInitializeHead(&ChunkList);
+
+    QuicTraceEvent(
+        ApiEnter,
+        "[ api] Enter %u (%p).",
+        QUIC_TRACE_API_STREAM_PROVIDE_RECEIVE_BUFFERS,
+        Handle);
+
+    if (!IS_STREAM_HANDLE(Handle) ||
+        Buffers == NULL ||
+        BufferCount == 0) {
+        Status = QUIC_STATUS_INVALID_PARAMETER;
+        goto Error;
+    }
+
+    for (uint32_t i = 0; i < BufferCount; ++i) {
+        if (Buffers[i].Buffer == NULL ||
+            Buffers[i].Length == 0 ||
+            Buffers[i].Length > INT32_MAX) { // Must fit in QUIC_RECV_CHUNK's AllocLength
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            goto Error;
+        }
+    }
+
+#pragma prefast(suppress: __WARNING_25024, "Pointer cast already validated.")
+    Stream = (QUIC_STREAM*)Handle;
+
+    CXPLAT_TEL_ASSERT(!Stream->Flags.HandleClosed);
+    CXPLAT_TEL_ASSERT(!Stream->Flags.Freed);
+
+    Connection = Stream->Connection;
+
+    QUIC_CONN_VERIFY(Connection, !Connection->State.Freed);
+    QUIC_CONN_VERIFY(Connection,
+        (Connection->WorkerThreadID == CxPlatCurThreadID()) ||
+        !Connection->State.HandleClosed);
+
+    //
+    // Wrap each of the app's buffers in a chunk now, so that adding them to the
+    // stream's receive buffer can't fail on allocation later.
+    //
+    for (uint32_t i = 0; i < BufferCount; ++i) {
+        QUIC_RECV_CHUNK* Chunk =
+            CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_RECV_CHUNK), QUIC_POOL_RECVBUF);
+        if (Chunk == NULL) {
+            Status = QUIC_STATUS_OUT_OF_MEMORY;
+            QuicTraceEvent(
+                AllocFailure,
+                "Allocation of '%s' failed. (%llu bytes)",
+                "Provided receive buffer chunk",
+                sizeof(QUIC_RECV_CHUNK));
+            goto Error;
+        }
+        QuicRecvChunkInitialize(Chunk, Buffers[i].Length, Buffers[i].Buffer);
+        CxPlatListInsertTail(&ChunkList, &Chunk->Link);
+    }
+
+    if (Connection->WorkerThreadID == CxPlatCurThreadID()) {
+        //
+        // Execute inline if called on the worker thread, most likely from a
+        // QUIC_STREAM_EVENT_RECEIVE_BUFFER_NEEDED event.
+        //
+        Status = QuicStreamProvideRecvBuffers(Stream, &ChunkList);
+        goto Error;
+    }
+
+    Oper = QuicOperationAlloc(Connection->Worker, QUIC_OPER_TYPE_API_CALL);
+    if (Oper == NULL) {
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "STRM_PROVIDE_RECV_BUFFERS, operation",
+            0);
+        goto Error;
+    }
+    Oper->API_CALL.Context->Type = QUIC_API_TYPE_STRM_PROVIDE_RECV_BUFFERS;
+    Oper->API_CALL.Context->STRM_PROVIDE_RECV_BUFFERS.Stream = Stream;
+    CxPlatListInitializeHead(&Oper->API_CALL.Context->STRM_PROVIDE_RECV_BUFFERS.Chunks);
+    CxPlatListMoveItems(&ChunkList, &Oper->API_CALL.Context->STRM_PROVIDE_RECV_BUFFERS.Chunks);
+
+    //
+    // Async stream operations need to hold a ref on the stream so that the
+    // stream isn't freed before the operation can be processed. The ref is
+    // released after the operation is processed.
+    //
+    QuicStreamAddRef(Stream, QUIC_STREAM_REF_OPERATION);
+
+    //
+    // Queue the operation but don't wait for the completion.
+    //
+    QuicConnQueueOper(Connection, Oper);
+    Status = QUIC_STATUS_PENDING;
+
+Error:
+
+    while (!CxPlatListIsEmpty(&ChunkList)) {
+        CXPLAT_FREE(
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&ChunkList), QUIC_RECV_CHUNK, Link),
+            QUIC_POOL_RECVBUF);
+    }
+
+    QuicTraceEvent(
+        ApiExitStatus,
+        "[ api] Exit %u",
+        Status);
+
+    return Status;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QUIC_API
@@ -1600,6 +1786,56 @@ Error:
     return Status;
 }
 
+//
+// Validates and allocates the send request for an app datagram send.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+static
+QUIC_STATUS
+QuicDatagramApiAllocSendRequest(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_reads_(BufferCount)
+        const QUIC_BUFFER* const Buffers,
+    _In_ uint32_t BufferCount,
+    _In_ QUIC_SEND_FLAGS Flags,
+    _In_opt_ void* ClientSendContext,
+    _Outptr_ QUIC_SEND_REQUEST** NewSendRequest
+    )
+{
+    uint64_t TotalLength;
+    QUIC_SEND_REQUEST* SendRequest;
+
+    TotalLength = 0;
+    for (uint32_t i = 0; i < BufferCount; ++i) {
+        TotalLength += Buffers[i].Length;
+    }
+
+    if (TotalLength > UINT16_MAX) {
+        QuicTraceEvent(
+            ConnError,
+            "[conn][%p] ERROR, %s.",
+            Connection,
+            "Send request total length exceeds max");
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+
+#pragma prefast(suppress: __WARNING_6014, "Memory is correctly freed (...).")
+    SendRequest = CxPlatPoolAlloc(&Connection->Worker->SendRequestPool);
+    if (SendRequest == NULL) {
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+
+    SendRequest->Next = NULL;
+    SendRequest->Buffers = Buffers;
+    SendRequest->BufferCount = BufferCount;
+    SendRequest->Flags = Flags;
+    SendRequest->TotalLength = TotalLength;
+    SendRequest->ClientContext = ClientSendContext;
+
+    *NewSendRequest = SendRequest;
+    return QUIC_STATUS_SUCCESS;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 QUIC_API
@@ -1614,7 +1850,6 @@ MsQuicDatagramSend(
 {
     QUIC_STATUS Status;
     QUIC_CONNECTION* Connection;
-    uint64_t TotalLength;
     QUIC_SEND_REQUEST* SendRequest;
 
     QuicTraceEvent(
@@ -1635,38 +1870,222 @@ MsQuicDatagramSend(
 
     CXPLAT_TEL_ASSERT(!Connection->State.Freed);
 
-    TotalLength = 0;
-    for (uint32_t i = 0; i < BufferCount; ++i) {
-        TotalLength += Buffers[i].Length;
+    Status =
+        QuicDatagramApiAllocSendRequest(
+            Connection,
+            Buffers,
+            BufferCount,
+            Flags,
+            ClientSendContext,
+            &SendRequest);
+    if (QUIC_FAILED(Status)) {
+        goto Error;
     }
 
-    if (TotalLength > UINT16_MAX) {
-        QuicTraceEvent(
-            ConnError,
-            "[conn][%p] ERROR, %s.",
-            Connection,
-            "Send request total length exceeds max");
+    Status = QuicDatagramQueueSend(&Connection->Datagram, SendRequest);
+
+Error:
+
+    QuicTraceEvent(
+        ApiExitStatus,
+        "[ api] Exit %u",
+        Status);
+
+    return Status;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QUIC_API
+MsQuicConnectionSendBatch(
+    _In_ _Pre_defensive_ HQUIC Handle,
+    _Inout_updates_(EntryCount) _Pre_defensive_
+        QUIC_SEND_BATCH_ENTRY* Entries,
+    _In_ uint32_t EntryCount
+    )
+{
+    QUIC_STATUS Status;
+    QUIC_CONNECTION* Connection;
+    QUIC_STREAM** FlushStreams = NULL;
+    uint32_t FlushStreamCount = 0;
+    BOOLEAN FlushDatagrams = FALSE;
+    BOOLEAN IsPriority = FALSE;
+    BOOLEAN SendInline;
+    QUIC_OPERATION* Oper;
+
+    QuicTraceEvent(
+        ApiEnter,
+        "[ api] Enter %u (%p).",
+        QUIC_TRACE_API_CONNECTION_SEND_BATCH,
+        Handle);
+
+    if (!IS_CONN_HANDLE(Handle) ||
+        Entries == NULL ||
+        EntryCount == 0) {
         Status = QUIC_STATUS_INVALID_PARAMETER;
-        goto Error;
+        goto Exit;
     }
 
-#pragma prefast(suppress: __WARNING_6014, "Memory is correctly freed (...).")
-    SendRequest = CxPlatPoolAlloc(&Connection->Worker->SendRequestPool);
-    if (SendRequest == NULL) {
+#pragma prefast(suppress: __WARNING_25024, "Pointer cast already validated.")
+    Connection = (QUIC_CONNECTION*)Handle;
+
+    QUIC_CONN_VERIFY(Connection, !Connection->State.Freed);
+
+    FlushStreams =
+        CXPLAT_ALLOC_NONPAGED(
+            sizeof(QUIC_STREAM*) * EntryCount,
+            QUIC_POOL_SEND_BATCH);
+    if (FlushStreams == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "Send batch streams",
+            sizeof(QUIC_STREAM*) * EntryCount);
         Status = QUIC_STATUS_OUT_OF_MEMORY;
-        goto Error;
+        goto Exit;
     }
 
-    SendRequest->Next = NULL;
-    SendRequest->Buffers = Buffers;
-    SendRequest->BufferCount = BufferCount;
-    SendRequest->Flags = Flags;
-    SendRequest->TotalLength = TotalLength;
-    SendRequest->ClientContext = ClientSendContext;
+#pragma warning(push)
+#pragma warning(disable:6240) // CXPLAT_AT_DISPATCH only really does anything for kernel mode
+    SendInline =
+        !Connection->Settings.SendBufferingEnabled &&
+        !CXPLAT_AT_DISPATCH() && // Never run inline if at DISPATCH
+        Connection->WorkerThreadID == CxPlatCurThreadID();
+#pragma warning(pop)
 
-    Status = QuicDatagramQueueSend(&Connection->Datagram, SendRequest);
+    //
+    // Queue every entry on its stream (or the datagram queue), remembering the
+    // queues that were empty, as those need to be flushed by this call.
+    //
+    Status = QUIC_STATUS_PENDING;
+    for (uint32_t i = 0; i < EntryCount; ++i) {
+        QUIC_SEND_BATCH_ENTRY* Entry = &Entries[i];
+        QUIC_STATUS EntryStatus;
+        BOOLEAN QueueOper = FALSE;
+
+        if (Entry->Buffers == NULL && Entry->BufferCount != 0) {
+            EntryStatus = QUIC_STATUS_INVALID_PARAMETER;
+
+        } else if (Entry->Stream == NULL) {
+            QUIC_SEND_REQUEST* SendRequest;
+            if (Entry->BufferCount == 0) {
+                EntryStatus = QUIC_STATUS_INVALID_PARAMETER;
+            } else {
+                EntryStatus =
+                    QuicDatagramApiAllocSendRequest(
+                        Connection,
+                        Entry->Buffers,
+                        Entry->BufferCount,
+                        Entry->Flags,
+                        Entry->ClientSendContext,
+                        &SendRequest);
+                if (QUIC_SUCCEEDED(EntryStatus)) {
+                    EntryStatus =
+                        QuicDatagramEnqueueSend(
+                            &Connection->Datagram, SendRequest, &QueueOper);
+                }
+            }
+            if (QUIC_SUCCEEDED(EntryStatus) && QueueOper) {
+                FlushDatagrams = TRUE;
+            }
 
-Error:
+        } else if (!IS_STREAM_HANDLE(Entry->Stream) ||
+            ((QUIC_STREAM*)Entry->Stream)->Connection != Connection) {
+            EntryStatus = QUIC_STATUS_INVALID_PARAMETER;
+
+        } else {
+#pragma prefast(suppress: __WARNING_25024, "Pointer cast already validated.")
+            QUIC_STREAM* Stream = (QUIC_STREAM*)Entry->Stream;
+            CXPLAT_TEL_ASSERT(!Stream->Flags.HandleClosed);
+            CXPLAT_TEL_ASSERT(!Stream->Flags.Freed);
+            EntryStatus =
+                QuicStreamApiQueueSend(
+                    Stream,
+                    Entry->Buffers,
+                    Entry->BufferCount,
+                    Entry->Flags,
+                    Entry->ClientSendContext,
+                    SendInline,
+                    &QueueOper);
+            if (QUIC_SUCCEEDED(EntryStatus) && QueueOper) {
+                FlushStreams[FlushStreamCount++] = Stream;
+            }
+        }
+
+        if (QUIC_SUCCEEDED(EntryStatus)) {
+            Entry->Status = QUIC_STATUS_PENDING;
+            if (Entry->Flags & QUIC_SEND_FLAG_PRIORITY_WORK) {
+                IsPriority = TRUE;
+            }
+        } else {
+            Entry->Status = EntryStatus;
+            if (Status == QUIC_STATUS_PENDING) {
+                Status = EntryStatus; // Return the first failure.
+            }
+        }
+    }
+
+    if (FlushStreamCount == 0 && !FlushDatagrams) {
+        goto Exit;
+    }
+
+    if (SendInline) {
+
+        CXPLAT_PASSIVE_CODE();
+
+        BOOLEAN AlreadyInline = Connection->State.InlineApiExecution;
+        if (!AlreadyInline) {
+            Connection->State.InlineApiExecution = TRUE;
+        }
+        for (uint32_t i = 0; i < FlushStreamCount; ++i) {
+            QuicStreamSendFlush(FlushStreams[i]);
+        }
+        if (FlushDatagrams) {
+            QuicDatagramSendFlush(&Connection->Datagram);
+        }
+        if (!AlreadyInline) {
+            Connection->State.InlineApiExecution = FALSE;
+        }
+        goto Exit;
+    }
+
+    Oper = QuicOperationAlloc(Connection->Worker, QUIC_OPER_TYPE_API_CALL);
+    if (Oper == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "CONN_SEND_BATCH operation",
+            0);
+        for (uint32_t i = 0; i < FlushStreamCount; ++i) {
+            QuicStreamRelease(FlushStreams[i], QUIC_STREAM_REF_OPERATION);
+        }
+        QuicConnApiSendOperAllocFailure(Connection);
+        goto Exit;
+    }
+
+    //
+    // The operation takes ownership of the streams (and their references).
+    //
+    Oper->API_CALL.Context->Type = QUIC_API_TYPE_CONN_SEND_BATCH;
+    Oper->API_CALL.Context->CONN_SEND_BATCH.Streams = FlushStreams;
+    Oper->API_CALL.Context->CONN_SEND_BATCH.StreamCount = FlushStreamCount;
+    Oper->API_CALL.Context->CONN_SEND_BATCH.FlushDatagrams = FlushDatagrams;
+    FlushStreams = NULL;
+
+    //
+    // Queue the operation but don't wait for the completion.
+    //
+    if (IsPriority) {
+        QuicConnQueuePriorityOper(Connection, Oper);
+    } else {
+        QuicConnQueueOper(Connection, Oper);
+    }
+
+Exit:
+
+    if (FlushStreams != NULL) {
+        CXPLAT_FREE(FlushStreams, QUIC_POOL_SEND_BATCH);
+    }
 
     QuicTraceEvent(
         ApiExitStatus,
@@ -224,6 +224,25 @@ MsQuicStreamReceiveSetEnabled(
     _In_ BOOLEAN IsEnabled
     );
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QUIC_API
+MsQuicStreamProvideReceiveBuffers(
+    _In_ _Pre_defensive_ HQUIC Stream,
+    _In_ uint32_t BufferCount,
+    _In_reads_(BufferCount) _Pre_defensive_
+        const QUIC_BUFFER* Buffers
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QUIC_API
+MsQuicConnectionPoolCreate(
+    _In_ _Pre_defensive_ const QUIC_CONNECTION_POOL_CONFIG* Config,
+    _Out_writes_(Config->NumberOfConnections) _Pre_defensive_
+        HQUIC* ConnectionPool
+    );
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QUIC_API
@@ -262,6 +281,16 @@ MsQuicDatagramSend(
     _In_opt_ void* ClientSendContext
     );
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QUIC_API
+MsQuicConnectionSendBatch(
+    _In_ _Pre_defensive_ HQUIC Handle,
+    _Inout_updates_(EntryCount) _Pre_defensive_
+        QUIC_SEND_BATCH_ENTRY* Entries,
+    _In_ uint32_t EntryCount
+    );
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 QUIC_API
@@ -0,0 +1,518 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Adapts the application provided congestion control callbacks set via
+    QUIC_PARAM_CONFIGURATION_CONGESTION_CONTROL to the internal congestion
+    control interface. MsQuic keeps track of bytes in flight, exemptions and
+    the blocked state, while the application decides the congestion window and
+    the pacing rate.
+
+--*/
+
+#include "precomp.h"
+#ifdef QUIC_CLOG
+#include "app_congestion_control.c.clog.h"
+#endif
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+AppCongestionControlGetCongestionWindow(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONGESTION_CONTROL_APP* App = &Cc->App;
+    return App->Callbacks->GetCongestionWindow(App->Callbacks->Context, App->State);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+AppCongestionControlCanSend(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_APP* App = &Cc->App;
+    return
+        App->BytesInFlight < AppCongestionControlGetCongestionWindow(Cc) ||
+        App->Exemptions > 0;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+AppCongestionControlSetExemption(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint8_t NumPackets
+    )
+{
+    Cc->App.Exemptions = NumPackets;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+AppCongestionControlReset(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ BOOLEAN FullReset
+    )
+{
+    QUIC_CONGESTION_CONTROL_APP* App = &Cc->App;
+
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    QUIC_CONGESTION_CONTROL_RESET_INFO Info;
+    Info.InitialWindowPackets = App->InitialWindowPackets;
+    Info.SendIdleTimeoutMs = App->SendIdleTimeoutMs;
+    Info.DatagramPayloadLength =
+        QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+    Info.FullReset = FullReset;
+
+    App->LastSendAllowance = 0;
+    App->HasHadCongestionEvent = FALSE;
+    if (FullReset) {
+        App->BytesInFlight = 0;
+    }
+    App->Callbacks->Reset(App->Callbacks->Context, App->State, &Info);
+    App->BytesInFlightMax = AppCongestionControlGetCongestionWindow(Cc) / 2;
+
+    QuicConnLogOutFlowStats(Connection);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+AppCongestionControlGetSendAllowance(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeSinceLastSend, // microsec
+    _In_ BOOLEAN TimeSinceLastSendValid
+    )
+{
+    QUIC_CONGESTION_CONTROL_APP* App = &Cc->App;
+
+    uint32_t SendAllowance;
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    const uint32_t CongestionWindow = AppCongestionControlGetCongestionWindow(Cc);
+    const uint64_t PacingRate =
+        App->Callbacks->GetPacingRate == NULL ?
+            0 : App->Callbacks->GetPacingRate(App->Callbacks->Context, App->State);
+
+    if (App->BytesInFlight >= CongestionWindow) {
+        //
+        // We are CC blocked, so we can't send anything.
+        //
+        SendAllowance = 0;
+
+    } else if (
+        PacingRate == 0 ||
+        !TimeSinceLastSendValid ||
+        !Connection->Settings.PacingEnabled ||
+        !Connection->Paths[0].GotFirstRttSample ||
+        Connection->Paths[0].SmoothedRtt < QUIC_MIN_PACING_RTT) {
+        //
+        // The controller doesn't want pacing or we're not in the necessary
+        // state to pace.
+        //
+        SendAllowance = CongestionWindow - App->BytesInFlight;
+
+    } else {
+        //
+        // We are pacing, so the send allowance is the time since the last send
+        // times the pacing rate the controller asked for, plus whatever was
+        // left over from the last send.
+        //
+        SendAllowance =
+            App->LastSendAllowance +
+            (uint32_t)((PacingRate * TimeSinceLastSend) / 1000000);
+        if (SendAllowance < App->LastSendAllowance || // Overflow case
+            SendAllowance > (CongestionWindow - App->BytesInFlight)) {
+            SendAllowance = CongestionWindow - App->BytesInFlight;
+        }
+
+        App->LastSendAllowance = SendAllowance;
+    }
+    return SendAllowance;
+}
+
+//
+// Returns TRUE if we became unblocked.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+AppCongestionControlUpdateBlockedState(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ BOOLEAN PreviousCanSendState
+    )
+{
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    QuicConnLogOutFlowStats(Connection);
+    if (PreviousCanSendState != AppCongestionControlCanSend(Cc)) {
+        if (PreviousCanSendState) {
+            QuicConnAddOutFlowBlockedReason(
+                Connection, QUIC_FLOW_BLOCKED_CONGESTION_CONTROL);
+        } else {
+            QuicConnRemoveOutFlowBlockedReason(
+                Connection, QUIC_FLOW_BLOCKED_CONGESTION_CONTROL);
+            Connection->Send.LastFlushTime = CxPlatTimeUs64(); // Reset last flush time
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+AppCongestionControlOnDataSent(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t NumRetransmittableBytes
+    )
+{
+    QUIC_CONGESTION_CONTROL_APP* App = &Cc->App;
+
+    BOOLEAN PreviousCanSendState = AppCongestionControlCanSend(Cc);
+
+    App->BytesInFlight += NumRetransmittableBytes;
+    if (App->BytesInFlightMax < App->BytesInFlight) {
+        App->BytesInFlightMax = App->BytesInFlight;
+        QuicSendBufferConnectionAdjust(QuicCongestionControlGetConnection(Cc));
+    }
+
+    if (NumRetransmittableBytes > App->LastSendAllowance) {
+        App->LastSendAllowance = 0;
+    } else {
+        App->LastSendAllowance -= NumRetransmittableBytes;
+    }
+
+    if (App->Exemptions > 0) {
+        --App->Exemptions;
+    }
+
+    if (App->Callbacks->OnDataSent != NULL) {
+        App->Callbacks->OnDataSent(
+            App->Callbacks->Context,
+            App->State,
+            NumRetransmittableBytes,
+            App->BytesInFlight);
+    }
+
+    AppCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+AppCongestionControlOnDataInvalidated(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t NumRetransmittableBytes
+    )
+{
+    QUIC_CONGESTION_CONTROL_APP* App = &Cc->App;
+
+    BOOLEAN PreviousCanSendState = AppCongestionControlCanSend(Cc);
+
+    CXPLAT_DBG_ASSERT(App->BytesInFlight >= NumRetransmittableBytes);
+    App->BytesInFlight -= NumRetransmittableBytes;
+
+    return AppCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+AppCongestionControlOnDataAcknowledged(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_ACK_EVENT* AckEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_APP* App = &Cc->App;
+
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    const QUIC_PATH* Path = &Connection->Paths[0];
+    BOOLEAN PreviousCanSendState = AppCongestionControlCanSend(Cc);
+
+    CXPLAT_DBG_ASSERT(App->BytesInFlight >= AckEvent->NumRetransmittableBytes);
+    App->BytesInFlight -= AckEvent->NumRetransmittableBytes;
+
+    QUIC_CONGESTION_CONTROL_ACK_INFO Info;
+    CxPlatZeroMemory(&Info, sizeof(Info));
+    Info.TimeNow = AckEvent->TimeNow;
+    Info.LargestAck = AckEvent->LargestAck;
+    Info.LargestSentPacketNumber = AckEvent->LargestSentPacketNumber;
+    Info.TotalAckedBytes = AckEvent->NumTotalAckedRetransmittableBytes;
+    Info.SmoothedRtt = AckEvent->SmoothedRtt;
+    Info.MinRtt = Path->MinRtt;
+    Info.RttSample = AckEvent->MinRtt;
+    Info.RttSampleValid = AckEvent->MinRttValid;
+    Info.OneWayDelay = AckEvent->OneWayDelay;
+    Info.AckedBytes = AckEvent->NumRetransmittableBytes;
+    Info.BytesInFlight = App->BytesInFlight;
+    Info.DatagramPayloadLength = QuicPathGetDatagramPayloadSize(Path);
+    Info.IsImplicit = AckEvent->IsImplicit;
+    Info.HasLoss = AckEvent->HasLoss;
+    Info.IsAppLimited = AckEvent->IsLargestAckedPacketAppLimited;
+
+    //
+    // Use the max delivery rate sample of the newly acknowledged packets, the
+    // same way BBR feeds its bandwidth filter.
+    //
+    if (!AckEvent->IsImplicit) {
+        const QUIC_SENT_PACKET_METADATA* AckedPacket = AckEvent->AckedPackets;
+        for (; AckedPacket != NULL; AckedPacket = AckedPacket->Next) {
+            uint64_t DeliveryRate;
+            if (AckedPacket->PacketLength != 0 &&
+                BbrGetDeliveryRate(AckedPacket, AckEvent, &DeliveryRate) &&
+                DeliveryRate / BW_UNIT > Info.DeliveryRate) {
+                Info.DeliveryRate = DeliveryRate / BW_UNIT;
+                Info.DeliveryRateValid = TRUE;
+            }
+        }
+    }
+
+    App->Callbacks->OnDataAcknowledged(App->Callbacks->Context, App->State, &Info);
+
+    if (Connection->Settings.NetStatsEventEnabled) {
+        const uint32_t CongestionWindow = AppCongestionControlGetCongestionWindow(Cc);
+        QUIC_CONNECTION_EVENT Event;
+        Event.Type = QUIC_CONNECTION_EVENT_NETWORK_STATISTICS;
+        Event.NETWORK_STATISTICS.BytesInFlight = App->BytesInFlight;
+        Event.NETWORK_STATISTICS.PostedBytes = Connection->SendBuffer.PostedBytes;
+        Event.NETWORK_STATISTICS.IdealBytes = Connection->SendBuffer.IdealBytes;
+        Event.NETWORK_STATISTICS.SmoothedRTT = Path->SmoothedRtt;
+        Event.NETWORK_STATISTICS.CongestionWindow = CongestionWindow;
+        Event.NETWORK_STATISTICS.Bandwidth = CongestionWindow / Path->SmoothedRtt;
+
+        QuicTraceLogConnVerbose(
+           IndicateDataAcked,
+           Connection,
+           "Indicating QUIC_CONNECTION_EVENT_NETWORK_STATISTICS [BytesInFlight=%u,PostedBytes=%llu,IdealBytes=%llu,SmoothedRTT=%llu,CongestionWindow=%u,Bandwidth=%llu]",
+           Event.NETWORK_STATISTICS.BytesInFlight,
+           Event.NETWORK_STATISTICS.PostedBytes,
+           Event.NETWORK_STATISTICS.IdealBytes,
+           Event.NETWORK_STATISTICS.SmoothedRTT,
+           Event.NETWORK_STATISTICS.CongestionWindow,
+           Event.NETWORK_STATISTICS.Bandwidth);
+       QuicConnIndicateEvent(Connection, &Event);
+    }
+
+    return AppCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+AppCongestionControlOnDataLost(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_LOSS_EVENT* LossEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_APP* App = &Cc->App;
+
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    BOOLEAN PreviousCanSendState = AppCongestionControlCanSend(Cc);
+
+    if (!App->HasHadCongestionEvent ||
+        LossEvent->LargestPacketNumberLost > App->RecoverySentPacketNumber) {
+        App->HasHadCongestionEvent = TRUE;
+        App->RecoverySentPacketNumber = LossEvent->LargestSentPacketNumber;
+        QuicTraceEvent(
+            ConnCongestionV2,
+            "[conn][%p] Congestion event: IsEcn=%hu",
+            Connection,
+            FALSE);
+        Connection->Stats.Send.CongestionCount++;
+    }
+
+    if (LossEvent->PersistentCongestion) {
+        QuicTraceEvent(
+            ConnPersistentCongestion,
+            "[conn][%p] Persistent congestion event",
+            Connection);
+        Connection->Stats.Send.PersistentCongestionCount++;
+
+        Connection->Paths[0].Route.State = RouteSuspected; // used only for RAW datapath
+    }
+
+    CXPLAT_DBG_ASSERT(App->BytesInFlight >= LossEvent->NumRetransmittableBytes);
+    App->BytesInFlight -= LossEvent->NumRetransmittableBytes;
+
+    QUIC_CONGESTION_CONTROL_LOSS_INFO Info;
+    CxPlatZeroMemory(&Info, sizeof(Info));
+    Info.LargestPacketNumberLost = LossEvent->LargestPacketNumberLost;
+    Info.LargestSentPacketNumber = LossEvent->LargestSentPacketNumber;
+    Info.LostBytes = LossEvent->NumRetransmittableBytes;
+    Info.BytesInFlight = App->BytesInFlight;
+    Info.DatagramPayloadLength =
+        QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+    Info.PersistentCongestion = LossEvent->PersistentCongestion;
+
+    App->Callbacks->OnDataLost(App->Callbacks->Context, App->State, &Info);
+
+    AppCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+AppCongestionControlOnEcn(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_ECN_EVENT* EcnEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_APP* App = &Cc->App;
+
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    BOOLEAN PreviousCanSendState = AppCongestionControlCanSend(Cc);
+
+    if (!App->HasHadCongestionEvent ||
+        EcnEvent->LargestPacketNumberAcked > App->RecoverySentPacketNumber) {
+        App->HasHadCongestionEvent = TRUE;
+        App->RecoverySentPacketNumber = EcnEvent->LargestSentPacketNumber;
+        QuicTraceEvent(
+            ConnCongestionV2,
+            "[conn][%p] Congestion event: IsEcn=%hu",
+            Connection,
+            TRUE);
+        Connection->Stats.Send.CongestionCount++;
+        Connection->Stats.Send.EcnCongestionCount++;
+    }
+
+    if (App->Callbacks->OnEcn != NULL) {
+        QUIC_CONGESTION_CONTROL_ECN_INFO Info;
+        CxPlatZeroMemory(&Info, sizeof(Info));
+        Info.LargestPacketNumberAcked = EcnEvent->LargestPacketNumberAcked;
+        Info.LargestSentPacketNumber = EcnEvent->LargestSentPacketNumber;
+        Info.NewCeCount = EcnEvent->NewCeCount;
+        Info.BytesInFlight = App->BytesInFlight;
+        Info.DatagramPayloadLength =
+            QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+
+        App->Callbacks->OnEcn(App->Callbacks->Context, App->State, &Info);
+    }
+
+    AppCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+AppCongestionControlOnSpuriousCongestionEvent(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_APP* App = &Cc->App;
+
+    if (App->Callbacks->OnSpuriousLoss == NULL) {
+        return FALSE;
+    }
+
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    BOOLEAN PreviousCanSendState = AppCongestionControlCanSend(Cc);
+
+    if (!App->Callbacks->OnSpuriousLoss(App->Callbacks->Context, App->State)) {
+        return FALSE;
+    }
+
+    QuicTraceEvent(
+        ConnSpuriousCongestion,
+        "[conn][%p] Spurious congestion event",
+        Connection);
+
+    return AppCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+void
+AppCongestionControlLogOutFlowStatus(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    const QUIC_PATH* Path = &Connection->Paths[0];
+    const QUIC_CONGESTION_CONTROL_APP* App = &Cc->App;
+
+    QuicTraceEvent(
+        ConnOutFlowStatsV2,
+        "[conn][%p] OUT: BytesSent=%llu InFlight=%u CWnd=%u ConnFC=%llu ISB=%llu PostedBytes=%llu SRtt=%llu 1Way=%llu",
+        Connection,
+        Connection->Stats.Send.TotalBytes,
+        App->BytesInFlight,
+        AppCongestionControlGetCongestionWindow(Cc),
+        Connection->Send.PeerMaxData - Connection->Send.OrderedStreamBytesSent,
+        Connection->SendBuffer.IdealBytes,
+        Connection->SendBuffer.PostedBytes,
+        Path->GotFirstRttSample ? Path->SmoothedRtt : 0,
+        Path->OneWayDelay);
+}
+
+uint32_t
+AppCongestionControlGetBytesInFlightMax(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->App.BytesInFlightMax;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint8_t
+AppCongestionControlGetExemptions(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->App.Exemptions;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+AppCongestionControlIsAppLimited(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    UNREFERENCED_PARAMETER(Cc);
+    return FALSE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+AppCongestionControlSetAppLimited(
+    _In_ struct QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    UNREFERENCED_PARAMETER(Cc);
+}
+
+static const QUIC_CONGESTION_CONTROL QuicCongestionControlApp = {
+    .Name = "App",
+    .QuicCongestionControlCanSend = AppCongestionControlCanSend,
+    .QuicCongestionControlSetExemption = AppCongestionControlSetExemption,
+    .QuicCongestionControlReset = AppCongestionControlReset,
+    .QuicCongestionControlGetSendAllowance = AppCongestionControlGetSendAllowance,
+    .QuicCongestionControlOnDataSent = AppCongestionControlOnDataSent,
+    .QuicCongestionControlOnDataInvalidated = AppCongestionControlOnDataInvalidated,
+    .QuicCongestionControlOnDataAcknowledged = AppCongestionControlOnDataAcknowledged,
+    .QuicCongestionControlOnDataLost = AppCongestionControlOnDataLost,
+    .QuicCongestionControlOnEcn = AppCongestionControlOnEcn,
+    .QuicCongestionControlOnSpuriousCongestionEvent = AppCongestionControlOnSpuriousCongestionEvent,
+    .QuicCongestionControlLogOutFlowStatus = AppCongestionControlLogOutFlowStatus,
+    .QuicCongestionControlGetExemptions = AppCongestionControlGetExemptions,
+    .QuicCongestionControlGetBytesInFlightMax = AppCongestionControlGetBytesInFlightMax,
+    .QuicCongestionControlIsAppLimited = AppCongestionControlIsAppLimited,
+    .QuicCongestionControlSetAppLimited = AppCongestionControlSetAppLimited,
+    .QuicCongestionControlGetCongestionWindow = AppCongestionControlGetCongestionWindow,
+};
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+AppCongestionControlInitialize(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_SETTINGS_INTERNAL* Settings,
+    _In_ const QUIC_CONGESTION_CONTROL_CALLBACKS* Callbacks
+    )
+{
+    *Cc = QuicCongestionControlApp;
+
+    QUIC_CONGESTION_CONTROL_APP* App = &Cc->App;
+    App->Callbacks = Callbacks;
+    App->InitialWindowPackets = Settings->InitialWindowPackets;
+    App->SendIdleTimeoutMs = Settings->SendIdleTimeoutMs;
+
+    //
+    // Only the part of the state the controller asked for is handed to it, so
+    // that is all that needs zeroing.
+    //
+    CXPLAT_DBG_ASSERT(Callbacks->StateSize <= sizeof(App->State));
+    CxPlatZeroMemory(App->State, Callbacks->StateSize);
+
+    AppCongestionControlReset(Cc, TRUE);
+}
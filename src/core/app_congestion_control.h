@@ -0,0 +1,62 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+--*/
+
+#pragma once
+
+//
+// Adapts an application provided QUIC_CONGESTION_CONTROL_CALLBACKS to the
+// internal congestion control interface.
+//
+typedef struct QUIC_CONGESTION_CONTROL_APP {
+
+    //
+    // The callbacks, owned by the connection's configuration.
+    //
+    const QUIC_CONGESTION_CONTROL_CALLBACKS* Callbacks;
+
+    uint32_t InitialWindowPackets;
+
+    uint32_t SendIdleTimeoutMs;
+
+    //
+    // The number of bytes considered to be still in the network.
+    //
+    uint32_t BytesInFlight;
+
+    uint32_t BytesInFlightMax;
+
+    //
+    // The leftover send allowance from a previous send. Only used when pacing.
+    //
+    uint32_t LastSendAllowance; // bytes
+
+    //
+    // A count of packets which can be sent ignoring the congestion window.
+    //
+    uint8_t Exemptions;
+
+    //
+    // Only used to count congestion events in the connection statistics, once
+    // per round trip like the built-in algorithms do.
+    //
+    BOOLEAN HasHadCongestionEvent;
+    uint64_t RecoverySentPacketNumber;
+
+    //
+    // The controller's per connection state.
+    //
+    uint64_t State[QUIC_CONGESTION_CONTROL_MAX_STATE_SIZE / sizeof(uint64_t)];
+
+} QUIC_CONGESTION_CONTROL_APP;
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+AppCongestionControlInitialize(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_SETTINGS_INTERNAL* Settings,
+    _In_ const QUIC_CONGESTION_CONTROL_CALLBACKS* Callbacks
+    );
@@ -36,16 +36,6 @@ typedef enum RECOVERY_STATE {
 
 } RECOVERY_STATE;
 
-//
-// Bandwidth is measured as (bytes / BW_UNIT) per second
-//
-#define BW_UNIT 8 // 1 << 3
-
-//
-// Gain is measured as (1 / GAIN_UNIT)
-//
-#define GAIN_UNIT 256 // 1 << 8
-
 //
 // The length of the gain cycle
 //
@@ -109,6 +99,57 @@ const uint32_t kBbrMaxBandwidthFilterLen = 10;
 
 const uint32_t kBbrMaxAckHeightFilterLen = 10;
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+BbrGetDeliveryRate(
+    _In_ const QUIC_SENT_PACKET_METADATA* AckedPacket,
+    _In_ const QUIC_ACK_EVENT* AckEvent,
+    _Out_ uint64_t* DeliveryRate
+    )
+{
+    uint64_t TimeNow = AckEvent->TimeNow;
+    uint64_t SendRate = UINT64_MAX;
+    uint64_t AckRate = UINT64_MAX;
+
+    if (AckedPacket->LastAckedPacketInfo != NULL) {
+        CXPLAT_DBG_ASSERT(CxPlatTimeAtOrBefore64(AckedPacket->LastAckedPacketInfo->SentTime, AckedPacket->SentTime));
+
+        uint64_t AckElapsed = 0;
+        uint64_t SendElapsed = CxPlatTimeDiff64(AckedPacket->LastAckedPacketInfo->SentTime, AckedPacket->SentTime);
+
+        if (SendElapsed) {
+            SendRate = (kMicroSecsInSec * BW_UNIT *
+                (uint32_t)(AckedPacket->TotalBytesSent - AckedPacket->LastAckedPacketInfo->TotalBytesSent) /
+                SendElapsed);
+        }
+
+        if (!CxPlatTimeAtOrBefore64(AckEvent->AdjustedAckTime, AckedPacket->LastAckedPacketInfo->AdjustedAckTime)) {
+            AckElapsed = CxPlatTimeDiff64(AckedPacket->LastAckedPacketInfo->AdjustedAckTime, AckEvent->AdjustedAckTime);
+        } else {
+            AckElapsed = CxPlatTimeDiff64(AckedPacket->LastAckedPacketInfo->AckTime, TimeNow);
+        }
+
+        CXPLAT_DBG_ASSERT(AckEvent->NumTotalAckedRetransmittableBytes >= AckedPacket->LastAckedPacketInfo->TotalBytesAcked);
+        if (AckElapsed) {
+            AckRate = (kMicroSecsInSec * BW_UNIT *
+                       (AckEvent->NumTotalAckedRetransmittableBytes - AckedPacket->LastAckedPacketInfo->TotalBytesAcked) /
+                       AckElapsed);
+        }
+    } else if (!CxPlatTimeAtOrBefore64(TimeNow, AckedPacket->SentTime)) {
+        CXPLAT_DBG_ASSERT(CxPlatTimeDiff64(AckedPacket->SentTime, TimeNow) != 0);
+        SendRate = (kMicroSecsInSec * BW_UNIT *
+                    AckEvent->NumTotalAckedRetransmittableBytes /
+                    CxPlatTimeDiff64(AckedPacket->SentTime, TimeNow));
+    }
+
+    if (SendRate == UINT64_MAX && AckRate == UINT64_MAX) {
+        return FALSE;
+    }
+
+    *DeliveryRate = CXPLAT_MIN(SendRate, AckRate);
+    return TRUE;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 BbrBandwidthFilterOnPacketAcked(
@@ -121,8 +162,6 @@ BbrBandwidthFilterOnPacketAcked(
         b->AppLimited = FALSE;
     }
 
-    uint64_t TimeNow = AckEvent->TimeNow;
-
     QUIC_SENT_PACKET_METADATA* AckedPacketsIterator = AckEvent->AckedPackets;
     while (AckedPacketsIterator != NULL) {
         QUIC_SENT_PACKET_METADATA* AckedPacket = AckedPacketsIterator;
@@ -132,47 +171,11 @@ BbrBandwidthFilterOnPacketAcked(
             continue;
         }
 
-        uint64_t SendRate = UINT64_MAX;
-        uint64_t AckRate = UINT64_MAX;
-
-        if (AckedPacket->Flags.HasLastAckedPacketInfo) {
-            CXPLAT_DBG_ASSERT(AckedPacket->TotalBytesSent >= AckedPacket->LastAckedPacketInfo.TotalBytesSent);
-            CXPLAT_DBG_ASSERT(CxPlatTimeAtOrBefore64(AckedPacket->LastAckedPacketInfo.SentTime, AckedPacket->SentTime));
-
-            uint64_t AckElapsed = 0;
-            uint64_t SendElapsed = CxPlatTimeDiff64(AckedPacket->LastAckedPacketInfo.SentTime, AckedPacket->SentTime);
-
-            if (SendElapsed) {
-                SendRate = (kMicroSecsInSec * BW_UNIT *
-                    (AckedPacket->TotalBytesSent - AckedPacket->LastAckedPacketInfo.TotalBytesSent) /
-                    SendElapsed);
-            }
-
-            if (!CxPlatTimeAtOrBefore64(AckEvent->AdjustedAckTime, AckedPacket->LastAckedPacketInfo.AdjustedAckTime)) {
-                AckElapsed = CxPlatTimeDiff64(AckedPacket->LastAckedPacketInfo.AdjustedAckTime, AckEvent->AdjustedAckTime);
-            } else {
-                AckElapsed = CxPlatTimeDiff64(AckedPacket->LastAckedPacketInfo.AckTime, TimeNow);
-            }
-
-            CXPLAT_DBG_ASSERT(AckEvent->NumTotalAckedRetransmittableBytes >= AckedPacket->LastAckedPacketInfo.TotalBytesAcked);
-            if (AckElapsed) {
-                AckRate = (kMicroSecsInSec * BW_UNIT *
-                           (AckEvent->NumTotalAckedRetransmittableBytes - AckedPacket->LastAckedPacketInfo.TotalBytesAcked) /
-                           AckElapsed);
-            }
-        } else if (!CxPlatTimeAtOrBefore64(TimeNow, AckedPacket->SentTime)) {
-            CXPLAT_DBG_ASSERT(CxPlatTimeDiff64(AckedPacket->SentTime, TimeNow) != 0);
-            SendRate = (kMicroSecsInSec * BW_UNIT *
-                        AckEvent->NumTotalAckedRetransmittableBytes /
-                        CxPlatTimeDiff64(AckedPacket->SentTime, TimeNow));
-        }
-
-        if (SendRate == UINT64_MAX && AckRate == UINT64_MAX) {
+        uint64_t DeliveryRate;
+        if (!BbrGetDeliveryRate(AckedPacket, AckEvent, &DeliveryRate)) {
             continue;
         }
 
-        uint64_t DeliveryRate = CXPLAT_MIN(SendRate, AckRate);
-
         QUIC_SLIDING_WINDOW_EXTREMUM_ENTRY Entry = (QUIC_SLIDING_WINDOW_EXTREMUM_ENTRY) { .Value = 0, .Time = 0 };
         QUIC_STATUS Status = QuicSlidingWindowExtremumGet(&b->WindowedMaxFilter, &Entry);
 
@@ -1019,7 +1022,7 @@ BbrCongestionControlReset(
     Bbr->LastEstimatedStartupBandwidth = 0;
 
     Bbr->AckAggregationStartTimeValid = FALSE;
-    Bbr->AckAggregationStartTime = CxPlatTimeUs64();
+    Bbr->AckAggregationStartTime = 0;
     Bbr->CycleStart = 0;
 
     Bbr->EndOfRecoveryValid = FALSE;
@@ -1032,7 +1035,7 @@ BbrCongestionControlReset(
     Bbr->EndOfRoundTrip = 0;
 
     Bbr->ProbeRttEndTimeValid = FALSE;
-    Bbr->ProbeRttEndTime = CxPlatTimeUs64();
+    Bbr->ProbeRttEndTime = 0;
 
     Bbr->RttSampleExpired = TRUE;
     Bbr->MinRttTimestampValid = FALSE;
@@ -1112,7 +1115,7 @@ BbrCongestionControlInitialize(
     Bbr->CycleStart = 0;
 
     Bbr->AckAggregationStartTimeValid = FALSE;
-    Bbr->AckAggregationStartTime = CxPlatTimeUs64();
+    Bbr->AckAggregationStartTime = 0;
 
     Bbr->EndOfRecoveryValid = FALSE;
     Bbr->EndOfRecovery = 0;
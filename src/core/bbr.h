@@ -11,6 +11,16 @@
 
 #define kBbrDefaultFilterCapacity 3
 
+//
+// Bandwidth is measured as (bytes / BW_UNIT) per second
+//
+#define BW_UNIT 8 // 1 << 3
+
+//
+// Gain is measured as (1 / GAIN_UNIT)
+//
+#define GAIN_UNIT 256 // 1 << 8
+
 typedef struct BBR_BANDWIDTH_FILTER {
 
     //
@@ -221,3 +231,17 @@ BbrCongestionControlInitialize(
     _In_ QUIC_CONGESTION_CONTROL* Cc,
     _In_ const QUIC_SETTINGS_INTERNAL* Settings
     );
+
+struct QUIC_ACK_EVENT;
+
+//
+// Calculates the delivery rate sample (in bytes / BW_UNIT per second) for a
+// newly acknowledged packet. Returns FALSE if no sample could be taken.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+BbrGetDeliveryRate(
+    _In_ const QUIC_SENT_PACKET_METADATA* AckedPacket,
+    _In_ const struct QUIC_ACK_EVENT* AckEvent,
+    _Out_ uint64_t* DeliveryRate
+    );
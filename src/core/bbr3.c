@@ -0,0 +1,1820 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Bottleneck Bandwidth and RTT version 3 (BBRv3) congestion control, as
+    described by draft-ietf-ccwg-bbr.
+
+    Compared to the original BBR (bbr.c), the model is additionally bounded
+    by the loss rate and ECN CE marks: inflight is capped from above by
+    InflightHi, learned when probing for bandwidth causes congestion, and from
+    below by BwLo and InflightLo, which back off on congestion outside of
+    probing. PROBE_BW is split into the DOWN, CRUISE, REFILL and UP phases.
+
+--*/
+
+#include "precomp.h"
+#ifdef QUIC_CLOG
+#include "bbr3.c.clog.h"
+#endif
+
+typedef enum BBR3_STATE {
+
+    BBR3_STATE_STARTUP,
+
+    BBR3_STATE_DRAIN,
+
+    BBR3_STATE_PROBE_BW_DOWN,
+
+    BBR3_STATE_PROBE_BW_CRUISE,
+
+    BBR3_STATE_PROBE_BW_REFILL,
+
+    BBR3_STATE_PROBE_BW_UP,
+
+    BBR3_STATE_PROBE_RTT
+
+} BBR3_STATE;
+
+typedef enum BBR3_ACK_PHASE {
+
+    BBR3_ACK_PHASE_INIT,
+
+    BBR3_ACK_PHASE_PROBE_STARTING,
+
+    BBR3_ACK_PHASE_PROBE_FEEDBACK,
+
+    BBR3_ACK_PHASE_PROBE_STOPPING,
+
+    BBR3_ACK_PHASE_REFILLING
+
+} BBR3_ACK_PHASE;
+
+//
+// Pacing and cwnd gains, in units of GAIN_UNIT.
+//
+#define BBR3_STARTUP_PACING_GAIN        (GAIN_UNIT * 277 / 100) // 4*ln(2)
+#define BBR3_DRAIN_PACING_GAIN          (GAIN_UNIT * 35 / 100)
+#define BBR3_DEFAULT_CWND_GAIN          (GAIN_UNIT * 2)
+#define BBR3_PROBE_DOWN_PACING_GAIN     (GAIN_UNIT * 90 / 100)
+#define BBR3_PROBE_UP_PACING_GAIN       (GAIN_UNIT * 5 / 4)
+#define BBR3_PROBE_UP_CWND_GAIN         (GAIN_UNIT * 9 / 4)
+#define BBR3_PROBE_RTT_CWND_GAIN        (GAIN_UNIT / 2)
+
+//
+// Pace at 1% below the estimated bandwidth to keep the bottleneck queue
+// drained.
+//
+#define BBR3_PACING_MARGIN_PERCENT      1
+
+//
+// The multiplicative decrease applied to the lower bounds on congestion, and
+// to InflightHi when probing causes congestion.
+//
+#define BBR3_BETA                       (GAIN_UNIT * 7 / 10)
+
+//
+// The fraction of InflightHi left unused when cruising, to leave room for
+// other flows.
+//
+#define BBR3_HEADROOM                   (GAIN_UNIT * 15 / 100)
+
+//
+// The per round trip loss rate above which inflight is considered too high.
+//
+#define BBR3_LOSS_THRESH_PERCENT        2
+
+//
+// STARTUP exits on high loss only after this many loss events in a round.
+//
+#define BBR3_STARTUP_FULL_LOSS_COUNT    6
+
+//
+// STARTUP exits after this many rounds without the bandwidth growing by at
+// least BBR3_STARTUP_GROWTH_TARGET.
+//
+#define BBR3_STARTUP_FULL_BW_ROUNDS     3
+#define BBR3_STARTUP_GROWTH_TARGET      (GAIN_UNIT * 5 / 4)
+
+#define BBR3_MIN_PIPE_CWND_PACKETS      4
+
+#define BBR3_PROBE_RTT_INTERVAL         S_TO_US(5)
+#define BBR3_PROBE_RTT_DURATION         MS_TO_US(200)
+#define BBR3_MIN_RTT_FILTER_LENGTH      S_TO_US(10)
+
+//
+// Bandwidth samples are kept for two PROBE_BW cycles.
+//
+#define BBR3_MAX_BW_FILTER_LENGTH       1
+
+//
+// Ack aggregation samples are kept for ten round trips.
+//
+#define BBR3_EXTRA_ACKED_FILTER_LENGTH  10
+
+//
+// Bandwidth is probed every 2 to 3 seconds, or sooner if a Reno flow with the
+// same BDP would have probed.
+//
+#define BBR3_PROBE_WAIT_BASE            S_TO_US(2)
+#define BBR3_PROBE_WAIT_RANDOM          S_TO_US(1)
+#define BBR3_RENO_MAX_PROBE_ROUNDS      63
+
+#define BBR3_PROBE_UP_MAX_ROUNDS        30
+
+//
+// ECN is only used as a signal on paths with a min RTT below
+// BBR3_ECN_MAX_RTT, where the bottleneck is expected to mark at a shallow
+// queue (such as a datacenter fabric). A round with at least BBR3_ECN_THRESH
+// of its packets marked means inflight is too high, and the lower bounds are
+// reduced by BBR3_ECN_FACTOR of the moving average of the marking ratio.
+//
+#define BBR3_ECN_MAX_RTT                MS_TO_US(5)
+#define BBR3_ECN_THRESH                 (GAIN_UNIT / 2)
+#define BBR3_ECN_FACTOR                 (GAIN_UNIT / 3)
+#define BBR3_ECN_ALPHA_GAIN_SHIFT       4 // 1/16
+
+#define BBR3_QUANTA_FACTOR              3
+
+#define BBR3_LOW_PACING_RATE_THRESHOLD  (1200ULL * 1000) // bytes per second
+#define BBR3_HIGH_PACING_RATE_THRESHOLD (24ULL * 1000 * 1000) // bytes per second
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+Bbr3CongestionControlGetMinCongestionWindow(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    return BBR3_MIN_PIPE_CWND_PACKETS * QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+Bbr3CongestionControlGetMaxBandwidth(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_SLIDING_WINDOW_EXTREMUM_ENTRY Entry = (QUIC_SLIDING_WINDOW_EXTREMUM_ENTRY) { .Value = 0, .Time = 0 };
+    QUIC_STATUS Status = QuicSlidingWindowExtremumGet(&Cc->Bbr3.MaxBwFilter, &Entry);
+    if (QUIC_SUCCEEDED(Status)) {
+        return Entry.Value;
+    }
+    return 0;
+}
+
+//
+// The bandwidth used by the model: the max bandwidth, bounded by the lower
+// bound learned from recent congestion.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+Bbr3CongestionControlGetBandwidth(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return CXPLAT_MIN(Bbr3CongestionControlGetMaxBandwidth(Cc), Cc->Bbr3.BwLo);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+Bbr3CongestionControlIsInProbeBw(
+    _In_ const QUIC_CONGESTION_CONTROL_BBR3* Bbr
+    )
+{
+    return
+        Bbr->State == BBR3_STATE_PROBE_BW_DOWN ||
+        Bbr->State == BBR3_STATE_PROBE_BW_CRUISE ||
+        Bbr->State == BBR3_STATE_PROBE_BW_REFILL ||
+        Bbr->State == BBR3_STATE_PROBE_BW_UP;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+Bbr3CongestionControlIsProbingBw(
+    _In_ const QUIC_CONGESTION_CONTROL_BBR3* Bbr
+    )
+{
+    return
+        Bbr->State == BBR3_STATE_STARTUP ||
+        Bbr->State == BBR3_STATE_PROBE_BW_REFILL ||
+        Bbr->State == BBR3_STATE_PROBE_BW_UP;
+}
+
+//
+// ECN is only trusted as a congestion signal on low latency paths.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+Bbr3CongestionControlIsEcnEligible(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    return
+        Connection->Settings.EcnEnabled &&
+        Cc->Bbr3.MinRtt <= BBR3_ECN_MAX_RTT;
+}
+
+//
+// Returns Gain times the estimated BDP of the path.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+Bbr3CongestionControlGetBdpMultiple(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t Bandwidth,
+    _In_ uint32_t Gain
+    )
+{
+    const QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+
+    if (!Bandwidth || Bbr->MinRtt == UINT64_MAX) {
+        return (uint64_t)Gain * Bbr->InitialCongestionWindow / GAIN_UNIT;
+    }
+
+    uint64_t Bdp = Bandwidth * Bbr->MinRtt / S_TO_US(1) / BW_UNIT;
+    return Bdp * Gain / GAIN_UNIT;
+}
+
+//
+// Adds the allowance for send and receive offload and delayed ACKs to an
+// inflight target.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+Bbr3CongestionControlQuantizationBudget(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t Inflight
+    )
+{
+    const QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+
+    Inflight = CXPLAT_MAX(Inflight, BBR3_QUANTA_FACTOR * Bbr->SendQuantum);
+    Inflight = CXPLAT_MAX(Inflight, Bbr3CongestionControlGetMinCongestionWindow(Cc));
+    if (Bbr->State == BBR3_STATE_PROBE_BW_UP) {
+        Inflight += 2 * (uint64_t)QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+    }
+    return Inflight;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+Bbr3CongestionControlGetInflight(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t Gain
+    )
+{
+    return
+        Bbr3CongestionControlQuantizationBudget(
+            Cc,
+            Bbr3CongestionControlGetBdpMultiple(
+                Cc, Bbr3CongestionControlGetBandwidth(Cc), Gain));
+}
+
+//
+// The inflight to aim for when cruising, leaving headroom below InflightHi.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+Bbr3CongestionControlGetInflightWithHeadroom(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+
+    if (Bbr->InflightHi == UINT32_MAX) {
+        return UINT32_MAX;
+    }
+
+    uint32_t Headroom =
+        CXPLAT_MAX(
+            (uint32_t)QuicPathGetDatagramPayloadSize(&Connection->Paths[0]),
+            (uint32_t)((uint64_t)Bbr->InflightHi * BBR3_HEADROOM / GAIN_UNIT));
+    uint32_t MinCongestionWindow = Bbr3CongestionControlGetMinCongestionWindow(Cc);
+
+    if (Bbr->InflightHi <= Headroom + MinCongestionWindow) {
+        return MinCongestionWindow;
+    }
+    return Bbr->InflightHi - Headroom;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+Bbr3CongestionControlGetTargetInflight(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    uint64_t Bdp =
+        Bbr3CongestionControlGetBdpMultiple(
+            Cc, Bbr3CongestionControlGetBandwidth(Cc), GAIN_UNIT);
+    return CXPLAT_MIN(Bdp, Cc->Bbr3.CongestionWindow);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+Bbr3CongestionControlGetCongestionWindow(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->Bbr3.CongestionWindow;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+Bbr3CongestionControlIsAppLimited(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->Bbr3.AppLimited;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicConnLogBbr3(
+    _In_ QUIC_CONNECTION* const Connection
+    )
+{
+    QUIC_CONGESTION_CONTROL* Cc = &Connection->CongestionControl;
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+
+    QuicTraceEvent(
+        ConnBbr,
+        "[conn][%p] BBR: State=%u RState=%u CongestionWindow=%u BytesInFlight=%u BytesInFlightMax=%u MinRttEst=%lu EstBw=%lu AppLimited=%u",
+        Connection,
+        Bbr->State,
+        Bbr->InRecovery,
+        Bbr3CongestionControlGetCongestionWindow(Cc),
+        Bbr->BytesInFlight,
+        Bbr->BytesInFlightMax,
+        Bbr->MinRtt,
+        Bbr3CongestionControlGetBandwidth(Cc) / BW_UNIT,
+        Bbr3CongestionControlIsAppLimited(Cc));
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlIndicateConnectionEvent(
+    _In_ QUIC_CONNECTION* const Connection,
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+    const QUIC_PATH* Path = &Connection->Paths[0];
+    QUIC_CONNECTION_EVENT Event;
+    Event.Type = QUIC_CONNECTION_EVENT_NETWORK_STATISTICS;
+    Event.NETWORK_STATISTICS.BytesInFlight = Bbr->BytesInFlight;
+    Event.NETWORK_STATISTICS.PostedBytes = Connection->SendBuffer.PostedBytes;
+    Event.NETWORK_STATISTICS.IdealBytes = Connection->SendBuffer.IdealBytes;
+    Event.NETWORK_STATISTICS.SmoothedRTT = Path->SmoothedRtt;
+    Event.NETWORK_STATISTICS.CongestionWindow = Bbr3CongestionControlGetCongestionWindow(Cc);
+    Event.NETWORK_STATISTICS.Bandwidth = Bbr3CongestionControlGetBandwidth(Cc) / BW_UNIT;
+
+    QuicTraceLogConnVerbose(
+        IndicateDataAcked,
+        Connection,
+        "Indicating QUIC_CONNECTION_EVENT_NETWORK_STATISTICS [BytesInFlight=%u,PostedBytes=%llu,IdealBytes=%llu,SmoothedRTT=%llu,CongestionWindow=%u,Bandwidth=%llu]",
+        Event.NETWORK_STATISTICS.BytesInFlight,
+        Event.NETWORK_STATISTICS.PostedBytes,
+        Event.NETWORK_STATISTICS.IdealBytes,
+        Event.NETWORK_STATISTICS.SmoothedRTT,
+        Event.NETWORK_STATISTICS.CongestionWindow,
+        Event.NETWORK_STATISTICS.Bandwidth);
+    QuicConnIndicateEvent(Connection, &Event);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+Bbr3CongestionControlCanSend(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return
+        Cc->Bbr3.BytesInFlight < Bbr3CongestionControlGetCongestionWindow(Cc) ||
+        Cc->Bbr3.Exemptions > 0;
+}
+
+void
+Bbr3CongestionControlLogOutFlowStatus(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    const QUIC_PATH* Path = &Connection->Paths[0];
+    const QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+
+    QuicTraceEvent(
+        ConnOutFlowStatsV2,
+        "[conn][%p] OUT: BytesSent=%llu InFlight=%u CWnd=%u ConnFC=%llu ISB=%llu PostedBytes=%llu SRtt=%llu 1Way=%llu",
+        Connection,
+        Connection->Stats.Send.TotalBytes,
+        Bbr->BytesInFlight,
+        Bbr->CongestionWindow,
+        Connection->Send.PeerMaxData - Connection->Send.OrderedStreamBytesSent,
+        Connection->SendBuffer.IdealBytes,
+        Connection->SendBuffer.PostedBytes,
+        Path->GotFirstRttSample ? Path->SmoothedRtt : 0,
+        Path->OneWayDelay);
+}
+
+//
+// Returns TRUE if we became unblocked.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+Bbr3CongestionControlUpdateBlockedState(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ BOOLEAN PreviousCanSendState
+    )
+{
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    QuicConnLogOutFlowStats(Connection);
+
+    if (PreviousCanSendState != Bbr3CongestionControlCanSend(Cc)) {
+        if (PreviousCanSendState) {
+            QuicConnAddOutFlowBlockedReason(
+                Connection, QUIC_FLOW_BLOCKED_CONGESTION_CONTROL);
+        } else {
+            QuicConnRemoveOutFlowBlockedReason(
+                Connection, QUIC_FLOW_BLOCKED_CONGESTION_CONTROL);
+            Connection->Send.LastFlushTime = CxPlatTimeUs64(); // Reset last flush time
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+Bbr3CongestionControlGetBytesInFlightMax(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->Bbr3.BytesInFlightMax;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint8_t
+Bbr3CongestionControlGetExemptions(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->Bbr3.Exemptions;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlSetExemption(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint8_t NumPackets
+    )
+{
+    Cc->Bbr3.Exemptions = NumPackets;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlOnDataSent(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t NumRetransmittableBytes
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+
+    BOOLEAN PreviousCanSendState = Bbr3CongestionControlCanSend(Cc);
+
+    if (!Bbr->BytesInFlight && Bbr3CongestionControlIsAppLimited(Cc)) {
+        Bbr->IdleRestart = TRUE;
+    }
+
+    Bbr->BytesInFlight += NumRetransmittableBytes;
+    if (Bbr->BytesInFlightMax < Bbr->BytesInFlight) {
+        Bbr->BytesInFlightMax = Bbr->BytesInFlight;
+        QuicSendBufferConnectionAdjust(QuicCongestionControlGetConnection(Cc));
+    }
+
+    if (Bbr->TxInflight < Bbr->BytesInFlight) {
+        Bbr->TxInflight = Bbr->BytesInFlight;
+    }
+    if (Bbr->BytesInFlight >= Bbr->CongestionWindow) {
+        Bbr->CwndLimitedInRound = TRUE;
+    }
+
+    if (Bbr->Exemptions > 0) {
+        --Bbr->Exemptions;
+    }
+
+    Bbr3CongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+Bbr3CongestionControlOnDataInvalidated(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t NumRetransmittableBytes
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+
+    BOOLEAN PreviousCanSendState = Bbr3CongestionControlCanSend(Cc);
+
+    CXPLAT_DBG_ASSERT(Bbr->BytesInFlight >= NumRetransmittableBytes);
+    Bbr->BytesInFlight -= NumRetransmittableBytes;
+
+    return Bbr3CongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlStartRound(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    Cc->Bbr3.EndOfRoundTrip = Connection->LossDetection.LargestSentPacketNumber;
+    Cc->Bbr3.EndOfRoundTripValid = TRUE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlMarkAppLimited(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    Cc->Bbr3.AppLimited = TRUE;
+    Cc->Bbr3.AppLimitedExitTarget = Connection->LossDetection.LargestSentPacketNumber;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+Bbr3CongestionControlSaveCongestionWindow(
+    _In_ const QUIC_CONGESTION_CONTROL_BBR3* Bbr
+    )
+{
+    if (!Bbr->InRecovery && Bbr->State != BBR3_STATE_PROBE_RTT) {
+        return Bbr->CongestionWindow;
+    }
+    return CXPLAT_MAX(Bbr->PriorCongestionWindow, Bbr->CongestionWindow);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlRestoreCongestionWindow(
+    _In_ QUIC_CONGESTION_CONTROL_BBR3* Bbr
+    )
+{
+    Bbr->CongestionWindow = CXPLAT_MAX(Bbr->CongestionWindow, Bbr->PriorCongestionWindow);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlResetLowerBounds(
+    _In_ QUIC_CONGESTION_CONTROL_BBR3* Bbr
+    )
+{
+    Bbr->BwLo = UINT64_MAX;
+    Bbr->InflightLo = UINT32_MAX;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlResetCongestionSignals(
+    _In_ QUIC_CONGESTION_CONTROL_BBR3* Bbr
+    )
+{
+    Bbr->LossInRound = FALSE;
+    Bbr->LossBytesInRound = 0;
+    Bbr->LossEventsInRound = 0;
+    Bbr->AckedPacketsInRound = 0;
+    Bbr->CeCountInRound = 0;
+    Bbr->BwLatest = 0;
+    Bbr->InflightLatest = 0;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlResetFullBw(
+    _In_ QUIC_CONGESTION_CONTROL_BBR3* Bbr
+    )
+{
+    Bbr->FullBw = 0;
+    Bbr->FullBwCount = 0;
+    Bbr->FullBwNow = FALSE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlEnterStartup(
+    _In_ QUIC_CONGESTION_CONTROL_BBR3* Bbr
+    )
+{
+    Bbr->State = BBR3_STATE_STARTUP;
+    Bbr->PacingGain = BBR3_STARTUP_PACING_GAIN;
+    Bbr->CwndGain = BBR3_DEFAULT_CWND_GAIN;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlEnterDrain(
+    _In_ QUIC_CONGESTION_CONTROL_BBR3* Bbr
+    )
+{
+    Bbr->State = BBR3_STATE_DRAIN;
+    Bbr->PacingGain = BBR3_DRAIN_PACING_GAIN;
+    Bbr->CwndGain = BBR3_DEFAULT_CWND_GAIN;
+}
+
+//
+// Randomizes the time until the next bandwidth probe, to desynchronize flows
+// sharing a bottleneck.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlPickProbeWait(
+    _In_ QUIC_CONGESTION_CONTROL_BBR3* Bbr
+    )
+{
+    uint32_t RandomValue = 0;
+    CxPlatRandom(sizeof(uint32_t), &RandomValue);
+    Bbr->RoundsSinceBwProbe = RandomValue & 1;
+    Bbr->BwProbeWait = BBR3_PROBE_WAIT_BASE + (RandomValue >> 1) % BBR3_PROBE_WAIT_RANDOM;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlStartProbeBwDown(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeNow
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+
+    Bbr3CongestionControlResetCongestionSignals(Bbr);
+    Bbr->BwProbeUpCount = UINT32_MAX;
+    Bbr3CongestionControlPickProbeWait(Bbr);
+    Bbr->CycleStart = TimeNow;
+    Bbr->AckPhase = BBR3_ACK_PHASE_PROBE_STOPPING;
+    Bbr3CongestionControlStartRound(Cc);
+
+    Bbr->State = BBR3_STATE_PROBE_BW_DOWN;
+    Bbr->PacingGain = BBR3_PROBE_DOWN_PACING_GAIN;
+    Bbr->CwndGain = BBR3_DEFAULT_CWND_GAIN;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlStartProbeBwCruise(
+    _In_ QUIC_CONGESTION_CONTROL_BBR3* Bbr
+    )
+{
+    Bbr->State = BBR3_STATE_PROBE_BW_CRUISE;
+    Bbr->PacingGain = GAIN_UNIT;
+    Bbr->CwndGain = BBR3_DEFAULT_CWND_GAIN;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlStartProbeBwRefill(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+
+    Bbr3CongestionControlResetLowerBounds(Bbr);
+    Bbr->BwProbeUpRounds = 0;
+    Bbr->BwProbeUpAcks = 0;
+    Bbr->AckPhase = BBR3_ACK_PHASE_REFILLING;
+    Bbr3CongestionControlStartRound(Cc);
+
+    Bbr->State = BBR3_STATE_PROBE_BW_REFILL;
+    Bbr->PacingGain = GAIN_UNIT;
+    Bbr->CwndGain = BBR3_DEFAULT_CWND_GAIN;
+}
+
+//
+// Grows InflightHi exponentially while probing up: each round doubles the
+// number of packets InflightHi grows by over the round.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlRaiseInflightHiSlope(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+
+    const uint32_t DatagramPayloadLength =
+        QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+
+    uint32_t Growth = 1u << Bbr->BwProbeUpRounds;
+    Bbr->BwProbeUpRounds = CXPLAT_MIN(Bbr->BwProbeUpRounds + 1, BBR3_PROBE_UP_MAX_ROUNDS);
+    Bbr->BwProbeUpCount = CXPLAT_MAX(Bbr->CongestionWindow / Growth, DatagramPayloadLength);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlStartProbeBwUp(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeNow
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+
+    Bbr->AckPhase = BBR3_ACK_PHASE_PROBE_STARTING;
+    Bbr3CongestionControlStartRound(Cc);
+    Bbr3CongestionControlResetFullBw(Bbr);
+    Bbr->FullBw = Bbr3CongestionControlGetMaxBandwidth(Cc);
+    Bbr->CycleStart = TimeNow;
+
+    Bbr->State = BBR3_STATE_PROBE_BW_UP;
+    Bbr->PacingGain = BBR3_PROBE_UP_PACING_GAIN;
+    Bbr->CwndGain = BBR3_PROBE_UP_CWND_GAIN;
+
+    Bbr3CongestionControlRaiseInflightHiSlope(Cc);
+}
+
+//
+// Returns TRUE if the loss rate of the current round, or the CE marking rate
+// of the last round (if RoundEnded), shows that inflight is too high.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+Bbr3CongestionControlIsInflightTooHigh(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc,
+    _In_ BOOLEAN RoundEnded
+    )
+{
+    const QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+
+    if (Bbr->LossBytesInRound > 0 &&
+        (uint64_t)Bbr->LossBytesInRound * 100 >
+            (uint64_t)Bbr->TxInflight * BBR3_LOSS_THRESH_PERCENT) {
+        return TRUE;
+    }
+
+    if (RoundEnded &&
+        Bbr->CeRatio >= BBR3_ECN_THRESH &&
+        Bbr3CongestionControlIsEcnEligible(Cc)) {
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlHandleInflightTooHigh(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeNow
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+
+    Bbr->BwProbeSamples = FALSE;
+    if (!Bbr->AppLimited) {
+        uint64_t Target =
+            Bbr3CongestionControlGetTargetInflight(Cc) * BBR3_BETA / GAIN_UNIT;
+        Bbr->InflightHi = (uint32_t)CXPLAT_MAX(Bbr->TxInflight, Target);
+    }
+    if (Bbr->State == BBR3_STATE_PROBE_BW_UP) {
+        Bbr3CongestionControlStartProbeBwDown(Cc, TimeNow);
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+Bbr3CongestionControlCheckInflightTooHigh(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeNow
+    )
+{
+    if (Bbr3CongestionControlIsInflightTooHigh(Cc, Cc->Bbr3.RoundStart)) {
+        if (Cc->Bbr3.BwProbeSamples) {
+            Bbr3CongestionControlHandleInflightTooHigh(Cc, TimeNow);
+        }
+        return TRUE;
+    }
+    return FALSE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlProbeInflightHiUpward(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t AckedBytes
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+
+    const uint32_t DatagramPayloadLength =
+        QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+
+    if (!Bbr->CwndLimitedInRound || Bbr->CongestionWindow < Bbr->InflightHi) {
+        return; // Not fully using InflightHi, so don't grow it.
+    }
+
+    Bbr->BwProbeUpAcks += AckedBytes;
+    if (Bbr->BwProbeUpAcks >= Bbr->BwProbeUpCount) {
+        uint32_t Delta = Bbr->BwProbeUpAcks / Bbr->BwProbeUpCount;
+        Bbr->BwProbeUpAcks -= Delta * Bbr->BwProbeUpCount;
+        uint64_t InflightHi = (uint64_t)Bbr->InflightHi + (uint64_t)Delta * DatagramPayloadLength;
+        Bbr->InflightHi = (uint32_t)CXPLAT_MIN(InflightHi, UINT32_MAX - 1);
+    }
+
+    if (Bbr->RoundStart) {
+        Bbr3CongestionControlRaiseInflightHiSlope(Cc);
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlAdaptUpperBounds(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_ACK_EVENT* AckEvent,
+    _In_ BOOLEAN SampleAppLimited
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+
+    if (Bbr->AckPhase == BBR3_ACK_PHASE_PROBE_STARTING && Bbr->RoundStart) {
+        //
+        // Starting to get feedback for the data sent while probing up.
+        //
+        Bbr->AckPhase = BBR3_ACK_PHASE_PROBE_FEEDBACK;
+    }
+
+    if (Bbr->AckPhase == BBR3_ACK_PHASE_PROBE_STOPPING && Bbr->RoundStart) {
+        //
+        // The end of the samples from the last probe. This is the best time
+        // to forget the bandwidth samples from the cycle before it.
+        //
+        Bbr->BwProbeSamples = FALSE;
+        Bbr->AckPhase = BBR3_ACK_PHASE_INIT;
+        if (Bbr3CongestionControlIsInProbeBw(Bbr) && !SampleAppLimited) {
+            Bbr->CycleCount++;
+        }
+    }
+
+    if (!Bbr3CongestionControlCheckInflightTooHigh(Cc, AckEvent->TimeNow)) {
+        if (Bbr->InflightHi == UINT32_MAX) {
+            return;
+        }
+        if (Bbr->TxInflight > Bbr->InflightHi) {
+            Bbr->InflightHi = Bbr->TxInflight;
+        }
+        if (Bbr->State == BBR3_STATE_PROBE_BW_UP) {
+            Bbr3CongestionControlProbeInflightHiUpward(Cc, AckEvent->NumRetransmittableBytes);
+        }
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+Bbr3CongestionControlHasElapsedInPhase(
+    _In_ const QUIC_CONGESTION_CONTROL_BBR3* Bbr,
+    _In_ uint64_t Interval,
+    _In_ uint64_t TimeNow
+    )
+{
+    return CxPlatTimeDiff64(Bbr->CycleStart, TimeNow) > Interval;
+}
+
+//
+// A Reno flow with the same BDP would increase its window by one packet per
+// round, so probe at least that often to compete fairly with it.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+Bbr3CongestionControlIsRenoCoexistenceProbeTime(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+
+    uint64_t RenoRounds =
+        Bbr3CongestionControlGetTargetInflight(Cc) /
+        QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+    uint64_t Rounds = CXPLAT_MIN(RenoRounds, BBR3_RENO_MAX_PROBE_ROUNDS);
+    return Cc->Bbr3.RoundsSinceBwProbe >= Rounds;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+Bbr3CongestionControlIsTimeToProbeBw(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeNow
+    )
+{
+    if (Bbr3CongestionControlHasElapsedInPhase(&Cc->Bbr3, Cc->Bbr3.BwProbeWait, TimeNow) ||
+        Bbr3CongestionControlIsRenoCoexistenceProbeTime(Cc)) {
+        Bbr3CongestionControlStartProbeBwRefill(Cc);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+Bbr3CongestionControlIsTimeToCruise(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+
+    if (Bbr->BytesInFlight > Bbr3CongestionControlGetInflightWithHeadroom(Cc)) {
+        return FALSE; // Not enough headroom.
+    }
+    return Bbr->BytesInFlight <= Bbr3CongestionControlGetInflight(Cc, GAIN_UNIT);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+Bbr3CongestionControlIsTimeToGoDown(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+
+    if (Bbr->CwndLimitedInRound && Bbr->CongestionWindow >= Bbr->InflightHi) {
+        //
+        // The bandwidth is limited by InflightHi, not the path, so restart
+        // the plateau check.
+        //
+        Bbr3CongestionControlResetFullBw(Bbr);
+        Bbr->FullBw = Bbr3CongestionControlGetMaxBandwidth(Cc);
+    } else if (Bbr->FullBwNow) {
+        return TRUE; // The path bandwidth is fully used.
+    }
+    return FALSE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlUpdateProbeBwCyclePhase(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_ACK_EVENT* AckEvent,
+    _In_ BOOLEAN SampleAppLimited
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+
+    if (!Bbr->FilledPipe) {
+        return;
+    }
+
+    Bbr3CongestionControlAdaptUpperBounds(Cc, AckEvent, SampleAppLimited);
+
+    switch (Bbr->State) {
+    case BBR3_STATE_PROBE_BW_DOWN:
+        if (Bbr3CongestionControlIsTimeToProbeBw(Cc, AckEvent->TimeNow)) {
+            break;
+        }
+        if (Bbr3CongestionControlIsTimeToCruise(Cc)) {
+            Bbr3CongestionControlStartProbeBwCruise(Bbr);
+        }
+        break;
+
+    case BBR3_STATE_PROBE_BW_CRUISE:
+        Bbr3CongestionControlIsTimeToProbeBw(Cc, AckEvent->TimeNow);
+        break;
+
+    case BBR3_STATE_PROBE_BW_REFILL:
+        //
+        // After one round of refilling the pipe, start probing up.
+        //
+        if (Bbr->RoundStart) {
+            Bbr->BwProbeSamples = TRUE;
+            Bbr3CongestionControlStartProbeBwUp(Cc, AckEvent->TimeNow);
+        }
+        break;
+
+    case BBR3_STATE_PROBE_BW_UP:
+        if (Bbr3CongestionControlIsTimeToGoDown(Cc)) {
+            Bbr3CongestionControlStartProbeBwDown(Cc, AckEvent->TimeNow);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+//
+// Backs off the lower bounds once per round trip when loss or CE marks are
+// seen outside of bandwidth probing.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlAdaptLowerBounds(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ BOOLEAN EcnInRound
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+
+    if (Bbr3CongestionControlIsProbingBw(Bbr) || (!Bbr->LossInRound && !EcnInRound)) {
+        return;
+    }
+
+    if (Bbr->BwLo == UINT64_MAX) {
+        Bbr->BwLo = Bbr3CongestionControlGetMaxBandwidth(Cc);
+    }
+    if (Bbr->InflightLo == UINT32_MAX) {
+        Bbr->InflightLo = Bbr->CongestionWindow;
+    }
+
+    if (Bbr->LossInRound) {
+        Bbr->BwLo = CXPLAT_MAX(Bbr->BwLatest, Bbr->BwLo * BBR3_BETA / GAIN_UNIT);
+        Bbr->InflightLo =
+            CXPLAT_MAX(
+                Bbr->InflightLatest,
+                (uint32_t)((uint64_t)Bbr->InflightLo * BBR3_BETA / GAIN_UNIT));
+    }
+
+    if (EcnInRound) {
+        uint32_t EcnCut = GAIN_UNIT - Bbr->EcnAlpha * BBR3_ECN_FACTOR / GAIN_UNIT;
+        Bbr->InflightLo =
+            CXPLAT_MIN(
+                Bbr->InflightLo,
+                (uint32_t)((uint64_t)Bbr->InflightLo * EcnCut / GAIN_UNIT));
+    }
+}
+
+//
+// Called at the end of each round trip to process the round's loss and ECN
+// signals.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlUpdateCongestionSignals(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+
+    BOOLEAN EcnInRound = FALSE;
+    if (Bbr->AckedPacketsInRound > 0 && Bbr3CongestionControlIsEcnEligible(Cc)) {
+        uint64_t CeRatio = Bbr->CeCountInRound * GAIN_UNIT / Bbr->AckedPacketsInRound;
+        Bbr->CeRatio = (uint32_t)CXPLAT_MIN(CeRatio, GAIN_UNIT);
+        Bbr->EcnAlpha =
+            Bbr->EcnAlpha -
+            (Bbr->EcnAlpha >> BBR3_ECN_ALPHA_GAIN_SHIFT) +
+            (Bbr->CeRatio >> BBR3_ECN_ALPHA_GAIN_SHIFT);
+        EcnInRound = Bbr->CeCountInRound > 0;
+    } else {
+        Bbr->CeRatio = 0;
+    }
+
+    if (EcnInRound) {
+        QuicTraceEvent(
+            ConnCongestionV2,
+            "[conn][%p] Congestion event: IsEcn=%hu",
+            Connection,
+            TRUE);
+        Connection->Stats.Send.EcnCongestionCount++;
+    }
+
+    Bbr3CongestionControlAdaptLowerBounds(Cc, EcnInRound);
+
+    if (Bbr->State == BBR3_STATE_STARTUP && !Bbr->FilledPipe) {
+        //
+        // Exit STARTUP if the round saw too many loss events or CE marks.
+        //
+        if ((Bbr->LossEventsInRound >= BBR3_STARTUP_FULL_LOSS_COUNT &&
+             Bbr3CongestionControlIsInflightTooHigh(Cc, FALSE)) ||
+            (EcnInRound && Bbr3CongestionControlIsInflightTooHigh(Cc, TRUE))) {
+            Bbr->FilledPipe = TRUE;
+            Bbr->InflightHi =
+                (uint32_t)CXPLAT_MAX(
+                    Bbr3CongestionControlGetBdpMultiple(
+                        Cc, Bbr3CongestionControlGetMaxBandwidth(Cc), GAIN_UNIT),
+                    Bbr->InflightLatest);
+        }
+    }
+}
+
+//
+// Checks once per round whether the bandwidth has stopped growing.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlCheckFullBwReached(
+    _In_ QUIC_CONGESTION_CONTROL_BBR3* Bbr,
+    _In_ BOOLEAN SampleAppLimited
+    )
+{
+    if (Bbr->FullBwNow || SampleAppLimited || !Bbr->RoundStart) {
+        return;
+    }
+
+    if (Bbr->BwLatest >= Bbr->FullBw * BBR3_STARTUP_GROWTH_TARGET / GAIN_UNIT) {
+        Bbr->FullBw = Bbr->BwLatest;
+        Bbr->FullBwCount = 0;
+        return;
+    }
+
+    Bbr->FullBwNow = ++Bbr->FullBwCount >= BBR3_STARTUP_FULL_BW_ROUNDS;
+    if (Bbr->FullBwNow) {
+        Bbr->FilledPipe = TRUE;
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlUpdateMinRtt(
+    _In_ QUIC_CONGESTION_CONTROL_BBR3* Bbr,
+    _In_ const QUIC_ACK_EVENT* AckEvent
+    )
+{
+    uint64_t TimeNow = AckEvent->TimeNow;
+
+    //
+    // Neither filter can expire before it has its first sample, which is also
+    // what sets its timestamp.
+    //
+    Bbr->ProbeRttExpired =
+        Bbr->ProbeRttMinDelay != UINT64_MAX &&
+        CxPlatTimeDiff64(Bbr->ProbeRttMinTimestamp, TimeNow) > BBR3_PROBE_RTT_INTERVAL;
+    if (AckEvent->MinRttValid && AckEvent->MinRtt != UINT64_MAX &&
+        (AckEvent->MinRtt < Bbr->ProbeRttMinDelay || Bbr->ProbeRttExpired)) {
+        Bbr->ProbeRttMinDelay = AckEvent->MinRtt;
+        Bbr->ProbeRttMinTimestamp = TimeNow;
+    }
+
+    BOOLEAN MinRttExpired =
+        Bbr->MinRtt != UINT64_MAX &&
+        CxPlatTimeDiff64(Bbr->MinRttTimestamp, TimeNow) > BBR3_MIN_RTT_FILTER_LENGTH;
+    if (Bbr->ProbeRttMinDelay < Bbr->MinRtt || MinRttExpired) {
+        Bbr->MinRtt = Bbr->ProbeRttMinDelay;
+        Bbr->MinRttTimestamp = Bbr->ProbeRttMinTimestamp;
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+Bbr3CongestionControlGetProbeRttCongestionWindow(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    uint64_t ProbeRttCwnd =
+        Bbr3CongestionControlGetBdpMultiple(
+            Cc, Bbr3CongestionControlGetBandwidth(Cc), BBR3_PROBE_RTT_CWND_GAIN);
+    return
+        (uint32_t)CXPLAT_MAX(
+            ProbeRttCwnd,
+            Bbr3CongestionControlGetMinCongestionWindow(Cc));
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlCheckProbeRtt(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_ACK_EVENT* AckEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+    uint64_t TimeNow = AckEvent->TimeNow;
+
+    if (Bbr->State != BBR3_STATE_PROBE_RTT &&
+        Bbr->ProbeRttExpired &&
+        !Bbr->IdleRestart) {
+        Bbr->PriorCongestionWindow = Bbr3CongestionControlSaveCongestionWindow(Bbr);
+        Bbr->State = BBR3_STATE_PROBE_RTT;
+        Bbr->PacingGain = GAIN_UNIT;
+        Bbr->CwndGain = BBR3_PROBE_RTT_CWND_GAIN;
+        Bbr->ProbeRttDoneTimeValid = FALSE;
+        Bbr->AckPhase = BBR3_ACK_PHASE_PROBE_STOPPING;
+        Bbr3CongestionControlStartRound(Cc);
+    }
+
+    if (Bbr->State == BBR3_STATE_PROBE_RTT) {
+        //
+        // Ignore low rate samples during PROBE_RTT.
+        //
+        Bbr3CongestionControlMarkAppLimited(Cc);
+
+        if (!Bbr->ProbeRttDoneTimeValid &&
+            Bbr->BytesInFlight <= Bbr3CongestionControlGetProbeRttCongestionWindow(Cc)) {
+            //
+            // Wait for at least BBR3_PROBE_RTT_DURATION and one round trip.
+            //
+            Bbr->ProbeRttDoneTime = TimeNow + BBR3_PROBE_RTT_DURATION;
+            Bbr->ProbeRttDoneTimeValid = TRUE;
+            Bbr->ProbeRttRoundDone = FALSE;
+            Bbr3CongestionControlStartRound(Cc);
+
+        } else if (Bbr->ProbeRttDoneTimeValid) {
+            if (Bbr->RoundStart) {
+                Bbr->ProbeRttRoundDone = TRUE;
+            }
+            if (Bbr->ProbeRttRoundDone &&
+                CxPlatTimeAtOrBefore64(Bbr->ProbeRttDoneTime, TimeNow)) {
+                //
+                // Schedule the next PROBE_RTT and exit.
+                //
+                Bbr->ProbeRttMinTimestamp = TimeNow;
+                Bbr3CongestionControlRestoreCongestionWindow(Bbr);
+                Bbr3CongestionControlResetLowerBounds(Bbr);
+                if (Bbr->FilledPipe) {
+                    Bbr3CongestionControlStartProbeBwDown(Cc, TimeNow);
+                    Bbr3CongestionControlStartProbeBwCruise(Bbr);
+                } else {
+                    Bbr3CongestionControlEnterStartup(Bbr);
+                }
+            }
+        }
+    }
+
+    if (AckEvent->NumRetransmittableBytes > 0) {
+        Bbr->IdleRestart = FALSE;
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlUpdateAckAggregation(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_ACK_EVENT* AckEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+
+    if (!Bbr->AckAggregationStartTimeValid) {
+        Bbr->AckAggregationStartTime = AckEvent->TimeNow;
+        Bbr->AckAggregationStartTimeValid = TRUE;
+        return;
+    }
+
+    uint64_t ExpectedAckBytes =
+        Bbr3CongestionControlGetBandwidth(Cc) *
+        CxPlatTimeDiff64(Bbr->AckAggregationStartTime, AckEvent->TimeNow) /
+        S_TO_US(1) /
+        BW_UNIT;
+
+    //
+    // Reset the aggregation epoch when the ACK arrival rate falls to or below
+    // the estimated bandwidth.
+    //
+    if (Bbr->AggregatedAckBytes <= ExpectedAckBytes) {
+        Bbr->AggregatedAckBytes = AckEvent->NumRetransmittableBytes;
+        Bbr->AckAggregationStartTime = AckEvent->TimeNow;
+        return;
+    }
+
+    Bbr->AggregatedAckBytes += AckEvent->NumRetransmittableBytes;
+
+    QuicSlidingWindowExtremumUpdateMax(
+        &Bbr->MaxAckHeightFilter,
+        CXPLAT_MIN(Bbr->AggregatedAckBytes - ExpectedAckBytes, Bbr->CongestionWindow),
+        Bbr->RoundTripCounter);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlSetPacingRate(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+
+    uint64_t Bandwidth = Bbr3CongestionControlGetBandwidth(Cc);
+    if (Bandwidth == 0) {
+        return;
+    }
+
+    uint64_t Rate =
+        Bandwidth * Bbr->PacingGain / GAIN_UNIT *
+        (100 - BBR3_PACING_MARGIN_PERCENT) / 100;
+
+    //
+    // Never slow down during STARTUP, before the pipe is known to be full.
+    //
+    if (Bbr->FilledPipe || Rate > Bbr->PacingRate) {
+        Bbr->PacingRate = Rate;
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlSetSendQuantum(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+
+    const uint16_t DatagramPayloadLength =
+        QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+
+    if (Bbr->PacingRate < BBR3_LOW_PACING_RATE_THRESHOLD * BW_UNIT) {
+        Bbr->SendQuantum = (uint64_t)DatagramPayloadLength;
+    } else if (Bbr->PacingRate < BBR3_HIGH_PACING_RATE_THRESHOLD * BW_UNIT) {
+        Bbr->SendQuantum = (uint64_t)DatagramPayloadLength * 2;
+    } else {
+        Bbr->SendQuantum = CXPLAT_MIN(Bbr->PacingRate / 1000 / BW_UNIT, 64 * 1024 /* 64k */);
+    }
+}
+
+//
+// Updates the congestion window for the newly acknowledged bytes, then
+// applies the bounds of the model.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlSetCongestionWindow(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TotalBytesAcked,
+    _In_ uint32_t AckedBytes
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+
+    uint32_t MinCongestionWindow = Bbr3CongestionControlGetMinCongestionWindow(Cc);
+
+    uint64_t ExtraAcked = 0;
+    if (Bbr->FilledPipe) {
+        QUIC_SLIDING_WINDOW_EXTREMUM_ENTRY Entry = (QUIC_SLIDING_WINDOW_EXTREMUM_ENTRY) { .Value = 0, .Time = 0 };
+        if (QUIC_SUCCEEDED(QuicSlidingWindowExtremumGet(&Bbr->MaxAckHeightFilter, &Entry))) {
+            ExtraAcked = Entry.Value;
+        }
+    }
+
+    uint64_t MaxInflight =
+        Bbr3CongestionControlQuantizationBudget(
+            Cc,
+            Bbr3CongestionControlGetBdpMultiple(
+                Cc, Bbr3CongestionControlGetBandwidth(Cc), Bbr->CwndGain) + ExtraAcked);
+
+    uint64_t CongestionWindow = Bbr->CongestionWindow;
+
+    if (Bbr->PacketConservation) {
+        CongestionWindow = CXPLAT_MAX(CongestionWindow, (uint64_t)Bbr->BytesInFlight + AckedBytes);
+    } else {
+        if (Bbr->FilledPipe) {
+            CongestionWindow = CXPLAT_MIN(CongestionWindow + AckedBytes, MaxInflight);
+        } else if (CongestionWindow < MaxInflight || TotalBytesAcked < Bbr->InitialCongestionWindow) {
+            CongestionWindow += AckedBytes;
+        }
+        CongestionWindow = CXPLAT_MAX(CongestionWindow, MinCongestionWindow);
+    }
+
+    if (Bbr->State == BBR3_STATE_PROBE_RTT) {
+        CongestionWindow =
+            CXPLAT_MIN(CongestionWindow, Bbr3CongestionControlGetProbeRttCongestionWindow(Cc));
+    }
+
+    uint64_t Cap = UINT32_MAX;
+    if (Bbr3CongestionControlIsInProbeBw(Bbr) && Bbr->State != BBR3_STATE_PROBE_BW_CRUISE) {
+        Cap = Bbr->InflightHi;
+    } else if (Bbr->State == BBR3_STATE_PROBE_RTT || Bbr->State == BBR3_STATE_PROBE_BW_CRUISE) {
+        Cap = Bbr3CongestionControlGetInflightWithHeadroom(Cc);
+    }
+    Cap = CXPLAT_MIN(Cap, Bbr->InflightLo);
+    Cap = CXPLAT_MAX(Cap, MinCongestionWindow);
+
+    Bbr->CongestionWindow = (uint32_t)CXPLAT_MIN(CongestionWindow, Cap);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+Bbr3CongestionControlGetSendAllowance(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeSinceLastSend, // microsec
+    _In_ BOOLEAN TimeSinceLastSendValid
+    )
+{
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+
+    uint32_t CongestionWindow = Bbr3CongestionControlGetCongestionWindow(Cc);
+
+    uint32_t SendAllowance = 0;
+
+    if (Bbr->BytesInFlight >= CongestionWindow) {
+        //
+        // We are CC blocked, so we can't send anything.
+        //
+        SendAllowance = 0;
+
+    } else if (
+        !TimeSinceLastSendValid ||
+        !Connection->Settings.PacingEnabled ||
+        Bbr->PacingRate == 0 ||
+        Bbr->MinRtt == UINT64_MAX ||
+        Bbr->MinRtt < QUIC_SEND_PACING_INTERVAL ||
+        TimeSinceLastSend > Bbr->MinRtt) {
+        //
+        // We're not in the necessary state to pace.
+        //
+        SendAllowance = CongestionWindow - Bbr->BytesInFlight;
+
+    } else {
+        //
+        // We are pacing, so send the bytes the pacing rate allows for the time
+        // since the last send.
+        //
+        uint64_t PacedAllowance =
+            Bbr->PacingRate * TimeSinceLastSend / S_TO_US(1) / BW_UNIT;
+
+        SendAllowance = (uint32_t)CXPLAT_MIN(PacedAllowance, CongestionWindow - Bbr->BytesInFlight);
+
+        if (SendAllowance > (CongestionWindow >> 2)) {
+            SendAllowance = CongestionWindow >> 2; // Don't send more than a quarter of the current window.
+        }
+    }
+    return SendAllowance;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+Bbr3CongestionControlOnDataAcknowledged(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_ACK_EVENT* AckEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+
+    BOOLEAN PreviousCanSendState = Bbr3CongestionControlCanSend(Cc);
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+
+    if (AckEvent->IsImplicit) {
+        Bbr3CongestionControlSetCongestionWindow(
+            Cc, AckEvent->NumTotalAckedRetransmittableBytes, AckEvent->NumRetransmittableBytes);
+
+        if (Connection->Settings.NetStatsEventEnabled) {
+            Bbr3CongestionControlIndicateConnectionEvent(Connection, Cc);
+        }
+        return Bbr3CongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+    }
+
+    CXPLAT_DBG_ASSERT(Bbr->BytesInFlight >= AckEvent->NumRetransmittableBytes);
+    Bbr->BytesInFlight -= AckEvent->NumRetransmittableBytes;
+
+    if (Bbr->AppLimited && Bbr->AppLimitedExitTarget < AckEvent->LargestAck) {
+        Bbr->AppLimited = FALSE;
+    }
+
+    //
+    // Take the delivery rate and data delivered samples from the newly
+    // acknowledged packets. These, and the ECN counts reported just before
+    // this ACK, count towards the round trip this ACK may be ending.
+    //
+    uint64_t DeliveryRate = 0;
+    uint32_t Delivered = 0;
+    BOOLEAN HasRateSample = FALSE;
+    BOOLEAN SampleAppLimited =
+        AckEvent->AckedPackets == NULL ? FALSE : AckEvent->IsLargestAckedPacketAppLimited;
+
+    for (const QUIC_SENT_PACKET_METADATA* AckedPacket = AckEvent->AckedPackets;
+         AckedPacket != NULL;
+         AckedPacket = AckedPacket->Next) {
+
+        Bbr->AckedPacketsInRound++;
+
+        if (AckedPacket->PacketLength == 0) {
+            continue;
+        }
+
+        uint64_t Rate;
+        if (BbrGetDeliveryRate(AckedPacket, AckEvent, &Rate)) {
+            DeliveryRate = CXPLAT_MAX(DeliveryRate, Rate);
+            HasRateSample = TRUE;
+        }
+
+        if (AckedPacket->LastAckedPacketInfo != NULL) {
+            uint64_t PacketDelivered =
+                AckEvent->NumTotalAckedRetransmittableBytes -
+                AckedPacket->LastAckedPacketInfo->TotalBytesAcked;
+            Delivered = (uint32_t)CXPLAT_MAX(Delivered, CXPLAT_MIN(PacketDelivered, UINT32_MAX));
+        }
+    }
+
+    if (HasRateSample &&
+        (DeliveryRate >= Bbr3CongestionControlGetMaxBandwidth(Cc) || !SampleAppLimited)) {
+        QuicSlidingWindowExtremumUpdateMax(&Bbr->MaxBwFilter, DeliveryRate, Bbr->CycleCount);
+    }
+    Bbr->BwLatest = CXPLAT_MAX(Bbr->BwLatest, DeliveryRate);
+    Bbr->InflightLatest = CXPLAT_MAX(Bbr->InflightLatest, Delivered);
+
+    Bbr->RoundStart = FALSE;
+    if (!Bbr->EndOfRoundTripValid || Bbr->EndOfRoundTrip < AckEvent->LargestAck) {
+        Bbr->RoundTripCounter++;
+        Bbr->RoundsSinceBwProbe++;
+        Bbr->RoundStart = TRUE;
+        Bbr3CongestionControlStartRound(Cc);
+        Bbr3CongestionControlUpdateCongestionSignals(Cc);
+    }
+
+    if (Bbr->InRecovery) {
+        if (Bbr->RoundStart) {
+            Bbr->PacketConservation = FALSE;
+        }
+        if (!AckEvent->HasLoss && Bbr->EndOfRecovery < AckEvent->LargestAck) {
+            Bbr->InRecovery = FALSE;
+            Bbr->PacketConservation = FALSE;
+            Bbr3CongestionControlRestoreCongestionWindow(Bbr);
+            QuicTraceEvent(
+                ConnRecoveryExit,
+                "[conn][%p] Recovery complete",
+                Connection);
+        }
+    }
+
+    Bbr3CongestionControlUpdateAckAggregation(Cc, AckEvent);
+
+    Bbr3CongestionControlCheckFullBwReached(Bbr, SampleAppLimited);
+    if (Bbr->State == BBR3_STATE_STARTUP && Bbr->FilledPipe) {
+        Bbr3CongestionControlEnterDrain(Bbr);
+    }
+    if (Bbr->State == BBR3_STATE_DRAIN &&
+        Bbr->BytesInFlight <= Bbr3CongestionControlGetInflight(Cc, GAIN_UNIT)) {
+        Bbr3CongestionControlStartProbeBwDown(Cc, AckEvent->TimeNow);
+    }
+
+    Bbr3CongestionControlUpdateProbeBwCyclePhase(Cc, AckEvent, SampleAppLimited);
+    Bbr3CongestionControlUpdateMinRtt(Bbr, AckEvent);
+    Bbr3CongestionControlCheckProbeRtt(Cc, AckEvent);
+
+    if (Bbr->RoundStart) {
+        //
+        // Start collecting the congestion signals for the next round.
+        //
+        Bbr3CongestionControlResetCongestionSignals(Bbr);
+        Bbr->BwLatest = DeliveryRate;
+        Bbr->InflightLatest = Delivered;
+        Bbr->TxInflight = Bbr->BytesInFlight;
+        Bbr->CwndLimitedInRound = FALSE;
+    }
+
+    Bbr3CongestionControlSetPacingRate(Cc);
+    Bbr3CongestionControlSetSendQuantum(Cc);
+    Bbr3CongestionControlSetCongestionWindow(
+        Cc, AckEvent->NumTotalAckedRetransmittableBytes, AckEvent->NumRetransmittableBytes);
+
+    QuicConnLogBbr3(Connection);
+
+    if (Connection->Settings.NetStatsEventEnabled) {
+        Bbr3CongestionControlIndicateConnectionEvent(Connection, Cc);
+    }
+
+    return Bbr3CongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlOnDataLost(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_LOSS_EVENT* LossEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+
+    BOOLEAN PreviousCanSendState = Bbr3CongestionControlCanSend(Cc);
+
+    CXPLAT_DBG_ASSERT(LossEvent->NumRetransmittableBytes > 0);
+
+    CXPLAT_DBG_ASSERT(Bbr->BytesInFlight >= LossEvent->NumRetransmittableBytes);
+    Bbr->BytesInFlight -= LossEvent->NumRetransmittableBytes;
+
+    uint32_t MinCongestionWindow = Bbr3CongestionControlGetMinCongestionWindow(Cc);
+
+    if (!Bbr->InRecovery) {
+        QuicTraceEvent(
+            ConnCongestionV2,
+            "[conn][%p] Congestion event: IsEcn=%hu",
+            Connection,
+            FALSE);
+        Connection->Stats.Send.CongestionCount++;
+
+        //
+        // Follow packet conservation for the first round of recovery.
+        //
+        Bbr->PriorCongestionWindow = Bbr3CongestionControlSaveCongestionWindow(Bbr);
+        Bbr->InRecovery = TRUE;
+        Bbr->PacketConservation = TRUE;
+        Bbr->CongestionWindow =
+            CXPLAT_MAX(
+                Bbr->BytesInFlight + QuicPathGetDatagramPayloadSize(&Connection->Paths[0]),
+                MinCongestionWindow);
+        Bbr3CongestionControlStartRound(Cc);
+    } else {
+        Bbr->CongestionWindow =
+            Bbr->CongestionWindow > LossEvent->NumRetransmittableBytes + MinCongestionWindow
+            ? Bbr->CongestionWindow - LossEvent->NumRetransmittableBytes
+            : MinCongestionWindow;
+    }
+    Bbr->EndOfRecovery = LossEvent->LargestSentPacketNumber;
+
+    Bbr->LossInRound = TRUE;
+    Bbr->LossBytesInRound += LossEvent->NumRetransmittableBytes;
+    Bbr->LossEventsInRound++;
+
+    if (Bbr->BwProbeSamples && Bbr3CongestionControlIsInflightTooHigh(Cc, FALSE)) {
+        Bbr3CongestionControlHandleInflightTooHigh(Cc, LossEvent->TimeNow);
+    }
+
+    if (LossEvent->PersistentCongestion) {
+        Bbr->PriorCongestionWindow = Bbr3CongestionControlSaveCongestionWindow(Bbr);
+        Bbr->CongestionWindow = MinCongestionWindow;
+
+        QuicTraceEvent(
+            ConnPersistentCongestion,
+            "[conn][%p] Persistent congestion event",
+            Connection);
+        Connection->Stats.Send.PersistentCongestionCount++;
+    }
+
+    Bbr3CongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+    QuicConnLogBbr3(Connection);
+}
+
+//
+// CE marks are accumulated and acted on once per round trip.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlOnEcn(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_ECN_EVENT* EcnEvent
+    )
+{
+    Cc->Bbr3.CeCountInRound += EcnEvent->NewCeCount;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+Bbr3CongestionControlOnSpuriousCongestionEvent(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    UNREFERENCED_PARAMETER(Cc);
+    return FALSE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlSetAppLimited(
+    _In_ struct QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    if (Cc->Bbr3.BytesInFlight > Bbr3CongestionControlGetCongestionWindow(Cc)) {
+        return;
+    }
+
+    Bbr3CongestionControlMarkAppLimited(Cc);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlInitializeState(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ BOOLEAN FullReset
+    )
+{
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    const QUIC_PATH* Path = &Connection->Paths[0];
+
+    const uint16_t DatagramPayloadLength = QuicPathGetDatagramPayloadSize(Path);
+
+    Bbr->CongestionWindow = Bbr->InitialCongestionWindowPackets * DatagramPayloadLength;
+    Bbr->InitialCongestionWindow = Bbr->InitialCongestionWindowPackets * DatagramPayloadLength;
+    Bbr->PriorCongestionWindow = Bbr->CongestionWindow;
+    Bbr->BytesInFlightMax = Bbr->CongestionWindow / 2;
+
+    if (FullReset) {
+        Bbr->BytesInFlight = 0;
+    }
+    Bbr->Exemptions = 0;
+
+    Bbr->FilledPipe = FALSE;
+    Bbr->RoundStart = FALSE;
+    Bbr->EndOfRoundTripValid = FALSE;
+    Bbr->EndOfRoundTrip = 0;
+    Bbr->RoundTripCounter = 0;
+    Bbr->InRecovery = FALSE;
+    Bbr->PacketConservation = FALSE;
+    Bbr->EndOfRecovery = 0;
+    Bbr->IdleRestart = FALSE;
+    Bbr->AppLimited = FALSE;
+    Bbr->AppLimitedExitTarget = 0;
+    Bbr->BwProbeSamples = FALSE;
+    Bbr->AckPhase = BBR3_ACK_PHASE_INIT;
+
+    Bbr->CycleCount = 0;
+    Bbr->CycleStart = 0;
+    Bbr->BwProbeWait = 0;
+    Bbr->RoundsSinceBwProbe = 0;
+    Bbr->BwProbeUpCount = UINT32_MAX;
+    Bbr->BwProbeUpAcks = 0;
+    Bbr->BwProbeUpRounds = 0;
+
+    Bbr3CongestionControlResetFullBw(Bbr);
+    Bbr3CongestionControlResetLowerBounds(Bbr);
+    Bbr3CongestionControlResetCongestionSignals(Bbr);
+    Bbr->InflightHi = UINT32_MAX;
+    Bbr->TxInflight = Bbr->BytesInFlight;
+    Bbr->CwndLimitedInRound = FALSE;
+    Bbr->CeRatio = 0;
+    Bbr->EcnAlpha = 0;
+
+    Bbr->MinRtt = UINT64_MAX;
+    Bbr->MinRttTimestamp = 0;
+    Bbr->ProbeRttMinDelay = UINT64_MAX;
+    Bbr->ProbeRttMinTimestamp = 0;
+    Bbr->ProbeRttExpired = FALSE;
+    Bbr->ProbeRttDoneTimeValid = FALSE;
+    Bbr->ProbeRttDoneTime = 0;
+    Bbr->ProbeRttRoundDone = FALSE;
+
+    Bbr->AckAggregationStartTimeValid = FALSE;
+    Bbr->AckAggregationStartTime = 0;
+    Bbr->AggregatedAckBytes = 0;
+    QuicSlidingWindowExtremumReset(&Bbr->MaxAckHeightFilter);
+    QuicSlidingWindowExtremumReset(&Bbr->MaxBwFilter);
+
+    //
+    // Until there's a bandwidth sample, pace the initial window over the
+    // smoothed RTT, scaled by the startup gain.
+    //
+    uint64_t SmoothedRtt =
+        Path->GotFirstRttSample ? Path->SmoothedRtt : MS_TO_US(QUIC_INITIAL_RTT);
+    if (SmoothedRtt == 0) {
+        SmoothedRtt = 1;
+    }
+    Bbr->PacingRate =
+        (uint64_t)Bbr->InitialCongestionWindow * BW_UNIT * S_TO_US(1) / SmoothedRtt *
+        BBR3_STARTUP_PACING_GAIN / GAIN_UNIT;
+    Bbr->SendQuantum = 0;
+
+    Bbr3CongestionControlEnterStartup(Bbr);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlReset(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ BOOLEAN FullReset
+    )
+{
+    Bbr3CongestionControlInitializeState(Cc, FullReset);
+
+    Bbr3CongestionControlLogOutFlowStatus(Cc);
+    QuicConnLogBbr3(QuicCongestionControlGetConnection(Cc));
+}
+
+static const QUIC_CONGESTION_CONTROL QuicCongestionControlBbr3 = {
+    .Name = "BBRv3",
+    .QuicCongestionControlCanSend = Bbr3CongestionControlCanSend,
+    .QuicCongestionControlSetExemption = Bbr3CongestionControlSetExemption,
+    .QuicCongestionControlReset = Bbr3CongestionControlReset,
+    .QuicCongestionControlGetSendAllowance = Bbr3CongestionControlGetSendAllowance,
+    .QuicCongestionControlGetCongestionWindow = Bbr3CongestionControlGetCongestionWindow,
+    .QuicCongestionControlOnDataSent = Bbr3CongestionControlOnDataSent,
+    .QuicCongestionControlOnDataInvalidated = Bbr3CongestionControlOnDataInvalidated,
+    .QuicCongestionControlOnDataAcknowledged = Bbr3CongestionControlOnDataAcknowledged,
+    .QuicCongestionControlOnDataLost = Bbr3CongestionControlOnDataLost,
+    .QuicCongestionControlOnEcn = Bbr3CongestionControlOnEcn,
+    .QuicCongestionControlOnSpuriousCongestionEvent = Bbr3CongestionControlOnSpuriousCongestionEvent,
+    .QuicCongestionControlLogOutFlowStatus = Bbr3CongestionControlLogOutFlowStatus,
+    .QuicCongestionControlGetExemptions = Bbr3CongestionControlGetExemptions,
+    .QuicCongestionControlGetBytesInFlightMax = Bbr3CongestionControlGetBytesInFlightMax,
+    .QuicCongestionControlIsAppLimited = Bbr3CongestionControlIsAppLimited,
+    .QuicCongestionControlSetAppLimited = Bbr3CongestionControlSetAppLimited,
+};
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlInitialize(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_SETTINGS_INTERNAL* Settings
+    )
+{
+    *Cc = QuicCongestionControlBbr3;
+
+    QUIC_CONGESTION_CONTROL_BBR3* Bbr = &Cc->Bbr3;
+
+    Bbr->InitialCongestionWindowPackets = Settings->InitialWindowPackets;
+    Bbr->BytesInFlight = 0;
+
+    Bbr->MaxBwFilter = QuicSlidingWindowExtremumInitialize(
+            BBR3_MAX_BW_FILTER_LENGTH, kBbrDefaultFilterCapacity, Bbr->MaxBwFilterEntries);
+    Bbr->MaxAckHeightFilter = QuicSlidingWindowExtremumInitialize(
+            BBR3_EXTRA_ACKED_FILTER_LENGTH, kBbrDefaultFilterCapacity, Bbr->MaxAckHeightFilterEntries);
+
+    Bbr3CongestionControlInitializeState(Cc, TRUE);
+
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    QuicConnLogOutFlowStats(Connection);
+    QuicConnLogBbr3(Connection);
+}
@@ -0,0 +1,254 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+--*/
+
+#pragma once
+
+#include "bbr.h"
+
+typedef struct QUIC_CONGESTION_CONTROL_BBR3 {
+
+    //
+    // TRUE once STARTUP has estimated that the pipe is full.
+    //
+    BOOLEAN FilledPipe : 1;
+
+    //
+    // TRUE if the current ACK started a new packet-timed round trip.
+    //
+    BOOLEAN RoundStart : 1;
+
+    //
+    // TRUE if EndOfRoundTrip is valid.
+    //
+    BOOLEAN EndOfRoundTripValid : 1;
+
+    //
+    // TRUE if any loss was detected in the current round trip.
+    //
+    BOOLEAN LossInRound : 1;
+
+    //
+    // TRUE if the sender was limited by the congestion window at any point in
+    // the current round trip.
+    //
+    BOOLEAN CwndLimitedInRound : 1;
+
+    //
+    // TRUE if the most recent bandwidth plateau check estimates the current
+    // bandwidth is fully utilized.
+    //
+    BOOLEAN FullBwNow : 1;
+
+    //
+    // TRUE while the ACKs being received are for data sent while probing for
+    // bandwidth, and so may be used to lower InflightHi.
+    //
+    BOOLEAN BwProbeSamples : 1;
+
+    //
+    // TRUE when restarting from idle, to avoid entering PROBE_RTT on the
+    // first ACK.
+    //
+    BOOLEAN IdleRestart : 1;
+
+    //
+    // TRUE if at least one round trip has completed in PROBE_RTT.
+    //
+    BOOLEAN ProbeRttRoundDone : 1;
+
+    //
+    // TRUE if ProbeRttDoneTime is valid.
+    //
+    BOOLEAN ProbeRttDoneTimeValid : 1;
+
+    //
+    // TRUE if the 5 second ProbeRttMinDelay sample has expired.
+    //
+    BOOLEAN ProbeRttExpired : 1;
+
+    //
+    // TRUE if the bandwidth samples are currently limited by the application.
+    //
+    BOOLEAN AppLimited : 1;
+
+    //
+    // TRUE if AckAggregationStartTime is valid.
+    //
+    BOOLEAN AckAggregationStartTimeValid : 1;
+
+    //
+    // TRUE while in loss recovery, and for the first round trip of it, while
+    // following packet conservation.
+    //
+    BOOLEAN InRecovery : 1;
+    BOOLEAN PacketConservation : 1;
+
+    //
+    // The size of the initial congestion window in packets.
+    //
+    uint32_t InitialCongestionWindowPackets;
+
+    uint32_t CongestionWindow; // bytes
+
+    uint32_t InitialCongestionWindow; // bytes
+
+    //
+    // The last congestion window before entering recovery or PROBE_RTT, that
+    // is restored on exit.
+    //
+    uint32_t PriorCongestionWindow; // bytes
+
+    //
+    // The number of bytes considered to be still in the network.
+    //
+    uint32_t BytesInFlight;
+    uint32_t BytesInFlightMax;
+
+    //
+    // A count of packets which can be sent ignoring CongestionWindow.
+    //
+    uint8_t Exemptions;
+
+    //
+    // The number of startup round trips with no significant bandwidth growth.
+    //
+    uint8_t FullBwCount;
+
+    //
+    // Current state of the BBR3_STATE state machine.
+    //
+    uint8_t State;
+
+    //
+    // Where the ACKs currently being received fall in the bandwidth probing
+    // cycle (BBR3_ACK_PHASE).
+    //
+    uint8_t AckPhase;
+
+    //
+    // The dynamic gain factors (in units of GAIN_UNIT) used to scale the
+    // estimated bandwidth to produce the pacing rate, and the estimated BDP to
+    // produce the congestion window.
+    //
+    uint32_t PacingGain;
+    uint32_t CwndGain;
+
+    //
+    // Count of packet-timed round trips, and the packet number which must be
+    // acknowledged to end the current one.
+    //
+    uint64_t RoundTripCounter;
+    uint64_t EndOfRoundTrip;
+
+    //
+    // Any ACK for a packet number after EndOfRecovery exits recovery.
+    //
+    uint64_t EndOfRecovery;
+
+    //
+    // Application limited samples are ignored until a packet number after
+    // AppLimitedExitTarget is acknowledged.
+    //
+    uint64_t AppLimitedExitTarget;
+
+    //
+    // The current pacing rate, in bytes / BW_UNIT per second.
+    //
+    uint64_t PacingRate;
+
+    //
+    // The maximum size of a burst of packets sent back to back.
+    //
+    uint64_t SendQuantum;
+
+    //
+    // The windowed max of the delivery rate over the last two bandwidth probing
+    // cycles, indexed by CycleCount.
+    //
+    QUIC_SLIDING_WINDOW_EXTREMUM MaxBwFilter;
+    QUIC_SLIDING_WINDOW_EXTREMUM_ENTRY MaxBwFilterEntries[kBbrDefaultFilterCapacity];
+    uint64_t CycleCount;
+
+    //
+    // The max delivery rate and data delivered seen in the current round trip.
+    //
+    uint64_t BwLatest;
+    uint32_t InflightLatest; // bytes
+
+    //
+    // The short-term lower bounds on bandwidth and inflight, adapted on loss
+    // and ECN outside of bandwidth probing. UINT64_MAX / UINT32_MAX if unset.
+    //
+    uint64_t BwLo;
+    uint32_t InflightLo; // bytes
+
+    //
+    // The long-term upper bound on inflight, learned when probing for
+    // bandwidth causes loss or CE marks. UINT32_MAX if unset.
+    //
+    uint32_t InflightHi; // bytes
+
+    //
+    // The bandwidth at the start of the current plateau check.
+    //
+    uint64_t FullBw;
+
+    //
+    // The congestion signals seen in the current round trip. TxInflight is the
+    // largest bytes in flight seen in the round, used to calculate the loss
+    // rate.
+    //
+    uint32_t TxInflight; // bytes
+    uint32_t LossBytesInRound;
+    uint32_t LossEventsInRound;
+    uint64_t AckedPacketsInRound;
+    uint64_t CeCountInRound;
+
+    //
+    // The fraction of packets CE marked in the last round trip, and its moving
+    // average, in units of GAIN_UNIT.
+    //
+    uint32_t CeRatio;
+    uint32_t EcnAlpha;
+
+    //
+    // Bandwidth probing cycle state for the PROBE_BW states.
+    //
+    uint64_t CycleStart; // microseconds
+    uint64_t BwProbeWait; // microseconds
+    uint32_t RoundsSinceBwProbe;
+    uint32_t BwProbeUpCount; // bytes
+    uint32_t BwProbeUpAcks; // bytes
+    uint32_t BwProbeUpRounds;
+
+    //
+    // The windowed min RTT over 10 seconds, and the min RTT over the shorter
+    // 5 second window used to schedule PROBE_RTT.
+    //
+    uint64_t MinRtt; // microseconds
+    uint64_t MinRttTimestamp; // microseconds
+    uint64_t ProbeRttMinDelay; // microseconds
+    uint64_t ProbeRttMinTimestamp; // microseconds
+    uint64_t ProbeRttDoneTime; // microseconds
+
+    //
+    // The max filter tracking the recent maximum degree of aggregation in the
+    // path, used to provision extra inflight.
+    //
+    uint64_t AckAggregationStartTime;
+    uint64_t AggregatedAckBytes;
+    QUIC_SLIDING_WINDOW_EXTREMUM MaxAckHeightFilter;
+    QUIC_SLIDING_WINDOW_EXTREMUM_ENTRY MaxAckHeightFilterEntries[kBbrDefaultFilterCapacity];
+
+} QUIC_CONGESTION_CONTROL_BBR3;
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlInitialize(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_SETTINGS_INTERNAL* Settings
+    );
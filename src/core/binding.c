@@ -741,6 +741,14 @@ Exit:
     return StatelessCtx;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicBindingSendStatelessResponse(
+    _In_ QUIC_BINDING* Binding,
+    _In_ uint32_t OperationType,
+    _In_ QUIC_RX_PACKET* RecvPacket
+    );
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 BOOLEAN
 QuicBindingQueueStatelessOperation(
@@ -754,7 +762,30 @@ QuicBindingQueueStatelessOperation(
         return FALSE;
     }
 
+#if QUIC_STATELESS_RESPONSE_INLINE
+    //
+    // Respond right away, without waiting for a worker or allocating anything.
+    // Each processor remembers the remote addresses it recently responded to,
+    // so each gets one response per expiration period, and is limited to a
+    // rate of responses, which bounds how much can be reflected at spoofed
+    // addresses. The packet is returned by the caller.
+    //
+    if (!QuicLibraryTryRecordStatelessResponse(
+            QuicAddrHash(&Packet->Route->RemoteAddress), CxPlatTimeMs32())) {
+        QuicPacketLogDrop(Binding, Packet, "Recent stateless response to remote address");
+        return FALSE;
+    }
+
+    if (!QuicLibraryTryTakeStatelessResponseToken(CxPlatTimeUs64())) {
+        QuicPacketLogDrop(Binding, Packet, "Stateless response rate limit reached");
+        return FALSE;
+    }
+
+    QuicBindingSendStatelessResponse(Binding, OperType, Packet);
+    return FALSE;
+#else
     QUIC_WORKER* Worker = QuicLibraryGetWorker(Packet);
+
     if (QuicWorkerIsOverloaded(Worker)) {
         QuicPacketLogDrop(Binding, Packet, "Stateless worker overloaded (stateless oper)");
         return FALSE;
@@ -782,27 +813,25 @@ QuicBindingQueueStatelessOperation(
     QuicWorkerQueueOperation(Worker, Oper);
 
     return TRUE;
+#endif
 }
 
-_IRQL_requires_max_(PASSIVE_LEVEL)
+//
+// Builds and sends a stateless response to the received packet, using only the
+// datapath's send buffers.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
 void
-QuicBindingProcessStatelessOperation(
+QuicBindingSendStatelessResponse(
+    _In_ QUIC_BINDING* Binding,
     _In_ uint32_t OperationType,
-    _In_ QUIC_STATELESS_CONTEXT* StatelessCtx
+    _In_ QUIC_RX_PACKET* RecvPacket
     )
 {
-    QUIC_BINDING* Binding = StatelessCtx->Binding;
-    QUIC_RX_PACKET* RecvPacket = StatelessCtx->Packet;
     QUIC_BUFFER* SendDatagram = NULL;
 
     CXPLAT_DBG_ASSERT(RecvPacket->ValidatedHeaderInv);
 
-    QuicTraceEvent(
-        BindingExecOper,
-        "[bind][%p] Execute: %u",
-        Binding,
-        OperationType);
-
     CXPLAT_SEND_CONFIG SendConfig = { RecvPacket->Route, 0, CXPLAT_ECN_NON_ECT, 0 };
     CXPLAT_SEND_DATA* SendData = CxPlatSendDataAlloc(Binding->Socket, &SendConfig);
     if (SendData == NULL) {
@@ -1064,6 +1093,23 @@ Exit:
     }
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicBindingProcessStatelessOperation(
+    _In_ uint32_t OperationType,
+    _In_ QUIC_STATELESS_CONTEXT* StatelessCtx
+    )
+{
+    QuicTraceEvent(
+        BindingExecOper,
+        "[bind][%p] Execute: %u",
+        StatelessCtx->Binding,
+        OperationType);
+
+    QuicBindingSendStatelessResponse(
+        StatelessCtx->Binding, OperationType, StatelessCtx->Packet);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicBindingReleaseStatelessOperation(
@@ -1270,6 +1316,7 @@ QuicBindingCreateConnection(
     QUIC_STATUS Status =
         QuicConnAlloc(
             MsQuicLib.StatelessRegistration,
+            Packet->PartitionIndex,
             Worker,
             Packet,
             &NewConnection);
@@ -1403,6 +1450,107 @@ QuicBindingDropBlockedSourcePorts(
     return FALSE;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicRxBatchReset(
+    _Out_ QUIC_RX_BATCH* Batch
+    )
+{
+    Batch->GroupCount = 0;
+    Batch->LastGroup = NULL;
+    CxPlatZeroMemory(Batch->Index, sizeof(Batch->Index));
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicRxBatchGroupMatches(
+    _In_ const QUIC_RX_BATCH_GROUP* Group,
+    _In_ const QUIC_RX_PACKET* Packet,
+    _In_ BOOLEAN SingleGroup
+    )
+{
+    const QUIC_RX_PACKET* First = (const QUIC_RX_PACKET*)Group->Chain;
+    return
+        SingleGroup ||
+        (Packet->DestCidLen == First->DestCidLen &&
+         memcmp(Packet->DestCid, First->DestCid, Packet->DestCidLen) == 0);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicRxBatchAdd(
+    _Inout_ QUIC_RX_BATCH* Batch,
+    _In_ QUIC_RX_PACKET* Packet,
+    _In_ BOOLEAN SingleGroup
+    )
+{
+    CXPLAT_STATIC_ASSERT(
+        QUIC_RX_BATCH_HASH_SIZE >= 2 * QUIC_RX_BATCH_MAX_GROUPS &&
+        (QUIC_RX_BATCH_HASH_SIZE & (QUIC_RX_BATCH_HASH_SIZE - 1)) == 0,
+        "The index always has an empty entry to end a probe");
+    CXPLAT_STATIC_ASSERT(
+        QUIC_RX_BATCH_MAX_GROUPS < UINT8_MAX, "Index entries are 8 bits");
+
+    QUIC_RX_BATCH_GROUP* Group = Batch->LastGroup;
+    if (Group == NULL || !QuicRxBatchGroupMatches(Group, Packet, SingleGroup)) {
+        Group = NULL;
+        uint32_t i =
+            SingleGroup ?
+                0 :
+                CxPlatHashSimple(Packet->DestCidLen, Packet->DestCid) & (QUIC_RX_BATCH_HASH_SIZE - 1);
+        while (Batch->Index[i] != 0) {
+            QUIC_RX_BATCH_GROUP* Existing = &Batch->Groups[Batch->Index[i] - 1];
+            if (QuicRxBatchGroupMatches(Existing, Packet, SingleGroup)) {
+                Group = Existing;
+                break;
+            }
+            i = (i + 1) & (QUIC_RX_BATCH_HASH_SIZE - 1);
+        }
+
+        if (Group == NULL) {
+            if (Batch->GroupCount == QUIC_RX_BATCH_MAX_GROUPS) {
+                return FALSE;
+            }
+            Group = &Batch->Groups[Batch->GroupCount++];
+            Batch->Index[i] = (uint8_t)Batch->GroupCount;
+            Group->Chain = NULL;
+            Group->HandshakeTail = &Group->Chain;
+            Group->DataTail = &Group->Chain;
+            Group->Length = 0;
+            Group->Bytes = 0;
+        }
+        Batch->LastGroup = Group;
+    }
+
+    //
+    // Insert the datagram into the group's chain, with handshake packets
+    // first (we assume handshake packets don't come after non-handshake
+    // packets in a datagram).
+    // We do this so that we can more easily determine if the chain of
+    // packets can create a new connection.
+    //
+
+    CXPLAT_RECV_DATA* Datagram = (CXPLAT_RECV_DATA*)Packet;
+    Group->Length++;
+    Group->Bytes += Datagram->BufferLength;
+    if (!QuicPacketIsHandshake(Packet->Invariant)) {
+        *Group->DataTail = Datagram;
+        Group->DataTail = &Datagram->Next;
+    } else {
+        if (*Group->HandshakeTail == NULL) {
+            *Group->HandshakeTail = Datagram;
+            Group->HandshakeTail = &Datagram->Next;
+            Group->DataTail = &Datagram->Next;
+        } else {
+            Datagram->Next = *Group->HandshakeTail;
+            *Group->HandshakeTail = Datagram;
+            Group->HandshakeTail = &Datagram->Next;
+        }
+    }
+
+    return TRUE;
+}
+
 //
 // Looks up or creates a connection to handle a chain of packets.
 // Returns TRUE if the packets were delivered, and FALSE if they should be
@@ -1415,7 +1563,8 @@ QuicBindingDeliverPackets(
     _In_ QUIC_BINDING* Binding,
     _In_ QUIC_RX_PACKET* Packets,
     _In_ uint32_t PacketChainLength,
-    _In_ uint32_t PacketChainByteLength
+    _In_ uint32_t PacketChainByteLength,
+    _Inout_ QUIC_WORKER_QUEUE_BATCH* WorkerBatch
     )
 {
     CXPLAT_DBG_ASSERT(Packets->ValidatedHeaderInv);
@@ -1576,12 +1725,40 @@ QuicBindingDeliverPackets(
     }
 
     QuicConnQueueRecvPackets(
-        Connection, Packets, PacketChainLength, PacketChainByteLength);
+        Connection, Packets, PacketChainLength, PacketChainByteLength, WorkerBatch);
     QuicConnRelease(Connection, QUIC_CONN_REF_LOOKUP_RESULT);
 
     return TRUE;
 }
 
+//
+// Delivers each group of the batch, appending the ones that should be dropped
+// to the release chain, and resets the batch.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicBindingDeliverBatch(
+    _In_ QUIC_BINDING* Binding,
+    _Inout_ QUIC_RX_BATCH* Batch,
+    _Inout_ QUIC_WORKER_QUEUE_BATCH* WorkerBatch,
+    _Inout_ CXPLAT_RECV_DATA*** ReleaseChainTail
+    )
+{
+    for (uint32_t i = 0; i < Batch->GroupCount; ++i) {
+        QUIC_RX_BATCH_GROUP* Group = &Batch->Groups[i];
+        if (!QuicBindingDeliverPackets(
+                Binding,
+                (QUIC_RX_PACKET*)Group->Chain,
+                Group->Length,
+                Group->Bytes,
+                WorkerBatch)) {
+            **ReleaseChainTail = Group->Chain;
+            *ReleaseChainTail = Group->DataTail;
+        }
+    }
+    QuicRxBatchReset(Batch);
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 _Function_class_(CXPLAT_DATAPATH_RECEIVE_CALLBACK)
 void
@@ -1598,19 +1775,19 @@ QuicBindingReceive(
     QUIC_BINDING* Binding = (QUIC_BINDING*)RecvCallbackContext;
     CXPLAT_RECV_DATA* ReleaseChain = NULL;
     CXPLAT_RECV_DATA** ReleaseChainTail = &ReleaseChain;
-    CXPLAT_RECV_DATA* SubChain = NULL;
-    CXPLAT_RECV_DATA** SubChainTail = &SubChain;
-    CXPLAT_RECV_DATA** SubChainDataTail = &SubChain;
-    uint32_t SubChainLength = 0;
-    uint32_t SubChainBytes = 0;
+    QUIC_RX_BATCH Batch;
+    QUIC_WORKER_QUEUE_BATCH WorkerBatch;
     uint32_t TotalChainLength = 0;
     uint32_t TotalDatagramBytes = 0;
 
     CXPLAT_DBG_ASSERT(Socket == Binding->Socket);
 
     //
-    // Breaks the chain of datagrams into subchains by destination CID and
-    // delivers the subchains.
+    // Groups the whole chain of datagrams by destination CID and delivers
+    // each group, so that a connection is only looked up, and has its packets
+    // queued, once per group, however its datagrams are interleaved with
+    // others'. The connections that then need to be queued on their workers
+    // are all queued at the end.
     //
     // NB: All packets in a datagram are required to have the same destination
     // CID, so we don't split datagrams here. Later on, the packet handling
@@ -1618,6 +1795,9 @@ QuicBindingReceive(
     // connection it was delivered to.
     //
 
+    QuicRxBatchReset(&Batch);
+    WorkerBatch.Count = 0;
+
     const uint16_t Partition = DatagramChain->PartitionIndex;
     const uint64_t PartitionShifted = ((uint64_t)Partition + 1) << 40;
 
@@ -1643,6 +1823,7 @@ QuicBindingReceive(
         Packet->AvailBufferLength = Datagram->BufferLength;
         Packet->HeaderLength = 0;
         Packet->PayloadLength = 0;
+        Packet->RetainCount = 0;
         Packet->DestCidLen = 0;
         Packet->SourceCidLen = 0;
         Packet->KeyType = QUIC_PACKET_KEY_INITIAL;
@@ -1688,62 +1869,21 @@ QuicBindingReceive(
         CXPLAT_DBG_ASSERT(Packet->ValidatedHeaderInv);
 
         //
-        // If the next datagram doesn't match the current subchain, deliver the
-        // current subchain and start a new one.
+        // Add the datagram to the group for its destination CID, first
+        // delivering the groups so far if there's no room for a new one.
         // (If the binding is exclusively owned, all datagrams are delivered to
-        // the same connection and this chain-splitting step is skipped.)
+        // the same connection, so they all go in one group.)
         //
-        if (!Binding->Exclusive && SubChain != NULL) {
-            QUIC_RX_PACKET* SubChainPacket = (QUIC_RX_PACKET*)SubChain;
-            if ((Packet->DestCidLen != SubChainPacket->DestCidLen ||
-                 memcmp(Packet->DestCid, SubChainPacket->DestCid, Packet->DestCidLen) != 0)) {
-                if (!QuicBindingDeliverPackets(Binding, (QUIC_RX_PACKET*)SubChain, SubChainLength, SubChainBytes)) {
-                    *ReleaseChainTail = SubChain;
-                    ReleaseChainTail = SubChainDataTail;
-                }
-                SubChain = NULL;
-                SubChainTail = &SubChain;
-                SubChainDataTail = &SubChain;
-                SubChainLength = 0;
-                SubChainBytes = 0;
-            }
-        }
-
-        //
-        // Insert the datagram into the current chain, with handshake packets
-        // first (we assume handshake packets don't come after non-handshake
-        // packets in a datagram).
-        // We do this so that we can more easily determine if the chain of
-        // packets can create a new connection.
-        //
-
-        SubChainLength++;
-        SubChainBytes += Datagram->BufferLength;
-        if (!QuicPacketIsHandshake(Packet->Invariant)) {
-            *SubChainDataTail = Datagram;
-            SubChainDataTail = &Datagram->Next;
-        } else {
-            if (*SubChainTail == NULL) {
-                *SubChainTail = Datagram;
-                SubChainTail = &Datagram->Next;
-                SubChainDataTail = &Datagram->Next;
-            } else {
-                Datagram->Next = *SubChainTail;
-                *SubChainTail = Datagram;
-                SubChainTail = &Datagram->Next;
-            }
+        if (!QuicRxBatchAdd(&Batch, Packet, Binding->Exclusive)) {
+            QuicBindingDeliverBatch(Binding, &Batch, &WorkerBatch, &ReleaseChainTail);
+            BOOLEAN Added = QuicRxBatchAdd(&Batch, Packet, Binding->Exclusive);
+            CXPLAT_DBG_ASSERT(Added);
+            UNREFERENCED_PARAMETER(Added);
         }
     }
 
-    if (SubChain != NULL) {
-        //
-        // Deliver the last subchain.
-        //
-        if (!QuicBindingDeliverPackets(Binding, (QUIC_RX_PACKET*)SubChain, SubChainLength, SubChainBytes)) {
-            *ReleaseChainTail = SubChain;
-            ReleaseChainTail = SubChainTail; // cppcheck-suppress unreadVariable; NOLINT
-        }
-    }
+    QuicBindingDeliverBatch(Binding, &Batch, &WorkerBatch, &ReleaseChainTail);
+    QuicWorkerQueueBatchFlush(&WorkerBatch);
 
     if (ReleaseChain != NULL) {
         CxPlatRecvDataReturn(ReleaseChain);
@@ -5,6 +5,10 @@
 
 --*/
 
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
 typedef struct QUIC_PARTITIONED_HASHTABLE QUIC_PARTITIONED_HASHTABLE;
 typedef struct QUIC_STATELESS_CONTEXT QUIC_STATELESS_CONTEXT;
 
@@ -90,6 +94,13 @@ typedef struct QUIC_RX_PACKET {
     //
     uint16_t PayloadLength;
 
+    //
+    // Number of references on the (decrypted) datagram buffer, if it is
+    // retained by stream receive buffers, plus one for the receive path. Zero
+    // if the packet was never retained.
+    //
+    uint16_t RetainCount;
+
     //
     // Lengths of the destination and source connection IDs
     //
@@ -171,6 +182,52 @@ typedef struct QUIC_RX_PACKET {
 
 } QUIC_RX_PACKET;
 
+//
+// The most distinct destination CIDs a receive batch is grouped by. Once that
+// many are pending, they are delivered before any more are grouped.
+//
+#define QUIC_RX_BATCH_MAX_GROUPS    16
+#define QUIC_RX_BATCH_HASH_SIZE     32 // Power of 2, at least twice the above
+
+//
+// The datagrams of a receive batch with the same destination CID, handshake
+// packets first.
+//
+typedef struct QUIC_RX_BATCH_GROUP {
+
+    CXPLAT_RECV_DATA* Chain;
+    CXPLAT_RECV_DATA** HandshakeTail;
+    CXPLAT_RECV_DATA** DataTail;
+    uint32_t Length;
+    uint32_t Bytes;
+
+} QUIC_RX_BATCH_GROUP;
+
+//
+// Groups all the datagrams of a receive batch by destination CID, so that each
+// group is looked up and queued to its connection once, no matter how the
+// connections' datagrams are interleaved.
+//
+typedef struct QUIC_RX_BATCH {
+
+    uint32_t GroupCount;
+
+    //
+    // The group the last datagram was added to, checked first, since a
+    // connection's datagrams often arrive back to back.
+    //
+    QUIC_RX_BATCH_GROUP* LastGroup;
+
+    //
+    // Open addressing index of the groups by destination CID hash. Each entry
+    // is the index of a group plus one, or zero if unused.
+    //
+    uint8_t Index[QUIC_RX_BATCH_HASH_SIZE];
+
+    QUIC_RX_BATCH_GROUP Groups[QUIC_RX_BATCH_MAX_GROUPS];
+
+} QUIC_RX_BATCH;
+
 typedef enum QUIC_BINDING_LOOKUP_TYPE {
 
     QUIC_BINDING_LOOKUP_SINGLE,         // Single connection
@@ -272,6 +329,28 @@ typedef struct QUIC_BINDING {
 CXPLAT_DATAPATH_RECEIVE_CALLBACK QuicBindingReceive;
 CXPLAT_DATAPATH_UNREACHABLE_CALLBACK QuicBindingUnreachable;
 
+//
+// Resets the batch to hold no datagrams.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicRxBatchReset(
+    _Out_ QUIC_RX_BATCH* Batch
+    );
+
+//
+// Adds a validated datagram to the group for its destination CID (or to a
+// single group, if SingleGroup is set). Returns FALSE, without adding it, if
+// it needs a new group and the batch has no more room.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicRxBatchAdd(
+    _Inout_ QUIC_RX_BATCH* Batch,
+    _In_ QUIC_RX_PACKET* Packet,
+    _In_ BOOLEAN SingleGroup
+    );
+
 //
 // Initializes a new binding.
 //
@@ -421,7 +500,21 @@ QuicBindingOnConnectionHandshakeConfirmed(
     );
 
 //
-// Queues a stateless operation on the binding.
+// Stateless responses are sent inline, on the receive path, in user mode. In
+// kernel mode, receives are indicated from a DPC, so the hashing and
+// encryption needed to build a response are left to a worker instead.
+//
+#ifdef _KERNEL_MODE
+#define QUIC_STATELESS_RESPONSE_INLINE 0
+#else
+#define QUIC_STATELESS_RESPONSE_INLINE 1
+#endif
+
+//
+// Sends a stateless response of the given type (Retry, Version Negotiation or
+// Stateless Reset) to the packet, either inline or by queuing a stateless
+// operation on the binding. Returns TRUE if the packet was queued, and so is
+// still in use, and FALSE if it's no longer needed.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
 BOOLEAN
@@ -516,3 +609,7 @@ QuicRetryTokenDecrypt(
     CxPlatDispatchLockRelease(&MsQuicLib.StatelessRetryKeysLock);
     return QUIC_SUCCEEDED(Status);
 }
+
+#if defined(__cplusplus)
+}
+#endif
@@ -559,6 +559,38 @@ QuicConfigurationParamSet(
 
         return QUIC_STATUS_SUCCESS;
 
+    case QUIC_PARAM_CONFIGURATION_CONGESTION_CONTROL: {
+
+        if (Buffer == NULL ||
+            BufferLength < sizeof(QUIC_CONGESTION_CONTROL_CALLBACKS)) {
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+
+        const QUIC_CONGESTION_CONTROL_CALLBACKS* Callbacks =
+            (const QUIC_CONGESTION_CONTROL_CALLBACKS*)Buffer;
+        if (Callbacks->Version != QUIC_CONGESTION_CONTROL_CALLBACKS_VERSION ||
+            Callbacks->StateSize > QUIC_CONGESTION_CONTROL_MAX_STATE_SIZE ||
+            Callbacks->Reset == NULL ||
+            Callbacks->OnDataAcknowledged == NULL ||
+            Callbacks->OnDataLost == NULL ||
+            Callbacks->GetCongestionWindow == NULL) {
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+
+        //
+        // Connections reference the callbacks for their whole lifetime, so
+        // they can't be changed once set.
+        //
+        if (Configuration->CongestionControlSet) {
+            return QUIC_STATUS_INVALID_STATE;
+        }
+
+        Configuration->CongestionControl = *Callbacks;
+        Configuration->CongestionControlSet = TRUE;
+
+        return QUIC_STATUS_SUCCESS;
+    }
+
 #ifdef WIN32
     case QUIC_PARAM_CONFIGURATION_SCHANNEL_CREDENTIAL_ATTRIBUTE_W:
 
@@ -63,6 +63,13 @@ typedef struct QUIC_CONFIGURATION {
 #endif
     CXPLAT_STORAGE* AppSpecificStorage;
 
+    //
+    // Application provided congestion control, used instead of the built-in
+    // algorithms when CongestionControlSet is TRUE.
+    //
+    BOOLEAN CongestionControlSet;
+    QUIC_CONGESTION_CONTROL_CALLBACKS CongestionControl;
+
     //
     // Configurable (app & registry) settings.
     //
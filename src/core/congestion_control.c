@@ -40,5 +40,14 @@ QuicCongestionControlInitialize(
     case QUIC_CONGESTION_CONTROL_ALGORITHM_BBR:
         BbrCongestionControlInitialize(Cc, Settings);
         break;
+    case QUIC_CONGESTION_CONTROL_ALGORITHM_BBR3:
+        Bbr3CongestionControlInitialize(Cc, Settings);
+        break;
+    case QUIC_CONGESTION_CONTROL_ALGORITHM_PRAGUE:
+        PragueCongestionControlInitialize(Cc, Settings);
+        break;
+    case QUIC_CONGESTION_CONTROL_ALGORITHM_LEDBAT:
+        LedbatCongestionControlInitialize(Cc, Settings);
+        break;
     }
 }
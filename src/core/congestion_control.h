@@ -5,8 +5,16 @@
 
 --*/
 
+#include "app_congestion_control.h"
 #include "bbr.h"
+#include "bbr3.h"
 #include "cubic.h"
+#include "ledbat.h"
+#include "prague.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
 
 typedef struct QUIC_ACK_EVENT {
 
@@ -40,6 +48,12 @@ typedef struct QUIC_ACK_EVENT {
     //
     uint64_t OneWayDelay;
 
+    //
+    // The one-way delay sample of this ACK. Only valid if OneWayDelayValid,
+    // which requires timestamps to be negotiated.
+    //
+    uint64_t OneWayDelayLatest;
+
     //
     // Acked time minus ack delay.
     //
@@ -53,10 +67,14 @@ typedef struct QUIC_ACK_EVENT {
 
     BOOLEAN MinRttValid : 1;
 
+    BOOLEAN OneWayDelayValid : 1;
+
 } QUIC_ACK_EVENT;
 
 typedef struct QUIC_LOSS_EVENT {
 
+    uint64_t TimeNow; // microsecond
+
     uint64_t LargestPacketNumberLost;
 
     uint64_t LargestSentPacketNumber;
@@ -69,10 +87,17 @@ typedef struct QUIC_LOSS_EVENT {
 
 typedef struct QUIC_ECN_EVENT {
 
+    uint64_t TimeNow; // microsecond
+
     uint64_t LargestPacketNumberAcked;
 
     uint64_t LargestSentPacketNumber;
 
+    //
+    // Number of packets newly reported as CE marked by this ACK.
+    //
+    uint64_t NewCeCount;
+
 } QUIC_ECN_EVENT;
 
 typedef struct QUIC_CONGESTION_CONTROL {
@@ -82,6 +107,13 @@ typedef struct QUIC_CONGESTION_CONTROL {
     //
     const char* Name;
 
+    //
+    // TRUE for a scalable algorithm, which responds in proportion to the
+    // fraction of CE marked packets instead of treating CE like loss. Its
+    // packets are sent with ECT(1) to identify them as L4S traffic (RFC 9331).
+    //
+    BOOLEAN L4s;
+
     BOOLEAN (*QuicCongestionControlCanSend)(
         _In_ struct QUIC_CONGESTION_CONTROL* Cc
         );
@@ -161,6 +193,10 @@ typedef struct QUIC_CONGESTION_CONTROL {
     union {
         QUIC_CONGESTION_CONTROL_CUBIC Cubic;
         QUIC_CONGESTION_CONTROL_BBR Bbr;
+        QUIC_CONGESTION_CONTROL_BBR3 Bbr3;
+        QUIC_CONGESTION_CONTROL_PRAGUE Prague;
+        QUIC_CONGESTION_CONTROL_LEDBAT Ledbat;
+        QUIC_CONGESTION_CONTROL_APP App;
     };
 
 } QUIC_CONGESTION_CONTROL;
@@ -370,3 +406,7 @@ QuicCongestionControlSetAppLimited(
 {
     Cc->QuicCongestionControlSetAppLimited(Cc);
 }
+
+#if defined(__cplusplus)
+}
+#endif
@@ -57,6 +57,7 @@ _Success_(return == QUIC_STATUS_SUCCESS)
 QUIC_STATUS
 QuicConnAlloc(
     _In_ QUIC_REGISTRATION* Registration,
+    _In_ uint16_t PartitionIndex,
     _In_opt_ QUIC_WORKER* Worker,
     _In_opt_ const QUIC_RX_PACKET* Packet,
     _Outptr_ _At_(*NewConnection, __drv_allocatesMem(Mem))
@@ -67,13 +68,6 @@ QuicConnAlloc(
     *NewConnection = NULL;
     QUIC_STATUS Status;
 
-    //
-    // For client, the datapath partitioning info is not known yet, so just use
-    // the current processor for now. Once the connection receives a packet the
-    // partition can be updated accordingly.
-    //
-    const uint16_t PartitionIndex =
-        IsServer ? Packet->PartitionIndex : QuicLibraryGetCurrentPartition();
     const uint16_t PartitionId = QuicPartitionIdCreate(PartitionIndex);
     CXPLAT_DBG_ASSERT(PartitionIndex == QuicPartitionIdGetIndex(PartitionId));
 
@@ -151,9 +145,9 @@ QuicConnAlloc(
     Path->IsActive = TRUE;
     Connection->PathsCount = 1;
 
-    Connection->EarliestExpirationTime = UINT64_MAX;
     for (QUIC_CONN_TIMER_TYPE Type = 0; Type < QUIC_CONN_TIMER_COUNT; ++Type) {
-        Connection->ExpirationTimes[Type] = UINT64_MAX;
+        Connection->Timers[Type].ExpirationTime = UINT64_MAX;
+        Connection->Timers[Type].Index = (uint8_t)Type;
     }
 
     if (IsServer) {
@@ -1152,21 +1146,6 @@ QuicConnReplaceRetiredCids(
     return TRUE;
 }
 
-_IRQL_requires_max_(DISPATCH_LEVEL)
-uint64_t
-QuicGetEarliestExpirationTime(
-    _In_ const QUIC_CONNECTION* Connection
-    )
-{
-    uint64_t EarliestExpirationTime = Connection->ExpirationTimes[0];
-    for (QUIC_CONN_TIMER_TYPE Type = 1; Type < QUIC_CONN_TIMER_COUNT; ++Type) {
-        if (Connection->ExpirationTimes[Type] < EarliestExpirationTime) {
-            EarliestExpirationTime = Connection->ExpirationTimes[Type];
-        }
-    }
-    return EarliestExpirationTime;
-}
-
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicConnTimerSetEx(
@@ -1185,12 +1164,9 @@ QuicConnTimerSetEx(
         (uint8_t)Type,
         Delay);
 
-    Connection->ExpirationTimes[Type] = NewExpirationTime;
-    uint64_t NewEarliestExpirationTime  = QuicGetEarliestExpirationTime(Connection);
-    if (NewEarliestExpirationTime != Connection->EarliestExpirationTime) {
-        Connection->EarliestExpirationTime = NewEarliestExpirationTime;
-        QuicTimerWheelUpdateConnection(&Connection->Worker->TimerWheel, Connection);
-    }
+    Connection->Timers[Type].ExpirationTime = NewExpirationTime;
+    QuicTimerWheelUpdateConnectionTimer(
+        &Connection->Worker->TimerWheel, Connection, &Connection->Timers[Type]);
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -1200,33 +1176,16 @@ QuicConnTimerCancel(
     _In_ QUIC_CONN_TIMER_TYPE Type
     )
 {
-    CXPLAT_DBG_ASSERT(Connection->EarliestExpirationTime <= Connection->ExpirationTimes[Type]);
-
-    if (Connection->EarliestExpirationTime == UINT64_MAX) {
+    if (Connection->Timers[Type].ExpirationTime == UINT64_MAX) {
         //
-        // No timers are currently scheduled.
+        // The timer isn't currently scheduled.
         //
         return;
     }
 
-    if (Connection->ExpirationTimes[Type] == Connection->EarliestExpirationTime) {
-        //
-        // We might be canceling the earliest timer, so we need to find the new
-        // expiration time for this connection.
-        //
-        Connection->ExpirationTimes[Type] = UINT64_MAX;
-        uint64_t NewEarliestExpirationTime = QuicGetEarliestExpirationTime(Connection);
-
-        if (NewEarliestExpirationTime != Connection->EarliestExpirationTime) {
-            //
-            // We've either found a new earliest expiration time, or there will be no timers scheduled.
-            //
-            Connection->EarliestExpirationTime = NewEarliestExpirationTime;
-            QuicTimerWheelUpdateConnection(&Connection->Worker->TimerWheel, Connection);
-        }
-    } else {
-        Connection->ExpirationTimes[Type] = UINT64_MAX;
-    }
+    Connection->Timers[Type].ExpirationTime = UINT64_MAX;
+    QuicTimerWheelUpdateConnectionTimer(
+        &Connection->Worker->TimerWheel, Connection, &Connection->Timers[Type]);
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -1238,15 +1197,15 @@ QuicConnTimerExpired(
 {
     BOOLEAN FlushSendImmediate = FALSE;
 
-    Connection->EarliestExpirationTime = UINT64_MAX;
-
     //
-    // Queue up operations for all expired timers and update the earliest expiration time
-    // on the fly. Note that we must not call any functions that might update the timer wheel.
+    // Queue up operations for all expired timers. The timer wheel has already
+    // removed them, but left their expiration times set. Timers still in the
+    // timer wheel are handled the next time it's processed.
     //
     for (QUIC_CONN_TIMER_TYPE Type = 0; Type < QUIC_CONN_TIMER_COUNT; ++Type) {
-        if (Connection->ExpirationTimes[Type] <= TimeNow) {
-            Connection->ExpirationTimes[Type] = UINT64_MAX;
+        if (Connection->Timers[Type].Link.Flink == NULL &&
+            Connection->Timers[Type].ExpirationTime <= TimeNow) {
+            Connection->Timers[Type].ExpirationTime = UINT64_MAX;
             QuicTraceEvent(
                 ConnExpiredTimer,
                 "[conn][%p] %hhu expired",
@@ -1284,17 +1243,13 @@ QuicConnTimerExpired(
                         0);
                 }
             }
-        } else if (Connection->ExpirationTimes[Type] < Connection->EarliestExpirationTime) {
-            Connection->EarliestExpirationTime = Connection->ExpirationTimes[Type];
         }
     }
 
-    QuicTimerWheelUpdateConnection(&Connection->Worker->TimerWheel, Connection);
-
     if (FlushSendImmediate) {
         //
-        // We don't want to actually call the flush immediate above as it can
-        // cause a new timer to be inserted, messing up timer loop.
+        // Flush once, after handling all the expired timers, rather than for
+        // each of them.
         //
         (void)QuicSendFlush(&Connection->Send);
     }
@@ -1765,7 +1720,11 @@ QuicConnStart(
         return QUIC_STATUS_INVALID_STATE;
     }
 
-    CXPLAT_TEL_ASSERT(Path->Binding == NULL);
+    //
+    // The only binding a connection can have before it starts is the one the
+    // connection pool created for the local address it picked.
+    //
+    CXPLAT_TEL_ASSERT(Path->Binding == NULL || Connection->State.LocalAddressSet);
 
     if (!Connection->State.RemoteAddressSet) {
 
@@ -1828,28 +1787,31 @@ QuicConnStart(
         Connection,
         CASTED_CLOG_BYTEARRAY(sizeof(Path->Route.RemoteAddress), &Path->Route.RemoteAddress));
 
-    CXPLAT_UDP_CONFIG UdpConfig = {0};
-    UdpConfig.LocalAddress = Connection->State.LocalAddressSet ? &Path->Route.LocalAddress : NULL;
-    UdpConfig.RemoteAddress = &Path->Route.RemoteAddress;
-    UdpConfig.Flags = Connection->State.ShareBinding ? CXPLAT_SOCKET_FLAG_SHARE : 0;
-    UdpConfig.InterfaceIndex = Connection->State.LocalInterfaceSet ? (uint32_t)Path->Route.LocalAddress.Ipv6.sin6_scope_id : 0, // NOLINT(google-readability-casting)
-    UdpConfig.PartitionIndex = QuicPartitionIdGetIndex(Connection->PartitionID);
+    //
+    // Get the binding for the current local & remote addresses, unless the
+    // connection pool already created it (to pick the local port).
+    //
+    if (Path->Binding == NULL) {
+        CXPLAT_UDP_CONFIG UdpConfig = {0};
+        UdpConfig.LocalAddress = Connection->State.LocalAddressSet ? &Path->Route.LocalAddress : NULL;
+        UdpConfig.RemoteAddress = &Path->Route.RemoteAddress;
+        UdpConfig.Flags = Connection->State.ShareBinding ? CXPLAT_SOCKET_FLAG_SHARE : 0;
+        UdpConfig.InterfaceIndex = Connection->State.LocalInterfaceSet ? (uint32_t)Path->Route.LocalAddress.Ipv6.sin6_scope_id : 0, // NOLINT(google-readability-casting)
+        UdpConfig.PartitionIndex = QuicPartitionIdGetIndex(Connection->PartitionID);
 #ifdef QUIC_COMPARTMENT_ID
-    UdpConfig.CompartmentId = Configuration->CompartmentId;
+        UdpConfig.CompartmentId = Configuration->CompartmentId;
 #endif
 #ifdef QUIC_OWNING_PROCESS
-    UdpConfig.OwningProcess = Configuration->OwningProcess;
+        UdpConfig.OwningProcess = Configuration->OwningProcess;
 #endif
 
-    //
-    // Get the binding for the current local & remote addresses.
-    //
-    Status =
-        QuicLibraryGetBinding(
-            &UdpConfig,
-            &Path->Binding);
-    if (QUIC_FAILED(Status)) {
-        goto Exit;
+        Status =
+            QuicLibraryGetBinding(
+                &UdpConfig,
+                &Path->Binding);
+        if (QUIC_FAILED(Status)) {
+            goto Exit;
+        }
     }
 
     //
@@ -3151,7 +3113,8 @@ QuicConnQueueRecvPackets(
     _In_ QUIC_CONNECTION* Connection,
     _In_ QUIC_RX_PACKET* Packets,
     _In_ uint32_t PacketChainLength,
-    _In_ uint32_t PacketChainByteLength
+    _In_ uint32_t PacketChainByteLength,
+    _Inout_ QUIC_WORKER_QUEUE_BATCH* WorkerBatch
     )
 {
     QUIC_RX_PACKET** PacketsTail = (QUIC_RX_PACKET**)&Packets->Next;
@@ -3205,7 +3168,14 @@ QuicConnQueueRecvPackets(
         QUIC_OPERATION* ConnOper =
             QuicOperationAlloc(Connection->Worker, QUIC_OPER_TYPE_FLUSH_RECV);
         if (ConnOper != NULL) {
-            QuicConnQueueOper(Connection, ConnOper);
+            //
+            // Same as QuicConnQueueOper, except that queuing the connection on
+            // the worker is left to the caller, along with any others it
+            // delivers packets to.
+            //
+            if (QuicOperationEnqueue(&Connection->OperQ, ConnOper)) {
+                QuicWorkerQueueBatchAdd(WorkerBatch, Connection);
+            }
         } else {
             QuicTraceEvent(
                 AllocFailure,
@@ -5750,7 +5720,7 @@ QuicConnRecvDatagrams(
                         &RecvState);
                     BatchCount = 0;
                 }
-                CxPlatRecvDataReturn((CXPLAT_RECV_DATA*)ReleaseChain);
+                QuicPacketReleaseChain(ReleaseChain);
                 ReleaseChain = NULL;
                 ReleaseChainTail = &ReleaseChain;
                 ReleaseChainCount = 0;
@@ -5788,7 +5758,7 @@ QuicConnRecvDatagrams(
     }
 
     if (ReleaseChain != NULL) {
-        CxPlatRecvDataReturn((CXPLAT_RECV_DATA*)ReleaseChain);
+        QuicPacketReleaseChain(ReleaseChain);
     }
 
     if (QuicConnIsServer(Connection) &&
@@ -6414,6 +6384,8 @@ QuicConnParamSet(
 
         Connection->State.UseRoundRobinStreamScheduling =
             Scheme == QUIC_STREAM_SCHEDULING_SCHEME_ROUND_ROBIN;
+        Connection->State.UseExtensiblePriorityStreamScheduling =
+            Scheme == QUIC_STREAM_SCHEDULING_SCHEME_EXTENSIBLE_PRIORITY;
 
         QuicTraceLogConnInfo(
             UpdateStreamSchedulingScheme,
@@ -6821,6 +6793,19 @@ QuicConnGetV2Statistics(
     if (STATISTICS_HAS_FIELD(*StatsLength, SendEcnCongestionCount)) {
         Stats->SendEcnCongestionCount = Connection->Stats.Send.EcnCongestionCount;
     }
+    if (STATISTICS_HAS_FIELD(*StatsLength, SendMetadataBytesPerPacket)) {
+        Stats->SendMetadataBytesPerPacket =
+            QuicLossDetectionGetMetadataBytesPerPacket(&Connection->LossDetection);
+    }
+    if (STATISTICS_HAS_FIELD(*StatsLength, SendEcnCeRatio)) {
+        Stats->SendEcnCeRatio = Connection->Stats.Send.EcnCeRatio;
+    }
+    if (STATISTICS_HAS_FIELD(*StatsLength, SendEctPackets)) {
+        Stats->SendEctPackets = Connection->Send.NumPacketsSentWithEct;
+    }
+    if (STATISTICS_HAS_FIELD(*StatsLength, SendEcnCePackets)) {
+        Stats->SendEcnCePackets = Connection->Stats.Send.EcnCePackets;
+    }
 
     *StatsLength = CXPLAT_MIN(*StatsLength, sizeof(QUIC_STATISTICS_V2));
 
@@ -7117,6 +7102,8 @@ QuicConnParamGet(
 
         *BufferLength = sizeof(QUIC_STREAM_SCHEDULING_SCHEME);
         *(QUIC_STREAM_SCHEDULING_SCHEME*)Buffer =
+            Connection->State.UseExtensiblePriorityStreamScheduling ?
+                QUIC_STREAM_SCHEDULING_SCHEME_EXTENSIBLE_PRIORITY :
             Connection->State.UseRoundRobinStreamScheduling ?
                 QUIC_STREAM_SCHEDULING_SCHEME_ROUND_ROBIN : QUIC_STREAM_SCHEDULING_SCHEME_FIFO;
 
@@ -7270,7 +7257,15 @@ QuicConnApplyNewSettings(
         }
 
         QuicSendApplyNewSettings(&Connection->Send, &Connection->Settings);
-        QuicCongestionControlInitialize(&Connection->CongestionControl, &Connection->Settings);
+        if (Connection->Configuration != NULL &&
+            Connection->Configuration->CongestionControlSet) {
+            AppCongestionControlInitialize(
+                &Connection->CongestionControl,
+                &Connection->Settings,
+                &Connection->Configuration->CongestionControl);
+        } else {
+            QuicCongestionControlInitialize(&Connection->CongestionControl, &Connection->Settings);
+        }
 
         if (QuicConnIsClient(Connection) && Connection->Settings.IsSet.VersionSettings) {
             Connection->Stats.QuicVersion = Connection->Settings.VersionSettings->FullyDeployedVersions[0];
@@ -7494,6 +7489,13 @@ QuicConnProcessApiOperation(
                 ApiCtx->STRM_RECV_SET_ENABLED.IsEnabled);
         break;
 
+    case QUIC_API_TYPE_STRM_PROVIDE_RECV_BUFFERS:
+        Status =
+            QuicStreamProvideRecvBuffers(
+                ApiCtx->STRM_PROVIDE_RECV_BUFFERS.Stream,
+                &ApiCtx->STRM_PROVIDE_RECV_BUFFERS.Chunks);
+        break;
+
     case QUIC_API_TYPE_SET_PARAM:
         Status =
             QuicLibrarySetParam(
@@ -7516,6 +7518,15 @@ QuicConnProcessApiOperation(
         QuicDatagramSendFlush(&Connection->Datagram);
         break;
 
+    case QUIC_API_TYPE_CONN_SEND_BATCH:
+        for (uint32_t i = 0; i < ApiCtx->CONN_SEND_BATCH.StreamCount; ++i) {
+            QuicStreamSendFlush(ApiCtx->CONN_SEND_BATCH.Streams[i]);
+        }
+        if (ApiCtx->CONN_SEND_BATCH.FlushDatagrams) {
+            QuicDatagramSendFlush(&Connection->Datagram);
+        }
+        break;
+
     default:
         CXPLAT_TEL_ASSERT(FALSE);
         Status = QUIC_STATUS_INVALID_PARAMETER;
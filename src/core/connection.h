@@ -8,6 +8,10 @@
 #include "connection.h.clog.h"
 #endif
 
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
 typedef struct QUIC_LISTENER QUIC_LISTENER;
 
 //
@@ -139,6 +143,12 @@ typedef union QUIC_CONNECTION_STATE {
         //
         BOOLEAN UseRoundRobinStreamScheduling : 1;
 
+        //
+        // Indicates the connection is using the extensible priority (urgency
+        // and incremental) stream scheduling scheme.
+        //
+        BOOLEAN UseExtensiblePriorityStreamScheduling : 1;
+
         //
         // Indicates that this connection has resumption enabled and needs to
         // keep the TLS state and transport parameters until it is done sending
@@ -285,10 +295,12 @@ typedef struct QUIC_CONN_STATS {
 
         uint64_t TotalBytes;            // Sum of UDP payloads
         uint64_t TotalStreamBytes;      // Sum of stream payloads
+        uint64_t EcnCePackets;          // Sent packets the peer reported as CE marked
 
         uint32_t CongestionCount;
         uint32_t EcnCongestionCount;
         uint32_t PersistentCongestionCount;
+        uint32_t EcnCeRatio;            // Parts per million, maintained by PRAGUE
     } Send;
 
     struct {
@@ -336,7 +348,7 @@ typedef struct QUIC_CONNECTION {
     CXPLAT_LIST_ENTRY WorkerLink;
 
     //
-    // Link in the timer wheel's list.
+    // Link in the worker's list of connections with expired timers.
     //
     CXPLAT_LIST_ENTRY TimerLink;
 
@@ -503,15 +515,16 @@ typedef struct QUIC_CONNECTION {
     uint8_t CibirId[2 + QUIC_MAX_CIBIR_LENGTH];
 
     //
-    // Expiration time (absolute time in us) for each timer type. We use UINT64_MAX as a sentinel
-    // to indicate that the timer is not set.
+    // The timer wheel entry for each timer type. Each entry holds the timer's
+    // expiration time (absolute time in us), with UINT64_MAX as a sentinel to
+    // indicate that the timer is not set.
     //
-    uint64_t ExpirationTimes[QUIC_CONN_TIMER_COUNT];
+    QUIC_TIMER_WHEEL_ENTRY Timers[QUIC_CONN_TIMER_COUNT];
 
     //
-    // Earliest expiration time of all timers types.
+    // The number of this connection's timers currently in the timer wheel.
     //
-    uint64_t EarliestExpirationTime;
+    uint8_t ActiveTimerCount;
 
     //
     // Receive packet queue.
@@ -975,9 +988,10 @@ QuicConnRemoveOutFlowBlockedReason(
 }
 
 //
-// Allocates and initializes a connection object. In the client scenario no
-// initial datagram exists already, so Datagram is NULL. In the server scenario
-// a datagram is the cause of the creation, and is passed in.
+// Allocates and initializes a connection object on the given partition. In the
+// client scenario no initial datagram exists already, so Datagram is NULL. In
+// the server scenario a datagram is the cause of the creation, and is passed
+// in.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
 _Must_inspect_result_
@@ -985,6 +999,7 @@ _Success_(return == QUIC_STATUS_SUCCESS)
 QUIC_STATUS
 QuicConnAlloc(
     _In_ QUIC_REGISTRATION* Registration,
+    _In_ uint16_t PartitionIndex,
     _In_opt_ QUIC_WORKER* Worker,
     _In_opt_ const QUIC_RX_PACKET* Packet,
     _Outptr_ _At_(*NewConnection, __drv_allocatesMem(Mem))
@@ -1542,7 +1557,9 @@ QuicConnResetIdleTimeout(
     );
 
 //
-// Queues a received packet chain to a connection for processing.
+// Queues a received packet chain to a connection for processing. If the
+// connection then needs to be queued on its worker, it's added to WorkerBatch
+// instead, for the caller to flush once it has queued all its packets.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
@@ -1550,7 +1567,8 @@ QuicConnQueueRecvPackets(
     _In_ QUIC_CONNECTION* Connection,
     _In_ QUIC_RX_PACKET* Packets,
     _In_ uint32_t PacketChainLength,
-    _In_ uint32_t PacketChainByteLength
+    _In_ uint32_t PacketChainByteLength,
+    _Inout_ QUIC_WORKER_QUEUE_BATCH* WorkerBatch
     );
 
 //
@@ -1675,3 +1693,7 @@ QuicMtuDiscoveryCheckSearchCompleteTimeout(
         }
     }
 }
+
+#if defined(__cplusplus)
+}
+#endif
@@ -0,0 +1,441 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    The connection pool creates a batch of client connections to a single
+    server with one call.
+
+    Each connection's local port is picked so that the RSS (Toeplitz) hash of
+    its 4-tuple, as computed by the local NIC on received packets, selects a
+    different receive queue of the interface. The connection is then placed on
+    the partition (and worker) that goes with that receive queue. The local
+    port is reserved by creating the connection's binding up front, so ports
+    already in use are simply skipped.
+
+    When the interface's RSS configuration isn't available (or UDP ports
+    aren't part of its hash input), the connections are spread round robin
+    over the partitions instead, with ephemeral local ports.
+
+--*/
+
+#include "precomp.h"
+#ifdef QUIC_CLOG
+#include "connection_pool.c.clog.h"
+#endif
+
+//
+// The range of local ports searched for a port with the right RSS hash. This
+// is the IANA dynamic port range.
+//
+#define QUIC_CONN_POOL_MIN_PORT     49152
+#define QUIC_CONN_POOL_PORT_COUNT   16384
+
+typedef struct QUIC_CONN_POOL_RSS {
+
+    CXPLAT_TOEPLITZ_HASH Toeplitz;
+
+    //
+    // Hash of the (receive direction) 4-tuple with a zero local port. Since
+    // the Toeplitz hash is linear, the full hash is this XOR the hash of just
+    // the local port.
+    //
+    uint32_t BaseHash;
+
+    //
+    // The offset of the local (destination) port in the hash input.
+    //
+    uint32_t LocalPortOffset;
+
+    //
+    // The number of receive queues referenced by the indirection table.
+    //
+    uint32_t QueueCount;
+
+    CXPLAT_RSS_CONFIG* Config;
+
+} QUIC_CONN_POOL_RSS;
+
+//
+// Gets the local address the networking stack picks for connecting to the
+// server, by creating (and immediately releasing) a binding for it.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicConnPoolGetLocalAddress(
+    _In_ const QUIC_ADDR* ServerAddress,
+    _Out_ QUIC_ADDR* LocalAddress
+    )
+{
+    QUIC_BINDING* Binding;
+    CXPLAT_UDP_CONFIG UdpConfig = {0};
+    UdpConfig.RemoteAddress = ServerAddress;
+    UdpConfig.PartitionIndex = QuicLibraryGetCurrentPartition();
+
+    QUIC_STATUS Status = QuicLibraryGetBinding(&UdpConfig, &Binding);
+    if (QUIC_SUCCEEDED(Status)) {
+        QuicBindingGetLocalAddress(Binding, LocalAddress);
+        QuicLibraryReleaseBinding(Binding);
+    }
+    return Status;
+}
+
+//
+// Sets up the hashing state for spreading the connections over the receive
+// queues of the local interface. Fails if that isn't possible.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicConnPoolRssInitialize(
+    _In_ const QUIC_ADDR* ServerAddress,
+    _In_ const QUIC_ADDR* LocalAddress,
+    _Outptr_ QUIC_CONN_POOL_RSS** NewRss
+    )
+{
+    const BOOLEAN IsIpv4 = QuicAddrGetFamily(LocalAddress) == QUIC_ADDRESS_FAMILY_INET;
+    const uint32_t IpLength = IsIpv4 ? 4 : 16;
+    const uint8_t* ServerIp =
+        IsIpv4 ?
+            (const uint8_t*)ServerAddress + QUIC_ADDR_V4_IP_OFFSET :
+            (const uint8_t*)ServerAddress + QUIC_ADDR_V6_IP_OFFSET;
+    const uint8_t* LocalIp =
+        IsIpv4 ?
+            (const uint8_t*)LocalAddress + QUIC_ADDR_V4_IP_OFFSET :
+            (const uint8_t*)LocalAddress + QUIC_ADDR_V6_IP_OFFSET;
+    const uint8_t* ServerPort =
+        IsIpv4 ?
+            (const uint8_t*)ServerAddress + QUIC_ADDR_V4_PORT_OFFSET :
+            (const uint8_t*)ServerAddress + QUIC_ADDR_V6_PORT_OFFSET;
+    CXPLAT_RSS_CONFIG* Config = NULL;
+    QUIC_CONN_POOL_RSS* Rss = NULL;
+    QUIC_STATUS Status;
+
+    *NewRss = NULL;
+
+    if (QuicAddrGetFamily(ServerAddress) != QuicAddrGetFamily(LocalAddress)) {
+        Status = QUIC_STATUS_NOT_SUPPORTED;
+        goto Exit;
+    }
+
+    Status = CxPlatDataPathRssConfigGet(MsQuicLib.Datapath, LocalAddress, &Config);
+    if (QUIC_FAILED(Status)) {
+        goto Exit;
+    }
+
+    //
+    // The hash input is the source IP, destination IP, source port and
+    // destination port, so the key must cover all of that plus the 4 byte
+    // output.
+    //
+    if (!(Config->HashTypes &
+            (IsIpv4 ? CXPLAT_RSS_HASH_TYPE_UDP_IPV4 : CXPLAT_RSS_HASH_TYPE_UDP_IPV6)) ||
+        Config->RssSecretKeyLength < 2 * IpLength + 2 * sizeof(uint16_t) + CXPLAT_TOEPLITZ_OUPUT_SIZE ||
+        Config->RssIndirectionTableCount == 0) {
+        Status = QUIC_STATUS_NOT_SUPPORTED;
+        goto Exit;
+    }
+
+    Rss = CXPLAT_ALLOC_PAGED(sizeof(QUIC_CONN_POOL_RSS), QUIC_POOL_CONN_POOL_API);
+    if (Rss == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "connection pool RSS state",
+            sizeof(QUIC_CONN_POOL_RSS));
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        goto Exit;
+    }
+
+    CxPlatZeroMemory(Rss->Toeplitz.HashKey, sizeof(Rss->Toeplitz.HashKey));
+    CxPlatCopyMemory(
+        Rss->Toeplitz.HashKey,
+        Config->RssSecretKey,
+        CXPLAT_MIN(Config->RssSecretKeyLength, sizeof(Rss->Toeplitz.HashKey)));
+    CxPlatToeplitzHashInitialize(&Rss->Toeplitz);
+
+    //
+    // Received packets come from the server, so the server is the source.
+    //
+    Rss->BaseHash =
+        CxPlatToeplitzHashCompute(&Rss->Toeplitz, ServerIp, IpLength, 0) ^
+        CxPlatToeplitzHashCompute(&Rss->Toeplitz, LocalIp, IpLength, IpLength) ^
+        CxPlatToeplitzHashCompute(&Rss->Toeplitz, ServerPort, sizeof(uint16_t), 2 * IpLength);
+    Rss->LocalPortOffset = 2 * IpLength + sizeof(uint16_t);
+
+    Rss->QueueCount = 0;
+    for (uint32_t i = 0; i < Config->RssIndirectionTableCount; ++i) {
+        if (Config->RssIndirectionTable[i] >= Rss->QueueCount) {
+            Rss->QueueCount = Config->RssIndirectionTable[i] + 1;
+        }
+    }
+
+    Rss->Config = Config;
+    Config = NULL;
+    *NewRss = Rss;
+
+Exit:
+
+    if (Config != NULL) {
+        CxPlatDataPathRssConfigFree(Config);
+    }
+
+    return Status;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnPoolRssUninitialize(
+    _In_ QUIC_CONN_POOL_RSS* Rss
+    )
+{
+    CxPlatDataPathRssConfigFree(Rss->Config);
+    CXPLAT_FREE(Rss, QUIC_POOL_CONN_POOL_API);
+}
+
+//
+// Returns the receive queue the NIC picks for packets sent to the local port.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+uint32_t
+QuicConnPoolRssGetQueue(
+    _In_ const QUIC_CONN_POOL_RSS* Rss,
+    _In_ uint16_t LocalPort // Host byte order
+    )
+{
+    const uint8_t Port[2] = { (uint8_t)(LocalPort >> 8), (uint8_t)LocalPort };
+    const uint32_t Hash =
+        Rss->BaseHash ^
+        CxPlatToeplitzHashCompute(
+            &Rss->Toeplitz, Port, sizeof(Port), Rss->LocalPortOffset);
+    return
+        Rss->Config->RssIndirectionTable[
+            Hash % Rss->Config->RssIndirectionTableCount];
+}
+
+//
+// Creates a binding on a local port for which the NIC picks the target receive
+// queue. On success, the next port to try is updated for the next connection.
+// Fails with QUIC_STATUS_NOT_FOUND if no such port is available.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicConnPoolBindToQueue(
+    _In_ const QUIC_CONN_POOL_RSS* Rss,
+    _In_ uint32_t TargetQueue,
+    _In_ uint16_t PartitionIndex,
+    _In_ const QUIC_ADDR* ServerAddress,
+    _In_ const QUIC_ADDR* LocalAddress,
+    _Inout_ uint16_t* NextPortIndex,
+    _Out_ QUIC_BINDING** Binding
+    )
+{
+    QUIC_ADDR BindAddress = *LocalAddress;
+    CXPLAT_UDP_CONFIG UdpConfig = {0};
+    UdpConfig.LocalAddress = &BindAddress;
+    UdpConfig.RemoteAddress = ServerAddress;
+    UdpConfig.PartitionIndex = PartitionIndex;
+
+    for (uint32_t i = 0; i < QUIC_CONN_POOL_PORT_COUNT; ++i) {
+        const uint16_t Port =
+            (uint16_t)(QUIC_CONN_POOL_MIN_PORT +
+                (*NextPortIndex + i) % QUIC_CONN_POOL_PORT_COUNT);
+        if (QuicConnPoolRssGetQueue(Rss, Port) != TargetQueue) {
+            continue;
+        }
+
+        QuicAddrSetPort(&BindAddress, Port);
+        QUIC_STATUS Status = QuicLibraryGetBinding(&UdpConfig, Binding);
+        if (Status == QUIC_STATUS_ADDRESS_IN_USE) {
+            continue;
+        }
+        if (QUIC_SUCCEEDED(Status)) {
+            *NextPortIndex = (uint16_t)((*NextPortIndex + i + 1) % QUIC_CONN_POOL_PORT_COUNT);
+        }
+        return Status;
+    }
+
+    return QUIC_STATUS_NOT_FOUND;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QUIC_API
+MsQuicConnectionPoolCreate(
+    _In_ _Pre_defensive_ const QUIC_CONNECTION_POOL_CONFIG* Config,
+    _Out_writes_(Config->NumberOfConnections) _Pre_defensive_
+        HQUIC* ConnectionPool
+    )
+{
+    QUIC_STATUS Status;
+    QUIC_REGISTRATION* Registration;
+    QUIC_ADDR ServerAddress;
+    QUIC_ADDR LocalAddress;
+    QUIC_CONN_POOL_RSS* Rss = NULL;
+    uint16_t CreatedCount = 0;
+    uint16_t StartIndex;
+    uint16_t NextPortIndex;
+
+    QuicTraceEvent(
+        ApiEnter,
+        "[ api] Enter %u (%p).",
+        QUIC_TRACE_API_CONNECTION_POOL_CREATE,
+        Config == NULL ? NULL : Config->Registration);
+
+    if (Config == NULL ||
+        ConnectionPool == NULL ||
+        Config->Registration == NULL ||
+        Config->Registration->Type != QUIC_HANDLE_TYPE_REGISTRATION ||
+        Config->Configuration == NULL ||
+        Config->Configuration->Type != QUIC_HANDLE_TYPE_CONFIGURATION ||
+        Config->Handler == NULL ||
+        Config->ServerName == NULL ||
+        Config->ServerPort == 0 ||
+        Config->NumberOfConnections == 0 ||
+        (Config->Family != QUIC_ADDRESS_FAMILY_UNSPEC &&
+         Config->Family != QUIC_ADDRESS_FAMILY_INET &&
+         Config->Family != QUIC_ADDRESS_FAMILY_INET6)) {
+        Status = QUIC_STATUS_INVALID_PARAMETER;
+        goto Error;
+    }
+
+#pragma prefast(suppress: __WARNING_25024, "Pointer cast already validated.")
+    Registration = (QUIC_REGISTRATION*)Config->Registration;
+
+    CxPlatZeroMemory(ConnectionPool, sizeof(HQUIC) * Config->NumberOfConnections);
+
+    if (Config->ServerAddress != NULL) {
+        ServerAddress = *Config->ServerAddress;
+    } else {
+        CxPlatZeroMemory(&ServerAddress, sizeof(ServerAddress));
+        QuicAddrSetFamily(&ServerAddress, Config->Family);
+        Status =
+            CxPlatDataPathResolveAddress(
+                MsQuicLib.Datapath,
+                Config->ServerName,
+                &ServerAddress);
+        if (QUIC_FAILED(Status)) {
+            goto Error;
+        }
+    }
+
+    if (QuicAddrIsWildCard(&ServerAddress)) {
+        Status = QUIC_STATUS_INVALID_PARAMETER;
+        goto Error;
+    }
+    QuicAddrSetPort(&ServerAddress, Config->ServerPort);
+
+    Status = QuicConnPoolGetLocalAddress(&ServerAddress, &LocalAddress);
+    if (QUIC_FAILED(Status)) {
+        goto Error;
+    }
+
+    Status = QuicConnPoolRssInitialize(&ServerAddress, &LocalAddress, &Rss);
+    if (QUIC_FAILED(Status)) {
+        QuicTraceLogWarning(
+            ConnPoolRssUnavailable,
+            "[ lib] Connection pool can't use RSS, 0x%x",
+            Status);
+    }
+
+    //
+    // Start at a random queue (or partition) and port, so that pools created
+    // one after another don't all pile up on the same ones.
+    //
+    CxPlatRandom(sizeof(StartIndex), &StartIndex);
+    NextPortIndex = StartIndex % QUIC_CONN_POOL_PORT_COUNT;
+
+    for (; CreatedCount < Config->NumberOfConnections; ++CreatedCount) {
+        QUIC_CONNECTION* Connection = NULL;
+        uint32_t TargetQueue = 0;
+        uint16_t PartitionIndex;
+        if (Rss != NULL) {
+            TargetQueue = (StartIndex + CreatedCount) % Rss->QueueCount;
+            PartitionIndex = (uint16_t)(TargetQueue % MsQuicLib.PartitionCount);
+        } else {
+            PartitionIndex = (uint16_t)((StartIndex + CreatedCount) % MsQuicLib.PartitionCount);
+        }
+
+        QUIC_WORKER* Worker =
+            &Registration->WorkerPool->Workers[
+                Registration->NoPartitioning ?
+                    0 : PartitionIndex % Registration->WorkerPool->WorkerCount];
+        Status = QuicConnAlloc(Registration, PartitionIndex, Worker, NULL, &Connection);
+        if (QUIC_FAILED(Status)) {
+            goto Error;
+        }
+
+        //
+        // N.B. The connection isn't known to anyone else yet, so its state can
+        // be updated directly until it is started.
+        //
+        Connection->ClientCallbackHandler = Config->Handler;
+        Connection->ClientContext =
+            Config->Context != NULL ? Config->Context[CreatedCount] : NULL;
+        ConnectionPool[CreatedCount] = (HQUIC)Connection;
+
+        QUIC_PATH* Path = &Connection->Paths[0];
+        Path->Route.RemoteAddress = ServerAddress;
+        Connection->State.RemoteAddressSet = TRUE;
+
+        if (Rss != NULL) {
+            Status =
+                QuicConnPoolBindToQueue(
+                    Rss,
+                    TargetQueue,
+                    PartitionIndex,
+                    &ServerAddress,
+                    &LocalAddress,
+                    &NextPortIndex,
+                    &Path->Binding);
+            if (QUIC_FAILED(Status) && Status != QUIC_STATUS_NOT_FOUND) {
+                ++CreatedCount;
+                goto Error;
+            }
+            if (Path->Binding != NULL) {
+                QuicBindingGetLocalAddress(Path->Binding, &Path->Route.LocalAddress);
+                Connection->State.LocalAddressSet = TRUE;
+                QuicTraceLogConnInfo(
+                    ConnPoolRssQueue,
+                    Connection,
+                    "Connection pool picked local port %hu for RSS queue %u",
+                    QuicAddrGetPort(&Path->Route.LocalAddress),
+                    TargetQueue);
+            }
+        }
+
+        Status =
+            MsQuicConnectionStart(
+                (HQUIC)Connection,
+                Config->Configuration,
+                Config->Family,
+                Config->ServerName,
+                Config->ServerPort);
+        if (QUIC_FAILED(Status)) {
+            ++CreatedCount;
+            goto Error;
+        }
+    }
+
+Error:
+
+    if (QUIC_FAILED(Status) && CreatedCount != 0 &&
+        (Config->Flags & QUIC_CONNECTION_POOL_FLAG_CLOSE_ON_FAILURE)) {
+        for (uint16_t i = 0; i < CreatedCount; ++i) {
+            MsQuicConnectionClose(ConnectionPool[i]);
+            ConnectionPool[i] = NULL;
+        }
+    }
+
+    if (Rss != NULL) {
+        QuicConnPoolRssUninitialize(Rss);
+    }
+
+    QuicTraceEvent(
+        ApiExitStatus,
+        "[ api] Exit %u",
+        Status);
+
+    return Status;
+}
@@ -1273,6 +1273,7 @@ QuicCryptoProcessDataFrame(
                 Crypto->RecvEncryptLevelStartOffset + Frame->Offset,
                 (uint16_t)Frame->Length,
                 Frame->Data,
+                NULL,
                 &FlowControlLimit,
                 DataReady);
         if (QUIC_FAILED(Status)) {
@@ -633,8 +633,8 @@ CubicCongestionControlOnDataAcknowledged(
             Cubic->AimdAccumulator += BytesAcked;
         }
         if (Cubic->AimdAccumulator > Cubic->AimdWindow) {
-            Cubic->AimdWindow += DatagramPayloadLength;
             Cubic->AimdAccumulator -= Cubic->AimdWindow;
+            Cubic->AimdWindow += DatagramPayloadLength;
         }
 
         if (Cubic->AimdWindow > CubicWindow) {
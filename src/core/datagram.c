@@ -320,16 +320,17 @@ QuicDatagramOnSendStateChanged(
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
-QuicDatagramQueueSend(
+QuicDatagramEnqueueSend(
     _In_ QUIC_DATAGRAM* Datagram,
-    _In_ QUIC_SEND_REQUEST* SendRequest
+    _In_ QUIC_SEND_REQUEST* SendRequest,
+    _Out_ BOOLEAN* QueueOper
     )
 {
     QUIC_STATUS Status;
-    BOOLEAN QueueOper = TRUE;
-    const BOOLEAN IsPriority = !!(SendRequest->Flags & QUIC_SEND_FLAG_PRIORITY_WORK);
     QUIC_CONNECTION* Connection = QuicDatagramGetConnection(Datagram);
 
+    *QueueOper = TRUE;
+
     CxPlatDispatchLockAcquire(&Datagram->ApiQueueLock);
     if (!Datagram->SendEnabled) {
         QuicTraceEvent(
@@ -350,7 +351,7 @@ QuicDatagramQueueSend(
             QUIC_SEND_REQUEST** ApiQueueTail = &Datagram->ApiQueue;
             while (*ApiQueueTail != NULL) {
                 ApiQueueTail = &((*ApiQueueTail)->Next);
-                QueueOper = FALSE; // Not necessary if the previous send hasn't been flushed yet.
+                *QueueOper = FALSE; // Not necessary if the previous send hasn't been flushed yet.
             }
             *ApiQueueTail = SendRequest;
             Status = QUIC_STATUS_SUCCESS;
@@ -360,6 +361,25 @@ QuicDatagramQueueSend(
 
     if (QUIC_FAILED(Status)) {
         CxPlatPoolFree(&Connection->Worker->SendRequestPool, SendRequest);
+    }
+
+    return Status;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicDatagramQueueSend(
+    _In_ QUIC_DATAGRAM* Datagram,
+    _In_ QUIC_SEND_REQUEST* SendRequest
+    )
+{
+    QUIC_STATUS Status;
+    BOOLEAN QueueOper;
+    const BOOLEAN IsPriority = !!(SendRequest->Flags & QUIC_SEND_FLAG_PRIORITY_WORK);
+    QUIC_CONNECTION* Connection = QuicDatagramGetConnection(Datagram);
+
+    Status = QuicDatagramEnqueueSend(Datagram, SendRequest, &QueueOper);
+    if (QUIC_FAILED(Status)) {
         goto Exit;
     }
 
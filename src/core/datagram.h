@@ -64,6 +64,19 @@ QuicDatagramOnSendStateChanged(
     _In_ QUIC_DATAGRAM* Datagram
     );
 
+//
+// Appends the send request to the API queue, without queuing the operation to
+// flush it. QueueOper is set if the caller is responsible for making sure the
+// queue gets flushed. The send request is freed on failure.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicDatagramEnqueueSend(
+    _In_ QUIC_DATAGRAM* Datagram,
+    _In_ QUIC_SEND_REQUEST* SendRequest,
+    _Out_ BOOLEAN* QueueOper
+    );
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 QuicDatagramQueueSend(
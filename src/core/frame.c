@@ -88,14 +88,15 @@ QuicAckHeaderDecode(
     _Out_ QUIC_ACK_EX* Frame
     )
 {
-    if (!QuicVarIntDecode(BufferLength, Buffer, Offset, &Frame->LargestAcknowledged) ||
-        !QuicVarIntDecode(BufferLength, Buffer, Offset, &Frame->AckDelay) ||
-        !QuicVarIntDecode(BufferLength, Buffer, Offset, &Frame->AdditionalAckBlockCount) ||
-        !QuicVarIntDecode(BufferLength, Buffer, Offset, &Frame->FirstAckBlock) ||
-        Frame->FirstAckBlock > Frame->LargestAcknowledged) {
+    QUIC_VAR_INT Values[4];
+    if (!QuicVarIntDecodeMany(BufferLength, Buffer, Offset, ARRAYSIZE(Values), Values)) {
         return FALSE;
     }
-    return TRUE;
+    Frame->LargestAcknowledged = Values[0];
+    Frame->AckDelay = Values[1];
+    Frame->AdditionalAckBlockCount = Values[2];
+    Frame->FirstAckBlock = Values[3];
+    return Frame->FirstAckBlock <= Frame->LargestAcknowledged;
 }
 
 _Success_(return != FALSE)
@@ -133,10 +134,12 @@ QuicAckBlockDecode(
     _Out_ QUIC_ACK_BLOCK_EX* Block
     )
 {
-    if (!QuicVarIntDecode(BufferLength, Buffer, Offset, &Block->Gap) ||
-        !QuicVarIntDecode(BufferLength, Buffer, Offset, &Block->AckBlock)) {
+    QUIC_VAR_INT Values[2];
+    if (!QuicVarIntDecodeMany(BufferLength, Buffer, Offset, ARRAYSIZE(Values), Values)) {
         return FALSE;
     }
+    Block->Gap = Values[0];
+    Block->AckBlock = Values[1];
     return TRUE;
 }
 
@@ -177,11 +180,13 @@ QuicAckEcnDecode(
     _Out_ QUIC_ACK_ECN_EX* Ecn
     )
 {
-    if (!QuicVarIntDecode(BufferLength, Buffer, Offset, &Ecn->ECT_0_Count) ||
-        !QuicVarIntDecode(BufferLength, Buffer, Offset, &Ecn->ECT_1_Count) ||
-        !QuicVarIntDecode(BufferLength, Buffer, Offset, &Ecn->CE_Count)) {
+    QUIC_VAR_INT Values[3];
+    if (!QuicVarIntDecodeMany(BufferLength, Buffer, Offset, ARRAYSIZE(Values), Values)) {
         return FALSE;
     }
+    Ecn->ECT_0_Count = Values[0];
+    Ecn->ECT_1_Count = Values[1];
+    Ecn->CE_Count = Values[2];
     return TRUE;
 }
 
@@ -236,7 +241,20 @@ QuicAckFrameEncode(
             Count - 1                       // AckBlock
         };
 
-        if (!QuicAckBlockEncode(&Block, Offset, BufferLength, Buffer)) {
+        if ((Block.Gap | Block.AckBlock) < 0x40) {
+            //
+            // Most blocks, with lots of small gaps from loss or reordering,
+            // encode both values in a single byte each. Write those directly.
+            //
+            if (BufferLength < *Offset + 2 * sizeof(uint8_t)) {
+                CXPLAT_TEL_ASSERT(FALSE); // TODO - Support partial ACK array encoding by updating the 'AdditionalAckBlockCount' field.
+                return FALSE;
+            }
+            Buffer[*Offset] = (uint8_t)Block.Gap;
+            Buffer[*Offset + 1] = (uint8_t)Block.AckBlock;
+            *Offset += 2 * sizeof(uint8_t);
+
+        } else if (!QuicAckBlockEncode(&Block, Offset, BufferLength, Buffer)) {
             CXPLAT_TEL_ASSERT(FALSE); // TODO - Support partial ACK array encoding by updating the 'AdditionalAckBlockCount' field.
             return FALSE;
         }
@@ -291,20 +309,33 @@ QuicAckFrameDecode(
         return FALSE;
     }
 
-    //
-    // Insert the largest/first block into the range.
-    //
+    if (Frame.AdditionalAckBlockCount >= QUIC_MAX_NUMBER_ACK_BLOCKS) {
+        *InvalidFrame = TRUE;
+        return FALSE;
+    }
 
     uint64_t Largest = Frame.LargestAcknowledged;
     uint64_t Count = Frame.FirstAckBlock + 1;
+    const uint32_t BlockCount = (uint32_t)Frame.AdditionalAckBlockCount + 1;
 
+    //
+    // Every additional block is below the previous one, with at least one
+    // packet number missing in between, so each block is a separate subrange.
+    // If the range starts out empty, and can hold all the blocks the frame
+    // could possibly contain (each needs at least two bytes), the blocks are
+    // written directly into the subrange array, back to front. Otherwise, each
+    // one is inserted into the range, which memmoves all the subranges already
+    // there for every block.
+    //
     BOOLEAN DontCare;
-    if (!QuicRangeAddRange(AckRanges, Largest + 1 - Count, Count, &DontCare)) {
-        return FALSE;
-    }
-
-    if (Frame.AdditionalAckBlockCount >= QUIC_MAX_NUMBER_ACK_BLOCKS) {
-        *InvalidFrame = TRUE;
+    QUIC_SUBRANGE* Sub = NULL;
+    if (QuicRangeSize(AckRanges) == 0 &&
+        Frame.AdditionalAckBlockCount * 2 <= (uint64_t)(BufferLength - *Offset) &&
+        QuicRangeReserve(AckRanges, BlockCount)) {
+        Sub = AckRanges->SubRanges + BlockCount - 1;
+        Sub->Low = Largest + 1 - Count;
+        Sub->Count = Count;
+    } else if (!QuicRangeAddRange(AckRanges, Largest + 1 - Count, Count, &DontCare)) {
         return FALSE;
     }
 
@@ -322,7 +353,16 @@ QuicAckFrameDecode(
         Largest -= Count;
 
         QUIC_ACK_BLOCK_EX Block;
-        if (!QuicAckBlockDecode(BufferLength, Buffer, Offset, &Block)) {
+        if (BufferLength >= *Offset + 2 * sizeof(uint8_t) &&
+            (Buffer[*Offset] | Buffer[*Offset + 1]) < 0x40) {
+            //
+            // Both values are single byte encoded; the common case.
+            //
+            Block.Gap = Buffer[*Offset];
+            Block.AckBlock = Buffer[*Offset + 1];
+            *Offset += 2 * sizeof(uint8_t);
+
+        } else if (!QuicAckBlockDecode(BufferLength, Buffer, Offset, &Block)) {
             *InvalidFrame = TRUE;
             return FALSE;
         }
@@ -335,18 +375,28 @@ QuicAckFrameDecode(
         Largest -= (Block.Gap + 1);
         Count = Block.AckBlock + 1;
 
-        //
-        // N.B. The efficiency here isn't great because we are always inserting
-        // values less than the current minimum, which requires a complete
-        // memmove of the current array. A circular buffer that allows both
-        // forward and backward growth would fix this.
-        //
+        if (Count > Largest + 1) {
+            //
+            // The block would go below packet number zero.
+            //
+            *InvalidFrame = TRUE;
+            return FALSE;
+        }
 
-        if (!QuicRangeAddRange(AckRanges, Largest - Count + 1, Count, &DontCare)) {
+        if (Sub != NULL) {
+            Sub--;
+            Sub->Low = Largest - Count + 1;
+            Sub->Count = Count;
+        } else if (!QuicRangeAddRange(AckRanges, Largest - Count + 1, Count, &DontCare)) {
             return FALSE;
         }
     }
 
+    if (Sub != NULL) {
+        CXPLAT_DBG_ASSERT(Sub == AckRanges->SubRanges);
+        AckRanges->UsedLength = BlockCount;
+    }
+
     *AckDelay = Frame.AckDelay;
 
     if (FrameType == QUIC_FRAME_ACK_1) {
@@ -658,19 +708,19 @@ QuicStreamFrameDecode(
     )
 {
     QUIC_STREAM_FRAME_TYPE Type = { .Type = FrameType };
-    if (!QuicVarIntDecode(BufferLength, Buffer, Offset, &Frame->StreamID)) {
+
+    //
+    // The stream ID, then the offset and length fields, if present.
+    //
+    QUIC_VAR_INT Values[3];
+    if (!QuicVarIntDecodeMany(BufferLength, Buffer, Offset, 1 + Type.OFF + Type.LEN, Values)) {
         return FALSE;
     }
-    if (Type.OFF) {
-        if (!QuicVarIntDecode(BufferLength, Buffer, Offset, &Frame->Offset)) {
-            return FALSE;
-        }
-    } else {
-        Frame->Offset = 0;
-    }
+    Frame->StreamID = Values[0];
+    Frame->Offset = Type.OFF ? Values[1] : 0;
     if (Type.LEN) {
-        if (!QuicVarIntDecode(BufferLength, Buffer, Offset, &Frame->Length) ||
-            BufferLength < Frame->Length + *Offset) {
+        Frame->Length = Values[1 + Type.OFF];
+        if (BufferLength < Frame->Length + *Offset) {
             return FALSE;
         }
         Frame->ExplicitLength = TRUE;
@@ -992,9 +1042,13 @@ QuicNewConnectionIDFrameDecode(
     _Out_ QUIC_NEW_CONNECTION_ID_EX* Frame
     )
 {
-    if (!QuicVarIntDecode(BufferLength, Buffer, Offset, &Frame->Sequence) ||
-        !QuicVarIntDecode(BufferLength, Buffer, Offset, &Frame->RetirePriorTo) ||
-        Frame->RetirePriorTo > Frame->Sequence ||
+    QUIC_VAR_INT Values[2];
+    if (!QuicVarIntDecodeMany(BufferLength, Buffer, Offset, ARRAYSIZE(Values), Values)) {
+        return FALSE;
+    }
+    Frame->Sequence = Values[0];
+    Frame->RetirePriorTo = Values[1];
+    if (Frame->RetirePriorTo > Frame->Sequence ||
         BufferLength < *Offset + 1) {
         return FALSE;
     }
@@ -550,6 +550,16 @@ QuicPacketHash(
         const uint8_t* const RemoteCid
     );
 
+void
+QuicPacketRetain(
+    _Inout_ QUIC_RX_PACKET* Packet
+    );
+
+void
+QuicPacketRelease(
+    _Inout_ QUIC_RX_PACKET* Packet
+    );
+
 QUIC_PACKET_KEY_TYPE
 QuicEncryptLevelToKeyType(
     QUIC_ENCRYPT_LEVEL Level
@@ -739,6 +749,13 @@ QuicAckTrackerHasPacketsToAck(
     _In_ const QUIC_ACK_TRACKER* Tracker
     );
 
+void
+QuicRecvChunkInitialize(
+    _Inout_ QUIC_RECV_CHUNK* Chunk,
+    _In_ uint32_t AllocLength,
+    _In_opt_ uint8_t* Buffer
+    );
+
 BOOLEAN
 QuicPacketBuilderHasAllowance(
     _In_ const QUIC_PACKET_BUILDER* Builder
@@ -784,6 +801,27 @@ QuicPacketTraceType(
     _In_ const QUIC_SENT_PACKET_METADATA* Metadata
     );
 
+BOOLEAN
+QuicSentPacketRingIsEmpty(
+    _In_ const QUIC_SENT_PACKET_RING* Ring
+    );
+
+uint64_t
+QuicSentPacketRingLargest(
+    _In_ const QUIC_SENT_PACKET_RING* Ring
+    );
+
+QUIC_SENT_PACKET_METADATA*
+QuicSentPacketRingGet(
+    _In_ const QUIC_SENT_PACKET_RING* Ring,
+    _In_ uint64_t PacketNumber
+    );
+
+QUIC_SENT_PACKET_METADATA*
+QuicSentPacketRingFirst(
+    _In_ const QUIC_SENT_PACKET_RING* Ring
+    );
+
 int64_t
 CxPlatTimeEpochMs64(
     void
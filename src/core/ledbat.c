@@ -0,0 +1,791 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    A less-than-best-effort, delay based congestion controller, following
+    LEDBAT (RFC 6817) with the LEDBAT++ modifications
+    (draft-irtf-iccrg-ledbat-plus-plus).
+
+    The queueing delay is estimated as the current delay minus the minimum
+    delay seen over the last few minutes. The delay is the one-way delay of
+    the send path when timestamps are negotiated, so congestion on the return
+    path is ignored, and the RTT otherwise. The window grows slowly while the
+    queueing delay is below the target and shrinks in proportion to how far
+    it is above it, so a connection gives way to competing traffic as soon as
+    a queue builds up.
+
+--*/
+
+#include "precomp.h"
+#ifdef QUIC_CLOG
+#include "ledbat.c.clog.h"
+#endif
+
+#include "ledbat.h"
+
+//
+// The queueing delay target. LEDBAT++ uses 60 ms; shorter paths use their
+// minimum RTT instead, so the controller also yields on low latency paths.
+//
+#define LEDBAT_TARGET_DELAY_MAX         MS_TO_US(60)
+#define LEDBAT_TARGET_DELAY_MIN         250 // microseconds
+
+//
+// Duration of each base delay history bucket.
+//
+#define LEDBAT_BASE_HISTORY_INTERVAL    S_TO_US(60)
+
+//
+// The window growth is divided by min(16, ceil(2 * target / minimum RTT)).
+//
+#define LEDBAT_MAX_GAIN_DIVISOR         16
+
+//
+// Periodic slowdown: the window is held at the minimum for two round trips,
+// two round trips after the initial slow start, and then again after nine
+// times the duration of the previous slowdown and the slow start following
+// it, keeping the time spent slowed down to about 10%.
+//
+#define LEDBAT_SLOWDOWN_RTTS            2
+#define LEDBAT_SLOWDOWN_INTERVAL_FACTOR 9
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+LedbatCongestionControlCanSend(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_LEDBAT* Ledbat = &Cc->Ledbat;
+    return Ledbat->BytesInFlight < Ledbat->CongestionWindow || Ledbat->Exemptions > 0;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+LedbatCongestionControlSetExemption(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint8_t NumPackets
+    )
+{
+    Cc->Ledbat.Exemptions = NumPackets;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+LedbatCongestionControlGetMinimumWindow(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    return
+        (uint32_t)QuicPathGetDatagramPayloadSize(&Connection->Paths[0]) *
+        QUIC_PERSISTENT_CONGESTION_WINDOW_PACKETS;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+LedbatCongestionControlReset(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ BOOLEAN FullReset
+    )
+{
+    QUIC_CONGESTION_CONTROL_LEDBAT* Ledbat = &Cc->Ledbat;
+
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    const uint16_t DatagramPayloadLength =
+        QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+    Ledbat->SlowStartThreshold = UINT32_MAX;
+    Ledbat->IsInRecovery = FALSE;
+    Ledbat->HasHadCongestionEvent = FALSE;
+    Ledbat->IsInSlowdown = FALSE;
+    Ledbat->SlowdownStartTime = 0;
+    Ledbat->CongestionWindow = DatagramPayloadLength * Ledbat->InitialWindowPackets;
+    Ledbat->BytesInFlightMax = Ledbat->CongestionWindow / 2;
+    Ledbat->LastSendAllowance = 0;
+    Ledbat->AimdAccumulator = 0;
+    if (FullReset) {
+        Ledbat->BytesInFlight = 0;
+    }
+
+    //
+    // The base delay history is a property of the path, so it is kept.
+    //
+
+    QuicConnLogOutFlowStats(Connection);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+LedbatCongestionControlGetSendAllowance(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeSinceLastSend, // microsec
+    _In_ BOOLEAN TimeSinceLastSendValid
+    )
+{
+    QUIC_CONGESTION_CONTROL_LEDBAT* Ledbat = &Cc->Ledbat;
+
+    uint32_t SendAllowance;
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    if (Ledbat->BytesInFlight >= Ledbat->CongestionWindow) {
+        //
+        // We are CC blocked, so we can't send anything.
+        //
+        SendAllowance = 0;
+
+    } else if (
+        !TimeSinceLastSendValid ||
+        !Connection->Settings.PacingEnabled ||
+        !Connection->Paths[0].GotFirstRttSample ||
+        Connection->Paths[0].SmoothedRtt < QUIC_MIN_PACING_RTT) {
+        //
+        // We're not in the necessary state to pace.
+        //
+        SendAllowance = Ledbat->CongestionWindow - Ledbat->BytesInFlight;
+
+    } else {
+
+        //
+        // We are pacing, so split the congestion window into chunks which are
+        // spread out over the RTT. As with CUBIC, use the predicted window of
+        // the next round trip: double the current window in slow start, and
+        // 25% more in congestion avoidance.
+        //
+        uint64_t EstimatedWnd;
+        if (Ledbat->CongestionWindow < Ledbat->SlowStartThreshold) {
+            EstimatedWnd = (uint64_t)Ledbat->CongestionWindow << 1;
+            if (EstimatedWnd > Ledbat->SlowStartThreshold) {
+                EstimatedWnd = Ledbat->SlowStartThreshold;
+            }
+        } else {
+            EstimatedWnd = Ledbat->CongestionWindow + (Ledbat->CongestionWindow >> 2); // CongestionWindow * 1.25
+        }
+
+        SendAllowance =
+            Ledbat->LastSendAllowance +
+            (uint32_t)((EstimatedWnd * TimeSinceLastSend) / Connection->Paths[0].SmoothedRtt);
+        if (SendAllowance < Ledbat->LastSendAllowance || // Overflow case
+            SendAllowance > (Ledbat->CongestionWindow - Ledbat->BytesInFlight)) {
+            SendAllowance = Ledbat->CongestionWindow - Ledbat->BytesInFlight;
+        }
+
+        Ledbat->LastSendAllowance = SendAllowance;
+    }
+    return SendAllowance;
+}
+
+//
+// Returns TRUE if we became unblocked.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+LedbatCongestionControlUpdateBlockedState(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ BOOLEAN PreviousCanSendState
+    )
+{
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    QuicConnLogOutFlowStats(Connection);
+    if (PreviousCanSendState != LedbatCongestionControlCanSend(Cc)) {
+        if (PreviousCanSendState) {
+            QuicConnAddOutFlowBlockedReason(
+                Connection, QUIC_FLOW_BLOCKED_CONGESTION_CONTROL);
+        } else {
+            QuicConnRemoveOutFlowBlockedReason(
+                Connection, QUIC_FLOW_BLOCKED_CONGESTION_CONTROL);
+            Connection->Send.LastFlushTime = CxPlatTimeUs64(); // Reset last flush time
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+//
+// Records a delay sample in the base and current delay filters.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+LedbatCongestionControlUpdateDelay(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t Delay,
+    _In_ uint64_t TimeNow
+    )
+{
+    QUIC_CONGESTION_CONTROL_LEDBAT* Ledbat = &Cc->Ledbat;
+
+    if (!Ledbat->DelayValid) {
+        for (uint32_t i = 0; i < LEDBAT_BASE_HISTORY; ++i) {
+            Ledbat->BaseDelays[i] = UINT64_MAX;
+        }
+        for (uint32_t i = 0; i < LEDBAT_CURRENT_FILTER; ++i) {
+            Ledbat->CurrentDelays[i] = UINT64_MAX;
+        }
+        Ledbat->BaseDelayIndex = 0;
+        Ledbat->BaseDelayBucketStart = TimeNow;
+        Ledbat->DelayValid = TRUE;
+    }
+
+    if (CxPlatTimeDiff64(Ledbat->BaseDelayBucketStart, TimeNow) >= LEDBAT_BASE_HISTORY_INTERVAL) {
+        Ledbat->BaseDelayIndex = (Ledbat->BaseDelayIndex + 1) % LEDBAT_BASE_HISTORY;
+        Ledbat->BaseDelays[Ledbat->BaseDelayIndex] = Delay;
+        Ledbat->BaseDelayBucketStart = TimeNow;
+    } else if (Delay < Ledbat->BaseDelays[Ledbat->BaseDelayIndex]) {
+        Ledbat->BaseDelays[Ledbat->BaseDelayIndex] = Delay;
+    }
+
+    Ledbat->CurrentDelays[Ledbat->CurrentDelayIndex] = Delay;
+    Ledbat->CurrentDelayIndex = (Ledbat->CurrentDelayIndex + 1) % LEDBAT_CURRENT_FILTER;
+}
+
+//
+// Returns the current delay minus the base delay.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+LedbatCongestionControlGetQueueingDelay(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONGESTION_CONTROL_LEDBAT* Ledbat = &Cc->Ledbat;
+
+    if (!Ledbat->DelayValid) {
+        return 0;
+    }
+
+    uint64_t Base = UINT64_MAX;
+    for (uint32_t i = 0; i < LEDBAT_BASE_HISTORY; ++i) {
+        Base = CXPLAT_MIN(Base, Ledbat->BaseDelays[i]);
+    }
+    uint64_t Current = UINT64_MAX;
+    for (uint32_t i = 0; i < LEDBAT_CURRENT_FILTER; ++i) {
+        Current = CXPLAT_MIN(Current, Ledbat->CurrentDelays[i]);
+    }
+
+    return Current - Base;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+LedbatCongestionControlOnSlowStartExit(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeNow,
+    _In_ uint64_t SmoothedRtt
+    )
+{
+    QUIC_CONGESTION_CONTROL_LEDBAT* Ledbat = &Cc->Ledbat;
+
+    if (Ledbat->SlowdownStartTime != 0) {
+        Ledbat->NextSlowdownTime =
+            TimeNow +
+            LEDBAT_SLOWDOWN_INTERVAL_FACTOR *
+                CxPlatTimeDiff64(Ledbat->SlowdownStartTime, TimeNow);
+        Ledbat->SlowdownStartTime = 0;
+    } else if (Ledbat->NextSlowdownTime == 0) {
+        //
+        // The end of the initial slow start.
+        //
+        Ledbat->NextSlowdownTime = TimeNow + LEDBAT_SLOWDOWN_RTTS * SmoothedRtt;
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+LedbatCongestionControlOnCongestionEvent(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeNowUs,
+    _In_ BOOLEAN IsPersistentCongestion,
+    _In_ BOOLEAN Ecn
+    )
+{
+    QUIC_CONGESTION_CONTROL_LEDBAT* Ledbat = &Cc->Ledbat;
+
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    const uint32_t MinimumWindow = LedbatCongestionControlGetMinimumWindow(Cc);
+    QuicTraceEvent(
+        ConnCongestionV2,
+        "[conn][%p] Congestion event: IsEcn=%hu",
+        Connection,
+        Ecn);
+    Connection->Stats.Send.CongestionCount++;
+
+    Ledbat->IsInRecovery = TRUE;
+    Ledbat->HasHadCongestionEvent = TRUE;
+    Ledbat->AimdAccumulator = 0;
+
+    //
+    // If the congestion event is not triggered by ECN, save previous state,
+    // just in case this ends up being spurious.
+    //
+    if (!Ecn) {
+        Ledbat->PrevSlowStartThreshold = Ledbat->SlowStartThreshold;
+        Ledbat->PrevCongestionWindow = Ledbat->CongestionWindow;
+    }
+
+    if (IsPersistentCongestion && !Ledbat->IsInPersistentCongestion) {
+
+        QuicTraceEvent(
+            ConnPersistentCongestion,
+            "[conn][%p] Persistent congestion event",
+            Connection);
+        Connection->Stats.Send.PersistentCongestionCount++;
+
+        Connection->Paths[0].Route.State = RouteSuspected; // used only for RAW datapath
+
+        Ledbat->IsInPersistentCongestion = TRUE;
+        Ledbat->SlowStartThreshold =
+            CXPLAT_MAX(MinimumWindow, Ledbat->CongestionWindow / 2);
+        Ledbat->CongestionWindow = MinimumWindow;
+
+    } else {
+
+        //
+        // Loss and CE are both treated like in Reno (RFC 6817).
+        //
+        Ledbat->SlowStartThreshold =
+        Ledbat->CongestionWindow =
+            CXPLAT_MAX(MinimumWindow, Ledbat->CongestionWindow / 2);
+    }
+
+    if (Ledbat->SlowdownStartTime != 0) {
+        //
+        // Slow start after a slowdown ends here, so schedule the next one.
+        //
+        Ledbat->IsInSlowdown = FALSE;
+        LedbatCongestionControlOnSlowStartExit(
+            Cc, TimeNowUs, Connection->Paths[0].SmoothedRtt);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+LedbatCongestionControlOnDataSent(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t NumRetransmittableBytes
+    )
+{
+    QUIC_CONGESTION_CONTROL_LEDBAT* Ledbat = &Cc->Ledbat;
+
+    BOOLEAN PreviousCanSendState = QuicCongestionControlCanSend(Cc);
+
+    Ledbat->BytesInFlight += NumRetransmittableBytes;
+    if (Ledbat->BytesInFlightMax < Ledbat->BytesInFlight) {
+        Ledbat->BytesInFlightMax = Ledbat->BytesInFlight;
+        QuicSendBufferConnectionAdjust(QuicCongestionControlGetConnection(Cc));
+    }
+
+    if (NumRetransmittableBytes > Ledbat->LastSendAllowance) {
+        Ledbat->LastSendAllowance = 0;
+    } else {
+        Ledbat->LastSendAllowance -= NumRetransmittableBytes;
+    }
+
+    if (Ledbat->Exemptions > 0) {
+        --Ledbat->Exemptions;
+    }
+
+    LedbatCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+LedbatCongestionControlOnDataInvalidated(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t NumRetransmittableBytes
+    )
+{
+    QUIC_CONGESTION_CONTROL_LEDBAT* Ledbat = &Cc->Ledbat;
+
+    BOOLEAN PreviousCanSendState = LedbatCongestionControlCanSend(Cc);
+
+    CXPLAT_DBG_ASSERT(Ledbat->BytesInFlight >= NumRetransmittableBytes);
+    Ledbat->BytesInFlight -= NumRetransmittableBytes;
+
+    return LedbatCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+LedbatCongestionControlOnDataAcknowledged(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_ACK_EVENT* AckEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_LEDBAT* Ledbat = &Cc->Ledbat;
+
+    const uint64_t TimeNowUs = AckEvent->TimeNow;
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    BOOLEAN PreviousCanSendState = LedbatCongestionControlCanSend(Cc);
+    uint32_t BytesAcked = AckEvent->NumRetransmittableBytes;
+
+    CXPLAT_DBG_ASSERT(Ledbat->BytesInFlight >= BytesAcked);
+    Ledbat->BytesInFlight -= BytesAcked;
+
+    //
+    // Prefer one-way delay samples, which are only affected by queueing on
+    // the send path. Once they are available, the RTT samples are ignored, as
+    // the two can't be compared.
+    //
+    if (AckEvent->OneWayDelayValid && (int64_t)AckEvent->OneWayDelayLatest >= 0) {
+        if (!Ledbat->UsingOneWayDelay) {
+            Ledbat->UsingOneWayDelay = TRUE;
+            Ledbat->DelayValid = FALSE;
+        }
+        LedbatCongestionControlUpdateDelay(Cc, AckEvent->OneWayDelayLatest, TimeNowUs);
+    } else if (!Ledbat->UsingOneWayDelay && AckEvent->MinRttValid && AckEvent->MinRtt < UINT32_MAX) {
+        LedbatCongestionControlUpdateDelay(Cc, AckEvent->MinRtt, TimeNowUs);
+    }
+
+    if (Ledbat->IsInRecovery) {
+        if (AckEvent->LargestAck > Ledbat->RecoverySentPacketNumber) {
+            //
+            // Done recovering. As with CUBIC, we simply require an ACK for a
+            // packet sent after recovery started.
+            //
+            QuicTraceEvent(
+                ConnRecoveryExit,
+                "[conn][%p] Recovery complete",
+                Connection);
+            Ledbat->IsInRecovery = FALSE;
+            Ledbat->IsInPersistentCongestion = FALSE;
+        }
+        goto Exit;
+    } else if (BytesAcked == 0) {
+        goto Exit;
+    }
+
+    if (Ledbat->IsInSlowdown) {
+        if (CxPlatTimeDiff64(Ledbat->SlowdownStartTime, TimeNowUs) <
+                LEDBAT_SLOWDOWN_RTTS * AckEvent->SmoothedRtt) {
+            goto Exit;
+        }
+        //
+        // The slowdown is over. Slow start back to the window before it.
+        //
+        Ledbat->IsInSlowdown = FALSE;
+    }
+
+    //
+    // The target and the gain are scaled by the path's minimum RTT, since
+    // one-way delays are only relative.
+    //
+    const QUIC_PATH* Path = &Connection->Paths[0];
+    const uint64_t MinRtt = Path->GotFirstRttSample ? Path->MinRtt : 0;
+    const uint64_t QueueingDelay = LedbatCongestionControlGetQueueingDelay(Cc);
+    const uint64_t TargetDelay =
+        CXPLAT_MAX(
+            LEDBAT_TARGET_DELAY_MIN,
+            CXPLAT_MIN(LEDBAT_TARGET_DELAY_MAX, MinRtt));
+    const uint32_t GainDivisor =
+        MinRtt == 0 ?
+            1 :
+            (uint32_t)CXPLAT_MIN(
+                LEDBAT_MAX_GAIN_DIVISOR,
+                (2 * TargetDelay + MinRtt - 1) / MinRtt);
+    const uint16_t DatagramPayloadLength =
+        QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+
+    if (Ledbat->CongestionWindow < Ledbat->SlowStartThreshold) {
+
+        //
+        // Slow Start, at a reduced gain, until the queueing delay reaches
+        // three quarters of the target.
+        //
+        if (QueueingDelay > TargetDelay * 3 / 4) {
+            Ledbat->SlowStartThreshold = Ledbat->CongestionWindow;
+        } else {
+            Ledbat->CongestionWindow += BytesAcked / GainDivisor;
+            if (Ledbat->CongestionWindow > Ledbat->SlowStartThreshold) {
+                Ledbat->CongestionWindow = Ledbat->SlowStartThreshold;
+            }
+        }
+        if (Ledbat->CongestionWindow >= Ledbat->SlowStartThreshold) {
+            LedbatCongestionControlOnSlowStartExit(Cc, TimeNowUs, AckEvent->SmoothedRtt);
+        }
+
+    } else if (QueueingDelay < TargetDelay) {
+
+        //
+        // Congestion Avoidance below the target: grow by one datagram per
+        // GainDivisor windows acknowledged.
+        //
+        Ledbat->AimdAccumulator += BytesAcked;
+        if ((uint64_t)Ledbat->AimdAccumulator >=
+                (uint64_t)Ledbat->CongestionWindow * GainDivisor) {
+            Ledbat->AimdAccumulator = 0;
+            Ledbat->CongestionWindow += DatagramPayloadLength;
+        }
+
+    } else {
+
+        //
+        // Congestion Avoidance above the target: shrink in proportion to the
+        // excess delay, W -= W * (delay / target - 1) per round trip, by at
+        // most half the window per round trip.
+        //
+        const uint64_t Decrease =
+            CXPLAT_MIN(
+                (uint64_t)BytesAcked * (QueueingDelay - TargetDelay) / TargetDelay,
+                (uint64_t)BytesAcked / 2);
+        const uint32_t MinimumWindow = LedbatCongestionControlGetMinimumWindow(Cc);
+        if (Ledbat->CongestionWindow > MinimumWindow + Decrease) {
+            Ledbat->CongestionWindow -= (uint32_t)Decrease;
+        } else {
+            Ledbat->CongestionWindow = MinimumWindow;
+        }
+        Ledbat->SlowStartThreshold = Ledbat->CongestionWindow;
+        Ledbat->AimdAccumulator = 0;
+    }
+
+    if (Ledbat->NextSlowdownTime != 0 &&
+        Ledbat->SlowdownStartTime == 0 &&
+        Ledbat->CongestionWindow >= Ledbat->SlowStartThreshold &&
+        CxPlatTimeAtOrBefore64(Ledbat->NextSlowdownTime, TimeNowUs)) {
+        //
+        // Periodic slowdown: hold the window at the minimum, so the queue
+        // drains and the base delay can be measured again. Competing LEDBAT
+        // flows see the same drained queue, which keeps them fair.
+        //
+        Ledbat->IsInSlowdown = TRUE;
+        Ledbat->SlowdownStartTime = TimeNowUs;
+        Ledbat->SlowStartThreshold = Ledbat->CongestionWindow;
+        Ledbat->CongestionWindow = LedbatCongestionControlGetMinimumWindow(Cc);
+        Ledbat->AimdAccumulator = 0;
+    }
+
+    //
+    // Limit the growth of the window based on the number of bytes we
+    // actually manage to put on the wire. See CUBIC for details.
+    //
+    if (Ledbat->CongestionWindow > 2 * Ledbat->BytesInFlightMax) {
+        Ledbat->CongestionWindow = 2 * Ledbat->BytesInFlightMax;
+    }
+
+Exit:
+
+    if (Connection->Settings.NetStatsEventEnabled) {
+        const QUIC_PATH* Path = &Connection->Paths[0];
+        QUIC_CONNECTION_EVENT Event;
+        Event.Type = QUIC_CONNECTION_EVENT_NETWORK_STATISTICS;
+        Event.NETWORK_STATISTICS.BytesInFlight = Ledbat->BytesInFlight;
+        Event.NETWORK_STATISTICS.PostedBytes = Connection->SendBuffer.PostedBytes;
+        Event.NETWORK_STATISTICS.IdealBytes = Connection->SendBuffer.IdealBytes;
+        Event.NETWORK_STATISTICS.SmoothedRTT = Path->SmoothedRtt;
+        Event.NETWORK_STATISTICS.CongestionWindow = Ledbat->CongestionWindow;
+        Event.NETWORK_STATISTICS.Bandwidth = Ledbat->CongestionWindow / Path->SmoothedRtt;
+
+        QuicTraceLogConnVerbose(
+           IndicateDataAcked,
+           Connection,
+           "Indicating QUIC_CONNECTION_EVENT_NETWORK_STATISTICS [BytesInFlight=%u,PostedBytes=%llu,IdealBytes=%llu,SmoothedRTT=%llu,CongestionWindow=%u,Bandwidth=%llu]",
+           Event.NETWORK_STATISTICS.BytesInFlight,
+           Event.NETWORK_STATISTICS.PostedBytes,
+           Event.NETWORK_STATISTICS.IdealBytes,
+           Event.NETWORK_STATISTICS.SmoothedRTT,
+           Event.NETWORK_STATISTICS.CongestionWindow,
+           Event.NETWORK_STATISTICS.Bandwidth);
+       QuicConnIndicateEvent(Connection, &Event);
+    }
+
+    return LedbatCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+LedbatCongestionControlOnDataLost(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_LOSS_EVENT* LossEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_LEDBAT* Ledbat = &Cc->Ledbat;
+
+    BOOLEAN PreviousCanSendState = LedbatCongestionControlCanSend(Cc);
+
+    //
+    // If data is lost after the most recent congestion event (or if there
+    // hasn't been a congestion event yet) then treat this loss as a new
+    // congestion event.
+    //
+    if (!Ledbat->HasHadCongestionEvent ||
+        LossEvent->LargestPacketNumberLost > Ledbat->RecoverySentPacketNumber) {
+
+        Ledbat->RecoverySentPacketNumber = LossEvent->LargestSentPacketNumber;
+        LedbatCongestionControlOnCongestionEvent(
+            Cc,
+            LossEvent->TimeNow,
+            LossEvent->PersistentCongestion,
+            FALSE);
+    }
+
+    CXPLAT_DBG_ASSERT(Ledbat->BytesInFlight >= LossEvent->NumRetransmittableBytes);
+    Ledbat->BytesInFlight -= LossEvent->NumRetransmittableBytes;
+
+    LedbatCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+LedbatCongestionControlOnEcn(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_ECN_EVENT* EcnEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_LEDBAT* Ledbat = &Cc->Ledbat;
+
+    BOOLEAN PreviousCanSendState = LedbatCongestionControlCanSend(Cc);
+
+    if (!Ledbat->HasHadCongestionEvent ||
+        EcnEvent->LargestPacketNumberAcked > Ledbat->RecoverySentPacketNumber) {
+
+        Ledbat->RecoverySentPacketNumber = EcnEvent->LargestSentPacketNumber;
+        QuicCongestionControlGetConnection(Cc)->Stats.Send.EcnCongestionCount++;
+        LedbatCongestionControlOnCongestionEvent(
+            Cc,
+            EcnEvent->TimeNow,
+            FALSE,
+            TRUE);
+    }
+
+    LedbatCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+LedbatCongestionControlOnSpuriousCongestionEvent(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_LEDBAT* Ledbat = &Cc->Ledbat;
+
+    if (!Ledbat->IsInRecovery) {
+        return FALSE;
+    }
+
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    BOOLEAN PreviousCanSendState = QuicCongestionControlCanSend(Cc);
+
+    QuicTraceEvent(
+        ConnSpuriousCongestion,
+        "[conn][%p] Spurious congestion event",
+        Connection);
+
+    //
+    // Revert to previous state.
+    //
+    Ledbat->SlowStartThreshold = Ledbat->PrevSlowStartThreshold;
+    Ledbat->CongestionWindow = Ledbat->PrevCongestionWindow;
+
+    Ledbat->IsInRecovery = FALSE;
+    Ledbat->HasHadCongestionEvent = FALSE;
+
+    return LedbatCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+void
+LedbatCongestionControlLogOutFlowStatus(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    const QUIC_PATH* Path = &Connection->Paths[0];
+    const QUIC_CONGESTION_CONTROL_LEDBAT* Ledbat = &Cc->Ledbat;
+
+    QuicTraceEvent(
+        ConnOutFlowStatsV2,
+        "[conn][%p] OUT: BytesSent=%llu InFlight=%u CWnd=%u ConnFC=%llu ISB=%llu PostedBytes=%llu SRtt=%llu 1Way=%llu",
+        Connection,
+        Connection->Stats.Send.TotalBytes,
+        Ledbat->BytesInFlight,
+        Ledbat->CongestionWindow,
+        Connection->Send.PeerMaxData - Connection->Send.OrderedStreamBytesSent,
+        Connection->SendBuffer.IdealBytes,
+        Connection->SendBuffer.PostedBytes,
+        Path->GotFirstRttSample ? Path->SmoothedRtt : 0,
+        Path->OneWayDelay);
+}
+
+uint32_t
+LedbatCongestionControlGetBytesInFlightMax(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->Ledbat.BytesInFlightMax;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint8_t
+LedbatCongestionControlGetExemptions(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->Ledbat.Exemptions;
+}
+
+uint32_t
+LedbatCongestionControlGetCongestionWindow(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->Ledbat.CongestionWindow;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+LedbatCongestionControlIsAppLimited(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    UNREFERENCED_PARAMETER(Cc);
+    return FALSE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+LedbatCongestionControlSetAppLimited(
+    _In_ struct QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    UNREFERENCED_PARAMETER(Cc);
+}
+
+static const QUIC_CONGESTION_CONTROL QuicCongestionControlLedbat = {
+    .Name = "Ledbat",
+    .QuicCongestionControlCanSend = LedbatCongestionControlCanSend,
+    .QuicCongestionControlSetExemption = LedbatCongestionControlSetExemption,
+    .QuicCongestionControlReset = LedbatCongestionControlReset,
+    .QuicCongestionControlGetSendAllowance = LedbatCongestionControlGetSendAllowance,
+    .QuicCongestionControlOnDataSent = LedbatCongestionControlOnDataSent,
+    .QuicCongestionControlOnDataInvalidated = LedbatCongestionControlOnDataInvalidated,
+    .QuicCongestionControlOnDataAcknowledged = LedbatCongestionControlOnDataAcknowledged,
+    .QuicCongestionControlOnDataLost = LedbatCongestionControlOnDataLost,
+    .QuicCongestionControlOnEcn = LedbatCongestionControlOnEcn,
+    .QuicCongestionControlOnSpuriousCongestionEvent = LedbatCongestionControlOnSpuriousCongestionEvent,
+    .QuicCongestionControlLogOutFlowStatus = LedbatCongestionControlLogOutFlowStatus,
+    .QuicCongestionControlGetExemptions = LedbatCongestionControlGetExemptions,
+    .QuicCongestionControlGetBytesInFlightMax = LedbatCongestionControlGetBytesInFlightMax,
+    .QuicCongestionControlIsAppLimited = LedbatCongestionControlIsAppLimited,
+    .QuicCongestionControlSetAppLimited = LedbatCongestionControlSetAppLimited,
+    .QuicCongestionControlGetCongestionWindow = LedbatCongestionControlGetCongestionWindow,
+};
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+LedbatCongestionControlInitialize(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_SETTINGS_INTERNAL* Settings
+    )
+{
+    *Cc = QuicCongestionControlLedbat;
+
+    QUIC_CONGESTION_CONTROL_LEDBAT* Ledbat = &Cc->Ledbat;
+
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    const uint16_t DatagramPayloadLength =
+        QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+    Ledbat->SlowStartThreshold = UINT32_MAX;
+    Ledbat->InitialWindowPackets = Settings->InitialWindowPackets;
+    Ledbat->CongestionWindow = DatagramPayloadLength * Ledbat->InitialWindowPackets;
+    Ledbat->BytesInFlightMax = Ledbat->CongestionWindow / 2;
+
+    QuicConnLogOutFlowStats(Connection);
+}
@@ -0,0 +1,114 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+--*/
+
+#pragma once
+
+//
+// Number of one minute buckets the base delay is the minimum of (RFC 6817).
+//
+#define LEDBAT_BASE_HISTORY 10
+
+//
+// Number of recent delay samples the current delay is the minimum of.
+//
+#define LEDBAT_CURRENT_FILTER 4
+
+typedef struct QUIC_CONGESTION_CONTROL_LEDBAT {
+
+    //
+    // TRUE if we have had at least one congestion event.
+    // If TRUE, RecoverySentPacketNumber is valid.
+    //
+    BOOLEAN HasHadCongestionEvent : 1;
+
+    //
+    // This flag indicates a congestion event occurred and CC is attempting
+    // to recover from it.
+    //
+    BOOLEAN IsInRecovery : 1;
+
+    //
+    // This flag indicates a persistent congestion event occurred and CC is
+    // attempting to recover from it.
+    //
+    BOOLEAN IsInPersistentCongestion : 1;
+
+    //
+    // TRUE while the window is held at the minimum during a periodic
+    // slowdown, to let the queue drain and the base delay be measured.
+    //
+    BOOLEAN IsInSlowdown : 1;
+
+    //
+    // TRUE once a delay sample has been taken, and if the samples are one-way
+    // delays from timestamps rather than RTTs.
+    //
+    BOOLEAN DelayValid : 1;
+    BOOLEAN UsingOneWayDelay : 1;
+
+    //
+    // The size of the initial congestion window, in packets.
+    //
+    uint32_t InitialWindowPackets;
+
+    uint32_t CongestionWindow; // bytes
+    uint32_t PrevCongestionWindow; // bytes
+    uint32_t SlowStartThreshold; // bytes
+    uint32_t PrevSlowStartThreshold; // bytes
+    uint32_t AimdAccumulator; // bytes
+
+    //
+    // The number of bytes considered to be still in the network.
+    //
+    uint32_t BytesInFlight;
+    uint32_t BytesInFlightMax;
+
+    //
+    // The leftover send allowance from a previous send. Only used when pacing.
+    //
+    uint32_t LastSendAllowance; // bytes
+
+    //
+    // A count of packets which can be sent ignoring CongestionWindow.
+    //
+    uint8_t Exemptions;
+
+    //
+    // The minimum delay of each of the last LEDBAT_BASE_HISTORY minutes.
+    //
+    uint64_t BaseDelays[LEDBAT_BASE_HISTORY]; // microseconds
+    uint64_t BaseDelayBucketStart; // microseconds
+    uint32_t BaseDelayIndex;
+
+    //
+    // The last LEDBAT_CURRENT_FILTER delay samples.
+    //
+    uint32_t CurrentDelayIndex;
+    uint64_t CurrentDelays[LEDBAT_CURRENT_FILTER]; // microseconds
+
+    //
+    // Periodic slowdown state (LEDBAT++). SlowdownStartTime is non-zero from
+    // the start of a slowdown until slow start after it completes.
+    //
+    uint64_t SlowdownStartTime; // microseconds
+    uint64_t NextSlowdownTime; // microseconds
+
+    //
+    // This variable tracks the largest packet that was outstanding at the time
+    // the last congestion event occurred. An ACK for any packet number greater
+    // than this indicates recovery is over.
+    //
+    uint64_t RecoverySentPacketNumber;
+
+} QUIC_CONGESTION_CONTROL_LEDBAT;
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+LedbatCongestionControlInitialize(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_SETTINGS_INTERNAL* Settings
+    );
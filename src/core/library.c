@@ -44,6 +44,7 @@ MsQuicLibraryLoad(
         // Load the library.
         //
         CxPlatSystemLoad();
+        QuicVarIntDecoderInitialize();
         CxPlatLockInitialize(&MsQuicLib.Lock);
         CxPlatDispatchLockInitialize(&MsQuicLib.DatapathLock);
         CxPlatDispatchLockInitialize(&MsQuicLib.StatelessRetryKeysLock);
@@ -113,7 +114,7 @@ MsQuicLibraryFreePartitions(
             CxPlatPoolUninitialize(&PerProc->ConnectionPool);
             CxPlatPoolUninitialize(&PerProc->TransportParamPool);
             CxPlatPoolUninitialize(&PerProc->PacketSpacePool);
-            CxPlatLockUninitialize(&PerProc->ResetTokenLock);
+            CxPlatDispatchLockUninitialize(&PerProc->ResetTokenLock);
             CxPlatHashFree(PerProc->ResetTokenHash);
         }
         CXPLAT_FREE(MsQuicLib.PerProc, QUIC_POOL_PERPROC);
@@ -173,7 +174,7 @@ QuicLibraryInitializePartitions(
         CxPlatPoolInitialize(FALSE, sizeof(QUIC_CONNECTION), QUIC_POOL_CONN, &PerProc->ConnectionPool);
         CxPlatPoolInitialize(FALSE, sizeof(QUIC_TRANSPORT_PARAMETERS), QUIC_POOL_TP, &PerProc->TransportParamPool);
         CxPlatPoolInitialize(FALSE, sizeof(QUIC_PACKET_SPACE), QUIC_POOL_TP, &PerProc->PacketSpacePool);
-        CxPlatLockInitialize(&PerProc->ResetTokenLock);
+        CxPlatDispatchLockInitialize(&PerProc->ResetTokenLock);
     }
 
     uint8_t ResetHashKey[20];
@@ -221,6 +222,21 @@ QuicLibrarySumPerfCounters(
         }
     }
 
+    //
+    // The zero-copy send counters are tracked by the datapath itself.
+    //
+    if (MsQuicLib.Datapath != NULL &&
+        CountersPerBuffer > QUIC_PERF_COUNTER_UDP_SEND_ZEROCOPY) {
+        CXPLAT_DATAPATH_STATISTICS DatapathStats;
+        CxPlatDataPathGetStatistics(MsQuicLib.Datapath, &DatapathStats);
+        Counters[QUIC_PERF_COUNTER_UDP_SEND_ZEROCOPY] =
+            (int64_t)DatapathStats.SendZeroCopyCount;
+        if (CountersPerBuffer > QUIC_PERF_COUNTER_UDP_SEND_ZEROCOPY_COPIED) {
+            Counters[QUIC_PERF_COUNTER_UDP_SEND_ZEROCOPY_COPIED] =
+                (int64_t)DatapathStats.SendZeroCopyCopiedCount;
+        }
+    }
+
     //
     // Zero any counters that are still negative after summation.
     //
@@ -1143,10 +1159,10 @@ QuicLibrarySetGlobalParam(
             }
 
             QUIC_LIBRARY_PP* PerProc = &MsQuicLib.PerProc[i];
-            CxPlatLockAcquire(&PerProc->ResetTokenLock);
+            CxPlatDispatchLockAcquire(&PerProc->ResetTokenLock);
             CxPlatHashFree(PerProc->ResetTokenHash);
             PerProc->ResetTokenHash = TokenHash;
-            CxPlatLockRelease(&PerProc->ResetTokenLock);
+            CxPlatDispatchLockRelease(&PerProc->ResetTokenLock);
         }
         break;
 
@@ -1798,8 +1814,11 @@ MsQuicOpenVersion(
     Api->StreamSend = MsQuicStreamSend;
     Api->StreamReceiveComplete = MsQuicStreamReceiveComplete;
     Api->StreamReceiveSetEnabled = MsQuicStreamReceiveSetEnabled;
+    Api->StreamProvideReceiveBuffers = MsQuicStreamProvideReceiveBuffers;
+    Api->ConnectionPoolCreate = MsQuicConnectionPoolCreate;
 
     Api->DatagramSend = MsQuicDatagramSend;
+    Api->ConnectionSendBatch = MsQuicConnectionSendBatch;
 
     *QuicApi = Api;
 
@@ -2427,7 +2446,7 @@ CXPLAT_STATIC_ASSERT(
     CXPLAT_HASH_SHA256_SIZE >= QUIC_STATELESS_RESET_TOKEN_LENGTH,
     "Stateless reset token must be shorter than hash size used");
 
-_IRQL_requires_max_(PASSIVE_LEVEL)
+_IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 QuicLibraryGenerateStatelessResetToken(
     _In_reads_(MsQuicLib.CidTotalLength)
@@ -2438,7 +2457,7 @@ QuicLibraryGenerateStatelessResetToken(
 {
     uint8_t HashOutput[CXPLAT_HASH_SHA256_SIZE];
     QUIC_LIBRARY_PP* PerProc = QuicLibraryGetPerProc();
-    CxPlatLockAcquire(&PerProc->ResetTokenLock);
+    CxPlatDispatchLockAcquire(&PerProc->ResetTokenLock);
     QUIC_STATUS Status =
         CxPlatHashCompute(
             PerProc->ResetTokenHash,
@@ -2446,7 +2465,7 @@ QuicLibraryGenerateStatelessResetToken(
             MsQuicLib.CidTotalLength,
             sizeof(HashOutput),
             HashOutput);
-    CxPlatLockRelease(&PerProc->ResetTokenLock);
+    CxPlatDispatchLockRelease(&PerProc->ResetTokenLock);
     if (QUIC_SUCCEEDED(Status)) {
         CxPlatCopyMemory(
             ResetToken,
@@ -64,12 +64,28 @@ typedef struct QUIC_CACHEALIGN QUIC_LIBRARY_PP {
     // Used for generating stateless reset hashes.
     //
     CXPLAT_HASH* ResetTokenHash;
-    CXPLAT_LOCK ResetTokenLock;
+    CXPLAT_DISPATCH_LOCK ResetTokenLock;
 
     uint64_t SendBatchId;
     uint64_t SendPacketId;
     uint64_t ReceivePacketId;
 
+    //
+    // Limits the stateless responses sent inline on this processor. This is
+    // the time, in units of one response at QUIC_STATELESS_RESPONSE_RATE, up
+    // to which responses have been sent. A response can be sent as long as
+    // it's no more than QUIC_STATELESS_RESPONSE_BURST of them ahead of now.
+    //
+    int64_t StatelessResponseTime;
+
+    //
+    // The remote addresses recently sent an inline stateless response on this
+    // processor, indexed by address hash. Each entry holds the full hash in
+    // the high 32 bits and the time of the response, in milliseconds, in the
+    // low 32 bits.
+    //
+    uint64_t StatelessResponseFilter[QUIC_STATELESS_RESPONSE_FILTER_SIZE];
+
     //
     // Per-processor performance counters.
     //
@@ -351,6 +367,62 @@ QuicLibraryGetPerProc(
     return &MsQuicLib.PerProc[CurrentProc];
 }
 
+//
+// Takes one of the current processor's stateless responses, if it hasn't
+// already used up the rate and burst allowed.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+inline
+BOOLEAN
+QuicLibraryTryTakeStatelessResponseToken(
+    _In_ uint64_t TimeNowUs
+    )
+{
+    QUIC_LIBRARY_PP* PerProc = QuicLibraryGetPerProc();
+    const int64_t Now =
+        (int64_t)(TimeNowUs * QUIC_STATELESS_RESPONSE_RATE / S_TO_US(1));
+    int64_t Time, NewTime;
+    do {
+        Time = *(volatile int64_t*)&PerProc->StatelessResponseTime;
+        NewTime = CXPLAT_MAX(Time, Now) + 1;
+        if (NewTime > Now + QUIC_STATELESS_RESPONSE_BURST) {
+            return FALSE;
+        }
+    } while (InterlockedCompareExchange64(
+                &PerProc->StatelessResponseTime, NewTime, Time) != Time);
+    return TRUE;
+}
+
+//
+// Records a stateless response to a remote address, by its hash, on the current
+// processor. Returns FALSE if the address was already sent one within the
+// stateless operation expiration time. The filter is direct mapped and
+// unsynchronized, so colliding addresses can evict each other and racing
+// updates can be lost; either only lets an extra response through, which the
+// rate limit still bounds.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+inline
+BOOLEAN
+QuicLibraryTryRecordStatelessResponse(
+    _In_ uint32_t RemoteAddressHash,
+    _In_ uint32_t TimeNowMs
+    )
+{
+    QUIC_LIBRARY_PP* PerProc = QuicLibraryGetPerProc();
+    volatile uint64_t* Entry =
+        &PerProc->StatelessResponseFilter[
+            RemoteAddressHash & (QUIC_STATELESS_RESPONSE_FILTER_SIZE - 1)];
+    const uint64_t Previous = *Entry;
+    if ((uint32_t)(Previous >> 32) == RemoteAddressHash &&
+        CxPlatTimeDiff32((uint32_t)Previous, TimeNowMs) <
+            (uint32_t)MsQuicLib.Settings.StatelessOperationExpirationMs) {
+        return FALSE;
+    }
+    *Entry = ((uint64_t)RemoteAddressHash << 32) | TimeNowMs;
+    return TRUE;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 inline
 uint16_t
@@ -411,6 +483,7 @@ QuicPerfCounterAdd(
 }
 
 #define QuicPerfCounterIncrement(Type) QuicPerfCounterAdd(Type, 1)
+
 #define QuicPerfCounterDecrement(Type) QuicPerfCounterAdd(Type, -1)
 
 #define QUIC_PERF_SAMPLE_INTERVAL_S    1 // 1 second
@@ -639,7 +712,7 @@ QuicLibraryOnHandshakeConnectionRemoved(
 //
 // Generates a stateless reset token for the given connection ID.
 //
-_IRQL_requires_max_(PASSIVE_LEVEL)
+_IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 QuicLibraryGenerateStatelessResetToken(
     _In_reads_(MsQuicLib.CidTotalLength)
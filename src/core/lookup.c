@@ -14,21 +14,98 @@ Abstract:
 #include "lookup.c.clog.h"
 #endif
 
+//
+// A local CID in a partition's table. A slot is only filled in once: its CID
+// doesn't change after its connection is published, so lock-free readers can
+// compare it without any synchronization. Removing the CID leaves a tombstone
+// behind, which is only reclaimed when the table is rebuilt into a new array.
+//
+typedef struct QUIC_CID_SLOT {
+
+    QUIC_CONNECTION* Connection;
+    uint32_t Hash;
+    uint8_t Length;
+    uint8_t Data[QUIC_CID_MAX_LENGTH]; // Zero padded past Length.
+
+} QUIC_CID_SLOT;
+
+//
+// Connection value of a slot whose CID has been removed.
+//
+#define QUIC_CID_SLOT_REMOVED ((QUIC_CONNECTION*)(uintptr_t)1)
+
+//
+// Minimum number of slots in a partition's table. Tables are rebuilt before
+// more than half their slots are used (by live or removed CIDs), so there is
+// always an empty slot to end a probe.
+//
+#define QUIC_CID_TABLE_MIN_SIZE 32
+
+typedef struct QUIC_CID_TABLE {
+
+    uint32_t Mask;
+    QUIC_CID_SLOT Slots[0];
+
+} QUIC_CID_TABLE;
+
 typedef struct QUIC_CACHEALIGN QUIC_PARTITIONED_HASHTABLE {
 
-    CXPLAT_DISPATCH_RW_LOCK RwLock;
-    CXPLAT_HASHTABLE Table;
+    //
+    // Open addressing (linear probing) table of the partition's CIDs.
+    //
+    QUIC_CID_TABLE* Table;
+
+    //
+    // Number of live CIDs in the table, and of slots used by live or removed
+    // CIDs.
+    //
+    uint32_t Count;
+    uint32_t Used;
+
+    //
+    // Number of partitions in the set this one belongs to, so that readers
+    // don't need the lookup's PartitionCount to index the set.
+    //
+    uint16_t PartitionCount;
 
 } QUIC_PARTITIONED_HASHTABLE;
 
-_IRQL_requires_max_(DISPATCH_LEVEL)
-BOOLEAN
-QuicLookupInsertLocalCid(
-    _In_ QUIC_LOOKUP* Lookup,
-    _In_ uint32_t Hash,
-    _In_ QUIC_CID_HASH_ENTRY* SourceCid,
-    _In_ BOOLEAN UpdateRefCount
-    );
+typedef struct QUIC_CACHEALIGN QUIC_LOOKUP_READERS {
+
+    //
+    // Number of lock-free readers active in each read epoch.
+    //
+    long Active[2];
+
+} QUIC_LOOKUP_READERS;
+
+typedef enum QUIC_LOOKUP_RETIRED_TYPE {
+    QUIC_LOOKUP_RETIRED_CONNECTION, // References on a connection.
+    QUIC_LOOKUP_RETIRED_TABLE,      // A partition's replaced CID table.
+    QUIC_LOOKUP_RETIRED_TABLES      // A replaced set of partitions.
+} QUIC_LOOKUP_RETIRED_TYPE;
+
+//
+// Something removed from the partitioned tables, that is only released once
+// no lock-free reader can still be using it.
+//
+typedef struct QUIC_LOOKUP_RETIRED {
+
+    void* Object;
+
+    //
+    // The read epoch it was retired in.
+    //
+    long Epoch;
+
+    //
+    // The number of connection references, or of partitions in the set.
+    //
+    uint16_t Count;
+
+    uint8_t Type; // QUIC_LOOKUP_RETIRED_TYPE
+
+} QUIC_LOOKUP_RETIRED;
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
@@ -40,6 +117,21 @@ QuicLookupInitialize(
     CxPlatDispatchRwLockInitialize(&Lookup->RwLock);
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupFreeHashTable(
+    _In_reads_(PartitionCount) QUIC_PARTITIONED_HASHTABLE* Tables,
+    _In_ uint16_t PartitionCount
+    )
+{
+    for (uint16_t i = 0; i < PartitionCount; i++) {
+        if (Tables[i].Table != NULL) {
+            CXPLAT_FREE(Tables[i].Table, QUIC_POOL_LOOKUP_HASHTABLE);
+        }
+    }
+    CXPLAT_FREE(Tables, QUIC_POOL_LOOKUP_HASHTABLE);
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicLookupUninitialize(
@@ -52,16 +144,35 @@ QuicLookupUninitialize(
         CXPLAT_DBG_ASSERT(Lookup->SINGLE.Connection == NULL);
     } else {
         CXPLAT_DBG_ASSERT(Lookup->HASH.Tables != NULL);
+#if DEBUG
         for (uint16_t i = 0; i < Lookup->PartitionCount; i++) {
-            QUIC_PARTITIONED_HASHTABLE* Table = &Lookup->HASH.Tables[i];
-            CXPLAT_DBG_ASSERT(Table->Table.NumEntries == 0);
-#pragma warning(push)
-#pragma warning(disable:6001)
-            CxPlatHashtableUninitialize(&Table->Table);
-#pragma warning(pop)
-            CxPlatDispatchRwLockUninitialize(&Table->RwLock);
+            CXPLAT_DBG_ASSERT(Lookup->HASH.Tables[i].Count == 0);
         }
-        CXPLAT_FREE(Lookup->HASH.Tables, QUIC_POOL_LOOKUP_HASHTABLE);
+#endif
+        QuicLookupFreeHashTable(Lookup->HASH.Tables, Lookup->PartitionCount);
+    }
+
+    //
+    // Connections hold a reference on the binding, so only tables can still be
+    // waiting to be released.
+    //
+    for (long i = 0; i < Lookup->RetiredCount; i++) {
+        QUIC_LOOKUP_RETIRED* Retired = &Lookup->Retired[i];
+        CXPLAT_DBG_ASSERT(Retired->Type != QUIC_LOOKUP_RETIRED_CONNECTION);
+        if (Retired->Type == QUIC_LOOKUP_RETIRED_TABLE) {
+            CXPLAT_FREE(Retired->Object, QUIC_POOL_LOOKUP_HASHTABLE);
+        } else if (Retired->Type == QUIC_LOOKUP_RETIRED_TABLES) {
+            QuicLookupFreeHashTable(
+                (QUIC_PARTITIONED_HASHTABLE*)Retired->Object,
+                Retired->Count);
+        }
+    }
+    if (Lookup->Retired != NULL) {
+        CXPLAT_FREE(Lookup->Retired, QUIC_POOL_LOOKUP_RETIRED);
+    }
+
+    if (Lookup->Readers != NULL) {
+        CXPLAT_FREE(Lookup->Readers, QUIC_POOL_LOOKUP_READERS);
     }
 
     if (Lookup->MaximizePartitioning) {
@@ -73,47 +184,535 @@ QuicLookupUninitialize(
 }
 
 //
-// Allocates and initializes a new partitioned hash table.
+// Marks the start of a lock-free read of the partitioned tables. Returns the
+// counter to pass to QuicLookupReadEnd, since the reader might have moved to
+// another processor by then.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+long*
+QuicLookupReadBegin(
+    _In_ QUIC_LOOKUP* Lookup
+    )
+{
+    long* Active =
+        &Lookup->Readers[CxPlatProcCurrentNumber() % Lookup->ReaderCount].
+            Active[*(volatile long*)&Lookup->ReadEpoch & 1];
+    InterlockedIncrement(Active);
+    return Active;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupReadEnd(
+    _In_ long* Active
+    )
+{
+    InterlockedDecrement(Active);
+}
+
+//
+// Makes sure there is room to retire anything the lookup might have to, so
+// that removing a CID never has to allocate. Each CID in the lookup retires at
+// most one connection reference when it is removed, and inserting a CID can
+// retire at most one table and one set of tables. Requires the RwLock to be
+// held exclusively.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicLookupReserveRetired(
+    _In_ QUIC_LOOKUP* Lookup
+    )
+{
+    const uint32_t Needed = (uint32_t)Lookup->RetiredCount + Lookup->CidCount + 3;
+    if (Needed <= Lookup->RetiredCapacity) {
+        return TRUE;
+    }
+
+    uint32_t Capacity = Lookup->RetiredCapacity == 0 ? 16 : Lookup->RetiredCapacity;
+    while (Capacity < Needed) {
+        Capacity <<= 1;
+    }
+    QUIC_LOOKUP_RETIRED* Retired =
+        CXPLAT_ALLOC_NONPAGED(
+            sizeof(QUIC_LOOKUP_RETIRED) * Capacity,
+            QUIC_POOL_LOOKUP_RETIRED);
+    if (Retired == NULL) {
+        return FALSE;
+    }
+
+    if (Lookup->Retired != NULL) {
+        CxPlatCopyMemory(
+            Retired,
+            Lookup->Retired,
+            sizeof(QUIC_LOOKUP_RETIRED) * Lookup->RetiredCount);
+        CXPLAT_FREE(Lookup->Retired, QUIC_POOL_LOOKUP_RETIRED);
+    }
+    Lookup->Retired = Retired;
+    Lookup->RetiredCapacity = Capacity;
+    return TRUE;
+}
+
+//
+// Returns TRUE if no lock-free reader is still counted in the epoch before
+// the current one, so that the epoch can be advanced.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicLookupCanAdvanceEpoch(
+    _In_ QUIC_LOOKUP* Lookup
+    )
+{
+    const long Previous = (*(volatile long*)&Lookup->ReadEpoch + 1) & 1;
+    for (uint32_t i = 0; i < Lookup->ReaderCount; i++) {
+        if (*(volatile long*)&Lookup->Readers[i].Active[Previous] != 0) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+//
+// Advances the read epoch as far as the lock-free readers allow, and releases
+// everything that was retired at least two epochs ago: every reader that could
+// have seen it has finished by then. Never waits for readers; if one is still
+// active, the last reader of its epoch does this on its way out. Requires the
+// RwLock to be held exclusively.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupReclaim(
+    _In_ QUIC_LOOKUP* Lookup
+    )
+{
+    const uint32_t Count = (uint32_t)Lookup->RetiredCount;
+    if (Count == 0) {
+        return;
+    }
+
+    while ((uint32_t)(Lookup->ReadEpoch - Lookup->Retired[Count - 1].Epoch) < 2 &&
+           QuicLookupCanAdvanceEpoch(Lookup)) {
+        InterlockedIncrement(&Lookup->ReadEpoch);
+    }
+
+    uint32_t Released = 0;
+    while (Released < Count &&
+           (uint32_t)(Lookup->ReadEpoch - Lookup->Retired[Released].Epoch) >= 2) {
+        QUIC_LOOKUP_RETIRED* Retired = &Lookup->Retired[Released++];
+        switch (Retired->Type) {
+        case QUIC_LOOKUP_RETIRED_CONNECTION: {
+            //
+            // The lock is held, so the last reference must not free the
+            // connection here. Releasing it as a lookup result instead queues
+            // the connection to its worker, just like the last reference of a
+            // lock-free lookup does.
+            //
+            QUIC_CONNECTION* Connection = (QUIC_CONNECTION*)Retired->Object;
+            QuicConnAddRef(Connection, QUIC_CONN_REF_LOOKUP_RESULT);
+            for (uint16_t i = 0; i < Retired->Count; i++) {
+                QuicConnRelease(Connection, QUIC_CONN_REF_LOOKUP_TABLE);
+            }
+            QuicConnRelease(Connection, QUIC_CONN_REF_LOOKUP_RESULT);
+            break;
+        }
+        case QUIC_LOOKUP_RETIRED_TABLE:
+            CXPLAT_FREE(Retired->Object, QUIC_POOL_LOOKUP_HASHTABLE);
+            break;
+        default:
+            QuicLookupFreeHashTable(
+                (QUIC_PARTITIONED_HASHTABLE*)Retired->Object,
+                Retired->Count);
+            break;
+        }
+    }
+
+    if (Released != 0) {
+        CxPlatMoveMemory(
+            Lookup->Retired,
+            Lookup->Retired + Released,
+            sizeof(QUIC_LOOKUP_RETIRED) * (Count - Released));
+        *(volatile long*)&Lookup->RetiredCount = (long)(Count - Released);
+    }
+}
+
+//
+// Retires something that was just removed from the partitioned tables, which
+// lock-free readers might still be using, and releases whatever can already
+// be. Requires the RwLock to be held exclusively, and room to have been
+// reserved.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupRetire(
+    _In_ QUIC_LOOKUP* Lookup,
+    _In_ QUIC_LOOKUP_RETIRED_TYPE Type,
+    _In_ void* Object,
+    _In_ uint16_t Count
+    )
+{
+    CXPLAT_FRE_ASSERT((uint32_t)Lookup->RetiredCount < Lookup->RetiredCapacity);
+    QUIC_LOOKUP_RETIRED* Retired = &Lookup->Retired[Lookup->RetiredCount];
+    Retired->Object = Object;
+    Retired->Epoch = Lookup->ReadEpoch;
+    Retired->Count = Count;
+    Retired->Type = (uint8_t)Type;
+
+    //
+    // The interlocked increment orders the removal before the check of the
+    // reader counters, and pairs with the one readers leave with: either this
+    // sees the reader gone, or the reader sees something to reclaim.
+    //
+    InterlockedIncrement(&Lookup->RetiredCount);
+    QuicLookupReclaim(Lookup);
+}
+
+//
+// Retires the lookup's references on a connection whose CIDs were just
+// removed, if lock-free readers might still find it. Returns FALSE if there
+// are no such readers, in which case the caller releases the references once
+// it drops the RwLock. Requires the RwLock to be held exclusively.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicLookupRetireConnection(
+    _In_ QUIC_LOOKUP* Lookup,
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ uint16_t RefCount
+    )
+{
+    if (Lookup->HASH.Tables == NULL) {
+        return FALSE;
+    }
+    QuicLookupRetire(Lookup, QUIC_LOOKUP_RETIRED_CONNECTION, Connection, RefCount);
+    return TRUE;
+}
+
+//
+// Returns the partition a CID belongs to, from its partition ID bytes.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint16_t
+QuicLookupPartitionIndex(
+    _In_range_(>, 0) uint16_t PartitionCount,
+    _In_reads_(MsQuicLib.CidServerIdLength + QUIC_CID_PID_LENGTH)
+        const uint8_t* const CID
+    )
+{
+    CXPLAT_STATIC_ASSERT(QUIC_CID_PID_LENGTH == 2, "The code below assumes 2 bytes");
+    uint16_t PartitionIndex;
+    CxPlatCopyMemory(&PartitionIndex, CID + MsQuicLib.CidServerIdLength, 2);
+    PartitionIndex &= MsQuicLib.PartitionMask;
+    PartitionIndex %= PartitionCount;
+    return PartitionIndex;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidSlotInitialize(
+    _Out_ QUIC_CID_SLOT* Slot,
+    _In_ const QUIC_CID_HASH_ENTRY* SourceCid,
+    _In_ uint32_t Hash
+    )
+{
+    CXPLAT_DBG_ASSERT(SourceCid->CID.Length <= QUIC_CID_MAX_LENGTH);
+    CxPlatZeroMemory(Slot, sizeof(*Slot));
+    Slot->Connection = SourceCid->Connection;
+    Slot->Hash = Hash;
+    Slot->Length = SourceCid->CID.Length;
+    CxPlatCopyMemory(Slot->Data, SourceCid->CID.Data, SourceCid->CID.Length);
+}
+
+//
+// Allocates an empty table with enough slots for Count CIDs to fill no more
+// than a quarter of it.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_CID_TABLE*
+QuicCidTableAlloc(
+    _In_ uint32_t Count
+    )
+{
+    uint32_t Size = QUIC_CID_TABLE_MIN_SIZE;
+    while (Size < 4 * Count) {
+        Size <<= 1;
+    }
+    const size_t AllocSize = sizeof(QUIC_CID_TABLE) + Size * sizeof(QUIC_CID_SLOT);
+    QUIC_CID_TABLE* Table = CXPLAT_ALLOC_NONPAGED(AllocSize, QUIC_POOL_LOOKUP_HASHTABLE);
+    if (Table != NULL) {
+        CxPlatZeroMemory(Table, AllocSize);
+        Table->Mask = Size - 1;
+    }
+    return Table;
+}
+
+//
+// Fills in the first empty slot in the CID's probe sequence. The table must
+// have another empty slot left after this one.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidTableFill(
+    _Inout_ QUIC_CID_TABLE* Table,
+    _In_ const QUIC_CID_SLOT* Source
+    )
+{
+    uint32_t i = Source->Hash & Table->Mask;
+    while (Table->Slots[i].Connection != NULL) {
+        i = (i + 1) & Table->Mask;
+    }
+
+    QUIC_CID_SLOT* Slot = &Table->Slots[i];
+    Slot->Hash = Source->Hash;
+    Slot->Length = Source->Length;
+    CxPlatCopyMemory(Slot->Data, Source->Data, sizeof(Slot->Data));
+
+    //
+    // Publish the slot to readers only once the CID is completely written.
+    //
+    InterlockedExchangePointer((void**)&Slot->Connection, Source->Connection);
+}
+
+//
+// Returns the connection for the CID, given as a zero padded key, or NULL.
+// Safe to call without the RwLock, inside a read epoch.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_CONNECTION*
+QuicCidTableLookup(
+    _In_ QUIC_CID_TABLE* Table,
+    _In_reads_(QUIC_CID_MAX_LENGTH)
+        const uint8_t* const Key,
+    _In_ uint8_t Length,
+    _In_ uint32_t Hash
+    )
+{
+    for (uint32_t i = Hash & Table->Mask; ; i = (i + 1) & Table->Mask) {
+        QUIC_CID_SLOT* Slot = &Table->Slots[i];
+        QUIC_CONNECTION* Connection =
+            (QUIC_CONNECTION*)QuicReadPtrAcquire((void**)&Slot->Connection);
+        if (Connection == NULL) {
+            return NULL;
+        }
+        if (Connection != QUIC_CID_SLOT_REMOVED &&
+            Slot->Hash == Hash &&
+            Slot->Length == Length &&
+            memcmp(Slot->Data, Key, QUIC_CID_MAX_LENGTH) == 0) {
+            return Connection;
+        }
+    }
+}
+
+//
+// Inserts the CID into the partition, first rebuilding the partition's table
+// if it is half used. Requires the RwLock to be held exclusively.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
 BOOLEAN
+QuicLookupInsertPartition(
+    _In_ QUIC_LOOKUP* Lookup,
+    _Inout_ QUIC_PARTITIONED_HASHTABLE* Partition,
+    _In_ const QUIC_CID_SLOT* Source
+    )
+{
+    QUIC_CID_TABLE* Table = Partition->Table;
+
+    if (2 * (Partition->Used + 1) > Table->Mask + 1) {
+        //
+        // Copy the live CIDs into a new table, sized for the current count,
+        // and publish it. The old one is retired, since readers might still
+        // be probing it.
+        //
+        QUIC_CID_TABLE* NewTable = QuicCidTableAlloc(Partition->Count + 1);
+        if (NewTable != NULL) {
+            for (uint32_t i = 0; i <= Table->Mask; i++) {
+                if (Table->Slots[i].Connection != NULL &&
+                    Table->Slots[i].Connection != QUIC_CID_SLOT_REMOVED) {
+                    QuicCidTableFill(NewTable, &Table->Slots[i]);
+                }
+            }
+            InterlockedExchangePointer((void**)&Partition->Table, NewTable);
+            Partition->Used = Partition->Count;
+            QuicLookupRetire(Lookup, QUIC_LOOKUP_RETIRED_TABLE, Table, 0);
+            Table = NewTable;
+
+        } else if (Partition->Used + 2 > Table->Mask + 1) {
+            //
+            // The last empty slot has to stay empty to end probes.
+            //
+            return FALSE;
+        }
+    }
+
+    QuicCidTableFill(Table, Source);
+    Partition->Count++;
+    Partition->Used++;
+    return TRUE;
+}
+
+//
+// Replaces the CID's slot in the partition with a tombstone. Requires the
+// RwLock to be held exclusively.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupRemovePartition(
+    _Inout_ QUIC_PARTITIONED_HASHTABLE* Partition,
+    _In_ const QUIC_CID_SLOT* Source
+    )
+{
+    QUIC_CID_TABLE* Table = Partition->Table;
+    for (uint32_t i = Source->Hash & Table->Mask;
+        Table->Slots[i].Connection != NULL;
+        i = (i + 1) & Table->Mask) {
+
+        QUIC_CID_SLOT* Slot = &Table->Slots[i];
+        if (Slot->Connection == Source->Connection &&
+            Slot->Hash == Source->Hash &&
+            Slot->Length == Source->Length &&
+            memcmp(Slot->Data, Source->Data, QUIC_CID_MAX_LENGTH) == 0) {
+            InterlockedExchangePointer((void**)&Slot->Connection, QUIC_CID_SLOT_REMOVED);
+            CXPLAT_DBG_ASSERT(Partition->Count != 0);
+            Partition->Count--;
+            return;
+        }
+    }
+
+    CXPLAT_DBG_ASSERTMSG(FALSE, "CID not found in its partition");
+}
+
+//
+// Counts, or if Fill is set adds, each of the lookup's current CIDs in its
+// partition of the new set of tables. Requires the RwLock to be held
+// exclusively.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupCopyCids(
+    _In_ QUIC_LOOKUP* Lookup,
+    _Inout_updates_(PartitionCount) QUIC_PARTITIONED_HASHTABLE* Tables,
+    _In_range_(>, 0) uint16_t PartitionCount,
+    _In_ BOOLEAN Fill
+    )
+{
+    if (Lookup->PartitionCount == 0) {
+
+        //
+        // Only a single connection before. Copy all CIDs on the connection.
+        //
+
+        if (Lookup->SINGLE.Connection == NULL) {
+            return;
+        }
+
+        for (CXPLAT_SLIST_ENTRY* Entry = Lookup->SINGLE.Connection->SourceCids.Next;
+            Entry != NULL;
+            Entry = Entry->Next) {
+
+            QUIC_CID_HASH_ENTRY* CID =
+                CXPLAT_CONTAINING_RECORD(
+                    Entry,
+                    QUIC_CID_HASH_ENTRY,
+                    Link);
+            QUIC_CID_SLOT Slot;
+            QuicCidSlotInitialize(
+                &Slot, CID, CxPlatHashSimple(CID->CID.Length, CID->CID.Data));
+            QUIC_PARTITIONED_HASHTABLE* Partition =
+                &Tables[QuicLookupPartitionIndex(PartitionCount, Slot.Data)];
+            if (Fill) {
+                QuicCidTableFill(Partition->Table, &Slot);
+                Partition->Used++;
+                CID->CID.IsInLookupTable = TRUE;
+            }
+            Partition->Count++;
+        }
+
+    } else {
+
+        //
+        // Changes the number of partitioned tables. Copy the live CIDs from
+        // the old tables.
+        //
+
+        for (uint16_t i = 0; i < Lookup->PartitionCount; i++) {
+            const QUIC_CID_TABLE* Table = Lookup->HASH.Tables[i].Table;
+            for (uint32_t j = 0; j <= Table->Mask; j++) {
+                const QUIC_CID_SLOT* Slot = &Table->Slots[j];
+                if (Slot->Connection == NULL ||
+                    Slot->Connection == QUIC_CID_SLOT_REMOVED) {
+                    continue;
+                }
+                QUIC_PARTITIONED_HASHTABLE* Partition =
+                    &Tables[QuicLookupPartitionIndex(PartitionCount, Slot->Data)];
+                if (Fill) {
+                    QuicCidTableFill(Partition->Table, Slot);
+                    Partition->Used++;
+                }
+                Partition->Count++;
+            }
+        }
+    }
+}
+
+//
+// Allocates and initializes a new set of partitioned hash tables, holding all
+// of the lookup's current CIDs.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_PARTITIONED_HASHTABLE*
 QuicLookupCreateHashTable(
     _In_ QUIC_LOOKUP* Lookup,
     _In_range_(>, 0) uint16_t PartitionCount
     )
 {
-    CXPLAT_DBG_ASSERT(Lookup->LookupTable == NULL);
     CXPLAT_FRE_ASSERT(PartitionCount > 0);
 
-    Lookup->HASH.Tables =
+    QUIC_PARTITIONED_HASHTABLE* Tables =
         CXPLAT_ALLOC_NONPAGED(
             sizeof(QUIC_PARTITIONED_HASHTABLE) * PartitionCount,
             QUIC_POOL_LOOKUP_HASHTABLE);
+    if (Tables == NULL) {
+        return NULL;
+    }
+    CxPlatZeroMemory(Tables, sizeof(QUIC_PARTITIONED_HASHTABLE) * PartitionCount);
 
-    if (Lookup->HASH.Tables != NULL) {
-
-        uint16_t Cleanup = 0;
-        uint8_t Failed = FALSE;
-        for (uint16_t i = 0; i < PartitionCount; i++) {
-            if (!CxPlatHashtableInitializeEx(&Lookup->HASH.Tables[i].Table, CXPLAT_HASH_MIN_SIZE)) {
-                Cleanup = i;
-                Failed = TRUE;
-                break;
-            }
-            CxPlatDispatchRwLockInitialize(&Lookup->HASH.Tables[i].RwLock);
-        }
-        if (Failed) {
-            for (uint16_t i = 0; i < Cleanup; i++) {
-                CxPlatHashtableUninitialize(&Lookup->HASH.Tables[i].Table);
-            }
-            CXPLAT_FREE(Lookup->HASH.Tables, QUIC_POOL_LOOKUP_HASHTABLE);
-            Lookup->HASH.Tables = NULL;
-        } else {
-            Lookup->PartitionCount = PartitionCount;
+    //
+    // Size each table for the CIDs that will be copied into it, so that the
+    // copy can't fail.
+    //
+    QuicLookupCopyCids(Lookup, Tables, PartitionCount, FALSE);
+    for (uint16_t i = 0; i < PartitionCount; i++) {
+        Tables[i].Table = QuicCidTableAlloc(Tables[i].Count);
+        if (Tables[i].Table == NULL) {
+            QuicLookupFreeHashTable(Tables, PartitionCount);
+            return NULL;
         }
+        Tables[i].Count = 0;
+        Tables[i].PartitionCount = PartitionCount;
     }
+    QuicLookupCopyCids(Lookup, Tables, PartitionCount, TRUE);
 
-    return Lookup->HASH.Tables != NULL;
+    return Tables;
+}
+
+//
+// Allocates the per-processor counters for lock-free readers.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicLookupCreateReaders(
+    _In_ QUIC_LOOKUP* Lookup
+    )
+{
+    const uint32_t ReaderCount = CxPlatProcCount();
+    Lookup->Readers =
+        CXPLAT_ALLOC_NONPAGED(
+            sizeof(QUIC_LOOKUP_READERS) * ReaderCount,
+            QUIC_POOL_LOOKUP_READERS);
+    if (Lookup->Readers == NULL) {
+        return FALSE;
+    }
+    CxPlatZeroMemory(Lookup->Readers, sizeof(QUIC_LOOKUP_READERS) * ReaderCount);
+    Lookup->ReaderCount = ReaderCount;
+    return TRUE;
 }
 
 //
@@ -133,7 +732,13 @@ QuicLookupRebalance(
     //
 
     uint16_t PartitionCount;
-    if (Lookup->MaximizePartitioning) {
+    if (Lookup->MaximizePartitioning ||
+        (Lookup->PartitionCount > 0 &&
+         Lookup->CidCount >= QUIC_LOOKUP_SHARED_PARTITION_CID_COUNT)) {
+        //
+        // Servers, and shared client bindings with enough CIDs, shard their
+        // CIDs across every partition, by the partition ID each CID encodes.
+        //
         PartitionCount = MsQuicLib.PartitionCount;
 
     } else if (Lookup->PartitionCount > 0 ||
@@ -152,87 +757,39 @@ QuicLookupRebalance(
 
     if (PartitionCount > Lookup->PartitionCount) {
 
-        uint16_t PreviousPartitionCount = Lookup->PartitionCount;
-        void* PreviousLookup = Lookup->LookupTable;
-        Lookup->LookupTable = NULL;
-
         CXPLAT_DBG_ASSERT(PartitionCount != 0);
 
-        if (!QuicLookupCreateHashTable(Lookup, PartitionCount)) {
-            Lookup->LookupTable = PreviousLookup;
+        if (Lookup->Readers == NULL && !QuicLookupCreateReaders(Lookup)) {
             return FALSE;
         }
 
-        //
-        // Move the CIDs to the new table.
-        //
-
-        if (PreviousPartitionCount == 0) {
-
-            //
-            // Only a single connection before. Enumerate all CIDs on the
-            // connection and reinsert them into the new table(s).
-            //
-
-            if (PreviousLookup != NULL) {
-                CXPLAT_SLIST_ENTRY* Entry =
-                    ((QUIC_CONNECTION*)PreviousLookup)->SourceCids.Next;
-
-                while (Entry != NULL) {
-                    QUIC_CID_HASH_ENTRY *CID =
-                        CXPLAT_CONTAINING_RECORD(
-                            Entry,
-                            QUIC_CID_HASH_ENTRY,
-                            Link);
-                    (void)QuicLookupInsertLocalCid(
-                        Lookup,
-                        CxPlatHashSimple(CID->CID.Length, CID->CID.Data),
-                        CID,
-                        FALSE);
-                    Entry = Entry->Next;
-                }
-            }
+        if (!QuicLookupReserveRetired(Lookup)) {
+            return FALSE;
+        }
 
-        } else {
+        QUIC_PARTITIONED_HASHTABLE* Tables =
+            QuicLookupCreateHashTable(Lookup, PartitionCount);
+        if (Tables == NULL) {
+            return FALSE;
+        }
 
-            //
-            // Changes the number of partitioned tables. Remove all the CIDs
-            // from the old tables and insert them into the new tables.
-            //
+        //
+        // Publish the new tables, already holding all the CIDs, so lock-free
+        // readers only ever see a complete set. The old set is retired, since
+        // readers might still be using it.
+        //
+        QUIC_PARTITIONED_HASHTABLE* PreviousTables = Lookup->HASH.Tables;
+        uint16_t PreviousPartitionCount = Lookup->PartitionCount;
+        InterlockedExchangePointer((void**)&Lookup->HASH.Tables, Tables);
+        Lookup->PartitionCount = PartitionCount;
+        Lookup->SINGLE.Connection = NULL;
 
-            QUIC_PARTITIONED_HASHTABLE* PreviousTable = PreviousLookup;
-            for (uint16_t i = 0; i < PreviousPartitionCount; i++) {
-                CXPLAT_HASHTABLE_ENUMERATOR Enumerator;
-#pragma warning(push)
-#pragma warning(disable:6001)
-                CxPlatHashtableEnumerateBegin(&PreviousTable[i].Table, &Enumerator);
-#pragma warning(pop)
-                while (TRUE) {
-                    CXPLAT_HASHTABLE_ENTRY* Entry =
-                        CxPlatHashtableEnumerateNext(&PreviousTable[i].Table, &Enumerator);
-                    if (Entry == NULL) {
-                        CxPlatHashtableEnumerateEnd(&PreviousTable[i].Table, &Enumerator);
-                        break;
-                    }
-                    CxPlatHashtableRemove(&PreviousTable[i].Table, Entry, NULL);
-
-                    QUIC_CID_HASH_ENTRY *CID =
-                        CXPLAT_CONTAINING_RECORD(
-                            Entry,
-                            QUIC_CID_HASH_ENTRY,
-                            Entry);
-                    (void)QuicLookupInsertLocalCid(
-                        Lookup,
-                        CxPlatHashSimple(CID->CID.Length, CID->CID.Data),
-                        CID,
-                        FALSE);
-                }
-#pragma warning(push)
-#pragma warning(disable:6001)
-                CxPlatHashtableUninitialize(&PreviousTable[i].Table);
-#pragma warning(pop)
-            }
-            CXPLAT_FREE(PreviousTable, QUIC_POOL_LOOKUP_HASHTABLE);
+        if (PreviousTables != NULL) {
+            QuicLookupRetire(
+                Lookup,
+                QUIC_LOOKUP_RETIRED_TABLES,
+                PreviousTables,
+                PreviousPartitionCount);
         }
     }
 
@@ -299,42 +856,15 @@ QuicCidMatchConnection(
 }
 
 //
-// Uses the hash and destination connection ID to look up the connection in the
-// hash table. Returns the pointer to the connection if found; NULL otherwise.
+// Looks up the local CID either in the single connection, when Tables is
+// NULL, or in the partitioned tables. Requires either the Lookup->RwLock to be
+// held, or, for the partitioned tables, a read epoch.
 //
-_IRQL_requires_max_(DISPATCH_LEVEL)
-QUIC_CONNECTION*
-QuicHashLookupConnection(
-    _In_ CXPLAT_HASHTABLE* Table,
-    _In_reads_(Length)
-        const uint8_t* const DestCid,
-    _In_ uint8_t Length,
-    _In_ uint32_t Hash
-    )
-{
-    CXPLAT_HASHTABLE_LOOKUP_CONTEXT Context;
-    CXPLAT_HASHTABLE_ENTRY* TableEntry =
-        CxPlatHashtableLookup(Table, Hash, &Context);
-
-    while (TableEntry != NULL) {
-        QUIC_CID_HASH_ENTRY* CIDEntry =
-            CXPLAT_CONTAINING_RECORD(TableEntry, QUIC_CID_HASH_ENTRY, Entry);
-
-        if (CIDEntry->CID.Length == Length &&
-            memcmp(DestCid, CIDEntry->CID.Data, Length) == 0) {
-            return CIDEntry->Connection;
-        }
-
-        TableEntry = CxPlatHashtableLookupNext(Table, &Context);
-    }
-
-    return NULL;
-}
-
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_CONNECTION*
 QuicLookupFindConnectionByLocalCidInternal(
     _In_ QUIC_LOOKUP* Lookup,
+    _In_opt_ QUIC_PARTITIONED_HASHTABLE* Tables,
     _In_reads_(CIDLen)
         const uint8_t* const CID,
     _In_ uint8_t CIDLen,
@@ -343,7 +873,7 @@ QuicLookupFindConnectionByLocalCidInternal(
 {
     QUIC_CONNECTION* Connection = NULL;
 
-    if (Lookup->PartitionCount == 0) {
+    if (Tables == NULL) {
         //
         // Only a single connection is on this binding. Validate that the
         // destination connection ID matches that connection.
@@ -353,30 +883,26 @@ QuicLookupFindConnectionByLocalCidInternal(
             Connection = Lookup->SINGLE.Connection;
         }
 
-    } else {
+    } else if (CIDLen <= QUIC_CID_MAX_LENGTH) {
         CXPLAT_DBG_ASSERT(CIDLen >= QUIC_MIN_INITIAL_CONNECTION_ID_LENGTH);
         CXPLAT_DBG_ASSERT(CID != NULL);
 
         //
         // Use the destination connection ID to get the index into the
         // partitioned hash table array, and look up the connection in that
-        // hash table.
+        // hash table. Longer CIDs are never generated locally, so they can't
+        // be in the tables.
         //
-        CXPLAT_STATIC_ASSERT(QUIC_CID_PID_LENGTH == 2, "The code below assumes 2 bytes");
-        uint16_t PartitionIndex;
-        CxPlatCopyMemory(&PartitionIndex, CID + MsQuicLib.CidServerIdLength, 2);
-        PartitionIndex &= MsQuicLib.PartitionMask;
-        PartitionIndex %= Lookup->PartitionCount;
-        QUIC_PARTITIONED_HASHTABLE* Table = &Lookup->HASH.Tables[PartitionIndex];
-
-        CxPlatDispatchRwLockAcquireShared(&Table->RwLock);
+        uint8_t Key[QUIC_CID_MAX_LENGTH] = {0};
+        CxPlatCopyMemory(Key, CID, CIDLen);
+        QUIC_PARTITIONED_HASHTABLE* Partition =
+            &Tables[QuicLookupPartitionIndex(Tables->PartitionCount, Key)];
         Connection =
-            QuicHashLookupConnection(
-                &Table->Table,
-                CID,
+            QuicCidTableLookup(
+                (QUIC_CID_TABLE*)QuicReadPtrAcquire((void**)&Partition->Table),
+                Key,
                 CIDLen,
                 Hash);
-        CxPlatDispatchRwLockReleaseShared(&Table->RwLock);
     }
 
 #if QUIC_DEBUG_HASHTABLE_LOOKUP
@@ -476,24 +1002,26 @@ QuicLookupInsertLocalCid(
 
     } else {
         CXPLAT_DBG_ASSERT(SourceCid->CID.Length >= MsQuicLib.CidServerIdLength + QUIC_CID_PID_LENGTH);
+        if (SourceCid->CID.Length > QUIC_CID_MAX_LENGTH) {
+            CXPLAT_DBG_ASSERTMSG(FALSE, "Only locally generated CIDs can be partitioned");
+            return FALSE;
+        }
+
+        if (!QuicLookupReserveRetired(Lookup)) {
+            return FALSE;
+        }
 
         //
         // Insert the source connection ID into the hash table.
         //
-        CXPLAT_STATIC_ASSERT(QUIC_CID_PID_LENGTH == 2, "The code below assumes 2 bytes");
-        uint16_t PartitionIndex;
-        CxPlatCopyMemory(&PartitionIndex, SourceCid->CID.Data + MsQuicLib.CidServerIdLength, 2);
-        PartitionIndex &= MsQuicLib.PartitionMask;
-        PartitionIndex %= Lookup->PartitionCount;
-        QUIC_PARTITIONED_HASHTABLE* Table = &Lookup->HASH.Tables[PartitionIndex];
-
-        CxPlatDispatchRwLockAcquireExclusive(&Table->RwLock);
-        CxPlatHashtableInsert(
-            &Table->Table,
-            &SourceCid->Entry,
-            Hash,
-            NULL);
-        CxPlatDispatchRwLockReleaseExclusive(&Table->RwLock);
+        QUIC_CID_SLOT Slot;
+        QuicCidSlotInitialize(&Slot, SourceCid, Hash);
+        QUIC_PARTITIONED_HASHTABLE* Partition =
+            &Lookup->HASH.Tables[
+                QuicLookupPartitionIndex(Lookup->PartitionCount, Slot.Data)];
+        if (!QuicLookupInsertPartition(Lookup, Partition, &Slot)) {
+            return FALSE;
+        }
     }
 
     if (UpdateRefCount) {
@@ -609,17 +1137,19 @@ QuicLookupRemoveLocalCidInt(
         CXPLAT_DBG_ASSERT(SourceCid->CID.Length >= MsQuicLib.CidServerIdLength + QUIC_CID_PID_LENGTH);
 
         //
-        // Remove the source connection ID from the multi-hash table.
+        // Remove the source connection ID from the multi-hash table. Lock-free
+        // readers may still find the connection, so the caller retires the
+        // lookup's reference on it instead of releasing it.
         //
-        CXPLAT_STATIC_ASSERT(QUIC_CID_PID_LENGTH == 2, "The code below assumes 2 bytes");
-        uint16_t PartitionIndex;
-        CxPlatCopyMemory(&PartitionIndex, SourceCid->CID.Data + MsQuicLib.CidServerIdLength, 2);
-        PartitionIndex &= MsQuicLib.PartitionMask;
-        PartitionIndex %= Lookup->PartitionCount;
-        QUIC_PARTITIONED_HASHTABLE* Table = &Lookup->HASH.Tables[PartitionIndex];
-        CxPlatDispatchRwLockAcquireExclusive(&Table->RwLock);
-        CxPlatHashtableRemove(&Table->Table, &SourceCid->Entry, NULL);
-        CxPlatDispatchRwLockReleaseExclusive(&Table->RwLock);
+        QUIC_CID_SLOT Slot;
+        QuicCidSlotInitialize(
+            &Slot,
+            SourceCid,
+            CxPlatHashSimple(SourceCid->CID.Length, SourceCid->CID.Data));
+        QuicLookupRemovePartition(
+            &Lookup->HASH.Tables[
+                QuicLookupPartitionIndex(Lookup->PartitionCount, Slot.Data)],
+            &Slot);
     }
 }
 
@@ -633,21 +1163,65 @@ QuicLookupFindConnectionByLocalCid(
     )
 {
     uint32_t Hash = CxPlatHashSimple(CIDLen, CID);
+    QUIC_CONNECTION* ExistingConnection;
 
-    CxPlatDispatchRwLockAcquireShared(&Lookup->RwLock);
+    if (QuicReadPtrAcquire((void**)&Lookup->HASH.Tables) != NULL) {
+        //
+        // Once partitioned, the lookup is read without taking any lock. The
+        // read epoch keeps the tables, and the lookup's reference on any
+        // connection found in them, from being released until the reader is
+        // done.
+        //
+#ifdef CXPLAT_RAISE_IRQL
+        CXPLAT_RAISE_IRQL();
+#endif
+        long* Active = QuicLookupReadBegin(Lookup);
 
-    QUIC_CONNECTION* ExistingConnection =
-        QuicLookupFindConnectionByLocalCidInternal(
-            Lookup,
-            CID,
-            CIDLen,
-            Hash);
+        ExistingConnection =
+            QuicLookupFindConnectionByLocalCidInternal(
+                Lookup,
+                (QUIC_PARTITIONED_HASHTABLE*)QuicReadPtrAcquire((void**)&Lookup->HASH.Tables),
+                CID,
+                CIDLen,
+                Hash);
 
-    if (ExistingConnection != NULL) {
-        QuicConnAddRef(ExistingConnection, QUIC_CONN_REF_LOOKUP_RESULT);
-    }
+        if (ExistingConnection != NULL) {
+            QuicConnAddRef(ExistingConnection, QUIC_CONN_REF_LOOKUP_RESULT);
+        }
 
-    CxPlatDispatchRwLockReleaseShared(&Lookup->RwLock);
+        QuicLookupReadEnd(Active);
+
+        if (*(volatile long*)&Lookup->RetiredCount != 0 &&
+            QuicLookupCanAdvanceEpoch(Lookup)) {
+            //
+            // This may have been the last reader a writer's retired objects
+            // were waiting on.
+            //
+            CxPlatDispatchRwLockAcquireExclusive(&Lookup->RwLock);
+            QuicLookupReclaim(Lookup);
+            CxPlatDispatchRwLockReleaseExclusive(&Lookup->RwLock);
+        }
+#ifdef CXPLAT_RAISE_IRQL
+        CXPLAT_LOWER_IRQL();
+#endif
+
+    } else {
+        CxPlatDispatchRwLockAcquireShared(&Lookup->RwLock);
+
+        ExistingConnection =
+            QuicLookupFindConnectionByLocalCidInternal(
+                Lookup,
+                Lookup->HASH.Tables,
+                CID,
+                CIDLen,
+                Hash);
+
+        if (ExistingConnection != NULL) {
+            QuicConnAddRef(ExistingConnection, QUIC_CONN_REF_LOOKUP_RESULT);
+        }
+
+        CxPlatDispatchRwLockReleaseShared(&Lookup->RwLock);
+    }
 
     return ExistingConnection;
 }
@@ -741,6 +1315,7 @@ QuicLookupAddLocalCid(
     ExistingConnection =
         QuicLookupFindConnectionByLocalCidInternal(
             Lookup,
+            Lookup->HASH.Tables,
             SourceCid->CID.Data,
             SourceCid->CID.Length,
             Hash);
@@ -826,12 +1401,18 @@ QuicLookupRemoveLocalCid(
     _In_ CXPLAT_SLIST_ENTRY** Entry
     )
 {
+    QUIC_CONNECTION* Connection = SourceCid->Connection;
+
     CxPlatDispatchRwLockAcquireExclusive(&Lookup->RwLock);
     QuicLookupRemoveLocalCidInt(Lookup, SourceCid);
     SourceCid->CID.IsInLookupTable = FALSE;
     *Entry = (*Entry)->Next;
+    const BOOLEAN Retired = QuicLookupRetireConnection(Lookup, Connection, 1);
     CxPlatDispatchRwLockReleaseExclusive(&Lookup->RwLock);
-    QuicConnRelease(SourceCid->Connection, QUIC_CONN_REF_LOOKUP_TABLE);
+
+    if (!Retired) {
+        QuicConnRelease(Connection, QUIC_CONN_REF_LOOKUP_TABLE);
+    }
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -882,6 +1463,10 @@ QuicLookupRemoveLocalCids(
         }
         CXPLAT_FREE(CID, QUIC_POOL_CIDHASH);
     }
+    if (ReleaseRefCount != 0 &&
+        QuicLookupRetireConnection(Lookup, Connection, ReleaseRefCount)) {
+        ReleaseRefCount = 0;
+    }
     CxPlatDispatchRwLockReleaseExclusive(&Lookup->RwLock);
 
     for (uint8_t i = 0; i < ReleaseRefCount; i++) {
@@ -899,6 +1484,7 @@ QuicLookupMoveLocalConnectionIDs(
     )
 {
     CXPLAT_SLIST_ENTRY* Entry = Connection->SourceCids.Next;
+    uint16_t ReleaseRefCount = 0;
 
     CxPlatDispatchRwLockAcquireExclusive(&LookupSrc->RwLock);
     while (Entry != NULL) {
@@ -909,10 +1495,20 @@ QuicLookupMoveLocalConnectionIDs(
                 Link);
         if (CID->CID.IsInLookupTable) {
             QuicLookupRemoveLocalCidInt(LookupSrc, CID);
-            QuicConnRelease(Connection, QUIC_CONN_REF_LOOKUP_TABLE);
+            ReleaseRefCount++;
         }
         Entry = Entry->Next;
     }
+    if (ReleaseRefCount != 0 &&
+        !QuicLookupRetireConnection(LookupSrc, Connection, ReleaseRefCount)) {
+        //
+        // The caller holds its own reference on the connection, so these
+        // can't be the last.
+        //
+        for (uint16_t i = 0; i < ReleaseRefCount; i++) {
+            QuicConnRelease(Connection, QUIC_CONN_REF_LOOKUP_TABLE);
+        }
+    }
     CxPlatDispatchRwLockReleaseExclusive(&LookupSrc->RwLock);
 
     CxPlatDispatchRwLockAcquireExclusive(&LookupDest->RwLock);
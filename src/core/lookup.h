@@ -5,7 +5,13 @@
 
 --*/
 
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
 typedef struct QUIC_PARTITIONED_HASHTABLE QUIC_PARTITIONED_HASHTABLE;
+typedef struct QUIC_LOOKUP_READERS QUIC_LOOKUP_READERS;
+typedef struct QUIC_LOOKUP_RETIRED QUIC_LOOKUP_RETIRED;
 
 typedef struct QUIC_REMOTE_HASH_ENTRY {
 
@@ -17,6 +23,14 @@ typedef struct QUIC_REMOTE_HASH_ENTRY {
 
 } QUIC_REMOTE_HASH_ENTRY;
 
+//
+// The number of local CIDs at which a lookup shared by client connections
+// goes from one partition to as many as the library has. Client CIDs encode
+// their connection's partition ID, just like server CIDs, so they can be
+// sharded the same way; below this, one table is cheaper.
+//
+#define QUIC_LOOKUP_SHARED_PARTITION_CID_COUNT 128
+
 //
 // Lookup table for connections.
 //
@@ -34,35 +48,60 @@ typedef struct QUIC_LOOKUP {
     uint32_t CidCount;
 
     //
-    // Lock for accessing the lookup data.
+    // Lock for accessing the lookup data. Writers always hold it exclusively.
+    // Once the lookup is partitioned, local CID lookups no longer take it.
     //
     CXPLAT_DISPATCH_RW_LOCK RwLock;
 
     //
     // The number of partitions used for lookup tables. Value of 0 (default)
-    // indicates only a single connection (may be NULL) is bound.
+    // indicates only a single connection (may be NULL) is bound. A shared
+    // client lookup starts with 1 and, once it holds enough CIDs, is
+    // partitioned as much as a server's.
     //
     uint16_t PartitionCount;
 
     //
     // Local CID lookup.
     //
-    union {
-        void* LookupTable;
-        struct {
-            //
-            // Single client connection is bound.
-            //
-            QUIC_CONNECTION* Connection;
-        } SINGLE;
-        struct {
-            //
-            // Set of partitioned hash tables.
-            //
-            _Field_size_bytes_(PartitionCount * sizeof(QUIC_PARTITIONED_HASHTABLE))
-            QUIC_PARTITIONED_HASHTABLE* Tables;
-        } HASH;
-    };
+    struct {
+        //
+        // Single client connection is bound.
+        //
+        QUIC_CONNECTION* Connection;
+    } SINGLE;
+    struct {
+        //
+        // Set of partitioned hash tables. NULL until the lookup is
+        // partitioned, and then only ever replaced by a larger set. Read
+        // without the RwLock by local CID lookups.
+        //
+        _Field_size_bytes_(PartitionCount * sizeof(QUIC_PARTITIONED_HASHTABLE))
+        QUIC_PARTITIONED_HASHTABLE* Tables;
+    } HASH;
+
+    //
+    // Lock-free readers of the partitioned tables count themselves active, in
+    // the current read epoch, on the counters for their processor. Anything
+    // writers remove that those readers might still be using is retired, and
+    // only released once the epoch has advanced twice, which it can only do
+    // when the previous epoch's readers are done. Neither writers nor readers
+    // ever wait for each other: whichever finds the epoch can advance does the
+    // releasing.
+    //
+    long ReadEpoch;
+    uint32_t ReaderCount;
+    _Field_size_(ReaderCount)
+    QUIC_LOOKUP_READERS* Readers;
+
+    //
+    // Retired objects, oldest first. Room for them is reserved as CIDs are
+    // inserted, so that removing a CID never has to allocate.
+    //
+    long RetiredCount;
+    uint32_t RetiredCapacity;
+    _Field_size_(RetiredCapacity)
+    QUIC_LOOKUP_RETIRED* Retired;
 
     //
     // Remote Hash lookup.
@@ -200,3 +239,7 @@ QuicLookupMoveLocalConnectionIDs(
     _In_ QUIC_LOOKUP* LookupDest,
     _In_ QUIC_CONNECTION* Connection
     );
+
+#if defined(__cplusplus)
+}
+#endif
@@ -95,20 +95,27 @@ QuicLossValidate(
     )
 {
     uint32_t AckElicitingPackets = 0;
-    QUIC_SENT_PACKET_METADATA** Tail = &LossDetection->SentPackets;
-    while (*Tail) {
-        CXPLAT_DBG_ASSERT(!(*Tail)->Flags.Freed);
-        if ((*Tail)->Flags.IsAckEliciting) {
+    uint32_t OutstandingPackets = 0;
+    const QUIC_SENT_PACKET_RING* SentPackets = &LossDetection->SentPackets;
+    for (uint64_t PacketNumber = QuicSentPacketRingFindNext(SentPackets, 0, UINT64_MAX);
+        PacketNumber != UINT64_MAX;
+        PacketNumber = QuicSentPacketRingFindNext(SentPackets, PacketNumber + 1, UINT64_MAX)) {
+        const QUIC_SENT_PACKET_METADATA* Packet =
+            QuicSentPacketRingGet(SentPackets, PacketNumber);
+        CXPLAT_DBG_ASSERT(Packet != NULL);
+        CXPLAT_DBG_ASSERT(Packet->PacketNumber == PacketNumber);
+        CXPLAT_DBG_ASSERT(Packet->FrameCount != 0); // Not freed
+        if (Packet->Flags.IsAckEliciting) {
             AckElicitingPackets++;
         }
-        Tail = &((*Tail)->Next);
+        OutstandingPackets++;
     }
-    CXPLAT_DBG_ASSERT(Tail == LossDetection->SentPacketsTail);
+    CXPLAT_DBG_ASSERT(SentPackets->Count == OutstandingPackets);
     CXPLAT_DBG_ASSERT(LossDetection->PacketsInFlight == AckElicitingPackets);
 
-    Tail = &LossDetection->LostPackets;
+    QUIC_SENT_PACKET_METADATA** Tail = &LossDetection->LostPackets;
     while (*Tail) {
-        CXPLAT_DBG_ASSERT(!(*Tail)->Flags.Freed);
+        CXPLAT_DBG_ASSERT((*Tail)->FrameCount != 0); // Not freed
         Tail = &((*Tail)->Next);
     }
     CXPLAT_DBG_ASSERT(Tail == LossDetection->LostPacketsTail);
@@ -123,10 +130,11 @@ QuicLossDetectionInitialize(
     _Inout_ QUIC_LOSS_DETECTION* LossDetection
     )
 {
-    LossDetection->SentPackets = NULL;
-    LossDetection->SentPacketsTail = &LossDetection->SentPackets;
+    QuicSentPacketRingInitialize(&LossDetection->SentPackets);
     LossDetection->LostPackets = NULL;
     LossDetection->LostPacketsTail = &LossDetection->LostPackets;
+    QuicSentFrameArenaInitialize(&LossDetection->FrameArena);
+    LossDetection->LastAckedPacketInfo = NULL;
     QuicLossDetectionInitializeInternalState(LossDetection);
 }
 
@@ -138,9 +146,9 @@ QuicLossDetectionUninitialize(
 {
     QUIC_CONNECTION* Connection = QuicLossDetectionGetConnection(LossDetection);
 
-    while (LossDetection->SentPackets != NULL) {
-        QUIC_SENT_PACKET_METADATA* Packet = LossDetection->SentPackets;
-        LossDetection->SentPackets = LossDetection->SentPackets->Next;
+    QUIC_SENT_PACKET_METADATA* Packet;
+    while ((Packet = QuicSentPacketRingFirst(&LossDetection->SentPackets)) != NULL) {
+        (void)QuicSentPacketRingRemove(&LossDetection->SentPackets, Packet->PacketNumber);
 
         if (Packet->Flags.IsAckEliciting) {
             QuicTraceLogVerbose(
@@ -153,8 +161,10 @@ QuicLossDetectionUninitialize(
 
         QuicLossDetectionOnPacketDiscarded(LossDetection, Packet, FALSE);
     }
+    QuicSentPacketRingUninitialize(&LossDetection->SentPackets);
+
     while (LossDetection->LostPackets != NULL) {
-        QUIC_SENT_PACKET_METADATA* Packet = LossDetection->LostPackets;
+        Packet = LossDetection->LostPackets;
         LossDetection->LostPackets = LossDetection->LostPackets->Next;
 
         QuicTraceLogVerbose(
@@ -165,6 +175,17 @@ QuicLossDetectionUninitialize(
 
         QuicLossDetectionOnPacketDiscarded(LossDetection, Packet, FALSE);
     }
+
+    QUIC_SENT_PACKET_POOL* Pool = &Connection->Worker->SentPacketPool;
+    if (LossDetection->LastAckedPacketInfo != NULL) {
+        QuicSentFrameArenaRelease(
+            &LossDetection->FrameArena,
+            Pool,
+            LossDetection->LastAckedPacketInfo,
+            LossDetection->LastAckedPacketInfo->ArenaOffset);
+        LossDetection->LastAckedPacketInfo = NULL;
+    }
+    QuicSentFrameArenaUninitialize(&LossDetection->FrameArena, Pool);
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -186,15 +207,14 @@ QuicLossDetectionReset(
     // Throw away any outstanding packets.
     //
 
-    while (LossDetection->SentPackets != NULL) {
-        QUIC_SENT_PACKET_METADATA* Packet = LossDetection->SentPackets;
-        LossDetection->SentPackets = LossDetection->SentPackets->Next;
+    QUIC_SENT_PACKET_METADATA* Packet;
+    while ((Packet = QuicSentPacketRingFirst(&LossDetection->SentPackets)) != NULL) {
+        (void)QuicSentPacketRingRemove(&LossDetection->SentPackets, Packet->PacketNumber);
         QuicLossDetectionRetransmitFrames(LossDetection, Packet, TRUE);
     }
-    LossDetection->SentPacketsTail = &LossDetection->SentPackets;
 
     while (LossDetection->LostPackets != NULL) {
-        QUIC_SENT_PACKET_METADATA* Packet = LossDetection->LostPackets;
+        Packet = LossDetection->LostPackets;
         LossDetection->LostPackets = LossDetection->LostPackets->Next;
         QuicLossDetectionRetransmitFrames(LossDetection, Packet, TRUE);
     }
@@ -214,11 +234,17 @@ QuicLossDetectionOldestOutstandingPacket(
     _In_ QUIC_LOSS_DETECTION* LossDetection
     )
 {
-    QUIC_SENT_PACKET_METADATA* Packet = LossDetection->SentPackets;
-    while (Packet != NULL && !Packet->Flags.IsAckEliciting) {
-        Packet = Packet->Next;
+    const QUIC_SENT_PACKET_RING* SentPackets = &LossDetection->SentPackets;
+    for (uint64_t PacketNumber = QuicSentPacketRingFindNext(SentPackets, 0, UINT64_MAX);
+        PacketNumber != UINT64_MAX;
+        PacketNumber = QuicSentPacketRingFindNext(SentPackets, PacketNumber + 1, UINT64_MAX)) {
+        QUIC_SENT_PACKET_METADATA* Packet =
+            QuicSentPacketRingGet(SentPackets, PacketNumber);
+        if (Packet->Flags.IsAckEliciting) {
+            return Packet;
+        }
     }
-    return Packet;
+    return NULL;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -394,9 +420,10 @@ QuicLossDetectionOnPacketSent(
     //
     // Allocate a copy of the packet metadata.
     //
+    QUIC_SENT_PACKET_POOL* Pool = &Connection->Worker->SentPacketPool;
     QUIC_SENT_PACKET_METADATA* SentPacket =
         QuicSentPacketPoolGetPacketMetadata(
-            &Connection->Worker->SentPacketPool, TempSentPacket->FrameCount);
+            Pool, &LossDetection->FrameArena, TempSentPacket->FrameCount);
     if (SentPacket == NULL) {
         //
         // We can't allocate the memory to permanently track this packet so just
@@ -406,26 +433,38 @@ QuicLossDetectionOnPacketSent(
             AllocFailure,
             "Allocation of '%s' failed. (%llu bytes)",
             "Sent packet metadata",
-            SIZEOF_QUIC_SENT_PACKET_METADATA(TempSentPacket->FrameCount));
+            sizeof(QUIC_SENT_PACKET_METADATA) + TempSentPacket->FrameCount * sizeof(QUIC_SENT_FRAME_METADATA));
         QuicLossDetectionRetransmitFrames(LossDetection, TempSentPacket, FALSE);
         QuicSentPacketMetadataReleaseFrames(TempSentPacket, Connection);
         return;
     }
 
+    QUIC_SENT_FRAME_METADATA* Frames = QuicSentPacketMetadataGetFrames(SentPacket);
+    const BOOLEAN FramesInline = SentPacket->FramesInline;
+    CxPlatCopyMemory(
+        SentPacket, TempSentPacket, FIELD_OFFSET(QUIC_SENT_PACKET_METADATA, Frame));
+    SentPacket->FramesInline = FramesInline;
     CxPlatCopyMemory(
-        SentPacket,
-        TempSentPacket,
-        sizeof(QUIC_SENT_PACKET_METADATA) +
+        Frames,
+        QuicSentPacketMetadataGetFrames(TempSentPacket),
         sizeof(QUIC_SENT_FRAME_METADATA) * TempSentPacket->FrameCount);
-
-    LossDetection->LargestSentPacketNumber = TempSentPacket->PacketNumber;
+    SentPacket->LastAckedPacketInfo = NULL;
 
     //
-    // Add to the outstanding-packet queue.
+    // Add to the outstanding-packet ring.
     //
     SentPacket->Next = NULL;
-    *LossDetection->SentPacketsTail = SentPacket;
-    LossDetection->SentPacketsTail = &SentPacket->Next;
+    if (!QuicSentPacketRingInsert(&LossDetection->SentPackets, SentPacket)) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "Sent packet ring",
+            0);
+        QuicLossDetectionRetransmitFrames(LossDetection, SentPacket, TRUE);
+        return;
+    }
+
+    LossDetection->LargestSentPacketNumber = TempSentPacket->PacketNumber;
 
     CXPLAT_DBG_ASSERT(
         SentPacket->Flags.KeyType != QUIC_PACKET_KEY_0_RTT ||
@@ -471,22 +510,75 @@ QuicLossDetectionOnPacketSent(
 
     LossDetection->TotalBytesSent += TempSentPacket->PacketLength;
 
-    SentPacket->TotalBytesSent = LossDetection->TotalBytesSent;
+    SentPacket->TotalBytesSent = (uint32_t)LossDetection->TotalBytesSent;
 
-    SentPacket->Flags.HasLastAckedPacketInfo = FALSE;
     if (LossDetection->TimeOfLastPacketAcked) {
-        SentPacket->Flags.HasLastAckedPacketInfo = TRUE;
+        LAST_ACKED_PACKET_INFO* Info = LossDetection->LastAckedPacketInfo;
+        if (Info == NULL ||
+            Info->AckTime != LossDetection->TimeOfLastPacketAcked ||
+            Info->SentTime != LossDetection->TimeOfLastAckedPacketSent ||
+            Info->AdjustedAckTime != LossDetection->AdjustedLastAckedTime ||
+            Info->TotalBytesSent != LossDetection->TotalBytesSentAtLastAck ||
+            Info->TotalBytesAcked != LossDetection->TotalBytesAcked) {
+            //
+            // Something has been acknowledged since the current info was
+            // captured, so capture a new one for this and following packets.
+            //
+            uint16_t ArenaOffset;
+            LAST_ACKED_PACKET_INFO* NewInfo =
+                QuicSentFrameArenaAlloc(
+                    &LossDetection->FrameArena,
+                    Pool,
+                    sizeof(LAST_ACKED_PACKET_INFO),
+                    &ArenaOffset);
+            if (NewInfo != NULL) {
+                NewInfo->SentTime = LossDetection->TimeOfLastAckedPacketSent;
+                NewInfo->AckTime = LossDetection->TimeOfLastPacketAcked;
+                NewInfo->AdjustedAckTime = LossDetection->AdjustedLastAckedTime;
+                NewInfo->TotalBytesSent = LossDetection->TotalBytesSentAtLastAck;
+                NewInfo->TotalBytesAcked = LossDetection->TotalBytesAcked;
+                NewInfo->ArenaOffset = ArenaOffset;
+            }
+            if (Info != NULL) {
+                QuicSentFrameArenaRelease(
+                    &LossDetection->FrameArena, Pool, Info, Info->ArenaOffset);
+            }
+            LossDetection->LastAckedPacketInfo = Info = NewInfo;
+        }
 
-        SentPacket->LastAckedPacketInfo.SentTime = LossDetection->TimeOfLastAckedPacketSent;
-        SentPacket->LastAckedPacketInfo.AckTime = LossDetection->TimeOfLastPacketAcked;
-        SentPacket->LastAckedPacketInfo.AdjustedAckTime = LossDetection->AdjustedLastAckedTime;
-        SentPacket->LastAckedPacketInfo.TotalBytesSent = LossDetection->TotalBytesSentAtLastAck;
-        SentPacket->LastAckedPacketInfo.TotalBytesAcked = LossDetection->TotalBytesAcked;
+        if (Info != NULL) {
+            QuicSentFrameArenaAddRef(Info, Info->ArenaOffset);
+            SentPacket->LastAckedPacketInfo = Info;
+        }
     }
 
     QuicLossValidate(LossDetection);
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+uint32_t
+QuicLossDetectionGetMetadataBytesPerPacket(
+    _In_ const QUIC_LOSS_DETECTION* LossDetection
+    )
+{
+    const QUIC_SENT_FRAME_ARENA* Arena = &LossDetection->FrameArena;
+    if (Arena->PacketCount == 0) {
+        return 0;
+    }
+
+    //
+    // Packet metadata, the arena chunks holding their frames and the ring
+    // slots (plus occupancy bitmap) indexing them.
+    //
+    const uint64_t Capacity = LossDetection->SentPackets.Capacity;
+    const uint64_t Bytes =
+        (uint64_t)Arena->PacketCount * sizeof(QUIC_SENT_PACKET_METADATA) +
+        (uint64_t)Arena->ChunkCount * QUIC_SENT_FRAME_CHUNK_SIZE +
+        Capacity * sizeof(QUIC_SENT_PACKET_METADATA*) + Capacity / 8;
+
+    return (uint32_t)(Bytes / Arena->PacketCount);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicLossDetectionOnPacketAcknowledged(
@@ -529,26 +621,27 @@ QuicLossDetectionOnPacketAcknowledged(
         PacketSpace->AwaitingKeyPhaseConfirmation = FALSE;
     }
 
+    QUIC_SENT_FRAME_METADATA* Frames = QuicSentPacketMetadataGetFrames(Packet);
     for (uint8_t i = 0; i < Packet->FrameCount; i++) {
-        switch (Packet->Frames[i].Type) {
+        switch (Frames[i].Type) {
 
         case QUIC_FRAME_ACK:
         case QUIC_FRAME_ACK_1:
             QuicAckTrackerOnAckFrameAcked(
                 &Connection->Packets[EncryptLevel]->AckTracker,
-                Packet->Frames[i].ACK.LargestAckedPacketNumber);
+                Frames[i].ACK.LargestAckedPacketNumber);
             break;
 
         case QUIC_FRAME_RESET_STREAM:
-            QuicStreamOnResetAck(Packet->Frames[i].RESET_STREAM.Stream);
+            QuicStreamOnResetAck(Frames[i].RESET_STREAM.Stream);
             break;
 
         case QUIC_FRAME_RELIABLE_RESET_STREAM:
-            QuicStreamOnResetReliableAck(Packet->Frames[i].RELIABLE_RESET_STREAM.Stream);
+            QuicStreamOnResetReliableAck(Frames[i].RELIABLE_RESET_STREAM.Stream);
             break;
 
         case QUIC_FRAME_CRYPTO:
-            QuicCryptoOnAck(&Connection->Crypto, &Packet->Frames[i]);
+            QuicCryptoOnAck(&Connection->Crypto, &Frames[i]);
             break;
 
         case QUIC_FRAME_STREAM:
@@ -560,13 +653,13 @@ QuicLossDetectionOnPacketAcknowledged(
         case QUIC_FRAME_STREAM_6:
         case QUIC_FRAME_STREAM_7:
             QuicStreamOnAck(
-                Packet->Frames[i].STREAM.Stream,
+                Frames[i].STREAM.Stream,
                 Packet->Flags,
-                &Packet->Frames[i]);
+                &Frames[i]);
             break;
 
         case QUIC_FRAME_STREAM_DATA_BLOCKED:
-            if (Packet->Frames[i].STREAM_DATA_BLOCKED.Stream->OutFlowBlockedReasons &
+            if (Frames[i].STREAM_DATA_BLOCKED.Stream->OutFlowBlockedReasons &
                 QUIC_FLOW_BLOCKED_STREAM_FLOW_CONTROL) {
                 //
                 // Stream is still blocked, so queue the blocked frame up again.
@@ -577,7 +670,7 @@ QuicLossDetectionOnPacketAcknowledged(
                 //
                 QuicSendSetStreamSendFlag(
                     &Connection->Send,
-                    Packet->Frames[i].STREAM_DATA_BLOCKED.Stream,
+                    Frames[i].STREAM_DATA_BLOCKED.Stream,
                     QUIC_STREAM_SEND_FLAG_DATA_BLOCKED,
                     FALSE);
             }
@@ -588,7 +681,7 @@ QuicLossDetectionOnPacketAcknowledged(
             QUIC_CID_HASH_ENTRY* SourceCid =
                 QuicConnGetSourceCidFromSeq(
                     Connection,
-                    Packet->Frames[i].NEW_CONNECTION_ID.Sequence,
+                    Frames[i].NEW_CONNECTION_ID.Sequence,
                     FALSE,
                     &IsLastCid);
             if (SourceCid != NULL) {
@@ -601,7 +694,7 @@ QuicLossDetectionOnPacketAcknowledged(
             QUIC_CID_LIST_ENTRY* DestCid =
                 QuicConnGetDestCidFromSeq(
                     Connection,
-                    Packet->Frames[i].RETIRE_CONNECTION_ID.Sequence,
+                    Frames[i].RETIRE_CONNECTION_ID.Sequence,
                     TRUE);
             if (DestCid != NULL) {
 #pragma prefast(suppress:6001, "TODO - Why does compiler think: Using uninitialized memory '*DestCid'")
@@ -619,11 +712,11 @@ QuicLossDetectionOnPacketAcknowledged(
         case QUIC_FRAME_DATAGRAM_1:
             QuicDatagramIndicateSendStateChange(
                 Connection,
-                &Packet->Frames[i].DATAGRAM.ClientContext,
+                &Frames[i].DATAGRAM.ClientContext,
                 Packet->Flags.SuspectedLost ?
                     QUIC_DATAGRAM_SEND_ACKNOWLEDGED_SPURIOUS :
                     QUIC_DATAGRAM_SEND_ACKNOWLEDGED);
-            Packet->Frames[i].DATAGRAM.ClientContext = NULL;
+            Frames[i].DATAGRAM.ClientContext = NULL;
             break;
 
         case QUIC_FRAME_HANDSHAKE_DONE:
@@ -687,8 +780,9 @@ QuicLossDetectionRetransmitFrames(
     QUIC_CONNECTION* Connection = QuicLossDetectionGetConnection(LossDetection);
     BOOLEAN NewDataQueued = FALSE;
 
+    QUIC_SENT_FRAME_METADATA* Frames = QuicSentPacketMetadataGetFrames(Packet);
     for (uint8_t i = 0; i < Packet->FrameCount; i++) {
-        switch (Packet->Frames[i].Type) {
+        switch (Frames[i].Type) {
         case QUIC_FRAME_PING:
             if (!Packet->Flags.IsMtuProbe) {
                 //
@@ -705,7 +799,7 @@ QuicLossDetectionRetransmitFrames(
             NewDataQueued |=
                 QuicSendSetStreamSendFlag(
                     &Connection->Send,
-                    Packet->Frames[i].RESET_STREAM.Stream,
+                    Frames[i].RESET_STREAM.Stream,
                     QUIC_STREAM_SEND_FLAG_SEND_ABORT,
                     FALSE);
             break;
@@ -714,7 +808,7 @@ QuicLossDetectionRetransmitFrames(
             NewDataQueued |=
                 QuicSendSetStreamSendFlag(
                     &Connection->Send,
-                    Packet->Frames[i].RELIABLE_RESET_STREAM.Stream,
+                    Frames[i].RELIABLE_RESET_STREAM.Stream,
                     QUIC_STREAM_SEND_FLAG_RELIABLE_ABORT,
                     FALSE);
             break;
@@ -723,7 +817,7 @@ QuicLossDetectionRetransmitFrames(
             NewDataQueued |=
                 QuicSendSetStreamSendFlag(
                     &Connection->Send,
-                    Packet->Frames[i].STOP_SENDING.Stream,
+                    Frames[i].STOP_SENDING.Stream,
                     QUIC_STREAM_SEND_FLAG_RECV_ABORT,
                     FALSE);
             break;
@@ -732,7 +826,7 @@ QuicLossDetectionRetransmitFrames(
             NewDataQueued |=
                 QuicCryptoOnLoss(
                     &Connection->Crypto,
-                    &Packet->Frames[i]);
+                    &Frames[i]);
             break;
 
         case QUIC_FRAME_STREAM:
@@ -745,8 +839,8 @@ QuicLossDetectionRetransmitFrames(
         case QUIC_FRAME_STREAM_7:
             NewDataQueued |=
                 QuicStreamOnLoss(
-                    Packet->Frames[i].STREAM.Stream,
-                    &Packet->Frames[i]);
+                    Frames[i].STREAM.Stream,
+                    &Frames[i]);
             break;
 
         case QUIC_FRAME_MAX_DATA:
@@ -760,7 +854,7 @@ QuicLossDetectionRetransmitFrames(
             NewDataQueued |=
                 QuicSendSetStreamSendFlag(
                     &Connection->Send,
-                    Packet->Frames[i].MAX_STREAM_DATA.Stream,
+                    Frames[i].MAX_STREAM_DATA.Stream,
                     QUIC_STREAM_SEND_FLAG_MAX_DATA,
                     FALSE);
             break;
@@ -783,7 +877,7 @@ QuicLossDetectionRetransmitFrames(
             NewDataQueued |=
                 QuicSendSetStreamSendFlag(
                     &Connection->Send,
-                    Packet->Frames[i].STREAM_DATA_BLOCKED.Stream,
+                    Frames[i].STREAM_DATA_BLOCKED.Stream,
                     QUIC_STREAM_SEND_FLAG_DATA_BLOCKED,
                     FALSE);
             break;
@@ -793,7 +887,7 @@ QuicLossDetectionRetransmitFrames(
             QUIC_CID_HASH_ENTRY* SourceCid =
                 QuicConnGetSourceCidFromSeq(
                     Connection,
-                    Packet->Frames[i].NEW_CONNECTION_ID.Sequence,
+                    Frames[i].NEW_CONNECTION_ID.Sequence,
                     FALSE,
                     &IsLastCid);
             if (SourceCid != NULL &&
@@ -811,7 +905,7 @@ QuicLossDetectionRetransmitFrames(
             QUIC_CID_LIST_ENTRY* DestCid =
                 QuicConnGetDestCidFromSeq(
                     Connection,
-                    Packet->Frames[i].RETIRE_CONNECTION_ID.Sequence,
+                    Frames[i].RETIRE_CONNECTION_ID.Sequence,
                     FALSE);
             if (DestCid != NULL) {
                 CXPLAT_DBG_ASSERT(DestCid->CID.Retired);
@@ -864,13 +958,13 @@ QuicLossDetectionRetransmitFrames(
             if (!Packet->Flags.SuspectedLost) {
                 QuicDatagramIndicateSendStateChange(
                     Connection,
-                    &Packet->Frames[i].DATAGRAM.ClientContext,
+                    &Frames[i].DATAGRAM.ClientContext,
                     QUIC_DATAGRAM_SEND_LOST_SUSPECT);
             }
             break;
 
         case QUIC_FRAME_ACK_FREQUENCY:
-            if (Packet->Frames[i].ACK_FREQUENCY.Sequence == Connection->SendAckFreqSeqNum) {
+            if (Frames[i].ACK_FREQUENCY.Sequence == Connection->SendAckFreqSeqNum) {
                 NewDataQueued |=
                     QuicSendSetSendFlag(
                         &Connection->Send,
@@ -957,7 +1051,7 @@ QuicLossDetectionDetectAndHandleLostPackets(
         QuicLossValidate(LossDetection);
     }
 
-    if (LossDetection->SentPackets != NULL) {
+    if (!QuicSentPacketRingIsEmpty(&LossDetection->SentPackets)) {
         //
         // Remove "suspect" packets inferred lost from out-of-order ACKs.
         // The spec has:
@@ -970,10 +1064,12 @@ QuicLossDetectionDetectAndHandleLostPackets(
         uint64_t Rtt = CXPLAT_MAX(Path->SmoothedRtt, Path->LatestRttSample);
         uint64_t TimeReorderThreshold = QUIC_TIME_REORDER_THRESHOLD(Rtt);
         uint64_t LargestLostPacketNumber = 0;
-        QUIC_SENT_PACKET_METADATA* PrevPacket = NULL;
-        Packet = LossDetection->SentPackets;
-        while (Packet != NULL) {
+        QUIC_SENT_PACKET_RING* SentPackets = &LossDetection->SentPackets;
+        for (uint64_t PacketNumber = QuicSentPacketRingFindNext(SentPackets, 0, UINT64_MAX);
+            PacketNumber != UINT64_MAX;
+            PacketNumber = QuicSentPacketRingFindNext(SentPackets, PacketNumber + 1, UINT64_MAX)) {
 
+            Packet = QuicSentPacketRingGet(SentPackets, PacketNumber);
             BOOLEAN NonretransmittableHandshakePacket =
                 !Packet->Flags.IsAckEliciting &&
                 Packet->Flags.KeyType < QUIC_PACKET_KEY_1_RTT;
@@ -981,8 +1077,6 @@ QuicLossDetectionDetectAndHandleLostPackets(
                 QuicKeyTypeToEncryptLevel(Packet->Flags.KeyType);
 
             if (EncryptLevel > LossDetection->LargestAckEncryptLevel) {
-                PrevPacket = Packet;
-                Packet = Packet->Next;
                 continue;
             }
 
@@ -1032,22 +1126,11 @@ QuicLossDetectionDetectAndHandleLostPackets(
             }
 
             LargestLostPacketNumber = Packet->PacketNumber;
-            if (PrevPacket == NULL) {
-                LossDetection->SentPackets = Packet->Next;
-                if (Packet->Next == NULL) {
-                    LossDetection->SentPacketsTail = &LossDetection->SentPackets;
-                }
-            } else {
-                PrevPacket->Next = Packet->Next;
-                if (Packet->Next == NULL) {
-                    LossDetection->SentPacketsTail = &PrevPacket->Next;
-                }
-            }
+            (void)QuicSentPacketRingRemove(SentPackets, PacketNumber);
 
+            Packet->Next = NULL;
             *LossDetection->LostPacketsTail = Packet;
             LossDetection->LostPacketsTail = &Packet->Next;
-            Packet = Packet->Next;
-            *LossDetection->LostPacketsTail = NULL;
         }
 
         QuicLossValidate(LossDetection);
@@ -1062,6 +1145,7 @@ QuicLossDetectionDetectAndHandleLostPackets(
             }
 
             QUIC_LOSS_EVENT LossEvent = {
+                .TimeNow = TimeNow,
                 .LargestPacketNumberLost = LargestLostPacketNumber,
                 .LargestSentPacketNumber = LossDetection->LargestSentPacketNumber,
                 .NumRetransmittableBytes = LostRetransmittableBytes,
@@ -1146,23 +1230,14 @@ QuicLossDetectionDiscardPackets(
 
     QuicLossValidate(LossDetection);
 
-    PrevPacket = NULL;
-    Packet = LossDetection->SentPackets;
-    while (Packet != NULL) {
-        QUIC_SENT_PACKET_METADATA* NextPacket = Packet->Next;
+    QUIC_SENT_PACKET_RING* SentPackets = &LossDetection->SentPackets;
+    for (uint64_t PacketNumber = QuicSentPacketRingFindNext(SentPackets, 0, UINT64_MAX);
+        PacketNumber != UINT64_MAX;
+        PacketNumber = QuicSentPacketRingFindNext(SentPackets, PacketNumber + 1, UINT64_MAX)) {
 
+        Packet = QuicSentPacketRingGet(SentPackets, PacketNumber);
         if (Packet->Flags.KeyType == KeyType) {
-            if (PrevPacket != NULL) {
-                PrevPacket->Next = NextPacket;
-                if (NextPacket == NULL) {
-                    LossDetection->SentPacketsTail = &PrevPacket->Next;
-                }
-            } else {
-                LossDetection->SentPackets = NextPacket;
-                if (NextPacket == NULL) {
-                    LossDetection->SentPacketsTail = &LossDetection->SentPackets;
-                }
-            }
+            (void)QuicSentPacketRingRemove(SentPackets, PacketNumber);
 
             QuicTraceLogVerbose(
                 PacketTxAckedImplicit,
@@ -1184,12 +1259,6 @@ QuicLossDetectionDiscardPackets(
             QuicLossDetectionOnPacketAcknowledged(LossDetection, EncryptLevel, Packet, TRUE, TimeNow, 0);
 
             QuicSentPacketPoolReturnPacketMetadata(Packet, Connection);
-
-            Packet = NextPacket;
-
-        } else {
-            PrevPacket = Packet;
-            Packet = NextPacket;
         }
     }
 
@@ -1231,31 +1300,21 @@ QuicLossDetectionOnZeroRttRejected(
     )
 {
     QUIC_CONNECTION* Connection = QuicLossDetectionGetConnection(LossDetection);
-    QUIC_SENT_PACKET_METADATA* PrevPacket;
-    QUIC_SENT_PACKET_METADATA* Packet;
+    QUIC_SENT_PACKET_RING* SentPackets = &LossDetection->SentPackets;
     uint32_t CountRetransmittableBytes = 0;
 
     //
     // Marks all the packets as lost so they can be retransmitted immediately.
     //
 
-    PrevPacket = NULL;
-    Packet = LossDetection->SentPackets;
-    while (Packet != NULL) {
-        QUIC_SENT_PACKET_METADATA* NextPacket = Packet->Next;
+    for (uint64_t PacketNumber = QuicSentPacketRingFindNext(SentPackets, 0, UINT64_MAX);
+        PacketNumber != UINT64_MAX;
+        PacketNumber = QuicSentPacketRingFindNext(SentPackets, PacketNumber + 1, UINT64_MAX)) {
 
+        QUIC_SENT_PACKET_METADATA* Packet =
+            QuicSentPacketRingGet(SentPackets, PacketNumber);
         if (Packet->Flags.KeyType == QUIC_PACKET_KEY_0_RTT) {
-            if (PrevPacket != NULL) {
-                PrevPacket->Next = NextPacket;
-                if (NextPacket == NULL) {
-                    LossDetection->SentPacketsTail = &PrevPacket->Next;
-                }
-            } else {
-                LossDetection->SentPackets = NextPacket;
-                if (NextPacket == NULL) {
-                    LossDetection->SentPacketsTail = &LossDetection->SentPackets;
-                }
-            }
+            (void)QuicSentPacketRingRemove(SentPackets, PacketNumber);
 
             QuicTraceLogVerbose(
                 PacketTx0RttRejected,
@@ -1269,12 +1328,6 @@ QuicLossDetectionOnZeroRttRejected(
             CountRetransmittableBytes += Packet->PacketLength;
 
             QuicLossDetectionRetransmitFrames(LossDetection, Packet, TRUE);
-
-            Packet = NextPacket;
-
-        } else {
-            PrevPacket = Packet;
-            Packet = NextPacket;
         }
     }
 
@@ -1320,7 +1373,7 @@ QuicLossDetectionProcessAckBlocks(
     *InvalidAckBlock = FALSE;
 
     QUIC_SENT_PACKET_METADATA** LostPacketsStart = &LossDetection->LostPackets;
-    QUIC_SENT_PACKET_METADATA** SentPacketsStart = &LossDetection->SentPackets;
+    QUIC_SENT_PACKET_RING* SentPackets = &LossDetection->SentPackets;
     QUIC_SENT_PACKET_METADATA* LargestAckedPacket = NULL;
 
     uint32_t i = 0;
@@ -1381,38 +1434,34 @@ QuicLossDetectionProcessAckBlocks(
         }
 
         //
-        // Now find all the acknowledged packets in the SentPackets list.
+        // Now find all the acknowledged packets in the outstanding packet ring.
+        // The ring is indexed by packet number, so only the packets actually
+        // covered by this block are visited.
         //
-        if (*SentPacketsStart != NULL) {
-            while (*SentPacketsStart && (*SentPacketsStart)->PacketNumber < AckBlock->Low) {
-                SentPacketsStart = &((*SentPacketsStart)->Next);
-            }
-
-            QUIC_SENT_PACKET_METADATA** End = SentPacketsStart;
-            while (*End && (*End)->PacketNumber <= QuicRangeGetHigh(AckBlock)) {
-
-                if ((*End)->Flags.IsAckEliciting) {
+        const uint64_t AckBlockHigh = QuicRangeGetHigh(AckBlock);
+        uint64_t PacketNumber =
+            QuicSentPacketRingFindNext(SentPackets, AckBlock->Low, AckBlockHigh);
+        if (PacketNumber != UINT64_MAX) {
+            do {
+                QUIC_SENT_PACKET_METADATA* Packet =
+                    QuicSentPacketRingRemove(SentPackets, PacketNumber);
+                CXPLAT_DBG_ASSERT(Packet != NULL);
+
+                if (Packet->Flags.IsAckEliciting) {
                     LossDetection->PacketsInFlight--;
-                    AckedRetransmittableBytes += (*End)->PacketLength;
+                    AckedRetransmittableBytes += Packet->PacketLength;
                 }
-                LargestAckedPacket = *End;
-                End = &((*End)->Next);
-            }
+                LargestAckedPacket = Packet;
 
-            if (SentPacketsStart != End) {
-                //
-                // Remove the ACKed packets from the outstanding packet list.
-                //
-                *AckedPacketsTail = *SentPacketsStart;
-                AckedPacketsTail = End;
-                *SentPacketsStart = *End;
-                *End = NULL;
-                if (End == LossDetection->SentPacketsTail) {
-                    LossDetection->SentPacketsTail = SentPacketsStart;
-                }
+                Packet->Next = NULL;
+                *AckedPacketsTail = Packet;
+                AckedPacketsTail = &Packet->Next;
 
-                QuicLossValidate(LossDetection);
-            }
+                PacketNumber =
+                    QuicSentPacketRingFindNext(SentPackets, PacketNumber + 1, AckBlockHigh);
+            } while (PacketNumber != UINT64_MAX);
+
+            QuicLossValidate(LossDetection);
         }
 
         if (LargestAckedPacket != NULL &&
@@ -1486,6 +1535,7 @@ QuicLossDetectionProcessAckBlocks(
 
     QuicLossValidate(LossDetection);
 
+    BOOLEAN OneWayDelayValid = FALSE;
     if (NewLargestAckRetransmittable && !NewLargestAckDifferentPath) {
         //
         // Update the current RTT with the smallest RTT calculated, which
@@ -1506,6 +1556,7 @@ QuicLossDetectionProcessAckBlocks(
             MinRtt,
             NewLargestAckTimestamp - Connection->Stats.Timing.Start,
             Packet->SendTimestamp);
+        OneWayDelayValid = Packet->SendTimestamp != UINT64_MAX;
     }
 
     if (NewLargestAck) {
@@ -1518,8 +1569,15 @@ QuicLossDetectionProcessAckBlocks(
             BOOLEAN EcnValidated = TRUE;
             int64_t EctCeDeltaSum = 0;
             if (Ecn != NULL) {
+                //
+                // Packets are sent with ECT(1) when the congestion controller
+                // is an L4S one, and with ECT(0) otherwise.
+                //
+                const BOOLEAN L4s = Connection->CongestionControl.L4s;
+                const uint64_t EctCount = L4s ? Ecn->ECT_1_Count : Ecn->ECT_0_Count;
+                const uint64_t OtherEctCount = L4s ? Ecn->ECT_0_Count : Ecn->ECT_1_Count;
                 EctCeDeltaSum += Ecn->CE_Count - Packets->EcnCeCounter;
-                EctCeDeltaSum += Ecn->ECT_0_Count - Packets->EcnEctCounter;
+                EctCeDeltaSum += EctCount - Packets->EcnEctCounter;
                 //
                 // Conditions where ECN validation fails:
                 // 1. Reneging ECN counts from the peer.
@@ -1527,13 +1585,15 @@ QuicLossDetectionProcessAckBlocks(
                 //
                 if (EctCeDeltaSum < 0 ||
                     EctCeDeltaSum < EcnEctCounter ||
-                    Ecn->ECT_1_Count != 0 ||
-                    Connection->Send.NumPacketsSentWithEct < Ecn->ECT_0_Count) {
+                    OtherEctCount != 0 ||
+                    Connection->Send.NumPacketsSentWithEct < EctCount) {
                     EcnValidated = FALSE;
                 } else {
+                    uint64_t NewCeCount = Ecn->CE_Count - Packets->EcnCeCounter;
                     BOOLEAN NewCE = Ecn->CE_Count > Packets->EcnCeCounter;
                     Packets->EcnCeCounter = Ecn->CE_Count;
-                    Packets->EcnEctCounter = Ecn->ECT_0_Count;
+                    Packets->EcnEctCounter = EctCount;
+                    Connection->Stats.Send.EcnCePackets += NewCeCount;
                     if (Path->EcnValidationState <= ECN_VALIDATION_UNKNOWN) {
                         Path->EcnValidationState = ECN_VALIDATION_CAPABLE;
                         QuicTraceEvent(
@@ -1546,8 +1606,10 @@ QuicLossDetectionProcessAckBlocks(
                     if (Path->EcnValidationState == ECN_VALIDATION_CAPABLE &&
                         NewCE) {
                         QUIC_ECN_EVENT EcnEvent = {
+                            .TimeNow = TimeNow,
                             .LargestPacketNumberAcked = LargestAckedPacketNum,
                             .LargestSentPacketNumber = LossDetection->LargestSentPacketNumber,
+                            .NewCeCount = NewCeCount,
                         };
                         QuicCongestionControlOnEcn(&Connection->CongestionControl, &EcnEvent);
                     }
@@ -1595,6 +1657,8 @@ QuicLossDetectionProcessAckBlocks(
             .SmoothedRtt = Path->SmoothedRtt,
             .MinRtt = MinRtt,
             .OneWayDelay = Path->OneWayDelay,
+            .OneWayDelayLatest = Path->OneWayDelayLatest,
+            .OneWayDelayValid = OneWayDelayValid,
             .HasLoss = (LossDetection->LostPackets != NULL),
             .AdjustedAckTime = TimeNow - AckDelay,
             .AckedPackets = AckedPackets,
@@ -1756,8 +1820,12 @@ QuicLossDetectionScheduleProbe(
     // Not enough new stream data exists to fill the probing packets. Schedule
     // retransmits if possible.
     //
-    QUIC_SENT_PACKET_METADATA* Packet = LossDetection->SentPackets;
-    while (Packet != NULL) {
+    const QUIC_SENT_PACKET_RING* SentPackets = &LossDetection->SentPackets;
+    for (uint64_t PacketNumber = QuicSentPacketRingFindNext(SentPackets, 0, UINT64_MAX);
+        PacketNumber != UINT64_MAX;
+        PacketNumber = QuicSentPacketRingFindNext(SentPackets, PacketNumber + 1, UINT64_MAX)) {
+        QUIC_SENT_PACKET_METADATA* Packet =
+            QuicSentPacketRingGet(SentPackets, PacketNumber);
         if (Packet->Flags.IsAckEliciting) {
             QuicTraceLogVerbose(
                 PacketTxProbeRetransmit,
@@ -1776,7 +1844,6 @@ QuicLossDetectionScheduleProbe(
                 return;
             }
         }
-        Packet = Packet->Next;
     }
 
     //
@@ -1826,7 +1893,7 @@ QuicLossDetectionProcessTimerOperation(
         CxPlatTimeDiff64(OldestPacket->SentTime, TimeNow) >=
             MS_TO_US((uint64_t)Connection->Settings.DisconnectTimeoutMs)) {
         //
-        // OldestPacket has been in the SentPackets list for at least
+        // OldestPacket has been in the SentPackets ring for at least
         // DisconnectTimeoutUs without an ACK for either OldestPacket or for any
         // packets sent more than the reordering threshold after it. Assume the
         // path is dead and close the connection.
@@ -5,6 +5,10 @@
 
 --*/
 
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
 typedef struct QUIC_LOSS_DETECTION {
 
     //
@@ -53,25 +57,25 @@ typedef struct QUIC_LOSS_DETECTION {
     uint64_t TotalBytesAcked;
 
     //
-    // Number of bytes sent when last acked packet was sent
+    // Number of bytes sent when last acked packet was sent. Wraps, like
+    // QUIC_SENT_PACKET_METADATA.TotalBytesSent.
     //
-    uint64_t TotalBytesSentAtLastAck;
+    uint32_t TotalBytesSentAtLastAck;
 
     //
-    // N.B.: SentPackets and LostPackets are generally kept in ascending packet
-    // number order, and packets in the LostPackets list generally have smaller
-    // numbers than those in the SentPackets list. The only case this is not
-    // true is during the handshake. Since multiple encryption levels are used
-    // in parallel, higher numbered packets in lower encryption levels can be
-    // "lost" sooner than the higher encryption levels.
+    // N.B.: SentPackets is indexed by packet number and LostPackets is generally
+    // kept in ascending packet number order. Packets in the LostPackets list
+    // generally have smaller numbers than those in SentPackets. The only case
+    // this is not true is during the handshake. Since multiple encryption
+    // levels are used in parallel, higher numbered packets in lower encryption
+    // levels can be "lost" sooner than the higher encryption levels.
     //
 
     //
-    // Outstanding packets.
+    // Outstanding packets, indexed by packet number.
     //
     uint64_t LargestSentPacketNumber;
-    QUIC_SENT_PACKET_METADATA* SentPackets;
-    QUIC_SENT_PACKET_METADATA** SentPacketsTail;
+    QUIC_SENT_PACKET_RING SentPackets;
 
     //
     // Lost packets. The purpose of this list is to remember packets a little
@@ -82,6 +86,18 @@ typedef struct QUIC_LOSS_DETECTION {
     QUIC_SENT_PACKET_METADATA* LostPackets;
     QUIC_SENT_PACKET_METADATA** LostPacketsTail;
 
+    //
+    // Arena for the frame metadata of outstanding and lost packets.
+    //
+    QUIC_SENT_FRAME_ARENA FrameArena;
+
+    //
+    // The last acked packet info shared by packets sent since the last ACK.
+    // Allocated from FrameArena, which holds a reference on it while it is
+    // current. NULL until it is first needed.
+    //
+    LAST_ACKED_PACKET_INFO* LastAckedPacketInfo;
+
     //
     // Number of probes sent.
     //
@@ -159,6 +175,16 @@ QuicLossDetectionOnPacketSent(
     _In_ QUIC_SENT_PACKET_METADATA* SentPacket
     );
 
+//
+// Returns the average memory, in bytes, used to track each sent packet that
+// hasn't been acknowledged or forgotten yet. Returns 0 if there are none.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+uint32_t
+QuicLossDetectionGetMetadataBytesPerPacket(
+    _In_ const QUIC_LOSS_DETECTION* LossDetection
+    );
+
 //
 // Processes a received ACK frame. Returns true if the frame could be
 // successfully processed. On failure, 'InvalidFrame' indicates if the frame
@@ -187,3 +213,7 @@ void
 QuicLossDetectionProcessTimerOperation(
     _In_ QUIC_LOSS_DETECTION* LossDetection
     );
+
+#if defined(__cplusplus)
+}
+#endif
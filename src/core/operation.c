@@ -113,12 +113,27 @@ QuicOperationFree(
             QuicStreamRelease(ApiCtx->STRM_SHUTDOWN.Stream, QUIC_STREAM_REF_OPERATION);
         } else if (ApiCtx->Type == QUIC_API_TYPE_STRM_SEND) {
             QuicStreamRelease(ApiCtx->STRM_SEND.Stream, QUIC_STREAM_REF_OPERATION);
+        } else if (ApiCtx->Type == QUIC_API_TYPE_CONN_SEND_BATCH) {
+            for (uint32_t i = 0; i < ApiCtx->CONN_SEND_BATCH.StreamCount; ++i) {
+                QuicStreamRelease(ApiCtx->CONN_SEND_BATCH.Streams[i], QUIC_STREAM_REF_OPERATION);
+            }
+            CXPLAT_FREE(ApiCtx->CONN_SEND_BATCH.Streams, QUIC_POOL_SEND_BATCH);
         } else if (ApiCtx->Type == QUIC_API_TYPE_STRM_RECV_COMPLETE) {
             if (ApiCtx->STRM_RECV_COMPLETE.Stream) {
                 QuicStreamRelease(ApiCtx->STRM_RECV_COMPLETE.Stream, QUIC_STREAM_REF_OPERATION);
             }
         } else if (ApiCtx->Type == QUIC_API_TYPE_STRM_RECV_SET_ENABLED) {
             QuicStreamRelease(ApiCtx->STRM_RECV_SET_ENABLED.Stream, QUIC_STREAM_REF_OPERATION);
+        } else if (ApiCtx->Type == QUIC_API_TYPE_STRM_PROVIDE_RECV_BUFFERS) {
+            while (!CxPlatListIsEmpty(&ApiCtx->STRM_PROVIDE_RECV_BUFFERS.Chunks)) {
+                CXPLAT_FREE(
+                    CXPLAT_CONTAINING_RECORD(
+                        CxPlatListRemoveHead(&ApiCtx->STRM_PROVIDE_RECV_BUFFERS.Chunks),
+                        QUIC_RECV_CHUNK,
+                        Link),
+                    QUIC_POOL_RECVBUF);
+            }
+            QuicStreamRelease(ApiCtx->STRM_PROVIDE_RECV_BUFFERS.Stream, QUIC_STREAM_REF_OPERATION);
         }
         CxPlatPoolFree(&Worker->ApiContextPool, ApiCtx);
     } else if (Oper->Type == QUIC_OPER_TYPE_FLUSH_STREAM_RECV) {
@@ -270,6 +285,15 @@ QuicOperationQueueClear(
                         ApiCtx->STRM_START.Stream,
                         QUIC_STREAM_SHUTDOWN_FLAG_ABORT | QUIC_STREAM_SHUTDOWN_FLAG_IMMEDIATE,
                         0);
+                } else if (ApiCtx->Type == QUIC_API_TYPE_CONN_SEND_BATCH) {
+                    for (uint32_t i = 0; i < ApiCtx->CONN_SEND_BATCH.StreamCount; ++i) {
+                        if (!ApiCtx->CONN_SEND_BATCH.Streams[i]->Flags.Started) {
+                            QuicStreamShutdown(
+                                ApiCtx->CONN_SEND_BATCH.Streams[i],
+                                QUIC_STREAM_SHUTDOWN_FLAG_ABORT | QUIC_STREAM_SHUTDOWN_FLAG_IMMEDIATE,
+                                0);
+                        }
+                    }
                 }
             }
             QuicOperationFree(Worker, Oper);
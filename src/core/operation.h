@@ -56,6 +56,7 @@ typedef enum QUIC_API_TYPE {
     QUIC_API_TYPE_STRM_SEND,
     QUIC_API_TYPE_STRM_RECV_COMPLETE,
     QUIC_API_TYPE_STRM_RECV_SET_ENABLED,
+    QUIC_API_TYPE_STRM_PROVIDE_RECV_BUFFERS,
 
     QUIC_API_TYPE_SET_PARAM,
     QUIC_API_TYPE_GET_PARAM,
@@ -63,6 +64,7 @@ typedef enum QUIC_API_TYPE {
     QUIC_API_TYPE_DATAGRAM_SEND,
     QUIC_API_TYPE_CONN_COMPLETE_RESUMPTION_TICKET_VALIDATION,
     QUIC_API_TYPE_CONN_COMPLETE_CERTIFICATE_VALIDATION,
+    QUIC_API_TYPE_CONN_SEND_BATCH,
 
 } QUIC_API_TYPE;
 
@@ -154,6 +156,19 @@ typedef struct QUIC_API_CONTEXT {
             QUIC_STREAM* Stream;
             BOOLEAN IsEnabled;
         } STRM_RECV_SET_ENABLED;
+        struct {
+            QUIC_STREAM* Stream;
+            CXPLAT_LIST_ENTRY Chunks;
+        } STRM_PROVIDE_RECV_BUFFERS;
+        struct {
+            //
+            // The streams whose queued sends need to be flushed. Each holds
+            // an operation reference.
+            //
+            QUIC_STREAM** Streams;
+            uint32_t StreamCount;
+            BOOLEAN FlushDatagrams;
+        } CONN_SEND_BATCH;
 
         struct {
             HQUIC Handle;
@@ -802,6 +802,33 @@ QuicPacketLogHeader(
     }
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicPacketReleaseChain(
+    _In_ QUIC_RX_PACKET* Packets
+    )
+{
+    QUIC_RX_PACKET* ReleaseChain = Packets;
+    QUIC_RX_PACKET** ReleaseChainTail = &ReleaseChain;
+    while (Packets != NULL) {
+        QUIC_RX_PACKET* Packet = Packets;
+        Packets = (QUIC_RX_PACKET*)Packet->Next;
+        if (Packet->RetainCount != 0) {
+            //
+            // Retained by stream receive buffers. Unlink it from the chain and
+            // just release the receive path's reference instead.
+            //
+            *ReleaseChainTail = Packets;
+            QuicPacketRelease(Packet);
+        } else {
+            ReleaseChainTail = (QUIC_RX_PACKET**)&Packet->Next;
+        }
+    }
+    if (ReleaseChain != NULL) {
+        CxPlatRecvDataReturn((CXPLAT_RECV_DATA*)ReleaseChain);
+    }
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicPacketLogDrop(
@@ -606,6 +606,60 @@ QuicPacketHash(
     return Key;
 }
 
+//
+// Takes a reference on the (decrypted) datagram buffer, to use its stream data
+// in place after the receive path is done with the packet.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+inline
+void
+QuicPacketRetain(
+    _Inout_ QUIC_RX_PACKET* Packet
+    )
+{
+    CXPLAT_DBG_ASSERT(Packet->IsShortHeader);
+    if (Packet->RetainCount == 0) {
+        //
+        // First reference. Nothing else can be referencing the packet yet, and
+        // the receive path gets its own reference too.
+        //
+        Packet->RetainCount = 2;
+    } else {
+        CXPLAT_DBG_ASSERT(Packet->RetainCount != UINT16_MAX);
+        InterlockedIncrement16((volatile short*)&Packet->RetainCount);
+    }
+}
+
+//
+// Releases a reference taken by QuicPacketRetain (or the receive path's own
+// reference). The datagram is returned to the datapath on the last one.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+inline
+void
+QuicPacketRelease(
+    _Inout_ QUIC_RX_PACKET* Packet
+    )
+{
+    CXPLAT_DBG_ASSERT(Packet->RetainCount != 0);
+    if (InterlockedDecrement16((volatile short*)&Packet->RetainCount) == 0) {
+        CXPLAT_RECV_DATA* Datagram = (CXPLAT_RECV_DATA*)Packet;
+        Datagram->Next = NULL;
+        CxPlatRecvDataReturn(Datagram);
+    }
+}
+
+//
+// Returns a chain of packets the receive path is done with to the datapath,
+// except for the ones still retained, which are returned on their last
+// release instead.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicPacketReleaseChain(
+    _In_ QUIC_RX_PACKET* Packets
+    );
+
 //
 // Logs a packet header.
 //
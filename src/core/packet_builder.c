@@ -103,6 +103,8 @@ QuicPacketBuilderInitialize(
     Builder->PacketBatchRetransmittable = FALSE;
     Builder->WrittenConnectionCloseFrame = FALSE;
     Builder->Metadata = &Builder->MetadataStorage.Metadata;
+    Builder->Metadata->Frames = Builder->MetadataStorage.Frames;
+    Builder->Metadata->FramesInline = FALSE;
     Builder->EncryptionOverhead = CXPLAT_ENCRYPTION_OVERHEAD;
     Builder->TotalDatagramsLength = 0;
 
@@ -263,7 +265,10 @@ QuicPacketBuilderPrepare(
                     MaxUdpPayloadSizeForFamily(
                         QuicAddrGetFamily(&Builder->Path->Route.RemoteAddress),
                         DatagramSize),
-                Builder->EcnEctSet ? CXPLAT_ECN_ECT_0 : CXPLAT_ECN_NON_ECT,
+                !Builder->EcnEctSet ?
+                    CXPLAT_ECN_NON_ECT :
+                    Builder->Connection->CongestionControl.L4s ?
+                        CXPLAT_ECN_ECT_1 : CXPLAT_ECN_ECT_0,
                 Builder->Connection->Registration->ExecProfile == QUIC_EXECUTION_PROFILE_TYPE_MAX_THROUGHPUT ?
                     CXPLAT_SEND_FLAGS_MAX_THROUGHPUT : CXPLAT_SEND_FLAGS_NONE
             };
@@ -370,12 +375,12 @@ QuicPacketBuilderPrepare(
             Builder->EncryptionOverhead = 0;
         }
 
-        Builder->Metadata->PacketId =
+        Builder->PacketId =
             PartitionShifted | InterlockedIncrement64((int64_t*)&QuicLibraryGetPerProc()->SendPacketId);
         QuicTraceEvent(
             PacketCreated,
             "[pack][%llu] Created in batch %llu",
-            Builder->Metadata->PacketId,
+            Builder->PacketId,
             Builder->BatchId);
 
         Builder->Metadata->FrameCount = 0;
@@ -384,9 +389,6 @@ QuicPacketBuilderPrepare(
         Builder->Metadata->Flags.IsAckEliciting = FALSE;
         Builder->Metadata->Flags.IsMtuProbe = IsPathMtuDiscovery;
         Builder->Metadata->Flags.SuspectedLost = FALSE;
-#if DEBUG
-        Builder->Metadata->Flags.Freed = FALSE;
-#endif
 
         Builder->PacketStart = Builder->DatagramLength;
         Builder->HeaderLength = 0;
@@ -830,7 +832,7 @@ QuicPacketBuilderFinalize(
         QuicTraceEvent(
             PacketEncrypt,
             "[pack][%llu] Encrypting",
-            Builder->Metadata->PacketId);
+            Builder->PacketId);
 
         PayloadLength += Builder->EncryptionOverhead;
         Builder->DatagramLength += Builder->EncryptionOverhead;
@@ -857,7 +859,7 @@ QuicPacketBuilderFinalize(
         QuicTraceEvent(
             PacketFinalize,
             "[pack][%llu] Finalizing",
-            Builder->Metadata->PacketId);
+            Builder->PacketId);
 
         if (Connection->State.HeaderProtectionEnabled) {
 
@@ -951,7 +953,7 @@ QuicPacketBuilderFinalize(
         QuicTraceEvent(
             PacketFinalize,
             "[pack][%llu] Finalizing",
-            Builder->Metadata->PacketId);
+            Builder->PacketId);
     }
 
     //
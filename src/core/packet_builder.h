@@ -148,6 +148,11 @@ typedef struct QUIC_PACKET_BUILDER {
 
     uint64_t BatchId;
 
+    //
+    // Identifies the current QUIC packet in traces.
+    //
+    uint64_t PacketId;
+
     //
     // Represents the metadata of the current QUIC packet.
     //
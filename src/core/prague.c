@@ -0,0 +1,692 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    A scalable congestion controller for L4S (RFC 9331), based on DCTCP
+    (RFC 8257) and TCP Prague.
+
+    Packets are sent with ECT(1) so that a DualQ AQM places them in its low
+    latency queue, which marks CE at a very shallow queue depth. Instead of
+    treating CE like loss, the window is reduced once per round trip in
+    proportion to a moving average of the fraction of packets CE marked, which
+    keeps the queue near empty while the link stays fully utilized. Loss is
+    still treated as a classic congestion event, halving the window.
+
+--*/
+
+#include "precomp.h"
+#ifdef QUIC_CLOG
+#include "prague.c.clog.h"
+#endif
+
+#include "prague.h"
+
+//
+// Fixed point unit of Alpha, the moving average of the CE fraction.
+//
+#define PRAGUE_ALPHA_SHIFT 20
+#define PRAGUE_ALPHA_UNIT (1 << PRAGUE_ALPHA_SHIFT)
+
+//
+// The gain (g) of the moving average, as a right shift: 1/16 (RFC 8257).
+//
+#define PRAGUE_ALPHA_GAIN_SHIFT 4
+
+//
+// The CE ratio exposed in the statistics is in parts per million.
+//
+#define PRAGUE_CE_RATIO_UNIT 1000000
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+PragueCongestionControlCanSend(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Cc->Prague;
+    return Prague->BytesInFlight < Prague->CongestionWindow || Prague->Exemptions > 0;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+PragueCongestionControlSetExemption(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint8_t NumPackets
+    )
+{
+    Cc->Prague.Exemptions = NumPackets;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+PragueCongestionControlResetRound(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Cc->Prague;
+    Prague->AckedPacketsInRound = 0;
+    Prague->CePacketsInRound = 0;
+    Prague->RoundEnd = QuicCongestionControlGetConnection(Cc)->Send.NextPacketNumber;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+PragueCongestionControlReset(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ BOOLEAN FullReset
+    )
+{
+    QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Cc->Prague;
+
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    const uint16_t DatagramPayloadLength =
+        QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+    Prague->SlowStartThreshold = UINT32_MAX;
+    Prague->IsInRecovery = FALSE;
+    Prague->HasHadCongestionEvent = FALSE;
+    Prague->CongestionWindow = DatagramPayloadLength * Prague->InitialWindowPackets;
+    Prague->BytesInFlightMax = Prague->CongestionWindow / 2;
+    Prague->LastSendAllowance = 0;
+    Prague->AimdAccumulator = 0;
+    Prague->Alpha = PRAGUE_ALPHA_UNIT;
+    PragueCongestionControlResetRound(Cc);
+    if (FullReset) {
+        Prague->BytesInFlight = 0;
+    }
+
+    QuicConnLogOutFlowStats(Connection);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+PragueCongestionControlGetSendAllowance(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint64_t TimeSinceLastSend, // microsec
+    _In_ BOOLEAN TimeSinceLastSendValid
+    )
+{
+    QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Cc->Prague;
+
+    uint32_t SendAllowance;
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    if (Prague->BytesInFlight >= Prague->CongestionWindow) {
+        //
+        // We are CC blocked, so we can't send anything.
+        //
+        SendAllowance = 0;
+
+    } else if (
+        !TimeSinceLastSendValid ||
+        !Connection->Settings.PacingEnabled ||
+        !Connection->Paths[0].GotFirstRttSample ||
+        Connection->Paths[0].SmoothedRtt < QUIC_MIN_PACING_RTT) {
+        //
+        // We're not in the necessary state to pace.
+        //
+        SendAllowance = Prague->CongestionWindow - Prague->BytesInFlight;
+
+    } else {
+
+        //
+        // We are pacing, so split the congestion window into chunks which are
+        // spread out over the RTT. As with CUBIC, use the predicted window of
+        // the next round trip: double the current window in slow start, and
+        // 25% more in congestion avoidance.
+        //
+        uint64_t EstimatedWnd;
+        if (Prague->CongestionWindow < Prague->SlowStartThreshold) {
+            EstimatedWnd = (uint64_t)Prague->CongestionWindow << 1;
+            if (EstimatedWnd > Prague->SlowStartThreshold) {
+                EstimatedWnd = Prague->SlowStartThreshold;
+            }
+        } else {
+            EstimatedWnd = Prague->CongestionWindow + (Prague->CongestionWindow >> 2); // CongestionWindow * 1.25
+        }
+
+        SendAllowance =
+            Prague->LastSendAllowance +
+            (uint32_t)((EstimatedWnd * TimeSinceLastSend) / Connection->Paths[0].SmoothedRtt);
+        if (SendAllowance < Prague->LastSendAllowance || // Overflow case
+            SendAllowance > (Prague->CongestionWindow - Prague->BytesInFlight)) {
+            SendAllowance = Prague->CongestionWindow - Prague->BytesInFlight;
+        }
+
+        Prague->LastSendAllowance = SendAllowance;
+    }
+    return SendAllowance;
+}
+
+//
+// Returns TRUE if we became unblocked.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+PragueCongestionControlUpdateBlockedState(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ BOOLEAN PreviousCanSendState
+    )
+{
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    QuicConnLogOutFlowStats(Connection);
+    if (PreviousCanSendState != PragueCongestionControlCanSend(Cc)) {
+        if (PreviousCanSendState) {
+            QuicConnAddOutFlowBlockedReason(
+                Connection, QUIC_FLOW_BLOCKED_CONGESTION_CONTROL);
+        } else {
+            QuicConnRemoveOutFlowBlockedReason(
+                Connection, QUIC_FLOW_BLOCKED_CONGESTION_CONTROL);
+            Connection->Send.LastFlushTime = CxPlatTimeUs64(); // Reset last flush time
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+PragueCongestionControlOnCongestionEvent(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ BOOLEAN IsPersistentCongestion,
+    _In_ BOOLEAN Ecn
+    )
+{
+    QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Cc->Prague;
+
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    const uint32_t MinimumWindow =
+        (uint32_t)QuicPathGetDatagramPayloadSize(&Connection->Paths[0]) *
+        QUIC_PERSISTENT_CONGESTION_WINDOW_PACKETS;
+    QuicTraceEvent(
+        ConnCongestionV2,
+        "[conn][%p] Congestion event: IsEcn=%hu",
+        Connection,
+        Ecn);
+    Connection->Stats.Send.CongestionCount++;
+
+    Prague->IsInRecovery = TRUE;
+    Prague->HasHadCongestionEvent = TRUE;
+    Prague->AimdAccumulator = 0;
+
+    //
+    // If the congestion event is not triggered by ECN, save previous state,
+    // just in case this ends up being spurious.
+    //
+    if (!Ecn) {
+        Prague->PrevSlowStartThreshold = Prague->SlowStartThreshold;
+        Prague->PrevCongestionWindow = Prague->CongestionWindow;
+    }
+
+    if (IsPersistentCongestion && !Prague->IsInPersistentCongestion) {
+
+        QuicTraceEvent(
+            ConnPersistentCongestion,
+            "[conn][%p] Persistent congestion event",
+            Connection);
+        Connection->Stats.Send.PersistentCongestionCount++;
+
+        Connection->Paths[0].Route.State = RouteSuspected; // used only for RAW datapath
+
+        Prague->IsInPersistentCongestion = TRUE;
+        Prague->SlowStartThreshold =
+            CXPLAT_MAX(MinimumWindow, Prague->CongestionWindow / 2);
+        Prague->CongestionWindow = MinimumWindow;
+
+    } else if (Ecn) {
+
+        //
+        // Scalable response: cwnd = cwnd * (1 - Alpha / 2).
+        //
+        const uint32_t Reduction =
+            (uint32_t)(((uint64_t)Prague->CongestionWindow * Prague->Alpha) >>
+                (PRAGUE_ALPHA_SHIFT + 1));
+        Prague->SlowStartThreshold =
+        Prague->CongestionWindow =
+            CXPLAT_MAX(MinimumWindow, Prague->CongestionWindow - Reduction);
+
+    } else {
+
+        //
+        // Classic response to loss, as required of L4S senders.
+        //
+        Prague->SlowStartThreshold =
+        Prague->CongestionWindow =
+            CXPLAT_MAX(MinimumWindow, Prague->CongestionWindow / 2);
+    }
+}
+
+//
+// Called at the end of each round trip to fold the round's CE fraction into
+// the moving average.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+PragueCongestionControlUpdateAlpha(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Cc->Prague;
+
+    if (Prague->AckedPacketsInRound > 0) {
+        QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+        const uint64_t CePackets =
+            CXPLAT_MIN(Prague->CePacketsInRound, Prague->AckedPacketsInRound);
+
+        const uint32_t Fraction =
+            (uint32_t)((CePackets << PRAGUE_ALPHA_SHIFT) / Prague->AckedPacketsInRound);
+        Prague->Alpha =
+            Prague->Alpha -
+            (Prague->Alpha >> PRAGUE_ALPHA_GAIN_SHIFT) +
+            (Fraction >> PRAGUE_ALPHA_GAIN_SHIFT);
+
+        //
+        // Alpha starts at 1 so the first reduction is conservative. The ratio
+        // reported in the statistics uses the same gain, but starts from the
+        // first sample.
+        //
+        const uint32_t Ratio =
+            (uint32_t)(CePackets * PRAGUE_CE_RATIO_UNIT / Prague->AckedPacketsInRound);
+        if (Connection->Stats.Send.EcnCeRatio == 0) {
+            Connection->Stats.Send.EcnCeRatio = Ratio;
+        } else {
+            Connection->Stats.Send.EcnCeRatio =
+                Connection->Stats.Send.EcnCeRatio -
+                (Connection->Stats.Send.EcnCeRatio >> PRAGUE_ALPHA_GAIN_SHIFT) +
+                (Ratio >> PRAGUE_ALPHA_GAIN_SHIFT);
+        }
+    }
+
+    PragueCongestionControlResetRound(Cc);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+PragueCongestionControlOnDataSent(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t NumRetransmittableBytes
+    )
+{
+    QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Cc->Prague;
+
+    BOOLEAN PreviousCanSendState = QuicCongestionControlCanSend(Cc);
+
+    Prague->BytesInFlight += NumRetransmittableBytes;
+    if (Prague->BytesInFlightMax < Prague->BytesInFlight) {
+        Prague->BytesInFlightMax = Prague->BytesInFlight;
+        QuicSendBufferConnectionAdjust(QuicCongestionControlGetConnection(Cc));
+    }
+
+    if (NumRetransmittableBytes > Prague->LastSendAllowance) {
+        Prague->LastSendAllowance = 0;
+    } else {
+        Prague->LastSendAllowance -= NumRetransmittableBytes;
+    }
+
+    if (Prague->Exemptions > 0) {
+        --Prague->Exemptions;
+    }
+
+    PragueCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+PragueCongestionControlOnDataInvalidated(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ uint32_t NumRetransmittableBytes
+    )
+{
+    QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Cc->Prague;
+
+    BOOLEAN PreviousCanSendState = PragueCongestionControlCanSend(Cc);
+
+    CXPLAT_DBG_ASSERT(Prague->BytesInFlight >= NumRetransmittableBytes);
+    Prague->BytesInFlight -= NumRetransmittableBytes;
+
+    return PragueCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+PragueCongestionControlOnDataAcknowledged(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_ACK_EVENT* AckEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Cc->Prague;
+
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    BOOLEAN PreviousCanSendState = PragueCongestionControlCanSend(Cc);
+    uint32_t BytesAcked = AckEvent->NumRetransmittableBytes;
+
+    CXPLAT_DBG_ASSERT(Prague->BytesInFlight >= BytesAcked);
+    Prague->BytesInFlight -= BytesAcked;
+
+    //
+    // The CE fraction is relative to the packets sent with ECT, which are the
+    // ones the peer's ECN counts cover.
+    //
+    for (const QUIC_SENT_PACKET_METADATA* AckedPacket = AckEvent->AckedPackets;
+         AckedPacket != NULL;
+         AckedPacket = AckedPacket->Next) {
+        Prague->AckedPacketsInRound += AckedPacket->Flags.EcnEctSet;
+    }
+
+    if (AckEvent->LargestAck >= Prague->RoundEnd) {
+        PragueCongestionControlUpdateAlpha(Cc);
+    }
+
+    if (Prague->IsInRecovery) {
+        if (AckEvent->LargestAck > Prague->RecoverySentPacketNumber) {
+            //
+            // Done recovering. As with CUBIC, we simply require an ACK for a
+            // packet sent after recovery started.
+            //
+            QuicTraceEvent(
+                ConnRecoveryExit,
+                "[conn][%p] Recovery complete",
+                Connection);
+            Prague->IsInRecovery = FALSE;
+            Prague->IsInPersistentCongestion = FALSE;
+        }
+        goto Exit;
+    } else if (BytesAcked == 0) {
+        goto Exit;
+    }
+
+    if (Prague->CongestionWindow < Prague->SlowStartThreshold) {
+
+        //
+        // Slow Start
+        //
+
+        Prague->CongestionWindow += BytesAcked;
+        BytesAcked = 0;
+        if (Prague->CongestionWindow >= Prague->SlowStartThreshold) {
+            //
+            // Treat the bytes acknowledged beyond SlowStartThreshold as if they
+            // were acknowledged during Congestion Avoidance below.
+            //
+            BytesAcked = Prague->CongestionWindow - Prague->SlowStartThreshold;
+            Prague->CongestionWindow = Prague->SlowStartThreshold;
+        }
+    }
+
+    //
+    // As with CUBIC, we require steady ACK feedback to justify window growth.
+    // The bytes acknowledged after a long time gap between ACKs don't count
+    // towards growing the window in Congestion Avoidance.
+    //
+    if (BytesAcked > 0 && Prague->TimeOfLastAckValid) {
+        const uint64_t TimeSinceLastAck =
+            CxPlatTimeDiff64(Prague->TimeOfLastAck, AckEvent->TimeNow);
+        if (TimeSinceLastAck > MS_TO_US((uint64_t)Prague->SendIdleTimeoutMs) &&
+            TimeSinceLastAck > (Connection->Paths[0].SmoothedRtt + 4 * Connection->Paths[0].RttVariance)) {
+            BytesAcked = 0;
+        }
+    }
+
+    if (BytesAcked > 0) {
+
+        //
+        // Congestion Avoidance: grow by one datagram per window acknowledged
+        // (RFC 3465), which combined with the once per round trip reduction
+        // keeps the number of CE marks per round trip roughly constant.
+        //
+        Prague->AimdAccumulator += BytesAcked;
+        if (Prague->AimdAccumulator >= Prague->CongestionWindow) {
+            Prague->AimdAccumulator -= Prague->CongestionWindow;
+            Prague->CongestionWindow +=
+                QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+        }
+    }
+
+    //
+    // Limit the growth of the window based on the number of bytes we
+    // actually manage to put on the wire. See CUBIC for details.
+    //
+    if (Prague->CongestionWindow > 2 * Prague->BytesInFlightMax) {
+        Prague->CongestionWindow = 2 * Prague->BytesInFlightMax;
+    }
+
+Exit:
+
+    Prague->TimeOfLastAck = AckEvent->TimeNow;
+    Prague->TimeOfLastAckValid = TRUE;
+
+    if (Connection->Settings.NetStatsEventEnabled) {
+        const QUIC_PATH* Path = &Connection->Paths[0];
+        QUIC_CONNECTION_EVENT Event;
+        Event.Type = QUIC_CONNECTION_EVENT_NETWORK_STATISTICS;
+        Event.NETWORK_STATISTICS.BytesInFlight = Prague->BytesInFlight;
+        Event.NETWORK_STATISTICS.PostedBytes = Connection->SendBuffer.PostedBytes;
+        Event.NETWORK_STATISTICS.IdealBytes = Connection->SendBuffer.IdealBytes;
+        Event.NETWORK_STATISTICS.SmoothedRTT = Path->SmoothedRtt;
+        Event.NETWORK_STATISTICS.CongestionWindow = Prague->CongestionWindow;
+        Event.NETWORK_STATISTICS.Bandwidth = Prague->CongestionWindow / Path->SmoothedRtt;
+
+        QuicTraceLogConnVerbose(
+           IndicateDataAcked,
+           Connection,
+           "Indicating QUIC_CONNECTION_EVENT_NETWORK_STATISTICS [BytesInFlight=%u,PostedBytes=%llu,IdealBytes=%llu,SmoothedRTT=%llu,CongestionWindow=%u,Bandwidth=%llu]",
+           Event.NETWORK_STATISTICS.BytesInFlight,
+           Event.NETWORK_STATISTICS.PostedBytes,
+           Event.NETWORK_STATISTICS.IdealBytes,
+           Event.NETWORK_STATISTICS.SmoothedRTT,
+           Event.NETWORK_STATISTICS.CongestionWindow,
+           Event.NETWORK_STATISTICS.Bandwidth);
+       QuicConnIndicateEvent(Connection, &Event);
+    }
+
+    return PragueCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+PragueCongestionControlOnDataLost(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_LOSS_EVENT* LossEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Cc->Prague;
+
+    BOOLEAN PreviousCanSendState = PragueCongestionControlCanSend(Cc);
+
+    //
+    // If data is lost after the most recent congestion event (or if there
+    // hasn't been a congestion event yet) then treat this loss as a new
+    // congestion event.
+    //
+    if (!Prague->HasHadCongestionEvent ||
+        LossEvent->LargestPacketNumberLost > Prague->RecoverySentPacketNumber) {
+
+        Prague->RecoverySentPacketNumber = LossEvent->LargestSentPacketNumber;
+        PragueCongestionControlOnCongestionEvent(
+            Cc,
+            LossEvent->PersistentCongestion,
+            FALSE);
+    }
+
+    CXPLAT_DBG_ASSERT(Prague->BytesInFlight >= LossEvent->NumRetransmittableBytes);
+    Prague->BytesInFlight -= LossEvent->NumRetransmittableBytes;
+
+    PragueCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+PragueCongestionControlOnEcn(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_ECN_EVENT* EcnEvent
+    )
+{
+    QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Cc->Prague;
+
+    BOOLEAN PreviousCanSendState = PragueCongestionControlCanSend(Cc);
+
+    Prague->CePacketsInRound += EcnEvent->NewCeCount;
+
+    //
+    // Reduce the window at most once per round trip, by the CE fraction
+    // averaged over the previous round trips.
+    //
+    if (!Prague->HasHadCongestionEvent ||
+        EcnEvent->LargestPacketNumberAcked > Prague->RecoverySentPacketNumber) {
+
+        Prague->RecoverySentPacketNumber = EcnEvent->LargestSentPacketNumber;
+        QuicCongestionControlGetConnection(Cc)->Stats.Send.EcnCongestionCount++;
+        PragueCongestionControlOnCongestionEvent(
+            Cc,
+            FALSE,
+            TRUE);
+    }
+
+    PragueCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+PragueCongestionControlOnSpuriousCongestionEvent(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Cc->Prague;
+
+    if (!Prague->IsInRecovery) {
+        return FALSE;
+    }
+
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    BOOLEAN PreviousCanSendState = QuicCongestionControlCanSend(Cc);
+
+    QuicTraceEvent(
+        ConnSpuriousCongestion,
+        "[conn][%p] Spurious congestion event",
+        Connection);
+
+    //
+    // Revert to previous state.
+    //
+    Prague->SlowStartThreshold = Prague->PrevSlowStartThreshold;
+    Prague->CongestionWindow = Prague->PrevCongestionWindow;
+
+    Prague->IsInRecovery = FALSE;
+    Prague->HasHadCongestionEvent = FALSE;
+
+    return PragueCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+void
+PragueCongestionControlLogOutFlowStatus(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    const QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    const QUIC_PATH* Path = &Connection->Paths[0];
+    const QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Cc->Prague;
+
+    QuicTraceEvent(
+        ConnOutFlowStatsV2,
+        "[conn][%p] OUT: BytesSent=%llu InFlight=%u CWnd=%u ConnFC=%llu ISB=%llu PostedBytes=%llu SRtt=%llu 1Way=%llu",
+        Connection,
+        Connection->Stats.Send.TotalBytes,
+        Prague->BytesInFlight,
+        Prague->CongestionWindow,
+        Connection->Send.PeerMaxData - Connection->Send.OrderedStreamBytesSent,
+        Connection->SendBuffer.IdealBytes,
+        Connection->SendBuffer.PostedBytes,
+        Path->GotFirstRttSample ? Path->SmoothedRtt : 0,
+        Path->OneWayDelay);
+}
+
+uint32_t
+PragueCongestionControlGetBytesInFlightMax(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->Prague.BytesInFlightMax;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint8_t
+PragueCongestionControlGetExemptions(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->Prague.Exemptions;
+}
+
+uint32_t
+PragueCongestionControlGetCongestionWindow(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->Prague.CongestionWindow;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+PragueCongestionControlIsAppLimited(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    UNREFERENCED_PARAMETER(Cc);
+    return FALSE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+PragueCongestionControlSetAppLimited(
+    _In_ struct QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    UNREFERENCED_PARAMETER(Cc);
+}
+
+static const QUIC_CONGESTION_CONTROL QuicCongestionControlPrague = {
+    .Name = "Prague",
+    .L4s = TRUE,
+    .QuicCongestionControlCanSend = PragueCongestionControlCanSend,
+    .QuicCongestionControlSetExemption = PragueCongestionControlSetExemption,
+    .QuicCongestionControlReset = PragueCongestionControlReset,
+    .QuicCongestionControlGetSendAllowance = PragueCongestionControlGetSendAllowance,
+    .QuicCongestionControlOnDataSent = PragueCongestionControlOnDataSent,
+    .QuicCongestionControlOnDataInvalidated = PragueCongestionControlOnDataInvalidated,
+    .QuicCongestionControlOnDataAcknowledged = PragueCongestionControlOnDataAcknowledged,
+    .QuicCongestionControlOnDataLost = PragueCongestionControlOnDataLost,
+    .QuicCongestionControlOnEcn = PragueCongestionControlOnEcn,
+    .QuicCongestionControlOnSpuriousCongestionEvent = PragueCongestionControlOnSpuriousCongestionEvent,
+    .QuicCongestionControlLogOutFlowStatus = PragueCongestionControlLogOutFlowStatus,
+    .QuicCongestionControlGetExemptions = PragueCongestionControlGetExemptions,
+    .QuicCongestionControlGetBytesInFlightMax = PragueCongestionControlGetBytesInFlightMax,
+    .QuicCongestionControlIsAppLimited = PragueCongestionControlIsAppLimited,
+    .QuicCongestionControlSetAppLimited = PragueCongestionControlSetAppLimited,
+    .QuicCongestionControlGetCongestionWindow = PragueCongestionControlGetCongestionWindow,
+};
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+PragueCongestionControlInitialize(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_SETTINGS_INTERNAL* Settings
+    )
+{
+    *Cc = QuicCongestionControlPrague;
+
+    QUIC_CONGESTION_CONTROL_PRAGUE* Prague = &Cc->Prague;
+
+    QUIC_CONNECTION* Connection = QuicCongestionControlGetConnection(Cc);
+    const uint16_t DatagramPayloadLength =
+        QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+    Prague->SlowStartThreshold = UINT32_MAX;
+    Prague->SendIdleTimeoutMs = Settings->SendIdleTimeoutMs;
+    Prague->InitialWindowPackets = Settings->InitialWindowPackets;
+    Prague->CongestionWindow = DatagramPayloadLength * Prague->InitialWindowPackets;
+    Prague->BytesInFlightMax = Prague->CongestionWindow / 2;
+    Prague->Alpha = PRAGUE_ALPHA_UNIT;
+    PragueCongestionControlResetRound(Cc);
+
+    QuicConnLogOutFlowStats(Connection);
+}
@@ -0,0 +1,98 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+--*/
+
+#pragma once
+
+typedef struct QUIC_CONGESTION_CONTROL_PRAGUE {
+
+    //
+    // TRUE if we have had at least one congestion event.
+    // If TRUE, RecoverySentPacketNumber is valid.
+    //
+    BOOLEAN HasHadCongestionEvent : 1;
+
+    //
+    // This flag indicates a congestion event occurred and CC is attempting
+    // to recover from it.
+    //
+    BOOLEAN IsInRecovery : 1;
+
+    //
+    // This flag indicates a persistent congestion event occurred and CC is
+    // attempting to recover from it.
+    //
+    BOOLEAN IsInPersistentCongestion : 1;
+
+    //
+    // TRUE if there has been at least one ACK.
+    //
+    BOOLEAN TimeOfLastAckValid : 1;
+
+    //
+    // The size of the initial congestion window, in packets.
+    //
+    uint32_t InitialWindowPackets;
+
+    //
+    // Minimum time without any sends before the congestion window is reset.
+    //
+    uint32_t SendIdleTimeoutMs;
+
+    uint32_t CongestionWindow; // bytes
+    uint32_t PrevCongestionWindow; // bytes
+    uint32_t SlowStartThreshold; // bytes
+    uint32_t PrevSlowStartThreshold; // bytes
+    uint32_t AimdAccumulator; // bytes
+
+    //
+    // The number of bytes considered to be still in the network.
+    //
+    uint32_t BytesInFlight;
+    uint32_t BytesInFlightMax;
+
+    //
+    // The leftover send allowance from a previous send. Only used when pacing.
+    //
+    uint32_t LastSendAllowance; // bytes
+
+    //
+    // A count of packets which can be sent ignoring CongestionWindow.
+    //
+    uint8_t Exemptions;
+
+    uint64_t TimeOfLastAck; // microseconds
+
+    //
+    // Moving average of the fraction of packets CE marked per round trip, in
+    // units of PRAGUE_ALPHA_UNIT. The window is reduced by Alpha / 2 when CE
+    // marks are reported.
+    //
+    uint32_t Alpha;
+
+    //
+    // The packets acknowledged, and reported as CE marked, since the round
+    // trip ending with the acknowledgement of RoundEnd started.
+    //
+    uint64_t AckedPacketsInRound;
+    uint64_t CePacketsInRound;
+    uint64_t RoundEnd; // Packet Number
+
+    //
+    // This variable tracks the largest packet that was outstanding at the time
+    // the last congestion event occurred. An ACK for any packet number greater
+    // than this indicates recovery is over.
+    //
+    uint64_t RecoverySentPacketNumber;
+
+} QUIC_CONGESTION_CONTROL_PRAGUE;
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+PragueCongestionControlInitialize(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_SETTINGS_INTERNAL* Settings
+    );
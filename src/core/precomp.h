@@ -56,6 +56,7 @@
 #include "registration.h"
 #include "configuration.h"
 #include "range.h"
+#include "var_int.h"
 #include "recv_buffer.h"
 #include "send_buffer.h"
 #include "frame.h"
@@ -77,4 +78,8 @@
 #include "listener.h"
 #include "cubic.h"
 #include "bbr.h"
+#include "bbr3.h"
+#include "prague.h"
+#include "ledbat.h"
+#include "app_congestion_control.h"
 #include "sliding_window_extremum.h"
@@ -165,6 +165,20 @@ typedef struct QUIC_RX_PACKET QUIC_RX_PACKET;
 //
 #define QUIC_STATELESS_OPERATION_EXPIRATION_MS  100
 
+//
+// The rate (per second) and burst of stateless responses each processor may
+// send inline from the receive path.
+//
+#define QUIC_STATELESS_RESPONSE_RATE            8192
+#define QUIC_STATELESS_RESPONSE_BURST           256
+
+//
+// The number of recent remote addresses each processor remembers, so an
+// address gets at most one inline stateless response per stateless operation
+// expiration period. Must be a power of 2.
+//
+#define QUIC_STATELESS_RESPONSE_FILTER_SIZE     64
+
 //
 // The maximum number of operations a connection will drain from its queue per
 // call to QuicConnDrainOperations.
@@ -184,6 +198,13 @@ typedef struct QUIC_RX_PACKET QUIC_RX_PACKET;
 //
 #define QUIC_STREAM_SEND_BATCH_COUNT            8
 
+//
+// The number of stream frame bytes an incremental stream is credited with each
+// deficit round robin turn under the extensible priority scheduling scheme.
+// Must be larger than a full sized packet so every turn makes progress.
+//
+#define QUIC_STREAM_SEND_QUANTUM                8192
+
 //
 // The maximum number of received packets to batch process at a time.
 //
@@ -328,6 +349,12 @@ CXPLAT_STATIC_ASSERT(
 //
 #define QUIC_RECV_BUFFER_DRAIN_RATIO            4
 
+//
+// The maximum number of buffers indicated in a single stream receive event.
+// App-owned and zero copy receive buffers use (at least) one buffer per chunk.
+//
+#define QUIC_MAX_RECEIVE_INDICATION_BUFFERS     16
+
 //
 // The default value for send buffering being enabled or not.
 //
@@ -532,6 +559,11 @@ CXPLAT_STATIC_ASSERT(
 //
 #define QUIC_DEFAULT_STREAM_MULTI_RECEIVE_ENABLED    FALSE
 
+//
+// The default settings for retaining datapath receive buffers for stream data.
+//
+#define QUIC_DEFAULT_STREAM_ZERO_COPY_RECEIVE_ENABLED FALSE
+
 //
 // The number of rounds in Cubic Slow Start to sample RTT.
 //
@@ -639,6 +671,7 @@ CXPLAT_STATIC_ASSERT(
 #define QUIC_SETTING_ONE_WAY_DELAY_ENABLED          "OneWayDelayEnabled"
 #define QUIC_SETTING_NET_STATS_EVENT_ENABLED        "NetStatsEventEnabled"
 #define QUIC_SETTING_STREAM_MULTI_RECEIVE_ENABLED   "StreamMultiReceiveEnabled"
+#define QUIC_SETTING_STREAM_ZERO_COPY_RECEIVE_ENABLED "StreamZeroCopyReceiveEnabled"
 
 #define QUIC_SETTING_INITIAL_WINDOW_PACKETS         "InitialWindowPackets"
 #define QUIC_SETTING_SEND_IDLE_TIMEOUT_MS           "SendIdleTimeoutMs"
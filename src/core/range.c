@@ -118,6 +118,57 @@ QuicRangeGrow(
     return TRUE;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Success_(return != FALSE)
+BOOLEAN
+QuicRangeReserve(
+    _Inout_ QUIC_RANGE* Range,
+    _In_ uint32_t Count
+    )
+{
+    if (Count <= Range->AllocLength) {
+        return TRUE;
+    }
+
+    if (Count > QUIC_MAX_RANGE_ALLOC_SIZE) {
+        return FALSE;
+    }
+
+    uint32_t NewAllocLength = Range->AllocLength << 1;
+    while (NewAllocLength < Count) {
+        NewAllocLength <<= 1;
+    }
+    if ((uint64_t)NewAllocLength * sizeof(QUIC_SUBRANGE) > Range->MaxAllocSize) {
+        return FALSE;
+    }
+    uint32_t NewAllocSize = NewAllocLength * sizeof(QUIC_SUBRANGE);
+
+    QUIC_SUBRANGE* NewSubRanges = CXPLAT_ALLOC_NONPAGED(NewAllocSize, QUIC_POOL_RANGE);
+    if (NewSubRanges == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "range (reserve)",
+            NewAllocSize);
+        return FALSE;
+    }
+
+    if (Range->UsedLength != 0) {
+        memcpy(
+            NewSubRanges,
+            Range->SubRanges,
+            Range->UsedLength * sizeof(QUIC_SUBRANGE));
+    }
+
+    if (Range->AllocLength != QUIC_RANGE_INITIAL_SUB_COUNT) {
+        CXPLAT_FREE(Range->SubRanges, QUIC_POOL_RANGE);
+    }
+    Range->SubRanges = NewSubRanges;
+    Range->AllocLength = NewAllocLength;
+
+    return TRUE;
+}
+
 //
 // Reads the array for inserting a new subrange at the given index.
 //
@@ -245,6 +296,62 @@ QuicRangeGetRange(
     return TRUE;
 }
 
+//
+// Returns the index of the first subrange ending at or after Low - 1, i.e. the
+// first one that a new range starting at Low would overlap or be adjacent to,
+// or UsedLength if there is none.
+//
+#if QUIC_RANGE_USE_BINARY_SEARCH
+
+//
+// O(log(n))
+//
+static
+uint32_t
+QuicRangeSearchFirstMergeable(
+    _In_ const QUIC_RANGE* Range,
+    _In_ uint64_t Low
+    )
+{
+    uint32_t Lo = 0;
+    uint32_t Hi = Range->UsedLength;
+    while (Lo < Hi) {
+        uint32_t Mid = Lo + (Hi - Lo) / 2;
+        const QUIC_SUBRANGE* Sub = QuicRangeGet(Range, Mid);
+        if (Sub->Low + Sub->Count < Low) {
+            Lo = Mid + 1;
+        } else {
+            Hi = Mid;
+        }
+    }
+    return Lo;
+}
+
+#else
+
+//
+// O(n)
+//
+static
+uint32_t
+QuicRangeSearchFirstMergeable(
+    _In_ const QUIC_RANGE* Range,
+    _In_ uint64_t Low
+    )
+{
+    uint32_t i = Range->UsedLength;
+    while (i > 0) {
+        const QUIC_SUBRANGE* Sub = QuicRangeGet(Range, i - 1);
+        if (Sub->Low + Sub->Count < Low) {
+            break;
+        }
+        i--;
+    }
+    return i;
+}
+
+#endif
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 _Success_(return != NULL)
 QUIC_SUBRANGE*
@@ -258,7 +365,6 @@ QuicRangeAddRange(
 {
     uint32_t i;
     QUIC_SUBRANGE* Sub;
-    QUIC_RANGE_SEARCH_KEY Key = { Low, Low + Count - 1 };
 
     *RangeUpdated = FALSE;
 
@@ -270,33 +376,8 @@ QuicRangeAddRange(
         // The new range is somewhere before the end of the of the last subrange
         // so we must search for the first overlapping or adjacent subrange.
         //
-        int result = QuicRangeSearch(Range, &Key);
-        if (IS_FIND_INDEX(result)) {
-            //
-            // We found 'an' overlapping subrange. We need to ensure this is the
-            // first overlapping range.
-            //
-            i = (uint32_t)result;
-            while ((Sub = QuicRangeGetSafe(Range, i - 1)) != NULL &&
-                    QuicRangeCompare(&Key, Sub) == 0) {
-                --i;
-            }
-        } else {
-            //
-            // No overlapping range was found, so the index of the insert was
-            // returned.
-            i = INSERT_INDEX_TO_FIND_INDEX(result);
-        }
-        //
-        // Make sure the previous subrange isn't 1 less than the current Low.
-        // If so, start with that subrange.
-        //
-        if ((Sub = QuicRangeGetSafe(Range, i - 1)) != NULL &&
-            Sub->Low + Sub->Count == Low) {
-            i--;
-        } else {
-            Sub = QuicRangeGetSafe(Range, i);
-        }
+        i = QuicRangeSearchFirstMergeable(Range, Low);
+        Sub = QuicRangeGetSafe(Range, i);
 #if QUIC_RANGE_USE_BINARY_SEARCH
     } else if (Sub == NULL) {
         //
@@ -250,6 +250,19 @@ QuicRangeReset(
     _Inout_ QUIC_RANGE* Range
     );
 
+//
+// Grows the subrange array, if necessary, so that it can hold at least Count
+// subranges without reallocating. Returns FALSE if the range isn't allowed to
+// grow that large or the allocation fails.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Success_(return != FALSE)
+BOOLEAN
+QuicRangeReserve(
+    _Inout_ QUIC_RANGE* Range,
+    _In_ uint32_t Count
+    );
+
 //
 // O(n)      when QUIC_RANGE_USE_BINARY_SEARCH == 0
 // O(log(n)) when QUIC_RANGE_USE_BINARY_SEARCH == 1
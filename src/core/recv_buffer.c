@@ -40,6 +40,21 @@ Abstract:
 
     Currently, only growing the virtual buffer length is supported.
 
+    In app-owned mode, the buffer never allocates or copies data between chunks
+    itself. Instead, the app provides its own buffers which are used, in order,
+    as a linear list of chunks. Data is written directly into them and is
+    indicated back to the app in place. The virtual buffer length is then the
+    amount of app provided space left after BaseOffset, and a chunk is released
+    (back to the app) once it has been completely drained.
+
+    Zero copy mode uses the same linear list of chunks, but they are created as
+    data is written. New data that directly follows the existing chunks (i.e.
+    generally in-order data) is kept in place, in the decrypted datagram it was
+    received in, by retaining the packet. Anything else is copied into newly
+    allocated chunks. The retained datagrams are returned to the datapath once
+    their data is drained. The virtual buffer length still only controls flow
+    control, like in the other (internally allocated) modes.
+
 --*/
 
 #include "precomp.h"
@@ -59,15 +74,33 @@ QuicRecvBufferInitialize(
 {
     QUIC_STATUS Status;
 
-    CXPLAT_DBG_ASSERT(AllocBufferLength != 0 && (AllocBufferLength & (AllocBufferLength - 1)) == 0);       // Power of 2
-    CXPLAT_DBG_ASSERT(VirtualBufferLength != 0 && (VirtualBufferLength & (VirtualBufferLength - 1)) == 0); // Power of 2
-    CXPLAT_DBG_ASSERT(AllocBufferLength <= VirtualBufferLength);
-
     QUIC_RECV_CHUNK* Chunk = NULL;
-    if (PreallocatedChunk != NULL) {
+    if (RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED) {
+        //
+        // All the buffer space is provided by the app, later on.
+        //
+        CXPLAT_DBG_ASSERT(PreallocatedChunk == NULL);
+        RecvBuffer->PreallocatedChunk = NULL;
+        AllocBufferLength = 0;
+        VirtualBufferLength = 0;
+    } else if (RecvMode == QUIC_RECV_BUF_MODE_ZERO_COPY) {
+        //
+        // Chunks are only created as data is written.
+        //
+        CXPLAT_DBG_ASSERT(PreallocatedChunk == NULL);
+        CXPLAT_DBG_ASSERT(VirtualBufferLength != 0);
+        RecvBuffer->PreallocatedChunk = NULL;
+        AllocBufferLength = 0;
+    } else if (PreallocatedChunk != NULL) {
+        CXPLAT_DBG_ASSERT(AllocBufferLength != 0 && (AllocBufferLength & (AllocBufferLength - 1)) == 0);       // Power of 2
+        CXPLAT_DBG_ASSERT(VirtualBufferLength != 0 && (VirtualBufferLength & (VirtualBufferLength - 1)) == 0); // Power of 2
+        CXPLAT_DBG_ASSERT(AllocBufferLength <= VirtualBufferLength);
         RecvBuffer->PreallocatedChunk = PreallocatedChunk;
         Chunk = PreallocatedChunk;
     } else {
+        CXPLAT_DBG_ASSERT(AllocBufferLength != 0 && (AllocBufferLength & (AllocBufferLength - 1)) == 0);       // Power of 2
+        CXPLAT_DBG_ASSERT(VirtualBufferLength != 0 && (VirtualBufferLength & (VirtualBufferLength - 1)) == 0); // Power of 2
+        CXPLAT_DBG_ASSERT(AllocBufferLength <= VirtualBufferLength);
         RecvBuffer->PreallocatedChunk = NULL;
         Chunk = CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_RECV_CHUNK) + AllocBufferLength, QUIC_POOL_RECVBUF);
         if (Chunk == NULL) {
@@ -83,9 +116,10 @@ QuicRecvBufferInitialize(
 
     QuicRangeInitialize(QUIC_MAX_RANGE_ALLOC_SIZE, &RecvBuffer->WrittenRanges);
     CxPlatListInitializeHead(&RecvBuffer->Chunks);
-    CxPlatListInsertHead(&RecvBuffer->Chunks, &Chunk->Link);
-    Chunk->AllocLength = AllocBufferLength;
-    Chunk->ExternalReference = FALSE;
+    if (Chunk != NULL) {
+        QuicRecvChunkInitialize(Chunk, AllocBufferLength, NULL);
+        CxPlatListInsertHead(&RecvBuffer->Chunks, &Chunk->Link);
+    }
     RecvBuffer->BaseOffset = 0;
     RecvBuffer->ReadStart = 0;
     RecvBuffer->ReadPendingLength = 0;
@@ -100,6 +134,36 @@ Error:
     return Status;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicRecvBufferProvideChunks(
+    _Inout_ QUIC_RECV_BUFFER* RecvBuffer,
+    _Inout_ CXPLAT_LIST_ENTRY* Chunks
+    )
+{
+    CXPLAT_DBG_ASSERT(RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED);
+    CXPLAT_DBG_ASSERT(!CxPlatListIsEmpty(Chunks));
+
+    uint64_t NewBufferLength = RecvBuffer->VirtualBufferLength;
+    for (CXPLAT_LIST_ENTRY* Link = Chunks->Flink;
+        Link != Chunks;
+        Link = Link->Flink) {
+        NewBufferLength +=
+            CXPLAT_CONTAINING_RECORD(Link, QUIC_RECV_CHUNK, Link)->AllocLength;
+    }
+    if (NewBufferLength > UINT32_MAX) {
+        //
+        // The (outstanding) buffer space must fit in the virtual buffer length.
+        //
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+
+    RecvBuffer->VirtualBufferLength = (uint32_t)NewBufferLength;
+    CxPlatListMoveItems(Chunks, &RecvBuffer->Chunks);
+
+    return QUIC_STATUS_SUCCESS;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicRecvBufferUninitialize(
@@ -113,6 +177,9 @@ QuicRecvBufferUninitialize(
                 CxPlatListRemoveHead(&RecvBuffer->Chunks),
                 QUIC_RECV_CHUNK,
                 Link);
+        if (Chunk->Packet != NULL) {
+            QuicPacketRelease(Chunk->Packet);
+        }
         if (Chunk != RecvBuffer->PreallocatedChunk) {
             CXPLAT_FREE(Chunk, QUIC_POOL_RECVBUF);
         }
@@ -171,6 +238,7 @@ QuicRecvBufferIncreaseVirtualBufferLength(
     )
 {
     CXPLAT_DBG_ASSERT(NewLength >= RecvBuffer->VirtualBufferLength); // Don't support decrease.
+    CXPLAT_DBG_ASSERT(RecvBuffer->RecvMode != QUIC_RECV_BUF_MODE_APP_OWNED); // Only the app adds space.
     RecvBuffer->VirtualBufferLength = NewLength;
 }
 
@@ -209,8 +277,7 @@ QuicRecvBufferResize(
         return FALSE;
     }
 
-    NewChunk->AllocLength = TargetBufferLength;
-    NewChunk->ExternalReference = FALSE;
+    QuicRecvChunkInitialize(NewChunk, TargetBufferLength, NULL);
     CxPlatListInsertTail(&RecvBuffer->Chunks, &NewChunk->Link);
 
     if (!LastChunk->ExternalReference) {
@@ -357,6 +424,56 @@ QuicRecvBufferGetTotalAllocLength(
     return AllocLength;
 }
 
+//
+// Extends the chunk space in zero copy mode to cover the write. If the write
+// reaches back to the current end of the chunk space, the new bytes are used
+// in place by retaining the packet. Otherwise, a new chunk is allocated for
+// them (and the gap before them).
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicRecvBufferAppendChunk(
+    _In_ QUIC_RECV_BUFFER* RecvBuffer,
+    _In_ uint64_t WriteOffset,
+    _In_ uint16_t WriteLength,
+    _In_reads_bytes_(WriteLength)
+        uint8_t const* WriteBuffer,
+    _In_opt_ QUIC_RX_PACKET* Packet
+    )
+{
+    CXPLAT_DBG_ASSERT(RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_ZERO_COPY);
+    const uint64_t ChunkEnd = RecvBuffer->BaseOffset + RecvBuffer->Capacity;
+    CXPLAT_DBG_ASSERT(WriteOffset + WriteLength > ChunkEnd);
+    const uint32_t Length = (uint32_t)(WriteOffset + WriteLength - ChunkEnd);
+    const BOOLEAN InPlace = Packet != NULL && WriteOffset <= ChunkEnd;
+
+    const size_t AllocLength = sizeof(QUIC_RECV_CHUNK) + (InPlace ? 0 : Length);
+    QUIC_RECV_CHUNK* Chunk = CXPLAT_ALLOC_NONPAGED(AllocLength, QUIC_POOL_RECVBUF);
+    if (Chunk == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "recv_buffer",
+            AllocLength);
+        return FALSE;
+    }
+
+    if (InPlace) {
+        QuicRecvChunkInitialize(
+            Chunk,
+            Length,
+            (uint8_t*)WriteBuffer + (ChunkEnd - WriteOffset));
+        Chunk->Packet = Packet;
+        QuicPacketRetain(Packet);
+    } else {
+        QuicRecvChunkInitialize(Chunk, Length, NULL);
+    }
+
+    CxPlatListInsertTail(&RecvBuffer->Chunks, &Chunk->Link);
+    RecvBuffer->Capacity += Length;
+    return TRUE;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicRecvBufferCopyIntoChunks(
@@ -385,7 +502,46 @@ QuicRecvBufferCopyIntoChunks(
         WriteBuffer += Diff;
     }
 
-    if (RecvBuffer->RecvMode != QUIC_RECV_BUF_MODE_MULTIPLE) {
+    if (RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED ||
+        RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_ZERO_COPY) {
+        //
+        // In app-owned and zero copy mode the chunks are used linearly,
+        // starting at ReadStart in the first chunk, and the write may span any
+        // number of them. Chunks in retained datagrams already hold their
+        // data, as they only ever cover bytes written in the same datagram.
+        //
+        uint64_t ChunkOffset =
+            RecvBuffer->ReadStart + (WriteOffset - RecvBuffer->BaseOffset);
+        CXPLAT_LIST_ENTRY* Link = RecvBuffer->Chunks.Flink;
+        QUIC_RECV_CHUNK* Chunk =
+            CXPLAT_CONTAINING_RECORD(Link, QUIC_RECV_CHUNK, Link);
+        while (ChunkOffset >= Chunk->AllocLength) {
+            ChunkOffset -= Chunk->AllocLength;
+            Link = Link->Flink;
+            CXPLAT_DBG_ASSERT(Link != &RecvBuffer->Chunks); // Space was validated by the caller
+            Chunk = CXPLAT_CONTAINING_RECORD(Link, QUIC_RECV_CHUNK, Link);
+        }
+
+        while (TRUE) {
+            uint32_t ChunkWriteLength = Chunk->AllocLength - (uint32_t)ChunkOffset;
+            if (ChunkWriteLength > WriteLength) {
+                ChunkWriteLength = WriteLength;
+            }
+            if (Chunk->Packet == NULL) {
+                CxPlatCopyMemory(Chunk->Buffer + ChunkOffset, WriteBuffer, ChunkWriteLength);
+            }
+            WriteLength -= (uint16_t)ChunkWriteLength;
+            if (WriteLength == 0) {
+                break;
+            }
+            WriteBuffer += ChunkWriteLength;
+            ChunkOffset = 0;
+            Link = Link->Flink;
+            CXPLAT_DBG_ASSERT(Link != &RecvBuffer->Chunks);
+            Chunk = CXPLAT_CONTAINING_RECORD(Link, QUIC_RECV_CHUNK, Link);
+        }
+
+    } else if (RecvBuffer->RecvMode != QUIC_RECV_BUF_MODE_MULTIPLE) {
         //
         // In single/circular mode we always just write to the last chunk.
         //
@@ -528,6 +684,7 @@ QuicRecvBufferWrite(
     _In_ uint64_t WriteOffset,
     _In_ uint16_t WriteLength,
     _In_reads_bytes_(WriteLength) uint8_t const* WriteBuffer,
+    _In_opt_ QUIC_RX_PACKET* Packet,
     _Inout_ uint64_t* WriteLimit,
     _Out_ BOOLEAN* ReadyToRead
     )
@@ -548,8 +705,13 @@ QuicRecvBufferWrite(
     // Check to see if the write buffer is trying to write beyond the virtual
     // allocation limit (i.e. max stream data size).
     //
+    // In app-owned mode, this instead means the app hasn't provided enough
+    // buffer space (yet).
+    //
     if (AbsoluteLength > RecvBuffer->BaseOffset + RecvBuffer->VirtualBufferLength) {
-        return QUIC_STATUS_BUFFER_TOO_SMALL;
+        return
+            RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED ?
+                QUIC_STATUS_OUT_OF_MEMORY : QUIC_STATUS_BUFFER_TOO_SMALL;
     }
 
     //
@@ -574,8 +736,16 @@ QuicRecvBufferWrite(
     // to support rolling back those changes on the possible allocation failure
     // here.
     //
-    uint32_t AllocLength = QuicRecvBufferGetTotalAllocLength(RecvBuffer);
-    if (AbsoluteLength > RecvBuffer->BaseOffset + AllocLength) {
+    // N.B. App-owned buffers always have all their space allocated already.
+    //
+    if (RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_ZERO_COPY) {
+        if (AbsoluteLength > RecvBuffer->BaseOffset + RecvBuffer->Capacity &&
+            !QuicRecvBufferAppendChunk(
+                RecvBuffer, WriteOffset, WriteLength, WriteBuffer, Packet)) {
+            return QUIC_STATUS_OUT_OF_MEMORY;
+        }
+    } else if (RecvBuffer->RecvMode != QUIC_RECV_BUF_MODE_APP_OWNED &&
+        AbsoluteLength > RecvBuffer->BaseOffset + QuicRecvBufferGetTotalAllocLength(RecvBuffer)) {
         //
         // If we don't currently have enough room then we will want to resize
         // the last chunk to be big enough to hold everything. We do this by
@@ -649,7 +819,9 @@ QuicRecvBufferRead(
         RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_MULTIPLE);
     CXPLAT_DBG_ASSERT(
         RecvBuffer->Chunks.Flink->Flink == &RecvBuffer->Chunks || // Should only have one buffer if not using multiple receive mode
-        RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_MULTIPLE);
+        RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_MULTIPLE ||
+        RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED ||
+        RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_ZERO_COPY);
 
     //
     // Find the length of the data written in the front, after the BaseOffset.
@@ -712,6 +884,42 @@ QuicRecvBufferRead(
             Buffers[0].Buffer = Chunk->Buffer + ReadStart;
         }
 
+    } else if (RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED ||
+               RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_ZERO_COPY) {
+        //
+        // In app-owned mode, the data is indicated in place, in the app's own
+        // buffers, and in zero copy mode, in the received datagrams where
+        // possible. This may take one buffer per chunk, so if there are more
+        // chunks than buffers, the rest is indicated by the next read.
+        //
+        CXPLAT_DBG_ASSERT(RecvBuffer->ReadPendingLength == 0);
+        CXPLAT_DBG_ASSERT(*BufferCount >= 1);
+
+        uint64_t UnreadLength = ContiguousLength;
+        uint32_t ChunkReadOffset = RecvBuffer->ReadStart;
+        uint32_t Count = 0;
+        CXPLAT_LIST_ENTRY* Link = RecvBuffer->Chunks.Flink;
+        while (UnreadLength != 0 && Count < *BufferCount) {
+            CXPLAT_DBG_ASSERT(Link != &RecvBuffer->Chunks);
+            QUIC_RECV_CHUNK* Chunk =
+                CXPLAT_CONTAINING_RECORD(Link, QUIC_RECV_CHUNK, Link);
+            uint32_t ChunkReadLength = Chunk->AllocLength - ChunkReadOffset;
+            if (ChunkReadLength > UnreadLength) {
+                ChunkReadLength = (uint32_t)UnreadLength;
+            }
+            Buffers[Count].Length = ChunkReadLength;
+            Buffers[Count].Buffer = Chunk->Buffer + ChunkReadOffset;
+            Chunk->ExternalReference = TRUE;
+            UnreadLength -= ChunkReadLength;
+            ChunkReadOffset = 0;
+            Link = Link->Flink;
+            ++Count;
+        }
+
+        *BufferCount = Count;
+        *BufferOffset = RecvBuffer->BaseOffset;
+        RecvBuffer->ReadPendingLength = ContiguousLength - UnreadLength;
+
     } else {
         CXPLAT_DBG_ASSERT(RecvBuffer->ReadPendingLength < ContiguousLength); // Shouldn't call read if there is nothing new to read
         uint64_t UnreadLength = ContiguousLength - RecvBuffer->ReadPendingLength;
@@ -975,6 +1183,44 @@ QuicRecvBufferDrain(
     QUIC_SUBRANGE* FirstRange = QuicRangeGet(&RecvBuffer->WrittenRanges, 0);
     CXPLAT_DBG_ASSERT(FirstRange);
     CXPLAT_DBG_ASSERT(FirstRange->Low == 0);
+
+    if (RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED ||
+        RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_ZERO_COPY) {
+        //
+        // Release all the chunks that have been completely drained. In
+        // app-owned mode the buffers themselves belong to the app, so only the
+        // chunks are freed. In zero copy mode, any retained datagrams are
+        // released too.
+        //
+        RecvBuffer->BaseOffset += DrainLength;
+        if (RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED) {
+            RecvBuffer->VirtualBufferLength -= (uint32_t)DrainLength;
+        } else {
+            RecvBuffer->Capacity -= (uint32_t)DrainLength;
+        }
+        uint64_t ChunkOffset = RecvBuffer->ReadStart + DrainLength;
+        while (!CxPlatListIsEmpty(&RecvBuffer->Chunks)) {
+            QUIC_RECV_CHUNK* Chunk =
+                CXPLAT_CONTAINING_RECORD(
+                    RecvBuffer->Chunks.Flink,
+                    QUIC_RECV_CHUNK,
+                    Link);
+            Chunk->ExternalReference = FALSE;
+            if (ChunkOffset < Chunk->AllocLength) {
+                break;
+            }
+            ChunkOffset -= Chunk->AllocLength;
+            CxPlatListEntryRemove(&Chunk->Link);
+            if (Chunk->Packet != NULL) {
+                QuicPacketRelease(Chunk->Packet);
+            }
+            CXPLAT_FREE(Chunk, QUIC_POOL_RECVBUF);
+        }
+        CXPLAT_DBG_ASSERT(ChunkOffset < UINT32_MAX);
+        RecvBuffer->ReadStart = (uint32_t)ChunkOffset;
+        return RecvBuffer->BaseOffset == FirstRange->Count;
+    }
+
     do {
         BOOLEAN PartialDrain = (uint64_t)RecvBuffer->ReadLength > DrainLength;
         if (PartialDrain ||
@@ -12,19 +12,44 @@ extern "C" {
 typedef enum QUIC_RECV_BUF_MODE {
     QUIC_RECV_BUF_MODE_SINGLE,      // Only one receive with a single contiguous buffer at a time.
     QUIC_RECV_BUF_MODE_CIRCULAR,    // Only one receive that may indicate two contiguous buffers at a time.
-    QUIC_RECV_BUF_MODE_MULTIPLE     // Multiple independent receives that may indicate up to two contiguous buffers at a time.
+    QUIC_RECV_BUF_MODE_MULTIPLE,    // Multiple independent receives that may indicate up to two contiguous buffers at a time.
+    QUIC_RECV_BUF_MODE_APP_OWNED,   // Only one receive at a time, indicating data in place in the app provided buffers.
+    QUIC_RECV_BUF_MODE_ZERO_COPY    // Only one receive at a time, indicating in-order data in place in the received datagrams.
 } QUIC_RECV_BUF_MODE;
 
 //
-// Represents a single contiguous range of bytes.
+// Represents a single contiguous range of bytes. Internally allocated chunks
+// are followed directly by their buffer, while in app-owned mode the buffer is
+// memory provided by the app and in zero copy mode it may point into a
+// retained datagram.
 //
 typedef struct QUIC_RECV_CHUNK {
     CXPLAT_LIST_ENTRY Link;         // Link in the list of chunks.
     uint32_t AllocLength : 31;      // Allocation size of Buffer
     uint32_t ExternalReference : 1; // Indicates the buffer is being used externally.
-    uint8_t Buffer[0];
+    uint8_t* Buffer;
+    QUIC_RX_PACKET* Packet;         // The retained datagram Buffer points into, if any.
 } QUIC_RECV_CHUNK;
 
+//
+// Initializes a chunk to use the given buffer. If Buffer is NULL, the buffer
+// is expected to directly follow the chunk in memory.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+inline
+void
+QuicRecvChunkInitialize(
+    _Inout_ QUIC_RECV_CHUNK* Chunk,
+    _In_ uint32_t AllocLength,
+    _In_opt_ uint8_t* Buffer
+    )
+{
+    Chunk->AllocLength = AllocLength;
+    Chunk->ExternalReference = FALSE;
+    Chunk->Buffer = Buffer != NULL ? Buffer : (uint8_t*)(Chunk + 1);
+    Chunk->Packet = NULL;
+}
+
 typedef struct QUIC_RECV_BUFFER {
 
     //
@@ -53,7 +78,8 @@ typedef struct QUIC_RECV_BUFFER {
     uint64_t BaseOffset;
 
     //
-    // Start of the head in the circular of the first chunk.
+    // Start of the head in the circular of the first chunk. In app-owned mode,
+    // the offset of BaseOffset in the first chunk.
     //
     uint32_t ReadStart;
 
@@ -64,13 +90,15 @@ typedef struct QUIC_RECV_BUFFER {
     uint32_t ReadLength;
 
     //
-    // Length of the buffer indicated to peers.
+    // Length of the buffer indicated to peers. In app-owned mode, the length of
+    // app provided buffer space after BaseOffset.
     //
     uint32_t VirtualBufferLength;
 
     //
     // Basically same as Chunk->AllocLength of first chunk, but start shrinking
-    // by drain operation after next chunk is allocated.
+    // by drain operation after next chunk is allocated. In zero copy mode, the
+    // length of chunk space after BaseOffset.
     //
     uint32_t Capacity;
 
@@ -92,6 +120,17 @@ QuicRecvBufferInitialize(
     _In_opt_ QUIC_RECV_CHUNK* PreallocatedChunk
     );
 
+//
+// Adds app provided chunks to the end of the buffer, increasing the virtual
+// buffer length by their total length. Only valid in app-owned mode.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicRecvBufferProvideChunks(
+    _Inout_ QUIC_RECV_BUFFER* RecvBuffer,
+    _Inout_ CXPLAT_LIST_ENTRY* Chunks
+    );
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicRecvBufferUninitialize(
@@ -131,6 +170,10 @@ QuicRecvBufferIncreaseVirtualBufferLength(
 //
 // Buffers a (possibly out-of-order or duplicate) range of bytes.
 //
+// In zero copy mode, if Packet is provided, then WriteBuffer points into its
+// datagram and new bytes may be kept in place by retaining the packet instead
+// of being copied.
+//
 // NewDataReady indicates if new in-order bytes are ready to be delivered to the
 // client.
 //
@@ -142,6 +185,7 @@ QuicRecvBufferWrite(
     _In_ uint64_t WriteOffset,
     _In_ uint16_t WriteLength,
     _In_reads_bytes_(WriteLength) uint8_t const* WriteBuffer,
+    _In_opt_ QUIC_RX_PACKET* Packet,
     _Inout_ uint64_t* WriteLimit,
     _Out_ BOOLEAN* NewDataReady
     );
@@ -33,6 +33,9 @@ QuicSendInitialize(
     )
 {
     CxPlatListInitializeHead(&Send->SendStreams);
+    Send->PriorityLevels = &Send->InlinePriorityLevel;
+    Send->PriorityLevelCount = 0;
+    Send->PriorityLevelCapacity = 1;
     Send->MaxData = Settings->ConnFlowControlWindow;
 }
 
@@ -67,6 +70,13 @@ QuicSendUninitialize(
 
         QuicStreamRelease(Stream, QUIC_STREAM_REF_SEND);
     }
+
+    Send->PriorityLevelCount = 0;
+    if (Send->PriorityLevels != &Send->InlinePriorityLevel) {
+        CXPLAT_FREE(Send->PriorityLevels, QUIC_POOL_SEND_PRIORITY);
+        Send->PriorityLevels = &Send->InlinePriorityLevel;
+        Send->PriorityLevelCapacity = 1;
+    }
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -139,6 +149,198 @@ QuicSendQueueFlush(
     }
 }
 
+//
+// Binary searches the priority level index. Returns TRUE if the priority has a
+// level; either way, Index is set to where the level is (or would be inserted).
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+BOOLEAN
+QuicSendFindPriorityLevel(
+    _In_ const QUIC_SEND* Send,
+    _In_ uint16_t Priority,
+    _Out_ uint32_t* Index
+    )
+{
+    uint32_t Low = 0;
+    uint32_t High = Send->PriorityLevelCount;
+    while (Low < High) {
+        const uint32_t Mid = Low + (High - Low) / 2;
+        const uint16_t MidPriority = Send->PriorityLevels[Mid].Priority;
+        if (MidPriority == Priority) {
+            *Index = Mid;
+            return TRUE;
+        }
+        if (MidPriority > Priority) {
+            Low = Mid + 1;
+        } else {
+            High = Mid;
+        }
+    }
+    *Index = Low;
+    return FALSE;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+BOOLEAN
+QuicSendAddPriorityLevel(
+    _In_ QUIC_SEND* Send,
+    _In_ uint32_t Index,
+    _In_ QUIC_STREAM* Tail
+    )
+{
+    CXPLAT_DBG_ASSERT(Index <= Send->PriorityLevelCount);
+
+    if (Send->PriorityLevelCount == Send->PriorityLevelCapacity) {
+        const uint32_t NewCapacity = Send->PriorityLevelCapacity * 2;
+        QUIC_SEND_PRIORITY_LEVEL* NewLevels =
+            CXPLAT_ALLOC_NONPAGED(
+                NewCapacity * sizeof(QUIC_SEND_PRIORITY_LEVEL),
+                QUIC_POOL_SEND_PRIORITY);
+        if (NewLevels == NULL) {
+            QuicTraceEvent(
+                AllocFailure,
+                "Allocation of '%s' failed. (%llu bytes)",
+                "send priority levels",
+                NewCapacity * sizeof(QUIC_SEND_PRIORITY_LEVEL));
+            return FALSE;
+        }
+        CxPlatCopyMemory(
+            NewLevels,
+            Send->PriorityLevels,
+            Send->PriorityLevelCount * sizeof(QUIC_SEND_PRIORITY_LEVEL));
+        if (Send->PriorityLevels != &Send->InlinePriorityLevel) {
+            CXPLAT_FREE(Send->PriorityLevels, QUIC_POOL_SEND_PRIORITY);
+        }
+        Send->PriorityLevels = NewLevels;
+        Send->PriorityLevelCapacity = NewCapacity;
+    }
+
+    CxPlatMoveMemory(
+        Send->PriorityLevels + Index + 1,
+        Send->PriorityLevels + Index,
+        (Send->PriorityLevelCount - Index) * sizeof(QUIC_SEND_PRIORITY_LEVEL));
+    Send->PriorityLevels[Index].Tail = Tail;
+    Send->PriorityLevels[Index].Priority = Tail->SendPriority;
+    Send->PriorityLevelCount++;
+
+    return TRUE;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendInsertStream(
+    _In_ QUIC_SEND* Send,
+    _In_ QUIC_STREAM* Stream
+    )
+{
+    CXPLAT_DBG_ASSERT(Stream->SendLink.Flink == NULL);
+
+    uint32_t Index;
+    if (QuicSendFindPriorityLevel(Send, Stream->SendPriority, &Index)) {
+        QUIC_SEND_PRIORITY_LEVEL* Level = &Send->PriorityLevels[Index];
+        CxPlatListInsertHead(&Level->Tail->SendLink, &Stream->SendLink); // Insert after current tail
+        Level->Tail = Stream;
+        return;
+    }
+
+    //
+    // This is a new priority level. It goes right after the last stream of the
+    // next higher priority level. The forward search only ever iterates if an
+    // earlier level couldn't be added to the index (allocation failure).
+    //
+    CXPLAT_LIST_ENTRY* Entry =
+        Index == 0 ?
+            &Send->SendStreams :
+            &Send->PriorityLevels[Index - 1].Tail->SendLink;
+    while (Entry->Flink != &Send->SendStreams &&
+        CXPLAT_CONTAINING_RECORD(Entry->Flink, QUIC_STREAM, SendLink)->SendPriority >=
+            Stream->SendPriority) {
+        Entry = Entry->Flink;
+    }
+    CxPlatListInsertHead(Entry, &Stream->SendLink); // Insert after current Entry
+
+    //
+    // If the index can't grow, the stream is still queued in the correct order;
+    // only future operations on this level fall back to walking the list.
+    //
+    (void)QuicSendAddPriorityLevel(Send, Index, Stream);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendRemoveStream(
+    _In_ QUIC_SEND* Send,
+    _In_ QUIC_STREAM* Stream
+    )
+{
+    CXPLAT_DBG_ASSERT(Stream->SendLink.Flink != NULL);
+
+    uint32_t Index;
+    if (QuicSendFindPriorityLevel(Send, Stream->SendPriority, &Index) &&
+        Send->PriorityLevels[Index].Tail == Stream) {
+        CXPLAT_LIST_ENTRY* Prev = Stream->SendLink.Blink;
+        if (Prev != &Send->SendStreams &&
+            CXPLAT_CONTAINING_RECORD(Prev, QUIC_STREAM, SendLink)->SendPriority ==
+                Stream->SendPriority) {
+            Send->PriorityLevels[Index].Tail =
+                CXPLAT_CONTAINING_RECORD(Prev, QUIC_STREAM, SendLink);
+        } else {
+            //
+            // This was the last stream of the level.
+            //
+            Send->PriorityLevelCount--;
+            CxPlatMoveMemory(
+                Send->PriorityLevels + Index,
+                Send->PriorityLevels + Index + 1,
+                (Send->PriorityLevelCount - Index) * sizeof(QUIC_SEND_PRIORITY_LEVEL));
+        }
+    }
+
+    CxPlatListEntryRemove(&Stream->SendLink);
+    Stream->SendLink.Flink = NULL;
+    Stream->SendDeficit = 0;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendRotateStream(
+    _In_ QUIC_SEND* Send,
+    _In_ QUIC_STREAM* Stream
+    )
+{
+    CXPLAT_DBG_ASSERT(Stream->SendLink.Flink != NULL);
+
+    uint32_t Index;
+    if (QuicSendFindPriorityLevel(Send, Stream->SendPriority, &Index)) {
+        QUIC_SEND_PRIORITY_LEVEL* Level = &Send->PriorityLevels[Index];
+        if (Level->Tail != Stream) {
+            CxPlatListEntryRemove(&Stream->SendLink);
+            CxPlatListInsertHead(&Level->Tail->SendLink, &Stream->SendLink); // Insert after current tail
+            Level->Tail = Stream;
+        }
+        return;
+    }
+
+    //
+    // The level isn't indexed. Move the stream after any streams of the same
+    // priority by walking the list.
+    //
+    CXPLAT_LIST_ENTRY* LastEntry = Stream->SendLink.Flink;
+    while (LastEntry != &Send->SendStreams) {
+        if (Stream->SendPriority >
+            CXPLAT_CONTAINING_RECORD(LastEntry, QUIC_STREAM, SendLink)->SendPriority) {
+            break;
+        }
+        LastEntry = LastEntry->Flink;
+    }
+    if (LastEntry->Blink != &Stream->SendLink) {
+        CxPlatListEntryRemove(&Stream->SendLink);
+        CxPlatListInsertTail(LastEntry, &Stream->SendLink);
+    }
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicSendQueueFlushForStream(
@@ -149,21 +351,10 @@ QuicSendQueueFlushForStream(
 {
     if (Stream->SendLink.Flink == NULL) {
         //
-        // Not previously queued, so add the stream to the end of the queue.
+        // Not previously queued, so add the stream to the end of its priority
+        // level in the queue.
         //
-        CXPLAT_LIST_ENTRY* Entry = Send->SendStreams.Blink;
-        while (Entry != &Send->SendStreams) {
-            //
-            // Search back to front for the right place (based on priority) to
-            // insert the stream.
-            //
-            if (Stream->SendPriority <=
-                CXPLAT_CONTAINING_RECORD(Entry, QUIC_STREAM, SendLink)->SendPriority) {
-                break;
-            }
-            Entry = Entry->Blink;
-        }
-        CxPlatListInsertHead(Entry, &Stream->SendLink); // Insert after current Entry
+        QuicSendInsertStream(Send, Stream);
         QuicStreamAddRef(Stream, QUIC_STREAM_REF_SEND);
     }
 
@@ -189,25 +380,14 @@ _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicSendUpdateStreamPriority(
     _In_ QUIC_SEND* Send,
-    _In_ QUIC_STREAM* Stream
+    _In_ QUIC_STREAM* Stream,
+    _In_ uint16_t Priority
     )
 {
     CXPLAT_DBG_ASSERT(Stream->SendLink.Flink != NULL);
-    CxPlatListEntryRemove(&Stream->SendLink);
-
-    CXPLAT_LIST_ENTRY* Entry = Send->SendStreams.Blink;
-    while (Entry != &Send->SendStreams) {
-        //
-        // Search back to front for the right place (based on priority) to
-        // insert the stream.
-        //
-        if (Stream->SendPriority <=
-            CXPLAT_CONTAINING_RECORD(Entry, QUIC_STREAM, SendLink)->SendPriority) {
-            break;
-        }
-        Entry = Entry->Blink;
-    }
-    CxPlatListInsertHead(Entry, &Stream->SendLink); // Insert after current Entry
+    QuicSendRemoveStream(Send, Stream);
+    Stream->SendPriority = Priority;
+    QuicSendInsertStream(Send, Stream);
 }
 
 #if DEBUG
@@ -273,6 +453,7 @@ QuicSendClear(
 
         QuicStreamRelease(Stream, QUIC_STREAM_REF_SEND);
     }
+    Send->PriorityLevelCount = 0;
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -455,8 +636,7 @@ QuicSendClearStreamSendFlag(
             //
             // Since there are no flags left, remove the stream from the queue.
             //
-            CxPlatListEntryRemove(&Stream->SendLink);
-            Stream->SendLink.Flink = NULL;
+            QuicSendRemoveStream(Send, Stream);
             QuicStreamRelease(Stream, QUIC_STREAM_REF_SEND);
         }
     }
@@ -1006,25 +1186,21 @@ QuicSendGetNextStream(
         //
         if (QuicSendCanSendStreamNow(Stream)) {
 
-            if (Connection->State.UseRoundRobinStreamScheduling) {
+            if (Connection->State.UseExtensiblePriorityStreamScheduling) {
                 //
-                // Move the stream after any streams of the same priority. Start
-                // with the "next" entry in the list and keep going until the
-                // next entry's priority is less. Then move the stream before
-                // that entry.
+                // Non-incremental streams are sent one at a time, in the order
+                // they were queued, ahead of any incremental streams of the
+                // same urgency. Incremental streams take turns, each limited
+                // by its deficit round robin credit instead of a packet count.
                 //
-                CXPLAT_LIST_ENTRY* LastEntry = Stream->SendLink.Flink;
-                while (LastEntry != &Send->SendStreams) {
-                    if (Stream->SendPriority >
-                        CXPLAT_CONTAINING_RECORD(LastEntry, QUIC_STREAM, SendLink)->SendPriority) {
-                        break;
-                    }
-                    LastEntry = LastEntry->Flink;
-                }
-                if (LastEntry->Blink != &Stream->SendLink) {
-                    CxPlatListEntryRemove(&Stream->SendLink);
-                    CxPlatListInsertTail(LastEntry, &Stream->SendLink);
-                }
+                QuicSendCreditStream(Send, Stream);
+                *PacketCount = UINT32_MAX;
+
+            } else if (Connection->State.UseRoundRobinStreamScheduling) {
+                //
+                // Move the stream after any streams of the same priority.
+                //
+                QuicSendRotateStream(Send, Stream);
 
                 *PacketCount = QUIC_STREAM_SEND_BATCH_COUNT;
 
@@ -1041,6 +1217,43 @@ QuicSendGetNextStream(
     return NULL;
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendCreditStream(
+    _In_ QUIC_SEND* Send,
+    _In_ QUIC_STREAM* Stream
+    )
+{
+    if (!QUIC_STREAM_PRIORITY_IS_INCREMENTAL(Stream->SendPriority)) {
+        return;
+    }
+
+    //
+    // Incremental streams of the same urgency share bandwidth by deficit round
+    // robin. Credit the stream with its quantum and move it behind its peers.
+    // Credit left over from a turn cut short (e.g. by congestion control)
+    // isn't banked, but any overshoot from the last turn is repaid.
+    //
+    Stream->SendDeficit =
+        CXPLAT_MIN(Stream->SendDeficit, 0) + QUIC_STREAM_SEND_QUANTUM;
+    QuicSendRotateStream(Send, Stream);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicSendChargeStream(
+    _In_ QUIC_STREAM* Stream,
+    _In_ uint32_t BytesWritten
+    )
+{
+    if (!QUIC_STREAM_PRIORITY_IS_INCREMENTAL(Stream->SendPriority)) {
+        return TRUE; // Non-incremental streams aren't limited to a quantum.
+    }
+
+    Stream->SendDeficit -= (int32_t)BytesWritten;
+    return Stream->SendDeficit > 0;
+}
+
 BOOLEAN
 CxPlatIsRouteReady(
     _In_ QUIC_CONNECTION *Connection,
@@ -1394,6 +1607,7 @@ QuicSendFlush(
             //
             // Write the stream frames.
             //
+            uint16_t StreamFrameStart = Builder.DatagramLength;
             WrotePacketFrames |= QuicStreamSendWrite(Stream, &Builder);
 
             if (Stream->SendFlags == 0 && Stream->SendLink.Flink != NULL) {
@@ -1401,12 +1615,14 @@ QuicSendFlush(
                 // If the stream no longer has anything to send, remove it from the
                 // list and release Send's reference on it.
                 //
-                CxPlatListEntryRemove(&Stream->SendLink);
-                Stream->SendLink.Flink = NULL;
+                QuicSendRemoveStream(Send, Stream);
                 QuicStreamRelease(Stream, QUIC_STREAM_REF_SEND);
                 Stream = NULL;
 
-            } else if ((WrotePacketFrames && --StreamPacketCount == 0) ||
+            } else if ((Connection->State.UseExtensiblePriorityStreamScheduling &&
+                    !QuicSendChargeStream(
+                        Stream, Builder.DatagramLength - StreamFrameStart)) ||
+                (WrotePacketFrames && --StreamPacketCount == 0) ||
                 !QuicSendCanSendStreamNow(Stream)) {
                 //
                 // Try a new stream next loop iteration.
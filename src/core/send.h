@@ -5,6 +5,10 @@
 
 --*/
 
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
 #define SEND_PACKET_SHORT_HEADER_TYPE 0xff
 
 inline
@@ -234,6 +238,23 @@ inline BOOLEAN HasStreamDataFrames(uint32_t Flags)
          QUIC_STREAM_SEND_FLAG_FIN);
 }
 
+//
+// Streams in the send queue are kept sorted by priority, so all the streams of
+// a given priority form a contiguous run in the list. A priority level tracks
+// the last stream of its run so that new streams can be appended to the level
+// (and round robin can rotate within the level) without walking the list.
+//
+typedef struct QUIC_SEND_PRIORITY_LEVEL {
+
+    //
+    // The last stream in the send queue with this priority.
+    //
+    QUIC_STREAM* Tail;
+
+    uint16_t Priority;
+
+} QUIC_SEND_PRIORITY_LEVEL;
+
 typedef struct QUIC_SEND {
 
     //
@@ -317,6 +338,16 @@ typedef struct QUIC_SEND {
     //
     CXPLAT_LIST_ENTRY SendStreams;
 
+    //
+    // Index of the priority levels present in SendStreams, sorted from highest
+    // to lowest priority. Initially points at InlinePriorityLevel, as most
+    // connections only ever use a single priority.
+    //
+    QUIC_SEND_PRIORITY_LEVEL* PriorityLevels;
+    uint32_t PriorityLevelCount;
+    uint32_t PriorityLevelCapacity;
+    QUIC_SEND_PRIORITY_LEVEL InlinePriorityLevel;
+
     //
     // The current token to send with an Initial packet.
     //
@@ -412,15 +443,68 @@ QuicSendQueueFlushForStream(
     );
 
 //
-// Updates the stream's order in response to a priority change.
+// Updates the stream's priority and its order in the send queue.
 //
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicSendUpdateStreamPriority(
+    _In_ QUIC_SEND* Send,
+    _In_ QUIC_STREAM* Stream,
+    _In_ uint16_t Priority
+    );
+
+//
+// Inserts the stream at the end of its priority level in the send queue.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendInsertStream(
     _In_ QUIC_SEND* Send,
     _In_ QUIC_STREAM* Stream
     );
 
+//
+// Removes the stream from the send queue.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendRemoveStream(
+    _In_ QUIC_SEND* Send,
+    _In_ QUIC_STREAM* Stream
+    );
+
+//
+// Moves the stream behind all the other streams of the same priority.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendRotateStream(
+    _In_ QUIC_SEND* Send,
+    _In_ QUIC_STREAM* Stream
+    );
+
+//
+// Starts a new deficit round robin turn for an incremental stream, crediting
+// it with a quantum of bytes and moving it behind its peers.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendCreditStream(
+    _In_ QUIC_SEND* Send,
+    _In_ QUIC_STREAM* Stream
+    );
+
+//
+// Charges an incremental stream's deficit round robin turn for the bytes it
+// just framed. Returns FALSE once the turn's credit is used up.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicSendChargeStream(
+    _In_ QUIC_STREAM* Stream,
+    _In_ uint32_t BytesWritten
+    );
+
 //
 // Tries to drain all queued data that needs to be sent. Returns TRUE if all the
 // data was drained.
@@ -512,3 +596,7 @@ QuicSendClearStreamSendFlag(
     _In_ QUIC_STREAM* Stream,
     _In_ uint32_t SendFlag
     );
+
+#if defined(__cplusplus)
+}
+#endif
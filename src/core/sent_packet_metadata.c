@@ -10,9 +10,16 @@ Abstract:
     packet is later acknowledged or inferred lost, this metadata is used
     to determine what exactly was acknowledged or lost.
 
-    The size of a QUIC_SENT_PACKET_METADATA depends on the number of frames
-    contained in the packet. The allocator uses a different pool for each
-    possible size.
+    The QUIC_SENT_PACKET_METADATA itself is a fixed size, cache line sized
+    item, which also holds the frame metadata of packets with a single frame.
+    The frames of other packets are allocated separately, from a
+    per-connection arena of fixed size chunks. Packets are generally
+    acknowledged in the order they are sent, so a chunk is usually freed in one
+    go once all the packets using it are acknowledged.
+
+    Outstanding packets are tracked in a QUIC_SENT_PACKET_RING, which indexes
+    them directly by packet number so that processing an ACK range doesn't
+    require walking every older outstanding packet.
 
 --*/
 
@@ -27,36 +34,37 @@ QuicSentPacketMetadataReleaseFrames(
     _In_ QUIC_CONNECTION* Connection
     )
 {
+    QUIC_SENT_FRAME_METADATA* Frames = QuicSentPacketMetadataGetFrames(Metadata);
     for (uint8_t i = 0; i < Metadata->FrameCount; i++) {
-        switch (Metadata->Frames[i].Type)
+        switch (Frames[i].Type)
         {
 #pragma warning(push)
 #pragma warning(disable:6001)
         case QUIC_FRAME_RESET_STREAM:
-            QuicStreamSentMetadataDecrement(Metadata->Frames[i].RESET_STREAM.Stream);
+            QuicStreamSentMetadataDecrement(Frames[i].RESET_STREAM.Stream);
             break;
         case QUIC_FRAME_MAX_STREAM_DATA:
-            QuicStreamSentMetadataDecrement(Metadata->Frames[i].MAX_STREAM_DATA.Stream);
+            QuicStreamSentMetadataDecrement(Frames[i].MAX_STREAM_DATA.Stream);
             break;
         case QUIC_FRAME_STREAM_DATA_BLOCKED:
-            QuicStreamSentMetadataDecrement(Metadata->Frames[i].STREAM_DATA_BLOCKED.Stream);
+            QuicStreamSentMetadataDecrement(Frames[i].STREAM_DATA_BLOCKED.Stream);
             break;
         case QUIC_FRAME_STOP_SENDING:
-            QuicStreamSentMetadataDecrement(Metadata->Frames[i].STOP_SENDING.Stream);
+            QuicStreamSentMetadataDecrement(Frames[i].STOP_SENDING.Stream);
             break;
         case QUIC_FRAME_STREAM:
-            QuicStreamSentMetadataDecrement(Metadata->Frames[i].STREAM.Stream);
+            QuicStreamSentMetadataDecrement(Frames[i].STREAM.Stream);
             break;
         case QUIC_FRAME_RELIABLE_RESET_STREAM:
-            QuicStreamSentMetadataDecrement(Metadata->Frames[i].RELIABLE_RESET_STREAM.Stream);
+            QuicStreamSentMetadataDecrement(Frames[i].RELIABLE_RESET_STREAM.Stream);
             break;
 #pragma warning(pop)
         case QUIC_FRAME_DATAGRAM:
         case QUIC_FRAME_DATAGRAM_1:
-            if (Metadata->Frames[i].DATAGRAM.ClientContext != NULL) {
+            if (Frames[i].DATAGRAM.ClientContext != NULL) {
                 QuicDatagramIndicateSendStateChange(
                     Connection,
-                    &Metadata->Frames[i].DATAGRAM.ClientContext,
+                    &Frames[i].DATAGRAM.ClientContext,
                     QUIC_DATAGRAM_SEND_LOST_DISCARDED);
             }
             break;
@@ -75,44 +83,170 @@ QuicSentPacketPoolInitialize(
     _Inout_ QUIC_SENT_PACKET_POOL* Pool
     )
 {
-    for (uint32_t i = 0; i < ARRAYSIZE(Pool->Pools); i++) {
-        uint32_t PacketMetadataSize =
-            (i + 1) * sizeof(QUIC_SENT_FRAME_METADATA) +
-            sizeof(QUIC_SENT_PACKET_METADATA);
+    CxPlatPoolInitialize(
+        FALSE,  // IsPaged
+        sizeof(QUIC_SENT_PACKET_METADATA),
+        QUIC_POOL_META,
+        &Pool->PacketPool);
+    CxPlatPoolInitialize(
+        FALSE,  // IsPaged
+        QUIC_SENT_FRAME_CHUNK_SIZE,
+        QUIC_POOL_SENT_FRAME_ARENA,
+        &Pool->ChunkPool);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicSentPacketPoolUninitialize(
+    _In_ QUIC_SENT_PACKET_POOL* Pool
+    )
+{
+    CxPlatPoolUninitialize(&Pool->PacketPool);
+    CxPlatPoolUninitialize(&Pool->ChunkPool);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicSentFrameArenaInitialize(
+    _Out_ QUIC_SENT_FRAME_ARENA* Arena
+    )
+{
+    Arena->Current = NULL;
+    Arena->ChunkCount = 0;
+    Arena->PacketCount = 0;
+}
 
-        CxPlatPoolInitialize(
-            FALSE,  // IsPaged
-            PacketMetadataSize,
-            QUIC_POOL_META,
-            Pool->Pools + i);
+//
+// Drops a reference on a chunk, returning it to the pool on the last one.
+//
+static
+void
+QuicSentFrameChunkRelease(
+    _Inout_ QUIC_SENT_FRAME_ARENA* Arena,
+    _In_ QUIC_SENT_PACKET_POOL* Pool,
+    _In_ QUIC_SENT_FRAME_CHUNK* Chunk
+    )
+{
+    CXPLAT_DBG_ASSERT(Chunk->RefCount > 0);
+    if (--Chunk->RefCount == 0) {
+        CXPLAT_DBG_ASSERT(Arena->ChunkCount > 0);
+        Arena->ChunkCount--;
+        CxPlatPoolFree(&Pool->ChunkPool, Chunk);
     }
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
-QuicSentPacketPoolUninitialize(
+QuicSentFrameArenaUninitialize(
+    _Inout_ QUIC_SENT_FRAME_ARENA* Arena,
     _In_ QUIC_SENT_PACKET_POOL* Pool
     )
 {
-    for (size_t i = 0; i < ARRAYSIZE(Pool->Pools); i++) {
-        CxPlatPoolUninitialize(Pool->Pools + i);
+    CXPLAT_DBG_ASSERT(Arena->PacketCount == 0);
+    if (Arena->Current != NULL) {
+        QuicSentFrameChunkRelease(Arena, Pool, Arena->Current);
+        Arena->Current = NULL;
     }
+    CXPLAT_DBG_ASSERT(Arena->ChunkCount == 0);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Success_(return != NULL)
+void*
+QuicSentFrameArenaAlloc(
+    _Inout_ QUIC_SENT_FRAME_ARENA* Arena,
+    _In_ QUIC_SENT_PACKET_POOL* Pool,
+    _In_range_(>, 0) uint16_t Size,
+    _Out_ uint16_t* Offset
+    )
+{
+    const uint32_t AlignedSize = ((uint32_t)Size + 7) & ~7u;
+    CXPLAT_DBG_ASSERT(
+        AlignedSize <= QUIC_SENT_FRAME_CHUNK_SIZE - sizeof(QUIC_SENT_FRAME_CHUNK));
+
+    QUIC_SENT_FRAME_CHUNK* Chunk = Arena->Current;
+    if (Chunk == NULL || Chunk->Used + AlignedSize > QUIC_SENT_FRAME_CHUNK_SIZE) {
+        Chunk = CxPlatPoolAlloc(&Pool->ChunkPool);
+        if (Chunk == NULL) {
+            QuicTraceEvent(
+                AllocFailure,
+                "Allocation of '%s' failed. (%llu bytes)",
+                "Sent frame arena chunk",
+                QUIC_SENT_FRAME_CHUNK_SIZE);
+            return NULL;
+        }
+        Chunk->RefCount = 1; // The arena's reference.
+        Chunk->Used = sizeof(QUIC_SENT_FRAME_CHUNK);
+        Arena->ChunkCount++;
+
+        if (Arena->Current != NULL) {
+            QuicSentFrameChunkRelease(Arena, Pool, Arena->Current);
+        }
+        Arena->Current = Chunk;
+    }
+
+    *Offset = (uint16_t)Chunk->Used;
+    Chunk->Used += AlignedSize;
+    Chunk->RefCount++;
+    return (uint8_t*)Chunk + *Offset;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicSentFrameArenaAddRef(
+    _In_ const void* Allocation,
+    _In_ uint16_t Offset
+    )
+{
+    QUIC_SENT_FRAME_CHUNK* Chunk =
+        (QUIC_SENT_FRAME_CHUNK*)((uint8_t*)Allocation - Offset);
+    CXPLAT_DBG_ASSERT(Chunk->RefCount > 0);
+    Chunk->RefCount++;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicSentFrameArenaRelease(
+    _Inout_ QUIC_SENT_FRAME_ARENA* Arena,
+    _In_ QUIC_SENT_PACKET_POOL* Pool,
+    _In_ const void* Allocation,
+    _In_ uint16_t Offset
+    )
+{
+    QuicSentFrameChunkRelease(
+        Arena, Pool, (QUIC_SENT_FRAME_CHUNK*)((uint8_t*)Allocation - Offset));
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_SENT_PACKET_METADATA*
 QuicSentPacketPoolGetPacketMetadata(
     _In_ QUIC_SENT_PACKET_POOL* Pool,
-    _In_ uint8_t FrameCount
+    _Inout_ QUIC_SENT_FRAME_ARENA* Arena,
+    _In_range_(1, QUIC_MAX_FRAMES_PER_PACKET) uint8_t FrameCount
     )
 {
-    QUIC_SENT_PACKET_METADATA* Metadata =
-        CxPlatPoolAlloc(Pool->Pools + FrameCount - 1);
-#if DEBUG
-    if (Metadata != NULL) {
-        Metadata->Flags.Freed = FALSE;
+    QUIC_SENT_PACKET_METADATA* Metadata = CxPlatPoolAlloc(&Pool->PacketPool);
+    if (Metadata == NULL) {
+        return NULL;
     }
-#endif
+
+    Metadata->FramesInline = FrameCount == 1;
+    if (!Metadata->FramesInline) {
+        Metadata->Frames =
+            QuicSentFrameArenaAlloc(
+                Arena,
+                Pool,
+                (uint16_t)(FrameCount * sizeof(QUIC_SENT_FRAME_METADATA)),
+                &Metadata->FrameOffset);
+        if (Metadata->Frames == NULL) {
+            CxPlatPoolFree(&Pool->PacketPool, Metadata);
+            return NULL;
+        }
+    }
+
+    Metadata->FrameCount = FrameCount;
+    Metadata->LastAckedPacketInfo = NULL;
+    Arena->PacketCount++;
     return Metadata;
 }
 
@@ -123,14 +257,250 @@ QuicSentPacketPoolReturnPacketMetadata(
     _In_ QUIC_CONNECTION* Connection
     )
 {
+    CXPLAT_DBG_ASSERT(Metadata->FrameCount != 0); // Already freed?
     _Analysis_assume_(
         Metadata->FrameCount > 0 &&
         Metadata->FrameCount <= QUIC_MAX_FRAMES_PER_PACKET);
 
+    QUIC_SENT_PACKET_POOL* Pool = &Connection->Worker->SentPacketPool;
+    QUIC_SENT_FRAME_ARENA* Arena = &Connection->LossDetection.FrameArena;
+
+    QuicSentPacketMetadataReleaseFrames(Metadata, Connection);
+    if (!Metadata->FramesInline) {
+        QuicSentFrameArenaRelease(Arena, Pool, Metadata->Frames, Metadata->FrameOffset);
+    }
+    if (Metadata->LastAckedPacketInfo != NULL) {
+        QuicSentFrameArenaRelease(
+            Arena,
+            Pool,
+            Metadata->LastAckedPacketInfo,
+            Metadata->LastAckedPacketInfo->ArenaOffset);
+    }
+
+    CXPLAT_DBG_ASSERT(Arena->PacketCount > 0);
+    Arena->PacketCount--;
 #if DEBUG
-    Metadata->Flags.Freed = TRUE;
+    Metadata->FrameCount = 0; // Tracked packets always have frames.
 #endif
+    CxPlatPoolFree(&Pool->PacketPool, Metadata);
+}
 
-    QuicSentPacketMetadataReleaseFrames(Metadata, Connection);
-    CxPlatPoolFree(Connection->Worker->SentPacketPool.Pools + Metadata->FrameCount - 1, Metadata);
+#define QUIC_SENT_PACKET_RING_MIN_CAPACITY 64
+
+//
+// Returns the index of the least significant set bit. Mask must not be 0.
+//
+static
+uint32_t
+QuicSentPacketRingFindFirstBit(
+    _In_ uint64_t Mask
+    )
+{
+    CXPLAT_DBG_ASSERT(Mask != 0);
+#if defined(_MSC_VER)
+    unsigned long Index;
+    if (_BitScanForward(&Index, (unsigned long)Mask)) {
+        return (uint32_t)Index;
+    }
+    _BitScanForward(&Index, (unsigned long)(Mask >> 32));
+    return (uint32_t)Index + 32;
+#else
+    return (uint32_t)__builtin_ctzll(Mask);
+#endif
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicSentPacketRingInitialize(
+    _Out_ QUIC_SENT_PACKET_RING* Ring
+    )
+{
+    CxPlatZeroMemory(Ring, sizeof(*Ring));
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicSentPacketRingUninitialize(
+    _Inout_ QUIC_SENT_PACKET_RING* Ring
+    )
+{
+    CXPLAT_DBG_ASSERT(Ring->Count == 0);
+    if (Ring->Slots != NULL) {
+        CXPLAT_FREE(Ring->Slots, QUIC_POOL_SENT_PACKET_RING);
+        Ring->Slots = NULL;
+        Ring->Bitmap = NULL;
+    }
+    Ring->Capacity = 0;
+    Ring->Head = 0;
+    Ring->Span = 0;
+}
+
+//
+// Grows the ring so that it has at least MinCapacity slots. The live span is
+// moved to the start of the new allocation.
+//
+static
+_Success_(return != FALSE)
+BOOLEAN
+QuicSentPacketRingGrow(
+    _Inout_ QUIC_SENT_PACKET_RING* Ring,
+    _In_ uint64_t MinCapacity
+    )
+{
+    uint64_t NewCapacity =
+        Ring->Capacity == 0 ? QUIC_SENT_PACKET_RING_MIN_CAPACITY : Ring->Capacity;
+    while (NewCapacity < MinCapacity) {
+        NewCapacity <<= 1;
+    }
+    if (NewCapacity > 0x80000000ull) {
+        return FALSE;
+    }
+
+    const size_t AllocSize =
+        (size_t)NewCapacity * sizeof(QUIC_SENT_PACKET_METADATA*) +
+        (size_t)(NewCapacity / 64) * sizeof(uint64_t);
+    QUIC_SENT_PACKET_METADATA** NewSlots =
+        CXPLAT_ALLOC_NONPAGED(AllocSize, QUIC_POOL_SENT_PACKET_RING);
+    if (NewSlots == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "Sent packet ring",
+            AllocSize);
+        return FALSE;
+    }
+    CxPlatZeroMemory(NewSlots, AllocSize);
+    uint64_t* NewBitmap = (uint64_t*)(NewSlots + NewCapacity);
+
+    for (uint32_t i = 0; i < Ring->Span; i++) {
+        QUIC_SENT_PACKET_METADATA* Packet =
+            Ring->Slots[(Ring->Head + i) & (Ring->Capacity - 1)];
+        if (Packet != NULL) {
+            NewSlots[i] = Packet;
+            NewBitmap[i / 64] |= 1ull << (i % 64);
+        }
+    }
+
+    if (Ring->Slots != NULL) {
+        CXPLAT_FREE(Ring->Slots, QUIC_POOL_SENT_PACKET_RING);
+    }
+    Ring->Slots = NewSlots;
+    Ring->Bitmap = NewBitmap;
+    Ring->Capacity = (uint32_t)NewCapacity;
+    Ring->Head = 0;
+
+    return TRUE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Success_(return != FALSE)
+BOOLEAN
+QuicSentPacketRingInsert(
+    _Inout_ QUIC_SENT_PACKET_RING* Ring,
+    _In_ QUIC_SENT_PACKET_METADATA* Packet
+    )
+{
+    if (Ring->Span == 0) {
+        Ring->Base = Packet->PacketNumber;
+        Ring->Head = 0;
+    }
+    CXPLAT_DBG_ASSERT(Packet->PacketNumber >= Ring->Base);
+    CXPLAT_DBG_ASSERT(
+        Ring->Span == 0 || Packet->PacketNumber > QuicSentPacketRingLargest(Ring));
+
+    const uint64_t Offset = Packet->PacketNumber - Ring->Base;
+    if (Offset >= Ring->Capacity &&
+        !QuicSentPacketRingGrow(Ring, Offset + 1)) {
+        return FALSE;
+    }
+
+    const uint32_t Slot = (Ring->Head + (uint32_t)Offset) & (Ring->Capacity - 1);
+    Ring->Slots[Slot] = Packet;
+    Ring->Bitmap[Slot / 64] |= 1ull << (Slot % 64);
+    Ring->Span = (uint32_t)Offset + 1;
+    Ring->Count++;
+
+    return TRUE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_SENT_PACKET_METADATA*
+QuicSentPacketRingRemove(
+    _Inout_ QUIC_SENT_PACKET_RING* Ring,
+    _In_ uint64_t PacketNumber
+    )
+{
+    QUIC_SENT_PACKET_METADATA* Packet = QuicSentPacketRingGet(Ring, PacketNumber);
+    if (Packet == NULL) {
+        return NULL;
+    }
+
+    const uint32_t Slot =
+        (Ring->Head + (uint32_t)(PacketNumber - Ring->Base)) & (Ring->Capacity - 1);
+    Ring->Slots[Slot] = NULL;
+    Ring->Bitmap[Slot / 64] &= ~(1ull << (Slot % 64));
+    Ring->Count--;
+
+    if (PacketNumber == Ring->Base) {
+        //
+        // Trim the front of the ring up to the next outstanding packet so that
+        // the first slot is always occupied.
+        //
+        if (Ring->Count == 0) {
+            Ring->Span = 0;
+        } else {
+            const uint64_t Next =
+                QuicSentPacketRingFindNext(Ring, PacketNumber + 1, UINT64_MAX);
+            CXPLAT_DBG_ASSERT(Next != UINT64_MAX);
+            const uint32_t Advance = (uint32_t)(Next - Ring->Base);
+            Ring->Head = (Ring->Head + Advance) & (Ring->Capacity - 1);
+            Ring->Span -= Advance;
+            Ring->Base = Next;
+        }
+    }
+
+    return Packet;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+QuicSentPacketRingFindNext(
+    _In_ const QUIC_SENT_PACKET_RING* Ring,
+    _In_ uint64_t PacketNumber,
+    _In_ uint64_t Last
+    )
+{
+    if (Ring->Span == 0) {
+        return UINT64_MAX;
+    }
+    if (PacketNumber < Ring->Base) {
+        PacketNumber = Ring->Base;
+    }
+    const uint64_t Largest = QuicSentPacketRingLargest(Ring);
+    if (Last > Largest) {
+        Last = Largest;
+    }
+    if (PacketNumber > Last) {
+        return UINT64_MAX;
+    }
+
+    //
+    // Slots outside the live span are always empty, and the capacity is a
+    // multiple of 64, so each bitmap word can be scanned without worrying
+    // about wrapping around the end of the ring.
+    //
+    uint64_t Offset = PacketNumber - Ring->Base;
+    const uint64_t LastOffset = Last - Ring->Base;
+    while (Offset <= LastOffset) {
+        const uint32_t Slot =
+            (Ring->Head + (uint32_t)Offset) & (Ring->Capacity - 1);
+        const uint64_t Word = Ring->Bitmap[Slot / 64] >> (Slot % 64);
+        if (Word != 0) {
+            Offset += QuicSentPacketRingFindFirstBit(Word);
+            return Offset <= LastOffset ? Ring->Base + Offset : UINT64_MAX;
+        }
+        Offset += 64 - (Slot % 64);
+    }
+
+    return UINT64_MAX;
 }
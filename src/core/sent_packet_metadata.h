@@ -5,6 +5,10 @@
 
 --*/
 
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
 //
 // The maximum number of frames we will write to a single packet.
 //
@@ -96,11 +100,7 @@ typedef struct QUIC_SEND_PACKET_FLAGS {
     // TRUE if the packet is sent while the transmission rate is limited by application
     //
     BOOLEAN IsAppLimited            : 1;
-    BOOLEAN HasLastAckedPacketInfo  : 1;
     BOOLEAN EcnEctSet               : 1;
-#if DEBUG
-    BOOLEAN Freed                   : 1;
-#endif
 
 } QUIC_SEND_PACKET_FLAGS;
 
@@ -110,9 +110,10 @@ typedef struct QUIC_SEND_PACKET_FLAGS {
 typedef struct LAST_ACKED_PACKET_INFO {
 
     //
-    // Total bytes sent when the last acked packet was acked
+    // Total bytes sent when the last acked packet was acked. Wraps, like
+    // QUIC_SENT_PACKET_METADATA.TotalBytesSent.
     //
-    uint64_t TotalBytesSent;
+    uint32_t TotalBytesSent;
 
     //
     // Total bytes acked when the last acked packet was acked
@@ -135,43 +136,96 @@ typedef struct LAST_ACKED_PACKET_INFO {
     //
     uint64_t AdjustedAckTime;
 
+    //
+    // Offset of this structure in its frame arena chunk. Every packet sent
+    // between two ACKs shares the same info, so it is allocated once from the
+    // arena and referenced by those packets.
+    //
+    uint16_t ArenaOffset;
 
 } LAST_ACKED_PACKET_INFO;
 
 //
-// Tracker for a sent packet.
+// Tracker for a sent packet. This is exactly one cache line, and the metadata
+// of a packet's frame is stored inline when it has only one, so the common
+// single STREAM frame packet is tracked without touching any other memory.
+// Packets with more frames keep them in the connection's frame arena instead.
 //
 typedef struct QUIC_SENT_PACKET_METADATA {
 
     struct QUIC_SENT_PACKET_METADATA *Next;
 
-    uint64_t PacketId;
     uint64_t PacketNumber;
+    uint64_t SentTime; // In microseconds
+
     //
-    // Total bytes sent when the packet was sent (including this packet)
+    // Shared info about the last acked packet when this one was sent, if any.
     //
-    uint64_t TotalBytesSent;
-    uint64_t SentTime; // In microseconds
-    uint16_t PacketLength;
-    uint8_t PathId;
+    const LAST_ACKED_PACKET_INFO* LastAckedPacketInfo;
 
-    LAST_ACKED_PACKET_INFO LastAckedPacketInfo;
+    //
+    // Total bytes sent when the packet was sent (including this packet). This
+    // wraps; it is only ever compared with the value of an earlier packet that
+    // was still outstanding, so the difference is always correct.
+    //
+    uint32_t TotalBytesSent;
+
+    uint16_t PacketLength           : 11;
+    uint16_t FrameCount             : 4;
+
+    //
+    // TRUE if the frame metadata is stored in Frame rather than Frames.
+    //
+    uint16_t FramesInline           : 1;
 
     //
     // Hints about the QUIC packet and included frames.
     //
     QUIC_SEND_PACKET_FLAGS Flags;
 
+    uint8_t PathId;
+
     //
-    // Frames included in this packet.
+    // Frames included in this packet. Use QuicSentPacketMetadataGetFrames to
+    // access them.
     //
-    uint8_t FrameCount;
-    QUIC_SENT_FRAME_METADATA Frames[0];
+    union {
+        QUIC_SENT_FRAME_METADATA Frame;
+        struct {
+            QUIC_SENT_FRAME_METADATA* Frames;
+
+            //
+            // Offset of Frames in its frame arena chunk, if it was allocated
+            // from one.
+            //
+            uint16_t FrameOffset;
+        };
+    };
 
 } QUIC_SENT_PACKET_METADATA;
 
-#define SIZEOF_QUIC_SENT_PACKET_METADATA(FrameCount) \
-    (sizeof(QUIC_SENT_PACKET_METADATA) + FrameCount * sizeof(QUIC_SENT_FRAME_METADATA))
+CXPLAT_STATIC_ASSERT(
+    sizeof(QUIC_SENT_PACKET_METADATA) == 64,
+    "Sent packet metadata should be exactly one cache line");
+CXPLAT_STATIC_ASSERT(
+    QUIC_MAX_FRAMES_PER_PACKET < (1 << 4),
+    "Metadata 'FrameCount' field above assumes it fits in 4 bits");
+CXPLAT_STATIC_ASSERT(
+    CXPLAT_MAX_MTU < (1 << 11),
+    "Metadata 'PacketLength' field above assumes packets fit in 11 bits");
+
+//
+// Returns the frames of a packet.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+inline
+QUIC_SENT_FRAME_METADATA*
+QuicSentPacketMetadataGetFrames(
+    _In_ QUIC_SENT_PACKET_METADATA* Metadata
+    )
+{
+    return Metadata->FramesInline ? &Metadata->Frame : Metadata->Frames;
+}
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
 inline
@@ -192,13 +246,13 @@ QuicSentPacketMetadataReleaseFrames(
     );
 
 //
-// Helper for allocating the maximum sent packet metadata on the stack.
+// Helper for allocating the maximum sent packet metadata on the stack. The
+// owner must point Metadata.Frames at Frames and clear Metadata.FramesInline.
 //
-typedef union QUIC_MAX_SENT_PACKET_METADATA
+typedef struct QUIC_MAX_SENT_PACKET_METADATA
 {
     QUIC_SENT_PACKET_METADATA Metadata;
-    uint8_t Raw[sizeof(QUIC_SENT_PACKET_METADATA) +
-              sizeof(QUIC_SENT_FRAME_METADATA) * QUIC_MAX_FRAMES_PER_PACKET];
+    QUIC_SENT_FRAME_METADATA Frames[QUIC_MAX_FRAMES_PER_PACKET];
 
 } QUIC_MAX_SENT_PACKET_METADATA;
 
@@ -207,12 +261,59 @@ CXPLAT_STATIC_ASSERT(
     "Max Send Packet Metadata should be small enough to be allocated on the stack");
 
 //
-// A collection of object pools for each size of packet and
-// associated frame metadata.
+// Size of each frame arena chunk, including its header.
+//
+#define QUIC_SENT_FRAME_CHUNK_SIZE 4096
+
+//
+// A chunk of frame arena memory. Allocations are carved out of the chunk
+// sequentially and each takes a reference on it. The chunk is returned to the
+// pool, all at once, when the last packet using it is released.
+//
+typedef struct QUIC_SENT_FRAME_CHUNK {
+
+    uint32_t RefCount;
+
+    //
+    // Offset of the first free byte, from the start of the chunk.
+    //
+    uint32_t Used;
+
+} QUIC_SENT_FRAME_CHUNK;
+
+//
+// Per-connection arena for sent frame metadata. Packets are generally sent and
+// acknowledged in order, so their frames are allocated contiguously and whole
+// chunks are freed together as ACKs arrive.
+//
+typedef struct QUIC_SENT_FRAME_ARENA {
+
+    //
+    // The chunk new allocations are carved from. The arena holds a reference
+    // on it.
+    //
+    QUIC_SENT_FRAME_CHUNK* Current;
+
+    //
+    // Number of chunks currently held by the connection.
+    //
+    uint32_t ChunkCount;
+
+    //
+    // Number of sent packet metadata items currently allocated with this
+    // arena.
+    //
+    uint32_t PacketCount;
+
+} QUIC_SENT_FRAME_ARENA;
+
+//
+// Object pools for sent packet metadata and frame arena chunks.
 //
 typedef struct QUIC_SENT_PACKET_POOL {
 
-    CXPLAT_POOL Pools[QUIC_MAX_FRAMES_PER_PACKET];
+    CXPLAT_POOL PacketPool;
+    CXPLAT_POOL ChunkPool;
 
 } QUIC_SENT_PACKET_POOL;
 
@@ -228,14 +329,69 @@ QuicSentPacketPoolUninitialize(
     _In_ QUIC_SENT_PACKET_POOL* Pool
     );
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicSentFrameArenaInitialize(
+    _Out_ QUIC_SENT_FRAME_ARENA* Arena
+    );
+
+//
+// Releases the arena's current chunk. All packets allocated with the arena
+// must have been freed first.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicSentFrameArenaUninitialize(
+    _Inout_ QUIC_SENT_FRAME_ARENA* Arena,
+    _In_ QUIC_SENT_PACKET_POOL* Pool
+    );
+
+//
+// Allocates Size bytes from the arena and returns the allocation's offset in
+// its chunk, needed to release it.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Success_(return != NULL)
+void*
+QuicSentFrameArenaAlloc(
+    _Inout_ QUIC_SENT_FRAME_ARENA* Arena,
+    _In_ QUIC_SENT_PACKET_POOL* Pool,
+    _In_range_(>, 0) uint16_t Size,
+    _Out_ uint16_t* Offset
+    );
+
+//
+// Takes an additional reference on the chunk holding an arena allocation.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicSentFrameArenaAddRef(
+    _In_ const void* Allocation,
+    _In_ uint16_t Offset
+    );
+
+//
+// Releases a reference on the chunk holding an arena allocation.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicSentFrameArenaRelease(
+    _Inout_ QUIC_SENT_FRAME_ARENA* Arena,
+    _In_ QUIC_SENT_PACKET_POOL* Pool,
+    _In_ const void* Allocation,
+    _In_ uint16_t Offset
+    );
+
 //
-// Allocates a sent packet metadata item.
+// Allocates a sent packet metadata item, with room for FrameCount frames. A
+// single frame is stored inline; more are allocated from the arena.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_SENT_PACKET_METADATA*
 QuicSentPacketPoolGetPacketMetadata(
     _In_ QUIC_SENT_PACKET_POOL* Pool,
-    _In_ uint8_t FrameCount
+    _Inout_ QUIC_SENT_FRAME_ARENA* Arena,
+    _In_range_(1, QUIC_MAX_FRAMES_PER_PACKET) uint8_t FrameCount
     );
 
 //
@@ -247,3 +403,157 @@ QuicSentPacketPoolReturnPacketMetadata(
     _In_ QUIC_SENT_PACKET_METADATA* Metadata,
     _In_ QUIC_CONNECTION* Connection
     );
+
+//
+// Tracks outstanding sent packets, indexed by packet number. Since all packets
+// use a single, increasing packet number sequence, slot i of the ring holds the
+// packet numbered Base + i, or NULL if that packet isn't outstanding (i.e. it
+// was already acknowledged or lost, or was never tracked). An occupancy bitmap
+// allows runs of empty slots to be skipped 64 at a time, so sweeping an ACK
+// range only costs time proportional to the packets it actually acknowledges.
+//
+typedef struct QUIC_SENT_PACKET_RING {
+
+    //
+    // Capacity slot pointers, followed by Capacity / 64 bitmap words.
+    //
+    QUIC_SENT_PACKET_METADATA** Slots;
+    uint64_t* Bitmap;
+
+    //
+    // Number of slots. Always a power of 2 and at least 64.
+    //
+    uint32_t Capacity;
+
+    //
+    // Slot index of the Base packet number.
+    //
+    uint32_t Head;
+
+    //
+    // Number of slots from Base up to and including the largest packet number
+    // inserted. The first slot is always occupied if Span is non-zero.
+    //
+    uint32_t Span;
+
+    //
+    // Number of occupied slots.
+    //
+    uint32_t Count;
+
+    //
+    // Packet number of the Head slot.
+    //
+    uint64_t Base;
+
+} QUIC_SENT_PACKET_RING;
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicSentPacketRingInitialize(
+    _Out_ QUIC_SENT_PACKET_RING* Ring
+    );
+
+//
+// Frees the ring's memory. The ring must be empty.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicSentPacketRingUninitialize(
+    _Inout_ QUIC_SENT_PACKET_RING* Ring
+    );
+
+//
+// Adds a packet to the ring. Its packet number must be larger than any other
+// packet in the ring. Returns FALSE if the ring couldn't grow to fit it.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Success_(return != FALSE)
+BOOLEAN
+QuicSentPacketRingInsert(
+    _Inout_ QUIC_SENT_PACKET_RING* Ring,
+    _In_ QUIC_SENT_PACKET_METADATA* Packet
+    );
+
+//
+// Removes and returns the packet with the given packet number, or returns NULL
+// if it isn't in the ring.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_SENT_PACKET_METADATA*
+QuicSentPacketRingRemove(
+    _Inout_ QUIC_SENT_PACKET_RING* Ring,
+    _In_ uint64_t PacketNumber
+    );
+
+//
+// Returns the smallest packet number in [PacketNumber, Last] that is in the
+// ring, or UINT64_MAX if there is none.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+QuicSentPacketRingFindNext(
+    _In_ const QUIC_SENT_PACKET_RING* Ring,
+    _In_ uint64_t PacketNumber,
+    _In_ uint64_t Last
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+inline
+BOOLEAN
+QuicSentPacketRingIsEmpty(
+    _In_ const QUIC_SENT_PACKET_RING* Ring
+    )
+{
+    return Ring->Count == 0;
+}
+
+//
+// Returns the largest packet number the ring currently spans. Only valid if
+// the ring isn't empty.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+inline
+uint64_t
+QuicSentPacketRingLargest(
+    _In_ const QUIC_SENT_PACKET_RING* Ring
+    )
+{
+    CXPLAT_DBG_ASSERT(Ring->Span != 0);
+    return Ring->Base + Ring->Span - 1;
+}
+
+//
+// Returns the packet with the given packet number, or NULL if it isn't in the
+// ring.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+inline
+QUIC_SENT_PACKET_METADATA*
+QuicSentPacketRingGet(
+    _In_ const QUIC_SENT_PACKET_RING* Ring,
+    _In_ uint64_t PacketNumber
+    )
+{
+    if (PacketNumber < Ring->Base || PacketNumber - Ring->Base >= Ring->Span) {
+        return NULL;
+    }
+    return Ring->Slots[(Ring->Head + (uint32_t)(PacketNumber - Ring->Base)) & (Ring->Capacity - 1)];
+}
+
+//
+// Returns the oldest packet in the ring, or NULL if it is empty.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+inline
+QUIC_SENT_PACKET_METADATA*
+QuicSentPacketRingFirst(
+    _In_ const QUIC_SENT_PACKET_RING* Ring
+    )
+{
+    return Ring->Span == 0 ? NULL : Ring->Slots[Ring->Head];
+}
+
+#if defined(__cplusplus)
+}
+#endif
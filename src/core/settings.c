@@ -168,6 +168,9 @@ QuicSettingsSetDefault(
     if (!Settings->IsSet.StreamMultiReceiveEnabled) {
         Settings->StreamMultiReceiveEnabled = QUIC_DEFAULT_STREAM_MULTI_RECEIVE_ENABLED;
     }
+    if (!Settings->IsSet.StreamZeroCopyReceiveEnabled) {
+        Settings->StreamZeroCopyReceiveEnabled = QUIC_DEFAULT_STREAM_ZERO_COPY_RECEIVE_ENABLED;
+    }
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -336,6 +339,9 @@ QuicSettingsCopy(
     if (!Destination->IsSet.StreamMultiReceiveEnabled) {
         Destination->StreamMultiReceiveEnabled = Source->StreamMultiReceiveEnabled;
     }
+    if (!Destination->IsSet.StreamZeroCopyReceiveEnabled) {
+        Destination->StreamZeroCopyReceiveEnabled = Source->StreamZeroCopyReceiveEnabled;
+    }
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -711,6 +717,11 @@ QuicSettingApply(
         Destination->StreamMultiReceiveEnabled = Source->StreamMultiReceiveEnabled;
         Destination->IsSet.StreamMultiReceiveEnabled = TRUE;
     }
+
+    if (Source->IsSet.StreamZeroCopyReceiveEnabled && (!Destination->IsSet.StreamZeroCopyReceiveEnabled || OverWrite)) {
+        Destination->StreamZeroCopyReceiveEnabled = Source->StreamZeroCopyReceiveEnabled;
+        Destination->IsSet.StreamZeroCopyReceiveEnabled = TRUE;
+    }
     return TRUE;
 }
 
@@ -1379,6 +1390,16 @@ VersionSettingsFail:
             &ValueLen);
         Settings->StreamMultiReceiveEnabled = !!Value;
     }
+    if (!Settings->IsSet.StreamZeroCopyReceiveEnabled) {
+        Value = QUIC_DEFAULT_STREAM_ZERO_COPY_RECEIVE_ENABLED;
+        ValueLen = sizeof(Value);
+        CxPlatStorageReadValue(
+            Storage,
+            QUIC_SETTING_STREAM_ZERO_COPY_RECEIVE_ENABLED,
+            (uint8_t*)&Value,
+            &ValueLen);
+        Settings->StreamZeroCopyReceiveEnabled = !!Value;
+    }
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -1448,6 +1469,7 @@ QuicSettingsDump(
     QuicTraceLogVerbose(SettingOneWayDelayEnabled,          "[sett] OneWayDelayEnabled     = %hhu", Settings->OneWayDelayEnabled);
     QuicTraceLogVerbose(SettingNetStatsEventEnabled,        "[sett] NetStatsEventEnabled   = %hhu", Settings->NetStatsEventEnabled);
     QuicTraceLogVerbose(SettingsStreamMultiReceiveEnabled,  "[sett] StreamMultiReceiveEnabled= %hhu", Settings->StreamMultiReceiveEnabled);
+    QuicTraceLogVerbose(SettingsStreamZeroCopyReceiveEnabled, "[sett] StreamZeroCopyReceiveEnabled= %hhu", Settings->StreamZeroCopyReceiveEnabled);
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -1612,6 +1634,9 @@ QuicSettingsDumpNew(
     if (Settings->IsSet.StreamMultiReceiveEnabled) {
         QuicTraceLogVerbose(SettingStreamMultiReceiveEnabled,       "[sett] StreamMultiReceiveEnabled  = %hhu", Settings->StreamMultiReceiveEnabled);
     }
+    if (Settings->IsSet.StreamZeroCopyReceiveEnabled) {
+        QuicTraceLogVerbose(SettingStreamZeroCopyReceiveEnabled,    "[sett] StreamZeroCopyReceiveEnabled = %hhu", Settings->StreamZeroCopyReceiveEnabled);
+    }
 }
 
 #define SETTINGS_SIZE_THRU_FIELD(SettingsType, Field) \
@@ -1876,6 +1901,14 @@ QuicSettingsSettingsToInternal(
         SettingsSize,
         InternalSettings);
 
+    SETTING_COPY_FLAG_TO_INTERNAL_SIZED(
+        Flags,
+        StreamZeroCopyReceiveEnabled,
+        QUIC_SETTINGS,
+        Settings,
+        SettingsSize,
+        InternalSettings);
+
     return QUIC_STATUS_SUCCESS;
 }
 
@@ -2045,6 +2078,14 @@ QuicSettingsGetSettings(
         *SettingsLength,
         InternalSettings);
 
+    SETTING_COPY_FLAG_FROM_INTERNAL_SIZED(
+        Flags,
+        StreamZeroCopyReceiveEnabled,
+        QUIC_SETTINGS,
+        Settings,
+        *SettingsLength,
+        InternalSettings);
+
     *SettingsLength = CXPLAT_MIN(*SettingsLength, sizeof(QUIC_SETTINGS));
 
     return QUIC_STATUS_SUCCESS;
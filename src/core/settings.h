@@ -62,7 +62,8 @@ typedef struct QUIC_SETTINGS_INTERNAL {
             uint64_t OneWayDelayEnabled                     : 1;
             uint64_t NetStatsEventEnabled                   : 1;
             uint64_t StreamMultiReceiveEnabled              : 1;
-            uint64_t RESERVED                               : 16;
+            uint64_t StreamZeroCopyReceiveEnabled           : 1;
+            uint64_t RESERVED                               : 15;
         } IsSet;
     };
 
@@ -113,6 +114,7 @@ typedef struct QUIC_SETTINGS_INTERNAL {
     uint8_t OneWayDelayEnabled              : 1;
     uint8_t NetStatsEventEnabled            : 1;
     uint8_t StreamMultiReceiveEnabled       : 1;
+    uint8_t StreamZeroCopyReceiveEnabled    : 1;
     uint8_t MtuDiscoveryMissingProbeCount;
 
 } QUIC_SETTINGS_INTERNAL;
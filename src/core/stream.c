@@ -70,7 +70,9 @@ QuicStreamInitialize(
     Stream->RecvMaxLength = UINT64_MAX;
     Stream->RefCount = 1;
     Stream->SendRequestsTail = &Stream->SendRequests;
-    Stream->SendPriority = QUIC_STREAM_PRIORITY_DEFAULT;
+    Stream->SendPriority =
+        Connection->State.UseExtensiblePriorityStreamScheduling ?
+            QUIC_STREAM_PRIORITY_EXTENSIBLE_DEFAULT : QUIC_STREAM_PRIORITY_DEFAULT;
     CxPlatDispatchLockInitialize(&Stream->ApiSendRequestLock);
     CxPlatRefInitialize(&Stream->RefCount);
     QuicRangeInitialize(
@@ -112,8 +114,29 @@ QuicStreamInitialize(
         }
     }
 
+    QUIC_RECV_BUF_MODE RecvMode;
+    if (Flags & QUIC_STREAM_OPEN_FLAG_APP_OWNED_BUFFERS) {
+        //
+        // All the receive buffer space will be provided by the app.
+        //
+        Stream->Flags.ReceiveMultiple = FALSE;
+        RecvMode = QUIC_RECV_BUF_MODE_APP_OWNED;
+    } else if (Connection->Settings.StreamZeroCopyReceiveEnabled &&
+               !Stream->Flags.ReceiveMultiple) {
+        //
+        // In-order data is indicated in place, in the received datagrams.
+        //
+        RecvMode = QUIC_RECV_BUF_MODE_ZERO_COPY;
+    } else {
+        RecvMode =
+            Stream->Flags.ReceiveMultiple ?
+                QUIC_RECV_BUF_MODE_MULTIPLE : QUIC_RECV_BUF_MODE_CIRCULAR;
+    }
+
     InitialRecvBufferLength = Connection->Settings.StreamRecvBufferDefault;
-    if (InitialRecvBufferLength == QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE) {
+    if ((RecvMode == QUIC_RECV_BUF_MODE_MULTIPLE ||
+         RecvMode == QUIC_RECV_BUF_MODE_CIRCULAR) &&
+        InitialRecvBufferLength == QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE) {
         PreallocatedRecvChunk = CxPlatPoolAlloc(&Worker->DefaultReceiveBufferPool);
         if (PreallocatedRecvChunk == NULL) {
             Status = QUIC_STATUS_OUT_OF_MEMORY;
@@ -132,14 +155,19 @@ QuicStreamInitialize(
             &Stream->RecvBuffer,
             InitialRecvBufferLength,
             FlowControlWindowSize,
-            Stream->Flags.ReceiveMultiple ?
-                QUIC_RECV_BUF_MODE_MULTIPLE : QUIC_RECV_BUF_MODE_CIRCULAR,
+            RecvMode,
             PreallocatedRecvChunk);
     if (QUIC_FAILED(Status)) {
         goto Exit;
     }
 
-    Stream->MaxAllowedRecvOffset = Stream->RecvBuffer.VirtualBufferLength;
+    //
+    // N.B. App-owned buffers start out empty, but the peer is still allowed
+    // the initial window from the transport parameters.
+    //
+    Stream->MaxAllowedRecvOffset =
+        RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED ?
+            FlowControlWindowSize : Stream->RecvBuffer.VirtualBufferLength;
     Stream->RecvWindowLastUpdate = CxPlatTimeUs64();
 
     QuicConnAddRef(Connection, QUIC_CONN_REF_STREAM);
@@ -190,6 +218,7 @@ QuicStreamFree(
 
     CXPLAT_DBG_ASSERT(Stream->ApiSendRequests == NULL);
     CXPLAT_DBG_ASSERT(Stream->SendRequests == NULL);
+    CXPLAT_DBG_ASSERT(Stream->SendRequestIndex == NULL);
 
 #if DEBUG
     CxPlatDispatchLockAcquire(&Connection->Streams.AllStreamsLock);
@@ -652,28 +681,47 @@ QuicStreamParamSet(
         Status = QUIC_STATUS_INVALID_PARAMETER;
         break;
 
-    case QUIC_PARAM_STREAM_PRIORITY: {
+    case QUIC_PARAM_STREAM_PRIORITY:
+    case QUIC_PARAM_STREAM_EXTENSIBLE_PRIORITY: {
 
-        if (BufferLength != sizeof(Stream->SendPriority) || Buffer == NULL) {
-            Status = QUIC_STATUS_INVALID_PARAMETER;
-            break;
+        uint16_t NewPriority;
+        if (Param == QUIC_PARAM_STREAM_PRIORITY) {
+            if (BufferLength != sizeof(Stream->SendPriority) || Buffer == NULL) {
+                Status = QUIC_STATUS_INVALID_PARAMETER;
+                break;
+            }
+            NewPriority = *(uint16_t*)Buffer;
+
+        } else {
+            const QUIC_STREAM_EXTENSIBLE_PRIORITY* Priority =
+                (const QUIC_STREAM_EXTENSIBLE_PRIORITY*)Buffer;
+            if (BufferLength != sizeof(QUIC_STREAM_EXTENSIBLE_PRIORITY) ||
+                Buffer == NULL ||
+                Priority->Urgency > QUIC_STREAM_URGENCY_MAX) {
+                Status = QUIC_STATUS_INVALID_PARAMETER;
+                break;
+            }
+            NewPriority =
+                QUIC_STREAM_PRIORITY_FROM_EXTENSIBLE(
+                    Priority->Urgency, Priority->Incremental);
         }
 
-        if (Stream->SendPriority != *(uint16_t*)Buffer) {
-            Stream->SendPriority = *(uint16_t*)Buffer;
+        if (Stream->SendPriority != NewPriority) {
+            if (Stream->Flags.Started && Stream->SendFlags != 0) {
+                //
+                // Update the stream's place in the send queue if necessary.
+                //
+                QuicSendUpdateStreamPriority(
+                    &Stream->Connection->Send, Stream, NewPriority);
+            } else {
+                Stream->SendPriority = NewPriority;
+            }
 
             QuicTraceLogStreamInfo(
                 UpdatePriority,
                 Stream,
                 "New send priority = %hu",
                 Stream->SendPriority);
-
-            if (Stream->Flags.Started && Stream->SendFlags != 0) {
-                //
-                // Update the stream's place in the send queue if necessary.
-                //
-                QuicSendUpdateStreamPriority(&Stream->Connection->Send, Stream);
-            }
         }
 
         Status = QUIC_STATUS_SUCCESS;
@@ -840,6 +888,30 @@ QuicStreamParamGet(
         Status = QUIC_STATUS_SUCCESS;
         break;
 
+    case QUIC_PARAM_STREAM_EXTENSIBLE_PRIORITY: {
+
+        if (*BufferLength < sizeof(QUIC_STREAM_EXTENSIBLE_PRIORITY)) {
+            *BufferLength = sizeof(QUIC_STREAM_EXTENSIBLE_PRIORITY);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        QUIC_STREAM_EXTENSIBLE_PRIORITY* Priority =
+            (QUIC_STREAM_EXTENSIBLE_PRIORITY*)Buffer;
+        *BufferLength = sizeof(QUIC_STREAM_EXTENSIBLE_PRIORITY);
+        Priority->Urgency = QUIC_STREAM_PRIORITY_URGENCY(Stream->SendPriority);
+        Priority->Incremental =
+            QUIC_STREAM_PRIORITY_IS_INCREMENTAL(Stream->SendPriority);
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
     case QUIC_PARAM_STREAM_STATISTICS: {
 
         if (*BufferLength < sizeof(QUIC_STREAM_STATISTICS)) {
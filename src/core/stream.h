@@ -9,6 +9,10 @@
 #include "stream.h.clog.h"
 #endif
 
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
 typedef struct QUIC_CONNECTION QUIC_CONNECTION;
 
 //
@@ -53,6 +57,32 @@ typedef struct QUIC_CONNECTION QUIC_CONNECTION;
 
 #define QUIC_STREAM_PRIORITY_DEFAULT 0x7FFF // Medium priority by default
 
+//
+// The extensible priority (RFC 9218) urgency and incremental values are folded
+// into the 16-bit send priority, so the send queue orders streams by urgency
+// and puts non-incremental streams ahead of incremental ones of the same
+// urgency. The low bits are left clear.
+//
+#define QUIC_STREAM_PRIORITY_URGENCY_SHIFT      13
+#define QUIC_STREAM_PRIORITY_NON_INCREMENTAL    0x1000
+
+#define QUIC_STREAM_PRIORITY_FROM_EXTENSIBLE(Urgency, Incremental) \
+    ((uint16_t)(((QUIC_STREAM_URGENCY_MAX - (Urgency)) << QUIC_STREAM_PRIORITY_URGENCY_SHIFT) | \
+        ((Incremental) ? 0 : QUIC_STREAM_PRIORITY_NON_INCREMENTAL)))
+
+#define QUIC_STREAM_PRIORITY_URGENCY(Priority) \
+    ((uint8_t)(QUIC_STREAM_URGENCY_MAX - ((Priority) >> QUIC_STREAM_PRIORITY_URGENCY_SHIFT)))
+
+#define QUIC_STREAM_PRIORITY_IS_INCREMENTAL(Priority) \
+    (((Priority) & QUIC_STREAM_PRIORITY_NON_INCREMENTAL) == 0)
+
+//
+// Under the extensible priority scheme, streams start with the RFC 9218 default
+// of urgency 3, non-incremental.
+//
+#define QUIC_STREAM_PRIORITY_EXTENSIBLE_DEFAULT \
+    QUIC_STREAM_PRIORITY_FROM_EXTENSIBLE(QUIC_STREAM_URGENCY_DEFAULT, FALSE)
+
 //
 // Tracks the data queued up for sending by an application.
 //
@@ -305,6 +335,22 @@ typedef struct QUIC_STREAM {
     //
     QUIC_SEND_REQUEST* SendBufferBookmark;
 
+    //
+    // The number of requests queued on SendRequests.
+    //
+    uint32_t SendRequestCount;
+
+    //
+    // Circular array of the queued send requests, in queue (and so stream
+    // offset) order, used to find the request containing a retransmitted
+    // offset without walking the queue. Only allocated once more than
+    // QUIC_SEND_REQUEST_INDEX_THRESHOLD requests are queued. NULL if not
+    // allocated, in which case lookups fall back to walking the queue.
+    //
+    QUIC_SEND_REQUEST** SendRequestIndex;
+    uint32_t SendRequestIndexHead;
+    uint32_t SendRequestIndexCapacity; // Power of 2
+
     //
     // The total send offset for all queued send requests.
     //
@@ -377,6 +423,13 @@ typedef struct QUIC_STREAM {
     //
     uint16_t SendPriority;
 
+    //
+    // The remaining byte credit of an incremental stream's deficit round robin
+    // turn, when using the extensible priority scheduling scheme. Negative
+    // values carry any overshoot from the last packet into the next turn.
+    //
+    int32_t SendDeficit;
+
     //
     // Recv State
     //
@@ -867,6 +920,40 @@ QuicStreamSendFlush(
     _In_ QUIC_STREAM* Stream
     );
 
+//
+// Queue length above which the send requests are indexed by stream offset.
+//
+#define QUIC_SEND_REQUEST_INDEX_THRESHOLD 16
+
+//
+// Adds a request, just appended to the end of SendRequests, to the index.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamSendRequestIndexAppend(
+    _In_ QUIC_STREAM* Stream,
+    _In_ QUIC_SEND_REQUEST* SendRequest
+    );
+
+//
+// Drops the first request, just removed from SendRequests, from the index.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamSendRequestIndexRemoveFirst(
+    _In_ QUIC_STREAM* Stream
+    );
+
+//
+// Finds the queued send request containing the stream byte at Offset.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_SEND_REQUEST*
+QuicStreamFindSendRequest(
+    _In_ const QUIC_STREAM* Stream,
+    _In_ uint64_t Offset
+    );
+
 //
 // Copies the bytes of a send request and completes it early.
 //
@@ -1005,3 +1092,19 @@ QuicStreamRecvSetEnabledState(
     _In_ QUIC_STREAM* Stream,
     _In_ BOOLEAN NewRecvEnabled
     );
+
+//
+// Adds app provided receive buffers (as a list of QUIC_RECV_CHUNK) to the
+// stream, switching it to app-owned receive buffers if necessary. On failure,
+// the chunks are left in the list.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicStreamProvideRecvBuffers(
+    _In_ QUIC_STREAM* Stream,
+    _Inout_ CXPLAT_LIST_ENTRY* Chunks
+    );
+
+#if defined(__cplusplus)
+}
+#endif
@@ -182,6 +182,34 @@ QuicStreamIndicatePeerSendAbortedEvent(
     (void)QuicStreamIndicateEvent(Stream, &Event);
 }
 
+//
+// Asks the app for more receive buffer space when the app-owned buffers can't
+// hold the data up to EndOffset. The app may provide the buffers inline.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamIndicateReceiveBufferNeeded(
+    _In_ QUIC_STREAM* Stream,
+    _In_ uint64_t EndOffset
+    )
+{
+    const uint64_t BufferEndOffset =
+        Stream->RecvBuffer.BaseOffset + Stream->RecvBuffer.VirtualBufferLength;
+    if (EndOffset <= BufferEndOffset) {
+        return;
+    }
+
+    QUIC_STREAM_EVENT Event;
+    Event.Type = QUIC_STREAM_EVENT_RECEIVE_BUFFER_NEEDED;
+    Event.RECEIVE_BUFFER_NEEDED.BufferLengthNeeded = EndOffset - BufferEndOffset;
+    QuicTraceLogStreamVerbose(
+        IndicateReceiveBufferNeeded,
+        Stream,
+        "Indicating QUIC_STREAM_EVENT_RECEIVE_BUFFER_NEEDED [%llu bytes]",
+        Event.RECEIVE_BUFFER_NEEDED.BufferLengthNeeded);
+    (void)QuicStreamIndicateEvent(Stream, &Event);
+}
+
 //
 // Processes a received RELIABLE_RESET frame's payload.
 //
@@ -379,7 +407,7 @@ _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QuicStreamProcessStreamFrame(
     _In_ QUIC_STREAM* Stream,
-    _In_ BOOLEAN EncryptedWith0Rtt,
+    _In_ QUIC_RX_PACKET* Packet,
     _In_ const QUIC_STREAM_EX* Frame
     )
 {
@@ -475,6 +503,21 @@ QuicStreamProcessStreamFrame(
 
     } else {
 
+        if (Stream->RecvBuffer.RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED) {
+            //
+            // App-owned buffers may have less space than the flow control
+            // window, so the limit has to be checked explicitly. If the data
+            // doesn't fit in the provided buffers, give the app a chance to
+            // provide more before failing the write below (which drops the
+            // packet, so that the peer retransmits it later).
+            //
+            if (EndOffset > Stream->MaxAllowedRecvOffset) {
+                Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+                goto Error;
+            }
+            QuicStreamIndicateReceiveBufferNeeded(Stream, EndOffset);
+        }
+
         //
         // This is initialized to inform QuicRecvBufferWrite of the
         // max number of allowed bytes per connection flow control.
@@ -489,12 +532,17 @@ QuicStreamProcessStreamFrame(
         // Write any nonduplicate data to the receive buffer.
         // QuicRecvBufferWrite will indicate if there is data to deliver.
         //
+        // N.B. In zero copy mode, only data from 1-RTT packets is used in
+        // place. Long header packets may share the datagram with packets that
+        // are deferred (and returned) separately.
+        //
         Status =
             QuicRecvBufferWrite(
                 &Stream->RecvBuffer,
                 Frame->Offset,
                 (uint16_t)Frame->Length,
                 Frame->Data,
+                Packet->IsShortHeader ? Packet : NULL,
                 &WriteLength,
                 &ReadyToDeliver);
         if (QUIC_FAILED(Status)) {
@@ -515,7 +563,7 @@ QuicStreamProcessStreamFrame(
                 "Flow control window exhausted!");
         }
 
-        if (EncryptedWith0Rtt) {
+        if (Packet->EncryptedWith0Rtt) {
             //
             // Keep track of the maximum length of the 0-RTT payload so that we
             // can indicate that appropriately to the API client.
@@ -713,7 +761,7 @@ QuicStreamRecv(
 
         Status =
             QuicStreamProcessStreamFrame(
-                Stream, Packet->EncryptedWith0Rtt, &Frame);
+                Stream, Packet, &Frame);
 
         break;
     }
@@ -760,6 +808,14 @@ QuicStreamOnBytesDelivered(
             QUIC_CONN_SEND_FLAG_MAX_DATA);
     }
 
+    if (Stream->RecvBuffer.RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED) {
+        //
+        // The stream's flow control window only moves when the app provides
+        // more buffers. See QuicStreamProvideRecvBuffers.
+        //
+        return;
+    }
+
     if (Stream->RecvWindowBytesDelivered >= RecvBufferDrainThreshold) {
 
         uint64_t TimeNow = CxPlatTimeUs64();
@@ -873,7 +929,7 @@ QuicStreamRecvFlush(
     while (FlushRecv) {
         CXPLAT_DBG_ASSERT(!Stream->Flags.SentStopSending);
 
-        QUIC_BUFFER RecvBuffers[3];
+        QUIC_BUFFER RecvBuffers[QUIC_MAX_RECEIVE_INDICATION_BUFFERS];
         QUIC_STREAM_EVENT Event = {0};
         Event.Type = QUIC_STREAM_EVENT_RECEIVE;
         Event.RECEIVE.BufferCount = ARRAYSIZE(RecvBuffers);
@@ -1174,3 +1230,74 @@ QuicStreamRecvSetEnabledState(
 
     return QUIC_STATUS_SUCCESS;
 }
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicStreamProvideRecvBuffers(
+    _In_ QUIC_STREAM* Stream,
+    _Inout_ CXPLAT_LIST_ENTRY* Chunks
+    )
+{
+    QUIC_STATUS Status;
+
+    if (Stream->Flags.RemoteNotAllowed ||
+        Stream->Flags.RemoteCloseFin ||
+        Stream->Flags.RemoteCloseReset ||
+        Stream->Flags.SentStopSending) {
+        return QUIC_STATUS_INVALID_STATE;
+    }
+
+    if (Stream->RecvBuffer.RecvMode != QUIC_RECV_BUF_MODE_APP_OWNED) {
+        //
+        // The stream switches to app-owned buffers on the first call, which is
+        // only possible if nothing has been received yet.
+        //
+        if (QuicRecvBufferGetTotalLength(&Stream->RecvBuffer) != 0) {
+            return QUIC_STATUS_INVALID_STATE;
+        }
+
+        QUIC_RECV_CHUNK* PreallocatedChunk = Stream->RecvBuffer.PreallocatedChunk;
+        QuicRecvBufferUninitialize(&Stream->RecvBuffer);
+        if (PreallocatedChunk != NULL) {
+            CxPlatPoolFree(
+                &Stream->Connection->Worker->DefaultReceiveBufferPool,
+                PreallocatedChunk);
+        }
+
+        Status =
+            QuicRecvBufferInitialize(
+                &Stream->RecvBuffer,
+                0,
+                0,
+                QUIC_RECV_BUF_MODE_APP_OWNED,
+                NULL);
+        CXPLAT_DBG_ASSERT(QUIC_SUCCEEDED(Status)); // Nothing to allocate.
+        Stream->Flags.ReceiveMultiple = FALSE;
+    }
+
+    Status = QuicRecvBufferProvideChunks(&Stream->RecvBuffer, Chunks);
+    if (QUIC_FAILED(Status)) {
+        return Status;
+    }
+
+    //
+    // Provided buffer space beyond the current flow control window can be
+    // immediately advertised to the peer.
+    //
+    const uint64_t BufferEndOffset =
+        Stream->RecvBuffer.BaseOffset + Stream->RecvBuffer.VirtualBufferLength;
+    if (BufferEndOffset > Stream->MaxAllowedRecvOffset) {
+        QuicTraceLogStreamVerbose(
+            UpdateFlowControl,
+            Stream,
+            "Updating flow control window");
+        Stream->MaxAllowedRecvOffset = BufferEndOffset;
+        QuicSendSetStreamSendFlag(
+            &Stream->Connection->Send,
+            Stream,
+            QUIC_STREAM_SEND_FLAG_MAX_DATA,
+            FALSE);
+    }
+
+    return QUIC_STATUS_SUCCESS;
+}
@@ -534,6 +534,152 @@ QuicStreamSendBufferRequest(
     return QUIC_STATUS_SUCCESS;
 }
 
+//
+// (Re)builds the send request index from the queue, with room for at least
+// all the currently queued requests. If the allocation fails, the index is
+// dropped and lookups walk the queue until the next rebuild.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicStreamSendRequestIndexRebuild(
+    _In_ QUIC_STREAM* Stream
+    )
+{
+    uint32_t NewCapacity = 2 * QUIC_SEND_REQUEST_INDEX_THRESHOLD;
+    while (NewCapacity < Stream->SendRequestCount) {
+        NewCapacity <<= 1;
+    }
+
+    if (Stream->SendRequestIndex != NULL) {
+        CXPLAT_FREE(Stream->SendRequestIndex, QUIC_POOL_SEND_REQUEST_INDEX);
+        Stream->SendRequestIndex = NULL;
+        Stream->SendRequestIndexCapacity = 0;
+    }
+
+    QUIC_SEND_REQUEST** NewIndex =
+        CXPLAT_ALLOC_NONPAGED(
+            NewCapacity * sizeof(QUIC_SEND_REQUEST*),
+            QUIC_POOL_SEND_REQUEST_INDEX);
+    if (NewIndex == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "send request index",
+            NewCapacity * sizeof(QUIC_SEND_REQUEST*));
+        return;
+    }
+
+    uint32_t i = 0;
+    for (QUIC_SEND_REQUEST* Req = Stream->SendRequests; Req != NULL; Req = Req->Next) {
+        CXPLAT_DBG_ASSERT(i < NewCapacity);
+        NewIndex[i++] = Req;
+    }
+    CXPLAT_DBG_ASSERT(i == Stream->SendRequestCount);
+
+    Stream->SendRequestIndex = NewIndex;
+    Stream->SendRequestIndexHead = 0;
+    Stream->SendRequestIndexCapacity = NewCapacity;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamSendRequestIndexAppend(
+    _In_ QUIC_STREAM* Stream,
+    _In_ QUIC_SEND_REQUEST* SendRequest
+    )
+{
+    CXPLAT_DBG_ASSERT(SendRequest->Next == NULL);
+    Stream->SendRequestCount++;
+
+    if (Stream->SendRequestIndex == NULL) {
+        if (Stream->SendRequestCount > QUIC_SEND_REQUEST_INDEX_THRESHOLD) {
+            QuicStreamSendRequestIndexRebuild(Stream);
+        }
+    } else if (Stream->SendRequestCount > Stream->SendRequestIndexCapacity) {
+        QuicStreamSendRequestIndexRebuild(Stream);
+    } else {
+        Stream->SendRequestIndex[
+            (Stream->SendRequestIndexHead + Stream->SendRequestCount - 1) &
+            (Stream->SendRequestIndexCapacity - 1)] = SendRequest;
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamSendRequestIndexRemoveFirst(
+    _In_ QUIC_STREAM* Stream
+    )
+{
+    CXPLAT_DBG_ASSERT(Stream->SendRequestCount > 0);
+    Stream->SendRequestCount--;
+
+    if (Stream->SendRequestIndex != NULL) {
+        if (Stream->SendRequestCount == 0) {
+            //
+            // Release the index along with the queue; it's rebuilt if the
+            // queue grows long again.
+            //
+            CXPLAT_FREE(Stream->SendRequestIndex, QUIC_POOL_SEND_REQUEST_INDEX);
+            Stream->SendRequestIndex = NULL;
+            Stream->SendRequestIndexHead = 0;
+            Stream->SendRequestIndexCapacity = 0;
+        } else {
+            Stream->SendRequestIndexHead =
+                (Stream->SendRequestIndexHead + 1) &
+                (Stream->SendRequestIndexCapacity - 1);
+        }
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_SEND_REQUEST*
+QuicStreamFindSendRequest(
+    _In_ const QUIC_STREAM* Stream,
+    _In_ uint64_t Offset
+    )
+{
+    CXPLAT_DBG_ASSERT(Stream->SendRequests != NULL);
+    CXPLAT_DBG_ASSERT(Offset >= Stream->SendRequests->StreamOffset);
+
+    //
+    // Use the bookmark if possible. Otherwise (e.g. for a retransmission of
+    // bytes before the bookmark), binary search the index for the last request
+    // starting at or before Offset, or walk the queue from the front if there
+    // is no index.
+    //
+    QUIC_SEND_REQUEST* Req;
+    if (Stream->SendBookmark != NULL &&
+        Stream->SendBookmark->StreamOffset <= Offset) {
+        Req = Stream->SendBookmark;
+    } else if (Stream->SendRequestIndex != NULL) {
+        const uint32_t Mask = Stream->SendRequestIndexCapacity - 1;
+        uint32_t Low = 0;
+        uint32_t High = Stream->SendRequestCount - 1;
+        while (Low < High) {
+            uint32_t Mid = Low + (High - Low + 1) / 2;
+            if (Stream->SendRequestIndex[(Stream->SendRequestIndexHead + Mid) & Mask]->StreamOffset <= Offset) {
+                Low = Mid;
+            } else {
+                High = Mid - 1;
+            }
+        }
+        Req = Stream->SendRequestIndex[(Stream->SendRequestIndexHead + Low) & Mask];
+    } else {
+        Req = Stream->SendRequests;
+    }
+
+    //
+    // Skip any requests ending at or before Offset, such as empty ones.
+    //
+    while (Req->StreamOffset + Req->TotalLength <= Offset) {
+        CXPLAT_DBG_ASSERT(Req->Next);
+        Req = Req->Next;
+    }
+
+    return Req;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicStreamEnqueueSendRequest(
@@ -580,6 +726,7 @@ QuicStreamEnqueueSendRequest(
 
     *Stream->SendRequestsTail = SendRequest;
     Stream->SendRequestsTail = &SendRequest->Next;
+    QuicStreamSendRequestIndexAppend(Stream, SendRequest);
 
     QuicTraceLogStreamVerbose(
         SendQueued,
@@ -696,22 +843,9 @@ QuicStreamCopyFromSendRequests(
     CXPLAT_DBG_ASSERT(Offset >= Stream->SendRequests->StreamOffset);
 
     //
-    // Find the send request containing the first byte, using the bookmark if
-    // possible (if the caller is requesting bytes before the bookmark, e.g.
-    // for a retransmission, then we have to do a full search).
+    // Find the send request containing the first byte.
     //
-    QUIC_SEND_REQUEST* Req;
-    if (Stream->SendBookmark != NULL &&
-        Stream->SendBookmark->StreamOffset <= Offset) {
-        Req = Stream->SendBookmark;
-    } else {
-        Req = Stream->SendRequests;
-    }
-    while (Req->StreamOffset + Req->TotalLength <= Offset) {
-        CXPLAT_DBG_ASSERT(Req->Next);
-        Req = Req->Next;
-    }
-
+    QUIC_SEND_REQUEST* Req = QuicStreamFindSendRequest(Stream, Offset);
     CXPLAT_DBG_ASSERT(Req);
 
     //
@@ -1108,7 +1242,7 @@ QuicStreamSendWrite(
         StreamWriteFrames,
         "[strm][%p] Writing frames to packet %llu",
         Stream,
-        Builder->Metadata->PacketId);
+        Builder->PacketId);
 
     if (Stream->SendFlags & QUIC_STREAM_SEND_FLAG_MAX_DATA) {
 
@@ -1519,6 +1653,7 @@ QuicStreamOnAck(
             if (Stream->SendRequests == NULL) {
                 Stream->SendRequestsTail = &Stream->SendRequests;
             }
+            QuicStreamSendRequestIndexRemoveFirst(Stream);
 
             QuicStreamCompleteSendRequest(Stream, Req, FALSE, TRUE);
         }
@@ -1640,6 +1775,7 @@ QuicStreamCancelRequests(
     while (Stream->SendRequests) {
         QUIC_SEND_REQUEST* Req = Stream->SendRequests;
         Stream->SendRequests = Req->Next;
+        QuicStreamSendRequestIndexRemoveFirst(Stream);
         QuicStreamCompleteSendRequest(Stream, Req, TRUE, TRUE);
     }
     Stream->SendRequestsTail = &Stream->SendRequests;
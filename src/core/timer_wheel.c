@@ -14,34 +14,41 @@ Abstract:
     need for the platform to provide any timer implementation, and providing a
     more efficient total timer solution.
 
-    The timer wheel consists of a few main parts:
-
-        Connections - Each connection maintains its own internal array of all
-        its timers. It only reports the soonest/next time to the timer wheel.
-        The timer wheel itself doesn't care about anything other than that value
-        from the connection.
-
-        Slots - This is a very simple hash table of time slots. Each slot holds
-        all connections with a next expiration time modulo the total slot count.
-
-        Slot Entry - Each slot is made up of a sorted, doubly-linked list of
-        connections.
-
-        Next Expiration - Along with all the connections in the timer wheel, the
-        timer wheel also explicitly keeps track of the next expiration time and
-        connection for quick next delay calculations.
-
-    With these parts, the timer wheel is able to support insertion, update and
-    removal of any number of timers (and their associated connection).
-
-    Insertion or update consists of getting the next expiration time from the
-    connection, calculating the correct slot and then doing an insert into the
-    slot's sorted list of connections. Additionally, the next expiration is
-    updated if the new timer is the soonest to expire.
-
-    Removal consists of removing the connection from the doubly-linked list and
-    updating the timer wheel's next expiration if this connection was currently
-    next to expire.
+    The timer wheel is a hierarchical, hashed timer wheel made up of a few main
+    parts:
+
+        Timers - Each connection has an entry per timer type. Every set timer
+        is in the timer wheel on its own, so setting or cancelling one doesn't
+        require the connection to find its earliest timer.
+
+        Ticks - Time is divided into ticks of 2^QUIC_TIMER_WHEEL_TICK_SHIFT us.
+        The timer wheel tracks the current tick, before which all timers have
+        already expired.
+
+        Levels - Each level has QUIC_TIMER_WHEEL_SLOT_COUNT slots, each an
+        unsorted, doubly-linked list of timers. A level 0 slot holds the timers
+        of a single tick, and a level N slot holds the timers of a whole level
+        N-1 turn. A timer is placed in the lowest level where its tick and the
+        current tick only differ in that level's slot index. A bitmap of
+        non-empty slots is kept per level.
+
+        Overflow - Timers too far in the future for the top level are kept in
+        a separate list.
+
+    Insertion only needs the XOR of the timer's tick with the current tick to
+    find its level and slot, and removal just unlinks the timer, so both are
+    O(1).
+
+    Advancing the timer wheel repeatedly finds the next non-empty slot (the
+    first set bit at or after the current slot, in the lowest non-empty level).
+    Timers in a level 0 slot expire. Timers in a higher level slot are lazily
+    cascaded, i.e. only re-placed into lower levels once the current tick
+    reaches that slot. Each timer cascades at most once per level.
+
+    The next expiration time given to the worker is exact for timers in level
+    0, and the start of the slot for timers in higher levels, at which point
+    they are cascaded and the next expiration time refined. Removing a timer
+    doesn't update it, so it may be earlier than needed, but never later.
 
 --*/
 
@@ -50,21 +57,44 @@ Abstract:
 #include "timer_wheel.c.clog.h"
 #endif
 
+#define QUIC_TIMER_WHEEL_SLOT_MASK  (QUIC_TIMER_WHEEL_SLOT_COUNT - 1)
+
 //
-// The initial count of slots in the timer wheel.
+// The number of tick bits covered by all the levels of the timer wheel.
 //
-#define QUIC_TIMER_WHEEL_INITIAL_SLOT_COUNT     32
+#define QUIC_TIMER_WHEEL_RANGE_BITS \
+    (QUIC_TIMER_WHEEL_LEVEL_BITS * QUIC_TIMER_WHEEL_LEVEL_COUNT)
+
+#define QUIC_TIMER_WHEEL_TOTAL_SLOT_COUNT \
+    (QUIC_TIMER_WHEEL_LEVEL_COUNT * QUIC_TIMER_WHEEL_SLOT_COUNT)
 
 //
-// On average, the max number of connections per slot.
+// Helper to get the connection that owns a timer.
 //
-#define QUIC_TIMER_WHEEL_MAX_LOAD_FACTOR    32
+#define QuicTimerWheelGetConnection(Timer) \
+    CXPLAT_CONTAINING_RECORD((Timer) - (Timer)->Index, QUIC_CONNECTION, Timers)
 
 //
-// Helper to get the slot index for a given time.
+// Returns the index of the least significant set bit. Mask must not be 0.
 //
-#define TIME_TO_SLOT_INDEX(TimerWheel, TimeUs) \
-    ((US_TO_MS(TimeUs) / 1000) % (TimerWheel)->SlotCount)
+static
+uint32_t
+QuicTimerWheelFindFirstSlot(
+    _In_ uint64_t Mask
+    )
+{
+    CXPLAT_DBG_ASSERT(Mask != 0);
+#if defined(_MSC_VER)
+    unsigned long Index;
+    if (_BitScanForward(&Index, (unsigned long)Mask)) {
+        return (uint32_t)Index;
+    }
+    _BitScanForward(&Index, (unsigned long)(Mask >> 32));
+    return (uint32_t)Index + 32;
+#else
+    return (uint32_t)__builtin_ctzll(Mask);
+#endif
+}
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
@@ -74,19 +104,21 @@ QuicTimerWheelInitialize(
 {
     TimerWheel->NextExpirationTime = UINT64_MAX;
     TimerWheel->ConnectionCount = 0;
-    TimerWheel->NextConnection = NULL;
-    TimerWheel->SlotCount = QUIC_TIMER_WHEEL_INITIAL_SLOT_COUNT;
+    TimerWheel->TimerCount = 0;
+    TimerWheel->CurrentTick = CxPlatTimeUs64() >> QUIC_TIMER_WHEEL_TICK_SHIFT;
+    CxPlatZeroMemory(TimerWheel->OccupiedSlots, sizeof(TimerWheel->OccupiedSlots));
+    CxPlatListInitializeHead(&TimerWheel->Overflow);
     TimerWheel->Slots =
-        CXPLAT_ALLOC_NONPAGED(QUIC_TIMER_WHEEL_INITIAL_SLOT_COUNT * sizeof(CXPLAT_LIST_ENTRY), QUIC_POOL_TIMERWHEEL);
+        CXPLAT_ALLOC_NONPAGED(QUIC_TIMER_WHEEL_TOTAL_SLOT_COUNT * sizeof(CXPLAT_LIST_ENTRY), QUIC_POOL_TIMERWHEEL);
     if (TimerWheel->Slots == NULL) {
         QuicTraceEvent(
             AllocFailure,
             "Allocation of '%s' failed. (%llu bytes)", "timerwheel slots",
-            QUIC_TIMER_WHEEL_INITIAL_SLOT_COUNT * sizeof(CXPLAT_LIST_ENTRY));
+            QUIC_TIMER_WHEEL_TOTAL_SLOT_COUNT * sizeof(CXPLAT_LIST_ENTRY));
         return QUIC_STATUS_OUT_OF_MEMORY;
     }
 
-    for (uint32_t i = 0; i < TimerWheel->SlotCount; ++i) {
+    for (uint32_t i = 0; i < QUIC_TIMER_WHEEL_TOTAL_SLOT_COUNT; ++i) {
         CxPlatListInitializeHead(&TimerWheel->Slots[i]);
     }
 
@@ -100,12 +132,15 @@ QuicTimerWheelUninitialize(
     )
 {
     if (TimerWheel->Slots != NULL) {
-        for (uint32_t i = 0; i < TimerWheel->SlotCount; ++i) {
-            CXPLAT_LIST_ENTRY* ListHead = &TimerWheel->Slots[i];
+        for (uint32_t i = 0; i <= QUIC_TIMER_WHEEL_TOTAL_SLOT_COUNT; ++i) {
+            CXPLAT_LIST_ENTRY* ListHead =
+                i == QUIC_TIMER_WHEEL_TOTAL_SLOT_COUNT ?
+                    &TimerWheel->Overflow : &TimerWheel->Slots[i];
             CXPLAT_LIST_ENTRY* Entry = ListHead->Flink;
             while (Entry != ListHead) {
                 QUIC_CONNECTION* Connection =
-                    CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONNECTION, TimerLink);
+                    QuicTimerWheelGetConnection(
+                        CXPLAT_CONTAINING_RECORD(Entry, QUIC_TIMER_WHEEL_ENTRY, Link));
                 QuicTraceLogConnWarning(
                     StillInTimerWheel,
                     Connection,
@@ -113,103 +148,93 @@ QuicTimerWheelUninitialize(
                 CXPLAT_DBG_ASSERT(!Connection);
                 Entry = Entry->Flink;
             }
-            CXPLAT_TEL_ASSERT(CxPlatListIsEmpty(&TimerWheel->Slots[i]));
+            CXPLAT_TEL_ASSERT(CxPlatListIsEmpty(ListHead));
         }
         CXPLAT_TEL_ASSERT(TimerWheel->ConnectionCount == 0);
-        CXPLAT_TEL_ASSERT(TimerWheel->NextConnection == NULL);
-        CXPLAT_TEL_ASSERT(TimerWheel->NextExpirationTime == UINT64_MAX);
+        CXPLAT_TEL_ASSERT(TimerWheel->TimerCount == 0);
 
         CXPLAT_FREE(TimerWheel->Slots, QUIC_POOL_TIMERWHEEL);
     }
 }
 
+//
+// Links the timer into the slot for its expiration time, relative to the
+// current tick.
+//
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
-QuicTimerWheelResize(
-    _Inout_ QUIC_TIMER_WHEEL* TimerWheel
+QuicTimerWheelPlace(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _Inout_ QUIC_TIMER_WHEEL_ENTRY* Timer
     )
 {
-    uint32_t NewSlotCount = TimerWheel->SlotCount * 2;
-    if (NewSlotCount <= TimerWheel->SlotCount) {
-        //
-        // Max size has been reached.
-        //
-        return;
+    uint64_t Tick = Timer->ExpirationTime >> QUIC_TIMER_WHEEL_TICK_SHIFT;
+    if (Tick < TimerWheel->CurrentTick) {
+        Tick = TimerWheel->CurrentTick; // Already expired.
     }
 
-    CXPLAT_LIST_ENTRY* NewSlots =
-        CXPLAT_ALLOC_NONPAGED(NewSlotCount * sizeof(CXPLAT_LIST_ENTRY), QUIC_POOL_TIMERWHEEL);
-    if (NewSlots == NULL) {
-        QuicTraceEvent(
-            AllocFailure,
-            "Allocation of '%s' failed. (%llu bytes)", "timerwheel slots (realloc)",
-            NewSlotCount * sizeof(CXPLAT_LIST_ENTRY));
+    const uint64_t Difference = Tick ^ TimerWheel->CurrentTick;
+    if ((Difference >> QUIC_TIMER_WHEEL_RANGE_BITS) != 0) {
+        Timer->Slot = QUIC_TIMER_WHEEL_OVERFLOW_SLOT;
+        CxPlatListInsertTail(&TimerWheel->Overflow, &Timer->Link);
         return;
     }
 
-    QuicTraceLogVerbose(
-        TimerWheelResize,
-        "[time][%p] Resizing timer wheel (new slot count = %u).",
-        TimerWheel,
-        NewSlotCount);
-
-    for (uint32_t i = 0; i < NewSlotCount; ++i) {
-        CxPlatListInitializeHead(&NewSlots[i]);
+    uint32_t Level = 0;
+    while ((Difference >> (QUIC_TIMER_WHEEL_LEVEL_BITS * (Level + 1))) != 0) {
+        Level++;
     }
 
-    uint32_t OldSlotCount = TimerWheel->SlotCount;
-    CXPLAT_LIST_ENTRY* OldSlots = TimerWheel->Slots;
-
-    TimerWheel->SlotCount = NewSlotCount;
-    TimerWheel->Slots = NewSlots;
+    const uint32_t Index =
+        (uint32_t)(Tick >> (QUIC_TIMER_WHEEL_LEVEL_BITS * Level)) & QUIC_TIMER_WHEEL_SLOT_MASK;
+    Timer->Slot = (uint16_t)(Level * QUIC_TIMER_WHEEL_SLOT_COUNT + Index);
+    CxPlatListInsertTail(&TimerWheel->Slots[Timer->Slot], &Timer->Link);
+    TimerWheel->OccupiedSlots[Level] |= 1ull << Index;
+}
 
-    for (uint32_t i = 0; i < OldSlotCount; ++i) {
+//
+// Finds the next non-empty slot and the tick it starts at. Returns FALSE if
+// all the levels are empty.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicTimerWheelFindNextSlot(
+    _In_ const QUIC_TIMER_WHEEL* TimerWheel,
+    _Out_ uint32_t* Level,
+    _Out_ uint32_t* Index,
+    _Out_ uint64_t* StartTick
+    )
+{
+    for (uint32_t i = 0; i < QUIC_TIMER_WHEEL_LEVEL_COUNT; ++i) {
+        const uint32_t Shift = QUIC_TIMER_WHEEL_LEVEL_BITS * i;
+#if DEBUG
         //
-        // Iterate through each old slot, remove all connections and add them
-        // to the new slots.
+        // All timers in a level are in or after the current slot; any in the
+        // current slot of an upper level would have been cascaded already.
         //
-        while (!CxPlatListIsEmpty(&OldSlots[i])) {
-            QUIC_CONNECTION* Connection =
-                CXPLAT_CONTAINING_RECORD(
-                    CxPlatListRemoveHead(&OldSlots[i]),
-                    QUIC_CONNECTION,
-                    TimerLink);
-            uint64_t ExpirationTime = Connection->EarliestExpirationTime;
-            CXPLAT_DBG_ASSERT(TimerWheel->SlotCount != 0);
-            uint32_t SlotIndex = TIME_TO_SLOT_INDEX(TimerWheel, ExpirationTime);
-
-            //
-            // Insert the connection into the slot, in the correct order. We search
-            // the slot's list in reverse order, with the assumption that most new
-            // timers will on average be later than existing ones.
-            //
-            CXPLAT_LIST_ENTRY* ListHead = &TimerWheel->Slots[SlotIndex];
-            CXPLAT_LIST_ENTRY* Entry = ListHead->Blink;
-
-            while (Entry != ListHead) {
-                QUIC_CONNECTION* ConnectionEntry =
-                    CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONNECTION, TimerLink);
-                uint64_t EntryExpirationTime = ConnectionEntry->EarliestExpirationTime;
-
-                if (ExpirationTime > EntryExpirationTime) {
-                    break;
-                }
-
-                Entry = Entry->Blink;
-            }
+        const uint32_t CurrentIndex =
+            (uint32_t)(TimerWheel->CurrentTick >> Shift) & QUIC_TIMER_WHEEL_SLOT_MASK;
+        CXPLAT_DBG_ASSERT(
+            (TimerWheel->OccupiedSlots[i] & ((1ull << CurrentIndex) - 1)) == 0);
+        CXPLAT_DBG_ASSERT(
+            i == 0 || (TimerWheel->OccupiedSlots[i] & (1ull << CurrentIndex)) == 0);
+#endif
 
-            //
-            // Insert after the current entry.
-            //
-            CxPlatListInsertHead(Entry, &Connection->TimerLink);
+        if (TimerWheel->OccupiedSlots[i] != 0) {
+            *Level = i;
+            *Index = QuicTimerWheelFindFirstSlot(TimerWheel->OccupiedSlots[i]);
+            *StartTick =
+                ((TimerWheel->CurrentTick >> (Shift + QUIC_TIMER_WHEEL_LEVEL_BITS))
+                    << (Shift + QUIC_TIMER_WHEEL_LEVEL_BITS)) |
+                ((uint64_t)*Index << Shift);
+            return TRUE;
         }
     }
-    CXPLAT_FREE(OldSlots, QUIC_POOL_TIMERWHEEL);
+    return FALSE;
 }
 
 //
-// Called to update NextConnection and NextExpirationTime when the
-// current NextConnection is updated.
+// Recalculates NextExpirationTime.
 //
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
@@ -218,28 +243,41 @@ QuicTimerWheelUpdate(
     )
 {
     TimerWheel->NextExpirationTime = UINT64_MAX;
-    TimerWheel->NextConnection = NULL;
+    QUIC_TIMER_WHEEL_ENTRY* NextTimer = NULL;
 
-    //
-    // Loop over the slots to find the connection with the earliest
-    // expiration time.
-    //
-    for (uint32_t i = 0; i < TimerWheel->SlotCount; ++i) {
-        if (!CxPlatListIsEmpty(&TimerWheel->Slots[i])) {
-            QUIC_CONNECTION* ConnectionEntry =
-                CXPLAT_CONTAINING_RECORD(
-                    TimerWheel->Slots[i].Flink,
-                    QUIC_CONNECTION,
-                    TimerLink);
-            uint64_t EntryExpirationTime = ConnectionEntry->EarliestExpirationTime;
-            if (EntryExpirationTime < TimerWheel->NextExpirationTime) {
-                TimerWheel->NextExpirationTime = EntryExpirationTime;
-                TimerWheel->NextConnection = ConnectionEntry;
+    uint32_t Level, Index;
+    uint64_t StartTick;
+    if (QuicTimerWheelFindNextSlot(TimerWheel, &Level, &Index, &StartTick)) {
+        if (Level == 0) {
+            //
+            // Timers in a level 0 slot all expire within the same tick, so
+            // finding the exact next expiration is a short search.
+            //
+            CXPLAT_LIST_ENTRY* ListHead = &TimerWheel->Slots[Index];
+            for (CXPLAT_LIST_ENTRY* Entry = ListHead->Flink;
+                Entry != ListHead;
+                Entry = Entry->Flink) {
+                QUIC_TIMER_WHEEL_ENTRY* Timer =
+                    CXPLAT_CONTAINING_RECORD(Entry, QUIC_TIMER_WHEEL_ENTRY, Link);
+                if (Timer->ExpirationTime < TimerWheel->NextExpirationTime) {
+                    TimerWheel->NextExpirationTime = Timer->ExpirationTime;
+                    NextTimer = Timer;
+                }
             }
+        } else {
+            //
+            // Wake up when the slot needs to be cascaded.
+            //
+            TimerWheel->NextExpirationTime = StartTick << QUIC_TIMER_WHEEL_TICK_SHIFT;
         }
+
+    } else if (!CxPlatListIsEmpty(&TimerWheel->Overflow)) {
+        TimerWheel->NextExpirationTime =
+            ((TimerWheel->CurrentTick >> QUIC_TIMER_WHEEL_RANGE_BITS) + 1)
+                << (QUIC_TIMER_WHEEL_RANGE_BITS + QUIC_TIMER_WHEEL_TICK_SHIFT);
     }
 
-    if (TimerWheel->NextConnection == NULL) {
+    if (TimerWheel->NextExpirationTime == UINT64_MAX) {
         QuicTraceLogVerbose(
             TimerWheelNextExpirationNull,
             "[time][%p] Next Expiration = {NULL}.",
@@ -250,148 +288,233 @@ QuicTimerWheelUpdate(
             "[time][%p] Next Expiration = {%llu, %p}.",
             TimerWheel,
             TimerWheel->NextExpirationTime,
-            TimerWheel->NextConnection);
+            NextTimer);
     }
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
-QuicTimerWheelRemoveConnection(
+QuicTimerWheelInsert(
     _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
-    _Inout_ QUIC_CONNECTION* Connection
+    _Inout_ QUIC_TIMER_WHEEL_ENTRY* Timer
     )
 {
-    if (Connection->TimerLink.Flink != NULL) {
-        //
-        // If the connection was in the timer wheel, remove its entry in the
-        // doubly-link list.
-        //
-        QuicTraceLogVerbose(
-            TimerWheelRemoveConnection,
-            "[time][%p] Removing Connection %p.",
-            TimerWheel,
-            Connection);
-        CxPlatListEntryRemove(&Connection->TimerLink);
-        Connection->TimerLink.Flink = NULL;
-        TimerWheel->ConnectionCount--;
+    CXPLAT_DBG_ASSERT(Timer->Link.Flink == NULL);
+    CXPLAT_DBG_ASSERT(Timer->ExpirationTime != UINT64_MAX);
 
-        if (Connection == TimerWheel->NextConnection) {
-            QuicTimerWheelUpdate(TimerWheel);
-        }
+    QuicTimerWheelPlace(TimerWheel, Timer);
+    TimerWheel->TimerCount++;
 
-        QuicConnRelease(Connection, QUIC_CONN_REF_TIMER_WHEEL);
+    if (Timer->ExpirationTime < TimerWheel->NextExpirationTime) {
+        TimerWheel->NextExpirationTime = Timer->ExpirationTime;
+        QuicTraceLogVerbose(
+            TimerWheelNextExpiration,
+            "[time][%p] Next Expiration = {%llu, %p}.",
+            TimerWheel,
+            Timer->ExpirationTime,
+            Timer);
     }
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
-QuicTimerWheelUpdateConnection(
+QuicTimerWheelRemove(
     _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
-    _Inout_ QUIC_CONNECTION* Connection
+    _Inout_ QUIC_TIMER_WHEEL_ENTRY* Timer
     )
 {
-    uint64_t ExpirationTime = Connection->EarliestExpirationTime;
+    CXPLAT_DBG_ASSERT(Timer->Link.Flink != NULL);
 
-    if (Connection->TimerLink.Flink != NULL) {
+    if (CxPlatListEntryRemove(&Timer->Link) &&
+        Timer->Slot != QUIC_TIMER_WHEEL_OVERFLOW_SLOT) {
         //
-        // Connection is already in the timer wheel, so remove it first.
+        // That was the last timer in the slot.
         //
-        CxPlatListEntryRemove(&Connection->TimerLink);
+        TimerWheel->OccupiedSlots[Timer->Slot / QUIC_TIMER_WHEEL_SLOT_COUNT] &=
+            ~(1ull << (Timer->Slot & QUIC_TIMER_WHEEL_SLOT_MASK));
+    }
+    Timer->Link.Flink = NULL;
+    TimerWheel->TimerCount--;
+
+    //
+    // NextExpirationTime is intentionally left as is. At worst, the worker
+    // wakes up early and recalculates it then.
+    //
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicTimerWheelAdvance(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _In_ uint64_t TimeNow,
+    _Inout_ CXPLAT_LIST_ENTRY* OutputListHead
+    )
+{
+    const uint64_t NowTick = TimeNow >> QUIC_TIMER_WHEEL_TICK_SHIFT;
+    CXPLAT_LIST_ENTRY Timers;
+    CxPlatListInitializeHead(&Timers);
+
+    for (;;) {
+        uint32_t Level, Index;
+        uint64_t StartTick;
+        if (!QuicTimerWheelFindNextSlot(TimerWheel, &Level, &Index, &StartTick)) {
+            if (CxPlatListIsEmpty(&TimerWheel->Overflow)) {
+                break;
+            }
 
-        if (ExpirationTime == UINT64_MAX || Connection->State.ShutdownComplete) {
             //
-            // No more timers left, go ahead and invalidate its link.
+            // Nothing left in the wheel, so move on to the next turn of the
+            // top level and pull back in any overflow timers that now fit.
             //
-            Connection->TimerLink.Flink = NULL;
-            QuicTraceLogVerbose(
-                TimerWheelRemoveConnection,
-                "[time][%p] Removing Connection %p.",
-                TimerWheel,
-                Connection);
-
-            if (Connection == TimerWheel->NextConnection) {
-                QuicTimerWheelUpdate(TimerWheel);
+            StartTick =
+                ((TimerWheel->CurrentTick >> QUIC_TIMER_WHEEL_RANGE_BITS) + 1)
+                    << QUIC_TIMER_WHEEL_RANGE_BITS;
+            if (StartTick > NowTick) {
+                break;
+            }
+            TimerWheel->CurrentTick = StartTick;
+            CxPlatListMoveItems(&TimerWheel->Overflow, &Timers);
+            while (!CxPlatListIsEmpty(&Timers)) {
+                QuicTimerWheelPlace(
+                    TimerWheel,
+                    CXPLAT_CONTAINING_RECORD(
+                        CxPlatListRemoveHead(&Timers), QUIC_TIMER_WHEEL_ENTRY, Link));
             }
+            continue;
+        }
 
-            QuicConnRelease(Connection, QUIC_CONN_REF_TIMER_WHEEL);
-            TimerWheel->ConnectionCount--;
-            return; // Nothing else to do.
+        if (StartTick > NowTick) {
+            break;
         }
 
-    } else if (ExpirationTime != UINT64_MAX && !Connection->State.ShutdownComplete) {
-        //
-        // It wasn't in the wheel already, so we must be adding it to the wheel.
-        //
-        TimerWheel->ConnectionCount++;
-        QuicConnAddRef(Connection, QUIC_CONN_REF_TIMER_WHEEL);
+        TimerWheel->CurrentTick = StartTick;
+        TimerWheel->OccupiedSlots[Level] &= ~(1ull << Index);
+        CxPlatListMoveItems(
+            &TimerWheel->Slots[Level * QUIC_TIMER_WHEEL_SLOT_COUNT + Index], &Timers);
 
-    } else {
-        return; // Ignore
+        while (!CxPlatListIsEmpty(&Timers)) {
+            QUIC_TIMER_WHEEL_ENTRY* Timer =
+                CXPLAT_CONTAINING_RECORD(
+                    CxPlatListRemoveHead(&Timers), QUIC_TIMER_WHEEL_ENTRY, Link);
+            if (Level == 0 && Timer->ExpirationTime <= TimeNow) {
+                CxPlatListInsertTail(OutputListHead, &Timer->Link);
+                TimerWheel->TimerCount--;
+            } else {
+                //
+                // Cascade the timer into a lower level, or, for level 0, put
+                // it back as it expires later in the current tick.
+                //
+                QuicTimerWheelPlace(TimerWheel, Timer);
+            }
+        }
+
+        if (Level == 0 && (TimerWheel->OccupiedSlots[0] & (1ull << Index))) {
+            CXPLAT_DBG_ASSERT(StartTick == NowTick);
+            break;
+        }
     }
 
-    //
-    // We are adding/updating the connection in the timer wheel.
-    //
+    if (NowTick > TimerWheel->CurrentTick) {
+        TimerWheel->CurrentTick = NowTick;
+    }
 
-    CXPLAT_DBG_ASSERT(ExpirationTime != UINT64_MAX);
-    CXPLAT_DBG_ASSERT(!Connection->State.ShutdownComplete);
-    CXPLAT_DBG_ASSERT(TimerWheel->SlotCount != 0);
-    uint32_t SlotIndex = TIME_TO_SLOT_INDEX(TimerWheel, ExpirationTime);
+    QuicTimerWheelUpdate(TimerWheel);
+}
 
-    //
-    // Insert the connection into the slot, in the correct order. We search
-    // the slot's list in reverse order, with the assumption that most new
-    // timers will on average be later than existing ones.
-    //
-    CXPLAT_LIST_ENTRY* ListHead = &TimerWheel->Slots[SlotIndex];
-    CXPLAT_LIST_ENTRY* Entry = ListHead->Blink;
+//
+// Releases the timer wheel's hold on the connection once it has no more
+// timers in the timer wheel.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicTimerWheelReleaseConnectionTimer(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _Inout_ QUIC_CONNECTION* Connection
+    )
+{
+    CXPLAT_DBG_ASSERT(Connection->ActiveTimerCount != 0);
+    if (--Connection->ActiveTimerCount == 0) {
+        TimerWheel->ConnectionCount--;
+        QuicConnRelease(Connection, QUIC_CONN_REF_TIMER_WHEEL);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicTimerWheelRemoveConnection(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _Inout_ QUIC_CONNECTION* Connection
+    )
+{
+    if (Connection->ActiveTimerCount == 0) {
+        return;
+    }
 
-    while (Entry != ListHead) {
-        QUIC_CONNECTION* ConnectionEntry =
-            CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONNECTION, TimerLink);
-        uint64_t EntryExpirationTime = ConnectionEntry->EarliestExpirationTime;
+    QuicTraceLogVerbose(
+        TimerWheelRemoveConnection,
+        "[time][%p] Removing Connection %p.",
+        TimerWheel,
+        Connection);
 
-        if (ExpirationTime > EntryExpirationTime) {
-            break;
+    for (uint32_t i = 0; i < QUIC_CONN_TIMER_COUNT; ++i) {
+        if (Connection->Timers[i].Link.Flink != NULL) {
+            QuicTimerWheelRemove(TimerWheel, &Connection->Timers[i]);
+            QuicTimerWheelReleaseConnectionTimer(TimerWheel, Connection);
+        }
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicTimerWheelUpdateConnectionTimer(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _Inout_ QUIC_CONNECTION* Connection,
+    _Inout_ QUIC_TIMER_WHEEL_ENTRY* Timer
+    )
+{
+    if (Timer->Link.Flink != NULL) {
+        //
+        // Timer is already in the timer wheel, so remove it first.
+        //
+        QuicTimerWheelRemove(TimerWheel, Timer);
+
+        if (Timer->ExpirationTime == UINT64_MAX || Connection->State.ShutdownComplete) {
+            QuicTimerWheelReleaseConnectionTimer(TimerWheel, Connection);
+            return; // Nothing else to do.
+        }
+
+    } else if (Timer->ExpirationTime != UINT64_MAX && !Connection->State.ShutdownComplete) {
+        //
+        // It wasn't in the wheel already, so we must be adding it to the wheel.
+        //
+        if (Connection->ActiveTimerCount++ == 0) {
+            TimerWheel->ConnectionCount++;
+            QuicConnAddRef(Connection, QUIC_CONN_REF_TIMER_WHEEL);
         }
 
-        Entry = Entry->Blink;
+    } else {
+        return; // Ignore
     }
 
-    //
-    // Insert after the current entry.
-    //
-    CxPlatListInsertHead(Entry, &Connection->TimerLink);
+    QuicTimerWheelInsert(TimerWheel, Timer);
+}
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicTimerWheelUpdateConnection(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _Inout_ QUIC_CONNECTION* Connection
+    )
+{
     QuicTraceLogVerbose(
         TimerWheelUpdateConnection,
         "[time][%p] Updating Connection %p.",
         TimerWheel,
         Connection);
 
-    //
-    // Make sure the next expiration time/connection is still correct.
-    //
-    if (ExpirationTime < TimerWheel->NextExpirationTime) {
-        TimerWheel->NextExpirationTime = ExpirationTime;
-        TimerWheel->NextConnection = Connection;
-        QuicTraceLogVerbose(
-            TimerWheelNextExpiration,
-            "[time][%p] Next Expiration = {%llu, %p}.",
-            TimerWheel,
-            ExpirationTime,
-            Connection);
-    } else if (Connection == TimerWheel->NextConnection) {
-        QuicTimerWheelUpdate(TimerWheel);
-    }
-
-    //
-    // Resize the timer wheel if we have too many connections for the
-    // current size.
-    //
-    if (TimerWheel->ConnectionCount >
-        TimerWheel->SlotCount * QUIC_TIMER_WHEEL_MAX_LOAD_FACTOR) {
-        QuicTimerWheelResize(TimerWheel);
+    for (uint32_t i = 0; i < QUIC_CONN_TIMER_COUNT; ++i) {
+        QuicTimerWheelUpdateConnectionTimer(
+            TimerWheel, Connection, &Connection->Timers[i]);
     }
 }
 
@@ -403,33 +526,25 @@ QuicTimerWheelGetExpired(
     _Inout_ CXPLAT_LIST_ENTRY* OutputListHead
     )
 {
+    CXPLAT_LIST_ENTRY ExpiredTimers;
+    CxPlatListInitializeHead(&ExpiredTimers);
+    QuicTimerWheelAdvance(TimerWheel, TimeNow, &ExpiredTimers);
+
     //
-    // Iterate through every slot to find all the connections that now have
-    // expired timers.
+    // Collect the connections of all the expired timers. The timers keep their
+    // expiration time so the connection can tell which ones expired.
     //
-    BOOLEAN NeedsUpdate = FALSE;
-    for (uint32_t i = 0; i < TimerWheel->SlotCount; ++i) {
-        CXPLAT_LIST_ENTRY* ListHead = &TimerWheel->Slots[i];
-        CXPLAT_LIST_ENTRY* Entry = ListHead->Flink;
-        while (Entry != ListHead) {
-            QUIC_CONNECTION* ConnectionEntry =
-                CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONNECTION, TimerLink);
-            uint64_t EntryExpirationTime = ConnectionEntry->EarliestExpirationTime;
-            if (EntryExpirationTime > TimeNow) {
-                break;
-            }
-            Entry = Entry->Flink;
-            CxPlatListEntryRemove(&ConnectionEntry->TimerLink);
-            CxPlatListInsertTail(OutputListHead, &ConnectionEntry->TimerLink);
-            if (ConnectionEntry == TimerWheel->NextConnection) {
-                NeedsUpdate = TRUE;
-            }
-            QuicConnAddRef(ConnectionEntry, QUIC_CONN_REF_WORKER);
-            QuicConnRelease(ConnectionEntry, QUIC_CONN_REF_TIMER_WHEEL);
-            TimerWheel->ConnectionCount--;
+    while (!CxPlatListIsEmpty(&ExpiredTimers)) {
+        QUIC_TIMER_WHEEL_ENTRY* Timer =
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&ExpiredTimers), QUIC_TIMER_WHEEL_ENTRY, Link);
+        Timer->Link.Flink = NULL;
+
+        QUIC_CONNECTION* Connection = QuicTimerWheelGetConnection(Timer);
+        if (Connection->TimerLink.Flink == NULL) {
+            CxPlatListInsertTail(OutputListHead, &Connection->TimerLink);
+            QuicConnAddRef(Connection, QUIC_CONN_REF_WORKER);
         }
-    }
-    if (NeedsUpdate) {
-        QuicTimerWheelUpdate(TimerWheel);
+        QuicTimerWheelReleaseConnectionTimer(TimerWheel, Connection);
     }
 }
@@ -5,12 +5,60 @@
 
 --*/
 
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
 typedef struct QUIC_CONNECTION QUIC_CONNECTION;
 
+//
+// The timer wheel is made up of QUIC_TIMER_WHEEL_LEVEL_COUNT levels, each with
+// QUIC_TIMER_WHEEL_SLOT_COUNT slots. A level 0 slot covers a single tick and
+// each slot in level N covers a whole level N-1 wheel turn.
+//
+#define QUIC_TIMER_WHEEL_TICK_SHIFT         10  // 1 tick = 1024 us
+#define QUIC_TIMER_WHEEL_LEVEL_BITS         6
+#define QUIC_TIMER_WHEEL_SLOT_COUNT         (1 << QUIC_TIMER_WHEEL_LEVEL_BITS)
+#define QUIC_TIMER_WHEEL_LEVEL_COUNT        5   // 2^30 ticks (~12 days)
+#define QUIC_TIMER_WHEEL_OVERFLOW_SLOT      0xFFFF
+
+//
+// A single timer in the timer wheel.
+//
+typedef struct QUIC_TIMER_WHEEL_ENTRY {
+
+    //
+    // Link in the timer wheel slot's list. Flink is NULL when the entry is not
+    // in the timer wheel.
+    //
+    CXPLAT_LIST_ENTRY Link;
+
+    //
+    // Expiration time (absolute time in us). UINT64_MAX indicates the timer is
+    // not set.
+    //
+    uint64_t ExpirationTime;
+
+    //
+    // The slot (Level * QUIC_TIMER_WHEEL_SLOT_COUNT + Index) the entry is in,
+    // or QUIC_TIMER_WHEEL_OVERFLOW_SLOT.
+    //
+    uint16_t Slot;
+
+    //
+    // The index of this entry in its owner's array of timers.
+    //
+    uint8_t Index;
+
+} QUIC_TIMER_WHEEL_ENTRY;
+
 typedef struct QUIC_TIMER_WHEEL {
 
     //
-    // The expiration time (in us) for the next timer in the timer wheel.
+    // The expiration time (in us) for the next timer in the timer wheel. This
+    // is never later than the actual next expiration, but may be earlier when
+    // the next timer is in an upper level (i.e. needs to be cascaded first) or
+    // after the next timer was removed.
     //
     uint64_t NextExpirationTime;
 
@@ -20,20 +68,32 @@ typedef struct QUIC_TIMER_WHEEL {
     uint64_t ConnectionCount;
 
     //
-    // The connection with the timer that expires next.
+    // Total number of timers in the timer wheel.
+    //
+    uint64_t TimerCount;
+
+    //
+    // The tick the timer wheel has been advanced to. All timers in earlier
+    // ticks have been expired.
     //
-    QUIC_CONNECTION* NextConnection;
+    uint64_t CurrentTick;
 
     //
-    // The number of slots in the Slots array.
+    // Bitmap of the non-empty slots in each level.
     //
-    uint32_t SlotCount;
+    uint64_t OccupiedSlots[QUIC_TIMER_WHEEL_LEVEL_COUNT];
 
     //
-    // An array of slots in the timer wheel.
+    // An array of QUIC_TIMER_WHEEL_LEVEL_COUNT * QUIC_TIMER_WHEEL_SLOT_COUNT
+    // slots.
     //
     CXPLAT_LIST_ENTRY* Slots;
 
+    //
+    // Timers beyond the range of the top level.
+    //
+    CXPLAT_LIST_ENTRY Overflow;
+
 } QUIC_TIMER_WHEEL;
 
 //
@@ -55,7 +115,40 @@ QuicTimerWheelUninitialize(
     );
 
 //
-// Removes the connection from the timer wheel.
+// Inserts the timer into the timer wheel, based on its ExpirationTime. The
+// timer must not already be in the timer wheel.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicTimerWheelInsert(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _Inout_ QUIC_TIMER_WHEEL_ENTRY* Timer
+    );
+
+//
+// Removes the timer from the timer wheel.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicTimerWheelRemove(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _Inout_ QUIC_TIMER_WHEEL_ENTRY* Timer
+    );
+
+//
+// Advances the timer wheel to the current time, moving all the expired timers
+// to the output list.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicTimerWheelAdvance(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _In_ uint64_t TimeNow,
+    _Inout_ CXPLAT_LIST_ENTRY* OutputListHead
+    );
+
+//
+// Removes all the connection's timers from the timer wheel.
 //
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
@@ -65,8 +158,20 @@ QuicTimerWheelRemoveConnection(
     );
 
 //
-// Inserts, removes, or moves the connection in the timer wheel. Called
-// when the connection's timer state changes.
+// Inserts, moves or removes one of the connection's timers in the timer wheel.
+// Called when the timer's expiration time changes.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicTimerWheelUpdateConnectionTimer(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _Inout_ QUIC_CONNECTION* Connection,
+    _Inout_ QUIC_TIMER_WHEEL_ENTRY* Timer
+    );
+
+//
+// Inserts all of the connection's set timers into the timer wheel. Called when
+// the connection moves to a new worker.
 //
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
@@ -76,7 +181,7 @@ QuicTimerWheelUpdateConnection(
     );
 
 //
-// Gets the next connection with an expired timer.
+// Gets all the connections with expired timers.
 //
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
@@ -85,3 +190,7 @@ QuicTimerWheelGetExpired(
     _In_ uint64_t TimeNow,
     _Inout_ CXPLAT_LIST_ENTRY* ListHead
     );
+
+#if defined(__cplusplus)
+}
+#endif
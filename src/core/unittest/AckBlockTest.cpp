@@ -0,0 +1,293 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test and microbenchmarks for tracking received packet numbers and
+    encoding and decoding them as ACK frame blocks.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "AckBlockTest.cpp.clog.h"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <vector>
+
+struct SmartAckRange {
+    QUIC_RANGE Range;
+    SmartAckRange(uint32_t MaxAllocSize) {
+        QuicRangeInitialize(MaxAllocSize, &Range);
+    }
+    ~SmartAckRange() {
+        QuicRangeUninitialize(&Range);
+    }
+};
+
+static
+void
+ExpectEqualRanges(
+    const QUIC_RANGE* Expected,
+    const QUIC_RANGE* Actual
+    )
+{
+    ASSERT_EQ(QuicRangeSize(Expected), QuicRangeSize(Actual));
+    for (uint32_t i = 0; i < QuicRangeSize(Expected); ++i) {
+        ASSERT_EQ(QuicRangeGet(Expected, i)->Low, QuicRangeGet(Actual, i)->Low);
+        ASSERT_EQ(QuicRangeGet(Expected, i)->Count, QuicRangeGet(Actual, i)->Count);
+    }
+}
+
+static
+bool
+EncodeAck(
+    const QUIC_RANGE* Range,
+    uint8_t* Buffer,
+    uint16_t BufferLength,
+    uint16_t* Length
+    )
+{
+    *Length = 0;
+    return QuicAckFrameEncode(Range, 25, nullptr, Length, BufferLength, Buffer) != FALSE;
+}
+
+static
+bool
+DecodeAck(
+    const uint8_t* Buffer,
+    uint16_t Length,
+    QUIC_RANGE* Range
+    )
+{
+    uint16_t Offset = 1; // Skip the frame type.
+    BOOLEAN InvalidFrame;
+    QUIC_ACK_ECN_EX Ecn;
+    uint64_t AckDelay;
+    return
+        QuicAckFrameDecode(
+            QUIC_FRAME_ACK, Length, Buffer, &Offset, &InvalidFrame, Range, &Ecn, &AckDelay) &&
+        Offset == Length;
+}
+
+TEST(AckBlockTest, DecodeManyBlocks)
+{
+    //
+    // Every other packet number, so each one is its own block.
+    //
+    SmartAckRange Sent(QUIC_MAX_RANGE_ALLOC_SIZE);
+    for (uint64_t i = 0; i < 200; ++i) {
+        ASSERT_TRUE(QuicRangeAddValue(&Sent.Range, 1000 + i * 2));
+    }
+    uint8_t Buffer[1024];
+    uint16_t Length;
+    ASSERT_TRUE(EncodeAck(&Sent.Range, Buffer, sizeof(Buffer), &Length));
+
+    SmartAckRange Decoded(QUIC_MAX_RANGE_DECODE_ACKS);
+    ASSERT_TRUE(DecodeAck(Buffer, Length, &Decoded.Range));
+    ExpectEqualRanges(&Sent.Range, &Decoded.Range);
+
+    //
+    // Decoding on top of existing values inserts each block instead, with the
+    // same result.
+    //
+    SmartAckRange Merged(QUIC_MAX_RANGE_DECODE_ACKS);
+    ASSERT_TRUE(QuicRangeAddValue(&Merged.Range, 5000));
+    ASSERT_TRUE(DecodeAck(Buffer, Length, &Merged.Range));
+    ASSERT_TRUE(QuicRangeAddValue(&Sent.Range, 5000));
+    ExpectEqualRanges(&Sent.Range, &Merged.Range);
+}
+
+TEST(AckBlockTest, DecodeTooManyBlocks)
+{
+    //
+    // More blocks than the decode range may hold fails the same way whether
+    // or not the range started out empty.
+    //
+    const uint32_t MaxBlocks = QUIC_MAX_RANGE_DECODE_ACKS / sizeof(QUIC_SUBRANGE);
+    SmartAckRange Sent(QUIC_MAX_RANGE_ALLOC_SIZE);
+    for (uint64_t i = 0; i < MaxBlocks + 1; ++i) {
+        ASSERT_TRUE(QuicRangeAddValue(&Sent.Range, i * 2));
+    }
+    uint8_t Buffer[2048];
+    uint16_t Length;
+    ASSERT_TRUE(EncodeAck(&Sent.Range, Buffer, sizeof(Buffer), &Length));
+
+    SmartAckRange Decoded(QUIC_MAX_RANGE_DECODE_ACKS);
+    ASSERT_FALSE(DecodeAck(Buffer, Length, &Decoded.Range));
+}
+
+TEST(AckBlockTest, DecodeBelowZero)
+{
+    uint8_t Buffer[] = {
+        QUIC_FRAME_ACK,
+        10, // Largest Acknowledged
+        0,  // ACK Delay
+        1,  // ACK Range Count
+        2,  // First ACK Range: 8-10
+        1,  // Gap: 7 and 6 missing
+        6,  // ACK Range: would be -1 to 5
+    };
+    SmartAckRange Decoded(QUIC_MAX_RANGE_DECODE_ACKS);
+    uint16_t Offset = 1;
+    BOOLEAN InvalidFrame;
+    QUIC_ACK_ECN_EX Ecn;
+    uint64_t AckDelay;
+    ASSERT_FALSE(
+        QuicAckFrameDecode(
+            QUIC_FRAME_ACK, sizeof(Buffer), Buffer, &Offset, &InvalidFrame,
+            &Decoded.Range, &Ecn, &AckDelay));
+    ASSERT_TRUE(InvalidFrame);
+
+    Buffer[6] = 5; // ACK Range: 0 to 5
+    Offset = 1;
+    QuicRangeReset(&Decoded.Range);
+    ASSERT_TRUE(
+        QuicAckFrameDecode(
+            QUIC_FRAME_ACK, sizeof(Buffer), Buffer, &Offset, &InvalidFrame,
+            &Decoded.Range, &Ecn, &AckDelay));
+    ASSERT_EQ(2u, QuicRangeSize(&Decoded.Range));
+    ASSERT_EQ(0u, QuicRangeGet(&Decoded.Range, 0)->Low);
+    ASSERT_EQ(6u, QuicRangeGet(&Decoded.Range, 0)->Count);
+}
+
+TEST(AckBlockTest, Reserve)
+{
+    SmartAckRange Range(QUIC_MAX_RANGE_DECODE_ACKS);
+    ASSERT_TRUE(QuicRangeAddValue(&Range.Range, 7));
+    ASSERT_TRUE(QuicRangeReserve(&Range.Range, QUIC_RANGE_INITIAL_SUB_COUNT));
+    ASSERT_EQ((uint32_t)QUIC_RANGE_INITIAL_SUB_COUNT, Range.Range.AllocLength);
+    ASSERT_TRUE(QuicRangeReserve(&Range.Range, 100));
+    ASSERT_EQ(128u, Range.Range.AllocLength);
+    ASSERT_EQ(1u, QuicRangeSize(&Range.Range));
+    ASSERT_EQ(7u, QuicRangeGetMin(&Range.Range));
+    ASSERT_FALSE(QuicRangeReserve(&Range.Range, QUIC_MAX_RANGE_DECODE_ACKS));
+    ASSERT_EQ(128u, Range.Range.AllocLength);
+}
+
+//
+// Receives PacketCount packets in the order given by the workload, tracking
+// them the way the ACK tracker does, and round trips an ACK frame through the
+// encoder and decoder every few packets.
+//
+static
+void
+RunAckWorkload(
+    const char* Name,
+    const std::vector<uint64_t>& Received
+    )
+{
+    const uint32_t PacketsPerAck = 8;
+    SmartAckRange ToAck(QUIC_MAX_RANGE_ACK_PACKETS);
+    SmartAckRange Decoded(QUIC_MAX_RANGE_DECODE_ACKS);
+    SmartAckRange Baseline(QUIC_MAX_RANGE_DECODE_ACKS);
+    uint8_t Buffer[1500];
+    uint16_t Length = 0;
+
+    std::chrono::steady_clock::duration AddElapsed {0};
+    std::chrono::steady_clock::duration EncodeElapsed {0};
+    std::chrono::steady_clock::duration DecodeElapsed {0};
+    std::chrono::steady_clock::duration InsertDecodeElapsed {0};
+    uint64_t AckCount = 0;
+    uint64_t BlockCount = 0;
+
+    for (size_t i = 0; i < Received.size(); i += PacketsPerAck) {
+        auto Start = std::chrono::steady_clock::now();
+        for (size_t j = i; j < Received.size() && j < i + PacketsPerAck; ++j) {
+            ASSERT_TRUE(QuicRangeAddValue(&ToAck.Range, Received[j]));
+        }
+        AddElapsed += std::chrono::steady_clock::now() - Start;
+
+        Start = std::chrono::steady_clock::now();
+        ASSERT_TRUE(EncodeAck(&ToAck.Range, Buffer, sizeof(Buffer), &Length));
+        EncodeElapsed += std::chrono::steady_clock::now() - Start;
+
+        Start = std::chrono::steady_clock::now();
+        ASSERT_TRUE(DecodeAck(Buffer, Length, &Decoded.Range));
+        DecodeElapsed += std::chrono::steady_clock::now() - Start;
+        ExpectEqualRanges(&ToAck.Range, &Decoded.Range);
+        QuicRangeReset(&Decoded.Range);
+
+        //
+        // The same frame decoded by inserting each block into the range, as
+        // happens when the range isn't empty to start with.
+        //
+        ASSERT_TRUE(QuicRangeAddValue(&Baseline.Range, UINT32_MAX));
+        Start = std::chrono::steady_clock::now();
+        ASSERT_TRUE(DecodeAck(Buffer, Length, &Baseline.Range));
+        InsertDecodeElapsed += std::chrono::steady_clock::now() - Start;
+        ASSERT_EQ(QuicRangeSize(&ToAck.Range) + 1, QuicRangeSize(&Baseline.Range));
+        QuicRangeReset(&Baseline.Range);
+
+        ++AckCount;
+        BlockCount += QuicRangeSize(&ToAck.Range);
+    }
+
+    auto Ns = [](std::chrono::steady_clock::duration Elapsed) {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Elapsed).count();
+    };
+    std::cout << "    " << Name << ": "
+              << Ns(AddElapsed) / Received.size() << " ns/packet tracked, "
+              << Ns(EncodeElapsed) / AckCount << " ns/ACK encoded, "
+              << Ns(DecodeElapsed) / AckCount << " ns/ACK decoded ("
+              << Ns(InsertDecodeElapsed) / AckCount << " ns inserting each block), "
+              << BlockCount / AckCount << " blocks/ACK" << std::endl;
+}
+
+TEST(AckBlockTest, RandomLoss)
+{
+    //
+    // 5% of packets are independently lost.
+    //
+    std::mt19937 Rng(5);
+    std::vector<uint64_t> Received;
+    for (uint64_t i = 0; i < 100000; ++i) {
+        if (Rng() % 100 >= 5) {
+            Received.push_back(i);
+        }
+    }
+    RunAckWorkload("random loss", Received);
+}
+
+TEST(AckBlockTest, BurstLoss)
+{
+    //
+    // Losses come in bursts of 1 to 32 packets.
+    //
+    std::mt19937 Rng(7);
+    std::vector<uint64_t> Received;
+    for (uint64_t i = 0; i < 100000; ++i) {
+        if (Rng() % 100 == 0) {
+            i += Rng() % 32;
+        } else {
+            Received.push_back(i);
+        }
+    }
+    RunAckWorkload("burst loss", Received);
+}
+
+TEST(AckBlockTest, Reordering)
+{
+    //
+    // Every packet arrives, but shuffled within windows of 64 packets, as with
+    // packets spread across several paths or receive queues.
+    //
+    std::mt19937 Rng(11);
+    std::vector<uint64_t> Received(100000);
+    for (uint64_t i = 0; i < Received.size(); ++i) {
+        Received[(size_t)i] = i;
+    }
+    for (size_t i = 0; i < Received.size(); i += 64) {
+        std::shuffle(
+            Received.begin() + i,
+            Received.begin() + std::min(i + 64, Received.size()),
+            Rng);
+    }
+    RunAckWorkload("reordering", Received);
+}
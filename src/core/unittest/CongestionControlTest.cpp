@@ -0,0 +1,1047 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Deterministic network emulation for congestion control and loss recovery.
+
+    Flows running the real congestion controllers share a bottleneck link with
+    a drop tail queue and configurable bandwidth, delay, jitter, random loss,
+    reordering and ECN marking. Each sender is a connection whose packets are
+    tracked by the real loss detection: sends go through
+    QuicLossDetectionOnPacketSent, the peer's ACK frames are encoded and
+    handed to QuicLossDetectionProcessAckFrame, and the loss detection and
+    pacing timers run on a real timer wheel. The packet builder is mirrored
+    rather than driven, since there is no datapath, and the receivers
+    acknowledge like a peer with the default ACK settings.
+
+    Everything runs on a virtual clock, which the core also reads through the
+    platform's time override, and a seeded random number generator, so a
+    scenario gives identical results on every run, and needs neither
+    privileges nor a real network. The override only exists in debug builds,
+    and so do these tests. Each scenario reports goodput, queueing
+    delay, retransmission ratio and fairness.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "CongestionControlTest.cpp.clog.h"
+#endif
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <queue>
+#include <random>
+#include <vector>
+
+#if DEBUG // Needs CxPlatSetTimeOverride.
+
+//
+// IPv4 and UDP header bytes added to each QUIC packet on the wire.
+//
+#define EMULATED_HEADER_BYTES 28
+
+struct EmulatedLinkConfig {
+    uint64_t BandwidthBps {20 * 1000 * 1000};
+    uint32_t RttUs {40000};         // Round trip propagation delay.
+    uint32_t QueueBytes {100000};   // Bottleneck buffer size.
+    uint32_t JitterUs {0};          // Maximum random extra forward delay.
+    uint32_t LossPpm {0};           // Random loss, in parts per million.
+    uint32_t ReorderPpm {0};        // Packets held back by ReorderDelayUs.
+    uint32_t ReorderDelayUs {0};
+    uint32_t EcnThresholdUs {0};    // CE mark ECT(0) packets queued longer.
+    uint32_t L4sThresholdUs {0};    // CE mark ECT(1) packets queued longer.
+};
+
+struct EmulatedFlowConfig {
+    QUIC_CONGESTION_CONTROL_ALGORITHM Algorithm {QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC};
+    uint64_t StartUs {0};
+    bool Ecn {false};
+    bool Timestamps {false};        // Gives the controller one-way delays.
+};
+
+struct EmulatedFlowStats {
+    uint64_t GoodputBytes {0};      // Unique bytes delivered while measuring.
+    uint64_t SentPackets {0};
+    uint64_t RetransmittedPackets {0};
+    uint64_t LostPackets {0};       // Inferred lost by the sender.
+    uint64_t SpuriousLostPackets {0};
+    uint64_t DroppedPackets {0};    // Dropped by the link.
+    uint64_t CePackets {0};
+    uint32_t CongestionEvents {0};
+    uint64_t QueueDelayMeanUs {0};
+    uint64_t QueueDelayP95Us {0};
+
+    double GoodputMbps {0};
+    double RetransmissionRatio {0};
+
+    bool operator==(const EmulatedFlowStats& Other) const {
+        return
+            GoodputBytes == Other.GoodputBytes &&
+            SentPackets == Other.SentPackets &&
+            RetransmittedPackets == Other.RetransmittedPackets &&
+            LostPackets == Other.LostPackets &&
+            SpuriousLostPackets == Other.SpuriousLostPackets &&
+            DroppedPackets == Other.DroppedPackets &&
+            CePackets == Other.CePackets &&
+            CongestionEvents == Other.CongestionEvents &&
+            QueueDelayMeanUs == Other.QueueDelayMeanUs &&
+            QueueDelayP95Us == Other.QueueDelayP95Us;
+    }
+};
+
+static
+const char*
+AlgorithmName(
+    QUIC_CONGESTION_CONTROL_ALGORITHM Algorithm
+    )
+{
+    switch (Algorithm) {
+    case QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC: return "Cubic";
+    case QUIC_CONGESTION_CONTROL_ALGORITHM_BBR: return "Bbr";
+    case QUIC_CONGESTION_CONTROL_ALGORITHM_BBR3: return "Bbr3";
+    case QUIC_CONGESTION_CONTROL_ALGORITHM_PRAGUE: return "Prague";
+    case QUIC_CONGESTION_CONTROL_ALGORITHM_LEDBAT: return "Ledbat";
+    default: return "Unknown";
+    }
+}
+
+class EmulatedNetwork {
+
+    enum EventType {
+        EventFlowStart,
+        EventTimerWheel,
+        EventPacketArrival,
+        EventAckTimer,
+        EventAckArrival,
+    };
+
+    struct Event {
+        uint64_t Time;
+        uint64_t Sequence;
+        EventType Type;
+        uint32_t Flow;
+        uint64_t Value; // Packet number, timer generation or ACK index.
+        bool operator>(const Event& Other) const {
+            return
+                Time != Other.Time ?
+                    Time > Other.Time : Sequence > Other.Sequence;
+        }
+    };
+
+    //
+    // What the link and the receiver see of a sent packet.
+    //
+    struct WirePacket {
+        uint64_t Chunk;
+        uint16_t Length;
+        bool Ect;
+        bool Ect1;
+        bool Ce;
+    };
+
+    struct Ack {
+        std::vector<uint8_t> Frame; // An encoded ACK or ACK_1 frame.
+        uint64_t PeerTimestamp;
+    };
+
+    enum ChunkState : uint8_t {
+        ChunkInFlight,
+        ChunkQueued,    // Suspected lost and waiting to be sent again.
+        ChunkAcked,
+    };
+
+    struct Flow {
+        EmulatedFlowConfig Config;
+        QUIC_CONNECTION* Connection;
+        EmulatedFlowStats Stats;
+        std::vector<uint32_t> QueueDelays;
+
+        //
+        // Sender state. Each packet carries one DATAGRAM frame with one chunk
+        // of the bulk transfer, and the datagram send state events from loss
+        // detection say which chunks need to be sent again.
+        //
+        std::vector<WirePacket> Packets; // Indexed by packet number.
+        std::vector<ChunkState> Chunks;
+        std::deque<uint64_t> RetransmitChunks;
+
+        //
+        // Receiver state.
+        //
+        std::vector<bool> Delivered;
+        QUIC_RANGE PendingAck;
+        uint32_t PendingAckCount {0};
+        uint64_t PendingLargest {0};
+        uint64_t PendingLargestTime {0};
+        bool ReceivedAny {false};
+        uint64_t LargestReceived {0};
+        QUIC_ACK_ECN_EX ReceivedEcn {0, 0, 0};
+        std::deque<Ack> Acks;
+        uint64_t AckTimerGeneration {0};
+        bool AckTimerPending {false};
+    };
+
+    EmulatedLinkConfig Link;
+    std::mt19937 Rng;
+    QUIC_WORKER* Worker;
+    QUIC_LIBRARY_PP* PreviousPerProc;
+    uint32_t PreviousProcessorCount;
+    std::vector<QUIC_LIBRARY_PP> PerProc;   // For the perf counters.
+    std::vector<std::unique_ptr<Flow>> Flows;
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> Events;
+    uint64_t EventSequence {0};
+    uint64_t TimerWheelEventTime {UINT64_MAX};
+    uint64_t Now {0};
+    uint64_t MeasureStart {0};
+    uint64_t MeasureEnd {0};
+    uint64_t LinkBusyUntil {0};
+    uint64_t LinkDeliveredBytes {0};
+
+    //
+    // The virtual clock starts at a fixed, nonzero time, so that nothing
+    // depends on the machine's uptime and no timestamp looks unset.
+    //
+    static const uint64_t Origin = S_TO_US(1);
+
+    //
+    // The peer acknowledges every second packet, after at most the default
+    // maximum ACK delay, and immediately when packets arrive out of order.
+    //
+    static const uint32_t AckFrequency = QUIC_MIN_ACK_SEND_NUMBER;
+    static const uint64_t MaxAckDelayUs = MS_TO_US(QUIC_TP_MAX_ACK_DELAY_DEFAULT);
+
+    //
+    // An arbitrary offset between the sender's and the receiver's clocks.
+    //
+    static const uint64_t PeerClockOffsetUs = 123456789;
+
+public:
+
+    EmulatedNetwork(const EmulatedLinkConfig& Link, uint32_t Seed = 1) :
+        Link(Link), Rng(Seed),
+        PreviousPerProc(MsQuicLib.PerProc),
+        PreviousProcessorCount(MsQuicLib.ProcessorCount) {
+        SetNow(Origin);
+        MsQuicLib.ProcessorCount = 1;
+        PerProc.resize(1);
+        CxPlatZeroMemory(PerProc.data(), sizeof(QUIC_LIBRARY_PP));
+        MsQuicLib.PerProc = PerProc.data();
+
+        //
+        // The flows share a worker's sent packet pool and timer wheel.
+        //
+        Worker = (QUIC_WORKER*)CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_WORKER), QUIC_POOL_TEST);
+        CXPLAT_FRE_ASSERT(Worker != nullptr);
+        CxPlatZeroMemory(Worker, sizeof(QUIC_WORKER));
+        QuicSentPacketPoolInitialize(&Worker->SentPacketPool);
+        CXPLAT_FRE_ASSERT(QUIC_SUCCEEDED(QuicTimerWheelInitialize(&Worker->TimerWheel)));
+    }
+
+    ~EmulatedNetwork() {
+        for (auto& Flow : Flows) {
+            QUIC_CONNECTION* Connection = Flow->Connection;
+            QuicTimerWheelRemoveConnection(&Worker->TimerWheel, Connection);
+            QuicLossDetectionUninitialize(&Connection->LossDetection);
+            QuicSendUninitialize(&Connection->Send);
+            QuicRangeUninitialize(&Connection->DecodedAckRanges);
+            CXPLAT_FREE(Connection->Packets[QUIC_ENCRYPT_LEVEL_1_RTT], QUIC_POOL_TEST);
+            CXPLAT_FREE(Connection, QUIC_POOL_TEST);
+            QuicRangeUninitialize(&Flow->PendingAck);
+        }
+        QuicTimerWheelUninitialize(&Worker->TimerWheel);
+        QuicSentPacketPoolUninitialize(&Worker->SentPacketPool);
+        CXPLAT_FREE(Worker, QUIC_POOL_TEST);
+        MsQuicLib.PerProc = PreviousPerProc;
+        MsQuicLib.ProcessorCount = PreviousProcessorCount;
+        CxPlatSetTimeOverride(0);
+    }
+
+    EmulatedNetwork(const EmulatedNetwork&) = delete;
+    EmulatedNetwork& operator=(const EmulatedNetwork&) = delete;
+
+    //
+    // Adds a flow whose sender is a 1-RTT server connection with just enough
+    // state for loss detection and congestion control.
+    //
+    void AddFlow(const EmulatedFlowConfig& Config) {
+        auto NewFlow = std::make_unique<Flow>();
+        NewFlow->Config = Config;
+        QuicRangeInitialize(QUIC_MAX_RANGE_DECODE_ACKS, &NewFlow->PendingAck);
+
+        QUIC_CONNECTION* Connection =
+            (QUIC_CONNECTION*)CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_CONNECTION), QUIC_POOL_TEST);
+        CXPLAT_FRE_ASSERT(Connection != nullptr);
+        CxPlatZeroMemory(Connection, sizeof(QUIC_CONNECTION));
+        NewFlow->Connection = Connection;
+        Connection->_.Type = QUIC_HANDLE_TYPE_CONNECTION_SERVER;
+        Connection->RefCount = 1;
+#if DEBUG
+        Connection->RefTypeCount[QUIC_CONN_REF_HANDLE_OWNER] = 1;
+#endif
+        Connection->Worker = Worker;
+        Connection->ClientCallbackHandler = ConnectionCallback;
+        Connection->_.ClientContext = NewFlow.get();
+        Connection->State.HandshakeConfirmed = TRUE;
+        Connection->Crypto.TlsState.WriteKey = QUIC_PACKET_KEY_1_RTT;
+        Connection->Stats.Timing.Start = Origin;
+        Connection->PeerTransportParams.MaxAckDelay = QUIC_TP_MAX_ACK_DELAY_DEFAULT;
+        Connection->PeerTransportParams.AckDelayExponent = QUIC_TP_ACK_DELAY_EXPONENT_DEFAULT;
+        for (uint32_t Type = 0; Type < QUIC_CONN_TIMER_COUNT; ++Type) {
+            Connection->Timers[Type].ExpirationTime = UINT64_MAX;
+            Connection->Timers[Type].Index = (uint8_t)Type;
+        }
+
+        QuicSettingsSetDefault(&Connection->Settings);
+        Connection->Settings.CongestionControlAlgorithm = (uint16_t)Config.Algorithm;
+        Connection->Settings.EcnEnabled = Config.Ecn;
+        Connection->Settings.HandshakeIdleTimeoutMs = 0; // No idle timer.
+
+        Connection->Packets[QUIC_ENCRYPT_LEVEL_1_RTT] =
+            (QUIC_PACKET_SPACE*)CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_PACKET_SPACE), QUIC_POOL_TEST);
+        CXPLAT_FRE_ASSERT(Connection->Packets[QUIC_ENCRYPT_LEVEL_1_RTT] != nullptr);
+        CxPlatZeroMemory(Connection->Packets[QUIC_ENCRYPT_LEVEL_1_RTT], sizeof(QUIC_PACKET_SPACE));
+        QuicRangeInitialize(QUIC_MAX_RANGE_DECODE_ACKS, &Connection->DecodedAckRanges);
+
+        QuicSendInitialize(&Connection->Send, &Connection->Settings);
+
+        //
+        // The emulator flushes after every event itself, so it stands in for
+        // the pending flush operation that QuicSendQueueFlush would queue.
+        //
+        Connection->Send.FlushOperationPending = TRUE;
+
+        QUIC_PATH* Path = &Connection->Paths[0];
+        QuicPathInitialize(Connection, Path);
+        Connection->PathsCount = 1;
+        Path->IsActive = TRUE;
+        Path->IsPeerValidated = TRUE;
+        Path->IsMinMtuValidated = TRUE;
+        Path->Allowance = UINT32_MAX;
+        Path->Mtu = QUIC_DPLPMTUD_DEFAULT_MAX_MTU;
+        QuicAddrSetFamily(&Path->Route.RemoteAddress, QUIC_ADDRESS_FAMILY_INET);
+
+        //
+        // The initial window depends on the path's MTU.
+        //
+        QuicCongestionControlInitialize(&Connection->CongestionControl, &Connection->Settings);
+        QuicLossDetectionInitialize(&Connection->LossDetection);
+
+        Flows.push_back(std::move(NewFlow));
+    }
+
+    //
+    // Runs all flows for DurationUs, measuring from MeasureStartUs on.
+    //
+    void Run(uint64_t DurationUs, uint64_t MeasureStartUs = 0) {
+        MeasureStart = Origin + MeasureStartUs;
+        MeasureEnd = Origin + DurationUs;
+        LinkBusyUntil = Origin;
+
+        for (uint32_t i = 0; i < (uint32_t)Flows.size(); ++i) {
+            Schedule(Origin + Flows[i]->Config.StartUs, EventFlowStart, i, 0);
+        }
+
+        while (!Events.empty() && Events.top().Time < MeasureEnd) {
+            Event Next = Events.top();
+            Events.pop();
+            SetNow(Next.Time);
+            Flow& F = *Flows[Next.Flow];
+            switch (Next.Type) {
+            case EventFlowStart:
+                TrySend(F);
+                break;
+            case EventTimerWheel:
+                OnTimerWheel();
+                break;
+            case EventPacketArrival:
+                OnPacketArrival(F, Next.Value);
+                break;
+            case EventAckTimer:
+                if (Next.Value == F.AckTimerGeneration) {
+                    SendAck(F);
+                }
+                break;
+            case EventAckArrival:
+                OnAckArrival(F, F.Acks[Next.Value]);
+                break;
+            }
+            ScheduleTimerWheel();
+        }
+
+        for (auto& Flow : Flows) {
+            Finalize(*Flow, DurationUs - MeasureStartUs);
+        }
+    }
+
+    const EmulatedFlowStats& GetStats(size_t Index) const {
+        return Flows[Index]->Stats;
+    }
+
+    //
+    // Jain's fairness index of the flows' goodput.
+    //
+    double Fairness() const {
+        double Sum = 0, SumSquares = 0;
+        for (auto& Flow : Flows) {
+            Sum += (double)Flow->Stats.GoodputBytes;
+            SumSquares += (double)Flow->Stats.GoodputBytes * (double)Flow->Stats.GoodputBytes;
+        }
+        return SumSquares == 0 ? 0 : (Sum * Sum) / (Flows.size() * SumSquares);
+    }
+
+    //
+    // The fraction of the link's capacity used while measuring.
+    //
+    double Utilization() const {
+        return
+            (double)LinkDeliveredBytes * 8 * 1000000 /
+            ((double)Link.BandwidthBps * (MeasureEnd - MeasureStart));
+    }
+
+    void Report(const char* Name) const {
+        std::cout << "    " << Name << ": utilization " << (int)(Utilization() * 100)
+            << "%, fairness " << Fairness() << std::endl;
+        for (auto& Flow : Flows) {
+            const EmulatedFlowStats& Stats = Flow->Stats;
+            std::cout << "      " << AlgorithmName(Flow->Config.Algorithm) << ": "
+                << Stats.GoodputMbps << " Mbps, queue delay "
+                << Stats.QueueDelayMeanUs / 1000.0 << " ms (p95 "
+                << Stats.QueueDelayP95Us / 1000.0 << " ms), "
+                << Stats.RetransmissionRatio * 100 << "% retransmitted, "
+                << Stats.DroppedPackets << " dropped, " << Stats.LostPackets << " lost ("
+                << Stats.SpuriousLostPackets << " spurious), "
+                << Stats.CongestionEvents << " congestion events" << std::endl;
+        }
+    }
+
+private:
+
+    //
+    // Moves the virtual clock, which is also what the core reads from the
+    // platform clock.
+    //
+    void SetNow(uint64_t Time) {
+        Now = Time;
+        CxPlatSetTimeOverride(Time);
+    }
+
+    void Schedule(uint64_t Time, EventType Type, uint32_t FlowIndex, uint64_t Value) {
+        Events.push({Time, EventSequence++, Type, FlowIndex, Value});
+    }
+
+    uint32_t IndexOf(const Flow& F) const {
+        for (uint32_t i = 0; i < (uint32_t)Flows.size(); ++i) {
+            if (Flows[i].get() == &F) {
+                return i;
+            }
+        }
+        CXPLAT_FRE_ASSERT(FALSE);
+        return 0;
+    }
+
+    bool Measuring() const {
+        return Now >= MeasureStart && Now < MeasureEnd;
+    }
+
+    //
+    // Wakes up for the next timer in the timer wheel, like the worker does.
+    //
+    void ScheduleTimerWheel() {
+        const uint64_t Next = Worker->TimerWheel.NextExpirationTime;
+        if (Next < TimerWheelEventTime) {
+            TimerWheelEventTime = CXPLAT_MAX(Next, Now);
+            Schedule(TimerWheelEventTime, EventTimerWheel, 0, 0);
+        }
+    }
+
+    //
+    // Runs the expired timers like QuicWorkerProcessTimers and
+    // QuicConnTimerExpired, and then the operations those queue. Only the loss
+    // detection and pacing timers are ever set.
+    //
+    void OnTimerWheel() {
+        TimerWheelEventTime = UINT64_MAX;
+
+        CXPLAT_LIST_ENTRY ExpiredTimers;
+        CxPlatListInitializeHead(&ExpiredTimers);
+        QuicTimerWheelGetExpired(&Worker->TimerWheel, Now, &ExpiredTimers);
+
+        while (!CxPlatListIsEmpty(&ExpiredTimers)) {
+            CXPLAT_LIST_ENTRY* Entry = CxPlatListRemoveHead(&ExpiredTimers);
+            Entry->Flink = NULL;
+            QUIC_CONNECTION* Connection =
+                CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONNECTION, TimerLink);
+
+            for (uint32_t Type = 0; Type < QUIC_CONN_TIMER_COUNT; ++Type) {
+                QUIC_TIMER_WHEEL_ENTRY* Timer = &Connection->Timers[Type];
+                if (Timer->Link.Flink == NULL && Timer->ExpirationTime <= Now) {
+                    Timer->ExpirationTime = UINT64_MAX;
+                    if (Type == QUIC_CONN_TIMER_LOSS_DETECTION) {
+                        QuicLossDetectionProcessTimerOperation(&Connection->LossDetection);
+                    }
+                }
+            }
+
+            TrySend(*(Flow*)Connection->_.ClientContext);
+            QuicConnRelease(Connection, QUIC_CONN_REF_WORKER);
+        }
+    }
+
+    static
+    QUIC_STATUS
+    QUIC_API
+    ConnectionCallback(
+        _In_ HQUIC /* Connection */,
+        _In_opt_ void* Context,
+        _Inout_ QUIC_CONNECTION_EVENT* Event
+        )
+    {
+        if (Event->Type != QUIC_CONNECTION_EVENT_DATAGRAM_SEND_STATE_CHANGED) {
+            return QUIC_STATUS_SUCCESS;
+        }
+
+        //
+        // The context of each DATAGRAM frame is its chunk number plus one.
+        //
+        Flow* F = (Flow*)Context;
+        const uint64_t Chunk =
+            (uint64_t)(uintptr_t)Event->DATAGRAM_SEND_STATE_CHANGED.ClientContext - 1;
+        switch (Event->DATAGRAM_SEND_STATE_CHANGED.State) {
+        case QUIC_DATAGRAM_SEND_ACKNOWLEDGED:
+        case QUIC_DATAGRAM_SEND_ACKNOWLEDGED_SPURIOUS:
+            F->Chunks[(size_t)Chunk] = ChunkAcked;
+            break;
+        case QUIC_DATAGRAM_SEND_LOST_SUSPECT:
+            //
+            // Send it again, unless it is already queued. If the original is
+            // acknowledged before then, the retransmission is skipped, as it
+            // would be for stream data.
+            //
+            if (F->Chunks[(size_t)Chunk] == ChunkInFlight) {
+                F->Chunks[(size_t)Chunk] = ChunkQueued;
+                F->RetransmitChunks.push_back(Chunk);
+            }
+            break;
+        default:
+            break;
+        }
+        return QUIC_STATUS_SUCCESS;
+    }
+
+    //
+    // Sends as much as the congestion controller allows, as QuicSendFlush
+    // does, and sets the pacing timer if it is pacing.
+    //
+    void TrySend(Flow& F) {
+        QUIC_CONNECTION* Connection = F.Connection;
+        QUIC_CONGESTION_CONTROL* Cc = &Connection->CongestionControl;
+        if (Now < Origin + F.Config.StartUs ||
+            !QuicCongestionControlCanSend(Cc)) {
+            return;
+        }
+
+        QuicConnTimerCancel(Connection, QUIC_CONN_TIMER_PACING);
+
+        //
+        // As in QuicPacketBuilderInitialize.
+        //
+        const BOOLEAN LastFlushTimeValid = Connection->Send.LastFlushTimeValid;
+        const uint64_t TimeSinceLastSend =
+            LastFlushTimeValid ?
+                CxPlatTimeDiff64(Connection->Send.LastFlushTime, Now) : 0;
+        uint32_t SendAllowance =
+            QuicCongestionControlGetSendAllowance(Cc, TimeSinceLastSend, LastFlushTimeValid);
+        Connection->Send.LastFlushTime = Now;
+        Connection->Send.LastFlushTimeValid = TRUE;
+
+        const bool EcnEctSet = ShouldSetEct(F);
+        bool Sent = false;
+        while (SendAllowance > 0 || QuicCongestionControlGetExemptions(Cc) > 0) {
+            const uint16_t PacketLength = SendPacket(F, EcnEctSet);
+            SendAllowance = PacketLength > SendAllowance ? 0 : SendAllowance - PacketLength;
+            Sent = true;
+        }
+
+        //
+        // As in QuicPacketBuilderCleanup.
+        //
+        if (Sent) {
+            QuicLossDetectionUpdateTimer(&Connection->LossDetection, FALSE);
+        }
+
+        if (QuicCongestionControlCanSend(Cc)) {
+            QuicConnTimerSet(Connection, QUIC_CONN_TIMER_PACING, QUIC_SEND_PACING_INTERVAL);
+        }
+    }
+
+    //
+    // Decides whether packets are sent with an ECT codepoint, and moves the
+    // path out of ECN testing, like QuicSendFlush.
+    //
+    bool ShouldSetEct(Flow& F) {
+        QUIC_CONNECTION* Connection = F.Connection;
+        QUIC_PATH* Path = &Connection->Paths[0];
+        if (Path->EcnValidationState == ECN_VALIDATION_CAPABLE) {
+            return true;
+        }
+        if (Path->EcnValidationState == ECN_VALIDATION_TESTING) {
+            if (Path->EcnTestingEndingTime != 0) {
+                if (!CxPlatTimeAtOrBefore64(Now, Path->EcnTestingEndingTime)) {
+                    Path->EcnValidationState = ECN_VALIDATION_UNKNOWN;
+                }
+            } else {
+                Path->EcnTestingEndingTime =
+                    Now +
+                    QuicLossDetectionComputeProbeTimeout(
+                        &Connection->LossDetection, Path, QUIC_CLOSE_PTO_COUNT);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    //
+    // Builds the metadata of a packet with one DATAGRAM frame, as the packet
+    // builder would, and hands it to loss detection.
+    //
+    uint16_t SendPacket(Flow& F, bool EcnEctSet) {
+        QUIC_CONNECTION* Connection = F.Connection;
+        QUIC_PATH* Path = &Connection->Paths[0];
+
+        uint64_t Chunk = UINT64_MAX;
+        while (!F.RetransmitChunks.empty() && Chunk == UINT64_MAX) {
+            const uint64_t Next = F.RetransmitChunks.front();
+            F.RetransmitChunks.pop_front();
+            if (F.Chunks[(size_t)Next] == ChunkQueued) {
+                F.Chunks[(size_t)Next] = ChunkInFlight;
+                Chunk = Next;
+                F.Stats.RetransmittedPackets++;
+            }
+        }
+        if (Chunk == UINT64_MAX) {
+            Chunk = F.Chunks.size();
+            F.Chunks.push_back(ChunkInFlight);
+        }
+        F.Stats.SentPackets++;
+
+        QUIC_MAX_SENT_PACKET_METADATA Storage;
+        CxPlatZeroMemory(&Storage, sizeof(Storage));
+        QUIC_SENT_PACKET_METADATA* Metadata = &Storage.Metadata;
+        Metadata->Frames = Storage.Frames;
+        Metadata->PacketNumber = Connection->Send.NextPacketNumber++;
+        Metadata->SentTime = Now;
+        Metadata->PacketLength = QuicPathGetDatagramPayloadSize(Path);
+        Metadata->FrameCount = 1;
+        Metadata->Flags.KeyType = QUIC_PACKET_KEY_1_RTT;
+        Metadata->Flags.IsAckEliciting = TRUE;
+        Metadata->Flags.EcnEctSet = EcnEctSet;
+        Metadata->PathId = Path->ID;
+        Storage.Frames[0].Type = QUIC_FRAME_DATAGRAM;
+        Storage.Frames[0].DATAGRAM.ClientContext = (void*)(uintptr_t)(Chunk + 1);
+
+        const uint64_t PacketNumber = Metadata->PacketNumber;
+        const uint16_t PacketLength = Metadata->PacketLength;
+        QuicLossDetectionOnPacketSent(&Connection->LossDetection, Path, Metadata);
+        if (EcnEctSet) {
+            ++Connection->Send.NumPacketsSentWithEct;
+        }
+
+        F.Packets.push_back(
+            {Chunk, PacketLength, EcnEctSet, EcnEctSet && Connection->CongestionControl.L4s, false});
+        Enqueue(F, PacketNumber);
+        return PacketLength;
+    }
+
+    //
+    // Puts a packet on the bottleneck link, unless it is lost or the queue is
+    // full, and schedules its arrival at the receiver.
+    //
+    void Enqueue(Flow& F, uint64_t PacketNumber) {
+        WirePacket& P = F.Packets[(size_t)PacketNumber];
+        if (Link.LossPpm != 0 && Rng() % 1000000 < Link.LossPpm) {
+            F.Stats.DroppedPackets++;
+            return;
+        }
+
+        const uint64_t WireBytes = P.Length + EMULATED_HEADER_BYTES;
+        const uint64_t QueuedBytes =
+            LinkBusyUntil > Now ?
+                (LinkBusyUntil - Now) * Link.BandwidthBps / (8 * 1000000) : 0;
+        if (QueuedBytes + WireBytes > Link.QueueBytes) {
+            F.Stats.DroppedPackets++;
+            return;
+        }
+
+        const uint64_t TransmitStart = CXPLAT_MAX(Now, LinkBusyUntil);
+        const uint64_t QueueDelay = TransmitStart - Now;
+        LinkBusyUntil =
+            TransmitStart + (WireBytes * 8 * 1000000 + Link.BandwidthBps - 1) / Link.BandwidthBps;
+        if (Measuring()) {
+            F.QueueDelays.push_back((uint32_t)QueueDelay);
+            LinkDeliveredBytes += WireBytes;
+        }
+
+        if (P.Ect) {
+            const uint32_t Threshold = P.Ect1 ? Link.L4sThresholdUs : Link.EcnThresholdUs;
+            P.Ce = Threshold != 0 && QueueDelay > Threshold;
+        }
+
+        uint64_t Arrival = LinkBusyUntil + Link.RttUs / 2;
+        if (Link.JitterUs != 0) {
+            Arrival += Rng() % (Link.JitterUs + 1);
+        }
+        if (Link.ReorderPpm != 0 && Rng() % 1000000 < Link.ReorderPpm) {
+            Arrival += Link.ReorderDelayUs;
+        }
+        Schedule(Arrival, EventPacketArrival, IndexOf(F), PacketNumber);
+    }
+
+    void OnPacketArrival(Flow& F, uint64_t PacketNumber) {
+        const WirePacket& P = F.Packets[(size_t)PacketNumber];
+        if (P.Ce) {
+            F.ReceivedEcn.CE_Count++;
+            F.Stats.CePackets++;
+        } else if (P.Ect1) {
+            F.ReceivedEcn.ECT_1_Count++;
+        } else if (P.Ect) {
+            F.ReceivedEcn.ECT_0_Count++;
+        }
+
+        if (F.Delivered.size() <= P.Chunk) {
+            F.Delivered.resize((size_t)P.Chunk + 1024);
+        }
+        if (!F.Delivered[(size_t)P.Chunk]) {
+            F.Delivered[(size_t)P.Chunk] = true;
+            if (Measuring()) {
+                F.Stats.GoodputBytes += P.Length;
+            }
+        }
+
+        const bool OutOfOrder =
+            F.ReceivedAny ?
+                PacketNumber != F.LargestReceived + 1 : PacketNumber != 0;
+        if (!F.ReceivedAny || PacketNumber > F.LargestReceived) {
+            F.ReceivedAny = true;
+            F.LargestReceived = PacketNumber;
+        }
+
+        CXPLAT_FRE_ASSERT(QuicRangeAddValue(&F.PendingAck, PacketNumber));
+        if (F.PendingAckCount++ == 0 || PacketNumber > F.PendingLargest) {
+            F.PendingLargest = PacketNumber;
+            F.PendingLargestTime = Now;
+        }
+
+        if (F.PendingAckCount >= AckFrequency || OutOfOrder) {
+            SendAck(F);
+        } else if (!F.AckTimerPending) {
+            F.AckTimerPending = true;
+            Schedule(Now + MaxAckDelayUs, EventAckTimer, IndexOf(F), ++F.AckTimerGeneration);
+        }
+    }
+
+    //
+    // Encodes an ACK frame for the packets received since the last one. The
+    // return path is never congested or lossy, so no range has to be repeated.
+    //
+    void SendAck(Flow& F) {
+        F.AckTimerPending = false;
+        F.AckTimerGeneration++;
+        if (F.PendingAckCount == 0) {
+            return;
+        }
+
+        const bool HasEcn =
+            F.ReceivedEcn.ECT_0_Count + F.ReceivedEcn.ECT_1_Count + F.ReceivedEcn.CE_Count != 0;
+        uint8_t Buffer[QUIC_DPLPMTUD_DEFAULT_MAX_MTU];
+        uint16_t Offset = 0;
+        CXPLAT_FRE_ASSERT(
+            QuicAckFrameEncode(
+                &F.PendingAck,
+                (Now - F.PendingLargestTime) >> QUIC_TP_ACK_DELAY_EXPONENT_DEFAULT,
+                HasEcn ? &F.ReceivedEcn : nullptr,
+                &Offset,
+                sizeof(Buffer),
+                Buffer));
+        QuicRangeReset(&F.PendingAck);
+        F.PendingAckCount = 0;
+
+        Ack A;
+        A.Frame.assign(Buffer, Buffer + Offset);
+        A.PeerTimestamp = Now - Origin + PeerClockOffsetUs;
+        F.Acks.push_back(std::move(A));
+        Schedule(Now + Link.RttUs / 2, EventAckArrival, IndexOf(F), F.Acks.size() - 1);
+    }
+
+    //
+    // Hands the ACK frame to loss detection, like QuicConnRecvFrames, and then
+    // sends whatever became allowed.
+    //
+    void OnAckArrival(Flow& F, const Ack& A) {
+        QUIC_CONNECTION* Connection = F.Connection;
+
+        QUIC_RX_PACKET Packet;
+        CxPlatZeroMemory(&Packet, sizeof(Packet));
+        Packet.SendTimestamp = F.Config.Timestamps ? A.PeerTimestamp : UINT64_MAX;
+
+        uint16_t Offset = sizeof(uint8_t); // The frame type.
+        BOOLEAN InvalidFrame;
+        CXPLAT_FRE_ASSERT(
+            QuicLossDetectionProcessAckFrame(
+                &Connection->LossDetection,
+                &Connection->Paths[0],
+                &Packet,
+                QUIC_ENCRYPT_LEVEL_1_RTT,
+                (QUIC_FRAME_TYPE)A.Frame[0],
+                (uint16_t)A.Frame.size(),
+                A.Frame.data(),
+                &Offset,
+                &InvalidFrame));
+
+        TrySend(F);
+    }
+
+    void Finalize(Flow& F, uint64_t MeasuredUs) {
+        EmulatedFlowStats& Stats = F.Stats;
+        Stats.LostPackets = F.Connection->Stats.Send.SuspectedLostPackets;
+        Stats.SpuriousLostPackets = F.Connection->Stats.Send.SpuriousLostPackets;
+        Stats.CongestionEvents = F.Connection->Stats.Send.CongestionCount;
+        Stats.GoodputMbps = (double)Stats.GoodputBytes * 8 / (double)MeasuredUs;
+        Stats.RetransmissionRatio =
+            Stats.SentPackets == 0 ?
+                0 : (double)Stats.RetransmittedPackets / (double)Stats.SentPackets;
+        if (!F.QueueDelays.empty()) {
+            uint64_t Sum = 0;
+            for (uint32_t Delay : F.QueueDelays) {
+                Sum += Delay;
+            }
+            Stats.QueueDelayMeanUs = Sum / F.QueueDelays.size();
+            auto P95 = F.QueueDelays.begin() + F.QueueDelays.size() * 95 / 100;
+            std::nth_element(F.QueueDelays.begin(), P95, F.QueueDelays.end());
+            Stats.QueueDelayP95Us = *P95;
+        }
+    }
+};
+
+//
+// 20 Mbps with a 40 ms round trip and one bandwidth-delay product of buffer.
+//
+static
+EmulatedLinkConfig
+DefaultLink()
+{
+    EmulatedLinkConfig Link;
+    Link.BandwidthBps = 20 * 1000 * 1000;
+    Link.RttUs = 40000;
+    Link.QueueBytes = (uint32_t)(Link.BandwidthBps / 8 * Link.RttUs / 1000000);
+    return Link;
+}
+
+struct CongestionControlEmulationTest : public ::testing::TestWithParam<QUIC_CONGESTION_CONTROL_ALGORITHM> {
+};
+
+TEST_P(CongestionControlEmulationTest, Bottleneck)
+{
+    EmulatedNetwork Network(DefaultLink());
+    EmulatedFlowConfig Flow;
+    Flow.Algorithm = GetParam();
+    Network.AddFlow(Flow);
+    Network.Run(S_TO_US(20), S_TO_US(5));
+    Network.Report("Bottleneck");
+
+    ASSERT_GE(Network.Utilization(), 0.8);
+}
+
+TEST_P(CongestionControlEmulationTest, RandomLoss)
+{
+    EmulatedLinkConfig Link = DefaultLink();
+    Link.LossPpm = 10000;
+    EmulatedNetwork Network(Link);
+    EmulatedFlowConfig Flow;
+    Flow.Algorithm = GetParam();
+    Network.AddFlow(Flow);
+    Network.Run(S_TO_US(20), S_TO_US(5));
+    Network.Report("1% random loss");
+
+    //
+    // Everything lost is inferred lost and retransmitted, and the transfer
+    // keeps going.
+    //
+    const EmulatedFlowStats& Stats = Network.GetStats(0);
+    ASSERT_GT(Stats.LostPackets, 0u);
+    ASSERT_GE(Stats.LostPackets, Stats.DroppedPackets * 9 / 10);
+    ASSERT_GE(Stats.RetransmittedPackets + Stats.SpuriousLostPackets + 64, Stats.LostPackets);
+    ASSERT_GE(Stats.GoodputMbps, 1.0);
+}
+
+TEST_P(CongestionControlEmulationTest, Reordering)
+{
+    EmulatedLinkConfig Link = DefaultLink();
+    Link.JitterUs = 1000;
+    Link.ReorderPpm = 10000;
+    Link.ReorderDelayUs = 10000;
+    EmulatedNetwork Network(Link);
+    EmulatedFlowConfig Flow;
+    Flow.Algorithm = GetParam();
+    Network.AddFlow(Flow);
+    Network.Run(S_TO_US(20), S_TO_US(5));
+    Network.Report("Jitter and 1% reordering");
+
+    //
+    // Reordered packets are declared lost and then acknowledged, which
+    // reverts the congestion window.
+    //
+    const EmulatedFlowStats& Stats = Network.GetStats(0);
+    ASSERT_GT(Stats.SpuriousLostPackets, 0u);
+    ASSERT_GE(Network.Utilization(), 0.5);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    CongestionControlTest,
+    CongestionControlEmulationTest,
+    ::testing::Values(
+        QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC,
+        QUIC_CONGESTION_CONTROL_ALGORITHM_BBR,
+        QUIC_CONGESTION_CONTROL_ALGORITHM_BBR3,
+        QUIC_CONGESTION_CONTROL_ALGORITHM_PRAGUE,
+        QUIC_CONGESTION_CONTROL_ALGORITHM_LEDBAT),
+    [](const ::testing::TestParamInfo<QUIC_CONGESTION_CONTROL_ALGORITHM>& Info) {
+        return std::string(AlgorithmName(Info.param));
+    });
+
+TEST(CongestionControlTest, Deterministic)
+{
+    EmulatedLinkConfig Link = DefaultLink();
+    Link.JitterUs = 2000;
+    Link.LossPpm = 5000;
+    Link.ReorderPpm = 5000;
+    Link.ReorderDelayUs = 5000;
+    Link.EcnThresholdUs = 10000;
+    Link.L4sThresholdUs = 1000;
+
+    EmulatedFlowStats Stats[2][3];
+    for (uint32_t Run = 0; Run < 2; ++Run) {
+        EmulatedNetwork Network(Link, 42);
+        EmulatedFlowConfig Flow;
+        Flow.Algorithm = QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC;
+        Network.AddFlow(Flow);
+        Flow.Algorithm = QUIC_CONGESTION_CONTROL_ALGORITHM_BBR;
+        Flow.StartUs = MS_TO_US(500);
+        Network.AddFlow(Flow);
+        Flow.Algorithm = QUIC_CONGESTION_CONTROL_ALGORITHM_PRAGUE;
+        Flow.StartUs = MS_TO_US(1000);
+        Flow.Ecn = true;
+        Network.AddFlow(Flow);
+        Network.Run(S_TO_US(10));
+        for (uint32_t i = 0; i < 3; ++i) {
+            Stats[Run][i] = Network.GetStats(i);
+        }
+    }
+
+    for (uint32_t i = 0; i < 3; ++i) {
+        ASSERT_GT(Stats[0][i].GoodputBytes, 0u);
+        ASSERT_TRUE(Stats[0][i] == Stats[1][i]);
+    }
+}
+
+TEST(CongestionControlTest, CubicFairness)
+{
+    EmulatedLinkConfig Link = DefaultLink();
+    Link.JitterUs = 1000;
+    EmulatedNetwork Network(Link);
+    EmulatedFlowConfig Flow;
+    Network.AddFlow(Flow);
+    Flow.StartUs = S_TO_US(2);
+    Network.AddFlow(Flow);
+    Network.Run(S_TO_US(60), S_TO_US(20));
+    Network.Report("Two Cubic flows");
+
+    ASSERT_GE(Network.Fairness(), 0.9);
+    ASSERT_GE(Network.Utilization(), 0.8);
+    ASSERT_LE(Network.GetStats(0).RetransmissionRatio, 0.05);
+    ASSERT_LE(Network.GetStats(1).RetransmissionRatio, 0.05);
+}
+
+TEST(CongestionControlTest, LedbatYields)
+{
+    EmulatedLinkConfig Link = DefaultLink();
+    Link.QueueBytes *= 4; // Deep enough for LEDBAT's target delay.
+    EmulatedNetwork Network(Link);
+    EmulatedFlowConfig Flow;
+    Flow.Algorithm = QUIC_CONGESTION_CONTROL_ALGORITHM_LEDBAT;
+    Flow.Timestamps = true;
+    Network.AddFlow(Flow);
+    Flow.Algorithm = QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC;
+    Flow.Timestamps = false;
+    Flow.StartUs = S_TO_US(5);
+    Network.AddFlow(Flow);
+    Network.Run(S_TO_US(30), S_TO_US(10));
+    Network.Report("LEDBAT then Cubic");
+
+    //
+    // The background flow gives way to the foreground one.
+    //
+    ASSERT_GE(Network.GetStats(1).GoodputBytes, 4 * Network.GetStats(0).GoodputBytes);
+}
+
+TEST(CongestionControlTest, LedbatAlone)
+{
+    EmulatedLinkConfig Link = DefaultLink();
+    Link.QueueBytes *= 4;
+    EmulatedNetwork Network(Link);
+    EmulatedFlowConfig Flow;
+    Flow.Algorithm = QUIC_CONGESTION_CONTROL_ALGORITHM_LEDBAT;
+    Flow.Timestamps = true;
+    Network.AddFlow(Flow);
+    Network.Run(S_TO_US(30), S_TO_US(10));
+    Network.Report("LEDBAT alone");
+
+    //
+    // Alone, it fills the link while keeping the queue near the target delay
+    // rather than filling the buffer.
+    //
+    const EmulatedFlowStats& Stats = Network.GetStats(0);
+    ASSERT_GE(Network.Utilization(), 0.8);
+    ASSERT_LE(Stats.QueueDelayP95Us, MS_TO_US(60));
+}
+
+TEST(CongestionControlTest, L4sQueueDelay)
+{
+    EmulatedLinkConfig Link = DefaultLink();
+    Link.QueueBytes *= 4;
+    Link.L4sThresholdUs = 1000;
+
+    EmulatedFlowStats Classic, Scalable;
+    {
+        EmulatedNetwork Network(Link);
+        EmulatedFlowConfig Flow;
+        Network.AddFlow(Flow);
+        Network.Run(S_TO_US(20), S_TO_US(5));
+        Network.Report("Cubic, deep buffer");
+        Classic = Network.GetStats(0);
+    }
+    {
+        EmulatedNetwork Network(Link);
+        EmulatedFlowConfig Flow;
+        Flow.Algorithm = QUIC_CONGESTION_CONTROL_ALGORITHM_PRAGUE;
+        Flow.Ecn = true;
+        Network.AddFlow(Flow);
+        Network.Run(S_TO_US(20), S_TO_US(5));
+        Network.Report("Prague, deep buffer with L4S marking");
+        Scalable = Network.GetStats(0);
+        ASSERT_GE(Network.Utilization(), 0.8);
+    }
+
+    //
+    // CE marks keep the queue short instead of it filling until loss.
+    //
+    ASSERT_GT(Scalable.CePackets, 0u);
+    ASSERT_EQ(0u, Scalable.DroppedPackets);
+    ASSERT_LE(Scalable.QueueDelayP95Us * 4, Classic.QueueDelayP95Us);
+}
+
+#endif // DEBUG
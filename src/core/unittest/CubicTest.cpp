@@ -0,0 +1,104 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test for the Cubic congestion controller.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "CubicTest.cpp.clog.h"
+#endif
+
+//
+// A connection with just enough state for its congestion controller.
+//
+struct SmartCubicConnection {
+    QUIC_CONNECTION* Connection;
+    SmartCubicConnection() {
+        Connection =
+            (QUIC_CONNECTION*)CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_CONNECTION), QUIC_POOL_TEST);
+        CXPLAT_FRE_ASSERT(Connection != nullptr);
+        CxPlatZeroMemory(Connection, sizeof(QUIC_CONNECTION));
+        QuicSettingsSetDefault(&Connection->Settings);
+        Connection->Settings.CongestionControlAlgorithm = QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC;
+        QUIC_PATH* Path = &Connection->Paths[0];
+        QuicPathInitialize(Connection, Path);
+        Connection->PathsCount = 1;
+        Path->IsActive = TRUE;
+        Path->Mtu = QUIC_DPLPMTUD_DEFAULT_MAX_MTU;
+        Path->GotFirstRttSample = TRUE;
+        Path->SmoothedRtt = MS_TO_US(40);
+        Path->RttVariance = MS_TO_US(5);
+        QuicAddrSetFamily(&Path->Route.RemoteAddress, QUIC_ADDRESS_FAMILY_INET);
+        QuicCongestionControlInitialize(&Connection->CongestionControl, &Connection->Settings);
+    }
+    ~SmartCubicConnection() {
+        CXPLAT_FREE(Connection, QUIC_POOL_TEST);
+    }
+    QUIC_CONNECTION* operator->() { return Connection; }
+};
+
+TEST(CubicTest, AimdWindowGrowth)
+{
+    //
+    // In the Reno-friendly region, the AIMD window grows by one datagram for
+    // each window's worth of bytes acknowledged, keeping the remainder. The
+    // accumulator must never be left larger than the window: growing the
+    // window before subtracting it used to wrap the accumulator, after which
+    // the window grew by a datagram on every ACK.
+    //
+    SmartCubicConnection Connection;
+    QUIC_CONGESTION_CONTROL* Cc = &Connection->CongestionControl;
+    QUIC_CONGESTION_CONTROL_CUBIC* Cubic = &Cc->Cubic;
+    const uint16_t DatagramPayloadLength =
+        QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+
+    //
+    // Start congestion avoidance with the cubic curve flat, so the AIMD window
+    // decides the congestion window, and with part of a datagram left over in
+    // the accumulator, as slow start can leave it.
+    //
+    uint64_t TimeNow = S_TO_US(1);
+    const uint32_t StartWindow = Cubic->CongestionWindow;
+    Cubic->SlowStartThreshold = StartWindow;
+    Cubic->AimdWindow = StartWindow;
+    Cubic->AimdAccumulator = DatagramPayloadLength / 2;
+    Cubic->WindowPrior = StartWindow;
+    Cubic->WindowMax = 0;
+    Cubic->KCubic = 0;
+    Cubic->TimeOfCongAvoidStart = TimeNow;
+
+    uint64_t PacketNumber = 0;
+    uint64_t BytesAcked = 0;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        QuicCongestionControlOnDataSent(Cc, DatagramPayloadLength);
+        Connection->Send.NextPacketNumber = ++PacketNumber;
+        TimeNow += 100;
+
+        QUIC_ACK_EVENT AckEvent;
+        CxPlatZeroMemory(&AckEvent, sizeof(AckEvent));
+        AckEvent.TimeNow = TimeNow;
+        AckEvent.LargestAck = PacketNumber - 1;
+        AckEvent.LargestSentPacketNumber = PacketNumber - 1;
+        AckEvent.NumRetransmittableBytes = DatagramPayloadLength;
+        AckEvent.SmoothedRtt = Connection->Paths[0].SmoothedRtt;
+        AckEvent.MinRtt = Connection->Paths[0].SmoothedRtt;
+        AckEvent.MinRttValid = TRUE;
+        QuicCongestionControlOnDataAcknowledged(Cc, &AckEvent);
+        BytesAcked += DatagramPayloadLength;
+
+        ASSERT_LE(Cubic->AimdAccumulator, Cubic->AimdWindow);
+    }
+
+    //
+    // Each datagram of growth took at least a full window of ACKed bytes.
+    //
+    const uint32_t Growth = (Cubic->AimdWindow - StartWindow) / DatagramPayloadLength;
+    ASSERT_GT(Growth, 0u);
+    ASSERT_LE((uint64_t)Growth * StartWindow, BytesAcked);
+}
@@ -0,0 +1,457 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test and contention benchmark for the local CID lookup.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "LookupTest.cpp.clog.h"
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+extern "C"
+void
+MsQuicCalculatePartitionMask(
+    void
+    );
+
+extern "C"
+long*
+QuicLookupReadBegin(
+    _In_ QUIC_LOOKUP* Lookup
+    );
+
+extern "C"
+void
+QuicLookupReadEnd(
+    _In_ long* Active
+    );
+
+static
+void
+SetPartitionCount(
+    uint16_t PartitionCount
+    )
+{
+    MsQuicLib.PartitionCount = PartitionCount;
+    MsQuicCalculatePartitionMask();
+    MsQuicLib.CidServerIdLength = 0;
+    MsQuicLib.CidTotalLength = QUIC_CID_MIN_LENGTH;
+}
+
+struct SmartLookup {
+    QUIC_LOOKUP Lookup;
+    SmartLookup(bool Maximize = true) {
+        QuicLookupInitialize(&Lookup);
+        if (Maximize) {
+            EXPECT_TRUE(QuicLookupMaximizePartitioning(&Lookup));
+        }
+    }
+    ~SmartLookup() {
+        QuicLookupUninitialize(&Lookup);
+    }
+    QUIC_CONNECTION* Find(const QUIC_CID_HASH_ENTRY* Cid) {
+        return Find(Cid->CID.Data, Cid->CID.Length);
+    }
+    QUIC_CONNECTION* Find(const uint8_t* Cid, uint8_t Length) {
+        QUIC_CONNECTION* Connection = QuicLookupFindConnectionByLocalCid(&Lookup, Cid, Length);
+        if (Connection != nullptr) {
+            QuicConnRelease(Connection, QUIC_CONN_REF_LOOKUP_RESULT);
+        }
+        return Connection;
+    }
+};
+
+//
+// A connection that only exists to own CIDs in the lookup. It keeps a
+// reference of its own, so the lookup never releases the last one.
+//
+struct SmartConnection {
+    QUIC_CONNECTION* Connection;
+    SmartConnection() {
+        Connection = (QUIC_CONNECTION*)CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_CONNECTION), QUIC_POOL_TEST);
+        CxPlatZeroMemory(Connection, sizeof(QUIC_CONNECTION));
+        Connection->RefCount = 1;
+#if DEBUG
+        Connection->RefTypeCount[QUIC_CONN_REF_HANDLE_OWNER] = 1;
+#endif
+    }
+    ~SmartConnection() {
+        while (Connection->SourceCids.Next != nullptr) {
+            CXPLAT_FREE(
+                CXPLAT_CONTAINING_RECORD(
+                    CxPlatListPopEntry(&Connection->SourceCids), QUIC_CID_HASH_ENTRY, Link),
+                QUIC_POOL_CIDHASH);
+        }
+        CXPLAT_DBG_ASSERT(Connection->RefCount == 1);
+        CXPLAT_FREE(Connection, QUIC_POOL_TEST);
+    }
+    //
+    // Adds a new random CID to the lookup, the same way the connection does,
+    // and returns it, or NULL if it collided.
+    //
+    QUIC_CID_HASH_ENTRY* AddCid(QUIC_LOOKUP* Lookup, std::mt19937& Rng) {
+        uint8_t Data[QUIC_CID_MIN_LENGTH];
+        for (auto& Byte : Data) {
+            Byte = (uint8_t)Rng();
+        }
+        QUIC_CID_HASH_ENTRY* Cid = QuicCidNewSource(Connection, sizeof(Data), Data);
+        if (!QuicLookupAddLocalCid(Lookup, Cid, nullptr)) {
+            CXPLAT_FREE(Cid, QUIC_POOL_CIDHASH);
+            return nullptr;
+        }
+        CxPlatListPushEntry(&Connection->SourceCids, &Cid->Link);
+        return Cid;
+    }
+    //
+    // Removes the most recently created CID from the lookup and frees it.
+    //
+    void RemoveNewestCid(QUIC_LOOKUP* Lookup) {
+        QUIC_CID_HASH_ENTRY* Cid =
+            CXPLAT_CONTAINING_RECORD(Connection->SourceCids.Next, QUIC_CID_HASH_ENTRY, Link);
+        QuicLookupRemoveLocalCid(Lookup, Cid, &Connection->SourceCids.Next);
+        CXPLAT_FREE(Cid, QUIC_POOL_CIDHASH);
+    }
+};
+
+TEST(LookupTest, AddFindRemove)
+{
+    SetPartitionCount(4);
+    SmartLookup Lookup;
+    ASSERT_EQ(4u, Lookup.Lookup.PartitionCount);
+
+    std::mt19937 Rng(1);
+    std::vector<SmartConnection> Connections(50);
+    std::vector<QUIC_CID_HASH_ENTRY*> Cids;
+    for (auto& Connection : Connections) {
+        for (uint32_t i = 0; i < 4; ++i) {
+            QUIC_CID_HASH_ENTRY* Cid = Connection.AddCid(&Lookup.Lookup, Rng);
+            ASSERT_NE(nullptr, Cid);
+            ASSERT_TRUE(Cid->CID.IsInLookupTable);
+            Cids.push_back(Cid);
+        }
+    }
+    ASSERT_EQ(Cids.size(), Lookup.Lookup.CidCount);
+    for (auto Cid : Cids) {
+        ASSERT_EQ(Cid->Connection, Lookup.Find(Cid));
+    }
+
+    //
+    // Other lengths, including ones longer than any locally generated CID,
+    // never match.
+    //
+    uint8_t Longer[QUIC_MAX_CONNECTION_ID_LENGTH_V1] = {0};
+    CxPlatCopyMemory(Longer, Cids[0]->CID.Data, Cids[0]->CID.Length);
+    ASSERT_EQ(nullptr, Lookup.Find(Longer, Cids[0]->CID.Length + 1));
+    ASSERT_EQ(nullptr, Lookup.Find(Longer, sizeof(Longer)));
+    uint8_t Unknown[QUIC_CID_MIN_LENGTH] = {0};
+    ASSERT_EQ(nullptr, Lookup.Find(Unknown, sizeof(Unknown)));
+
+    //
+    // Adding the same CID again collides with its connection.
+    //
+    SmartConnection Other;
+    QUIC_CID_HASH_ENTRY* Duplicate =
+        QuicCidNewSource(Other.Connection, Cids[5]->CID.Length, Cids[5]->CID.Data);
+    CxPlatListPushEntry(&Other.Connection->SourceCids, &Duplicate->Link);
+    QUIC_CONNECTION* Collision;
+    ASSERT_FALSE(QuicLookupAddLocalCid(&Lookup.Lookup, Duplicate, &Collision));
+    ASSERT_EQ(Cids[5]->Connection, Collision);
+    QuicConnRelease(Collision, QUIC_CONN_REF_LOOKUP_RESULT);
+
+    for (auto& Connection : Connections) {
+        QuicLookupRemoveLocalCids(&Lookup.Lookup, Connection.Connection);
+        ASSERT_EQ(1, Connection.Connection->RefCount);
+    }
+    ASSERT_EQ(0u, Lookup.Lookup.CidCount);
+    uint8_t Removed[QUIC_CID_MIN_LENGTH];
+    CxPlatCopyMemory(Removed, Duplicate->CID.Data, sizeof(Removed));
+    ASSERT_EQ(nullptr, Lookup.Find(Removed, sizeof(Removed)));
+}
+
+TEST(LookupTest, Churn)
+{
+    //
+    // CIDs are constantly added and removed, as connections come and go and
+    // rotate their CIDs, so the tables are rebuilt many times over.
+    //
+    SetPartitionCount(2);
+    SmartLookup Lookup;
+    std::mt19937 Rng(2);
+    std::vector<SmartConnection> Connections(64);
+    std::map<std::vector<uint8_t>, QUIC_CONNECTION*> Expected;
+
+    for (uint32_t i = 0; i < 20000; ++i) {
+        SmartConnection& Connection = Connections[Rng() % Connections.size()];
+        if (Connection.Connection->SourceCids.Next != nullptr && Rng() % 2 == 0) {
+            QUIC_CID_HASH_ENTRY* Cid =
+                CXPLAT_CONTAINING_RECORD(
+                    Connection.Connection->SourceCids.Next, QUIC_CID_HASH_ENTRY, Link);
+            Expected.erase(std::vector<uint8_t>(Cid->CID.Data, Cid->CID.Data + Cid->CID.Length));
+            Connection.RemoveNewestCid(&Lookup.Lookup);
+        } else {
+            QUIC_CID_HASH_ENTRY* Cid = Connection.AddCid(&Lookup.Lookup, Rng);
+            ASSERT_NE(nullptr, Cid);
+            Expected[std::vector<uint8_t>(Cid->CID.Data, Cid->CID.Data + Cid->CID.Length)] =
+                Connection.Connection;
+        }
+        ASSERT_EQ(Expected.size(), Lookup.Lookup.CidCount);
+
+        if (i % 1000 == 0) {
+            for (auto& Entry : Expected) {
+                ASSERT_EQ(Entry.second, Lookup.Find(Entry.first.data(), (uint8_t)Entry.first.size()));
+            }
+        }
+    }
+
+    for (auto& Connection : Connections) {
+        QuicLookupRemoveLocalCids(&Lookup.Lookup, Connection.Connection);
+    }
+}
+
+TEST(LookupTest, RetiredWhileReading)
+{
+    //
+    // Removing a CID while a lock-free reader is active doesn't wait for it:
+    // the lookup's reference is retired and released by a later reader, once
+    // the one that might still be using it is gone.
+    //
+    SetPartitionCount(4);
+    SmartLookup Lookup;
+    std::mt19937 Rng(4);
+    SmartConnection Connection, Other;
+    QUIC_CID_HASH_ENTRY* OtherCid = Other.AddCid(&Lookup.Lookup, Rng);
+    ASSERT_NE(nullptr, OtherCid);
+    for (uint32_t i = 0; i < 4; ++i) {
+        ASSERT_NE(nullptr, Connection.AddCid(&Lookup.Lookup, Rng));
+    }
+    ASSERT_EQ(5, Connection.Connection->RefCount);
+
+    long* Active = QuicLookupReadBegin(&Lookup.Lookup);
+    Connection.RemoveNewestCid(&Lookup.Lookup);
+    QuicLookupRemoveLocalCids(&Lookup.Lookup, Connection.Connection);
+    ASSERT_EQ(0, Connection.Connection->SourceCids.Next);
+    ASSERT_EQ(5, Connection.Connection->RefCount);
+
+    //
+    // Readers that start after the removal don't hold it up.
+    //
+    ASSERT_EQ(Other.Connection, Lookup.Find(OtherCid));
+    ASSERT_EQ(5, Connection.Connection->RefCount);
+
+    QuicLookupReadEnd(Active);
+    ASSERT_EQ(Other.Connection, Lookup.Find(OtherCid));
+    ASSERT_EQ(1, Connection.Connection->RefCount);
+    ASSERT_EQ(0, Lookup.Lookup.RetiredCount);
+
+    QuicLookupRemoveLocalCids(&Lookup.Lookup, Other.Connection);
+}
+
+TEST(LookupTest, Rebalance)
+{
+    //
+    // A client binding starts with a single connection, is partitioned once
+    // it is shared, and then fully partitioned, all without losing any CIDs.
+    //
+    SetPartitionCount(8);
+    SmartLookup Lookup(false);
+    std::mt19937 Rng(3);
+    SmartConnection First, Second;
+    std::vector<QUIC_CID_HASH_ENTRY*> Cids;
+
+    for (uint32_t i = 0; i < 3; ++i) {
+        Cids.push_back(First.AddCid(&Lookup.Lookup, Rng));
+        ASSERT_NE(nullptr, Cids.back());
+    }
+    ASSERT_EQ(0u, Lookup.Lookup.PartitionCount);
+    ASSERT_EQ(First.Connection, Lookup.Find(Cids[0]));
+
+    Cids.push_back(Second.AddCid(&Lookup.Lookup, Rng));
+    ASSERT_NE(nullptr, Cids.back());
+    ASSERT_EQ(1u, Lookup.Lookup.PartitionCount);
+    for (auto Cid : Cids) {
+        ASSERT_EQ(Cid->Connection, Lookup.Find(Cid));
+    }
+
+    ASSERT_TRUE(QuicLookupMaximizePartitioning(&Lookup.Lookup));
+    ASSERT_EQ(8u, Lookup.Lookup.PartitionCount);
+    for (uint32_t i = 0; i < 100; ++i) {
+        Cids.push_back(Second.AddCid(&Lookup.Lookup, Rng));
+        ASSERT_NE(nullptr, Cids.back());
+    }
+    for (auto Cid : Cids) {
+        ASSERT_EQ(Cid->Connection, Lookup.Find(Cid));
+    }
+
+    QuicLookupRemoveLocalCids(&Lookup.Lookup, First.Connection);
+    QuicLookupRemoveLocalCids(&Lookup.Lookup, Second.Connection);
+    ASSERT_EQ(0u, Lookup.Lookup.CidCount);
+}
+
+TEST(LookupTest, SharedClient)
+{
+    //
+    // A client binding shared by many connections goes from one partition to
+    // all of them once it holds enough CIDs.
+    //
+    SetPartitionCount(8);
+    SmartLookup Lookup(false);
+    std::mt19937 Rng(5);
+    std::vector<SmartConnection> Connections(QUIC_LOOKUP_SHARED_PARTITION_CID_COUNT / 4);
+    std::vector<QUIC_CID_HASH_ENTRY*> Cids;
+
+    for (uint32_t i = 0; i < 4; ++i) {
+        for (auto& Connection : Connections) {
+            Cids.push_back(Connection.AddCid(&Lookup.Lookup, Rng));
+            ASSERT_NE(nullptr, Cids.back());
+            ASSERT_EQ(Cids.size() == 1 ? 0u : 1u, Lookup.Lookup.PartitionCount);
+        }
+    }
+    ASSERT_EQ((uint32_t)QUIC_LOOKUP_SHARED_PARTITION_CID_COUNT, Lookup.Lookup.CidCount);
+    ASSERT_EQ(1u, Lookup.Lookup.PartitionCount);
+
+    Cids.push_back(Connections[0].AddCid(&Lookup.Lookup, Rng));
+    ASSERT_NE(nullptr, Cids.back());
+    ASSERT_EQ(8u, Lookup.Lookup.PartitionCount);
+    for (auto Cid : Cids) {
+        ASSERT_EQ(Cid->Connection, Lookup.Find(Cid));
+    }
+
+    //
+    // It stays fully partitioned as connections go away.
+    //
+    for (size_t i = 1; i < Connections.size(); ++i) {
+        QuicLookupRemoveLocalCids(&Lookup.Lookup, Connections[i].Connection);
+    }
+    ASSERT_EQ(8u, Lookup.Lookup.PartitionCount);
+    Cids.push_back(Connections[0].AddCid(&Lookup.Lookup, Rng));
+    ASSERT_NE(nullptr, Cids.back());
+    ASSERT_EQ(8u, Lookup.Lookup.PartitionCount);
+    ASSERT_EQ(Connections[0].Connection, Lookup.Find(Cids.back()));
+    QuicLookupRemoveLocalCids(&Lookup.Lookup, Connections[0].Connection);
+    ASSERT_EQ(0u, Lookup.Lookup.CidCount);
+}
+
+//
+// Reader threads look up random existing CIDs, as the receive path does for
+// every datagram, while a writer thread keeps adding and removing other CIDs.
+// When Locked is set, every lookup also takes a shared reader-writer lock
+// (and every write takes it exclusively), like the lookup used to.
+//
+static
+void
+RunContention(
+    uint32_t ReaderCount,
+    bool Locked
+    )
+{
+    const uint32_t LookupsPerReader = 200000;
+    SetPartitionCount(4);
+    SmartLookup Lookup;
+    std::mt19937 Rng(4);
+    std::vector<SmartConnection> Connections(1024);
+    std::vector<QUIC_CID_HASH_ENTRY*> Cids;
+    for (auto& Connection : Connections) {
+        for (uint32_t i = 0; i < 2; ++i) {
+            Cids.push_back(Connection.AddCid(&Lookup.Lookup, Rng));
+            ASSERT_NE(nullptr, Cids.back());
+        }
+    }
+
+    CXPLAT_DISPATCH_RW_LOCK RwLock;
+    CxPlatDispatchRwLockInitialize(&RwLock);
+    std::atomic<bool> Done {false};
+    std::atomic<uint32_t> Mismatches {0};
+    uint64_t WriteCount = 0;
+
+    std::thread Writer([&]() {
+        std::mt19937 WriterRng(5);
+        SmartConnection Churn;
+        while (!Done) {
+            if (Locked) {
+                CxPlatDispatchRwLockAcquireExclusive(&RwLock);
+            }
+            QUIC_CID_HASH_ENTRY* Cid = Churn.AddCid(&Lookup.Lookup, WriterRng);
+            if (Locked) {
+                CxPlatDispatchRwLockReleaseExclusive(&RwLock);
+                CxPlatDispatchRwLockAcquireExclusive(&RwLock);
+            }
+            if (Cid != nullptr) {
+                Churn.RemoveNewestCid(&Lookup.Lookup);
+            }
+            if (Locked) {
+                CxPlatDispatchRwLockReleaseExclusive(&RwLock);
+            }
+            ++WriteCount;
+            std::this_thread::yield();
+        }
+    });
+
+    auto Start = std::chrono::steady_clock::now();
+    std::vector<std::thread> Readers;
+    for (uint32_t i = 0; i < ReaderCount; ++i) {
+        Readers.emplace_back([&, i]() {
+            std::mt19937 ReaderRng(100 + i);
+            for (uint32_t j = 0; j < LookupsPerReader; ++j) {
+                QUIC_CID_HASH_ENTRY* Cid = Cids[ReaderRng() % Cids.size()];
+                if (Locked) {
+                    CxPlatDispatchRwLockAcquireShared(&RwLock);
+                }
+                QUIC_CONNECTION* Connection =
+                    QuicLookupFindConnectionByLocalCid(
+                        &Lookup.Lookup, Cid->CID.Data, Cid->CID.Length);
+                if (Locked) {
+                    CxPlatDispatchRwLockReleaseShared(&RwLock);
+                }
+                if (Connection != Cid->Connection) {
+                    ++Mismatches;
+                }
+                if (Connection != nullptr) {
+                    QuicConnRelease(Connection, QUIC_CONN_REF_LOOKUP_RESULT);
+                }
+            }
+        });
+    }
+    for (auto& Reader : Readers) {
+        Reader.join();
+    }
+    auto Elapsed = std::chrono::steady_clock::now() - Start;
+    Done = true;
+    Writer.join();
+    CxPlatDispatchRwLockUninitialize(&RwLock);
+
+    ASSERT_EQ(0u, Mismatches.load());
+    uint64_t Ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Elapsed).count();
+    std::cout << "    " << ReaderCount << " readers" << (Locked ? " (shared lock)" : "") << ": "
+              << (double)ReaderCount * LookupsPerReader * 1000 / Ns << " M lookups/s, "
+              << WriteCount << " CIDs added and removed meanwhile" << std::endl;
+
+    for (auto& Connection : Connections) {
+        QuicLookupRemoveLocalCids(&Lookup.Lookup, Connection.Connection);
+    }
+}
+
+TEST(LookupTest, Contention)
+{
+    uint32_t MaxReaders = CXPLAT_MAX(1u, std::thread::hardware_concurrency());
+    for (uint32_t ReaderCount = 1; ; ReaderCount *= 2) {
+        ReaderCount = CXPLAT_MIN(ReaderCount, MaxReaders);
+        RunContention(ReaderCount, true);
+        RunContention(ReaderCount, false);
+        if (ReaderCount == MaxReaders) {
+            break;
+        }
+    }
+}
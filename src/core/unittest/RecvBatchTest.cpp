@@ -0,0 +1,336 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test and benchmark for grouping received datagrams by destination CID.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "RecvBatchTest.cpp.clog.h"
+#endif
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+extern "C"
+void
+MsQuicCalculatePartitionMask(
+    void
+    );
+
+//
+// A receive batch of datagrams, each with a 1-RTT or Initial packet header
+// and a destination CID, ready to be grouped.
+//
+struct TestDatagrams {
+    struct Datagram {
+        QUIC_RX_PACKET Packet;
+        uint8_t Buffer[32];
+    };
+    std::vector<Datagram> Datagrams;
+    TestDatagrams(size_t Count) : Datagrams(Count) {
+        CxPlatZeroMemory(Datagrams.data(), Count * sizeof(Datagram));
+    }
+    //
+    // Sets the i'th datagram's destination CID, and makes it an Initial
+    // (handshake) packet if requested.
+    //
+    void Set(size_t i, const uint8_t* Cid, uint8_t CidLength, bool Handshake = false) {
+        Datagram& D = Datagrams[i];
+        uint8_t* DestCid = D.Buffer + 1;
+        D.Buffer[0] = 0x40;
+        if (Handshake) {
+            D.Buffer[0] = 0xC0; // Initial
+            uint32_t Version = QUIC_VERSION_1;
+            CxPlatCopyMemory(D.Buffer + 1, &Version, sizeof(Version));
+            D.Buffer[5] = CidLength;
+            DestCid = D.Buffer + 6;
+        }
+        CXPLAT_FRE_ASSERT(DestCid + CidLength <= D.Buffer + sizeof(D.Buffer));
+        CxPlatCopyMemory(DestCid, Cid, CidLength);
+        D.Packet._.Next = nullptr;
+        D.Packet._.Buffer = D.Buffer;
+        D.Packet._.BufferLength = sizeof(D.Buffer);
+        D.Packet.AvailBuffer = D.Buffer;
+        D.Packet.DestCid = DestCid;
+        D.Packet.DestCidLen = CidLength;
+    }
+    QUIC_RX_PACKET* operator[](size_t i) {
+        return &Datagrams[i].Packet;
+    }
+};
+
+static
+std::vector<const QUIC_RX_PACKET*>
+GroupPackets(
+    const QUIC_RX_BATCH_GROUP* Group
+    )
+{
+    std::vector<const QUIC_RX_PACKET*> Packets;
+    for (const CXPLAT_RECV_DATA* Datagram = Group->Chain;
+         Datagram != nullptr;
+         Datagram = Datagram->Next) {
+        Packets.push_back((const QUIC_RX_PACKET*)Datagram);
+    }
+    return Packets;
+}
+
+TEST(RecvBatchTest, Interleaved)
+{
+    const uint8_t Cids[3][QUIC_CID_MIN_LENGTH] = {{1}, {2}, {3}};
+    TestDatagrams Datagrams(30);
+    for (size_t i = 0; i < 30; ++i) {
+        Datagrams.Set(i, Cids[i % 3], sizeof(Cids[0]));
+    }
+
+    QUIC_RX_BATCH Batch;
+    QuicRxBatchReset(&Batch);
+    for (size_t i = 0; i < 30; ++i) {
+        ASSERT_TRUE(QuicRxBatchAdd(&Batch, Datagrams[i], FALSE));
+    }
+
+    //
+    // One group per CID, in the order they were first seen, each holding its
+    // datagrams in the order they were received.
+    //
+    ASSERT_EQ(3u, Batch.GroupCount);
+    for (uint32_t i = 0; i < 3; ++i) {
+        auto Packets = GroupPackets(&Batch.Groups[i]);
+        ASSERT_EQ(10u, Packets.size());
+        ASSERT_EQ(10u, Batch.Groups[i].Length);
+        ASSERT_EQ(10u * 32, Batch.Groups[i].Bytes);
+        for (size_t j = 0; j < Packets.size(); ++j) {
+            ASSERT_EQ(Datagrams[i + j * 3], Packets[j]);
+        }
+        ASSERT_EQ(&Datagrams.Datagrams[i + 27].Packet._.Next, Batch.Groups[i].DataTail);
+    }
+}
+
+TEST(RecvBatchTest, HandshakeFirst)
+{
+    //
+    // Handshake packets are moved ahead of the others with the same CID, so
+    // that the head of a group shows whether it can create a connection.
+    //
+    const uint8_t Cid[QUIC_CID_MIN_LENGTH] = {1};
+    const uint8_t OtherCid[QUIC_CID_MIN_LENGTH] = {2};
+    TestDatagrams Datagrams(5);
+    Datagrams.Set(0, Cid, sizeof(Cid));
+    Datagrams.Set(1, OtherCid, sizeof(OtherCid));
+    Datagrams.Set(2, Cid, sizeof(Cid), true);
+    Datagrams.Set(3, Cid, sizeof(Cid));
+    Datagrams.Set(4, Cid, sizeof(Cid), true);
+
+    QUIC_RX_BATCH Batch;
+    QuicRxBatchReset(&Batch);
+    for (size_t i = 0; i < 5; ++i) {
+        ASSERT_TRUE(QuicRxBatchAdd(&Batch, Datagrams[i], FALSE));
+    }
+    ASSERT_EQ(2u, Batch.GroupCount);
+    auto Packets = GroupPackets(&Batch.Groups[0]);
+    ASSERT_EQ(4u, Packets.size());
+    ASSERT_EQ(Datagrams[2], Packets[0]);
+    ASSERT_EQ(Datagrams[4], Packets[1]);
+    ASSERT_EQ(Datagrams[0], Packets[2]);
+    ASSERT_EQ(Datagrams[3], Packets[3]);
+    ASSERT_EQ(&Datagrams.Datagrams[3].Packet._.Next, Batch.Groups[0].DataTail);
+}
+
+TEST(RecvBatchTest, Full)
+{
+    //
+    // Once the batch has as many groups as it can hold, datagrams with new
+    // CIDs are refused, but ones for existing groups are still added.
+    //
+    std::vector<std::vector<uint8_t>> Cids;
+    for (uint32_t i = 0; i <= QUIC_RX_BATCH_MAX_GROUPS; ++i) {
+        Cids.push_back(std::vector<uint8_t>(QUIC_CID_MIN_LENGTH, (uint8_t)i));
+    }
+    TestDatagrams Datagrams(QUIC_RX_BATCH_MAX_GROUPS + 2);
+    for (uint32_t i = 0; i <= QUIC_RX_BATCH_MAX_GROUPS; ++i) {
+        Datagrams.Set(i, Cids[i].data(), (uint8_t)Cids[i].size());
+    }
+    Datagrams.Set(QUIC_RX_BATCH_MAX_GROUPS + 1, Cids[0].data(), (uint8_t)Cids[0].size());
+
+    QUIC_RX_BATCH Batch;
+    QuicRxBatchReset(&Batch);
+    for (uint32_t i = 0; i < QUIC_RX_BATCH_MAX_GROUPS; ++i) {
+        ASSERT_TRUE(QuicRxBatchAdd(&Batch, Datagrams[i], FALSE));
+    }
+    ASSERT_FALSE(QuicRxBatchAdd(&Batch, Datagrams[QUIC_RX_BATCH_MAX_GROUPS], FALSE));
+    ASSERT_TRUE(QuicRxBatchAdd(&Batch, Datagrams[QUIC_RX_BATCH_MAX_GROUPS + 1], FALSE));
+    ASSERT_EQ((uint32_t)QUIC_RX_BATCH_MAX_GROUPS, Batch.GroupCount);
+    ASSERT_EQ(2u, Batch.Groups[0].Length);
+
+    QuicRxBatchReset(&Batch);
+    ASSERT_TRUE(QuicRxBatchAdd(&Batch, Datagrams[QUIC_RX_BATCH_MAX_GROUPS], FALSE));
+    ASSERT_EQ(1u, Batch.GroupCount);
+}
+
+TEST(RecvBatchTest, SingleGroup)
+{
+    //
+    // Exclusive bindings deliver everything to one connection, whatever the
+    // CID.
+    //
+    const uint8_t Cids[2][QUIC_CID_MIN_LENGTH] = {{1}, {2}};
+    TestDatagrams Datagrams(4);
+    for (size_t i = 0; i < 4; ++i) {
+        Datagrams.Set(i, Cids[i % 2], (uint8_t)(i % 2 == 0 ? 0 : sizeof(Cids[1])));
+    }
+    QUIC_RX_BATCH Batch;
+    QuicRxBatchReset(&Batch);
+    for (size_t i = 0; i < 4; ++i) {
+        ASSERT_TRUE(QuicRxBatchAdd(&Batch, Datagrams[i], TRUE));
+    }
+    ASSERT_EQ(1u, Batch.GroupCount);
+    ASSERT_EQ(4u, Batch.Groups[0].Length);
+}
+
+//
+// Looks up the connection for receive batches in which the datagrams of
+// several connections are interleaved, out of a lookup with many connections.
+// The baseline splits each batch into runs of consecutive datagrams with the
+// same CID, and looks up each run's connection, as receiving used to.
+//
+static
+void
+RunBatchLookups(
+    const char* Name,
+    uint32_t ConnectionsPerBatch,
+    bool Interleaved
+    )
+{
+    const uint32_t ConnectionCount = 4096;
+    const uint32_t BatchSize = 32;
+    const uint32_t BatchCount = 2000;
+
+    MsQuicLib.PartitionCount = 4;
+    MsQuicCalculatePartitionMask();
+    MsQuicLib.CidServerIdLength = 0;
+    MsQuicLib.CidTotalLength = QUIC_CID_MIN_LENGTH;
+
+    QUIC_LOOKUP Lookup;
+    QuicLookupInitialize(&Lookup);
+    ASSERT_TRUE(QuicLookupMaximizePartitioning(&Lookup));
+
+    std::mt19937 Rng(6);
+    std::vector<QUIC_CONNECTION*> Connections(ConnectionCount);
+    for (auto& Connection : Connections) {
+        Connection = (QUIC_CONNECTION*)CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_CONNECTION), QUIC_POOL_TEST);
+        ASSERT_NE(nullptr, Connection);
+        CxPlatZeroMemory(Connection, sizeof(QUIC_CONNECTION));
+        Connection->RefCount = 1;
+#if DEBUG
+        Connection->RefTypeCount[QUIC_CONN_REF_HANDLE_OWNER] = 1;
+#endif
+        uint8_t Data[QUIC_CID_MIN_LENGTH];
+        for (auto& Byte : Data) {
+            Byte = (uint8_t)Rng();
+        }
+        QUIC_CID_HASH_ENTRY* Cid = QuicCidNewSource(Connection, sizeof(Data), Data);
+        ASSERT_NE(nullptr, Cid);
+        ASSERT_TRUE(QuicLookupAddLocalCid(&Lookup, Cid, nullptr));
+        CxPlatListPushEntry(&Connection->SourceCids, &Cid->Link);
+    }
+
+    std::vector<TestDatagrams> Batches;
+    std::vector<std::vector<QUIC_CONNECTION*>> Expected;
+    for (uint32_t i = 0; i < BatchCount; ++i) {
+        std::vector<QUIC_CONNECTION*> Chosen(ConnectionsPerBatch);
+        for (auto& Connection : Chosen) {
+            Connection = Connections[Rng() % ConnectionCount];
+        }
+        Batches.emplace_back(BatchSize);
+        Expected.emplace_back(BatchSize);
+        for (uint32_t j = 0; j < BatchSize; ++j) {
+            QUIC_CONNECTION* Connection =
+                Interleaved ?
+                    Chosen[j % ConnectionsPerBatch] :
+                    Chosen[j * ConnectionsPerBatch / BatchSize];
+            const QUIC_CID_HASH_ENTRY* Cid =
+                CXPLAT_CONTAINING_RECORD(Connection->SourceCids.Next, QUIC_CID_HASH_ENTRY, Link);
+            Batches.back().Set(j, Cid->CID.Data, Cid->CID.Length);
+            Expected.back()[j] = Connection;
+        }
+    }
+
+    uint64_t RunLookups = 0;
+    auto Start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BatchCount; ++i) {
+        QUIC_CONNECTION* Connection = nullptr;
+        const QUIC_RX_PACKET* RunPacket = nullptr;
+        for (uint32_t j = 0; j < BatchSize; ++j) {
+            const QUIC_RX_PACKET* Packet = Batches[i][j];
+            if (RunPacket == nullptr ||
+                Packet->DestCidLen != RunPacket->DestCidLen ||
+                memcmp(Packet->DestCid, RunPacket->DestCid, Packet->DestCidLen) != 0) {
+                RunPacket = Packet;
+                Connection =
+                    QuicLookupFindConnectionByLocalCid(&Lookup, Packet->DestCid, Packet->DestCidLen);
+                ASSERT_EQ(Expected[i][j], Connection);
+                QuicConnRelease(Connection, QUIC_CONN_REF_LOOKUP_RESULT);
+                ++RunLookups;
+            }
+        }
+    }
+    auto RunElapsed = std::chrono::steady_clock::now() - Start;
+
+    uint64_t GroupLookups = 0;
+    QUIC_RX_BATCH Batch;
+    auto LookupGroups = [&]() {
+        for (uint32_t j = 0; j < Batch.GroupCount; ++j) {
+            const QUIC_RX_PACKET* Packet = (const QUIC_RX_PACKET*)Batch.Groups[j].Chain;
+            QUIC_CONNECTION* Connection =
+                QuicLookupFindConnectionByLocalCid(&Lookup, Packet->DestCid, Packet->DestCidLen);
+            ASSERT_NE(nullptr, Connection);
+            QuicConnRelease(Connection, QUIC_CONN_REF_LOOKUP_RESULT);
+            ++GroupLookups;
+        }
+        QuicRxBatchReset(&Batch);
+    };
+    Start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BatchCount; ++i) {
+        QuicRxBatchReset(&Batch);
+        for (uint32_t j = 0; j < BatchSize; ++j) {
+            if (!QuicRxBatchAdd(&Batch, Batches[i][j], FALSE)) {
+                LookupGroups();
+                ASSERT_TRUE(QuicRxBatchAdd(&Batch, Batches[i][j], FALSE));
+            }
+        }
+        LookupGroups();
+    }
+    auto GroupElapsed = std::chrono::steady_clock::now() - Start;
+
+    for (auto Connection : Connections) {
+        QuicLookupRemoveLocalCids(&Lookup, Connection);
+        CXPLAT_FREE(
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListPopEntry(&Connection->SourceCids), QUIC_CID_HASH_ENTRY, Link),
+            QUIC_POOL_CIDHASH);
+        CXPLAT_FREE(Connection, QUIC_POOL_TEST);
+    }
+    QuicLookupUninitialize(&Lookup);
+
+    auto NsPerDatagram = [&](std::chrono::steady_clock::duration Elapsed) {
+        return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(Elapsed).count() /
+            ((double)BatchCount * BatchSize);
+    };
+    std::cout << "    " << Name << ": grouped " << NsPerDatagram(GroupElapsed) << " ns/datagram, "
+              << (double)GroupLookups / BatchCount << " lookups/batch; "
+              << "split into runs " << NsPerDatagram(RunElapsed) << " ns/datagram, "
+              << (double)RunLookups / BatchCount << " lookups/batch" << std::endl;
+}
+
+TEST(RecvBatchTest, InterleavedLookups)
+{
+    RunBatchLookups("8 connections interleaved", 8, true);
+    RunBatchLookups("32 connections interleaved", 32, true);
+    RunBatchLookups("4 connections in sequence", 4, false);
+}
@@ -52,6 +52,42 @@ struct RecvBuffer {
     void IncreaseVirtualBufferLength(uint32_t Length) {
         QuicRecvBufferIncreaseVirtualBufferLength(&RecvBuf, Length);
     }
+    // Provides ChunkCount consecutive chunks of Buffer, in app-owned mode.
+    QUIC_STATUS ProvideChunks(
+        _In_ uint8_t* Buffer,
+        _In_ uint32_t ChunkCount,
+        _In_ uint32_t ChunkLength
+        ) {
+        CXPLAT_LIST_ENTRY Chunks;
+        CxPlatListInitializeHead(&Chunks);
+        for (uint32_t i = 0; i < ChunkCount; ++i) {
+            auto Chunk =
+                (QUIC_RECV_CHUNK*)CXPLAT_ALLOC_NONPAGED(
+                    sizeof(QUIC_RECV_CHUNK),
+                    QUIC_POOL_RECVBUF);
+            CXPLAT_FRE_ASSERT(Chunk);
+            QuicRecvChunkInitialize(Chunk, ChunkLength, Buffer + i * ChunkLength);
+            CxPlatListInsertTail(&Chunks, &Chunk->Link);
+        }
+        printf("Provide: Count=%u, Length=%u\n", ChunkCount, ChunkLength);
+        auto Status = QuicRecvBufferProvideChunks(&RecvBuf, &Chunks);
+        while (!CxPlatListIsEmpty(&Chunks)) {
+            CXPLAT_FREE(
+                CXPLAT_CONTAINING_RECORD(CxPlatListRemoveHead(&Chunks), QUIC_RECV_CHUNK, Link),
+                QUIC_POOL_RECVBUF);
+        }
+        Dump();
+        return Status;
+    }
+    uint32_t ChunkCount() {
+        uint32_t Count = 0;
+        for (CXPLAT_LIST_ENTRY* Entry = RecvBuf.Chunks.Flink;
+            Entry != &RecvBuf.Chunks;
+            Entry = Entry->Flink) {
+            ++Count;
+        }
+        return Count;
+    }
     QUIC_STATUS Write(
         _In_ uint64_t WriteOffset,
         _In_ uint16_t WriteLength,
@@ -65,11 +101,28 @@ struct RecvBuffer {
             BufferToWrite[i] = (uint8_t)(WriteOffset + i);
         }
         printf("Write: Offset=%llu, Length=%u\n", (unsigned long long)WriteOffset, WriteLength);
-        auto Status = QuicRecvBufferWrite(&RecvBuf, WriteOffset, WriteLength, BufferToWrite, WriteLimit, NewDataReady);
+        auto Status = QuicRecvBufferWrite(&RecvBuf, WriteOffset, WriteLength, BufferToWrite, NULL, WriteLimit, NewDataReady);
         delete [] BufferToWrite;
         Dump();
         return Status;
     }
+    // Writes data in place from a (fake) received packet, for zero copy mode.
+    QUIC_STATUS WriteFromPacket(
+        _In_ QUIC_RX_PACKET* Packet,
+        _In_ uint8_t* Payload,
+        _In_ uint64_t WriteOffset,
+        _In_ uint16_t WriteLength,
+        _Out_ BOOLEAN* NewDataReady
+        ) {
+        for (uint16_t i = 0; i < WriteLength; ++i) {
+            Payload[i] = (uint8_t)(WriteOffset + i);
+        }
+        uint64_t WriteLimit = LARGE_TEST_BUFFER_LENGTH;
+        printf("Write (packet): Offset=%llu, Length=%u\n", (unsigned long long)WriteOffset, WriteLength);
+        auto Status = QuicRecvBufferWrite(&RecvBuf, WriteOffset, WriteLength, Payload, Packet, &WriteLimit, NewDataReady);
+        Dump();
+        return Status;
+    }
     void Read(
         _Out_ uint64_t* BufferOffset,
         _Inout_ uint32_t* BufferCount,
@@ -1451,6 +1504,249 @@ TEST(MultiRecvTest, ReadPendingOver2Chunk)
     RecvBuf.Drain(8);
 }
 
+TEST(AppOwnedRecvTest, WriteAndReadInPlace)
+{
+    RecvBuffer RecvBuf;
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, RecvBuf.Initialize(QUIC_RECV_BUF_MODE_APP_OWNED));
+    ASSERT_EQ(0u, RecvBuf.RecvBuf.VirtualBufferLength);
+    ASSERT_EQ(0u, RecvBuf.ChunkCount());
+
+    uint64_t InOutWriteLength = LARGE_TEST_BUFFER_LENGTH;
+    BOOLEAN NewDataReady = FALSE;
+    ASSERT_EQ( // No buffers provided yet
+        QUIC_STATUS_OUT_OF_MEMORY,
+        RecvBuf.Write(0, 8, &InOutWriteLength, &NewDataReady));
+
+    uint8_t AppBuffer[64];
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, RecvBuf.ProvideChunks(AppBuffer, 2, 32));
+    ASSERT_EQ(64u, RecvBuf.RecvBuf.VirtualBufferLength);
+
+    InOutWriteLength = LARGE_TEST_BUFFER_LENGTH;
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        RecvBuf.Write(0, 40, &InOutWriteLength, &NewDataReady));
+    ASSERT_TRUE(NewDataReady);
+    RecvBuffer::ValidateBuffer(AppBuffer, 40, 0); // Written directly to the app's buffer
+
+    uint64_t ReadOffset;
+    QUIC_BUFFER ReadBuffers[3];
+    uint32_t BufferCount = ARRAYSIZE(ReadBuffers);
+    RecvBuf.Read(&ReadOffset, &BufferCount, ReadBuffers);
+    ASSERT_EQ(0ull, ReadOffset);
+    ASSERT_EQ(2u, BufferCount);
+    ASSERT_EQ(AppBuffer, ReadBuffers[0].Buffer);
+    ASSERT_EQ(32u, ReadBuffers[0].Length);
+    ASSERT_EQ(AppBuffer + 32, ReadBuffers[1].Buffer);
+    ASSERT_EQ(8u, ReadBuffers[1].Length);
+
+    ASSERT_TRUE(RecvBuf.Drain(40));
+    ASSERT_EQ(1u, RecvBuf.ChunkCount()); // The first chunk was given back
+    ASSERT_EQ(8u, RecvBuf.RecvBuf.ReadStart);
+    ASSERT_EQ(24u, RecvBuf.RecvBuf.VirtualBufferLength);
+
+    InOutWriteLength = LARGE_TEST_BUFFER_LENGTH;
+    ASSERT_EQ(
+        QUIC_STATUS_OUT_OF_MEMORY,
+        RecvBuf.Write(40, 30, &InOutWriteLength, &NewDataReady));
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, RecvBuf.ProvideChunks(AppBuffer, 1, 32)); // Reuse the returned space
+    InOutWriteLength = LARGE_TEST_BUFFER_LENGTH;
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        RecvBuf.Write(40, 30, &InOutWriteLength, &NewDataReady));
+    ASSERT_TRUE(NewDataReady);
+
+    BufferCount = ARRAYSIZE(ReadBuffers);
+    RecvBuf.Read(&ReadOffset, &BufferCount, ReadBuffers);
+    ASSERT_EQ(40ull, ReadOffset);
+    ASSERT_EQ(2u, BufferCount);
+    ASSERT_EQ(AppBuffer + 40, ReadBuffers[0].Buffer);
+    ASSERT_EQ(24u, ReadBuffers[0].Length);
+    ASSERT_EQ(AppBuffer, ReadBuffers[1].Buffer);
+    ASSERT_EQ(6u, ReadBuffers[1].Length);
+    ASSERT_TRUE(RecvBuf.Drain(30));
+    ASSERT_EQ(1u, RecvBuf.ChunkCount());
+    ASSERT_EQ(26u, RecvBuf.RecvBuf.VirtualBufferLength);
+}
+
+TEST(AppOwnedRecvTest, OutOfOrderAcrossChunks)
+{
+    RecvBuffer RecvBuf;
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, RecvBuf.Initialize(QUIC_RECV_BUF_MODE_APP_OWNED));
+    uint8_t AppBuffer[32];
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, RecvBuf.ProvideChunks(AppBuffer, 4, 8));
+
+    uint64_t InOutWriteLength = LARGE_TEST_BUFFER_LENGTH;
+    BOOLEAN NewDataReady = FALSE;
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        RecvBuf.Write(12, 20, &InOutWriteLength, &NewDataReady));
+    ASSERT_FALSE(NewDataReady);
+    InOutWriteLength = LARGE_TEST_BUFFER_LENGTH;
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        RecvBuf.Write(0, 14, &InOutWriteLength, &NewDataReady));
+    ASSERT_TRUE(NewDataReady);
+    RecvBuffer::ValidateBuffer(AppBuffer, 32, 0);
+
+    //
+    // Only as many chunks as there are buffers are indicated at once.
+    //
+    uint64_t ReadOffset;
+    QUIC_BUFFER ReadBuffers[3];
+    uint32_t BufferCount = ARRAYSIZE(ReadBuffers);
+    RecvBuf.Read(&ReadOffset, &BufferCount, ReadBuffers);
+    ASSERT_EQ(0ull, ReadOffset);
+    ASSERT_EQ(3u, BufferCount);
+    ASSERT_FALSE(RecvBuf.Drain(24));
+    ASSERT_TRUE(RecvBuf.HasUnreadData());
+    ASSERT_EQ(1u, RecvBuf.ChunkCount());
+
+    BufferCount = ARRAYSIZE(ReadBuffers);
+    RecvBuf.Read(&ReadOffset, &BufferCount, ReadBuffers);
+    ASSERT_EQ(24ull, ReadOffset);
+    ASSERT_EQ(1u, BufferCount);
+    ASSERT_EQ(AppBuffer + 24, ReadBuffers[0].Buffer);
+    ASSERT_EQ(8u, ReadBuffers[0].Length);
+
+    //
+    // A partial drain keeps the chunk until it's fully consumed.
+    //
+    ASSERT_FALSE(RecvBuf.Drain(5));
+    ASSERT_EQ(1u, RecvBuf.ChunkCount());
+    BufferCount = ARRAYSIZE(ReadBuffers);
+    RecvBuf.Read(&ReadOffset, &BufferCount, ReadBuffers);
+    ASSERT_EQ(29ull, ReadOffset);
+    ASSERT_EQ(1u, BufferCount);
+    ASSERT_EQ(3u, ReadBuffers[0].Length);
+    ASSERT_TRUE(RecvBuf.Drain(3));
+    ASSERT_EQ(0u, RecvBuf.ChunkCount());
+    ASSERT_EQ(0u, RecvBuf.RecvBuf.VirtualBufferLength);
+}
+
+//
+// A fake 1-RTT datagram, for zero copy mode. The receive path's own reference
+// is never released, so it is never returned to the (non-existent) datapath.
+//
+struct FakeDatagram {
+    QUIC_RX_PACKET Packet;
+    uint8_t Payload[DEF_TEST_BUFFER_LENGTH];
+    FakeDatagram() {
+        CxPlatZeroMemory(&Packet, sizeof(Packet));
+        Packet.IsShortHeader = TRUE;
+    }
+};
+
+TEST(ZeroCopyRecvTest, InOrderInPlace)
+{
+    RecvBuffer RecvBuf;
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, RecvBuf.Initialize(QUIC_RECV_BUF_MODE_ZERO_COPY));
+    ASSERT_EQ((uint32_t)DEF_TEST_BUFFER_LENGTH, RecvBuf.RecvBuf.VirtualBufferLength);
+    ASSERT_EQ(0u, RecvBuf.ChunkCount());
+
+    FakeDatagram Datagrams[2];
+    BOOLEAN NewDataReady = FALSE;
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        RecvBuf.WriteFromPacket(&Datagrams[0].Packet, Datagrams[0].Payload, 0, 20, &NewDataReady));
+    ASSERT_TRUE(NewDataReady);
+    ASSERT_EQ(2u, Datagrams[0].Packet.RetainCount);
+    ASSERT_EQ(
+        QUIC_STATUS_SUCCESS,
+        RecvBuf.WriteFromPacket(&Datagrams[1].Packet, Datagrams[1].Payload, 20, 20, &NewDataReady));
+    ASSERT_TRUE(NewDataReady);
+    ASSERT_EQ(2u, Datagrams[1].Packet.RetainCount);
+    ASSERT_EQ(2u, RecvBuf.ChunkCount());
+
+    //
+    // The data is indicated directly from the datagrams.
+    //
+    uint64_t ReadOffset;
+    QUIC_BUFFER ReadBuffers[3];
+    uint32_t BufferCount = ARRAYSIZE(ReadBuffers);
+    RecvBuf.Read(&ReadOffset, &BufferCount, ReadBuffers);
+    ASSERT_EQ(0ull, ReadOffset);
+    ASSERT_EQ(2u, BufferCount);
+    ASSERT_EQ(Datagrams[0].Payload, ReadBuffers[0].Buffer);
+    ASSERT_EQ(20u, ReadBuffers[0].Length);
+    ASSERT_EQ(Datagrams[1].Payload, ReadBuffers[1].Buffer);
+    ASSERT_EQ(20u, ReadBuffers[1].Length);
+
+    //
+    // Datagrams are released as soon as all their data is drained.
+    //
+    ASSERT_FALSE(RecvBuf.Drain(30));
+    ASSERT_EQ(1u, Datagrams[0].Packet.RetainCount);
+    ASSERT_EQ(2u, Datagrams[1].Packet.RetainCount);
+    ASSERT_EQ(1u, RecvBuf.ChunkCount());
+
+    BufferCount = ARRAYSIZE(ReadBuffers);
+    RecvBuf.Read(&ReadOffset, &BufferCount, ReadBuffers);
+    ASSERT_EQ(30ull, ReadOffset);
+    ASSERT_EQ(1u, BufferCount);
+    ASSERT_EQ(Datagrams[1].Payload + 10, ReadBuffers[0].Buffer);
+    ASSERT_TRUE(RecvBuf.Drain(10));
+    ASSERT_EQ(1u, Datagrams[1].Packet.RetainCount);
+    ASSERT_EQ(0u, RecvBuf.ChunkCount());
+    ASSERT_EQ((uint32_t)DEF_TEST_BUFFER_LENGTH, RecvBuf.RecvBuf.VirtualBufferLength);
+}
+
+TEST(ZeroCopyRecvTest, OutOfOrderCopied)
+{
+    FakeDatagram Datagrams[4];
+    {
+        RecvBuffer RecvBuf;
+        ASSERT_EQ(QUIC_STATUS_SUCCESS, RecvBuf.Initialize(QUIC_RECV_BUF_MODE_ZERO_COPY));
+
+        //
+        // Data after a gap, and then data filling the gap, is copied.
+        //
+        BOOLEAN NewDataReady = FALSE;
+        ASSERT_EQ(
+            QUIC_STATUS_SUCCESS,
+            RecvBuf.WriteFromPacket(&Datagrams[0].Packet, Datagrams[0].Payload, 20, 20, &NewDataReady));
+        ASSERT_FALSE(NewDataReady);
+        ASSERT_EQ(
+            QUIC_STATUS_SUCCESS,
+            RecvBuf.WriteFromPacket(&Datagrams[1].Packet, Datagrams[1].Payload, 0, 20, &NewDataReady));
+        ASSERT_TRUE(NewDataReady);
+        ASSERT_EQ(0u, Datagrams[0].Packet.RetainCount);
+        ASSERT_EQ(0u, Datagrams[1].Packet.RetainCount);
+        ASSERT_EQ(1u, RecvBuf.ChunkCount());
+
+        //
+        // Only the new part of overlapping data is used in place.
+        //
+        ASSERT_EQ(
+            QUIC_STATUS_SUCCESS,
+            RecvBuf.WriteFromPacket(&Datagrams[2].Packet, Datagrams[2].Payload, 30, 20, &NewDataReady));
+        ASSERT_TRUE(NewDataReady);
+        ASSERT_EQ(2u, Datagrams[2].Packet.RetainCount);
+        ASSERT_EQ(2u, RecvBuf.ChunkCount());
+
+        uint64_t ReadOffset;
+        QUIC_BUFFER ReadBuffers[3];
+        uint32_t BufferCount = ARRAYSIZE(ReadBuffers);
+        RecvBuf.Read(&ReadOffset, &BufferCount, ReadBuffers);
+        ASSERT_EQ(0ull, ReadOffset);
+        ASSERT_EQ(2u, BufferCount);
+        ASSERT_EQ(40u, ReadBuffers[0].Length);
+        ASSERT_EQ(Datagrams[2].Payload + 10, ReadBuffers[1].Buffer);
+        ASSERT_EQ(10u, ReadBuffers[1].Length);
+        ASSERT_TRUE(RecvBuf.Drain(50));
+        ASSERT_EQ(1u, Datagrams[2].Packet.RetainCount);
+
+        //
+        // Data that hasn't been drained yet is released on cleanup.
+        //
+        ASSERT_EQ(
+            QUIC_STATUS_SUCCESS,
+            RecvBuf.WriteFromPacket(&Datagrams[3].Packet, Datagrams[3].Payload, 50, 10, &NewDataReady));
+        ASSERT_TRUE(NewDataReady);
+        ASSERT_EQ(2u, Datagrams[3].Packet.RetainCount);
+    }
+    ASSERT_EQ(1u, Datagrams[3].Packet.RetainCount);
+}
+
 INSTANTIATE_TEST_SUITE_P(
     RecvBufferTest,
     WithMode,
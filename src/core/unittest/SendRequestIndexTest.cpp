@@ -0,0 +1,225 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test for the stream send request offset index.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "SendRequestIndexTest.cpp.clog.h"
+#endif
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+struct SmartSendRequestQueue {
+    QUIC_STREAM* Stream;
+    std::vector<QUIC_SEND_REQUEST> Requests;
+    uint32_t Next {0};
+    uint32_t First {0};
+    SmartSendRequestQueue(uint32_t RequestCount) : Requests(RequestCount) {
+        Stream = (QUIC_STREAM*)CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_STREAM), QUIC_POOL_TEST);
+        CxPlatZeroMemory(Stream, sizeof(QUIC_STREAM));
+        Stream->SendRequestsTail = &Stream->SendRequests;
+        CxPlatZeroMemory(Requests.data(), RequestCount * sizeof(QUIC_SEND_REQUEST));
+    }
+    ~SmartSendRequestQueue() {
+        while (Stream->SendRequests != NULL) {
+            RemoveFirst();
+        }
+        CXPLAT_DBG_ASSERT(Stream->SendRequestIndex == NULL);
+        CXPLAT_FREE(Stream, QUIC_POOL_TEST);
+    }
+    //
+    // Queues the next request the same way QuicStreamEnqueueSendRequest does.
+    //
+    QUIC_SEND_REQUEST* Enqueue(uint64_t Length) {
+        QUIC_SEND_REQUEST* Req = &Requests[Next++];
+        Req->TotalLength = Length;
+        Req->StreamOffset = Stream->QueuedSendOffset;
+        Stream->QueuedSendOffset += Length;
+        *Stream->SendRequestsTail = Req;
+        Stream->SendRequestsTail = &Req->Next;
+        QuicStreamSendRequestIndexAppend(Stream, Req);
+        return Req;
+    }
+    //
+    // Pops the first request the same way acknowledging it does.
+    //
+    void RemoveFirst() {
+        QUIC_SEND_REQUEST* Req = Stream->SendRequests;
+        Stream->SendRequests = Req->Next;
+        if (Stream->SendRequests == NULL) {
+            Stream->SendRequestsTail = &Stream->SendRequests;
+        }
+        QuicStreamSendRequestIndexRemoveFirst(Stream);
+        if (Stream->SendBookmark == Req) {
+            Stream->SendBookmark = Req->Next;
+        }
+        ++First;
+    }
+    //
+    // Pops every request that ends at or before Offset.
+    //
+    void AckTo(uint64_t Offset) {
+        while (Stream->SendRequests != NULL &&
+            Stream->SendRequests->StreamOffset + Stream->SendRequests->TotalLength <= Offset) {
+            RemoveFirst();
+        }
+    }
+    QUIC_SEND_REQUEST* Find(uint64_t Offset) const {
+        return QuicStreamFindSendRequest(Stream, Offset);
+    }
+    //
+    // Reference lookup: a full walk of the queue from the front.
+    //
+    QUIC_SEND_REQUEST* Walk(uint64_t Offset) const {
+        QUIC_SEND_REQUEST* Req = Stream->SendRequests;
+        while (Req->StreamOffset + Req->TotalLength <= Offset) {
+            Req = Req->Next;
+        }
+        return Req;
+    }
+};
+
+TEST(SendRequestIndexTest, ShortQueue)
+{
+    SmartSendRequestQueue Queue(QUIC_SEND_REQUEST_INDEX_THRESHOLD + 1);
+    for (uint32_t i = 0; i < QUIC_SEND_REQUEST_INDEX_THRESHOLD; ++i) {
+        Queue.Enqueue(100);
+    }
+    ASSERT_EQ(nullptr, Queue.Stream->SendRequestIndex);
+    ASSERT_EQ(&Queue.Requests[3], Queue.Find(399));
+    ASSERT_EQ(&Queue.Requests[4], Queue.Find(400));
+
+    //
+    // Crossing the threshold builds the index, and draining the queue frees it.
+    //
+    Queue.Enqueue(100);
+    ASSERT_NE(nullptr, Queue.Stream->SendRequestIndex);
+    ASSERT_EQ(QUIC_SEND_REQUEST_INDEX_THRESHOLD + 1, Queue.Stream->SendRequestCount);
+    ASSERT_EQ(&Queue.Requests[3], Queue.Find(399));
+    ASSERT_EQ(&Queue.Requests[QUIC_SEND_REQUEST_INDEX_THRESHOLD], Queue.Find(1699));
+    Queue.AckTo(1700);
+    ASSERT_EQ(nullptr, Queue.Stream->SendRequests);
+    ASSERT_EQ(nullptr, Queue.Stream->SendRequestIndex);
+    ASSERT_EQ(0u, Queue.Stream->SendRequestCount);
+}
+
+TEST(SendRequestIndexTest, EmptyRequests)
+{
+    //
+    // Empty requests share their offset with the next request; lookups always
+    // resolve to the request actually holding the byte.
+    //
+    SmartSendRequestQueue Queue(100);
+    for (uint32_t i = 0; i < 100; ++i) {
+        Queue.Enqueue(i % 3 == 0 ? 0 : 10);
+    }
+    ASSERT_NE(nullptr, Queue.Stream->SendRequestIndex);
+    for (uint64_t Offset = 0; Offset < Queue.Stream->QueuedSendOffset; ++Offset) {
+        QUIC_SEND_REQUEST* Req = Queue.Find(Offset);
+        ASSERT_EQ(Queue.Walk(Offset), Req);
+        ASSERT_NE(0u, Req->TotalLength);
+    }
+}
+
+TEST(SendRequestIndexTest, Wrap)
+{
+    //
+    // A steady window of queued requests slides through the index many times
+    // without needing to rebuild it.
+    //
+    const uint32_t Window = 50;
+    SmartSendRequestQueue Queue(10000);
+    QUIC_SEND_REQUEST** Index = nullptr;
+    for (uint32_t i = 0; i < 10000; ++i) {
+        Queue.Enqueue(1 + i % 7);
+        if (i >= Window) {
+            Queue.RemoveFirst();
+            if (Index == nullptr) {
+                Index = Queue.Stream->SendRequestIndex;
+            }
+            ASSERT_EQ(Index, Queue.Stream->SendRequestIndex);
+        }
+        uint64_t Offset = Queue.Stream->SendRequests->StreamOffset + i % 97;
+        if (Offset < Queue.Stream->QueuedSendOffset) {
+            ASSERT_EQ(Queue.Walk(Offset), Queue.Find(Offset));
+        }
+    }
+    ASSERT_EQ(64u, Queue.Stream->SendRequestIndexCapacity);
+    ASSERT_EQ(Window, Queue.Stream->SendRequestCount);
+}
+
+TEST(SendRequestIndexTest, RetransmitStress)
+{
+    //
+    // 100k requests are queued and sent, and 5% of the packets are lost. Every
+    // lost packet's offset is before the send bookmark, so each retransmission
+    // has to find its request from scratch, while the acknowledged requests
+    // are completed from the front of the queue.
+    //
+    const uint32_t RequestCount = 100000;
+    const uint16_t PacketPayload = 1200;
+    SmartSendRequestQueue Queue(RequestCount);
+    std::mt19937 Rng(1234);
+
+    for (uint32_t i = 0; i < RequestCount; ++i) {
+        Queue.Enqueue(Rng() % 50 == 0 ? 0 : 1 + Rng() % 4000);
+    }
+    ASSERT_EQ(RequestCount, Queue.Stream->SendRequestCount);
+    ASSERT_GE(Queue.Stream->SendRequestIndexCapacity, RequestCount);
+    Queue.Stream->SendBookmark = &Queue.Requests[RequestCount - 1];
+
+    std::vector<uint64_t> Lost;
+    for (uint64_t Offset = 0; Offset < Queue.Stream->QueuedSendOffset; Offset += PacketPayload) {
+        if (Rng() % 100 < 5) {
+            Lost.push_back(Offset);
+        }
+    }
+    ASSERT_FALSE(Lost.empty());
+
+    //
+    // Time the lookups against a full walk of the queue before anything is
+    // acknowledged.
+    //
+    auto Start = std::chrono::steady_clock::now();
+    uintptr_t Check = 0;
+    for (auto Offset : Lost) {
+        Check += (uintptr_t)Queue.Find(Offset);
+    }
+    auto IndexElapsed = std::chrono::steady_clock::now() - Start;
+    Start = std::chrono::steady_clock::now();
+    uintptr_t WalkCheck = 0;
+    for (auto Offset : Lost) {
+        WalkCheck += (uintptr_t)Queue.Walk(Offset);
+    }
+    auto WalkElapsed = std::chrono::steady_clock::now() - Start;
+    ASSERT_EQ(WalkCheck, Check);
+
+    //
+    // Retransmit the lost packets in order, acknowledging everything before
+    // each one as its retransmission completes.
+    //
+    for (auto Offset : Lost) {
+        QUIC_SEND_REQUEST* Req = Queue.Find(Offset);
+        ASSERT_EQ(Queue.Walk(Offset), Req);
+        ASSERT_LE(Req->StreamOffset, Offset);
+        ASSERT_GT(Req->StreamOffset + Req->TotalLength, Offset);
+        Queue.AckTo(Offset);
+        ASSERT_EQ(RequestCount - Queue.First, Queue.Stream->SendRequestCount);
+    }
+
+    auto NsPerOp = [](std::chrono::steady_clock::duration Elapsed, uint64_t Count) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Elapsed).count() / Count;
+    };
+    std::cout << "    retransmit lookup (index): " << NsPerOp(IndexElapsed, Lost.size()) << " ns, "
+              << "(queue walk): " << NsPerOp(WalkElapsed, Lost.size()) << " ns ("
+              << RequestCount << " queued, " << Lost.size() << " lost)" << std::endl;
+}
@@ -0,0 +1,182 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test for the sent frame metadata arena.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "SentFrameArenaTest.cpp.clog.h"
+#endif
+
+#include <deque>
+#include <vector>
+
+struct SmartSentFrameArena {
+    QUIC_SENT_PACKET_POOL Pool;
+    QUIC_SENT_FRAME_ARENA Arena;
+    struct Allocation {
+        void* Ptr;
+        uint16_t Offset;
+    };
+    SmartSentFrameArena() {
+        QuicSentPacketPoolInitialize(&Pool);
+        QuicSentFrameArenaInitialize(&Arena);
+    }
+    ~SmartSentFrameArena() {
+        QuicSentFrameArenaUninitialize(&Arena, &Pool);
+        QuicSentPacketPoolUninitialize(&Pool);
+    }
+    Allocation Alloc(uint16_t Size) {
+        Allocation A;
+        A.Ptr = QuicSentFrameArenaAlloc(&Arena, &Pool, Size, &A.Offset);
+        return A;
+    }
+    void Release(const Allocation& A) {
+        QuicSentFrameArenaRelease(&Arena, &Pool, A.Ptr, A.Offset);
+    }
+};
+
+TEST(SentFrameArenaTest, Layout)
+{
+    ASSERT_EQ(64u, sizeof(QUIC_SENT_PACKET_METADATA));
+    ASSERT_EQ(24u, sizeof(QUIC_SENT_FRAME_METADATA));
+    ASSERT_EQ(
+        sizeof(QUIC_SENT_PACKET_METADATA),
+        FIELD_OFFSET(QUIC_SENT_PACKET_METADATA, Frame) + sizeof(QUIC_SENT_FRAME_METADATA));
+}
+
+TEST(SentFrameArenaTest, InlineFrame)
+{
+    SmartSentFrameArena Arena;
+
+    //
+    // A single frame is stored in the packet metadata itself, without using
+    // the arena.
+    //
+    QUIC_SENT_PACKET_METADATA* Single =
+        QuicSentPacketPoolGetPacketMetadata(&Arena.Pool, &Arena.Arena, 1);
+    ASSERT_NE(nullptr, Single);
+    ASSERT_TRUE(Single->FramesInline);
+    ASSERT_EQ(&Single->Frame, QuicSentPacketMetadataGetFrames(Single));
+    ASSERT_EQ(1u, Arena.Arena.PacketCount);
+#ifndef _WIN32
+    ASSERT_EQ(0u, ((size_t)Single) % 64);
+#endif
+
+    QUIC_SENT_PACKET_METADATA* Multiple =
+        QuicSentPacketPoolGetPacketMetadata(&Arena.Pool, &Arena.Arena, 3);
+    ASSERT_NE(nullptr, Multiple);
+    ASSERT_FALSE(Multiple->FramesInline);
+    ASSERT_EQ(Multiple->Frames, QuicSentPacketMetadataGetFrames(Multiple));
+    ASSERT_EQ(sizeof(QUIC_SENT_FRAME_CHUNK), (size_t)Multiple->FrameOffset);
+
+    Arena.Release({Multiple->Frames, Multiple->FrameOffset});
+    Arena.Arena.PacketCount -= 2;
+    CxPlatPoolFree(&Arena.Pool.PacketPool, Multiple);
+    CxPlatPoolFree(&Arena.Pool.PacketPool, Single);
+}
+
+TEST(SentFrameArenaTest, AllocRelease)
+{
+    SmartSentFrameArena Arena;
+    std::vector<SmartSentFrameArena::Allocation> Allocations;
+
+    //
+    // Fill more than one chunk with single frame allocations.
+    //
+    const uint32_t PerChunk =
+        (QUIC_SENT_FRAME_CHUNK_SIZE - sizeof(QUIC_SENT_FRAME_CHUNK)) /
+        sizeof(QUIC_SENT_FRAME_METADATA);
+    for (uint32_t i = 0; i < PerChunk + 1; ++i) {
+        auto A = Arena.Alloc(sizeof(QUIC_SENT_FRAME_METADATA));
+        ASSERT_NE(nullptr, A.Ptr);
+        ASSERT_EQ(0u, ((size_t)A.Ptr) % 8);
+        ASSERT_GE(A.Offset, sizeof(QUIC_SENT_FRAME_CHUNK));
+        Allocations.push_back(A);
+    }
+    ASSERT_EQ(2u, Arena.Arena.ChunkCount);
+    ASSERT_EQ(
+        (uint8_t*)Allocations[0].Ptr + sizeof(QUIC_SENT_FRAME_METADATA),
+        (uint8_t*)Allocations[1].Ptr);
+
+    //
+    // The first chunk is freed as soon as everything in it is released, since
+    // the arena has moved on to the second one.
+    //
+    for (uint32_t i = 0; i < PerChunk; ++i) {
+        ASSERT_EQ(2u, Arena.Arena.ChunkCount);
+        Arena.Release(Allocations[i]);
+    }
+    ASSERT_EQ(1u, Arena.Arena.ChunkCount);
+
+    //
+    // The current chunk stays around, held by the arena, while it is empty.
+    //
+    Arena.Release(Allocations[PerChunk]);
+    ASSERT_EQ(1u, Arena.Arena.ChunkCount);
+}
+
+TEST(SentFrameArenaTest, AddRef)
+{
+    SmartSentFrameArena Arena;
+    auto Shared = Arena.Alloc(sizeof(LAST_ACKED_PACKET_INFO));
+    ASSERT_NE(nullptr, Shared.Ptr);
+    QuicSentFrameArenaAddRef(Shared.Ptr, Shared.Offset);
+
+    //
+    // Move the arena on to a new chunk; the shared allocation keeps the first
+    // one alive until its last reference is released.
+    //
+    std::vector<SmartSentFrameArena::Allocation> Allocations;
+    while (Arena.Arena.ChunkCount < 2) {
+        auto A = Arena.Alloc(256);
+        ASSERT_NE(nullptr, A.Ptr);
+        Allocations.push_back(A);
+    }
+    for (auto& A : Allocations) {
+        Arena.Release(A);
+    }
+    ASSERT_EQ(2u, Arena.Arena.ChunkCount);
+    Arena.Release(Shared);
+    ASSERT_EQ(2u, Arena.Arena.ChunkCount);
+    Arena.Release(Shared);
+    ASSERT_EQ(1u, Arena.Arena.ChunkCount);
+}
+
+TEST(SentFrameArenaTest, InOrderAcks)
+{
+    //
+    // Packets acknowledged roughly in the order they were sent only ever hold
+    // on to the few chunks spanning the outstanding window.
+    //
+    const uint32_t Window = 1000;
+    SmartSentFrameArena Arena;
+    std::deque<SmartSentFrameArena::Allocation> Outstanding;
+    uint32_t MaxChunks = 0;
+    for (uint32_t i = 0; i < 100000; ++i) {
+        uint8_t FrameCount = (i % 10 == 0) ? 3 : 1;
+        auto A = Arena.Alloc((uint16_t)(FrameCount * sizeof(QUIC_SENT_FRAME_METADATA)));
+        ASSERT_NE(nullptr, A.Ptr);
+        Outstanding.push_back(A);
+        if (Outstanding.size() > Window) {
+            Arena.Release(Outstanding.front());
+            Outstanding.pop_front();
+        }
+        MaxChunks = CXPLAT_MAX(MaxChunks, Arena.Arena.ChunkCount);
+    }
+    const uint32_t WindowChunks =
+        (uint32_t)(Window * 1.2 * sizeof(QUIC_SENT_FRAME_METADATA) /
+            (QUIC_SENT_FRAME_CHUNK_SIZE - sizeof(QUIC_SENT_FRAME_CHUNK))) + 2;
+    ASSERT_LE(MaxChunks, WindowChunks);
+    while (!Outstanding.empty()) {
+        Arena.Release(Outstanding.front());
+        Outstanding.pop_front();
+    }
+    ASSERT_EQ(1u, Arena.Arena.ChunkCount);
+}
@@ -0,0 +1,271 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test for the sent packet ring.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "SentPacketRingTest.cpp.clog.h"
+#endif
+
+#include <chrono>
+#include <map>
+#include <random>
+#include <vector>
+
+struct SmartSentPacketRing {
+    QUIC_SENT_PACKET_RING Ring;
+    std::vector<QUIC_SENT_PACKET_METADATA> Packets;
+    SmartSentPacketRing(uint32_t PacketCount) : Packets(PacketCount) {
+        QuicSentPacketRingInitialize(&Ring);
+        for (uint32_t i = 0; i < PacketCount; ++i) {
+            CxPlatZeroMemory(&Packets[i], sizeof(Packets[i]));
+            Packets[i].PacketNumber = i;
+        }
+    }
+    ~SmartSentPacketRing() {
+        QUIC_SENT_PACKET_METADATA* Packet;
+        while ((Packet = QuicSentPacketRingFirst(&Ring)) != NULL) {
+            QuicSentPacketRingRemove(&Ring, Packet->PacketNumber);
+        }
+        QuicSentPacketRingUninitialize(&Ring);
+    }
+    bool Insert(uint64_t PacketNumber) {
+        return QuicSentPacketRingInsert(&Ring, &Packets[(size_t)PacketNumber]) != FALSE;
+    }
+    bool Remove(uint64_t PacketNumber) {
+        QUIC_SENT_PACKET_METADATA* Packet = QuicSentPacketRingRemove(&Ring, PacketNumber);
+        if (Packet == NULL) {
+            return false;
+        }
+        EXPECT_EQ(PacketNumber, Packet->PacketNumber);
+        return true;
+    }
+    bool Contains(uint64_t PacketNumber) const {
+        return QuicSentPacketRingGet(&Ring, PacketNumber) != NULL;
+    }
+    uint64_t FindNext(uint64_t PacketNumber, uint64_t Last = UINT64_MAX) const {
+        return QuicSentPacketRingFindNext(&Ring, PacketNumber, Last);
+    }
+};
+
+TEST(SentPacketRingTest, Empty)
+{
+    SmartSentPacketRing Ring(1);
+    ASSERT_TRUE(QuicSentPacketRingIsEmpty(&Ring.Ring));
+    ASSERT_EQ(nullptr, QuicSentPacketRingFirst(&Ring.Ring));
+    ASSERT_FALSE(Ring.Contains(0));
+    ASSERT_FALSE(Ring.Remove(0));
+    ASSERT_EQ(UINT64_MAX, Ring.FindNext(0));
+}
+
+TEST(SentPacketRingTest, InsertRemove)
+{
+    SmartSentPacketRing Ring(10);
+    for (uint64_t i = 0; i < 10; ++i) {
+        ASSERT_TRUE(Ring.Insert(i));
+    }
+    ASSERT_EQ(10u, Ring.Ring.Count);
+    ASSERT_EQ(9u, QuicSentPacketRingLargest(&Ring.Ring));
+    for (uint64_t i = 0; i < 10; ++i) {
+        ASSERT_TRUE(Ring.Contains(i));
+    }
+    ASSERT_FALSE(Ring.Contains(10));
+
+    //
+    // Removing from the middle leaves a hole that FindNext skips.
+    //
+    ASSERT_TRUE(Ring.Remove(4));
+    ASSERT_TRUE(Ring.Remove(5));
+    ASSERT_FALSE(Ring.Remove(5));
+    ASSERT_FALSE(Ring.Contains(4));
+    ASSERT_EQ(6u, Ring.FindNext(4));
+    ASSERT_EQ(UINT64_MAX, Ring.FindNext(4, 5));
+    ASSERT_EQ(3u, Ring.FindNext(3, 5));
+
+    //
+    // Removing the oldest packets trims the front up to the next outstanding
+    // packet.
+    //
+    ASSERT_TRUE(Ring.Remove(0));
+    ASSERT_EQ(1u, Ring.Ring.Base);
+    ASSERT_TRUE(Ring.Remove(1));
+    ASSERT_TRUE(Ring.Remove(2));
+    ASSERT_TRUE(Ring.Remove(3));
+    ASSERT_EQ(6u, Ring.Ring.Base);
+    ASSERT_EQ(&Ring.Packets[6], QuicSentPacketRingFirst(&Ring.Ring));
+    ASSERT_EQ(6u, Ring.FindNext(0));
+    ASSERT_EQ(4u, Ring.Ring.Count);
+}
+
+TEST(SentPacketRingTest, Gaps)
+{
+    SmartSentPacketRing Ring(1000);
+    for (uint64_t i = 0; i < 1000; i += 7) {
+        ASSERT_TRUE(Ring.Insert(i));
+    }
+    for (uint64_t i = 0; i < 1000; ++i) {
+        ASSERT_EQ(i % 7 == 0, Ring.Contains(i));
+        uint64_t Expected = (i + 6) / 7 * 7;
+        ASSERT_EQ(Expected < 1000 ? Expected : UINT64_MAX, Ring.FindNext(i));
+    }
+}
+
+TEST(SentPacketRingTest, Wrap)
+{
+    //
+    // A steady window of outstanding packets slides through the ring many
+    // times without ever needing to grow it.
+    //
+    const uint32_t Window = 50;
+    SmartSentPacketRing Ring(10000);
+    for (uint64_t i = 0; i < 10000; ++i) {
+        ASSERT_TRUE(Ring.Insert(i));
+        if (i >= Window) {
+            ASSERT_TRUE(Ring.Remove(i - Window));
+        }
+        ASSERT_EQ(i < Window ? 0 : i - Window + 1, Ring.FindNext(0));
+    }
+    ASSERT_EQ(64u, Ring.Ring.Capacity);
+    ASSERT_EQ(Window, Ring.Ring.Count);
+}
+
+TEST(SentPacketRingTest, Grow)
+{
+    //
+    // The oldest packet stays outstanding, so the ring has to grow to span all
+    // the newer ones, including after its head has wrapped.
+    //
+    SmartSentPacketRing Ring(5000);
+    for (uint64_t i = 0; i < 40; ++i) {
+        ASSERT_TRUE(Ring.Insert(i));
+    }
+    for (uint64_t i = 0; i < 30; ++i) {
+        ASSERT_TRUE(Ring.Remove(i));
+    }
+    for (uint64_t i = 40; i < 5000; ++i) {
+        ASSERT_TRUE(Ring.Insert(i));
+    }
+    ASSERT_GE(Ring.Ring.Capacity, 4970u);
+    for (uint64_t i = 0; i < 5000; ++i) {
+        ASSERT_EQ(i >= 30, Ring.Contains(i));
+    }
+}
+
+TEST(SentPacketRingTest, Randomized)
+{
+    const uint32_t PacketCount = 20000;
+    SmartSentPacketRing Ring(PacketCount);
+    std::map<uint64_t, bool> Reference;
+    std::mt19937 Rng(4321);
+    uint64_t NextPacketNumber = 0;
+
+    for (uint32_t Round = 0; Round < 50000; ++Round) {
+        if (NextPacketNumber < PacketCount && (Rng() % 3 != 0 || Reference.empty())) {
+            //
+            // Skip some packet numbers, as happens with packets that don't need
+            // to be tracked.
+            //
+            NextPacketNumber += Rng() % 4 == 0 ? 2 : 1;
+            if (NextPacketNumber >= PacketCount) {
+                continue;
+            }
+            ASSERT_TRUE(Ring.Insert(NextPacketNumber));
+            Reference[NextPacketNumber] = true;
+        } else if (!Reference.empty()) {
+            //
+            // Acknowledge a random range, like an ACK block would.
+            //
+            uint64_t Low = Reference.begin()->first + Rng() % 200;
+            uint64_t High = Low + Rng() % 20;
+            for (auto It = Reference.lower_bound(Low);
+                It != Reference.end() && It->first <= High;) {
+                ASSERT_EQ(It->first, Ring.FindNext(Low, High));
+                ASSERT_TRUE(Ring.Remove(It->first));
+                Low = It->first + 1;
+                It = Reference.erase(It);
+            }
+            ASSERT_EQ(UINT64_MAX, Ring.FindNext(Low, High));
+        }
+
+        ASSERT_EQ(Reference.size(), (size_t)Ring.Ring.Count);
+        if (!Reference.empty()) {
+            ASSERT_EQ(Reference.begin()->first, Ring.FindNext(0));
+        }
+    }
+}
+
+TEST(SentPacketRingTest, AckPerformance)
+{
+    //
+    // Models a large, lossy window: 100k packets are outstanding and only the
+    // odd packets get acknowledged, one ACK frame at a time, so every even
+    // packet stays outstanding behind the acknowledged ranges. Walking a
+    // packet list from the front for each ACK frame is quadratic here, while
+    // the ring only visits the packets each frame acknowledges.
+    //
+    const uint32_t PacketCount = 100000;
+    const uint32_t RangesPerAck = 16;
+    SmartSentPacketRing Ring(PacketCount);
+
+    auto Start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < PacketCount; ++i) {
+        ASSERT_TRUE(Ring.Insert(i));
+    }
+    auto InsertElapsed = std::chrono::steady_clock::now() - Start;
+
+    uint64_t AckedCount = 0;
+    Start = std::chrono::steady_clock::now();
+    for (uint64_t Low = 1; Low < PacketCount; Low += 2 * RangesPerAck) {
+        for (uint64_t j = 0; j < RangesPerAck; ++j) {
+            uint64_t PacketNumber = Ring.FindNext(Low + 2 * j, Low + 2 * j);
+            while (PacketNumber != UINT64_MAX) {
+                QuicSentPacketRingRemove(&Ring.Ring, PacketNumber);
+                ++AckedCount;
+                PacketNumber = Ring.FindNext(PacketNumber + 1, Low + 2 * j);
+            }
+        }
+    }
+    auto AckElapsed = std::chrono::steady_clock::now() - Start;
+    ASSERT_EQ(PacketCount / 2, AckedCount);
+    ASSERT_EQ(PacketCount / 2, Ring.Ring.Count);
+
+    //
+    // The same ACK pattern against a singly linked list, walked from the front
+    // for every ACK frame.
+    //
+    for (uint32_t i = 0; i < PacketCount; ++i) {
+        Ring.Packets[i].Next = i + 1 < PacketCount ? &Ring.Packets[i + 1] : NULL;
+    }
+    QUIC_SENT_PACKET_METADATA* List = &Ring.Packets[0];
+    uint64_t ListAckedCount = 0;
+    Start = std::chrono::steady_clock::now();
+    for (uint64_t Low = 1; Low < PacketCount; Low += 2 * RangesPerAck) {
+        QUIC_SENT_PACKET_METADATA** Prev = &List;
+        for (uint64_t j = 0; j < RangesPerAck; ++j) {
+            while (*Prev != NULL && (*Prev)->PacketNumber < Low + 2 * j) {
+                Prev = &(*Prev)->Next;
+            }
+            while (*Prev != NULL && (*Prev)->PacketNumber <= Low + 2 * j) {
+                *Prev = (*Prev)->Next;
+                ++ListAckedCount;
+            }
+        }
+    }
+    auto ListElapsed = std::chrono::steady_clock::now() - Start;
+    ASSERT_EQ(AckedCount, ListAckedCount);
+
+    auto NsPerOp = [](std::chrono::steady_clock::duration Elapsed, uint64_t Count) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Elapsed).count() / Count;
+    };
+    std::cout << "    insert: " << NsPerOp(InsertElapsed, PacketCount) << " ns/packet, "
+              << "ack (ring): " << NsPerOp(AckElapsed, AckedCount) << " ns/packet, "
+              << "ack (list walk): " << NsPerOp(ListElapsed, ListAckedCount) << " ns/packet ("
+              << PacketCount << " outstanding)" << std::endl;
+}
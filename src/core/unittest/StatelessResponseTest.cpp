@@ -0,0 +1,138 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test for the stateless response rate limit and address filter.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "StatelessResponseTest.cpp.clog.h"
+#endif
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+//
+// Gives the library a set of per-processor state, each with a full bucket at
+// time zero, for the duration of a test.
+//
+struct SmartPerProc {
+    QUIC_LIBRARY_PP* Previous;
+    uint32_t PreviousCount;
+    std::vector<QUIC_LIBRARY_PP> PerProc;
+    SmartPerProc() : Previous(MsQuicLib.PerProc), PreviousCount(MsQuicLib.ProcessorCount) {
+        MsQuicLib.ProcessorCount = 1;
+        PerProc.resize(1);
+        CxPlatZeroMemory(PerProc.data(), sizeof(QUIC_LIBRARY_PP));
+        MsQuicLib.PerProc = PerProc.data();
+    }
+    ~SmartPerProc() {
+        MsQuicLib.PerProc = Previous;
+        MsQuicLib.ProcessorCount = PreviousCount;
+    }
+};
+
+TEST(StatelessResponseTest, Burst)
+{
+    SmartPerProc PerProc;
+    for (uint32_t i = 0; i < QUIC_STATELESS_RESPONSE_BURST; ++i) {
+        ASSERT_TRUE(QuicLibraryTryTakeStatelessResponseToken(0));
+    }
+    ASSERT_FALSE(QuicLibraryTryTakeStatelessResponseToken(0));
+
+    //
+    // Tokens come back at the configured rate, fractions included.
+    //
+    const uint64_t UsPerToken = S_TO_US(1) / QUIC_STATELESS_RESPONSE_RATE;
+    ASSERT_FALSE(QuicLibraryTryTakeStatelessResponseToken(UsPerToken / 2));
+    ASSERT_TRUE(QuicLibraryTryTakeStatelessResponseToken(UsPerToken + 1));
+    ASSERT_FALSE(QuicLibraryTryTakeStatelessResponseToken(UsPerToken + 1));
+    for (uint32_t i = 0; i < 10; ++i) {
+        ASSERT_TRUE(QuicLibraryTryTakeStatelessResponseToken(12 * UsPerToken));
+    }
+    ASSERT_FALSE(QuicLibraryTryTakeStatelessResponseToken(12 * UsPerToken));
+}
+
+TEST(StatelessResponseTest, Rate)
+{
+    //
+    // However long the bucket is idle, it never holds more than the burst,
+    // and over time the responses allowed track the rate.
+    //
+    SmartPerProc PerProc;
+    uint64_t Time = S_TO_US(60);
+    uint32_t Taken = 0;
+    while (QuicLibraryTryTakeStatelessResponseToken(Time)) {
+        ++Taken;
+    }
+    ASSERT_EQ((uint32_t)QUIC_STATELESS_RESPONSE_BURST, Taken);
+
+    Taken = 0;
+    for (uint32_t i = 0; i < 10000; ++i) {
+        Time += 100;
+        while (QuicLibraryTryTakeStatelessResponseToken(Time)) {
+            ++Taken;
+        }
+    }
+    ASSERT_LE(Taken, QUIC_STATELESS_RESPONSE_RATE);
+    ASSERT_GE(Taken, QUIC_STATELESS_RESPONSE_RATE - QUIC_STATELESS_RESPONSE_RATE / 100);
+}
+
+TEST(StatelessResponseTest, Concurrent)
+{
+    //
+    // Threads racing on the same processor's bucket never take more than the
+    // burst between them.
+    //
+    SmartPerProc PerProc;
+    const uint64_t Time = S_TO_US(1);
+    std::atomic<uint32_t> Taken{0};
+    std::vector<std::thread> Threads;
+    for (uint32_t i = 0; i < 8; ++i) {
+        Threads.emplace_back([&]() {
+            for (uint32_t j = 0; j < QUIC_STATELESS_RESPONSE_BURST; ++j) {
+                if (QuicLibraryTryTakeStatelessResponseToken(Time)) {
+                    ++Taken;
+                }
+            }
+        });
+    }
+    for (auto& Thread : Threads) {
+        Thread.join();
+    }
+    ASSERT_EQ((uint32_t)QUIC_STATELESS_RESPONSE_BURST, Taken.load());
+}
+
+TEST(StatelessResponseTest, Filter)
+{
+    //
+    // Each remote address gets one response per expiration period. Other
+    // addresses, including ones sharing its filter entry, are unaffected.
+    //
+    SmartPerProc PerProc;
+    const uint16_t PreviousExpirationMs = MsQuicLib.Settings.StatelessOperationExpirationMs;
+    MsQuicLib.Settings.StatelessOperationExpirationMs = QUIC_STATELESS_OPERATION_EXPIRATION_MS;
+
+    const uint32_t Hash = 0x12345678;
+    const uint32_t OtherHash = Hash + QUIC_STATELESS_RESPONSE_FILTER_SIZE;
+    uint32_t TimeMs = 1000;
+    ASSERT_TRUE(QuicLibraryTryRecordStatelessResponse(Hash, TimeMs));
+    ASSERT_FALSE(QuicLibraryTryRecordStatelessResponse(Hash, TimeMs));
+    ASSERT_TRUE(QuicLibraryTryRecordStatelessResponse(Hash + 1, TimeMs));
+
+    TimeMs += QUIC_STATELESS_OPERATION_EXPIRATION_MS - 1;
+    ASSERT_FALSE(QuicLibraryTryRecordStatelessResponse(Hash, TimeMs));
+    TimeMs += 1;
+    ASSERT_TRUE(QuicLibraryTryRecordStatelessResponse(Hash, TimeMs));
+
+    ASSERT_TRUE(QuicLibraryTryRecordStatelessResponse(OtherHash, TimeMs));
+    ASSERT_TRUE(QuicLibraryTryRecordStatelessResponse(Hash, TimeMs));
+
+    MsQuicLib.Settings.StatelessOperationExpirationMs = PreviousExpirationMs;
+}
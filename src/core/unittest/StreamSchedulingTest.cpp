@@ -0,0 +1,279 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test for the stream send queue, its priority level index and the
+    extensible priority scheduling scheme.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "StreamSchedulingTest.cpp.clog.h"
+#endif
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+struct SmartSendQueue {
+    QUIC_SEND Send;
+    std::vector<QUIC_STREAM*> Streams;
+    SmartSendQueue(uint32_t StreamCount) {
+        QUIC_SETTINGS_INTERNAL Settings;
+        CxPlatZeroMemory(&Settings, sizeof(Settings));
+        CxPlatZeroMemory(&Send, sizeof(Send));
+        QuicSendInitialize(&Send, &Settings);
+        for (uint32_t i = 0; i < StreamCount; ++i) {
+            QUIC_STREAM* Stream = (QUIC_STREAM*)CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_STREAM), QUIC_POOL_TEST);
+            CxPlatZeroMemory(Stream, sizeof(QUIC_STREAM));
+            Stream->ID = i;
+            Streams.push_back(Stream);
+        }
+    }
+    ~SmartSendQueue() {
+        for (auto Stream : Streams) {
+            if (Stream->SendLink.Flink != NULL) {
+                QuicSendRemoveStream(&Send, Stream);
+            }
+        }
+        QuicSendUninitialize(&Send);
+        for (auto Stream : Streams) {
+            CXPLAT_FREE(Stream, QUIC_POOL_TEST);
+        }
+    }
+    void Insert(QUIC_STREAM* Stream, uint16_t Priority) {
+        Stream->SendPriority = Priority;
+        QuicSendInsertStream(&Send, Stream);
+    }
+    QUIC_STREAM* Head() {
+        if (CxPlatListIsEmpty(&Send.SendStreams)) {
+            return nullptr;
+        }
+        return CXPLAT_CONTAINING_RECORD(Send.SendStreams.Flink, QUIC_STREAM, SendLink);
+    }
+    uint32_t Count() {
+        uint32_t Count = 0;
+        for (CXPLAT_LIST_ENTRY* Entry = Send.SendStreams.Flink;
+            Entry != &Send.SendStreams;
+            Entry = Entry->Flink) {
+            ++Count;
+        }
+        return Count;
+    }
+    //
+    // Validates the queue is sorted by priority and that every indexed level
+    // points at the last stream of its run.
+    //
+    void Validate() {
+        uint32_t Level = 0;
+        QUIC_STREAM* Prev = nullptr;
+        for (CXPLAT_LIST_ENTRY* Entry = Send.SendStreams.Flink;
+            Entry != &Send.SendStreams;
+            Entry = Entry->Flink) {
+            QUIC_STREAM* Stream = CXPLAT_CONTAINING_RECORD(Entry, QUIC_STREAM, SendLink);
+            if (Prev != nullptr) {
+                ASSERT_GE(Prev->SendPriority, Stream->SendPriority);
+                if (Prev->SendPriority != Stream->SendPriority) {
+                    ASSERT_LT(Level, Send.PriorityLevelCount);
+                    ASSERT_EQ(Prev, Send.PriorityLevels[Level].Tail);
+                    ASSERT_EQ(Prev->SendPriority, Send.PriorityLevels[Level].Priority);
+                    ++Level;
+                }
+            }
+            Prev = Stream;
+        }
+        if (Prev != nullptr) {
+            ASSERT_EQ(Prev, Send.PriorityLevels[Level].Tail);
+            ++Level;
+        }
+        ASSERT_EQ(Level, Send.PriorityLevelCount);
+    }
+};
+
+TEST(StreamSchedulingTest, PriorityOrder)
+{
+    SmartSendQueue Queue(6);
+    Queue.Insert(Queue.Streams[0], 1);
+    Queue.Insert(Queue.Streams[1], 3);
+    Queue.Insert(Queue.Streams[2], 2);
+    Queue.Insert(Queue.Streams[3], 3);
+    Queue.Insert(Queue.Streams[4], 1);
+    Queue.Insert(Queue.Streams[5], 0xFFFF);
+    Queue.Validate();
+    ASSERT_EQ(4u, Queue.Send.PriorityLevelCount);
+
+    const uint64_t ExpectedOrder[] = { 5, 1, 3, 2, 0, 4 };
+    uint32_t i = 0;
+    for (CXPLAT_LIST_ENTRY* Entry = Queue.Send.SendStreams.Flink;
+        Entry != &Queue.Send.SendStreams;
+        Entry = Entry->Flink, ++i) {
+        ASSERT_EQ(ExpectedOrder[i],
+            CXPLAT_CONTAINING_RECORD(Entry, QUIC_STREAM, SendLink)->ID);
+    }
+
+    QuicSendRemoveStream(&Queue.Send, Queue.Streams[5]);
+    QuicSendRemoveStream(&Queue.Send, Queue.Streams[3]);
+    Queue.Validate();
+    ASSERT_EQ(3u, Queue.Send.PriorityLevelCount);
+    ASSERT_EQ(Queue.Streams[1], Queue.Head());
+
+    QuicSendUpdateStreamPriority(&Queue.Send, Queue.Streams[0], 4);
+    Queue.Validate();
+    ASSERT_EQ(Queue.Streams[0], Queue.Head());
+}
+
+TEST(StreamSchedulingTest, RoundRobin)
+{
+    SmartSendQueue Queue(4);
+    for (auto Stream : Queue.Streams) {
+        Queue.Insert(Stream, 7);
+    }
+    for (uint32_t i = 0; i < 8; ++i) {
+        QUIC_STREAM* Stream = Queue.Head();
+        ASSERT_EQ(i % 4, Stream->ID);
+        QuicSendRotateStream(&Queue.Send, Stream);
+        Queue.Validate();
+    }
+}
+
+TEST(StreamSchedulingTest, ExtensiblePriorityOrder)
+{
+    for (uint8_t Urgency = 0; Urgency <= QUIC_STREAM_URGENCY_MAX; ++Urgency) {
+        for (uint8_t Incremental = 0; Incremental < 2; ++Incremental) {
+            uint16_t Priority = QUIC_STREAM_PRIORITY_FROM_EXTENSIBLE(Urgency, Incremental);
+            ASSERT_EQ(Urgency, QUIC_STREAM_PRIORITY_URGENCY(Priority));
+            ASSERT_EQ(Incremental != 0, QUIC_STREAM_PRIORITY_IS_INCREMENTAL(Priority));
+        }
+    }
+
+    ASSERT_EQ(QUIC_STREAM_URGENCY_DEFAULT, QUIC_STREAM_PRIORITY_URGENCY(QUIC_STREAM_PRIORITY_EXTENSIBLE_DEFAULT));
+    ASSERT_FALSE(QUIC_STREAM_PRIORITY_IS_INCREMENTAL(QUIC_STREAM_PRIORITY_EXTENSIBLE_DEFAULT));
+
+    SmartSendQueue Queue(5);
+    Queue.Insert(Queue.Streams[0], QUIC_STREAM_PRIORITY_FROM_EXTENSIBLE(3, TRUE));
+    Queue.Insert(Queue.Streams[1], QUIC_STREAM_PRIORITY_FROM_EXTENSIBLE(0, FALSE));
+    Queue.Insert(Queue.Streams[2], QUIC_STREAM_PRIORITY_FROM_EXTENSIBLE(3, FALSE));
+    Queue.Insert(Queue.Streams[3], QUIC_STREAM_PRIORITY_FROM_EXTENSIBLE(7, TRUE));
+    Queue.Insert(Queue.Streams[4], QUIC_STREAM_PRIORITY_FROM_EXTENSIBLE(3, FALSE));
+    Queue.Validate();
+
+    //
+    // Most urgent first, and non-incremental streams, in the order they were
+    // queued, ahead of incremental ones of the same urgency.
+    //
+    const uint64_t ExpectedOrder[] = { 1, 2, 4, 0, 3 };
+    uint32_t i = 0;
+    for (CXPLAT_LIST_ENTRY* Entry = Queue.Send.SendStreams.Flink;
+        Entry != &Queue.Send.SendStreams;
+        Entry = Entry->Flink, ++i) {
+        ASSERT_EQ(ExpectedOrder[i],
+            CXPLAT_CONTAINING_RECORD(Entry, QUIC_STREAM, SendLink)->ID);
+    }
+
+    //
+    // Non-incremental streams don't take turns.
+    //
+    QuicSendCreditStream(&Queue.Send, Queue.Streams[1]);
+    ASSERT_EQ(Queue.Streams[1], Queue.Head());
+    ASSERT_EQ(0, Queue.Streams[1]->SendDeficit);
+    ASSERT_TRUE(QuicSendChargeStream(Queue.Streams[1], 0x10000));
+}
+
+TEST(StreamSchedulingTest, DeficitRoundRobin)
+{
+    //
+    // Incremental streams of the same urgency writing very differently sized
+    // frames should still get the same share of bytes.
+    //
+    const uint32_t FrameSizes[] = { 1200, 400, 37 };
+    const uint32_t Turns = 3000;
+    SmartSendQueue Queue(ARRAYSIZE(FrameSizes));
+    for (auto Stream : Queue.Streams) {
+        Queue.Insert(Stream, QUIC_STREAM_PRIORITY_FROM_EXTENSIBLE(3, TRUE));
+    }
+
+    uint64_t BytesSent[ARRAYSIZE(FrameSizes)] = { 0 };
+    for (uint32_t i = 0; i < Turns; ++i) {
+        QUIC_STREAM* Stream = Queue.Head();
+        ASSERT_EQ(i % ARRAYSIZE(FrameSizes), Stream->ID);
+        QuicSendCreditStream(&Queue.Send, Stream);
+        ASSERT_GT(Stream->SendDeficit, 0);
+        uint32_t FrameSize = FrameSizes[Stream->ID];
+        do {
+            BytesSent[Stream->ID] += FrameSize;
+        } while (QuicSendChargeStream(Stream, FrameSize));
+        Queue.Validate();
+    }
+
+    const uint64_t Rounds = Turns / ARRAYSIZE(FrameSizes);
+    for (uint32_t i = 0; i < ARRAYSIZE(FrameSizes); ++i) {
+        ASSERT_GE(BytesSent[i], Rounds * QUIC_STREAM_SEND_QUANTUM);
+        ASSERT_LT(BytesSent[i], Rounds * QUIC_STREAM_SEND_QUANTUM + FrameSizes[i]);
+    }
+
+    //
+    // Leaving the queue forfeits any remaining credit.
+    //
+    QuicSendRemoveStream(&Queue.Send, Queue.Streams[0]);
+    ASSERT_EQ(0, Queue.Streams[0]->SendDeficit);
+}
+
+TEST(StreamSchedulingTest, ManyStreams)
+{
+    const uint32_t StreamCount = 10000;
+    const uint32_t Iterations = 200000;
+    const uint16_t Priorities[] = { 0, 1, 2, 3, 0x7FFF, 0x8000, 0xFFFE, 0xFFFF };
+
+    SmartSendQueue Queue(StreamCount);
+    std::mt19937 Rng(1234);
+
+    auto Start = std::chrono::steady_clock::now();
+    for (auto Stream : Queue.Streams) {
+        Queue.Insert(Stream, Priorities[Rng() % ARRAYSIZE(Priorities)]);
+    }
+    Queue.Validate();
+    ASSERT_EQ(StreamCount, Queue.Count());
+
+    //
+    // Simulate the send loop: round robin the head stream, with the occasional
+    // priority change, completion and requeue.
+    //
+    for (uint32_t i = 0; i < Iterations; ++i) {
+        QUIC_STREAM* Stream = Queue.Head();
+        switch (Rng() % 8) {
+        case 0:
+            QuicSendUpdateStreamPriority(
+                &Queue.Send, Stream, Priorities[Rng() % ARRAYSIZE(Priorities)]);
+            break;
+        case 1: {
+            QuicSendRemoveStream(&Queue.Send, Stream);
+            Queue.Insert(Stream, Stream->SendPriority);
+            QUIC_STREAM* Other = Queue.Streams[Rng() % StreamCount];
+            QuicSendRemoveStream(&Queue.Send, Other);
+            Queue.Insert(Other, Priorities[Rng() % ARRAYSIZE(Priorities)]);
+            break;
+        }
+        default:
+            QuicSendRotateStream(&Queue.Send, Stream);
+            break;
+        }
+    }
+    auto Elapsed =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - Start).count();
+    std::cout << "    " << Iterations << " scheduling operations over " << StreamCount
+              << " streams: " << (Elapsed / Iterations) << " ns/op" << std::endl;
+
+    Queue.Validate();
+    ASSERT_EQ(StreamCount, Queue.Count());
+
+    for (auto Stream : Queue.Streams) {
+        QuicSendRemoveStream(&Queue.Send, Stream);
+    }
+    ASSERT_EQ(0u, Queue.Send.PriorityLevelCount);
+    ASSERT_TRUE(CxPlatListIsEmpty(&Queue.Send.SendStreams));
+}
@@ -0,0 +1,246 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test for the hierarchical timer wheel.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "TimerWheelTest.cpp.clog.h"
+#endif
+
+#include <chrono>
+#include <random>
+#include <set>
+#include <vector>
+
+struct SmartTimerWheel {
+    QUIC_TIMER_WHEEL Wheel;
+    std::vector<QUIC_TIMER_WHEEL_ENTRY> Timers;
+    uint64_t BaseTime;
+    SmartTimerWheel(uint32_t TimerCount) : Timers(TimerCount), BaseTime(0) {
+        CxPlatZeroMemory(&Wheel, sizeof(Wheel));
+        for (auto& Timer : Timers) {
+            CxPlatZeroMemory(&Timer, sizeof(Timer));
+            Timer.ExpirationTime = UINT64_MAX;
+        }
+    }
+    ~SmartTimerWheel() {
+        for (auto& Timer : Timers) {
+            if (Timer.Link.Flink != NULL) {
+                QuicTimerWheelRemove(&Wheel, &Timer);
+            }
+        }
+        QuicTimerWheelUninitialize(&Wheel);
+    }
+    QUIC_STATUS Initialize() {
+        QUIC_STATUS Status = QuicTimerWheelInitialize(&Wheel);
+        BaseTime = Wheel.CurrentTick << QUIC_TIMER_WHEEL_TICK_SHIFT;
+        return Status;
+    }
+    void Set(uint32_t Index, uint64_t ExpirationTime) {
+        if (Timers[Index].Link.Flink != NULL) {
+            QuicTimerWheelRemove(&Wheel, &Timers[Index]);
+        }
+        Timers[Index].ExpirationTime = BaseTime + ExpirationTime;
+        QuicTimerWheelInsert(&Wheel, &Timers[Index]);
+    }
+    void Cancel(uint32_t Index) {
+        if (Timers[Index].Link.Flink != NULL) {
+            QuicTimerWheelRemove(&Wheel, &Timers[Index]);
+        }
+        Timers[Index].ExpirationTime = UINT64_MAX;
+    }
+    //
+    // Advances to the (relative) time and returns the indexes of the expired
+    // timers.
+    //
+    std::set<uint32_t> Advance(uint64_t TimeNow) {
+        CXPLAT_LIST_ENTRY Expired;
+        CxPlatListInitializeHead(&Expired);
+        QuicTimerWheelAdvance(&Wheel, BaseTime + TimeNow, &Expired);
+        std::set<uint32_t> Indexes;
+        while (!CxPlatListIsEmpty(&Expired)) {
+            QUIC_TIMER_WHEEL_ENTRY* Timer =
+                CXPLAT_CONTAINING_RECORD(
+                    CxPlatListRemoveHead(&Expired), QUIC_TIMER_WHEEL_ENTRY, Link);
+            Timer->Link.Flink = NULL;
+            Indexes.insert((uint32_t)(Timer - Timers.data()));
+        }
+        return Indexes;
+    }
+    uint64_t NextExpiration() {
+        return Wheel.NextExpirationTime == UINT64_MAX ?
+            UINT64_MAX : Wheel.NextExpirationTime - BaseTime;
+    }
+};
+
+TEST(TimerWheelTest, Basic)
+{
+    const uint64_t ExpirationTimes[] = {
+        0, 500, 1000, 1500, MS_TO_US(70), S_TO_US(5), S_TO_US(300),
+        S_TO_US(60 * 60 * 24 * 20) // Beyond the top level.
+    };
+    SmartTimerWheel Wheel(ARRAYSIZE(ExpirationTimes));
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, Wheel.Initialize());
+    ASSERT_EQ(UINT64_MAX, Wheel.NextExpiration());
+    for (uint32_t i = 0; i < ARRAYSIZE(ExpirationTimes); ++i) {
+        Wheel.Set(i, ExpirationTimes[i]);
+    }
+    ASSERT_EQ(ARRAYSIZE(ExpirationTimes), Wheel.Wheel.TimerCount);
+    ASSERT_EQ(0u, Wheel.NextExpiration());
+
+    for (uint32_t i = 0; i < ARRAYSIZE(ExpirationTimes); ++i) {
+        //
+        // Nothing expires early.
+        //
+        if (ExpirationTimes[i] != 0) {
+            auto Expired = Wheel.Advance(ExpirationTimes[i] - 1);
+            ASSERT_TRUE(Expired.empty());
+            ASSERT_LE(Wheel.NextExpiration(), ExpirationTimes[i]);
+            ASSERT_GT(Wheel.NextExpiration(), ExpirationTimes[i] - 1);
+        }
+
+        auto Expired = Wheel.Advance(ExpirationTimes[i]);
+        ASSERT_EQ(1u, Expired.size());
+        ASSERT_EQ(i, *Expired.begin());
+        ASSERT_EQ(ARRAYSIZE(ExpirationTimes) - i - 1, Wheel.Wheel.TimerCount);
+    }
+    ASSERT_EQ(UINT64_MAX, Wheel.NextExpiration());
+}
+
+TEST(TimerWheelTest, CancelAndReset)
+{
+    SmartTimerWheel Wheel(3);
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, Wheel.Initialize());
+    Wheel.Set(0, MS_TO_US(25));
+    Wheel.Set(1, MS_TO_US(30));
+    Wheel.Set(2, S_TO_US(30));
+    Wheel.Cancel(0);
+    Wheel.Set(1, S_TO_US(10));
+    Wheel.Set(2, MS_TO_US(40));
+
+    ASSERT_TRUE(Wheel.Advance(MS_TO_US(39)).empty());
+    auto Expired = Wheel.Advance(MS_TO_US(40));
+    ASSERT_EQ(std::set<uint32_t>({ 2 }), Expired);
+    ASSERT_TRUE(Wheel.Advance(S_TO_US(10) - 1).empty());
+    Expired = Wheel.Advance(S_TO_US(10));
+    ASSERT_EQ(std::set<uint32_t>({ 1 }), Expired);
+    ASSERT_EQ(0u, Wheel.Wheel.TimerCount);
+}
+
+TEST(TimerWheelTest, Randomized)
+{
+    const uint32_t TimerCount = 1000;
+    SmartTimerWheel Wheel(TimerCount);
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, Wheel.Initialize());
+    std::mt19937_64 Rng(42);
+    const uint64_t MaxDelays[] = {
+        1000, MS_TO_US(25), MS_TO_US(500), S_TO_US(30), S_TO_US(60 * 60 * 24 * 30)
+    };
+
+    uint64_t Now = 0;
+    for (uint32_t Iteration = 0; Iteration < 20000; ++Iteration) {
+        uint32_t Index = (uint32_t)(Rng() % TimerCount);
+        switch (Rng() % 4) {
+        case 0:
+            Wheel.Cancel(Index);
+            break;
+        case 1: {
+            //
+            // Advance by a random amount and make sure exactly the timers that
+            // are due expire.
+            //
+            Now += Rng() % MaxDelays[Rng() % 3];
+            std::set<uint32_t> Expected;
+            uint64_t NextExpected = UINT64_MAX;
+            for (uint32_t i = 0; i < TimerCount; ++i) {
+                uint64_t ExpirationTime = Wheel.Timers[i].ExpirationTime;
+                if (ExpirationTime == UINT64_MAX) {
+                    continue;
+                }
+                if (ExpirationTime - Wheel.BaseTime <= Now) {
+                    Expected.insert(i);
+                } else if (ExpirationTime - Wheel.BaseTime < NextExpected) {
+                    NextExpected = ExpirationTime - Wheel.BaseTime;
+                }
+            }
+            ASSERT_EQ(Expected, Wheel.Advance(Now));
+            for (auto i : Expected) {
+                Wheel.Timers[i].ExpirationTime = UINT64_MAX;
+            }
+            ASSERT_GT(Wheel.NextExpiration(), Now);
+            ASSERT_LE(Wheel.NextExpiration(), NextExpected);
+            break;
+        }
+        default:
+            Wheel.Set(Index, Now + Rng() % MaxDelays[Rng() % ARRAYSIZE(MaxDelays)]);
+            break;
+        }
+    }
+}
+
+TEST(TimerWheelTest, Throughput)
+{
+    //
+    // Models a busy worker: every connection has an idle timer, and most have
+    // a loss detection timer, with ACK delay and pacing timers constantly
+    // being set and cancelled.
+    //
+    const uint32_t ConnectionCount = 500000;
+    const uint32_t TimersPerConnection = 4;
+    const uint32_t ChurnCount = 2000000;
+    const uint64_t Delays[TimersPerConnection] = {
+        S_TO_US(30), MS_TO_US(200), MS_TO_US(25), 1000
+    };
+    SmartTimerWheel Wheel(ConnectionCount * TimersPerConnection);
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, Wheel.Initialize());
+    std::mt19937 Rng(1234);
+    uint64_t Now = 0;
+
+    auto Start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < ConnectionCount * TimersPerConnection; ++i) {
+        Wheel.Set(i, Now + Delays[i % TimersPerConnection] / 2 + Rng() % Delays[i % TimersPerConnection]);
+    }
+    auto ArmElapsed = std::chrono::steady_clock::now() - Start;
+
+    Start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < ChurnCount; ++i) {
+        uint32_t Index = Rng() % (ConnectionCount * TimersPerConnection);
+        if (Index % TimersPerConnection >= 2 && (i & 1)) {
+            Wheel.Cancel(Index);
+        } else {
+            Wheel.Set(Index, Now + Delays[Index % TimersPerConnection] / 2 + Rng() % Delays[Index % TimersPerConnection]);
+        }
+        if ((i & 0xFF) == 0) {
+            Now += 100;
+        }
+    }
+    auto ChurnElapsed = std::chrono::steady_clock::now() - Start;
+
+    //
+    // Let everything expire, a millisecond at a time.
+    //
+    uint64_t TimerCount = Wheel.Wheel.TimerCount;
+    uint64_t ExpiredCount = 0;
+    Start = std::chrono::steady_clock::now();
+    while (Wheel.Wheel.TimerCount != 0) {
+        Now += 1000;
+        ExpiredCount += Wheel.Advance(Now).size();
+    }
+    auto ExpireElapsed = std::chrono::steady_clock::now() - Start;
+    ASSERT_EQ(TimerCount, ExpiredCount);
+
+    auto NsPerOp = [](std::chrono::steady_clock::duration Elapsed, uint64_t Count) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Elapsed).count() / Count;
+    };
+    std::cout << "    arm: " << NsPerOp(ArmElapsed, ConnectionCount * TimersPerConnection) << " ns/op, "
+              << "re-arm/cancel: " << NsPerOp(ChurnElapsed, ChurnCount) << " ns/op, "
+              << "expire: " << NsPerOp(ExpireElapsed, ExpiredCount) << " ns/op ("
+              << ExpiredCount << " timers over " << Now / 1000 << " ms)" << std::endl;
+}
@@ -14,6 +14,10 @@ Abstract:
 #include "VarIntTest.cpp.clog.h"
 #endif
 
+#include <chrono>
+#include <random>
+#include <vector>
+
 uint64_t Encode(uint64_t Value)
 {
     uint64_t Encoded = 0;
@@ -73,3 +77,147 @@ TEST(VarIntTest, RandomEncodeDecode)
         ASSERT_EQ(Value, Decoded);
     }
 }
+
+//
+// Encodes random values with a random mix of encoded lengths.
+//
+static
+uint16_t
+EncodeRandomValues(
+    std::mt19937_64& Rng,
+    uint32_t Count,
+    uint8_t* Buffer,
+    uint16_t BufferLength,
+    std::vector<uint64_t>& Values
+    )
+{
+    static const uint64_t Limits[] = { 0x40, 0x4000, 0x40000000, 0x4000000000000000ULL };
+    uint8_t* Start = Buffer;
+    Values.clear();
+    for (uint32_t i = 0; i < Count; ++i) {
+        uint64_t Value = Rng() % Limits[Rng() % ARRAYSIZE(Limits)];
+        if (Buffer + QuicVarIntSize(Value) > Start + BufferLength) {
+            break;
+        }
+        Buffer = QuicVarIntEncode(Value, Buffer);
+        Values.push_back(Value);
+    }
+    return (uint16_t)(Buffer - Start);
+}
+
+TEST(VarIntTest, DecodeManyEquivalence)
+{
+    //
+    // Every decoder supported here must match decoding the values one at a
+    // time, including on truncated buffers and random bytes.
+    //
+    std::mt19937_64 Rng(16);
+    std::vector<uint64_t> Values;
+    uint8_t Buffer[512];
+    QUIC_VAR_INT Expected[64];
+    QUIC_VAR_INT Decoded[64];
+
+    for (uint32_t Type = 0; Type < QUIC_VAR_INT_DECODER_COUNT; ++Type) {
+        QUIC_VAR_INT_DECODE_MANY_FN* DecodeMany = QuicVarIntGetDecoder((QUIC_VAR_INT_DECODER)Type);
+        if (DecodeMany == nullptr) {
+            std::cout << "    decoder " << Type << " not supported" << std::endl;
+            continue;
+        }
+        for (uint32_t i = 0; i < 100000; ++i) {
+            uint16_t BufferLength;
+            if (i % 4 == 0) {
+                BufferLength = (uint16_t)(Rng() % sizeof(Buffer));
+                for (uint16_t j = 0; j < BufferLength; ++j) {
+                    Buffer[j] = (uint8_t)Rng();
+                }
+            } else {
+                BufferLength =
+                    EncodeRandomValues(Rng, (uint32_t)(Rng() % 64), Buffer, sizeof(Buffer), Values);
+                if (i % 4 == 1 && BufferLength != 0) {
+                    BufferLength -= (uint16_t)(Rng() % (BufferLength + 1)); // Truncate.
+                }
+            }
+            uint16_t StartOffset = BufferLength == 0 ? 0 : (uint16_t)(Rng() % 4 % (BufferLength + 1));
+            uint32_t Count = (uint32_t)(Rng() % (ARRAYSIZE(Expected) + 1));
+
+            uint16_t ExpectedOffset = StartOffset;
+            BOOLEAN ExpectedResult = TRUE;
+            for (uint32_t j = 0; j < Count && ExpectedResult; ++j) {
+                ExpectedResult = QuicVarIntDecode(BufferLength, Buffer, &ExpectedOffset, &Expected[j]);
+            }
+            if (!ExpectedResult) {
+                ExpectedOffset = StartOffset;
+            }
+
+            uint16_t Offset = StartOffset;
+            ASSERT_EQ(ExpectedResult, DecodeMany(BufferLength, Buffer, &Offset, Count, Decoded));
+            ASSERT_EQ(ExpectedOffset, Offset);
+            if (ExpectedResult) {
+                for (uint32_t j = 0; j < Count; ++j) {
+                    ASSERT_EQ(Expected[j], Decoded[j]);
+                }
+            }
+        }
+    }
+}
+
+TEST(VarIntTest, DecodeManyPerformance)
+{
+    //
+    // Decodes packets' worth of varints, four at a time as for an ACK frame
+    // header, mostly one and two byte values as is typical in frames. Many
+    // different packets are used so the branch predictor can't simply learn
+    // the lengths.
+    //
+    const uint32_t PacketCount = 512;
+    std::mt19937_64 Rng(42);
+    std::vector<std::vector<uint8_t>> Packets(PacketCount);
+    std::vector<uint32_t> ValueCounts(PacketCount);
+    uint64_t TotalValues = 0;
+    for (uint32_t p = 0; p < PacketCount; ++p) {
+        Packets[p].resize(1200);
+        uint8_t* Buffer = Packets[p].data();
+        uint16_t BufferLength = 0;
+        uint32_t ValueCount = 0;
+        while (BufferLength + sizeof(uint64_t) <= Packets[p].size()) {
+            uint64_t Value = Rng() % 10 < 7 ? Rng() % 0x40 : (Rng() % 10 < 9 ? Rng() % 0x4000 : Rng() % 0x40000000);
+            BufferLength = (uint16_t)(QuicVarIntEncode(Value, Buffer + BufferLength) - Buffer);
+            ++ValueCount;
+        }
+        Packets[p].resize(BufferLength);
+        ValueCounts[p] = ValueCount & ~3u;
+        TotalValues += ValueCounts[p];
+    }
+
+    const uint32_t Rounds = 20;
+    uint64_t ScalarNs = 0;
+    for (uint32_t Type = 0; Type < QUIC_VAR_INT_DECODER_COUNT; ++Type) {
+        QUIC_VAR_INT_DECODE_MANY_FN* DecodeMany = QuicVarIntGetDecoder((QUIC_VAR_INT_DECODER)Type);
+        if (DecodeMany == nullptr) {
+            continue;
+        }
+        QUIC_VAR_INT Values[4];
+        uint64_t Check = 0;
+        auto Start = std::chrono::steady_clock::now();
+        for (uint32_t Round = 0; Round < Rounds; ++Round) {
+            for (uint32_t p = 0; p < PacketCount; ++p) {
+                uint16_t Offset = 0;
+                for (uint32_t i = 0; i < ValueCounts[p]; i += 4) {
+                    ASSERT_TRUE(
+                        DecodeMany(
+                            (uint16_t)Packets[p].size(), Packets[p].data(), &Offset, 4, Values));
+                    Check += Values[0] ^ Values[3];
+                }
+            }
+        }
+        uint64_t Ns =
+            (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - Start).count();
+        if (Type == QUIC_VAR_INT_DECODER_SCALAR) {
+            ScalarNs = Ns;
+        }
+        std::cout << "    decoder " << Type << ": "
+                  << (double)Ns / (Rounds * TotalValues) << " ns/value ("
+                  << (double)ScalarNs / Ns << "x scalar, check " << (Check & 0xFF) << ")" << std::endl;
+    }
+}
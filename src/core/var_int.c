@@ -0,0 +1,229 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Bulk decoding of consecutive QUIC variable-length integers, as found in
+    most multi-field frames.
+
+    On x86/x64 user mode builds, runs of varints are decoded with a byte
+    shuffle: the 2-bit prefixes of the next values give their lengths, which
+    select a precomputed shuffle mask that moves each value's bytes into its
+    own 64-bit lane, converting them from network byte order at the same time.
+    A second mask then clears the length prefix bits. The SSSE3 decoder does
+    2 values per shuffle. It only runs while there are enough bytes left in
+    the buffer to load a full vector, and finishes any remaining values with
+    the scalar decoder.
+
+    The decoder is picked from the processor's features when the library is
+    loaded. Wider vectors don't help: each value's position depends on the
+    lengths of the ones before it, so a 4 value AVX2 decoder is bound by the
+    same serial chain and measured slower on mixed length input. Kernel mode
+    builds always use the scalar decoder, to avoid having to save the extended
+    processor state.
+
+--*/
+
+#include "precomp.h"
+
+#if !defined(_KERNEL_MODE) && \
+    (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86))
+#define QUIC_VAR_INT_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define QUIC_VAR_INT_TARGET(Features)
+#else
+#define QUIC_VAR_INT_TARGET(Features) __attribute__((target(Features)))
+#endif
+#else
+#define QUIC_VAR_INT_SIMD 0
+#endif
+
+_Success_(return != FALSE)
+static
+BOOLEAN
+QuicVarIntDecodeManyScalar(
+    _In_ uint16_t BufferLength,
+    _In_reads_bytes_(BufferLength)
+        const uint8_t * const Buffer,
+    _Inout_
+    _Deref_in_range_(0, BufferLength)
+    _Deref_out_range_(0, BufferLength)
+        uint16_t* Offset,
+    _In_ uint32_t Count,
+    _Out_writes_(Count) QUIC_VAR_INT* Values
+    )
+{
+    uint16_t LocalOffset = *Offset;
+    for (uint32_t i = 0; i < Count; ++i) {
+        if (!QuicVarIntDecode(BufferLength, Buffer, &LocalOffset, &Values[i])) {
+            return FALSE;
+        }
+    }
+    *Offset = LocalOffset;
+    return TRUE;
+}
+
+#if QUIC_VAR_INT_SIMD
+
+//
+// Shuffle masks for a pair of varints, indexed by their two length prefixes
+// (First << 2 | Second). The low 8 bytes receive the first value and the high
+// 8 bytes the second one, each reversed into host (little endian) byte order.
+// 0x80 zeroes the unused bytes.
+//
+#define QV_SRC(Len, Base, i) ((i) < (Len) ? (Base) + (Len) - 1 - (i) : 0x80)
+#define QV_LANE(Len, Base) \
+    QV_SRC(Len, Base, 0), QV_SRC(Len, Base, 1), QV_SRC(Len, Base, 2), QV_SRC(Len, Base, 3), \
+    QV_SRC(Len, Base, 4), QV_SRC(Len, Base, 5), QV_SRC(Len, Base, 6), QV_SRC(Len, Base, 7)
+#define QV_SHUFFLE(Len0, Len1) { QV_LANE(Len0, 0), QV_LANE(Len1, Len0) }
+
+static const uint8_t QuicVarIntShuffle[16][16] = {
+    QV_SHUFFLE(1, 1), QV_SHUFFLE(1, 2), QV_SHUFFLE(1, 4), QV_SHUFFLE(1, 8),
+    QV_SHUFFLE(2, 1), QV_SHUFFLE(2, 2), QV_SHUFFLE(2, 4), QV_SHUFFLE(2, 8),
+    QV_SHUFFLE(4, 1), QV_SHUFFLE(4, 2), QV_SHUFFLE(4, 4), QV_SHUFFLE(4, 8),
+    QV_SHUFFLE(8, 1), QV_SHUFFLE(8, 2), QV_SHUFFLE(8, 4), QV_SHUFFLE(8, 8),
+};
+
+//
+// Masks clearing the length prefix bits, which end up in the most significant
+// byte of each value, after the shuffle.
+//
+#define QV_BIT(Len, i) ((i) == (Len) - 1 ? 0x3F : 0xFF)
+#define QV_BITS(Len) \
+    QV_BIT(Len, 0), QV_BIT(Len, 1), QV_BIT(Len, 2), QV_BIT(Len, 3), \
+    QV_BIT(Len, 4), QV_BIT(Len, 5), QV_BIT(Len, 6), QV_BIT(Len, 7)
+#define QV_PREFIX_MASK(Len0, Len1) { QV_BITS(Len0), QV_BITS(Len1) }
+
+static const uint8_t QuicVarIntPrefixMask[16][16] = {
+    QV_PREFIX_MASK(1, 1), QV_PREFIX_MASK(1, 2), QV_PREFIX_MASK(1, 4), QV_PREFIX_MASK(1, 8),
+    QV_PREFIX_MASK(2, 1), QV_PREFIX_MASK(2, 2), QV_PREFIX_MASK(2, 4), QV_PREFIX_MASK(2, 8),
+    QV_PREFIX_MASK(4, 1), QV_PREFIX_MASK(4, 2), QV_PREFIX_MASK(4, 4), QV_PREFIX_MASK(4, 8),
+    QV_PREFIX_MASK(8, 1), QV_PREFIX_MASK(8, 2), QV_PREFIX_MASK(8, 4), QV_PREFIX_MASK(8, 8),
+};
+
+//
+// Looks up the table index and total encoded length of the pair of varints
+// starting at Buffer, which must have at least 16 readable bytes. The four
+// bytes that could start the second value are all loaded up front, so that
+// only a shift depends on the first value's length.
+//
+#define QV_PAIR(Buffer, Index, Length) \
+    do { \
+        const uint32_t Prefix0 = (Buffer)[0] >> 6; \
+        const uint32_t Next = \
+            (uint32_t)(Buffer)[1] | ((uint32_t)(Buffer)[2] << 8) | \
+            ((uint32_t)(Buffer)[4] << 16) | ((uint32_t)(Buffer)[8] << 24); \
+        const uint32_t Prefix1 = (Next >> (8 * Prefix0 + 6)) & 3; \
+        (Index) = (uint8_t)((Prefix0 << 2) | Prefix1); \
+        (Length) = (uint16_t)((1 << Prefix0) + (1 << Prefix1)); \
+    } while (0)
+
+_Success_(return != FALSE)
+static
+QUIC_VAR_INT_TARGET("ssse3")
+BOOLEAN
+QuicVarIntDecodeManySsse3(
+    _In_ uint16_t BufferLength,
+    _In_reads_bytes_(BufferLength)
+        const uint8_t * const Buffer,
+    _Inout_
+    _Deref_in_range_(0, BufferLength)
+    _Deref_out_range_(0, BufferLength)
+        uint16_t* Offset,
+    _In_ uint32_t Count,
+    _Out_writes_(Count) QUIC_VAR_INT* Values
+    )
+{
+    uint16_t LocalOffset = *Offset;
+    uint32_t i = 0;
+    while (Count - i >= 2 && (uint32_t)LocalOffset + sizeof(__m128i) <= BufferLength) {
+        uint8_t Index;
+        uint16_t Length;
+        QV_PAIR(Buffer + LocalOffset, Index, Length);
+        __m128i Data = _mm_loadu_si128((const __m128i*)(Buffer + LocalOffset));
+        Data = _mm_shuffle_epi8(Data, _mm_loadu_si128((const __m128i*)QuicVarIntShuffle[Index]));
+        Data = _mm_and_si128(Data, _mm_loadu_si128((const __m128i*)QuicVarIntPrefixMask[Index]));
+        _mm_storeu_si128((__m128i*)(Values + i), Data);
+        LocalOffset += Length;
+        i += 2;
+    }
+
+    if (!QuicVarIntDecodeManyScalar(BufferLength, Buffer, &LocalOffset, Count - i, Values + i)) {
+        return FALSE;
+    }
+    *Offset = LocalOffset;
+    return TRUE;
+}
+
+static
+BOOLEAN
+QuicVarIntCpuSupportsSsse3(
+    void
+    )
+{
+#if defined(_MSC_VER)
+    int CpuInfo[4];
+    __cpuid(CpuInfo, 1);
+    return (CpuInfo[2] & (1 << 9)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3") != 0;
+#endif
+}
+
+#endif // QUIC_VAR_INT_SIMD
+
+static QUIC_VAR_INT_DECODE_MANY_FN* QuicVarIntDecodeManyImpl = QuicVarIntDecodeManyScalar;
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_VAR_INT_DECODE_MANY_FN*
+QuicVarIntGetDecoder(
+    _In_ QUIC_VAR_INT_DECODER Decoder
+    )
+{
+    switch (Decoder) {
+    case QUIC_VAR_INT_DECODER_SCALAR:
+        return QuicVarIntDecodeManyScalar;
+#if QUIC_VAR_INT_SIMD
+    case QUIC_VAR_INT_DECODER_SSSE3:
+        return QuicVarIntCpuSupportsSsse3() ? QuicVarIntDecodeManySsse3 : NULL;
+#endif
+    default:
+        return NULL;
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicVarIntDecoderInitialize(
+    void
+    )
+{
+    QUIC_VAR_INT_DECODE_MANY_FN* Decoder =
+        QuicVarIntGetDecoder(QUIC_VAR_INT_DECODER_SSSE3);
+    if (Decoder != NULL) {
+        QuicVarIntDecodeManyImpl = Decoder;
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Success_(return != FALSE)
+BOOLEAN
+QuicVarIntDecodeMany(
+    _In_ uint16_t BufferLength,
+    _In_reads_bytes_(BufferLength)
+        const uint8_t * const Buffer,
+    _Inout_
+    _Deref_in_range_(0, BufferLength)
+    _Deref_out_range_(0, BufferLength)
+        uint16_t* Offset,
+    _In_ uint32_t Count,
+    _Out_writes_(Count) QUIC_VAR_INT* Values
+    )
+{
+    return QuicVarIntDecodeManyImpl(BufferLength, Buffer, Offset, Count, Values);
+}
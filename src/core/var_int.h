@@ -0,0 +1,82 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+--*/
+
+#pragma once
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+//
+// Decodes Count consecutive variable-length integers starting at *Offset into
+// Values. On success, *Offset is advanced past all of them. On failure (the
+// buffer ends first), *Offset is left unchanged and the contents of Values are
+// undefined.
+//
+typedef
+_Success_(return != FALSE)
+BOOLEAN
+(QUIC_VAR_INT_DECODE_MANY_FN)(
+    _In_ uint16_t BufferLength,
+    _In_reads_bytes_(BufferLength)
+        const uint8_t * const Buffer,
+    _Inout_
+    _Deref_in_range_(0, BufferLength)
+    _Deref_out_range_(0, BufferLength)
+        uint16_t* Offset,
+    _In_ uint32_t Count,
+    _Out_writes_(Count) QUIC_VAR_INT* Values
+    );
+
+typedef enum QUIC_VAR_INT_DECODER {
+    QUIC_VAR_INT_DECODER_SCALAR,
+    QUIC_VAR_INT_DECODER_SSSE3,     // 2 values per 128-bit shuffle.
+    QUIC_VAR_INT_DECODER_COUNT
+} QUIC_VAR_INT_DECODER;
+
+//
+// Selects the SSSE3 decoder if the processor supports it. Called once, as the
+// library is loaded. Until then, the scalar decoder is used.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicVarIntDecoderInitialize(
+    void
+    );
+
+//
+// Returns the given decoder, or NULL if it isn't supported by this build or
+// processor.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_VAR_INT_DECODE_MANY_FN*
+QuicVarIntGetDecoder(
+    _In_ QUIC_VAR_INT_DECODER Decoder
+    );
+
+//
+// Decodes Count consecutive variable-length integers with the decoder
+// selected by QuicVarIntDecoderInitialize.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Success_(return != FALSE)
+BOOLEAN
+QuicVarIntDecodeMany(
+    _In_ uint16_t BufferLength,
+    _In_reads_bytes_(BufferLength)
+        const uint8_t * const Buffer,
+    _Inout_
+    _Deref_in_range_(0, BufferLength)
+    _Deref_out_range_(0, BufferLength)
+        uint16_t* Offset,
+    _In_ uint32_t Count,
+    _Out_writes_(Count) QUIC_VAR_INT* Values
+    );
+
+#if defined(__cplusplus)
+}
+#endif
@@ -268,6 +268,77 @@ QuicWorkerQueueConnection(
     }
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicWorkerQueueBatchAdd(
+    _Inout_ QUIC_WORKER_QUEUE_BATCH* Batch,
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    CXPLAT_DBG_ASSERT(Connection->Worker != NULL);
+    if (Batch->Count == ARRAYSIZE(Batch->Connections)) {
+        QuicWorkerQueueBatchFlush(Batch);
+    }
+    QuicConnAddRef(Connection, QUIC_CONN_REF_LOOKUP_RESULT);
+    Batch->Connections[Batch->Count++] = Connection;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicWorkerQueueBatchFlush(
+    _Inout_ QUIC_WORKER_QUEUE_BATCH* Batch
+    )
+{
+    uint32_t i = 0;
+    while (i < Batch->Count) {
+        QUIC_WORKER* Worker = Batch->Connections[i]->Worker;
+        uint32_t First = i;
+        uint32_t QueuedCount = 0;
+        BOOLEAN WakeWorkerThread = FALSE;
+
+        //
+        // Queue every connection in the batch on this worker under one
+        // acquisition of its lock, moving them to the front of what's left
+        // of the batch.
+        //
+        CxPlatDispatchLockAcquire(&Worker->Lock);
+        for (uint32_t j = i; j < Batch->Count; ++j) {
+            QUIC_CONNECTION* Connection = Batch->Connections[j];
+            if (Connection->Worker != Worker) {
+                continue;
+            }
+            if (!Connection->WorkerProcessing && !Connection->HasQueuedWork) {
+                if (QueuedCount++ == 0) {
+                    WakeWorkerThread = QuicWorkerIsIdle(Worker);
+                }
+                Connection->Stats.Schedule.LastQueueTime = CxPlatTimeUs32();
+                QuicTraceEvent(
+                    ConnScheduleState,
+                    "[conn][%p] Scheduling: %u",
+                    Connection,
+                    QUIC_SCHEDULE_QUEUED);
+                QuicConnAddRef(Connection, QUIC_CONN_REF_WORKER);
+                CxPlatListInsertTail(&Worker->Connections, &Connection->WorkerLink);
+            }
+            Connection->HasQueuedWork = TRUE;
+            Batch->Connections[j] = Batch->Connections[i];
+            Batch->Connections[i++] = Connection;
+        }
+        CxPlatDispatchLockRelease(&Worker->Lock);
+
+        if (QueuedCount != 0) {
+            if (WakeWorkerThread) {
+                QuicWorkerThreadWake(Worker);
+            }
+            QuicPerfCounterAdd(QUIC_PERF_COUNTER_CONN_QUEUE_DEPTH, QueuedCount);
+        }
+        for (; First < i; ++First) {
+            QuicConnRelease(Batch->Connections[First], QUIC_CONN_REF_LOOKUP_RESULT);
+        }
+    }
+    Batch->Count = 0;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicWorkerQueuePriorityConnection(
@@ -5,6 +5,28 @@
 
 --*/
 
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+//
+// The most connections a QUIC_WORKER_QUEUE_BATCH holds before it is flushed.
+//
+#define QUIC_WORKER_QUEUE_BATCH_SIZE 16
+
+//
+// Connections that need to be queued on their workers, collected so that each
+// worker's lock is only acquired (and its thread only woken) once for all of
+// them. Each connection holds a QUIC_CONN_REF_LOOKUP_RESULT reference until it
+// is queued.
+//
+typedef struct QUIC_WORKER_QUEUE_BATCH {
+
+    uint32_t Count;
+    QUIC_CONNECTION* Connections[QUIC_WORKER_QUEUE_BATCH_SIZE];
+
+} QUIC_WORKER_QUEUE_BATCH;
+
 //
 // A worker thread for draining queued operations on a connection.
 //
@@ -185,6 +207,27 @@ QuicWorkerQueueConnection(
     _In_ QUIC_CONNECTION* Connection
     );
 
+//
+// Adds the connection to the batch, to be queued onto its worker later by
+// QuicWorkerQueueBatchFlush.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicWorkerQueueBatchAdd(
+    _Inout_ QUIC_WORKER_QUEUE_BATCH* Batch,
+    _In_ QUIC_CONNECTION* Connection
+    );
+
+//
+// Queues all the connections in the batch onto their workers, and kicks each
+// worker thread if necessary.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicWorkerQueueBatchFlush(
+    _Inout_ QUIC_WORKER_QUEUE_BATCH* Batch
+    );
+
 //
 // Queues a priority connection onto the worker, and kicks the worker thread if
 // necessary.
@@ -205,4 +248,8 @@ void
 QuicWorkerQueueOperation(
     _In_ QUIC_WORKER* Worker,
     _In_ QUIC_OPERATION* Operation
-    );
\ No newline at end of file
+    );
+
+#if defined(__cplusplus)
+}
+#endif
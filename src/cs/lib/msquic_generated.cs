@@ -142,6 +142,7 @@ namespace Microsoft.Quic
     {
         FIFO = 0x0000,
         ROUND_ROBIN = 0x0001,
+        EXTENSIBLE_PRIORITY = 0x0002,
         COUNT,
     }
 
@@ -152,6 +153,7 @@ namespace Microsoft.Quic
         UNIDIRECTIONAL = 0x0001,
         ZERO_RTT = 0x0002,
         DELAY_ID_FC_UPDATES = 0x0004,
+        APP_OWNED_BUFFERS = 0x0008,
     }
 
     [System.Flags]
@@ -218,6 +220,7 @@ namespace Microsoft.Quic
         XDP = 0x0004,
         NO_IDEAL_PROC = 0x0008,
         HIGH_PRIORITY = 0x0010,
+        ZERO_COPY_SEND = 0x0020,
     }
 
     internal unsafe partial struct QUIC_EXECUTION_CONFIG
@@ -480,6 +483,9 @@ namespace Microsoft.Quic
     {
         CUBIC,
         BBR,
+        BBR3,
+        PRAGUE,
+        LEDBAT,
         MAX,
     }
 
@@ -888,6 +894,18 @@ namespace Microsoft.Quic
 
         [NativeTypeName("uint32_t")]
         internal uint SendEcnCongestionCount;
+
+        [NativeTypeName("uint32_t")]
+        internal uint SendMetadataBytesPerPacket;
+
+        [NativeTypeName("uint32_t")]
+        internal uint SendEcnCeRatio;
+
+        [NativeTypeName("uint64_t")]
+        internal ulong SendEctPackets;
+
+        [NativeTypeName("uint64_t")]
+        internal ulong SendEcnCePackets;
     }
 
     internal partial struct QUIC_LISTENER_STATISTICS
@@ -936,6 +954,8 @@ namespace Microsoft.Quic
         SEND_STATELESS_RESET,
         SEND_STATELESS_RETRY,
         CONN_LOAD_REJECT,
+        UDP_SEND_ZEROCOPY,
+        UDP_SEND_ZEROCOPY_COPIED,
         MAX,
     }
 
@@ -1364,6 +1384,19 @@ namespace Microsoft.Quic
             }
         }
 
+        internal ulong StreamZeroCopyReceiveEnabled
+        {
+            get
+            {
+                return Anonymous2.Anonymous.StreamZeroCopyReceiveEnabled;
+            }
+
+            set
+            {
+                Anonymous2.Anonymous.StreamZeroCopyReceiveEnabled = value;
+            }
+        }
+
         internal ulong ReservedFlags
         {
             get
@@ -1994,17 +2027,31 @@ namespace Microsoft.Quic
                     }
                 }
 
-                [NativeTypeName("uint64_t : 21")]
+                [NativeTypeName("uint64_t : 1")]
+                internal ulong StreamZeroCopyReceiveEnabled
+                {
+                    get
+                    {
+                        return (_bitfield >> 43) & 0x1UL;
+                    }
+
+                    set
+                    {
+                        _bitfield = (_bitfield & ~(0x1UL << 43)) | ((value & 0x1UL) << 43);
+                    }
+                }
+
+                [NativeTypeName("uint64_t : 20")]
                 internal ulong RESERVED
                 {
                     get
                     {
-                        return (_bitfield >> 43) & 0x1FFFFFUL;
+                        return (_bitfield >> 44) & 0xFFFFFUL;
                     }
 
                     set
                     {
-                        _bitfield = (_bitfield & ~(0x1FFFFFUL << 43)) | ((value & 0x1FFFFFUL) << 43);
+                        _bitfield = (_bitfield & ~(0xFFFFFUL << 44)) | ((value & 0xFFFFFUL) << 44);
                     }
                 }
             }
@@ -2109,17 +2156,31 @@ namespace Microsoft.Quic
                     }
                 }
 
-                [NativeTypeName("uint64_t : 58")]
+                [NativeTypeName("uint64_t : 1")]
+                internal ulong StreamZeroCopyReceiveEnabled
+                {
+                    get
+                    {
+                        return (_bitfield >> 6) & 0x1UL;
+                    }
+
+                    set
+                    {
+                        _bitfield = (_bitfield & ~(0x1UL << 6)) | ((value & 0x1UL) << 6);
+                    }
+                }
+
+                [NativeTypeName("uint64_t : 57")]
                 internal ulong ReservedFlags
                 {
                     get
                     {
-                        return (_bitfield >> 6) & 0x3FFFFFFUL;
+                        return (_bitfield >> 7) & 0x1FFFFFFFFFFFFFFUL;
                     }
 
                     set
                     {
-                        _bitfield = (_bitfield & ~(0x3FFFFFFUL << 6)) | ((value & 0x3FFFFFFUL) << 6);
+                        _bitfield = (_bitfield & ~(0x1FFFFFFFFFFFFFFUL << 7)) | ((value & 0x1FFFFFFFFFFFFFFUL) << 7);
                     }
                 }
             }
@@ -2269,6 +2330,15 @@ namespace Microsoft.Quic
         internal ulong StreamBlockedByAppUs;
     }
 
+    internal partial struct QUIC_STREAM_EXTENSIBLE_PRIORITY
+    {
+        [NativeTypeName("uint8_t")]
+        internal byte Urgency;
+
+        [NativeTypeName("BOOLEAN")]
+        internal byte Incremental;
+    }
+
     internal unsafe partial struct QUIC_SCHANNEL_CREDENTIAL_ATTRIBUTE_W
     {
         [NativeTypeName("unsigned long")]
@@ -2870,6 +2940,7 @@ namespace Microsoft.Quic
         IDEAL_SEND_BUFFER_SIZE = 8,
         PEER_ACCEPTED = 9,
         CANCEL_ON_LOSS = 10,
+        RECEIVE_BUFFER_NEEDED = 11,
     }
 
     internal partial struct QUIC_STREAM_EVENT
@@ -2951,6 +3022,14 @@ namespace Microsoft.Quic
             }
         }
 
+        internal ref _Anonymous_e__Union._RECEIVE_BUFFER_NEEDED_e__Struct RECEIVE_BUFFER_NEEDED
+        {
+            get
+            {
+                return ref MemoryMarshal.GetReference(MemoryMarshal.CreateSpan(ref Anonymous.RECEIVE_BUFFER_NEEDED, 1));
+            }
+        }
+
         [StructLayout(LayoutKind.Explicit)]
         internal partial struct _Anonymous_e__Union
         {
@@ -2990,6 +3069,10 @@ namespace Microsoft.Quic
             [NativeTypeName("struct (anonymous struct)")]
             internal _CANCEL_ON_LOSS_e__Struct CANCEL_ON_LOSS;
 
+            [FieldOffset(0)]
+            [NativeTypeName("struct (anonymous struct)")]
+            internal _RECEIVE_BUFFER_NEEDED_e__Struct RECEIVE_BUFFER_NEEDED;
+
             internal partial struct _START_COMPLETE_e__Struct
             {
                 [NativeTypeName("HRESULT")]
@@ -3153,9 +3236,72 @@ namespace Microsoft.Quic
                 [NativeTypeName("QUIC_UINT62")]
                 internal ulong ErrorCode;
             }
+
+            internal partial struct _RECEIVE_BUFFER_NEEDED_e__Struct
+            {
+                [NativeTypeName("uint64_t")]
+                internal ulong BufferLengthNeeded;
+            }
         }
     }
 
+    internal unsafe partial struct QUIC_SEND_BATCH_ENTRY
+    {
+        [NativeTypeName("HQUIC")]
+        internal QUIC_HANDLE* Stream;
+
+        [NativeTypeName("const QUIC_BUFFER *")]
+        internal QUIC_BUFFER* Buffers;
+
+        [NativeTypeName("uint32_t")]
+        internal uint BufferCount;
+
+        internal QUIC_SEND_FLAGS Flags;
+
+        internal void* ClientSendContext;
+
+        [NativeTypeName("QUIC_STATUS")]
+        internal int Status;
+    }
+
+    [System.Flags]
+    internal enum QUIC_CONNECTION_POOL_FLAGS
+    {
+        NONE = 0x00000000,
+        CLOSE_ON_FAILURE = 0x00000001,
+    }
+
+    internal unsafe partial struct QUIC_CONNECTION_POOL_CONFIG
+    {
+        [NativeTypeName("HQUIC")]
+        internal QUIC_HANDLE* Registration;
+
+        [NativeTypeName("HQUIC")]
+        internal QUIC_HANDLE* Configuration;
+
+        [NativeTypeName("QUIC_CONNECTION_CALLBACK_HANDLER")]
+        internal delegate* unmanaged[Cdecl]<QUIC_HANDLE*, void*, QUIC_CONNECTION_EVENT*, int> Handler;
+
+        internal void** Context;
+
+        [NativeTypeName("const char *")]
+        internal sbyte* ServerName;
+
+        [NativeTypeName("const QUIC_ADDR *")]
+        internal QuicAddr* ServerAddress;
+
+        [NativeTypeName("QUIC_ADDRESS_FAMILY")]
+        internal ushort Family;
+
+        [NativeTypeName("uint16_t")]
+        internal ushort ServerPort;
+
+        [NativeTypeName("uint16_t")]
+        internal ushort NumberOfConnections;
+
+        internal QUIC_CONNECTION_POOL_FLAGS Flags;
+    }
+
     internal unsafe partial struct QUIC_API_TABLE
     {
         [NativeTypeName("QUIC_SET_CONTEXT_FN")]
@@ -3250,6 +3396,15 @@ namespace Microsoft.Quic
 
         [NativeTypeName("QUIC_CONNECTION_COMP_CERT_FN")]
         internal delegate* unmanaged[Cdecl]<QUIC_HANDLE*, byte, QUIC_TLS_ALERT_CODES, int> ConnectionCertificateValidationComplete;
+
+        [NativeTypeName("QUIC_STREAM_PROVIDE_RECEIVE_BUFFERS_FN")]
+        internal delegate* unmanaged[Cdecl]<QUIC_HANDLE*, uint, QUIC_BUFFER*, int> StreamProvideReceiveBuffers;
+
+        [NativeTypeName("QUIC_CONNECTION_POOL_CREATE_FN")]
+        internal delegate* unmanaged[Cdecl]<QUIC_CONNECTION_POOL_CONFIG*, QUIC_HANDLE**, int> ConnectionPoolCreate;
+
+        [NativeTypeName("QUIC_CONNECTION_SEND_BATCH_FN")]
+        internal delegate* unmanaged[Cdecl]<QUIC_HANDLE*, QUIC_SEND_BATCH_ENTRY*, uint, int> ConnectionSendBatch;
     }
 
     internal static unsafe partial class MsQuic
@@ -3282,6 +3437,12 @@ namespace Microsoft.Quic
         [NativeTypeName("#define QUIC_TLS_SECRETS_MAX_SECRET_LEN 64")]
         internal const uint QUIC_TLS_SECRETS_MAX_SECRET_LEN = 64;
 
+        [NativeTypeName("#define QUIC_STREAM_URGENCY_MAX 7")]
+        internal const uint QUIC_STREAM_URGENCY_MAX = 7;
+
+        [NativeTypeName("#define QUIC_STREAM_URGENCY_DEFAULT 3")]
+        internal const uint QUIC_STREAM_URGENCY_DEFAULT = 3;
+
         [NativeTypeName("#define QUIC_PARAM_PREFIX_GLOBAL 0x01000000")]
         internal const uint QUIC_PARAM_PREFIX_GLOBAL = 0x01000000;
 
@@ -3354,6 +3515,9 @@ namespace Microsoft.Quic
         [NativeTypeName("#define QUIC_PARAM_CONFIGURATION_VERSION_SETTINGS 0x03000002")]
         internal const uint QUIC_PARAM_CONFIGURATION_VERSION_SETTINGS = 0x03000002;
 
+        [NativeTypeName("#define QUIC_PARAM_CONFIGURATION_CONGESTION_CONTROL 0x03000004")]
+        internal const uint QUIC_PARAM_CONFIGURATION_CONGESTION_CONTROL = 0x03000004;
+
         [NativeTypeName("#define QUIC_PARAM_CONFIGURATION_SCHANNEL_CREDENTIAL_ATTRIBUTE_W 0x03000003")]
         internal const uint QUIC_PARAM_CONFIGURATION_SCHANNEL_CREDENTIAL_ATTRIBUTE_W = 0x03000003;
 
@@ -3474,6 +3638,9 @@ namespace Microsoft.Quic
         [NativeTypeName("#define QUIC_PARAM_STREAM_RELIABLE_OFFSET 0x08000005")]
         internal const uint QUIC_PARAM_STREAM_RELIABLE_OFFSET = 0x08000005;
 
+        [NativeTypeName("#define QUIC_PARAM_STREAM_EXTENSIBLE_PRIORITY 0x08000006")]
+        internal const uint QUIC_PARAM_STREAM_EXTENSIBLE_PRIORITY = 0x08000006;
+
         [NativeTypeName("#define QUIC_API_VERSION_2 2")]
         internal const uint QUIC_API_VERSION_2 = 2;
     }
@@ -0,0 +1,12 @@
+#ifndef CLOG_DO_NOT_INCLUDE_HEADER
+#include <clog.h>
+#endif
+#ifdef __cplusplus
+extern "C" {
+#endif
+#ifdef __cplusplus
+}
+#endif
+#ifdef CLOG_INLINE_IMPLEMENTATION
+#include "quic.clog_AckBlockTest.cpp.clog.h.c"
+#endif
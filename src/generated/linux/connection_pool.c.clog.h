@@ -0,0 +1,135 @@
+#ifndef CLOG_DO_NOT_INCLUDE_HEADER
+#include <clog.h>
+#endif
+#undef TRACEPOINT_PROVIDER
+#define TRACEPOINT_PROVIDER CLOG_CONNECTION_POOL_C
+#undef TRACEPOINT_PROBE_DYNAMIC_LINKAGE
+#define  TRACEPOINT_PROBE_DYNAMIC_LINKAGE
+#undef TRACEPOINT_INCLUDE
+#define TRACEPOINT_INCLUDE "connection_pool.c.clog.h.lttng.h"
+#if !defined(DEF_CLOG_CONNECTION_POOL_C) || defined(TRACEPOINT_HEADER_MULTI_READ)
+#define DEF_CLOG_CONNECTION_POOL_C
+#include <lttng/tracepoint.h>
+#define __int64 __int64_t
+#include "connection_pool.c.clog.h.lttng.h"
+#endif
+#include <lttng/tracepoint-event.h>
+#ifndef _clog_MACRO_QuicTraceEvent
+#define _clog_MACRO_QuicTraceEvent  1
+#define QuicTraceEvent(a, ...) _clog_CAT(_clog_ARGN_SELECTOR(__VA_ARGS__), _clog_CAT(_,a(#a, __VA_ARGS__)))
+#endif
+#ifndef _clog_MACRO_QuicTraceLogConnInfo
+#define _clog_MACRO_QuicTraceLogConnInfo  1
+#define QuicTraceLogConnInfo(a, ...) _clog_CAT(_clog_ARGN_SELECTOR(__VA_ARGS__), _clog_CAT(_,a(#a, __VA_ARGS__)))
+#endif
+#ifndef _clog_MACRO_QuicTraceLogWarning
+#define _clog_MACRO_QuicTraceLogWarning  1
+#define QuicTraceLogWarning(a, ...) _clog_CAT(_clog_ARGN_SELECTOR(__VA_ARGS__), _clog_CAT(_,a(#a, __VA_ARGS__)))
+#endif
+#ifdef __cplusplus
+extern "C" {
+#endif
+/*----------------------------------------------------------
+// Decoder Ring for AllocFailure
+// Allocation of '%s' failed. (%llu bytes)
+// QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "connection pool RSS state",
+            sizeof(QUIC_CONN_POOL_RSS));
+// arg2 = arg2 = "connection pool RSS state" = arg2
+// arg3 = arg3 = sizeof(QUIC_CONN_POOL_RSS) = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_AllocFailure
+#define _clog_4_ARGS_TRACE_AllocFailure(uniqueId, encoded_arg_string, arg2, arg3)\
+tracepoint(CLOG_CONNECTION_POOL_C, AllocFailure , arg2, arg3);\
+
+#endif
+
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for ApiEnter
+// [ api] Enter %u (%p).
+// QuicTraceEvent(
+        ApiEnter,
+        "[ api] Enter %u (%p).",
+        QUIC_TRACE_API_CONNECTION_POOL_CREATE,
+        Config == NULL ? NULL : Config->Registration);
+// arg2 = arg2 = QUIC_TRACE_API_CONNECTION_POOL_CREATE = arg2
+// arg3 = arg3 = Config == NULL ? NULL : Config->Registration = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_ApiEnter
+#define _clog_4_ARGS_TRACE_ApiEnter(uniqueId, encoded_arg_string, arg2, arg3)\
+tracepoint(CLOG_CONNECTION_POOL_C, ApiEnter , arg2, arg3);\
+
+#endif
+
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for ConnPoolRssUnavailable
+// [ lib] Connection pool can't use RSS, 0x%x
+// QuicTraceLogWarning(
+            ConnPoolRssUnavailable,
+            "[ lib] Connection pool can't use RSS, 0x%x",
+            Status);
+// arg2 = arg2 = Status = arg2
+----------------------------------------------------------*/
+#ifndef _clog_3_ARGS_TRACE_ConnPoolRssUnavailable
+#define _clog_3_ARGS_TRACE_ConnPoolRssUnavailable(uniqueId, encoded_arg_string, arg2)\
+tracepoint(CLOG_CONNECTION_POOL_C, ConnPoolRssUnavailable , arg2);\
+
+#endif
+
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for ConnPoolRssQueue
+// [conn][%p] Connection pool picked local port %hu for RSS queue %u
+// QuicTraceLogConnInfo(
+                    ConnPoolRssQueue,
+                    Connection,
+                    "Connection pool picked local port %hu for RSS queue %u",
+                    QuicAddrGetPort(&Path->Route.LocalAddress),
+                    TargetQueue);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = QuicAddrGetPort(&Path->Route.LocalAddress) = arg3
+// arg4 = arg4 = TargetQueue = arg4
+----------------------------------------------------------*/
+#ifndef _clog_5_ARGS_TRACE_ConnPoolRssQueue
+#define _clog_5_ARGS_TRACE_ConnPoolRssQueue(uniqueId, arg1, encoded_arg_string, arg3, arg4)\
+tracepoint(CLOG_CONNECTION_POOL_C, ConnPoolRssQueue , arg1, arg3, arg4);\
+
+#endif
+
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for ApiExitStatus
+// [ api] Exit %u
+// QuicTraceEvent(
+        ApiExitStatus,
+        "[ api] Exit %u",
+        Status);
+// arg2 = arg2 = Status = arg2
+----------------------------------------------------------*/
+#ifndef _clog_3_ARGS_TRACE_ApiExitStatus
+#define _clog_3_ARGS_TRACE_ApiExitStatus(uniqueId, encoded_arg_string, arg2)\
+tracepoint(CLOG_CONNECTION_POOL_C, ApiExitStatus , arg2);\
+
+#endif
+
+
+
+
+#ifdef __cplusplus
+}
+#endif
+#ifdef CLOG_INLINE_IMPLEMENTATION
+#include "quic.clog_connection_pool.c.clog.h.c"
+#endif
@@ -0,0 +1,111 @@
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for AllocFailure
+// Allocation of '%s' failed. (%llu bytes)
+// QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "connection pool RSS state",
+            sizeof(QUIC_CONN_POOL_RSS));
+// arg2 = arg2 = "connection pool RSS state" = arg2
+// arg3 = arg3 = sizeof(QUIC_CONN_POOL_RSS) = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_CONNECTION_POOL_C, AllocFailure,
+    TP_ARGS(
+        const char *, arg2,
+        unsigned long long, arg3), 
+    TP_FIELDS(
+        ctf_string(arg2, arg2)
+        ctf_integer(uint64_t, arg3, arg3)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for ApiEnter
+// [ api] Enter %u (%p).
+// QuicTraceEvent(
+        ApiEnter,
+        "[ api] Enter %u (%p).",
+        QUIC_TRACE_API_CONNECTION_POOL_CREATE,
+        Config == NULL ? NULL : Config->Registration);
+// arg2 = arg2 = QUIC_TRACE_API_CONNECTION_POOL_CREATE = arg2
+// arg3 = arg3 = Config == NULL ? NULL : Config->Registration = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_CONNECTION_POOL_C, ApiEnter,
+    TP_ARGS(
+        unsigned int, arg2,
+        const void *, arg3), 
+    TP_FIELDS(
+        ctf_integer(unsigned int, arg2, arg2)
+        ctf_integer_hex(uint64_t, arg3, (uint64_t)arg3)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for ConnPoolRssUnavailable
+// [ lib] Connection pool can't use RSS, 0x%x
+// QuicTraceLogWarning(
+            ConnPoolRssUnavailable,
+            "[ lib] Connection pool can't use RSS, 0x%x",
+            Status);
+// arg2 = arg2 = Status = arg2
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_CONNECTION_POOL_C, ConnPoolRssUnavailable,
+    TP_ARGS(
+        unsigned int, arg2), 
+    TP_FIELDS(
+        ctf_integer(unsigned int, arg2, arg2)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for ConnPoolRssQueue
+// [conn][%p] Connection pool picked local port %hu for RSS queue %u
+// QuicTraceLogConnInfo(
+                    ConnPoolRssQueue,
+                    Connection,
+                    "Connection pool picked local port %hu for RSS queue %u",
+                    QuicAddrGetPort(&Path->Route.LocalAddress),
+                    TargetQueue);
+// arg1 = arg1 = Connection = arg1
+// arg3 = arg3 = QuicAddrGetPort(&Path->Route.LocalAddress) = arg3
+// arg4 = arg4 = TargetQueue = arg4
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_CONNECTION_POOL_C, ConnPoolRssQueue,
+    TP_ARGS(
+        const void *, arg1,
+        unsigned short, arg3,
+        unsigned int, arg4), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg1, (uint64_t)arg1)
+        ctf_integer(unsigned short, arg3, arg3)
+        ctf_integer(unsigned int, arg4, arg4)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for ApiExitStatus
+// [ api] Exit %u
+// QuicTraceEvent(
+        ApiExitStatus,
+        "[ api] Exit %u",
+        Status);
+// arg2 = arg2 = Status = arg2
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_CONNECTION_POOL_C, ApiExitStatus,
+    TP_ARGS(
+        unsigned int, arg2), 
+    TP_FIELDS(
+        ctf_integer(unsigned int, arg2, arg2)
+    )
+)
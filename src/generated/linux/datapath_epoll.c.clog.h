@@ -197,6 +197,24 @@ tracepoint(CLOG_DATAPATH_EPOLL_C, LibraryError , arg2);\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for DatapathZeroCopyFallback
+// [data][%p] Zero-copy send was copied by the kernel, disabling
+// QuicTraceLogWarning(
+                    DatapathZeroCopyFallback,
+                    "[data][%p] Zero-copy send was copied by the kernel, disabling",
+                    SocketContext->Binding);
+// arg2 = arg2 = SocketContext->Binding = arg2
+----------------------------------------------------------*/
+#ifndef _clog_3_ARGS_TRACE_DatapathZeroCopyFallback
+#define _clog_3_ARGS_TRACE_DatapathZeroCopyFallback(uniqueId, encoded_arg_string, arg2)\
+tracepoint(CLOG_DATAPATH_EPOLL_C, DatapathZeroCopyFallback , arg2);\
+
+#endif
+
+
+
+
 #ifdef __cplusplus
 }
 #endif
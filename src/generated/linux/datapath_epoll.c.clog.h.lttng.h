@@ -218,3 +218,22 @@ TRACEPOINT_EVENT(CLOG_DATAPATH_EPOLL_C, LibraryError,
         ctf_string(arg2, arg2)
     )
 )
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for DatapathZeroCopyFallback
+// [data][%p] Zero-copy send was copied by the kernel, disabling
+// QuicTraceLogWarning(
+                    DatapathZeroCopyFallback,
+                    "[data][%p] Zero-copy send was copied by the kernel, disabling",
+                    SocketContext->Binding);
+// arg2 = arg2 = SocketContext->Binding = arg2
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_DATAPATH_EPOLL_C, DatapathZeroCopyFallback,
+    TP_ARGS(
+        const void *, arg2), 
+    TP_FIELDS(
+        ctf_integer_hex(uint64_t, arg2, (uint64_t)arg2)
+    )
+)
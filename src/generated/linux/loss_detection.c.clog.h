@@ -368,9 +368,9 @@ tracepoint(CLOG_LOSS_DETECTION_C, ConnLossDetectionTimerSet , arg2, arg3, arg4,
             AllocFailure,
             "Allocation of '%s' failed. (%llu bytes)",
             "Sent packet metadata",
-            SIZEOF_QUIC_SENT_PACKET_METADATA(TempSentPacket->FrameCount));
+            sizeof(QUIC_SENT_PACKET_METADATA) + TempSentPacket->FrameCount * sizeof(QUIC_SENT_FRAME_METADATA));
 // arg2 = arg2 = "Sent packet metadata" = arg2
-// arg3 = arg3 = SIZEOF_QUIC_SENT_PACKET_METADATA(TempSentPacket->FrameCount) = arg3
+// arg3 = arg3 = sizeof(QUIC_SENT_PACKET_METADATA) + TempSentPacket->FrameCount * sizeof(QUIC_SENT_FRAME_METADATA) = arg3
 ----------------------------------------------------------*/
 #ifndef _clog_4_ARGS_TRACE_AllocFailure
 #define _clog_4_ARGS_TRACE_AllocFailure(uniqueId, encoded_arg_string, arg2, arg3)\
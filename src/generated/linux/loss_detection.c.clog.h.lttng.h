@@ -392,9 +392,9 @@ TRACEPOINT_EVENT(CLOG_LOSS_DETECTION_C, ConnLossDetectionTimerSet,
             AllocFailure,
             "Allocation of '%s' failed. (%llu bytes)",
             "Sent packet metadata",
-            SIZEOF_QUIC_SENT_PACKET_METADATA(TempSentPacket->FrameCount));
+            sizeof(QUIC_SENT_PACKET_METADATA) + TempSentPacket->FrameCount * sizeof(QUIC_SENT_FRAME_METADATA));
 // arg2 = arg2 = "Sent packet metadata" = arg2
-// arg3 = arg3 = SIZEOF_QUIC_SENT_PACKET_METADATA(TempSentPacket->FrameCount) = arg3
+// arg3 = arg3 = sizeof(QUIC_SENT_PACKET_METADATA) + TempSentPacket->FrameCount * sizeof(QUIC_SENT_FRAME_METADATA) = arg3
 ----------------------------------------------------------*/
 TRACEPOINT_EVENT(CLOG_LOSS_DETECTION_C, AllocFailure,
     TP_ARGS(
@@ -0,0 +1,7 @@
+#include <clog.h>
+#ifdef BUILDING_TRACEPOINT_PROVIDER
+#define TRACEPOINT_CREATE_PROBES
+#else
+#define TRACEPOINT_DEFINE
+#endif
+#include "app_congestion_control.c.clog.h"
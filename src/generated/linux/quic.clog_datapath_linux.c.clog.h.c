@@ -1 +1,7 @@
 #include <clog.h>
+#ifdef BUILDING_TRACEPOINT_PROVIDER
+#define TRACEPOINT_CREATE_PROBES
+#else
+#define TRACEPOINT_DEFINE
+#endif
+#include "datapath_linux.c.clog.h"
\ No newline at end of file
@@ -1 +1,7 @@
 #include <clog.h>
+#ifdef BUILDING_TRACEPOINT_PROVIDER
+#define TRACEPOINT_CREATE_PROBES
+#else
+#define TRACEPOINT_DEFINE
+#endif
+#include "sent_packet_metadata.c.clog.h"
\ No newline at end of file
@@ -233,6 +233,26 @@ tracepoint(CLOG_SEND_C, ConnFlushSend , arg2, arg3);\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for AllocFailure
+// Allocation of '%s' failed. (%llu bytes)
+// QuicTraceEvent(
+                AllocFailure,
+                "Allocation of '%s' failed. (%llu bytes)",
+                "send priority levels",
+                NewCapacity * sizeof(QUIC_SEND_PRIORITY_LEVEL));
+// arg2 = arg2 = "send priority levels" = arg2
+// arg3 = arg3 = NewCapacity * sizeof(QUIC_SEND_PRIORITY_LEVEL) = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_AllocFailure
+#define _clog_4_ARGS_TRACE_AllocFailure(uniqueId, encoded_arg_string, arg2, arg3)\
+tracepoint(CLOG_SEND_C, AllocFailure , arg2, arg3);\
+
+#endif
+
+
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -228,3 +228,26 @@ TRACEPOINT_EVENT(CLOG_SEND_C, ConnFlushSend,
         ctf_integer(unsigned int, arg3, arg3)
     )
 )
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for AllocFailure
+// Allocation of '%s' failed. (%llu bytes)
+// QuicTraceEvent(
+                AllocFailure,
+                "Allocation of '%s' failed. (%llu bytes)",
+                "send priority levels",
+                NewCapacity * sizeof(QUIC_SEND_PRIORITY_LEVEL));
+// arg2 = arg2 = "send priority levels" = arg2
+// arg3 = arg3 = NewCapacity * sizeof(QUIC_SEND_PRIORITY_LEVEL) = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_SEND_C, AllocFailure,
+    TP_ARGS(
+        const char *, arg2,
+        unsigned long long, arg3), 
+    TP_FIELDS(
+        ctf_string(arg2, arg2)
+        ctf_integer(uint64_t, arg3, arg3)
+    )
+)
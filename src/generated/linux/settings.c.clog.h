@@ -982,6 +982,36 @@ tracepoint(CLOG_SETTINGS_C, AllocFailure , arg2, arg3);\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for SettingsStreamZeroCopyReceiveEnabled
+// [sett] StreamZeroCopyReceiveEnabled= %hhu
+// QuicTraceLogVerbose(SettingsStreamZeroCopyReceiveEnabled, "[sett] StreamZeroCopyReceiveEnabled= %hhu", Settings->StreamZeroCopyReceiveEnabled);
+// arg2 = arg2 = Settings->StreamZeroCopyReceiveEnabled = arg2
+----------------------------------------------------------*/
+#ifndef _clog_3_ARGS_TRACE_SettingsStreamZeroCopyReceiveEnabled
+#define _clog_3_ARGS_TRACE_SettingsStreamZeroCopyReceiveEnabled(uniqueId, encoded_arg_string, arg2)\
+tracepoint(CLOG_SETTINGS_C, SettingsStreamZeroCopyReceiveEnabled , arg2);\
+
+#endif
+
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for SettingStreamZeroCopyReceiveEnabled
+// [sett] StreamZeroCopyReceiveEnabled = %hhu
+// QuicTraceLogVerbose(SettingStreamZeroCopyReceiveEnabled,    "[sett] StreamZeroCopyReceiveEnabled = %hhu", Settings->StreamZeroCopyReceiveEnabled);
+// arg2 = arg2 = Settings->StreamZeroCopyReceiveEnabled = arg2
+----------------------------------------------------------*/
+#ifndef _clog_3_ARGS_TRACE_SettingStreamZeroCopyReceiveEnabled
+#define _clog_3_ARGS_TRACE_SettingStreamZeroCopyReceiveEnabled(uniqueId, encoded_arg_string, arg2)\
+tracepoint(CLOG_SETTINGS_C, SettingStreamZeroCopyReceiveEnabled , arg2);\
+
+#endif
+
+
+
+
 #ifdef __cplusplus
 }
 #endif
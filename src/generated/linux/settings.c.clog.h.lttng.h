@@ -1032,3 +1032,35 @@ TRACEPOINT_EVENT(CLOG_SETTINGS_C, AllocFailure,
         ctf_integer(uint64_t, arg3, arg3)
     )
 )
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for SettingsStreamZeroCopyReceiveEnabled
+// [sett] StreamZeroCopyReceiveEnabled= %hhu
+// QuicTraceLogVerbose(SettingsStreamZeroCopyReceiveEnabled, "[sett] StreamZeroCopyReceiveEnabled= %hhu", Settings->StreamZeroCopyReceiveEnabled);
+// arg2 = arg2 = Settings->StreamZeroCopyReceiveEnabled = arg2
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_SETTINGS_C, SettingsStreamZeroCopyReceiveEnabled,
+    TP_ARGS(
+        unsigned char, arg2), 
+    TP_FIELDS(
+        ctf_integer(unsigned char, arg2, arg2)
+    )
+)
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for SettingStreamZeroCopyReceiveEnabled
+// [sett] StreamZeroCopyReceiveEnabled = %hhu
+// QuicTraceLogVerbose(SettingStreamZeroCopyReceiveEnabled,    "[sett] StreamZeroCopyReceiveEnabled = %hhu", Settings->StreamZeroCopyReceiveEnabled);
+// arg2 = arg2 = Settings->StreamZeroCopyReceiveEnabled = arg2
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_SETTINGS_C, SettingStreamZeroCopyReceiveEnabled,
+    TP_ARGS(
+        unsigned char, arg2), 
+    TP_FIELDS(
+        ctf_integer(unsigned char, arg2, arg2)
+    )
+)
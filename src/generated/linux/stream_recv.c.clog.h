@@ -575,6 +575,26 @@ tracepoint(CLOG_STREAM_RECV_C, StreamAppReceiveComplete , arg2, arg3);\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for IndicateReceiveBufferNeeded
+// [strm][%p] Indicating QUIC_STREAM_EVENT_RECEIVE_BUFFER_NEEDED [%llu bytes]
+// QuicTraceLogStreamVerbose(
+        IndicateReceiveBufferNeeded,
+        Stream,
+        "Indicating QUIC_STREAM_EVENT_RECEIVE_BUFFER_NEEDED [%llu bytes]",
+        Event.RECEIVE_BUFFER_NEEDED.BufferLengthNeeded);
+// arg1 = arg1 = Stream = arg1
+// arg3 = arg3 = Event.RECEIVE_BUFFER_NEEDED.BufferLengthNeeded = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_IndicateReceiveBufferNeeded
+#define _clog_4_ARGS_TRACE_IndicateReceiveBufferNeeded(uniqueId, arg1, encoded_arg_string, arg3)\
+tracepoint(CLOG_STREAM_RECV_C, IndicateReceiveBufferNeeded , arg1, arg3);\
+
+#endif
+
+
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -387,6 +387,26 @@ tracepoint(CLOG_STREAM_SEND_C, StreamWriteFrames , arg2, arg3);\
 
 
 
+/*----------------------------------------------------------
+// Decoder Ring for AllocFailure
+// Allocation of '%s' failed. (%llu bytes)
+// QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "send request index",
+            NewCapacity * sizeof(QUIC_SEND_REQUEST*));
+// arg2 = arg2 = "send request index" = arg2
+// arg3 = arg3 = NewCapacity * sizeof(QUIC_SEND_REQUEST*) = arg3
+----------------------------------------------------------*/
+#ifndef _clog_4_ARGS_TRACE_AllocFailure
+#define _clog_4_ARGS_TRACE_AllocFailure(uniqueId, encoded_arg_string, arg2, arg3)\
+tracepoint(CLOG_STREAM_SEND_C, AllocFailure , arg2, arg3);\
+
+#endif
+
+
+
+
 #ifdef __cplusplus
 }
 #endif
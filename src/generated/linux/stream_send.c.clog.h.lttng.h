@@ -433,3 +433,26 @@ TRACEPOINT_EVENT(CLOG_STREAM_SEND_C, StreamWriteFrames,
         ctf_integer(uint64_t, arg3, arg3)
     )
 )
+
+
+
+/*----------------------------------------------------------
+// Decoder Ring for AllocFailure
+// Allocation of '%s' failed. (%llu bytes)
+// QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "send request index",
+            NewCapacity * sizeof(QUIC_SEND_REQUEST*));
+// arg2 = arg2 = "send request index" = arg2
+// arg3 = arg3 = NewCapacity * sizeof(QUIC_SEND_REQUEST*) = arg3
+----------------------------------------------------------*/
+TRACEPOINT_EVENT(CLOG_STREAM_SEND_C, AllocFailure,
+    TP_ARGS(
+        const char *, arg2,
+        unsigned long long, arg3), 
+    TP_FIELDS(
+        ctf_string(arg2, arg2)
+        ctf_integer(uint64_t, arg3, arg3)
+    )
+)
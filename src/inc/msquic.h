@@ -189,6 +189,7 @@ DEFINE_ENUM_FLAG_OPERATORS(QUIC_SEND_RESUMPTION_FLAGS)
 typedef enum QUIC_STREAM_SCHEDULING_SCHEME {
     QUIC_STREAM_SCHEDULING_SCHEME_FIFO          = 0x0000,   // Sends stream data first come, first served. (Default)
     QUIC_STREAM_SCHEDULING_SCHEME_ROUND_ROBIN   = 0x0001,   // Sends stream data evenly multiplexed.
+    QUIC_STREAM_SCHEDULING_SCHEME_EXTENSIBLE_PRIORITY = 0x0002, // Sends stream data by RFC 9218 urgency and incremental semantics.
     QUIC_STREAM_SCHEDULING_SCHEME_COUNT,                    // The number of stream scheduling schemes.
 } QUIC_STREAM_SCHEDULING_SCHEME;
 
@@ -198,6 +199,8 @@ typedef enum QUIC_STREAM_OPEN_FLAGS {
     QUIC_STREAM_OPEN_FLAG_0_RTT             = 0x0002,   // The stream was opened via a 0-RTT packet.
     QUIC_STREAM_OPEN_FLAG_DELAY_ID_FC_UPDATES = 0x0004, // Indicates stream ID flow control limit updates for the
                                                         // connection should be delayed to StreamClose.
+    QUIC_STREAM_OPEN_FLAG_APP_OWNED_BUFFERS = 0x0008,   // Indicates the app provides the buffers received data is
+                                                        // written to, via StreamProvideReceiveBuffers.
 } QUIC_STREAM_OPEN_FLAGS;
 
 DEFINE_ENUM_FLAG_OPERATORS(QUIC_STREAM_OPEN_FLAGS)
@@ -272,6 +275,7 @@ typedef enum QUIC_EXECUTION_CONFIG_FLAGS {
     QUIC_EXECUTION_CONFIG_FLAG_XDP              = 0x0004,
     QUIC_EXECUTION_CONFIG_FLAG_NO_IDEAL_PROC    = 0x0008,
     QUIC_EXECUTION_CONFIG_FLAG_HIGH_PRIORITY    = 0x0010,
+    QUIC_EXECUTION_CONFIG_FLAG_ZERO_COPY_SEND   = 0x0020,
 #endif
 } QUIC_EXECUTION_CONFIG_FLAGS;
 
@@ -434,6 +438,9 @@ typedef enum QUIC_CONGESTION_CONTROL_ALGORITHM {
     QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC,
 #ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
     QUIC_CONGESTION_CONTROL_ALGORITHM_BBR,
+    QUIC_CONGESTION_CONTROL_ALGORITHM_BBR3,
+    QUIC_CONGESTION_CONTROL_ALGORITHM_PRAGUE,
+    QUIC_CONGESTION_CONTROL_ALGORITHM_LEDBAT,
 #endif
     QUIC_CONGESTION_CONTROL_ALGORITHM_MAX,
 } QUIC_CONGESTION_CONTROL_ALGORITHM;
@@ -555,6 +562,12 @@ typedef struct QUIC_STATISTICS_V2 {
 
     uint32_t SendEcnCongestionCount;        // Number of congestion events caused by ECN.
 
+    uint32_t SendMetadataBytesPerPacket;    // Average sent packet tracking memory per outstanding packet.
+
+    uint32_t SendEcnCeRatio;                // Smoothed fraction of packets CE marked per round trip, in parts per million. Only tracked by PRAGUE.
+    uint64_t SendEctPackets;                // Number of packets sent with an ECT codepoint.
+    uint64_t SendEcnCePackets;              // Number of sent packets the peer reported as CE marked.
+
     // N.B. New fields must be appended to end
 
 } QUIC_STATISTICS_V2;
@@ -608,6 +621,8 @@ typedef enum QUIC_PERFORMANCE_COUNTERS {
     QUIC_PERF_COUNTER_SEND_STATELESS_RESET, // Total stateless reset packets sent ever.
     QUIC_PERF_COUNTER_SEND_STATELESS_RETRY, // Total stateless retry packets sent ever.
     QUIC_PERF_COUNTER_CONN_LOAD_REJECT,     // Total connections rejected due to worker load.
+    QUIC_PERF_COUNTER_UDP_SEND_ZEROCOPY,    // Total UDP send calls that didn't copy the payload.
+    QUIC_PERF_COUNTER_UDP_SEND_ZEROCOPY_COPIED, // Total zero-copy UDP send calls the kernel still copied.
     QUIC_PERF_COUNTER_MAX,
 } QUIC_PERFORMANCE_COUNTERS;
 
@@ -688,7 +703,8 @@ typedef struct QUIC_SETTINGS {
             uint64_t OneWayDelayEnabled                     : 1;
             uint64_t NetStatsEventEnabled                   : 1;
             uint64_t StreamMultiReceiveEnabled              : 1;
-            uint64_t RESERVED                               : 21;
+            uint64_t StreamZeroCopyReceiveEnabled           : 1;
+            uint64_t RESERVED                               : 20;
 #else
             uint64_t RESERVED                               : 26;
 #endif
@@ -739,7 +755,8 @@ typedef struct QUIC_SETTINGS {
             uint64_t OneWayDelayEnabled        : 1;
             uint64_t NetStatsEventEnabled      : 1;
             uint64_t StreamMultiReceiveEnabled : 1;
-            uint64_t ReservedFlags             : 58;
+            uint64_t StreamZeroCopyReceiveEnabled : 1;
+            uint64_t ReservedFlags             : 57;
 #else
             uint64_t ReservedFlags             : 63;
 #endif
@@ -786,6 +803,14 @@ typedef struct QUIC_STREAM_STATISTICS {
     uint64_t StreamBlockedByAppUs;
 } QUIC_STREAM_STATISTICS;
 
+#define QUIC_STREAM_URGENCY_MAX     7
+#define QUIC_STREAM_URGENCY_DEFAULT 3
+
+typedef struct QUIC_STREAM_EXTENSIBLE_PRIORITY {
+    uint8_t Urgency;        // 0 (highest) to 7 (lowest) - 3 (default)
+    BOOLEAN Incremental;    // Data may be interleaved with other incremental streams of the same urgency.
+} QUIC_STREAM_EXTENSIBLE_PRIORITY;
+
 //
 // Functions for associating application contexts with QUIC handles. MsQuic
 // provides no explicit synchronization between parallel calls to these
@@ -868,6 +893,7 @@ void
 #define QUIC_PARAM_CONFIGURATION_TICKET_KEYS            0x03000001  // QUIC_TICKET_KEY_CONFIG[]
 #ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
 #define QUIC_PARAM_CONFIGURATION_VERSION_SETTINGS       0x03000002  // QUIC_VERSION_SETTINGS
+#define QUIC_PARAM_CONFIGURATION_CONGESTION_CONTROL     0x03000004  // QUIC_CONGESTION_CONTROL_CALLBACKS
 #endif
 // Schannel-specific Configuration parameter
 typedef struct QUIC_SCHANNEL_CREDENTIAL_ATTRIBUTE_W {
@@ -877,6 +903,167 @@ typedef struct QUIC_SCHANNEL_CREDENTIAL_ATTRIBUTE_W {
 } QUIC_SCHANNEL_CREDENTIAL_ATTRIBUTE_W;
 #define QUIC_PARAM_CONFIGURATION_SCHANNEL_CREDENTIAL_ATTRIBUTE_W  0x03000003  // QUIC_SCHANNEL_CREDENTIAL_ATTRIBUTE_W
 
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+//
+// Application provided congestion control, set with
+// QUIC_PARAM_CONFIGURATION_CONGESTION_CONTROL.
+//
+// The callbacks are registered on a configuration and are used by every
+// connection that configuration is set on, instead of the built-in algorithm
+// selected by QUIC_SETTINGS.CongestionControlAlgorithm. They are invoked inline
+// on the connection's worker thread, so they must not block. Each connection
+// reserves StateSize bytes of zero initialized, 8 byte aligned state for the
+// controller, so no allocations are needed per connection.
+//
+// MsQuic tracks the bytes in flight and enforces the congestion window and
+// pacing rate returned by the controller.
+//
+#define QUIC_CONGESTION_CONTROL_CALLBACKS_VERSION   1
+#define QUIC_CONGESTION_CONTROL_MAX_STATE_SIZE      256
+
+typedef struct QUIC_CONGESTION_CONTROL_RESET_INFO {
+    uint32_t InitialWindowPackets;
+    uint32_t SendIdleTimeoutMs;
+    uint16_t DatagramPayloadLength;     // Current max UDP payload, in bytes.
+    BOOLEAN FullReset;                  // FALSE on a reset after idle or a path change.
+} QUIC_CONGESTION_CONTROL_RESET_INFO;
+
+typedef struct QUIC_CONGESTION_CONTROL_ACK_INFO {
+    uint64_t TimeNow;                   // Microseconds.
+    uint64_t LargestAck;                // Largest packet number acknowledged.
+    uint64_t LargestSentPacketNumber;
+    uint64_t TotalAckedBytes;           // Retransmittable bytes acknowledged over the connection lifetime.
+    uint64_t SmoothedRtt;               // Microseconds.
+    uint64_t MinRtt;                    // Minimum RTT over the connection lifetime, in microseconds.
+    uint64_t RttSample;                 // Smallest RTT of the newly acknowledged packets, valid if RttSampleValid.
+    uint64_t OneWayDelay;               // Smoothed send path one-way delay, in microseconds, if negotiated.
+    uint64_t DeliveryRate;              // Bytes per second, valid if DeliveryRateValid.
+    uint32_t AckedBytes;                // Newly acknowledged retransmittable bytes.
+    uint32_t BytesInFlight;             // After removing AckedBytes.
+    uint16_t DatagramPayloadLength;
+    BOOLEAN RttSampleValid;
+    BOOLEAN DeliveryRateValid;
+    BOOLEAN IsImplicit;                 // Implicitly acknowledged by discarding the packet's keys.
+    BOOLEAN HasLoss;                    // The ACK also caused packets to be declared lost.
+    BOOLEAN IsAppLimited;               // The largest acknowledged packet was sent while application limited.
+} QUIC_CONGESTION_CONTROL_ACK_INFO;
+
+typedef struct QUIC_CONGESTION_CONTROL_LOSS_INFO {
+    uint64_t LargestPacketNumberLost;
+    uint64_t LargestSentPacketNumber;
+    uint32_t LostBytes;
+    uint32_t BytesInFlight;             // After removing LostBytes.
+    uint16_t DatagramPayloadLength;
+    BOOLEAN PersistentCongestion;
+} QUIC_CONGESTION_CONTROL_LOSS_INFO;
+
+typedef struct QUIC_CONGESTION_CONTROL_ECN_INFO {
+    uint64_t LargestPacketNumberAcked;
+    uint64_t LargestSentPacketNumber;
+    uint64_t NewCeCount;                // Packets newly reported as CE marked.
+    uint32_t BytesInFlight;
+    uint16_t DatagramPayloadLength;
+} QUIC_CONGESTION_CONTROL_ECN_INFO;
+
+//
+// Called when the connection starts using the controller (with FullReset
+// set and zeroed State) and whenever congestion state must be reset.
+//
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+(QUIC_API * QUIC_CONGESTION_CONTROL_RESET_FN)(
+    _In_opt_ void* Context,
+    _Inout_ void* State,
+    _In_ const QUIC_CONGESTION_CONTROL_RESET_INFO* Info
+    );
+
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+(QUIC_API * QUIC_CONGESTION_CONTROL_DATA_SENT_FN)(
+    _In_opt_ void* Context,
+    _Inout_ void* State,
+    _In_ uint32_t SentBytes,
+    _In_ uint32_t BytesInFlight
+    );
+
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+(QUIC_API * QUIC_CONGESTION_CONTROL_DATA_ACKED_FN)(
+    _In_opt_ void* Context,
+    _Inout_ void* State,
+    _In_ const QUIC_CONGESTION_CONTROL_ACK_INFO* Info
+    );
+
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+(QUIC_API * QUIC_CONGESTION_CONTROL_DATA_LOST_FN)(
+    _In_opt_ void* Context,
+    _Inout_ void* State,
+    _In_ const QUIC_CONGESTION_CONTROL_LOSS_INFO* Info
+    );
+
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+(QUIC_API * QUIC_CONGESTION_CONTROL_ECN_FN)(
+    _In_opt_ void* Context,
+    _Inout_ void* State,
+    _In_ const QUIC_CONGESTION_CONTROL_ECN_INFO* Info
+    );
+
+//
+// Called when all packets recently declared lost were acknowledged after all.
+// Returns TRUE if the controller reverted its response to the loss.
+//
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+(QUIC_API * QUIC_CONGESTION_CONTROL_SPURIOUS_LOSS_FN)(
+    _In_opt_ void* Context,
+    _Inout_ void* State
+    );
+
+//
+// Returns the congestion window, in bytes.
+//
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+(QUIC_API * QUIC_CONGESTION_CONTROL_GET_WINDOW_FN)(
+    _In_opt_ void* Context,
+    _In_ const void* State
+    );
+
+//
+// Returns the pacing rate, in bytes per second. Zero disables pacing.
+//
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+(QUIC_API * QUIC_CONGESTION_CONTROL_GET_PACING_RATE_FN)(
+    _In_opt_ void* Context,
+    _In_ const void* State
+    );
+
+typedef struct QUIC_CONGESTION_CONTROL_CALLBACKS {
+    uint32_t Version;                   // QUIC_CONGESTION_CONTROL_CALLBACKS_VERSION
+    uint32_t StateSize;                 // Up to QUIC_CONGESTION_CONTROL_MAX_STATE_SIZE bytes.
+    void* Context;                      // Passed to every callback.
+    QUIC_CONGESTION_CONTROL_RESET_FN Reset;
+    QUIC_CONGESTION_CONTROL_DATA_SENT_FN OnDataSent;                // Optional.
+    QUIC_CONGESTION_CONTROL_DATA_ACKED_FN OnDataAcknowledged;
+    QUIC_CONGESTION_CONTROL_DATA_LOST_FN OnDataLost;
+    QUIC_CONGESTION_CONTROL_ECN_FN OnEcn;                           // Optional.
+    QUIC_CONGESTION_CONTROL_SPURIOUS_LOSS_FN OnSpuriousLoss;        // Optional.
+    QUIC_CONGESTION_CONTROL_GET_WINDOW_FN GetCongestionWindow;
+    QUIC_CONGESTION_CONTROL_GET_PACING_RATE_FN GetPacingRate;       // Optional.
+} QUIC_CONGESTION_CONTROL_CALLBACKS;
+#endif
+
 //
 // Parameters for Listener.
 //
@@ -951,6 +1138,7 @@ typedef struct QUIC_SCHANNEL_CONTEXT_ATTRIBUTE_EX_W {
 #ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
 #define QUIC_PARAM_STREAM_RELIABLE_OFFSET               0x08000005  // uint64_t
 #endif
+#define QUIC_PARAM_STREAM_EXTENSIBLE_PRIORITY           0x08000006  // QUIC_STREAM_EXTENSIBLE_PRIORITY
 
 typedef
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -1408,6 +1596,7 @@ typedef enum QUIC_STREAM_EVENT_TYPE {
     QUIC_STREAM_EVENT_IDEAL_SEND_BUFFER_SIZE    = 8,
     QUIC_STREAM_EVENT_PEER_ACCEPTED             = 9,
     QUIC_STREAM_EVENT_CANCEL_ON_LOSS            = 10,
+    QUIC_STREAM_EVENT_RECEIVE_BUFFER_NEEDED     = 11,
 } QUIC_STREAM_EVENT_TYPE;
 
 typedef struct QUIC_STREAM_EVENT {
@@ -1456,6 +1645,9 @@ typedef struct QUIC_STREAM_EVENT {
         struct {
             /* out */ QUIC_UINT62 ErrorCode;
         } CANCEL_ON_LOSS;
+        struct {
+            /* in */ uint64_t BufferLengthNeeded;
+        } RECEIVE_BUFFER_NEEDED;
     };
 } QUIC_STREAM_EVENT;
 
@@ -1558,6 +1750,22 @@ QUIC_STATUS
     _In_ BOOLEAN IsEnabled
     );
 
+//
+// Provides buffers for received data to be written to, for a stream in
+// app-owned buffer mode. The buffers are owned by MsQuic until all the data in
+// them has been completed via StreamReceiveComplete, or the stream is shut
+// down.
+//
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+(QUIC_API * QUIC_STREAM_PROVIDE_RECEIVE_BUFFERS_FN)(
+    _In_ _Pre_defensive_ HQUIC Stream,
+    _In_ uint32_t BufferCount,
+    _In_reads_(BufferCount) _Pre_defensive_
+        const QUIC_BUFFER* Buffers
+    );
+
 //
 // Datagrams
 //
@@ -1578,6 +1786,77 @@ QUIC_STATUS
     _In_opt_ void* ClientSendContext
     );
 
+//
+// Batched Sends
+//
+
+typedef struct QUIC_SEND_BATCH_ENTRY {
+    HQUIC Stream;                           // NULL to send a datagram.
+    const QUIC_BUFFER* Buffers;
+    uint32_t BufferCount;
+    QUIC_SEND_FLAGS Flags;
+    void* ClientSendContext;
+    QUIC_STATUS Status;                     // Out. QUIC_STATUS_PENDING if queued.
+} QUIC_SEND_BATCH_ENTRY;
+
+//
+// Queues sends on any number of streams (and/or datagrams) of the same
+// connection at once. Equivalent to calling StreamSend or DatagramSend for
+// each entry, but queues at most a single connection operation for the whole
+// batch. Each entry's Status is set to QUIC_STATUS_PENDING if it was queued,
+// in which case its completion is indicated as usual.
+//
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+(QUIC_API * QUIC_CONNECTION_SEND_BATCH_FN)(
+    _In_ _Pre_defensive_ HQUIC Connection,
+    _Inout_updates_(EntryCount) _Pre_defensive_
+        QUIC_SEND_BATCH_ENTRY* Entries,
+    _In_ uint32_t EntryCount
+    );
+
+//
+// Connection Pools
+//
+
+typedef enum QUIC_CONNECTION_POOL_FLAGS {
+    QUIC_CONNECTION_POOL_FLAG_NONE =                0x00000000,
+    QUIC_CONNECTION_POOL_FLAG_CLOSE_ON_FAILURE =    0x00000001, // Closes all the pool's connections if any fails to be created.
+} QUIC_CONNECTION_POOL_FLAGS;
+
+DEFINE_ENUM_FLAG_OPERATORS(QUIC_CONNECTION_POOL_FLAGS)
+
+typedef struct QUIC_CONNECTION_POOL_CONFIG {
+    HQUIC Registration;
+    HQUIC Configuration;
+    QUIC_CONNECTION_CALLBACK_HANDLER Handler;
+    _Field_size_opt_(NumberOfConnections)
+        void** Context;                     // Optional. One context per connection.
+    const char* ServerName;
+    const QUIC_ADDR* ServerAddress;         // Optional. Resolved from ServerName if NULL.
+    QUIC_ADDRESS_FAMILY Family;
+    uint16_t ServerPort;                    // Host byte order
+    uint16_t NumberOfConnections;
+    QUIC_CONNECTION_POOL_FLAGS Flags;
+} QUIC_CONNECTION_POOL_CONFIG;
+
+//
+// Opens and starts a pool of client connections to the same server. The local
+// ports are chosen so that the connections are spread evenly over the local
+// interface's receive (RSS) queues and over the registration's workers. Returns
+// once all the connections have been started (or one of them failed to be);
+// each connection then indicates its events to Handler, with its own Context.
+//
+typedef
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+(QUIC_API * QUIC_CONNECTION_POOL_CREATE_FN)(
+    _In_ _Pre_defensive_ const QUIC_CONNECTION_POOL_CONFIG* Config,
+    _Out_writes_(Config->NumberOfConnections) _Pre_defensive_
+        HQUIC* ConnectionPool
+    );
+
 //
 // Version 2 API Function Table. Returned from MsQuicOpenVersion when Version
 // is 2. Also returned from MsQuicOpen2.
@@ -1626,6 +1905,11 @@ typedef struct QUIC_API_TABLE {
     QUIC_CONNECTION_COMP_RESUMPTION_FN  ConnectionResumptionTicketValidationComplete; // Available from v2.2
     QUIC_CONNECTION_COMP_CERT_FN        ConnectionCertificateValidationComplete;      // Available from v2.2
 
+    QUIC_STREAM_PROVIDE_RECEIVE_BUFFERS_FN
+                                        StreamProvideReceiveBuffers;                  // Available from v2.5
+    QUIC_CONNECTION_POOL_CREATE_FN      ConnectionPoolCreate;                         // Available from v2.5
+    QUIC_CONNECTION_SEND_BATCH_FN       ConnectionSendBatch;                          // Available from v2.5
+
 } QUIC_API_TABLE;
 
 #define QUIC_API_VERSION_1      1 // Not supported any more
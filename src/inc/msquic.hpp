@@ -606,6 +606,7 @@ public:
     MsQuicSettings& SetOneWayDelayEnabled(bool value) { OneWayDelayEnabled = value; IsSet.OneWayDelayEnabled = TRUE; return *this; }
     MsQuicSettings& SetNetStatsEventEnabled(bool value) { NetStatsEventEnabled = value; IsSet.NetStatsEventEnabled = TRUE; return *this; }
     MsQuicSettings& SetStreamMultiReceiveEnabled(bool value) { StreamMultiReceiveEnabled = value; IsSet.StreamMultiReceiveEnabled = TRUE; return *this; }
+    MsQuicSettings& SetStreamZeroCopyReceiveEnabled(bool value) { StreamZeroCopyReceiveEnabled = value; IsSet.StreamZeroCopyReceiveEnabled = TRUE; return *this; }
 #endif
 
     QUIC_STATUS
@@ -1525,6 +1526,15 @@ struct MsQuicStream {
         return MsQuic->StreamReceiveSetEnabled(Handle, IsEnabled ? TRUE : FALSE);
     }
 
+    _IRQL_requires_max_(DISPATCH_LEVEL)
+    QUIC_STATUS
+    ProvideReceiveBuffers(
+        _In_ uint32_t BufferCount,
+        _In_reads_(BufferCount) const QUIC_BUFFER* Buffers
+        ) noexcept {
+        return MsQuic->StreamProvideReceiveBuffers(Handle, BufferCount, Buffers);
+    }
+
     QUIC_STATUS
     GetID(_Out_ QUIC_UINT62* ID) const noexcept {
         uint32_t Size = sizeof(*ID);
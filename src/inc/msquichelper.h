@@ -200,6 +200,8 @@ DumpMsQuicPerfCounters(
     printf("  SEND_STATELESS_RESET:  %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_SEND_STATELESS_RESET]);
     printf("  SEND_STATELESS_RETRY:  %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_SEND_STATELESS_RETRY]);
     printf("  CONN_LOAD_REJECT:      %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_CONN_LOAD_REJECT]);
+    printf("  UDP_SEND_ZEROCOPY:     %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_UDP_SEND_ZEROCOPY]);
+    printf("  UDP_SEND_ZC_COPIED:    %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_UDP_SEND_ZEROCOPY_COPIED]);
 }
 
 //
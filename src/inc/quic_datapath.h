@@ -458,6 +458,23 @@ CxPlatDataPathIsPaddingPreferred(
     _In_ CXPLAT_SEND_DATA* SendData
     );
 
+typedef struct CXPLAT_DATAPATH_STATISTICS {
+
+    uint64_t SendZeroCopyCount;         // Sends submitted without copying the payload.
+    uint64_t SendZeroCopyCopiedCount;   // Zero-copy sends the kernel ended up copying anyway.
+
+} CXPLAT_DATAPATH_STATISTICS;
+
+//
+// Queries the cumulative statistics of the datapath.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatDataPathGetStatistics(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _Out_ CXPLAT_DATAPATH_STATISTICS* Statistics
+    );
+
 //
 // Resolves a hostname to an IP address.
 //
@@ -517,6 +534,46 @@ CxPlatDataPathGetGatewayAddresses(
     _Out_ uint32_t* GatewayAddressesCount
     );
 
+#define CXPLAT_RSS_HASH_TYPE_UDP_IPV4   0x00000001  // UDP ports are hashed for IPv4
+#define CXPLAT_RSS_HASH_TYPE_UDP_IPV6   0x00000002  // UDP ports are hashed for IPv6
+
+//
+// The receive side scaling (RSS) configuration of an interface. Only Toeplitz
+// hashing is reported.
+//
+typedef struct CXPLAT_RSS_CONFIG {
+    uint32_t HashTypes;                 // CXPLAT_RSS_HASH_TYPE_*
+    uint32_t RssSecretKeyLength;
+    uint32_t RssIndirectionTableCount;
+    _Field_size_(RssSecretKeyLength)
+        uint8_t* RssSecretKey;
+    _Field_size_(RssIndirectionTableCount)
+        uint32_t* RssIndirectionTable;  // Receive queue index for each entry
+} CXPLAT_RSS_CONFIG;
+
+//
+// Gets the RSS configuration of the interface that owns the local address.
+// The returned configuration must be freed with CxPlatDataPathRssConfigFree.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Success_(QUIC_SUCCEEDED(return))
+QUIC_STATUS
+CxPlatDataPathRssConfigGet(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _In_ const QUIC_ADDR* LocalAddress,
+    _Outptr_ _At_(*RssConfig, __drv_allocatesMem(Mem))
+        CXPLAT_RSS_CONFIG** RssConfig
+    );
+
+//
+// Frees the RSS configuration returned by CxPlatDataPathRssConfigGet.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatDataPathRssConfigFree(
+    _In_ __drv_freesMem(Mem) CXPLAT_RSS_CONFIG* RssConfig
+    );
+
 //
 // The following APIs are specific to a single UDP or TCP socket abstraction.
 //
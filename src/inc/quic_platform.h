@@ -148,6 +148,16 @@ typedef struct CXPLAT_SLIST_ENTRY {
 #define QUIC_POOL_ROUTE_RESOLUTION_WORKER   'A4cQ' // Qc4A - QUIC route resolution worker
 #define QUIC_POOL_ROUTE_RESOLUTION_OPER     'B4cQ' // Qc4B - QUIC route resolution operation
 #define QUIC_POOL_EXECUTION_CONFIG          'C4cQ' // Qc4C - QUIC execution config
+#define QUIC_POOL_PLATFORM_POOL_CACHE       'D4cQ' // Qc4D - QUIC platform pool magazine cache
+#define QUIC_POOL_SEND_PRIORITY             'E4cQ' // Qc4E - QUIC send priority levels
+#define QUIC_POOL_DATAPATH_RSS_CONFIG       'F4cQ' // Qc4F - QUIC Datapath RSS configuration
+#define QUIC_POOL_CONN_POOL_API             '05cQ' // Qc50 - QUIC Connection Pool API
+#define QUIC_POOL_SEND_BATCH                '15cQ' // Qc51 - QUIC Send batch streams
+#define QUIC_POOL_SENT_PACKET_RING          '25cQ' // Qc52 - QUIC Sent packet ring
+#define QUIC_POOL_SENT_FRAME_ARENA          '35cQ' // Qc53 - QUIC Sent frame arena chunk
+#define QUIC_POOL_SEND_REQUEST_INDEX        '45cQ' // Qc54 - QUIC Send request index
+#define QUIC_POOL_LOOKUP_READERS            '55cQ' // Qc55 - QUIC Lookup reader counters
+#define QUIC_POOL_LOOKUP_RETIRED            '65cQ' // Qc56 - QUIC Lookup retired objects
 
 typedef enum CXPLAT_THREAD_FLAGS {
     CXPLAT_THREAD_FLAG_NONE               = 0x0000,
@@ -413,6 +423,15 @@ CxPlatSetAllocFailDenominator(
 int32_t
 CxPlatGetAllocFailDenominator(
     );
+
+//
+// Makes the platform clock return TimeUs instead of the real time, so tests
+// can run on a virtual clock. Zero goes back to the real time.
+//
+void
+CxPlatSetTimeOverride(
+    _In_ uint64_t TimeUs
+    );
 #endif
 
 #ifdef DEBUG
@@ -252,6 +252,7 @@ InterlockedDecrement64(
 }
 
 #define QuicReadPtrNoFence(p) ((void*)(*p)) // TODO
+#define QuicReadPtrAcquire(p) ((void*)__atomic_load_n((p), __ATOMIC_ACQUIRE))
 
 //
 // Assertion interfaces.
@@ -443,10 +444,115 @@ CxPlatListPopEntry(
     _Inout_ CXPLAT_SLIST_ENTRY* ListHead
     );
 
+extern uint32_t CxPlatProcessorCount;
+
+uint32_t
+CxPlatProcCurrentNumber(
+    void
+    );
+
+//
+// The pool keeps a per-processor magazine (a small, fixed size stack of free
+// entries) in front of the shared free list. A thread claims its processor's
+// magazine with a single atomic exchange, so the common alloc/free pair never
+// touches a shared lock. Full and empty magazines are exchanged with a depot
+// that is protected by the pool lock, which is only taken once every
+// CXPLAT_POOL_MAGAZINE_SIZE operations. Entries freed on a different processor
+// than they were allocated on simply go into that processor's magazine and flow
+// back through the depot.
+//
+
+#define CXPLAT_POOL_MAGAZINE_SIZE   32
+
+//
+// Each processor's cache gets its own 64 bytes, so that processors don't share
+// cache lines. The cache array is aligned to match when it's allocated.
+//
+#define CXPLAT_POOL_CACHE_ALIGNMENT 64
+
+typedef struct CXPLAT_POOL_MAGAZINE {
+
+    //
+    // Link in the depot's full or empty magazine list.
+    //
+
+    struct CXPLAT_POOL_MAGAZINE* Next;
+
+    //
+    // Number of valid entries in the Entries array.
+    //
+
+    uint32_t Count;
+
+    void* Entries[CXPLAT_POOL_MAGAZINE_SIZE];
+
+} CXPLAT_POOL_MAGAZINE;
+
+typedef struct CXPLAT_POOL_CACHE {
+
+    //
+    // The processor's loaded magazine. NULL while a thread has it claimed (or
+    // if the cache hasn't been populated yet).
+    //
+
+    alignas(CXPLAT_POOL_CACHE_ALIGNMENT) CXPLAT_POOL_MAGAZINE* volatile Magazine;
+
+    //
+    // Set once the cache has had a magazine assigned.
+    //
+
+    BOOLEAN Populated;
+
+    //
+    // Statistics, only updated by the thread that has the magazine claimed.
+    //
+
+    uint64_t AllocHits;
+    uint64_t AllocMisses;
+    uint64_t FreeHits;
+    uint64_t FreeMisses;
+
+} CXPLAT_POOL_CACHE;
+
+typedef struct CXPLAT_POOL_STATS {
+
+    //
+    // Allocations served from a per-processor magazine.
+    //
+
+    uint64_t AllocHits;
+
+    //
+    // Allocations that fell back to the shared list or the heap.
+    //
+
+    uint64_t AllocMisses;
+
+    //
+    // Frees absorbed by a per-processor magazine.
+    //
+
+    uint64_t FreeHits;
+
+    //
+    // Frees that fell back to the shared list or the heap.
+    //
+
+    uint64_t FreeMisses;
+
+    //
+    // Magazines exchanged with the depot.
+    //
+
+    uint64_t DepotTransfers;
+
+} CXPLAT_POOL_STATS;
+
 typedef struct CXPLAT_POOL {
 
     //
-    // List of free entries.
+    // List of free entries. Only used when per-processor caching isn't
+    // available or the processor's magazine is contended.
     //
 
     CXPLAT_SLIST_ENTRY ListHead;
@@ -458,8 +564,7 @@ typedef struct CXPLAT_POOL {
     uint16_t ListDepth;
 
     //
-    // Lock to synchronize access to the List.
-    // LINUX_TODO: Check how to make this lock free?
+    // Lock to synchronize access to the List and the depot.
     //
 
     CXPLAT_LOCK Lock;
@@ -476,6 +581,32 @@ typedef struct CXPLAT_POOL {
 
     uint32_t Tag;
 
+    //
+    // Per-processor magazine caches, aligned within CacheAllocation. NULL if
+    // caching is disabled.
+    //
+
+    CXPLAT_POOL_CACHE* Caches;
+    void* CacheAllocation;
+    uint32_t CacheCount;
+
+    //
+    // The depot of full and empty magazines.
+    //
+
+    CXPLAT_POOL_MAGAZINE* DepotFull;
+    CXPLAT_POOL_MAGAZINE* DepotEmpty;
+    uint32_t DepotFullCount;
+
+    //
+    // Statistics for operations not attributed to a per-processor cache.
+    // Protected by Lock.
+    //
+
+    uint64_t AllocMisses;
+    uint64_t FreeMisses;
+    uint64_t DepotTransfers;
+
 } CXPLAT_POOL;
 
 #ifndef DISABLE_CXPLAT_POOL
@@ -484,6 +615,12 @@ typedef struct CXPLAT_POOL {
 #define CXPLAT_POOL_MAXIMUM_DEPTH   0   // TODO - Optimize this scenario better
 #endif
 
+//
+// Maximum number of full magazines held in the depot.
+//
+#define CXPLAT_POOL_DEPOT_MAXIMUM_DEPTH \
+    (CXPLAT_POOL_MAXIMUM_DEPTH / CXPLAT_POOL_MAGAZINE_SIZE)
+
 #if DEBUG
 typedef struct CXPLAT_POOL_ENTRY {
     CXPLAT_SLIST_ENTRY ListHead;
@@ -496,6 +633,42 @@ CxPlatGetAllocFailDenominator(
     );
 #endif
 
+//
+// Slow path helpers for the per-processor magazine cache.
+//
+
+_Ret_maybenull_
+CXPLAT_POOL_MAGAZINE*
+CxPlatPoolCachePopulate(
+    _Inout_ CXPLAT_POOL* Pool,
+    _Inout_ CXPLAT_POOL_CACHE* Cache
+    );
+
+_Ret_notnull_
+CXPLAT_POOL_MAGAZINE*
+CxPlatPoolDepotExchangeEmpty(
+    _Inout_ CXPLAT_POOL* Pool,
+    _In_ CXPLAT_POOL_MAGAZINE* Empty
+    );
+
+_Ret_notnull_
+CXPLAT_POOL_MAGAZINE*
+CxPlatPoolDepotExchangeFull(
+    _Inout_ CXPLAT_POOL* Pool,
+    _In_ CXPLAT_POOL_MAGAZINE* Full
+    );
+
+void
+CxPlatPoolCacheUninitialize(
+    _Inout_ CXPLAT_POOL* Pool
+    );
+
+void
+CxPlatPoolGetStats(
+    _In_ CXPLAT_POOL* Pool,
+    _Out_ CXPLAT_POOL_STATS* Stats
+    );
+
 inline
 void
 CxPlatPoolInitialize(
@@ -513,6 +686,34 @@ CxPlatPoolInitialize(
     CxPlatLockInitialize(&Pool->Lock);
     Pool->ListDepth = 0;
     CxPlatZeroMemory(&Pool->ListHead, sizeof(Pool->ListHead));
+    Pool->DepotFull = NULL;
+    Pool->DepotEmpty = NULL;
+    Pool->DepotFullCount = 0;
+    Pool->AllocMisses = 0;
+    Pool->FreeMisses = 0;
+    Pool->DepotTransfers = 0;
+    Pool->CacheCount = CxPlatProcessorCount;
+    Pool->Caches = NULL;
+    Pool->CacheAllocation = NULL;
+    if (CXPLAT_POOL_DEPOT_MAXIMUM_DEPTH != 0 && Pool->CacheCount != 0) {
+        //
+        // If this allocation fails, the pool still works; it just always uses
+        // the shared list. CxPlatAlloc only guarantees malloc's alignment, so
+        // allocate enough extra to align the caches.
+        //
+        Pool->CacheAllocation =
+            CxPlatAlloc(
+                sizeof(CXPLAT_POOL_CACHE) * Pool->CacheCount +
+                    CXPLAT_POOL_CACHE_ALIGNMENT - 1,
+                QUIC_POOL_PLATFORM_POOL_CACHE);
+        if (Pool->CacheAllocation != NULL) {
+            Pool->Caches =
+                (CXPLAT_POOL_CACHE*)
+                    (((uintptr_t)Pool->CacheAllocation + CXPLAT_POOL_CACHE_ALIGNMENT - 1) &
+                     ~(uintptr_t)(CXPLAT_POOL_CACHE_ALIGNMENT - 1));
+            CxPlatZeroMemory(Pool->Caches, sizeof(CXPLAT_POOL_CACHE) * Pool->CacheCount);
+        }
+    }
     UNREFERENCED_PARAMETER(IsPaged);
 }
 
@@ -523,6 +724,9 @@ CxPlatPoolUninitialize(
     )
 {
     void* Entry;
+    if (Pool->Caches != NULL) {
+        CxPlatPoolCacheUninitialize(Pool);
+    }
     CxPlatLockAcquire(&Pool->Lock);
     while ((Entry = CxPlatListPopEntry(&Pool->ListHead)) != NULL) {
         CXPLAT_FRE_ASSERT(Pool->ListDepth > 0);
@@ -535,6 +739,55 @@ CxPlatPoolUninitialize(
     CxPlatLockUninitialize(&Pool->Lock);
 }
 
+//
+// Claims the current processor's magazine. Returns NULL if another thread
+// (preempted on this same processor) currently has it claimed.
+//
+inline
+CXPLAT_POOL_MAGAZINE*
+CxPlatPoolCacheAcquire(
+    _Inout_ CXPLAT_POOL* Pool,
+    _Inout_ CXPLAT_POOL_CACHE* Cache
+    )
+{
+    CXPLAT_POOL_MAGAZINE* Magazine =
+        (CXPLAT_POOL_MAGAZINE*)InterlockedFetchAndClearPointer(
+            (void* volatile*)&Cache->Magazine);
+    if (Magazine == NULL && !Cache->Populated) {
+        Magazine = CxPlatPoolCachePopulate(Pool, Cache);
+    }
+    return Magazine;
+}
+
+inline
+void
+CxPlatPoolCacheRelease(
+    _Inout_ CXPLAT_POOL_CACHE* Cache,
+    _In_ CXPLAT_POOL_MAGAZINE* Magazine
+    )
+{
+    InterlockedExchangePointer((void* volatile*)&Cache->Magazine, Magazine);
+}
+
+//
+// Allocates a new entry from the heap. Entries that are a whole number of cache
+// lines are also cache line aligned, so they span no more lines than needed.
+//
+inline
+void*
+CxPlatPoolAllocEntry(
+    _In_ const CXPLAT_POOL* Pool
+    )
+{
+    if (Pool->Size % CXPLAT_POOL_CACHE_ALIGNMENT == 0) {
+        void* Entry;
+        return
+            posix_memalign(&Entry, CXPLAT_POOL_CACHE_ALIGNMENT, Pool->Size) == 0 ?
+                Entry : NULL;
+    }
+    return CxPlatAlloc(Pool->Size, Pool->Tag);
+}
+
 inline
 void*
 CxPlatPoolAlloc(
@@ -546,16 +799,43 @@ CxPlatPoolAlloc(
         return CxPlatAlloc(Pool->Size, Pool->Tag);
     }
 #endif
+    void* Entry = NULL;
+    if (Pool->Caches != NULL) {
+        CXPLAT_POOL_CACHE* Cache = &Pool->Caches[CxPlatProcCurrentNumber() % Pool->CacheCount];
+        CXPLAT_POOL_MAGAZINE* Magazine = CxPlatPoolCacheAcquire(Pool, Cache);
+        if (Magazine != NULL) {
+            if (Magazine->Count == 0) {
+                Magazine = CxPlatPoolDepotExchangeEmpty(Pool, Magazine);
+            }
+            if (Magazine->Count != 0) {
+                Entry = Magazine->Entries[--Magazine->Count];
+                Cache->AllocHits++;
+            } else {
+                Cache->AllocMisses++;
+            }
+            CxPlatPoolCacheRelease(Cache, Magazine);
+            if (Entry == NULL) {
+                //
+                // Both the magazine and the depot are empty. The shared list
+                // is very likely empty too, so go straight to the heap.
+                //
+                Entry = CxPlatPoolAllocEntry(Pool);
+            }
+            goto Exit;
+        }
+    }
     CxPlatLockAcquire(&Pool->Lock);
-    void* Entry = CxPlatListPopEntry(&Pool->ListHead);
+    Entry = CxPlatListPopEntry(&Pool->ListHead);
     if (Entry != NULL) {
         CXPLAT_FRE_ASSERT(Pool->ListDepth > 0);
         Pool->ListDepth--;
     }
+    Pool->AllocMisses++;
     CxPlatLockRelease(&Pool->Lock);
     if (Entry == NULL) {
-        Entry = CxPlatAlloc(Pool->Size, Pool->Tag);
+        Entry = CxPlatPoolAllocEntry(Pool);
     }
+Exit:
 #if DEBUG
     if (Entry != NULL) {
         ((CXPLAT_POOL_ENTRY*)Entry)->SpecialFlag = 0;
@@ -579,13 +859,30 @@ CxPlatPoolFree(
     CXPLAT_DBG_ASSERT(((CXPLAT_POOL_ENTRY*)Entry)->SpecialFlag != CXPLAT_POOL_SPECIAL_FLAG);
     ((CXPLAT_POOL_ENTRY*)Entry)->SpecialFlag = CXPLAT_POOL_SPECIAL_FLAG;
 #endif
-    if (Pool->ListDepth >= CXPLAT_POOL_MAXIMUM_DEPTH) {
-        CxPlatFree(Entry, Pool->Tag);
-    } else {
-        CxPlatLockAcquire(&Pool->Lock);
+    if (Pool->Caches != NULL) {
+        CXPLAT_POOL_CACHE* Cache = &Pool->Caches[CxPlatProcCurrentNumber() % Pool->CacheCount];
+        CXPLAT_POOL_MAGAZINE* Magazine = CxPlatPoolCacheAcquire(Pool, Cache);
+        if (Magazine != NULL) {
+            if (Magazine->Count == CXPLAT_POOL_MAGAZINE_SIZE) {
+                Magazine = CxPlatPoolDepotExchangeFull(Pool, Magazine);
+            }
+            CXPLAT_DBG_ASSERT(Magazine->Count < CXPLAT_POOL_MAGAZINE_SIZE);
+            Magazine->Entries[Magazine->Count++] = Entry;
+            Cache->FreeHits++;
+            CxPlatPoolCacheRelease(Cache, Magazine);
+            return;
+        }
+    }
+    CxPlatLockAcquire(&Pool->Lock);
+    Pool->FreeMisses++;
+    if (Pool->ListDepth < CXPLAT_POOL_MAXIMUM_DEPTH) {
         CxPlatListPushEntry(&Pool->ListHead, (CXPLAT_SLIST_ENTRY*)Entry);
         Pool->ListDepth++;
-        CxPlatLockRelease(&Pool->Lock);
+        Entry = NULL;
+    }
+    CxPlatLockRelease(&Pool->Lock);
+    if (Entry != NULL) {
+        CxPlatFree(Entry, Pool->Tag);
     }
 }
 
@@ -600,6 +897,20 @@ CxPlatPoolPrune(
     if (Entry != NULL) {
         CXPLAT_FRE_ASSERT(Pool->ListDepth > 0);
         Pool->ListDepth--;
+    } else if (Pool->DepotFull != NULL) {
+        //
+        // The depot only holds full magazines, so trim it a whole magazine at
+        // a time.
+        //
+        CXPLAT_POOL_MAGAZINE* Magazine = Pool->DepotFull;
+        Pool->DepotFull = Magazine->Next;
+        Pool->DepotFullCount--;
+        CxPlatLockRelease(&Pool->Lock);
+        for (uint32_t i = 0; i < Magazine->Count; ++i) {
+            CxPlatFree(Magazine->Entries[i], Pool->Tag);
+        }
+        CxPlatFree(Magazine, QUIC_POOL_PLATFORM_POOL_CACHE);
+        return TRUE;
     }
     CxPlatLockRelease(&Pool->Lock);
     if (Entry == NULL) {
@@ -957,16 +1268,35 @@ Exit:
 #if CXPLAT_USE_IO_URING // liburing
 
 #include <liburing.h>
-typedef struct io_uring CXPLAT_EVENTQ;
+
+//
+// The io_uring submission queue is single producer, so all access to it is
+// serialized by a lock. Completions are only ever consumed by the worker
+// thread that owns the queue.
+//
+typedef struct CXPLAT_EVENTQ {
+    struct io_uring Ring;
+    CXPLAT_LOCK Lock;
+} CXPLAT_EVENTQ;
 typedef struct io_uring_cqe* CXPLAT_CQE;
 
+#define CXPLAT_EVENTQ_SQ_DEPTH  1024 // TODO - make size configurable
+#define CXPLAT_EVENTQ_CQ_DEPTH  (8 * CXPLAT_EVENTQ_SQ_DEPTH)
+
 inline
 BOOLEAN
 CxPlatEventQInitialize(
     _Out_ CXPLAT_EVENTQ* queue
     )
 {
-    return 0 == io_uring_queue_init(256, queue, 0); // TODO - make size configurable
+    struct io_uring_params params = {0};
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = CXPLAT_EVENTQ_CQ_DEPTH;
+    if (io_uring_queue_init_params(CXPLAT_EVENTQ_SQ_DEPTH, &queue->Ring, &params) != 0) {
+        return FALSE;
+    }
+    CxPlatLockInitialize(&queue->Lock);
+    return TRUE;
 }
 
 inline
@@ -975,7 +1305,26 @@ CxPlatEventQCleanup(
     _In_ CXPLAT_EVENTQ* queue
     )
 {
-    io_uring_queue_exit(queue);
+    io_uring_queue_exit(&queue->Ring);
+    CxPlatLockUninitialize(&queue->Lock);
+}
+
+//
+// Returns a free SQE, flushing the submission queue to the kernel if it is
+// full. Must be called with the queue lock held.
+//
+inline
+struct io_uring_sqe*
+CxPlatEventQGetSqe(
+    _In_ CXPLAT_EVENTQ* queue
+    )
+{
+    struct io_uring_sqe *io_sqe = io_uring_get_sqe(&queue->Ring);
+    if (io_sqe == NULL) {
+        io_uring_submit(&queue->Ring);
+        io_sqe = io_uring_get_sqe(&queue->Ring);
+    }
+    return io_sqe;
 }
 
 inline
@@ -985,16 +1334,38 @@ _CxPlatEventQEnqueue(
     _In_opt_ void* user_data
     )
 {
-    struct io_uring_sqe *io_sqe = io_uring_get_sqe(queue);
-    if (io_sqe == NULL) return FALSE; // OOM
+    CxPlatLockAcquire(&queue->Lock);
+    struct io_uring_sqe *io_sqe = CxPlatEventQGetSqe(queue);
+    if (io_sqe == NULL) {
+        CxPlatLockRelease(&queue->Lock);
+        return FALSE; // OOM
+    }
     io_uring_prep_nop(io_sqe);
     io_uring_sqe_set_data(io_sqe, user_data);
-    io_uring_submit(queue); // TODO - Extract to separate function?
+    io_uring_submit(&queue->Ring);
+    CxPlatLockRelease(&queue->Lock);
     return TRUE;
 }
 
 #define CxPlatEventQEnqueue(queue, sqe, user_data) _CxPlatEventQEnqueue(queue, user_data)
 
+//
+// Submits any SQEs that were prepared, but not yet submitted, by the worker
+// thread while it processed the last batch of completions.
+//
+inline
+void
+CxPlatEventQSubmitPending(
+    _In_ CXPLAT_EVENTQ* queue
+    )
+{
+    if (io_uring_sq_ready(&queue->Ring) != 0) {
+        CxPlatLockAcquire(&queue->Lock);
+        io_uring_submit(&queue->Ring);
+        CxPlatLockRelease(&queue->Lock);
+    }
+}
+
 inline
 uint32_t
 CxPlatEventQDequeue(
@@ -1004,17 +1375,18 @@ CxPlatEventQDequeue(
     _In_ uint32_t wait_time // milliseconds
     )
 {
-    int result = io_uring_peek_batch_cqe(queue, events, count);
+    CxPlatEventQSubmitPending(queue);
+    int result = io_uring_peek_batch_cqe(&queue->Ring, events, count);
     if (result > 0 || wait_time == 0) return result;
     if (wait_time != UINT32_MAX) {
         struct __kernel_timespec timeout;
         timeout.tv_sec = (wait_time / 1000);
         timeout.tv_nsec = ((wait_time % 1000) * 1000000);
-        (void)io_uring_wait_cqe_timeout(queue, events, &timeout);
+        (void)io_uring_wait_cqe_timeout(&queue->Ring, events, &timeout);
     } else {
-        (void)io_uring_wait_cqe(queue, events);
+        (void)io_uring_wait_cqe(&queue->Ring, events);
     }
-    return io_uring_peek_batch_cqe(queue, events, count);
+    return io_uring_peek_batch_cqe(&queue->Ring, events, count);
 }
 
 inline
@@ -1024,7 +1396,7 @@ CxPlatEventQReturn(
     _In_ uint32_t count
     )
 {
-    io_uring_cq_advance(queue, count);
+    io_uring_cq_advance(&queue->Ring, count);
 }
 
 inline
@@ -1033,7 +1405,7 @@ CxPlatCqeUserData(
     _In_ const CXPLAT_CQE* cqe
     )
 {
-    return (void*)(uintptr_t)cqe->user_data;
+    return (void*)(uintptr_t)(*cqe)->user_data;
 }
 
 #else // epoll
@@ -352,6 +352,7 @@ typedef struct CXPLAT_DISPATCH_RW_LOCK {
 #define QuicReadLongPtrNoFence ReadNoFence
 #endif
 #define QuicReadPtrNoFence ReadPointerNoFence
+#define QuicReadPtrAcquire ReadPointerAcquire
 
 typedef LONG_PTR CXPLAT_REF_COUNT;
 
@@ -618,7 +619,23 @@ CxPlatTimeUs64ToPlat(
         ((Low + ((High % 1000000) << 32)) / 1000000);
 }
 
+#ifdef DEBUG
+uint64_t
+CxPlatGetTimeOverride(
+    );
+
+inline
+uint64_t
+CxPlatTimeUs64(
+    void
+    )
+{
+    const uint64_t TimeOverride = CxPlatGetTimeOverride();
+    return TimeOverride != 0 ? TimeOverride : QuicTimePlatToUs64(QuicTimePlat());
+}
+#else
 #define CxPlatTimeUs64() QuicTimePlatToUs64(QuicTimePlat())
+#endif
 #define CxPlatTimeUs32() (uint32_t)CxPlatTimeUs64()
 #define CxPlatTimeMs64() US_TO_MS(CxPlatTimeUs64())
 #define CxPlatTimeMs32() (uint32_t)CxPlatTimeMs64()
@@ -566,8 +566,10 @@ typedef SRWLOCK CXPLAT_DISPATCH_RW_LOCK;
 
 #ifdef QUIC_RESTRICTED_BUILD
 #define QuicReadPtrNoFence(p) ((void*)(*p))
+#define QuicReadPtrAcquire(p) ((void*)(*(void* volatile*)(p)))
 #else
 #define QuicReadPtrNoFence ReadPointerNoFence
+#define QuicReadPtrAcquire ReadPointerAcquire
 #endif
 
 typedef LONG_PTR CXPLAT_REF_COUNT;
@@ -913,7 +915,23 @@ CxPlatTimeUs64ToPlat(
         ((Low + ((High % 1000000) << 32)) / CxPlatPerfFreq);
 }
 
+#ifdef DEBUG
+uint64_t
+CxPlatGetTimeOverride(
+    );
+
+inline
+uint64_t
+CxPlatTimeUs64(
+    void
+    )
+{
+    const uint64_t TimeOverride = CxPlatGetTimeOverride();
+    return TimeOverride != 0 ? TimeOverride : QuicTimePlatToUs64(QuicTimePlat());
+}
+#else
 #define CxPlatTimeUs64() QuicTimePlatToUs64(QuicTimePlat())
+#endif
 #define CxPlatTimeUs32() (uint32_t)CxPlatTimeUs64()
 #define CxPlatTimeMs64() US_TO_MS(CxPlatTimeUs64())
 #define CxPlatTimeMs32() (uint32_t)CxPlatTimeMs64()
@@ -115,6 +115,10 @@
 #define _Field_size_(...)
 #endif
 
+#ifndef _Field_size_opt_
+#define _Field_size_opt_(...)
+#endif
+
 #ifndef _Success_
 #define _Success_(...)
 #endif
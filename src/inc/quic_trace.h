@@ -103,6 +103,9 @@ typedef enum QUIC_TRACE_API_TYPE {
     QUIC_TRACE_API_DATAGRAM_SEND,
     QUIC_TRACE_API_CONNECTION_COMPLETE_RESUMPTION_TICKET_VALIDATION,
     QUIC_TRACE_API_CONNECTION_COMPLETE_CERTIFICATE_VALIDATION,
+    QUIC_TRACE_API_STREAM_PROVIDE_RECEIVE_BUFFERS,
+    QUIC_TRACE_API_CONNECTION_POOL_CREATE,
+    QUIC_TRACE_API_CONNECTION_SEND_BATCH,
     QUIC_TRACE_API_COUNT // Must be last
 } QUIC_TRACE_API_TYPE;
 
@@ -225,12 +225,14 @@ pub const SEND_RESUMPTION_FLAG_FINAL: SendResumptionFlags = 1;
 pub type StreamSchedulingScheme = u32;
 pub const STREAM_SCHEDULING_SCHEME_FIFO: StreamSchedulingScheme = 0;
 pub const STREAM_SCHEDULING_SCHEME_ROUND_ROBIN: StreamSchedulingScheme = 1;
-pub const STREAM_SCHEDULING_SCHEME_COUNT: StreamSchedulingScheme = 2;
+pub const STREAM_SCHEDULING_SCHEME_EXTENSIBLE_PRIORITY: StreamSchedulingScheme = 2;
+pub const STREAM_SCHEDULING_SCHEME_COUNT: StreamSchedulingScheme = 3;
 
 pub type StreamOpenFlags = u32;
 pub const STREAM_OPEN_FLAG_NONE: StreamOpenFlags = 0;
 pub const STREAM_OPEN_FLAG_UNIDIRECTIONAL: StreamOpenFlags = 1;
 pub const STREAM_OPEN_FLAG_0_RTT: StreamOpenFlags = 2;
+pub const STREAM_OPEN_FLAG_APP_OWNED_BUFFERS: StreamOpenFlags = 8;
 
 pub type StreamStartFlags = u32;
 pub const STREAM_START_FLAG_NONE: StreamStartFlags = 0;
@@ -715,6 +717,7 @@ pub struct SchannelCredentialAttributeW {
     pub buffer: *mut c_void,
 }
 pub const PARAM_CONFIGURATION_SCHANNEL_CREDENTIAL_ATTRIBUTE_W: u32 = 0x03000003;
+pub const PARAM_CONFIGURATION_CONGESTION_CONTROL: u32 = 0x03000004;
 
 pub const PARAM_LISTENER_LOCAL_ADDRESS: u32 = 0x04000000;
 pub const PARAM_LISTENER_STATS: u32 = 0x04000001;
@@ -901,6 +904,39 @@ pub struct ConnectionEvent {
 pub type ConnectionEventHandler =
     extern "C" fn(connection: Handle, context: *mut c_void, event: &ConnectionEvent) -> u32;
 
+pub type ConnectionPoolFlags = u32;
+pub const CONNECTION_POOL_FLAG_NONE: ConnectionPoolFlags = 0;
+pub const CONNECTION_POOL_FLAG_CLOSE_ON_FAILURE: ConnectionPoolFlags = 1;
+
+/// Specifies the configuration for a new pool of connections.
+#[repr(C)]
+#[derive(Copy, Clone)]
+pub struct ConnectionPoolConfig {
+    pub registration: Handle,
+    pub configuration: Handle,
+    pub handler: ConnectionEventHandler,
+    pub context: *const *const c_void,
+    pub server_name: *const i8,
+    pub server_address: *const Addr,
+    pub family: AddressFamily,
+    pub server_port: u16,
+    pub number_of_connections: u16,
+    pub flags: ConnectionPoolFlags,
+}
+
+/// A single send of a batch queued on a connection. A null stream sends a
+/// datagram.
+#[repr(C)]
+#[derive(Copy, Clone)]
+pub struct SendBatchEntry {
+    pub stream: Handle,
+    pub buffers: *const Buffer,
+    pub buffer_count: u32,
+    pub flags: SendFlags,
+    pub client_send_context: *const c_void,
+    pub status: u32,
+}
+
 pub type StreamEventType = u32;
 pub const STREAM_EVENT_START_COMPLETE: StreamEventType = 0;
 pub const STREAM_EVENT_RECEIVE: StreamEventType = 1;
@@ -912,6 +948,7 @@ pub const STREAM_EVENT_SEND_SHUTDOWN_COMPLETE: StreamEventType = 6;
 pub const STREAM_EVENT_SHUTDOWN_COMPLETE: StreamEventType = 7;
 pub const STREAM_EVENT_IDEAL_SEND_BUFFER_SIZE: StreamEventType = 8;
 pub const STREAM_EVENT_PEER_ACCEPTED: StreamEventType = 9;
+pub const STREAM_EVENT_RECEIVE_BUFFER_NEEDED: StreamEventType = 11;
 
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
@@ -979,6 +1016,12 @@ pub struct StreamEventIdealSendBufferSize {
     pub byte_count: u64,
 }
 
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct StreamEventReceiveBufferNeeded {
+    pub buffer_length_needed: u64,
+}
+
 #[repr(C)]
 #[derive(Copy, Clone)]
 pub union StreamEventPayload {
@@ -990,6 +1033,7 @@ pub union StreamEventPayload {
     pub send_shutdown_complete: StreamEventSendShutdownComplete,
     pub shutdown_complete: StreamEventShutdownComplete,
     pub ideal_send_buffer_size: StreamEventIdealSendBufferSize,
+    pub receive_buffer_needed: StreamEventReceiveBufferNeeded,
 }
 
 #[repr(C)]
@@ -1104,6 +1148,20 @@ struct ApiTable {
         result: BOOLEAN,
         tls_alert: TlsAlertCode
     ) -> u32,
+    stream_provide_receive_buffers: extern "C" fn(
+        stream: Handle,
+        buffer_count: u32,
+        buffers: *const Buffer,
+    ) -> u32,
+    connection_pool_create: extern "C" fn(
+        config: *const ConnectionPoolConfig,
+        connection_pool: *mut Handle,
+    ) -> u32,
+    connection_send_batch: extern "C" fn(
+        connection: Handle,
+        entries: *mut SendBatchEntry,
+        entry_count: u32,
+    ) -> u32,
 }
 
 #[link(name = "msquic")]
@@ -1702,6 +1760,19 @@ impl Stream {
         }
     }
 
+    pub fn provide_receive_buffers(&self, buffers: &[Buffer]) {
+        let status = unsafe {
+            ((*self.table).stream_provide_receive_buffers)(
+                self.handle,
+                buffers.len() as u32,
+                buffers.as_ptr(),
+            )
+        };
+        if Status::failed(status) {
+            panic!("StreamProvideReceiveBuffers failure 0x{:x}", status);
+        }
+    }
+
     pub fn set_callback_handler(&self, handler: StreamEventHandler, context: *const c_void) {
         unsafe {
             ((*self.table).set_callback_handler)(self.handle, handler as *const c_void, context)
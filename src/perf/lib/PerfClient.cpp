@@ -153,6 +153,7 @@ PerfClient::Init(
     TryGetValue(argc, argv, "encrypt", &UseEncryption);
     TryGetValue(argc, argv, "pacing", &UsePacing);
     TryGetValue(argc, argv, "sendbuf", &UseSendBuffering);
+    TryGetValue(argc, argv, "batch", &BatchSends);
     TryGetValue(argc, argv, "ptput", &PrintThroughput);
     TryGetValue(argc, argv, "prate", &PrintIoRate);
     TryGetValue(argc, argv, "pconnection", &PrintConnections);
@@ -207,6 +208,10 @@ PerfClient::Init(
             WriteOutput("TCP mode doesn't support CIBIR!\n");
             return QUIC_STATUS_INVALID_PARAMETER;
         }
+        if (BatchSends) {
+            WriteOutput("TCP mode doesn't support send batching!\n");
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
     }
 
     if ((Upload || Download) && !StreamCount) {
@@ -509,6 +514,15 @@ PerfClientConnection::Initialize() {
             return;
         }
 
+        if (Client.BatchSends && Client.StreamCount) {
+            SendBatch.reset(new(std::nothrow) QUIC_SEND_BATCH_ENTRY[Client.StreamCount]);
+            if (!SendBatch) {
+                MsQuic->ConnectionClose(Handle);
+                Worker.ConnectionPool.Free(this);
+                return;
+            }
+        }
+
         QUIC_STATUS Status;
         BOOLEAN Value;
         if (!Client.UseEncryption) {
@@ -618,9 +632,7 @@ PerfClientConnection::OnHandshakeComplete() {
         WorkerConnComplete = true;
         Worker.OnConnectionComplete();
     } else {
-        for (uint32_t i = 0; i < Client.StreamCount; ++i) {
-            StartNewStream();
-        }
+        StartNewStreams(Client.StreamCount);
     }
 }
 
@@ -672,6 +684,45 @@ PerfClientConnection::StartNewStream() {
     Stream->Send();
 }
 
+void
+PerfClientConnection::StartNewStreams(uint32_t Count) {
+    //
+    // With 'batch', the initial sends of all the new streams are queued with a
+    // single ConnectionSendBatch call instead of one StreamSend per stream.
+    //
+    SendBatchActive = SendBatch;
+    for (uint32_t i = 0; i < Count; ++i) {
+        StartNewStream();
+    }
+    FlushSendBatch();
+    SendBatchActive = false;
+}
+
+void
+PerfClientConnection::QueueSend(
+    _In_ HQUIC Stream,
+    _In_ QUIC_BUFFER* Buffer,
+    QUIC_SEND_FLAGS Flags
+    ) {
+    if (SendBatchCount == Client.StreamCount) {
+        FlushSendBatch();
+    }
+    auto& Entry = SendBatch[SendBatchCount++];
+    Entry.Stream = Stream;
+    Entry.Buffers = Buffer;
+    Entry.BufferCount = 1;
+    Entry.Flags = Flags;
+    Entry.ClientSendContext = Buffer;
+}
+
+void
+PerfClientConnection::FlushSendBatch() {
+    if (SendBatchCount) {
+        MsQuic->ConnectionSendBatch(Handle, SendBatch.get(), SendBatchCount);
+        SendBatchCount = 0;
+    }
+}
+
 PerfClientStream::PerfClientStream(_In_ PerfClientConnection& Connection)
     : Connection{Connection} {
     if (Connection.Client.UseSendBuffering) {
@@ -692,8 +743,8 @@ PerfClientConnection::OnStreamShutdown() {
             Shutdown();
         }
     } else if (Client.RepeatStreams) {
-        while (StreamsActive < Client.StreamCount) {
-            StartNewStream();
+        if (StreamsActive < Client.StreamCount) {
+            StartNewStreams(Client.StreamCount - (uint32_t)StreamsActive);
         }
     } else {
         if (!StreamsActive && StreamsCreated == Client.StreamCount) {
@@ -867,6 +918,8 @@ PerfClientStream::Send() {
             SendData->Length = DataLength;
             SendData->Fin = (Flags & QUIC_SEND_FLAG_FIN) ? TRUE : FALSE;
             Connection.TcpConn->Send(SendData);
+        } else if (Connection.SendBatchActive) {
+            Connection.QueueSend(Handle, Buffer, Flags);
         } else {
             MsQuic->StreamSend(Handle, Buffer, 1, Flags, Buffer);
         }
@@ -25,10 +25,16 @@ struct PerfClientConnection {
     uint64_t StreamsCreated {0};
     uint64_t StreamsActive {0};
     bool WorkerConnComplete {false}; // Indicated completion to worker
+    UniquePtr<QUIC_SEND_BATCH_ENTRY[]> SendBatch; // Only used with 'batch'
+    uint32_t SendBatchCount {0};
+    bool SendBatchActive {false}; // Sends are being collected into SendBatch
     PerfClientConnection(_In_ PerfClient& Client, _In_ PerfClientWorker& Worker) : Client(Client), Worker(Worker) { }
     ~PerfClientConnection();
     void Initialize();
     void StartNewStream();
+    void StartNewStreams(uint32_t Count);
+    void QueueSend(_In_ HQUIC Stream, _In_ QUIC_BUFFER* Buffer, QUIC_SEND_FLAGS Flags);
+    void FlushSendBatch();
     void OnHandshakeComplete();
     void OnShutdownComplete();
     void OnStreamShutdown();
@@ -189,6 +195,7 @@ struct PerfClient {
     uint8_t UseEncryption {TRUE};
     uint8_t UsePacing {TRUE};
     uint8_t UseSendBuffering {FALSE};
+    uint8_t BatchSends {FALSE};
     uint8_t PrintThroughput {FALSE};
     uint8_t PrintIoRate {FALSE};
     uint8_t PrintConnections {FALSE};
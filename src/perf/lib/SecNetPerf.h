@@ -174,6 +174,10 @@ QuicPrintConnectionStatistics(
         "  SendSpuriousLostPackets   %llu\n"
         "  SendCongestionCount       %u\n"
         "  SendEcnCongestionCount    %u\n"
+        "  SendMetadataBytesPerPacket %u\n"
+        "  SendEctPackets            %llu\n"
+        "  SendEcnCePackets          %llu\n"
+        "  SendEcnCeRatio            %u ppm\n"
         "  RecvTotalPackets          %llu\n"
         "  RecvReorderedPackets      %llu\n"
         "  RecvDroppedPackets        %llu\n"
@@ -187,6 +191,10 @@ QuicPrintConnectionStatistics(
         (unsigned long long)Stats.SendSpuriousLostPackets,
         Stats.SendCongestionCount,
         Stats.SendEcnCongestionCount,
+        Stats.SendMetadataBytesPerPacket,
+        (unsigned long long)Stats.SendEctPackets,
+        (unsigned long long)Stats.SendEcnCePackets,
+        Stats.SendEcnCeRatio,
         (unsigned long long)Stats.RecvTotalPackets,
         (unsigned long long)Stats.RecvReorderedPackets,
         (unsigned long long)Stats.RecvDroppedPackets,
@@ -71,6 +71,7 @@ PrintHelp(
         "  -encrypt:<0/1>           Disables/enables encryption. (def:1)\n"
         "  -pacing:<0/1>            Disables/enables send pacing. (def:1)\n"
         "  -sendbuf:<0/1>           Disables/enables send buffering. (def:0)\n"
+        "  -batch:<0/1>             Queues the sends of new streams with a single batched send call. (def:0)\n"
         "  -ptput:<0/1>             Print throughput information. (def:0)\n"
         "  -pconn:<0/1>             Print connection statistics. (def:0)\n"
         "  -pstream:<0/1>           Print stream statistics. (def:0)\n"
@@ -91,7 +92,7 @@ PrintHelp(
         "  -exec:<profile>          Execution profile to use.\n"
         "                            - {lowlat, maxtput, scavenger, realtime}.\n"
         "  -cc:<algo>               Congestion control algorithm to use.\n"
-        "                            - {cubic, bbr}.\n"
+        "                            - {cubic, bbr, bbr3, prague, ledbat}.\n"
         "  -pollidle:<time_us>      Amount of time to poll while idle before sleeping (default: 0).\n"
         "  -ecn:<0/1>               Enables/disables sender-side ECN support. (def:0)\n"
         "  -qeo:<0/1>               Allows/disallowes QUIC encryption offload. (def:0)\n"
@@ -101,6 +102,7 @@ PrintHelp(
         "  -cpu:<cpu_index>         Specify the processor(s) to use.\n"
         "  -cipher:<value>          Decimal value of 1 or more QUIC_ALLOWED_CIPHER_SUITE_FLAGS.\n"
         "  -highpri:<0/1>           Configures MsQuic to run threads at high priority. (def:0)\n"
+        "  -zerocopy:<0/1>          Configures MsQuic to use zero-copy sends where supported. (def:0)\n"
 #endif // _KERNEL_MODE
         "\n",
         PERF_DEFAULT_PORT,
@@ -181,6 +183,13 @@ QuicMainStart(
         Config->Flags |= QUIC_EXECUTION_CONFIG_FLAG_HIGH_PRIORITY;
         SetConfig = true;
     }
+
+    uint8_t ZeroCopySend = false;
+    TryGetValue(argc, argv, "zerocopy", &ZeroCopySend);
+    if (ZeroCopySend) {
+        Config->Flags |= QUIC_EXECUTION_CONFIG_FLAG_ZERO_COPY_SEND;
+        SetConfig = true;
+    }
 #endif // _KERNEL_MODE
 
     if (TryGetValue(argc, argv, "pollidle", &Config->PollingIdleTimeoutUs)) {
@@ -222,6 +231,12 @@ QuicMainStart(
             PerfDefaultCongestionControl = QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC;
         } else if (IsValue(CcName, "bbr")) {
             PerfDefaultCongestionControl = QUIC_CONGESTION_CONTROL_ALGORITHM_BBR;
+        } else if (IsValue(CcName, "bbr3")) {
+            PerfDefaultCongestionControl = QUIC_CONGESTION_CONTROL_ALGORITHM_BBR3;
+        } else if (IsValue(CcName, "prague")) {
+            PerfDefaultCongestionControl = QUIC_CONGESTION_CONTROL_ALGORITHM_PRAGUE;
+        } else if (IsValue(CcName, "ledbat")) {
+            PerfDefaultCongestionControl = QUIC_CONGESTION_CONTROL_ALGORITHM_LEDBAT;
         } else {
             WriteOutput("Failed to parse congestion control algorithm[%s], use cubic as default\n", CcName);
         }
@@ -15,6 +15,7 @@ Environment:
 
 #include "platform_internal.h"
 #include <fcntl.h>
+#include <linux/errqueue.h>
 #include <linux/filter.h>
 #include <linux/in6.h>
 #include <netinet/udp.h>
@@ -44,6 +45,12 @@ CXPLAT_STATIC_ASSERT((SIZEOF_STRUCT_MEMBER(QUIC_BUFFER, Buffer) == sizeof(void*)
 const uint16_t CXPLAT_MAX_IO_BATCH_SIZE =
     (CXPLAT_LARGE_IO_BUFFER_SIZE / (1280 - CXPLAT_MIN_IPV6_HEADER_SIZE - CXPLAT_UDP_HEADER_SIZE));
 
+//
+// The minimum send size for which MSG_ZEROCOPY is used. Below this, the cost
+// of pinning the pages and reaping the completion outweighs the copy.
+//
+#define CXPLAT_SEND_ZERO_COPY_THRESHOLD     16384
+
 //
 // Contains all the info for a single RX IO operation. Multiple RX packets may
 // come from a single IO operation.
@@ -106,6 +113,16 @@ typedef struct CXPLAT_SEND_DATA {
     //
     CXPLAT_LIST_ENTRY TxEntry;
 
+    //
+    // Entry in the socket's list of MSG_ZEROCOPY sends pending completion.
+    //
+    CXPLAT_LIST_ENTRY ZeroCopyEntry;
+
+    //
+    // The MSG_ZEROCOPY completion sequence number of the send.
+    //
+    uint32_t ZeroCopySequence;
+
     //
     // The local address to bind to.
     //
@@ -163,6 +180,15 @@ typedef struct CXPLAT_SEND_DATA {
     //
     uint8_t SegmentationSupported : 1;
 
+    //
+    // Indicates the send was done with MSG_ZEROCOPY, so the buffer may only be
+    // freed once both the sender is done with it and the kernel has completed
+    // it. The latter two are protected by the socket's ZeroCopyLock.
+    //
+    uint8_t ZeroCopyPending : 1;
+    uint8_t ZeroCopySendDone : 1;
+    uint8_t ZeroCopyCompleted : 1;
+
     //
     // Space for ancillary control data.
     //
@@ -427,6 +453,17 @@ DataPathInitialize(
     CxPlatRefInitializeEx(&Datapath->RefCount, Datapath->PartitionCount);
     CxPlatDataPathCalculateFeatureSupport(Datapath, ClientRecvDataLength);
 
+#ifdef SO_ZEROCOPY
+    //
+    // Zero-copy only pays off for large sends, so it's only used along with
+    // segmentation.
+    //
+    if (Config && Config->Flags & QUIC_EXECUTION_CONFIG_FLAG_ZERO_COPY_SEND &&
+        Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION) {
+        Datapath->SendZeroCopySupported = TRUE;
+    }
+#endif
+
     //
     // Initialize the per processor contexts.
     //
@@ -520,6 +557,20 @@ DataPathIsPaddingPreferred(
     return !!(Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION);
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+DataPathGetStatistics(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _Out_ CXPLAT_DATAPATH_STATISTICS* Statistics
+    )
+{
+    CxPlatZeroMemory(Statistics, sizeof(*Statistics));
+    for (uint32_t i = 0; i < Datapath->PartitionCount; i++) {
+        Statistics->SendZeroCopyCount += Datapath->Partitions[i].SendZeroCopyCount;
+        Statistics->SendZeroCopyCopiedCount += Datapath->Partitions[i].SendZeroCopyCopiedCount;
+    }
+}
+
 QUIC_STATUS
 CxPlatSocketConfigureRss(
     _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
@@ -898,6 +949,32 @@ CxPlatSocketContextInitialize(
             goto Exit;
         }
 
+#ifdef SO_ZEROCOPY
+        if (Datapath->SendZeroCopySupported) {
+            Option = TRUE;
+            Result =
+                setsockopt(
+                    SocketContext->SocketFd,
+                    SOL_SOCKET,
+                    SO_ZEROCOPY,
+                    (const void*)&Option,
+                    sizeof(Option));
+            if (Result == SOCKET_ERROR) {
+                //
+                // Not fatal. Sends on this socket just copy the data.
+                //
+                QuicTraceEvent(
+                    DatapathErrorStatus,
+                    "[data][%p] ERROR, %u, %s.",
+                    Binding,
+                    errno,
+                    "setsockopt(SO_ZEROCOPY) failed");
+            } else {
+                SocketContext->ZeroCopyEnabled = TRUE;
+            }
+        }
+#endif
+
         //
         // Only set SO_REUSEPORT on a server socket, otherwise the client could be
         // assigned a server port (unless it's forcing sharing).
@@ -1094,6 +1171,19 @@ CxPlatSocketContextUninitializeComplete(
         CxPlatSqeCleanup(SocketContext->DatapathPartition->EventQ, &SocketContext->FlushTxSqe.Sqe);
     }
 
+    //
+    // Any MSG_ZEROCOPY sends the kernel hasn't completed yet are dropped with
+    // the socket.
+    //
+    while (!CxPlatListIsEmpty(&SocketContext->ZeroCopyQueue)) {
+        CxPlatSendDataFree(
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&SocketContext->ZeroCopyQueue),
+                CXPLAT_SEND_DATA,
+                ZeroCopyEntry));
+    }
+
+    CxPlatLockUninitialize(&SocketContext->ZeroCopyLock);
     CxPlatLockUninitialize(&SocketContext->TxQueueLock);
     CxPlatRundownUninitialize(&SocketContext->UpcallRundown);
 
@@ -1238,6 +1328,8 @@ SocketCreateUdp(
         Binding->SocketContexts[i].SocketFd = INVALID_SOCKET;
         CxPlatListInitializeHead(&Binding->SocketContexts[i].TxQueue);
         CxPlatLockInitialize(&Binding->SocketContexts[i].TxQueueLock);
+        CxPlatListInitializeHead(&Binding->SocketContexts[i].ZeroCopyQueue);
+        CxPlatLockInitialize(&Binding->SocketContexts[i].ZeroCopyLock);
         CxPlatRundownInitialize(&Binding->SocketContexts[i].UpcallRundown);
     }
 
@@ -1356,6 +1448,8 @@ CxPlatSocketCreateTcpInternal(
     SocketContext->SocketFd = INVALID_SOCKET;
     CxPlatListInitializeHead(&SocketContext->TxQueue);
     CxPlatLockInitialize(&SocketContext->TxQueueLock);
+    CxPlatListInitializeHead(&SocketContext->ZeroCopyQueue);
+    CxPlatLockInitialize(&SocketContext->ZeroCopyLock);
     CxPlatRundownInitialize(&SocketContext->UpcallRundown);
 
     CXPLAT_UDP_CONFIG Config = {
@@ -1484,6 +1578,8 @@ SocketCreateTcpListener(
     SocketContext->SocketFd = INVALID_SOCKET;
     CxPlatListInitializeHead(&SocketContext->TxQueue);
     CxPlatLockInitialize(&SocketContext->TxQueueLock);
+    CxPlatListInitializeHead(&SocketContext->ZeroCopyQueue);
+    CxPlatLockInitialize(&SocketContext->ZeroCopyLock);
     CxPlatRundownInitialize(&SocketContext->UpcallRundown);
 
     CXPLAT_UDP_CONFIG Config = {
@@ -1700,7 +1796,7 @@ CxPlatSocketHandleErrors(
             SocketContext->Binding,
             errno,
             "getsockopt(SO_ERROR) failed");
-    } else {
+    } else if (ErrNum != 0) {
         QuicTraceEvent(
             DatapathErrorStatus,
             "[data][%p] ERROR, %u, %s.",
@@ -2187,6 +2283,9 @@ SendDataAlloc(
         SendData->OnConnectedSocket = Socket->Connected;
         SendData->SegmentationSupported =
             !!(Socket->Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION);
+        SendData->ZeroCopyPending = FALSE;
+        SendData->ZeroCopySendDone = FALSE;
+        SendData->ZeroCopyCompleted = FALSE;
         SendData->Iovs[0].iov_len = 0;
         SendData->Iovs[0].iov_base = SendData->Buffer;
         SendData->DatapathType = Config->Route->DatapathType = CXPLAT_DATAPATH_TYPE_USER;
@@ -2296,6 +2395,11 @@ CxPlatSendDataSend(
     _In_ CXPLAT_SEND_DATA* SendData
     );
 
+void
+CxPlatSendDataRelease(
+    _In_ CXPLAT_SEND_DATA* SendData
+    );
+
 void
 SocketSend(
     _In_ CXPLAT_SOCKET* Socket,
@@ -2370,7 +2474,7 @@ SocketSend(
                 Status,
                 SendData->TotalSize);
         }
-        CxPlatSendDataFree(SendData);
+        CxPlatSendDataRelease(SendData);
     }
 }
 
@@ -2437,6 +2541,168 @@ CxPlatSendDataPopulateAncillaryData(
     SendData->ControlBufferLength = (uint8_t)Mhdr->msg_controllen;
 }
 
+#ifdef SO_ZEROCOPY
+//
+// Sends the data with MSG_ZEROCOPY. On success, the kernel holds references to
+// the send buffer until the completion is reaped from the error queue, so the
+// send data is tracked in the socket's ZeroCopyQueue until then. Returns 0 on
+// success, or the errno of the failure.
+//
+int
+CxPlatSendDataSendZeroCopy(
+    _In_ CXPLAT_SEND_DATA* SendData,
+    _In_ struct msghdr* Mhdr
+    )
+{
+    CXPLAT_SOCKET_CONTEXT* SocketContext = SendData->SocketContext;
+    int Error = 0;
+
+    //
+    // The kernel assigns completion sequence numbers in the order of the
+    // successful sends, so the sendmsg and the assignment must be atomic.
+    //
+    CxPlatLockAcquire(&SocketContext->ZeroCopyLock);
+    if (sendmsg(SocketContext->SocketFd, Mhdr, MSG_ZEROCOPY) < 0) {
+        Error = errno;
+    } else {
+        SendData->ZeroCopyPending = TRUE;
+        SendData->ZeroCopySequence = SocketContext->ZeroCopyNextSequence++;
+        CxPlatListInsertTail(&SocketContext->ZeroCopyQueue, &SendData->ZeroCopyEntry);
+    }
+    CxPlatLockRelease(&SocketContext->ZeroCopyLock);
+
+    if (Error == 0) {
+        InterlockedIncrement64(
+            (int64_t*)&SocketContext->DatapathPartition->SendZeroCopyCount);
+    }
+
+    return Error;
+}
+
+//
+// Reaps the MSG_ZEROCOPY completions off the socket's error queue, freeing any
+// send data that the sender was already done with.
+//
+void
+CxPlatSocketContextReapZeroCopy(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
+    )
+{
+    uint8_t ControlBuffer[CMSG_SPACE(sizeof(struct sock_extended_err) + sizeof(struct sockaddr_in6))];
+
+    while (TRUE) {
+        struct msghdr Mhdr = {0};
+        Mhdr.msg_control = ControlBuffer;
+        Mhdr.msg_controllen = sizeof(ControlBuffer);
+        if (recvmsg(SocketContext->SocketFd, &Mhdr, MSG_ERRQUEUE) < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                QuicTraceEvent(
+                    DatapathErrorStatus,
+                    "[data][%p] ERROR, %u, %s.",
+                    SocketContext->Binding,
+                    errno,
+                    "recvmsg(MSG_ERRQUEUE) failed");
+            }
+            break;
+        }
+
+        for (struct cmsghdr* CMsg = CMSG_FIRSTHDR(&Mhdr);
+             CMsg != NULL;
+             CMsg = CMSG_NXTHDR(&Mhdr, CMsg)) {
+
+            if (!((CMsg->cmsg_level == SOL_IP && CMsg->cmsg_type == IP_RECVERR) ||
+                  (CMsg->cmsg_level == SOL_IPV6 && CMsg->cmsg_type == IPV6_RECVERR))) {
+                continue;
+            }
+
+            const struct sock_extended_err* ExtErr =
+                (const struct sock_extended_err*)CMSG_DATA(CMsg);
+            if (ExtErr->ee_errno != 0 || ExtErr->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+                continue;
+            }
+
+            //
+            // The completion covers the inclusive range [ee_info, ee_data].
+            //
+            const uint32_t Last = ExtErr->ee_data;
+            CXPLAT_LIST_ENTRY FreeList;
+            CxPlatListInitializeHead(&FreeList);
+
+            CxPlatLockAcquire(&SocketContext->ZeroCopyLock);
+            while (!CxPlatListIsEmpty(&SocketContext->ZeroCopyQueue)) {
+                CXPLAT_SEND_DATA* SendData =
+                    CXPLAT_CONTAINING_RECORD(
+                        SocketContext->ZeroCopyQueue.Flink,
+                        CXPLAT_SEND_DATA,
+                        ZeroCopyEntry);
+                if ((int32_t)(SendData->ZeroCopySequence - Last) > 0) {
+                    break;
+                }
+                CxPlatListRemoveHead(&SocketContext->ZeroCopyQueue);
+                if (SendData->ZeroCopySendDone) {
+                    CxPlatListInsertTail(&FreeList, &SendData->ZeroCopyEntry);
+                } else {
+                    SendData->ZeroCopyCompleted = TRUE;
+                }
+            }
+
+            if (ExtErr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED &&
+                SocketContext->ZeroCopyEnabled) {
+                //
+                // The kernel had to copy the data anyway (e.g. the route
+                // doesn't support scatter-gather), so zero-copy only adds
+                // overhead on this socket. Stop using it.
+                //
+                SocketContext->ZeroCopyEnabled = FALSE;
+                QuicTraceLogWarning(
+                    DatapathZeroCopyFallback,
+                    "[data][%p] Zero-copy send was copied by the kernel, disabling",
+                    SocketContext->Binding);
+            }
+            CxPlatLockRelease(&SocketContext->ZeroCopyLock);
+
+            if (ExtErr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+                InterlockedExchangeAdd64(
+                    (int64_t*)&SocketContext->DatapathPartition->SendZeroCopyCopiedCount,
+                    (int64_t)(Last - ExtErr->ee_info) + 1);
+            }
+
+            while (!CxPlatListIsEmpty(&FreeList)) {
+                CxPlatSendDataFree(
+                    CXPLAT_CONTAINING_RECORD(
+                        CxPlatListRemoveHead(&FreeList),
+                        CXPLAT_SEND_DATA,
+                        ZeroCopyEntry));
+            }
+        }
+    }
+}
+#endif
+
+//
+// Called when the sender is done with the send data. If the kernel still holds
+// a MSG_ZEROCOPY reference to the buffer, the free is deferred until the
+// completion is reaped.
+//
+void
+CxPlatSendDataRelease(
+    _In_ CXPLAT_SEND_DATA* SendData
+    )
+{
+    if (SendData->ZeroCopyPending) {
+        CXPLAT_SOCKET_CONTEXT* SocketContext = SendData->SocketContext;
+        BOOLEAN Free;
+        CxPlatLockAcquire(&SocketContext->ZeroCopyLock);
+        SendData->ZeroCopySendDone = TRUE;
+        Free = SendData->ZeroCopyCompleted;
+        CxPlatLockRelease(&SocketContext->ZeroCopyLock);
+        if (!Free) {
+            return;
+        }
+    }
+    CxPlatSendDataFree(SendData);
+}
+
 BOOLEAN
 CxPlatSendDataSendSegmented(
     _In_ CXPLAT_SEND_DATA* SendData
@@ -2456,6 +2722,24 @@ CxPlatSendDataSendSegmented(
         msghdr.msg_controllen = SendData->ControlBufferLength;
     }
 
+#ifdef SO_ZEROCOPY
+    if (SendData->SocketContext->ZeroCopyEnabled &&
+        SendData->TotalSize >= CXPLAT_SEND_ZERO_COPY_THRESHOLD) {
+        int Error = CxPlatSendDataSendZeroCopy(SendData, &msghdr);
+        if (Error == 0) {
+            return TRUE;
+        }
+        if (Error != ENOBUFS) {
+            errno = Error;
+            return FALSE;
+        }
+        //
+        // The socket's optmem limit for pinned pages was hit, so just copy
+        // this one.
+        //
+    }
+#endif
+
     if (sendmsg(SendData->SocketContext->SocketFd, &msghdr, 0) < 0) {
         return FALSE;
     }
@@ -2684,7 +2968,7 @@ CxPlatSocketContextFlushTxQueue(
                 Status,
                 SendData->TotalSize);
         }
-        CxPlatSendDataFree(SendData);
+        CxPlatSendDataRelease(SendData);
         if (!CxPlatListIsEmpty(&SocketContext->TxQueue)) {
             SendData =
                 CXPLAT_CONTAINING_RECORD(
@@ -2725,6 +3009,12 @@ CxPlatDataPathSocketProcessIoCompletion(
 {
     if (CxPlatRundownAcquire(&SocketContext->UpcallRundown)) {
         if (EPOLLERR & Cqe->events) {
+#ifdef SO_ZEROCOPY
+            if (SocketContext->Binding->Type == CXPLAT_SOCKET_UDP &&
+                SocketContext->Binding->Datapath->SendZeroCopySupported) {
+                CxPlatSocketContextReapZeroCopy(SocketContext);
+            }
+#endif
             CxPlatSocketHandleErrors(SocketContext);
         }
         if (EPOLLIN & Cqe->events) {
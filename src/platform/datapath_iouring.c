@@ -0,0 +1,2238 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    QUIC datapath Abstraction Layer, built on io_uring.
+
+    Receives use a single multishot recvmsg per socket that completes into
+    receive blocks the kernel picks from a per-partition ring of provided
+    buffers. Sends are submitted as sendmsg operations; large (segmented)
+    sends use zero-copy sendmsg when the kernel supports it. All completions
+    are processed by the worker thread that owns the partition's event
+    queue.
+
+Environment:
+
+    Linux
+
+--*/
+
+#include "platform_internal.h"
+#include <linux/filter.h>
+#include <linux/in6.h>
+#include <netinet/udp.h>
+
+#ifdef QUIC_CLOG
+#include "datapath_iouring.c.clog.h"
+#endif
+
+CXPLAT_STATIC_ASSERT((SIZEOF_STRUCT_MEMBER(QUIC_BUFFER, Length) <= sizeof(size_t)), "(sizeof(QUIC_BUFFER.Length) == sizeof(size_t) must be TRUE.");
+CXPLAT_STATIC_ASSERT((SIZEOF_STRUCT_MEMBER(QUIC_BUFFER, Buffer) == sizeof(void*)), "(sizeof(QUIC_BUFFER.Buffer) == sizeof(void*) must be TRUE.");
+
+//
+// The maximum single buffer size for single packet/datagram IO payloads.
+//
+#define CXPLAT_SMALL_IO_BUFFER_SIZE         MAX_UDP_PAYLOAD_LENGTH
+
+//
+// The maximum single buffer size for coalesced IO payloads.
+//
+#define CXPLAT_LARGE_IO_BUFFER_SIZE         0xFFFF
+
+//
+// The maximum batch size of IOs in that can use a single coalesced IO buffer.
+// This is calculated base on the number of the smallest possible single
+// packet/datagram payloads (i.e. IPv6) that can fit in the large buffer.
+//
+const uint16_t CXPLAT_MAX_IO_BATCH_SIZE =
+    (CXPLAT_LARGE_IO_BUFFER_SIZE / (1280 - CXPLAT_MIN_IPV6_HEADER_SIZE - CXPLAT_UDP_HEADER_SIZE));
+
+//
+// The number of provided receive buffers per partition. Must be a power of 2.
+//
+#define CXPLAT_RECV_BUFFER_COUNT            256
+
+//
+// The minimum send size for which zero-copy is used. Below this, the cost of
+// pinning the pages and the extra notification outweighs the copy.
+//
+#define CXPLAT_SEND_ZERO_COPY_THRESHOLD     16384
+
+//
+// Provided buffer group IDs must be unique per io_uring instance, and
+// multiple datapaths may share the same worker pool.
+//
+static uint16_t CxPlatNextRecvBufferGroup = 0;
+
+//
+// Contains all the info for a single RX IO operation. Multiple RX packets may
+// come from a single IO operation.
+//
+typedef struct DATAPATH_RX_IO_BLOCK {
+    //
+    // The partition whose provided buffer ring owns this recv block.
+    //
+    CXPLAT_DATAPATH_PARTITION* Partition;
+
+    //
+    // Represents the network route.
+    //
+    CXPLAT_ROUTE Route;
+
+    //
+    // Ref count of receive data/packets that are using this block.
+    //
+    long RefCount;
+
+    //
+    // The ID of the block in the provided buffer ring.
+    //
+    uint16_t BufferId;
+
+    //
+    // An array of packets to represent the datagram and metadata returned to
+    // the app.
+    //
+    //DATAPATH_RX_PACKET Packets[0];
+
+    //
+    // The io_uring_recvmsg_out header, the source address and control data,
+    // followed by the buffer that actually stores the UDP payload.
+    //
+    //uint8_t Buffer[]; // CXPLAT_SMALL_IO_BUFFER_SIZE or CXPLAT_LARGE_IO_BUFFER_SIZE
+
+} DATAPATH_RX_IO_BLOCK;
+
+typedef struct __attribute__((aligned(16))) DATAPATH_RX_PACKET {
+    //
+    // The IO block that owns the packet.
+    //
+    DATAPATH_RX_IO_BLOCK* IoBlock;
+
+    //
+    // Publicly visible receive data.
+    //
+    CXPLAT_RECV_DATA Data;
+
+} DATAPATH_RX_PACKET;
+
+//
+// A single sendmsg operation of a send.
+//
+typedef struct CXPLAT_SEND_MSG {
+    struct msghdr Hdr;
+    struct iovec Iov;
+} CXPLAT_SEND_MSG;
+
+//
+// Send context.
+//
+
+typedef struct CXPLAT_SEND_DATA {
+    CXPLAT_SEND_DATA_COMMON;
+
+    //
+    // Completion queue event tag for all the send operations.
+    //
+    DATAPATH_SQE Sqe;
+
+    //
+    // The socket context owning this send.
+    //
+    struct CXPLAT_SOCKET_CONTEXT* SocketContext;
+
+    //
+    // The local address to bind to.
+    //
+    QUIC_ADDR LocalAddress;
+
+    //
+    // The remote address to send to.
+    //
+    QUIC_ADDR RemoteAddress;
+
+    //
+    // The current QUIC_BUFFER returned to the client for segmented sends.
+    //
+    QUIC_BUFFER ClientBuffer;
+
+    //
+    // The total buffer size for iovecs.
+    //
+    uint32_t TotalSize;
+
+    //
+    // The send segmentation size the app asked for.
+    //
+    uint16_t SegmentSize;
+
+    //
+    // Total number of packet buffers allocated (and messages used if !GSO).
+    //
+    uint16_t BufferCount;
+
+    //
+    // The number of submitted send operations that haven't completed yet.
+    // Only accessed by the partition's worker thread once submitted.
+    //
+    uint16_t PendingOps;
+
+    //
+    // Length of the calculated ControlBuffer. Value is zero until the data is
+    // computed.
+    //
+    uint8_t ControlBufferLength;
+
+    //
+    // Set of flags set to configure the send behavior.
+    //
+    uint8_t Flags; // CXPLAT_SEND_FLAGS
+
+    //
+    // Indicates that send is on a connected socket.
+    //
+    uint8_t OnConnectedSocket : 1;
+
+    //
+    // Indicates that segmentation is supported for the send data.
+    //
+    uint8_t SegmentationSupported : 1;
+
+    //
+    // Indicates the send was submitted as zero-copy.
+    //
+    uint8_t ZeroCopy : 1;
+
+    //
+    // Space for ancillary control data.
+    //
+    alignas(8)
+    char ControlBuffer[
+        CMSG_SPACE(sizeof(int)) +               // IP_TOS || IPV6_TCLASS
+        CMSG_SPACE(sizeof(struct in6_pktinfo))  // IP_PKTINFO || IPV6_PKTINFO
+    #ifdef UDP_SEGMENT
+        + CMSG_SPACE(sizeof(uint16_t))          // UDP_SEGMENT
+    #endif
+        ];
+    CXPLAT_STATIC_ASSERT(
+        CMSG_SPACE(sizeof(struct in6_pktinfo)) >= CMSG_SPACE(sizeof(struct in_pktinfo)),
+        "sizeof(struct in6_pktinfo) >= sizeof(struct in_pktinfo) failed");
+
+    //
+    // Space for all the packet buffers.
+    //
+    uint8_t Buffer[CXPLAT_LARGE_IO_BUFFER_SIZE];
+
+    //
+    // Messages used for sends on the socket.
+    //
+    CXPLAT_SEND_MSG Msgs[1]; // variable length, depends on if GSO is being used
+                             //   if GSO is used, only 1 is needed
+                             //   if GSO is not used, then N are needed
+
+} CXPLAT_SEND_DATA;
+
+typedef struct CXPLAT_RECV_MSG_CONTROL_BUFFER {
+    char Data[CMSG_SPACE(sizeof(struct in6_pktinfo)) +
+              2 * CMSG_SPACE(sizeof(int))];
+} CXPLAT_RECV_MSG_CONTROL_BUFFER;
+
+//
+// The space at the start of each provided receive buffer that the kernel uses
+// for the recvmsg metadata.
+//
+#define CXPLAT_RECV_MSG_HEADER_SIZE \
+    (sizeof(struct io_uring_recvmsg_out) + \
+     sizeof(QUIC_ADDR) + \
+     sizeof(CXPLAT_RECV_MSG_CONTROL_BUFFER))
+
+#ifdef DEBUG
+#define CXPLAT_DBG_ASSERT_CMSG(CMsg, type) \
+    if (CMsg->cmsg_len < CMSG_LEN(sizeof(type))) { \
+        printf("%u: cmsg[%u:%u] len (%u) < exp_len (%u)\n", \
+            (uint32_t)__LINE__, \
+            (uint32_t)CMsg->cmsg_level, (uint32_t)CMsg->cmsg_type, \
+            (uint32_t)CMsg->cmsg_len, (uint32_t)CMSG_LEN(sizeof(type))); \
+    }
+#else
+#define CXPLAT_DBG_ASSERT_CMSG(CMsg, type)
+#endif
+
+void
+CxPlatDataPathCalculateFeatureSupport(
+    _Inout_ CXPLAT_DATAPATH* Datapath,
+    _In_ uint32_t ClientRecvDataLength
+    )
+{
+#ifdef UDP_SEGMENT
+    //
+    // Open up two sockets and send with GSO and receive with GRO, and make sure
+    // everything **actually** works, so that we can be sure we can leverage
+    // GRO.
+    //
+    int SendSocket = INVALID_SOCKET, RecvSocket = INVALID_SOCKET;
+    struct sockaddr_in RecvAddr = {0}, RecvAddr2 = {0};
+    socklen_t RecvAddrSize = sizeof(RecvAddr), RecvAddr2Size = sizeof(RecvAddr2);
+    int PktInfoEnabled = 1, TosEnabled = 1, GroEnabled = 1;
+    uint8_t Buffer[8 * 1476] = {0};
+    struct iovec IoVec;
+    IoVec.iov_base = Buffer;
+    IoVec.iov_len = sizeof(Buffer);
+    char SendControlBuffer[CMSG_SPACE(sizeof(int)) + CMSG_SPACE(sizeof(uint16_t))] = {0};
+    struct msghdr SendMsg = {0};
+    SendMsg.msg_name = &RecvAddr;
+    SendMsg.msg_namelen = RecvAddrSize;
+    SendMsg.msg_iov = &IoVec;
+    SendMsg.msg_iovlen = 1;
+    SendMsg.msg_control = SendControlBuffer;
+    SendMsg.msg_controllen = sizeof(SendControlBuffer);
+    struct cmsghdr *CMsg = CMSG_FIRSTHDR(&SendMsg);
+    CMsg->cmsg_level = IPPROTO_IP;
+    CMsg->cmsg_type = IP_TOS;
+    CMsg->cmsg_len = CMSG_LEN(sizeof(int));
+    *(int*)CMSG_DATA(CMsg) = 0x1;
+    CMsg = CMSG_NXTHDR(&SendMsg, CMsg);
+    CMsg->cmsg_level = SOL_UDP;
+    CMsg->cmsg_type = UDP_SEGMENT;
+    CMsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    *((uint16_t*)CMSG_DATA(CMsg)) = 1476;
+    RecvAddr.sin_family = AF_INET;
+    RecvAddr.sin_addr.s_addr = inet_addr("127.0.0.1");
+    char RecvControlBuffer[CMSG_SPACE(sizeof(int)) + CMSG_SPACE(sizeof(int)) + CMSG_SPACE(sizeof(struct in6_pktinfo))] = {0};
+    struct msghdr RecvMsg = {0};
+    RecvMsg.msg_name = &RecvAddr2;
+    RecvMsg.msg_namelen = RecvAddr2Size;
+    RecvMsg.msg_iov = &IoVec;
+    RecvMsg.msg_iovlen = 1;
+    RecvMsg.msg_control = RecvControlBuffer;
+    RecvMsg.msg_controllen = sizeof(RecvControlBuffer);
+#define VERIFY(X) if (!(X)) { goto Error; }
+    SendSocket = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, IPPROTO_UDP);
+    VERIFY(SendSocket != INVALID_SOCKET)
+    RecvSocket = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, IPPROTO_UDP);
+    VERIFY(RecvSocket != INVALID_SOCKET)
+    VERIFY(setsockopt(SendSocket, IPPROTO_IP, IP_PKTINFO, &PktInfoEnabled, sizeof(PktInfoEnabled)) != SOCKET_ERROR)
+    VERIFY(setsockopt(RecvSocket, IPPROTO_IP, IP_PKTINFO, &PktInfoEnabled, sizeof(PktInfoEnabled)) != SOCKET_ERROR)
+    VERIFY(setsockopt(SendSocket, IPPROTO_IP, IP_RECVTOS, &TosEnabled, sizeof(TosEnabled)) != SOCKET_ERROR)
+    VERIFY(setsockopt(RecvSocket, IPPROTO_IP, IP_RECVTOS, &TosEnabled, sizeof(TosEnabled)) != SOCKET_ERROR)
+    VERIFY(bind(RecvSocket, (struct sockaddr*)&RecvAddr, RecvAddrSize) != SOCKET_ERROR)
+#ifdef UDP_GRO
+    VERIFY(setsockopt(RecvSocket, SOL_UDP, UDP_GRO, &GroEnabled, sizeof(GroEnabled)) != SOCKET_ERROR)
+#endif
+    VERIFY(getsockname(RecvSocket, (struct sockaddr*)&RecvAddr, &RecvAddrSize) != SOCKET_ERROR)
+    VERIFY(connect(SendSocket, (struct sockaddr*)&RecvAddr, RecvAddrSize) != SOCKET_ERROR)
+    VERIFY(sendmsg(SendSocket, &SendMsg, 0) == sizeof(Buffer))
+    //
+    // We were able to at least send successfully, so indicate the send
+    // segmentation feature as available.
+    //
+    Datapath->Features |= CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION;
+#ifdef UDP_GRO
+    VERIFY(recvmsg(RecvSocket, &RecvMsg, 0) == sizeof(Buffer))
+    BOOLEAN FoundPKTINFO = FALSE, FoundTOS = FALSE, FoundGRO = FALSE;
+    for (CMsg = CMSG_FIRSTHDR(&RecvMsg); CMsg != NULL; CMsg = CMSG_NXTHDR(&RecvMsg, CMsg)) {
+        if (CMsg->cmsg_level == IPPROTO_IP) {
+            if (CMsg->cmsg_type == IP_PKTINFO) {
+                FoundPKTINFO = TRUE;
+            } else if (CMsg->cmsg_type == IP_TOS) {
+                CXPLAT_DBG_ASSERT_CMSG(CMsg, uint8_t);
+                VERIFY(0x1 == *(uint8_t*)CMSG_DATA(CMsg))
+                FoundTOS = TRUE;
+            }
+        } else if (CMsg->cmsg_level == IPPROTO_UDP) {
+            if (CMsg->cmsg_type == UDP_GRO) {
+                CXPLAT_DBG_ASSERT_CMSG(CMsg, uint16_t);
+                VERIFY(1476 == *(uint16_t*)CMSG_DATA(CMsg))
+                FoundGRO = TRUE;
+            }
+        }
+    }
+    VERIFY(FoundPKTINFO)
+    VERIFY(FoundTOS)
+    VERIFY(FoundGRO)
+    //
+    // We were able receive everything successfully so we can indicate the
+    // receive coalescing feature as available.
+    //
+    Datapath->Features |= CXPLAT_DATAPATH_FEATURE_RECV_COALESCING;
+#endif // UDP_GRO
+Error:
+    if (RecvSocket != INVALID_SOCKET) { close(RecvSocket); }
+    if (SendSocket != INVALID_SOCKET) { close(SendSocket); }
+#endif // UDP_SEGMENT
+
+    if (Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION) {
+        Datapath->SendDataSize = sizeof(CXPLAT_SEND_DATA);
+        Datapath->SendIoVecCount = 1;
+    } else {
+        const uint32_t SendDataSize =
+            sizeof(CXPLAT_SEND_DATA) + (CXPLAT_MAX_IO_BATCH_SIZE - 1) * sizeof(CXPLAT_SEND_MSG);
+        Datapath->SendDataSize = SendDataSize;
+        Datapath->SendIoVecCount = CXPLAT_MAX_IO_BATCH_SIZE;
+    }
+
+    //
+    // Each receive block is also a provided buffer, so its size is fixed up
+    // front and the recvmsg metadata precedes the payload.
+    //
+    Datapath->RecvBlockStride =
+        sizeof(DATAPATH_RX_PACKET) + ClientRecvDataLength;
+    uint32_t RecvBlockSize;
+    if (Datapath->Features & CXPLAT_DATAPATH_FEATURE_RECV_COALESCING) {
+        Datapath->RecvBlockBufferOffset =
+            sizeof(DATAPATH_RX_IO_BLOCK) +
+            CXPLAT_MAX_IO_BATCH_SIZE * Datapath->RecvBlockStride;
+        RecvBlockSize =
+            Datapath->RecvBlockBufferOffset + CXPLAT_RECV_MSG_HEADER_SIZE +
+            CXPLAT_LARGE_IO_BUFFER_SIZE;
+    } else {
+        Datapath->RecvBlockBufferOffset =
+            sizeof(DATAPATH_RX_IO_BLOCK) + Datapath->RecvBlockStride;
+        RecvBlockSize =
+            Datapath->RecvBlockBufferOffset + CXPLAT_RECV_MSG_HEADER_SIZE +
+            CXPLAT_SMALL_IO_BUFFER_SIZE;
+    }
+    Datapath->RecvBlockSize = (RecvBlockSize + 15) & ~15u; // Keep blocks aligned.
+}
+
+//
+// Queries the kernel for the optional io_uring send features.
+//
+void
+CxPlatDataPathCalculateIoUringSupport(
+    _Inout_ CXPLAT_DATAPATH* Datapath,
+    _In_opt_ QUIC_EXECUTION_CONFIG* Config
+    )
+{
+    if (!Config || !(Config->Flags & QUIC_EXECUTION_CONFIG_FLAG_ZERO_COPY_SEND)) {
+        return; // Zero-copy sends are opt-in.
+    }
+
+    CXPLAT_EVENTQ* EventQ = CxPlatWorkerPoolGetEventQ(Datapath->WorkerPool, 0);
+    struct io_uring_probe* Probe = io_uring_get_probe_ring(&EventQ->Ring);
+    if (Probe == NULL) {
+        return;
+    }
+
+    if (Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION &&
+        io_uring_opcode_supported(Probe, IORING_OP_SENDMSG_ZC)) {
+        Datapath->SendZeroCopySupported = TRUE;
+    }
+
+    io_uring_free_probe(Probe);
+}
+
+static
+DATAPATH_RX_IO_BLOCK*
+CxPlatPartitionGetRecvBlock(
+    _In_ const CXPLAT_DATAPATH_PARTITION* DatapathPartition,
+    _In_ uint16_t BufferId
+    )
+{
+    CXPLAT_DBG_ASSERT(BufferId < CXPLAT_RECV_BUFFER_COUNT);
+    return
+        (DATAPATH_RX_IO_BLOCK*)
+            (DatapathPartition->RecvBlocks +
+             (size_t)BufferId * DatapathPartition->Datapath->RecvBlockSize);
+}
+
+//
+// Gives a receive block (back) to the kernel to receive into.
+//
+static
+void
+CxPlatRecvBlockReturn(
+    _In_ DATAPATH_RX_IO_BLOCK* IoBlock
+    )
+{
+    CXPLAT_DATAPATH_PARTITION* DatapathPartition = IoBlock->Partition;
+    CXPLAT_DATAPATH* Datapath = DatapathPartition->Datapath;
+
+    CxPlatLockAcquire(&DatapathPartition->RecvBufRingLock);
+    io_uring_buf_ring_add(
+        DatapathPartition->RecvBufRing,
+        (uint8_t*)IoBlock + Datapath->RecvBlockBufferOffset,
+        Datapath->RecvBlockSize - Datapath->RecvBlockBufferOffset,
+        IoBlock->BufferId,
+        io_uring_buf_ring_mask(CXPLAT_RECV_BUFFER_COUNT),
+        0);
+    io_uring_buf_ring_advance(DatapathPartition->RecvBufRing, 1);
+    CxPlatLockRelease(&DatapathPartition->RecvBufRingLock);
+}
+
+QUIC_STATUS
+CxPlatProcessorContextInitializeRecvBuffers(
+    _Inout_ CXPLAT_DATAPATH_PARTITION* DatapathPartition
+    )
+{
+    CXPLAT_DATAPATH* Datapath = DatapathPartition->Datapath;
+    const size_t RecvBlocksLength =
+        (size_t)CXPLAT_RECV_BUFFER_COUNT * Datapath->RecvBlockSize;
+
+    DatapathPartition->RecvBlocks =
+        CXPLAT_ALLOC_NONPAGED(RecvBlocksLength, QUIC_POOL_DATA);
+    if (DatapathPartition->RecvBlocks == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "DATAPATH_RX_IO_BLOCK",
+            RecvBlocksLength);
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+
+    int Ret = 0;
+    DatapathPartition->RecvBufRing =
+        io_uring_setup_buf_ring(
+            &DatapathPartition->EventQ->Ring,
+            CXPLAT_RECV_BUFFER_COUNT,
+            Datapath->RecvBufferGroup,
+            0,
+            &Ret);
+    if (DatapathPartition->RecvBufRing == NULL) {
+        QuicTraceEvent(
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            -Ret,
+            "io_uring_setup_buf_ring failed");
+        CXPLAT_FREE(DatapathPartition->RecvBlocks, QUIC_POOL_DATA);
+        DatapathPartition->RecvBlocks = NULL;
+        return -Ret;
+    }
+
+    for (uint16_t i = 0; i < CXPLAT_RECV_BUFFER_COUNT; ++i) {
+        DATAPATH_RX_IO_BLOCK* IoBlock = CxPlatPartitionGetRecvBlock(DatapathPartition, i);
+        IoBlock->Partition = DatapathPartition;
+        IoBlock->BufferId = i;
+        io_uring_buf_ring_add(
+            DatapathPartition->RecvBufRing,
+            (uint8_t*)IoBlock + Datapath->RecvBlockBufferOffset,
+            Datapath->RecvBlockSize - Datapath->RecvBlockBufferOffset,
+            i,
+            io_uring_buf_ring_mask(CXPLAT_RECV_BUFFER_COUNT),
+            i);
+    }
+    io_uring_buf_ring_advance(DatapathPartition->RecvBufRing, CXPLAT_RECV_BUFFER_COUNT);
+
+    return QUIC_STATUS_SUCCESS;
+}
+
+QUIC_STATUS
+CxPlatProcessorContextInitialize(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _In_ uint16_t PartitionIndex,
+    _Out_ CXPLAT_DATAPATH_PARTITION* DatapathPartition
+    )
+{
+    CXPLAT_DBG_ASSERT(Datapath != NULL);
+    DatapathPartition->Datapath = Datapath;
+    DatapathPartition->PartitionIndex = PartitionIndex;
+    DatapathPartition->EventQ = CxPlatWorkerPoolGetEventQ(Datapath->WorkerPool, PartitionIndex);
+    CxPlatRefInitialize(&DatapathPartition->RefCount);
+    CxPlatPoolInitialize(TRUE, Datapath->SendDataSize, QUIC_POOL_DATA, &DatapathPartition->SendBlockPool);
+    CxPlatLockInitialize(&DatapathPartition->RecvBufRingLock);
+
+    QUIC_STATUS Status = CxPlatProcessorContextInitializeRecvBuffers(DatapathPartition);
+    if (QUIC_FAILED(Status)) {
+        CxPlatLockUninitialize(&DatapathPartition->RecvBufRingLock);
+        CxPlatPoolUninitialize(&DatapathPartition->SendBlockPool);
+        return Status;
+    }
+
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatProcessorContextUninitialize(
+    _In_ CXPLAT_DATAPATH_PARTITION* DatapathPartition
+    )
+{
+    io_uring_free_buf_ring(
+        &DatapathPartition->EventQ->Ring,
+        DatapathPartition->RecvBufRing,
+        CXPLAT_RECV_BUFFER_COUNT,
+        DatapathPartition->Datapath->RecvBufferGroup);
+    CXPLAT_FREE(DatapathPartition->RecvBlocks, QUIC_POOL_DATA);
+    CxPlatLockUninitialize(&DatapathPartition->RecvBufRingLock);
+    CxPlatPoolUninitialize(&DatapathPartition->SendBlockPool);
+}
+
+QUIC_STATUS
+DataPathInitialize(
+    _In_ uint32_t ClientRecvDataLength,
+    _In_opt_ const CXPLAT_UDP_DATAPATH_CALLBACKS* UdpCallbacks,
+    _In_opt_ const CXPLAT_TCP_DATAPATH_CALLBACKS* TcpCallbacks,
+    _In_ CXPLAT_WORKER_POOL* WorkerPool,
+    _In_opt_ QUIC_EXECUTION_CONFIG* Config,
+    _Out_ CXPLAT_DATAPATH** NewDatapath
+    )
+{
+    if (NewDatapath == NULL) {
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+    if (UdpCallbacks != NULL) {
+        if (UdpCallbacks->Receive == NULL || UdpCallbacks->Unreachable == NULL) {
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+    }
+    if (TcpCallbacks != NULL) {
+        if (TcpCallbacks->Accept == NULL ||
+            TcpCallbacks->Connect == NULL ||
+            TcpCallbacks->Receive == NULL ||
+            TcpCallbacks->SendComplete == NULL) {
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+    }
+    if (WorkerPool == NULL) {
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+
+    if (!CxPlatWorkerPoolLazyStart(WorkerPool, Config)) {
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+
+    const uint32_t PartitionCount = (Config && Config->ProcessorCount)
+        ? Config->ProcessorCount : CxPlatProcCount();
+
+    const size_t DatapathLength =
+        sizeof(CXPLAT_DATAPATH) + PartitionCount * sizeof(CXPLAT_DATAPATH_PARTITION);
+
+    CXPLAT_DATAPATH* Datapath =
+        (CXPLAT_DATAPATH*)CXPLAT_ALLOC_PAGED(DatapathLength, QUIC_POOL_DATAPATH);
+    if (Datapath == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "CXPLAT_DATAPATH",
+            DatapathLength);
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+
+    CxPlatZeroMemory(Datapath, DatapathLength);
+    if (UdpCallbacks) {
+        Datapath->UdpHandlers = *UdpCallbacks;
+    }
+    if (TcpCallbacks) {
+        Datapath->TcpHandlers = *TcpCallbacks;
+    }
+    Datapath->WorkerPool = WorkerPool;
+
+    Datapath->PartitionCount = PartitionCount;
+    Datapath->Features = CXPLAT_DATAPATH_FEATURE_LOCAL_PORT_SHARING;
+    Datapath->RecvBufferGroup =
+        (uint16_t)InterlockedIncrement16((short*)&CxPlatNextRecvBufferGroup);
+    CxPlatRefInitializeEx(&Datapath->RefCount, Datapath->PartitionCount);
+    CxPlatDataPathCalculateFeatureSupport(Datapath, ClientRecvDataLength);
+    CxPlatDataPathCalculateIoUringSupport(Datapath, Config);
+
+    //
+    // Initialize the per processor contexts.
+    //
+    for (uint32_t i = 0; i < Datapath->PartitionCount; i++) {
+        QUIC_STATUS Status =
+            CxPlatProcessorContextInitialize(
+                Datapath, (uint16_t)i, &Datapath->Partitions[i]);
+        if (QUIC_FAILED(Status)) {
+            while (i-- > 0) {
+                CxPlatProcessorContextUninitialize(&Datapath->Partitions[i]);
+            }
+            CXPLAT_FREE(Datapath, QUIC_POOL_DATAPATH);
+            return Status;
+        }
+    }
+
+    CXPLAT_FRE_ASSERT(CxPlatRundownAcquire(&WorkerPool->Rundown));
+    *NewDatapath = Datapath;
+
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatDataPathRelease(
+    _In_ CXPLAT_DATAPATH* Datapath
+    )
+{
+    if (CxPlatRefDecrement(&Datapath->RefCount)) {
+#if DEBUG
+        CXPLAT_DBG_ASSERT(!Datapath->Freed);
+        CXPLAT_DBG_ASSERT(Datapath->Uninitialized);
+        Datapath->Freed = TRUE;
+#endif
+        CxPlatRundownRelease(&Datapath->WorkerPool->Rundown);
+        CXPLAT_FREE(Datapath, QUIC_POOL_DATAPATH);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatProcessorContextRelease(
+    _In_ CXPLAT_DATAPATH_PARTITION* DatapathPartition
+    )
+{
+    if (CxPlatRefDecrement(&DatapathPartition->RefCount)) {
+#if DEBUG
+        CXPLAT_DBG_ASSERT(!DatapathPartition->Uninitialized);
+        DatapathPartition->Uninitialized = TRUE;
+#endif
+        CxPlatProcessorContextUninitialize(DatapathPartition);
+        CxPlatDataPathRelease(DatapathPartition->Datapath);
+    }
+}
+
+void
+DataPathUninitialize(
+    _In_ CXPLAT_DATAPATH* Datapath
+    )
+{
+    if (Datapath != NULL) {
+#if DEBUG
+        CXPLAT_DBG_ASSERT(!Datapath->Uninitialized);
+        Datapath->Uninitialized = TRUE;
+#endif
+        const uint16_t PartitionCount = Datapath->PartitionCount;
+        for (uint32_t i = 0; i < PartitionCount; i++) {
+            CxPlatProcessorContextRelease(&Datapath->Partitions[i]);
+        }
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+DataPathUpdateConfig(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _In_ QUIC_EXECUTION_CONFIG* Config
+    )
+{
+    UNREFERENCED_PARAMETER(Datapath);
+    UNREFERENCED_PARAMETER(Config);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+DataPathGetSupportedFeatures(
+    _In_ CXPLAT_DATAPATH* Datapath
+    )
+{
+    return Datapath->Features;
+}
+
+BOOLEAN
+DataPathIsPaddingPreferred(
+    _In_ CXPLAT_DATAPATH* Datapath
+    )
+{
+    return !!(Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+DataPathGetStatistics(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _Out_ CXPLAT_DATAPATH_STATISTICS* Statistics
+    )
+{
+    CxPlatZeroMemory(Statistics, sizeof(*Statistics));
+    for (uint32_t i = 0; i < Datapath->PartitionCount; i++) {
+        Statistics->SendZeroCopyCount += Datapath->Partitions[i].SendZeroCopyCount;
+        Statistics->SendZeroCopyCopiedCount += Datapath->Partitions[i].SendZeroCopyCopiedCount;
+    }
+}
+
+QUIC_STATUS
+CxPlatSocketConfigureRss(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
+    _In_ uint32_t SocketCount
+    )
+{
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    int Result = 0;
+
+    struct sock_filter BpfCode[] = {
+        {BPF_LD | BPF_W | BPF_ABS, 0, 0, SKF_AD_OFF | SKF_AD_CPU},
+        {BPF_ALU | BPF_MOD, 0, 0, SocketCount},
+        {BPF_RET | BPF_A, 0, 0, 0}
+    };
+
+    struct sock_fprog BpfConfig = {0};
+    BpfConfig.len = ARRAYSIZE(BpfCode);
+    BpfConfig.filter = BpfCode;
+
+    Result =
+        setsockopt(
+            SocketContext->SocketFd,
+            SOL_SOCKET,
+            SO_ATTACH_REUSEPORT_CBPF,
+            (const void*)&BpfConfig,
+            sizeof(BpfConfig));
+    if (Result == SOCKET_ERROR) {
+        Status = errno;
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            SocketContext->Binding,
+            Status,
+            "setsockopt(SO_ATTACH_REUSEPORT_CBPF) failed");
+    }
+
+    return Status;
+#else
+    UNREFERENCED_PARAMETER(SocketContext);
+    UNREFERENCED_PARAMETER(SocketCount);
+    return QUIC_STATUS_NOT_SUPPORTED;
+#endif
+}
+
+//
+// Socket context interface. It abstracts a (generally per-processor) UDP socket
+// and the corresponding logic/functionality like send and receive processing.
+//
+QUIC_STATUS
+CxPlatSocketContextInitialize(
+    _Inout_ CXPLAT_SOCKET_CONTEXT* SocketContext,
+    _In_ const CXPLAT_UDP_CONFIG* Config,
+    _In_ const uint16_t PartitionIndex
+    )
+{
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    int Result = 0;
+    int Option = 0;
+    QUIC_ADDR MappedAddress = {0};
+    socklen_t AssignedLocalAddressLength = 0;
+
+    CXPLAT_SOCKET* Binding = SocketContext->Binding;
+    CXPLAT_DATAPATH* Datapath = Binding->Datapath;
+
+    CXPLAT_DBG_ASSERT(PartitionIndex < Datapath->PartitionCount);
+    SocketContext->DatapathPartition = &Datapath->Partitions[PartitionIndex];
+    CxPlatRefIncrement(&SocketContext->DatapathPartition->RefCount);
+
+    SocketContext->ShutdownSqe.CqeType = CXPLAT_CQE_TYPE_SOCKET_SHUTDOWN;
+    SocketContext->IoSqe.CqeType = CXPLAT_CQE_TYPE_SOCKET_IO;
+
+    //
+    // The kernel lays out each received message in the provided buffer based
+    // on the name and control lengths of this template.
+    //
+    SocketContext->RecvMsgHdr.msg_namelen = sizeof(QUIC_ADDR);
+    SocketContext->RecvMsgHdr.msg_controllen = sizeof(CXPLAT_RECV_MSG_CONTROL_BUFFER);
+
+    //
+    // Create datagram socket.
+    //
+    SocketContext->SocketFd =
+        socket(
+            AF_INET6,
+            SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+            IPPROTO_UDP);
+    if (SocketContext->SocketFd == INVALID_SOCKET) {
+        Status = errno;
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            Binding,
+            Status,
+            "socket failed");
+        goto Exit;
+    }
+
+    //
+    // Set dual (IPv4 & IPv6) socket mode.
+    //
+    Option = FALSE;
+    Result =
+        setsockopt(
+            SocketContext->SocketFd,
+            IPPROTO_IPV6,
+            IPV6_V6ONLY,
+            (const void*)&Option,
+            sizeof(Option));
+    if (Result == SOCKET_ERROR) {
+        Status = errno;
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            Binding,
+            Status,
+            "setsockopt(IPV6_V6ONLY) failed");
+        goto Exit;
+    }
+
+    //
+    // Set DON'T FRAG socket option.
+    //
+    Option = IP_PMTUDISC_PROBE;
+    Result =
+        setsockopt(
+            SocketContext->SocketFd,
+            IPPROTO_IP,
+            IP_MTU_DISCOVER,
+            (const void*)&Option,
+            sizeof(Option));
+    if (Result == SOCKET_ERROR) {
+        Status = errno;
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            Binding,
+            Status,
+            "setsockopt(IP_MTU_DISCOVER) failed");
+        goto Exit;
+    }
+    Result =
+        setsockopt(
+            SocketContext->SocketFd,
+            IPPROTO_IPV6,
+            IPV6_MTU_DISCOVER,
+            (const void*)&Option,
+            sizeof(Option));
+    if (Result == SOCKET_ERROR) {
+        Status = errno;
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            Binding,
+            Status,
+            "setsockopt(IPV6_MTU_DISCOVER) failed");
+        goto Exit;
+    }
+
+    Option = TRUE;
+    Result =
+        setsockopt(
+            SocketContext->SocketFd,
+            IPPROTO_IPV6,
+            IPV6_DONTFRAG,
+            (const void*)&Option,
+            sizeof(Option));
+    if (Result == SOCKET_ERROR) {
+        Status = errno;
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            Binding,
+            Status,
+            "setsockopt(IPV6_DONTFRAG) failed");
+        goto Exit;
+    }
+
+    //
+    // Set socket option to receive ancillary data about the incoming packets.
+    //
+    Option = TRUE;
+    Result =
+        setsockopt(
+            SocketContext->SocketFd,
+            IPPROTO_IPV6,
+            IPV6_RECVPKTINFO,
+            (const void*)&Option,
+            sizeof(Option));
+    if (Result == SOCKET_ERROR) {
+        Status = errno;
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            Binding,
+            Status,
+            "setsockopt(IPV6_RECVPKTINFO) failed");
+        goto Exit;
+    }
+
+    //
+    // Set socket option to receive TOS (= DSCP + ECN) information from the
+    // incoming packet.
+    //
+    Option = TRUE;
+    Result =
+        setsockopt(
+            SocketContext->SocketFd,
+            IPPROTO_IPV6,
+            IPV6_RECVTCLASS,
+            (const void*)&Option,
+            sizeof(Option));
+    if (Result == SOCKET_ERROR) {
+        Status = errno;
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            Binding,
+            Status,
+            "setsockopt(IPV6_RECVTCLASS) failed");
+        goto Exit;
+    }
+
+    Option = TRUE;
+    Result =
+        setsockopt(
+            SocketContext->SocketFd,
+            IPPROTO_IP,
+            IP_RECVTOS,
+            (const void*)&Option,
+            sizeof(Option));
+    if (Result == SOCKET_ERROR) {
+        Status = errno;
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            Binding,
+            Status,
+            "setsockopt(IP_RECVTOS) failed");
+        goto Exit;
+    }
+
+#ifdef UDP_GRO
+    if (Datapath->Features & CXPLAT_DATAPATH_FEATURE_RECV_COALESCING) {
+        Option = TRUE;
+        Result =
+            setsockopt(
+                SocketContext->SocketFd,
+                SOL_UDP,
+                UDP_GRO,
+                (const void*)&Option,
+                sizeof(Option));
+        if (Result == SOCKET_ERROR) {
+            Status = errno;
+            QuicTraceEvent(
+                DatapathErrorStatus,
+                "[data][%p] ERROR, %u, %s.",
+                Binding,
+                Status,
+                "setsockopt(UDP_GRO) failed");
+            goto Exit;
+        }
+    }
+#endif
+
+    //
+    // The socket is shared by multiple QUIC endpoints, so increase the receive
+    // buffer size.
+    //
+    Option = INT32_MAX;
+    Result =
+        setsockopt(
+            SocketContext->SocketFd,
+            SOL_SOCKET,
+            SO_RCVBUF,
+            (const void*)&Option,
+            sizeof(Option));
+    if (Result == SOCKET_ERROR) {
+        Status = errno;
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            Binding,
+            Status,
+            "setsockopt(SO_RCVBUF) failed");
+        goto Exit;
+    }
+
+    //
+    // Only set SO_REUSEPORT on a server socket, otherwise the client could be
+    // assigned a server port (unless it's forcing sharing).
+    //
+    if ((Config->Flags & CXPLAT_SOCKET_FLAG_SHARE || Config->RemoteAddress == NULL) &&
+        Datapath->PartitionCount > 1) {
+        //
+        // The port is shared across processors.
+        //
+        Option = TRUE;
+        Result =
+            setsockopt(
+                SocketContext->SocketFd,
+                SOL_SOCKET,
+                SO_REUSEPORT,
+                (const void*)&Option,
+                sizeof(Option));
+        if (Result == SOCKET_ERROR) {
+            Status = errno;
+            QuicTraceEvent(
+                DatapathErrorStatus,
+                "[data][%p] ERROR, %u, %s.",
+                Binding,
+                Status,
+                "setsockopt(SO_REUSEPORT) failed");
+            goto Exit;
+        }
+    }
+
+    CxPlatCopyMemory(&MappedAddress, &Binding->LocalAddress, sizeof(MappedAddress));
+    if (MappedAddress.Ipv6.sin6_family == QUIC_ADDRESS_FAMILY_INET6) {
+        MappedAddress.Ipv6.sin6_family = AF_INET6;
+    }
+
+    Result =
+        bind(
+            SocketContext->SocketFd,
+            &MappedAddress.Ip,
+            sizeof(MappedAddress));
+    if (Result == SOCKET_ERROR) {
+        Status = errno;
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            Binding,
+            Status,
+            "bind failed");
+        goto Exit;
+    }
+
+    if (Config->RemoteAddress != NULL) {
+        CxPlatZeroMemory(&MappedAddress, sizeof(MappedAddress));
+        CxPlatConvertToMappedV6(Config->RemoteAddress, &MappedAddress);
+
+        if (MappedAddress.Ipv6.sin6_family == QUIC_ADDRESS_FAMILY_INET6) {
+            MappedAddress.Ipv6.sin6_family = AF_INET6;
+        }
+        Result =
+            connect(
+                SocketContext->SocketFd,
+                &MappedAddress.Ip,
+                sizeof(MappedAddress));
+        if (Result == SOCKET_ERROR) {
+            Status = errno;
+            QuicTraceEvent(
+                DatapathErrorStatus,
+                "[data][%p] ERROR, %u, %s.",
+                Binding,
+                Status,
+                "connect failed");
+            goto Exit;
+        }
+        Binding->Connected = TRUE;
+    }
+
+    //
+    // If no specific local port was indicated, then the stack just
+    // assigned this socket a port. We need to query it and use it for
+    // all the other sockets we are going to create.
+    //
+    AssignedLocalAddressLength = sizeof(Binding->LocalAddress);
+    Result =
+        getsockname(
+            SocketContext->SocketFd,
+            (struct sockaddr *)&Binding->LocalAddress,
+            &AssignedLocalAddressLength);
+    if (Result == SOCKET_ERROR) {
+        Status = errno;
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            Binding,
+            Status,
+            "getsockname failed");
+        goto Exit;
+    }
+
+#if DEBUG
+    if (Config->LocalAddress && Config->LocalAddress->Ipv4.sin_port != 0) {
+        CXPLAT_DBG_ASSERT(Config->LocalAddress->Ipv4.sin_port == Binding->LocalAddress.Ipv4.sin_port);
+    } else if (Config->RemoteAddress && Config->LocalAddress && Config->LocalAddress->Ipv4.sin_port == 0) {
+        //
+        // A client socket being assigned the same port as a remote socket causes issues later
+        // in the datapath and binding paths. Check to make sure this case was not given to us.
+        //
+        CXPLAT_DBG_ASSERT(Binding->LocalAddress.Ipv4.sin_port != Config->RemoteAddress->Ipv4.sin_port);
+    }
+#endif
+
+    if (Binding->LocalAddress.Ipv6.sin6_family == AF_INET6) {
+        Binding->LocalAddress.Ipv6.sin6_family = QUIC_ADDRESS_FAMILY_INET6;
+    }
+
+Exit:
+
+    if (QUIC_FAILED(Status)) {
+        close(SocketContext->SocketFd);
+        SocketContext->SocketFd = INVALID_SOCKET;
+    }
+
+    return Status;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatSocketRelease(
+    _In_ CXPLAT_SOCKET* Socket
+    )
+{
+    if (CxPlatRefDecrement(&Socket->RefCount)) {
+#if DEBUG
+        CXPLAT_DBG_ASSERT(!Socket->Freed);
+        CXPLAT_DBG_ASSERT(Socket->Uninitialized);
+        Socket->Freed = TRUE;
+#endif
+        CXPLAT_FREE(CxPlatSocketToRaw(Socket), QUIC_POOL_SOCKET);
+    }
+}
+
+void
+CxPlatSocketContextUninitializeComplete(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
+    )
+{
+#if DEBUG
+    CXPLAT_DBG_ASSERT(!SocketContext->Freed);
+    SocketContext->Freed = TRUE;
+#endif
+
+    if (SocketContext->SocketFd != INVALID_SOCKET) {
+        close(SocketContext->SocketFd);
+    }
+
+    CxPlatRundownUninitialize(&SocketContext->UpcallRundown);
+
+    if (SocketContext->DatapathPartition) {
+        CxPlatProcessorContextRelease(SocketContext->DatapathPartition);
+    }
+    CxPlatSocketRelease(SocketContext->Binding);
+}
+
+//
+// Releases a reference on the socket context's outstanding IO, completing the
+// clean up once the last one is gone.
+//
+static
+void
+CxPlatSocketContextReleaseIo(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
+    )
+{
+    if (InterlockedDecrement(&SocketContext->OutstandingIo) == 0) {
+        CxPlatSocketContextUninitializeComplete(SocketContext);
+    }
+}
+
+//
+// Queues up the multishot receive on the socket. Must be called with the event
+// queue lock held. The SQE is submitted by the caller, or along with the next
+// event queue dequeue when running on the worker thread.
+//
+static
+BOOLEAN
+CxPlatSocketContextArmReceive(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
+    )
+{
+    struct io_uring_sqe* Sqe =
+        CxPlatEventQGetSqe(SocketContext->DatapathPartition->EventQ);
+    if (Sqe == NULL) {
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            SocketContext->Binding,
+            QUIC_STATUS_OUT_OF_MEMORY,
+            "io_uring_get_sqe failed");
+        return FALSE;
+    }
+
+    io_uring_prep_recvmsg_multishot(Sqe, SocketContext->SocketFd, &SocketContext->RecvMsgHdr, 0);
+    Sqe->flags |= IOSQE_BUFFER_SELECT;
+    Sqe->buf_group = SocketContext->Binding->Datapath->RecvBufferGroup;
+    io_uring_sqe_set_data(Sqe, &SocketContext->IoSqe);
+    return TRUE;
+}
+
+void
+CxPlatSocketContextStartReceive(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
+    )
+{
+    CXPLAT_EVENTQ* EventQ = SocketContext->DatapathPartition->EventQ;
+
+    //
+    // One reference for the socket itself, released once the shutdown
+    // cancellation completes, and one for the multishot receive.
+    //
+    SocketContext->OutstandingIo = 2;
+
+    CxPlatLockAcquire(&EventQ->Lock);
+    CXPLAT_FRE_ASSERT(CxPlatSocketContextArmReceive(SocketContext));
+    io_uring_submit(&EventQ->Ring);
+    CxPlatLockRelease(&EventQ->Lock);
+
+    SocketContext->IoStarted = TRUE;
+}
+
+void
+CxPlatSocketContextUninitialize(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
+    )
+{
+#if DEBUG
+    CXPLAT_DBG_ASSERT(!SocketContext->Uninitialized);
+    SocketContext->Uninitialized = TRUE;
+#endif
+
+    if (!SocketContext->IoStarted) {
+        CxPlatSocketContextUninitializeComplete(SocketContext);
+    } else {
+        CxPlatRundownReleaseAndWait(&SocketContext->UpcallRundown); // Block until all upcalls complete.
+
+        //
+        // Cancel the multishot receive. Clean up completes once the
+        // cancellation, the receive and any in-flight sends have completed.
+        //
+        CXPLAT_EVENTQ* EventQ = SocketContext->DatapathPartition->EventQ;
+        CxPlatLockAcquire(&EventQ->Lock);
+        SocketContext->ShuttingDown = TRUE;
+        struct io_uring_sqe* Sqe = CxPlatEventQGetSqe(EventQ);
+        CXPLAT_FRE_ASSERT(Sqe != NULL);
+        io_uring_prep_cancel(Sqe, &SocketContext->IoSqe, 0);
+        io_uring_sqe_set_data(Sqe, &SocketContext->ShutdownSqe);
+        io_uring_submit(&EventQ->Ring);
+        CxPlatLockRelease(&EventQ->Lock);
+    }
+}
+
+//
+// Datapath binding interface.
+//
+
+QUIC_STATUS
+SocketCreateUdp(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _In_ const CXPLAT_UDP_CONFIG* Config,
+    _Out_ CXPLAT_SOCKET** NewBinding
+    )
+{
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    const BOOLEAN IsServerSocket = Config->RemoteAddress == NULL;
+    const BOOLEAN NumPerProcessorSockets = IsServerSocket && Datapath->PartitionCount > 1;
+    const uint16_t SocketCount = NumPerProcessorSockets ? (uint16_t)CxPlatProcCount() : 1;
+
+    CXPLAT_DBG_ASSERT(Datapath->UdpHandlers.Receive != NULL || Config->Flags & CXPLAT_SOCKET_FLAG_PCP);
+
+    const size_t RawBindingLength =
+        CxPlatGetRawSocketSize() + SocketCount * sizeof(CXPLAT_SOCKET_CONTEXT);
+    CXPLAT_SOCKET_RAW* RawBinding =
+        (CXPLAT_SOCKET_RAW*)CXPLAT_ALLOC_PAGED(RawBindingLength, QUIC_POOL_SOCKET);
+    if (RawBinding == NULL) {
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "CXPLAT_SOCKET",
+            RawBindingLength);
+        goto Exit;
+    }
+    CXPLAT_SOCKET* Binding = CxPlatRawToSocket(RawBinding);
+
+    QuicTraceEvent(
+        DatapathCreated,
+        "[data][%p] Created, local=%!ADDR!, remote=%!ADDR!",
+        Binding,
+        CASTED_CLOG_BYTEARRAY(Config->LocalAddress ? sizeof(*Config->LocalAddress) : 0, Config->LocalAddress),
+        CASTED_CLOG_BYTEARRAY(Config->RemoteAddress ? sizeof(*Config->RemoteAddress) : 0, Config->RemoteAddress));
+
+    CxPlatZeroMemory(RawBinding, RawBindingLength);
+    Binding->Datapath = Datapath;
+    Binding->ClientContext = Config->CallbackContext;
+    Binding->NumPerProcessorSockets = NumPerProcessorSockets;
+    Binding->HasFixedRemoteAddress = (Config->RemoteAddress != NULL);
+    Binding->Mtu = CXPLAT_MAX_MTU;
+    Binding->Type = CXPLAT_SOCKET_UDP;
+    CxPlatRefInitializeEx(&Binding->RefCount, SocketCount);
+    if (Config->LocalAddress) {
+        CxPlatConvertToMappedV6(Config->LocalAddress, &Binding->LocalAddress);
+    } else {
+        Binding->LocalAddress.Ip.sa_family = QUIC_ADDRESS_FAMILY_INET6;
+    }
+    if (Config->Flags & CXPLAT_SOCKET_FLAG_PCP) {
+        Binding->PcpBinding = TRUE;
+    }
+
+    for (uint32_t i = 0; i < SocketCount; i++) {
+        Binding->SocketContexts[i].Binding = Binding;
+        Binding->SocketContexts[i].SocketFd = INVALID_SOCKET;
+        CxPlatRundownInitialize(&Binding->SocketContexts[i].UpcallRundown);
+    }
+
+    for (uint32_t i = 0; i < SocketCount; i++) {
+        Status =
+            CxPlatSocketContextInitialize(
+                &Binding->SocketContexts[i],
+                Config,
+                Config->RemoteAddress ? Config->PartitionIndex : (i % Datapath->PartitionCount));
+        if (QUIC_FAILED(Status)) {
+            goto Exit;
+        }
+    }
+
+    if (IsServerSocket) {
+        //
+        // The return value is being ignored here, as if a system does not support
+        // bpf we still want the server to work. If this happens, the sockets will
+        // round robin, but each flow will be sent to the same socket, just not
+        // based on RSS.
+        //
+        (void)CxPlatSocketConfigureRss(&Binding->SocketContexts[0], SocketCount);
+    }
+
+    CxPlatConvertFromMappedV6(&Binding->LocalAddress, &Binding->LocalAddress);
+    Binding->LocalAddress.Ipv6.sin6_scope_id = 0;
+
+    if (Config->RemoteAddress != NULL) {
+        Binding->RemoteAddress = *Config->RemoteAddress;
+    } else {
+        Binding->RemoteAddress.Ipv4.sin_port = 0;
+    }
+
+    //
+    // Must set output pointer before starting receive path, as the receive path
+    // will try to use the output.
+    //
+    *NewBinding = Binding;
+
+    for (uint32_t i = 0; i < SocketCount; i++) {
+        CxPlatSocketContextStartReceive(&Binding->SocketContexts[i]);
+    }
+
+    Binding = NULL;
+    RawBinding = NULL;
+
+Exit:
+
+    if (RawBinding != NULL) {
+        SocketDelete(CxPlatRawToSocket(RawBinding));
+    }
+
+    return Status;
+}
+
+//
+// TCP is not supported on the io_uring datapath.
+//
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+SocketCreateTcp(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _In_opt_ const QUIC_ADDR* LocalAddress,
+    _In_ const QUIC_ADDR* RemoteAddress,
+    _In_opt_ void* CallbackContext,
+    _Out_ CXPLAT_SOCKET** Socket
+    )
+{
+    UNREFERENCED_PARAMETER(Datapath);
+    UNREFERENCED_PARAMETER(LocalAddress);
+    UNREFERENCED_PARAMETER(RemoteAddress);
+    UNREFERENCED_PARAMETER(CallbackContext);
+    UNREFERENCED_PARAMETER(Socket);
+    return QUIC_STATUS_NOT_SUPPORTED;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+SocketCreateTcpListener(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _In_opt_ const QUIC_ADDR* LocalAddress,
+    _In_opt_ void* CallbackContext,
+    _Out_ CXPLAT_SOCKET** Socket
+    )
+{
+    UNREFERENCED_PARAMETER(Datapath);
+    UNREFERENCED_PARAMETER(LocalAddress);
+    UNREFERENCED_PARAMETER(CallbackContext);
+    UNREFERENCED_PARAMETER(Socket);
+    return QUIC_STATUS_NOT_SUPPORTED;
+}
+
+void
+SocketDelete(
+    _In_ CXPLAT_SOCKET* Socket
+    )
+{
+    CXPLAT_DBG_ASSERT(Socket != NULL);
+    QuicTraceEvent(
+        DatapathDestroyed,
+        "[data][%p] Destroyed",
+        Socket);
+
+#if DEBUG
+    CXPLAT_DBG_ASSERT(!Socket->Uninitialized);
+    Socket->Uninitialized = TRUE;
+#endif
+
+    const uint16_t SocketCount =
+        Socket->NumPerProcessorSockets ? (uint16_t)CxPlatProcCount() : 1;
+
+    for (uint32_t i = 0; i < SocketCount; ++i) {
+        CxPlatSocketContextUninitialize(&Socket->SocketContexts[i]);
+    }
+}
+
+//
+// Receive Path
+//
+
+void
+CxPlatSocketHandleError(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
+    _In_ int ErrNum
+    )
+{
+    QuicTraceEvent(
+        DatapathErrorStatus,
+        "[data][%p] ERROR, %u, %s.",
+        SocketContext->Binding,
+        ErrNum,
+        "Socket error event");
+
+    //
+    // Send unreachable notification to MsQuic if any related
+    // errors were received.
+    //
+    if (ErrNum == ECONNREFUSED ||
+        ErrNum == EHOSTUNREACH ||
+        ErrNum == ENETUNREACH) {
+        if (!SocketContext->Binding->PcpBinding) {
+            SocketContext->Binding->Datapath->UdpHandlers.Unreachable(
+                SocketContext->Binding,
+                SocketContext->Binding->ClientContext,
+                &SocketContext->Binding->RemoteAddress);
+        }
+    }
+}
+
+void
+CxPlatSocketContextRecvComplete(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
+    _In_ DATAPATH_RX_IO_BLOCK* IoBlock,
+    _In_ uint32_t BytesTransferred
+    )
+{
+    CXPLAT_DATAPATH* Datapath = SocketContext->DatapathPartition->Datapath;
+    CXPLAT_DBG_ASSERT(SocketContext->Binding->Datapath == Datapath);
+
+    struct msghdr* RecvMsgHdr = &SocketContext->RecvMsgHdr;
+    struct io_uring_recvmsg_out* RecvOut =
+        io_uring_recvmsg_validate(
+            (uint8_t*)IoBlock + Datapath->RecvBlockBufferOffset,
+            (int)BytesTransferred,
+            RecvMsgHdr);
+    if (RecvOut == NULL) {
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            SocketContext->Binding,
+            BytesTransferred,
+            "io_uring_recvmsg_validate failed");
+        CxPlatRecvBlockReturn(IoBlock);
+        return;
+    }
+
+    const uint32_t PayloadLength =
+        io_uring_recvmsg_payload_length(RecvOut, (int)BytesTransferred, RecvMsgHdr);
+    uint8_t* RecvBuffer = (uint8_t*)io_uring_recvmsg_payload(RecvOut, RecvMsgHdr);
+
+    uint8_t TOS = 0;
+    uint16_t SegmentLength = 0;
+    BOOLEAN FoundLocalAddr = FALSE, FoundTOS = FALSE;
+    QUIC_ADDR* LocalAddr = &IoBlock->Route.LocalAddress;
+    QUIC_ADDR* RemoteAddr = &IoBlock->Route.RemoteAddress;
+    CxPlatZeroMemory(&IoBlock->Route, sizeof(IoBlock->Route));
+    CxPlatCopyMemory(
+        RemoteAddr,
+        io_uring_recvmsg_name(RecvOut),
+        CXPLAT_MIN(RecvOut->namelen, sizeof(*RemoteAddr)));
+    CxPlatConvertFromMappedV6(RemoteAddr, RemoteAddr);
+    IoBlock->Route.State = RouteResolved;
+    IoBlock->Route.Queue = SocketContext;
+
+    //
+    // Process the ancillary control messages to get the local address,
+    // type of service and possibly the GRO segmentation length.
+    //
+    for (struct cmsghdr *CMsg = io_uring_recvmsg_cmsg_firsthdr(RecvOut, RecvMsgHdr);
+         CMsg != NULL;
+         CMsg = io_uring_recvmsg_cmsg_nexthdr(RecvOut, RecvMsgHdr, CMsg)) {
+        if (CMsg->cmsg_level == IPPROTO_IPV6) {
+            if (CMsg->cmsg_type == IPV6_PKTINFO) {
+                struct in6_pktinfo* PktInfo6 = (struct in6_pktinfo*)CMSG_DATA(CMsg);
+                LocalAddr->Ip.sa_family = QUIC_ADDRESS_FAMILY_INET6;
+                LocalAddr->Ipv6.sin6_addr = PktInfo6->ipi6_addr;
+                LocalAddr->Ipv6.sin6_port = SocketContext->Binding->LocalAddress.Ipv6.sin6_port;
+                CxPlatConvertFromMappedV6(LocalAddr, LocalAddr);
+                LocalAddr->Ipv6.sin6_scope_id = PktInfo6->ipi6_ifindex;
+                FoundLocalAddr = TRUE;
+            } else if (CMsg->cmsg_type == IPV6_TCLASS) {
+                CXPLAT_DBG_ASSERT_CMSG(CMsg, uint8_t);
+                TOS = *(uint8_t*)CMSG_DATA(CMsg);
+                FoundTOS = TRUE;
+            } else {
+                CXPLAT_DBG_ASSERT(FALSE);
+            }
+        } else if (CMsg->cmsg_level == IPPROTO_IP) {
+            if (CMsg->cmsg_type == IP_TOS) {
+                CXPLAT_DBG_ASSERT_CMSG(CMsg, uint8_t);
+                TOS = *(uint8_t*)CMSG_DATA(CMsg);
+                FoundTOS = TRUE;
+            } else {
+                CXPLAT_DBG_ASSERT(FALSE);
+            }
+        } else if (CMsg->cmsg_level == IPPROTO_UDP) {
+#ifdef UDP_GRO
+            if (CMsg->cmsg_type == UDP_GRO) {
+                CXPLAT_DBG_ASSERT_CMSG(CMsg, uint16_t);
+                SegmentLength = *(uint16_t*)CMSG_DATA(CMsg);
+            }
+#endif
+        } else {
+            CXPLAT_DBG_ASSERT(FALSE);
+        }
+    }
+
+    CXPLAT_FRE_ASSERT(FoundLocalAddr);
+    CXPLAT_FRE_ASSERT(FoundTOS);
+
+    QuicTraceEvent(
+        DatapathRecv,
+        "[data][%p] Recv %u bytes (segment=%hu) Src=%!ADDR! Dst=%!ADDR!",
+        SocketContext->Binding,
+        PayloadLength,
+        SegmentLength,
+        CASTED_CLOG_BYTEARRAY(sizeof(*LocalAddr), LocalAddr),
+        CASTED_CLOG_BYTEARRAY(sizeof(*RemoteAddr), RemoteAddr));
+
+    if (PayloadLength == 0) {
+        QuicTraceLogWarning(
+            DatapathRecvEmpty,
+            "[data][%p] Dropping datagram with empty payload.",
+            SocketContext->Binding);
+        CxPlatRecvBlockReturn(IoBlock);
+        return;
+    }
+
+    if (SegmentLength == 0) {
+        SegmentLength = (uint16_t)PayloadLength;
+    }
+
+    //
+    // Build up the chain of receive packets to indicate up to the app.
+    //
+    CXPLAT_RECV_DATA* DatagramHead = NULL;
+    CXPLAT_RECV_DATA** DatagramTail = &DatagramHead;
+    DATAPATH_RX_PACKET* Datagram = (DATAPATH_RX_PACKET*)(IoBlock + 1);
+    IoBlock->RefCount = 0;
+    uint32_t Offset = 0;
+    while (Offset < PayloadLength &&
+           IoBlock->RefCount < CXPLAT_MAX_IO_BATCH_SIZE) {
+        IoBlock->RefCount++;
+        Datagram->IoBlock = IoBlock;
+
+        CXPLAT_RECV_DATA* RecvData = &Datagram->Data;
+        RecvData->Next = NULL;
+        RecvData->Route = &IoBlock->Route;
+        RecvData->Buffer = RecvBuffer + Offset;
+        if (PayloadLength - Offset < SegmentLength) {
+            RecvData->BufferLength = (uint16_t)(PayloadLength - Offset);
+        } else {
+            RecvData->BufferLength = SegmentLength;
+        }
+        RecvData->PartitionIndex = SocketContext->DatapathPartition->PartitionIndex;
+        RecvData->TypeOfService = TOS;
+        RecvData->Allocated = TRUE;
+        RecvData->Route->DatapathType = RecvData->DatapathType = CXPLAT_DATAPATH_TYPE_USER;
+        RecvData->QueuedOnConnection = FALSE;
+        RecvData->Reserved = FALSE;
+
+        *DatagramTail = RecvData;
+        DatagramTail = &RecvData->Next;
+
+        Offset += RecvData->BufferLength;
+        Datagram = (DATAPATH_RX_PACKET*)((char*)Datagram + Datapath->RecvBlockStride);
+    }
+
+    if (!SocketContext->Binding->PcpBinding) {
+        CXPLAT_DBG_ASSERT(Datapath->UdpHandlers.Receive);
+        Datapath->UdpHandlers.Receive(
+            SocketContext->Binding,
+            SocketContext->Binding->ClientContext,
+            DatagramHead);
+    } else{
+        CxPlatPcpRecvCallback(
+            SocketContext->Binding,
+            SocketContext->Binding->ClientContext,
+            DatagramHead);
+    }
+}
+
+void
+CxPlatSocketContextProcessRecvCqe(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
+    _In_ const struct io_uring_cqe* Cqe
+    )
+{
+    BOOLEAN Rearm = !(Cqe->flags & IORING_CQE_F_MORE);
+
+    if (Cqe->flags & IORING_CQE_F_BUFFER) {
+        DATAPATH_RX_IO_BLOCK* IoBlock =
+            CxPlatPartitionGetRecvBlock(
+                SocketContext->DatapathPartition,
+                (uint16_t)(Cqe->flags >> IORING_CQE_BUFFER_SHIFT));
+        if (Cqe->res >= 0 && CxPlatRundownAcquire(&SocketContext->UpcallRundown)) {
+            CxPlatSocketContextRecvComplete(SocketContext, IoBlock, (uint32_t)Cqe->res);
+            CxPlatRundownRelease(&SocketContext->UpcallRundown);
+        } else {
+            CxPlatRecvBlockReturn(IoBlock);
+        }
+
+    } else if (Cqe->res == -ENOBUFS) {
+        //
+        // All the provided buffers are currently indicated up. The receive is
+        // rearmed and picks up again once buffers are returned.
+        //
+        QuicTraceLogWarning(
+            DatapathRecvNoBuffers,
+            "[data][%p] Out of provided receive buffers.",
+            SocketContext->Binding);
+
+    } else if (Cqe->res < 0 && Cqe->res != -ECANCELED) {
+        if (Cqe->res == -EINVAL || Cqe->res == -EOPNOTSUPP) {
+            Rearm = FALSE; // Not supported by the kernel; rearming won't help.
+            QuicTraceEvent(
+                DatapathErrorStatus,
+                "[data][%p] ERROR, %u, %s.",
+                SocketContext->Binding,
+                -Cqe->res,
+                "multishot recvmsg failed");
+            CxPlatSocketContextReleaseIo(SocketContext);
+        } else if (CxPlatRundownAcquire(&SocketContext->UpcallRundown)) {
+            CxPlatSocketHandleError(SocketContext, -Cqe->res);
+            CxPlatRundownRelease(&SocketContext->UpcallRundown);
+        }
+    }
+
+    if (Rearm) {
+        //
+        // The multishot receive terminated. Rearm it, unless the socket is
+        // shutting down. The new SQE is submitted with the next dequeue.
+        //
+        CXPLAT_EVENTQ* EventQ = SocketContext->DatapathPartition->EventQ;
+        CxPlatLockAcquire(&EventQ->Lock);
+        if (!SocketContext->ShuttingDown) {
+            Rearm = CxPlatSocketContextArmReceive(SocketContext);
+        } else {
+            Rearm = FALSE;
+        }
+        CxPlatLockRelease(&EventQ->Lock);
+        if (!Rearm) {
+            CxPlatSocketContextReleaseIo(SocketContext);
+        }
+    }
+}
+
+void
+RecvDataReturn(
+    _In_ CXPLAT_RECV_DATA* RecvDataChain
+    )
+{
+    CXPLAT_RECV_DATA* Datagram;
+    while ((Datagram = RecvDataChain) != NULL) {
+        RecvDataChain = RecvDataChain->Next;
+        DATAPATH_RX_PACKET* Packet =
+            CXPLAT_CONTAINING_RECORD(Datagram, DATAPATH_RX_PACKET, Data);
+        if (InterlockedDecrement(&Packet->IoBlock->RefCount) == 0) {
+            CxPlatRecvBlockReturn(Packet->IoBlock);
+        }
+    }
+}
+
+//
+// Send Path
+//
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Success_(return != NULL)
+CXPLAT_SEND_DATA*
+SendDataAlloc(
+    _In_ CXPLAT_SOCKET* Socket,
+    _Inout_ CXPLAT_SEND_CONFIG* Config
+    )
+{
+    CXPLAT_DBG_ASSERT(Socket != NULL);
+    CXPLAT_DBG_ASSERT(Config->MaxPacketSize <= MAX_UDP_PAYLOAD_LENGTH);
+    if (Config->Route->Queue == NULL) {
+        Config->Route->Queue = &Socket->SocketContexts[0];
+    }
+
+    CXPLAT_SOCKET_CONTEXT* SocketContext = Config->Route->Queue;
+    CXPLAT_DATAPATH_PARTITION* DatapathPartition = SocketContext->DatapathPartition;
+    CXPLAT_DBG_ASSERT(SocketContext->Binding == Socket);
+    CXPLAT_DBG_ASSERT(SocketContext->Binding->Datapath == DatapathPartition->Datapath);
+
+    CXPLAT_SEND_DATA* SendData = CxPlatPoolAlloc(&DatapathPartition->SendBlockPool);
+    if (SendData != NULL) {
+        SendData->Sqe.CqeType = CXPLAT_CQE_TYPE_SOCKET_SEND;
+        SendData->SocketContext = SocketContext;
+        SendData->ClientBuffer.Buffer = SendData->Buffer;
+        SendData->ClientBuffer.Length = 0;
+        SendData->TotalSize = 0;
+        SendData->SegmentSize =
+            (Socket->Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION)
+                ? Config->MaxPacketSize : 0;
+        SendData->BufferCount = 0;
+        SendData->PendingOps = 0;
+        SendData->ControlBufferLength = 0;
+        SendData->ECN = Config->ECN;
+        SendData->Flags = Config->Flags;
+        SendData->OnConnectedSocket = Socket->Connected;
+        SendData->SegmentationSupported =
+            !!(Socket->Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION);
+        SendData->ZeroCopy = FALSE;
+        SendData->Msgs[0].Iov.iov_len = 0;
+        SendData->Msgs[0].Iov.iov_base = SendData->Buffer;
+        SendData->DatapathType = Config->Route->DatapathType = CXPLAT_DATAPATH_TYPE_USER;
+    }
+
+    return SendData;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+SendDataFree(
+    _In_ CXPLAT_SEND_DATA* SendData
+    )
+{
+    CXPLAT_DATAPATH_PARTITION* DatapathPartition = SendData->SocketContext->DatapathPartition;
+    CxPlatPoolFree(&DatapathPartition->SendBlockPool, SendData);
+}
+
+static
+void
+CxPlatSendDataFinalizeSendBuffer(
+    _In_ CXPLAT_SEND_DATA* SendData
+    )
+{
+    if (SendData->ClientBuffer.Length == 0) { // No buffer to finalize.
+        return;
+    }
+
+    CXPLAT_DBG_ASSERT(SendData->SegmentSize == 0 || SendData->ClientBuffer.Length <= SendData->SegmentSize);
+    CXPLAT_DBG_ASSERT(SendData->TotalSize + SendData->ClientBuffer.Length <= sizeof(SendData->Buffer));
+
+    SendData->BufferCount++;
+    SendData->TotalSize += SendData->ClientBuffer.Length;
+    if (SendData->SegmentationSupported) {
+        SendData->Msgs[0].Iov.iov_len += SendData->ClientBuffer.Length;
+        if (SendData->SegmentSize == 0 ||
+            SendData->ClientBuffer.Length < SendData->SegmentSize ||
+            SendData->TotalSize + SendData->SegmentSize > sizeof(SendData->Buffer)) {
+            SendData->ClientBuffer.Buffer = NULL;
+        } else {
+            SendData->ClientBuffer.Buffer += SendData->SegmentSize;
+        }
+    } else {
+        struct iovec* IoVec = &SendData->Msgs[SendData->BufferCount - 1].Iov;
+        IoVec->iov_base = SendData->ClientBuffer.Buffer;
+        IoVec->iov_len = SendData->ClientBuffer.Length;
+        if (SendData->TotalSize + SendData->SegmentSize > sizeof(SendData->Buffer) ||
+            SendData->BufferCount == SendData->SocketContext->DatapathPartition->Datapath->SendIoVecCount) {
+            SendData->ClientBuffer.Buffer = NULL;
+        } else {
+            SendData->ClientBuffer.Buffer += SendData->ClientBuffer.Length;
+        }
+    }
+    SendData->ClientBuffer.Length = 0;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Success_(return != NULL)
+QUIC_BUFFER*
+SendDataAllocBuffer(
+    _In_ CXPLAT_SEND_DATA* SendData,
+    _In_ uint16_t MaxBufferLength
+    )
+{
+    CXPLAT_DBG_ASSERT(SendData != NULL);
+    CXPLAT_DBG_ASSERT(MaxBufferLength > 0);
+    CxPlatSendDataFinalizeSendBuffer(SendData);
+    CXPLAT_DBG_ASSERT(SendData->SegmentSize == 0 || SendData->SegmentSize >= MaxBufferLength);
+    CXPLAT_DBG_ASSERT(SendData->TotalSize + MaxBufferLength <= sizeof(SendData->Buffer));
+    CXPLAT_DBG_ASSERT(
+        SendData->SegmentationSupported ||
+        SendData->BufferCount < SendData->SocketContext->DatapathPartition->Datapath->SendIoVecCount);
+    UNREFERENCED_PARAMETER(MaxBufferLength);
+    if (SendData->ClientBuffer.Buffer == NULL) {
+        return NULL;
+    }
+    SendData->ClientBuffer.Length = MaxBufferLength;
+    return &SendData->ClientBuffer;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+SendDataFreeBuffer(
+    _In_ CXPLAT_SEND_DATA* SendData,
+    _In_ QUIC_BUFFER* Buffer
+    )
+{
+    //
+    // This must be the final send buffer; intermediate buffers cannot be freed.
+    //
+    CXPLAT_DBG_ASSERT(Buffer == &SendData->ClientBuffer);
+    Buffer->Length = 0;
+    UNREFERENCED_PARAMETER(SendData);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+SendDataIsFull(
+    _In_ CXPLAT_SEND_DATA* SendData
+    )
+{
+    CxPlatSendDataFinalizeSendBuffer(SendData);
+    return SendData->ClientBuffer.Buffer == NULL;
+}
+
+//
+// This is defined and used instead of CMSG_NXTHDR because (1) we've already
+// done the work to ensure the necessary space is available and (2) CMSG_NXTHDR
+// apparently not only checks there is enough space to move to the next pointer
+// but somehow assumes the next pointer has been writen already (?!) and tries
+// to validate its length as well. That would work if you're reading an already
+// populated buffer, but not if you're building one up (unless you've zero-init
+// the entire buffer).
+//
+#define CXPLAT_CMSG_NXTHDR(cmsg) \
+    (struct cmsghdr*)((uint8_t*)cmsg + CMSG_ALIGN(cmsg->cmsg_len))
+
+void
+CxPlatSendDataPopulateAncillaryData(
+    _In_ CXPLAT_SEND_DATA* SendData,
+    _Inout_ struct msghdr* Mhdr
+    )
+{
+    Mhdr->msg_controllen = CMSG_SPACE(sizeof(int));
+    struct cmsghdr *CMsg = CMSG_FIRSTHDR(Mhdr);
+    CMsg->cmsg_level = SendData->LocalAddress.Ip.sa_family == AF_INET ? IPPROTO_IP : IPPROTO_IPV6;
+    CMsg->cmsg_type = SendData->LocalAddress.Ip.sa_family == AF_INET ? IP_TOS : IPV6_TCLASS;
+    CMsg->cmsg_len = CMSG_LEN(sizeof(int));
+    *(int*)CMSG_DATA(CMsg) = SendData->ECN;
+
+    if (!SendData->OnConnectedSocket) {
+        if (SendData->LocalAddress.Ip.sa_family == AF_INET) {
+            Mhdr->msg_controllen += CMSG_SPACE(sizeof(struct in_pktinfo));
+            CMsg = CXPLAT_CMSG_NXTHDR(CMsg);
+            CMsg->cmsg_level = IPPROTO_IP;
+            CMsg->cmsg_type = IP_PKTINFO;
+            CMsg->cmsg_len = CMSG_LEN(sizeof(struct in_pktinfo));
+            struct in_pktinfo *PktInfo = (struct in_pktinfo*)CMSG_DATA(CMsg);
+            PktInfo->ipi_ifindex = SendData->LocalAddress.Ipv6.sin6_scope_id;
+            PktInfo->ipi_spec_dst = SendData->LocalAddress.Ipv4.sin_addr;
+            PktInfo->ipi_addr = SendData->LocalAddress.Ipv4.sin_addr;
+        } else {
+            Mhdr->msg_controllen += CMSG_SPACE(sizeof(struct in6_pktinfo));
+            CMsg = CXPLAT_CMSG_NXTHDR(CMsg);
+            CMsg->cmsg_level = IPPROTO_IPV6;
+            CMsg->cmsg_type = IPV6_PKTINFO;
+            CMsg->cmsg_len = CMSG_LEN(sizeof(struct in6_pktinfo));
+            struct in6_pktinfo *PktInfo6 = (struct in6_pktinfo*)CMSG_DATA(CMsg);
+            PktInfo6->ipi6_ifindex = SendData->LocalAddress.Ipv6.sin6_scope_id;
+            PktInfo6->ipi6_addr = SendData->LocalAddress.Ipv6.sin6_addr;
+        }
+    }
+
+#ifdef UDP_SEGMENT
+    if (SendData->SegmentationSupported && SendData->SegmentSize > 0) {
+        Mhdr->msg_controllen += CMSG_SPACE(sizeof(uint16_t));
+        CMsg = CXPLAT_CMSG_NXTHDR(CMsg);
+        CMsg->cmsg_level = SOL_UDP;
+        CMsg->cmsg_type = UDP_SEGMENT;
+        CMsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+        *((uint16_t*)CMSG_DATA(CMsg)) = SendData->SegmentSize;
+    }
+#endif
+
+    CXPLAT_DBG_ASSERT(Mhdr->msg_controllen <= sizeof(SendData->ControlBuffer));
+    SendData->ControlBufferLength = (uint8_t)Mhdr->msg_controllen;
+}
+
+//
+// Queues up a single send operation. Must be called with the event queue lock
+// held.
+//
+static
+BOOLEAN
+CxPlatSendDataPrepareSqe(
+    _In_ CXPLAT_SEND_DATA* SendData,
+    _In_ const struct msghdr* Mhdr
+    )
+{
+    CXPLAT_SOCKET_CONTEXT* SocketContext = SendData->SocketContext;
+    CXPLAT_DATAPATH* Datapath = SocketContext->DatapathPartition->Datapath;
+
+    struct io_uring_sqe* Sqe = CxPlatEventQGetSqe(SocketContext->DatapathPartition->EventQ);
+    if (Sqe == NULL) {
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            SocketContext->Binding,
+            QUIC_STATUS_OUT_OF_MEMORY,
+            "io_uring_get_sqe failed");
+        return FALSE;
+    }
+
+    SendData->ZeroCopy =
+        Datapath->SendZeroCopySupported &&
+        SendData->SegmentationSupported &&
+        SendData->TotalSize >= CXPLAT_SEND_ZERO_COPY_THRESHOLD;
+
+    //
+    // Zero-copy sendmsg can't send from registered (fixed) buffers; the
+    // kernel only allows those for plain sends, which can't carry the
+    // ancillary data. The pages are pinned for each send instead.
+    //
+    if (SendData->ZeroCopy) {
+        io_uring_prep_sendmsg_zc(Sqe, SocketContext->SocketFd, Mhdr, 0);
+    } else {
+        io_uring_prep_sendmsg(Sqe, SocketContext->SocketFd, Mhdr, 0);
+    }
+    io_uring_sqe_set_data(Sqe, &SendData->Sqe);
+    return TRUE;
+}
+
+void
+CxPlatSendDataSubmit(
+    _In_ CXPLAT_SEND_DATA* SendData
+    )
+{
+    CXPLAT_SOCKET_CONTEXT* SocketContext = SendData->SocketContext;
+    CXPLAT_EVENTQ* EventQ = SocketContext->DatapathPartition->EventQ;
+
+    //
+    // With GSO the whole payload goes out in a single sendmsg; otherwise each
+    // packet is its own message. io_uring has no equivalent of sendmmsg, so
+    // that takes an SQE per packet, but they are all submitted together with
+    // a single io_uring_submit call.
+    //
+    const uint16_t MessageCount =
+        SendData->SegmentationSupported ? 1 : SendData->BufferCount;
+    for (uint16_t i = 0; i < MessageCount; ++i) {
+        struct msghdr* Mhdr = &SendData->Msgs[i].Hdr;
+        Mhdr->msg_name = (void*)&SendData->RemoteAddress;
+        Mhdr->msg_namelen = sizeof(SendData->RemoteAddress);
+        Mhdr->msg_iov = &SendData->Msgs[i].Iov;
+        Mhdr->msg_iovlen = 1;
+        Mhdr->msg_flags = 0;
+        Mhdr->msg_control = SendData->ControlBuffer;
+        if (SendData->ControlBufferLength == 0) {
+            CxPlatSendDataPopulateAncillaryData(SendData, Mhdr);
+        } else {
+            Mhdr->msg_controllen = SendData->ControlBufferLength;
+        }
+    }
+
+    InterlockedIncrement(&SocketContext->OutstandingIo);
+    SendData->PendingOps = MessageCount;
+
+    CxPlatLockAcquire(&EventQ->Lock);
+    uint16_t Prepared = 0;
+    while (Prepared < MessageCount &&
+           CxPlatSendDataPrepareSqe(SendData, &SendData->Msgs[Prepared].Hdr)) {
+        ++Prepared;
+    }
+    SendData->PendingOps = Prepared;
+    if (Prepared != 0) {
+        io_uring_submit(&EventQ->Ring);
+    }
+    CxPlatLockRelease(&EventQ->Lock);
+
+    if (Prepared == 0) {
+        SendDataFree(SendData);
+        CxPlatSocketContextReleaseIo(SocketContext);
+    }
+}
+
+void
+SocketSend(
+    _In_ CXPLAT_SOCKET* Socket,
+    _In_ const CXPLAT_ROUTE* Route,
+    _In_ CXPLAT_SEND_DATA* SendData
+    )
+{
+    UNREFERENCED_PARAMETER(Socket);
+
+    //
+    // Finalize the state of the send data and log the send.
+    //
+    CxPlatSendDataFinalizeSendBuffer(SendData);
+    QuicTraceEvent(
+        DatapathSend,
+        "[data][%p] Send %u bytes in %hhu buffers (segment=%hu) Dst=%!ADDR!, Src=%!ADDR!",
+        Socket,
+        SendData->TotalSize,
+        SendData->BufferCount,
+        SendData->SegmentSize,
+        CASTED_CLOG_BYTEARRAY(sizeof(Route->RemoteAddress), &Route->RemoteAddress),
+        CASTED_CLOG_BYTEARRAY(sizeof(Route->LocalAddress), &Route->LocalAddress));
+
+    //
+    // Cache the address, mapping the remote address as necessary.
+    //
+    CxPlatConvertToMappedV6(&Route->RemoteAddress, &SendData->RemoteAddress);
+    SendData->LocalAddress = Route->LocalAddress;
+
+    CxPlatSendDataSubmit(SendData);
+}
+
+//
+// Handles a send that failed because an optional send feature isn't actually
+// supported, by turning the feature off and resubmitting. Returns TRUE if the
+// send was resubmitted.
+//
+static
+BOOLEAN
+CxPlatSendDataRetry(
+    _In_ CXPLAT_SEND_DATA* SendData,
+    _In_ int ErrNum
+    )
+{
+    CXPLAT_SOCKET_CONTEXT* SocketContext = SendData->SocketContext;
+    CXPLAT_DATAPATH* Datapath = SocketContext->DatapathPartition->Datapath;
+
+    if (!SendData->ZeroCopy || (ErrNum != EINVAL && ErrNum != EOPNOTSUPP)) {
+        return FALSE;
+    }
+
+    QuicTraceEvent(
+        LibraryError,
+        "[ lib] ERROR, %s.",
+        "Disabling io_uring zero-copy sends globally");
+    Datapath->SendZeroCopySupported = FALSE;
+
+    CXPLAT_DBG_ASSERT(SendData->SegmentationSupported); // Only a single message.
+    CXPLAT_EVENTQ* EventQ = SocketContext->DatapathPartition->EventQ;
+    CxPlatLockAcquire(&EventQ->Lock);
+    BOOLEAN Resubmitted = CxPlatSendDataPrepareSqe(SendData, &SendData->Msgs[0].Hdr);
+    CxPlatLockRelease(&EventQ->Lock);
+    return Resubmitted;
+}
+
+void
+CxPlatSendDataHandleError(
+    _In_ CXPLAT_SEND_DATA* SendData,
+    _In_ int ErrNum
+    )
+{
+    CXPLAT_SOCKET_CONTEXT* SocketContext = SendData->SocketContext;
+
+    QuicTraceEvent(
+        DatapathErrorStatus,
+        "[data][%p] ERROR, %u, %s.",
+        SocketContext->Binding,
+        ErrNum,
+        SendData->SegmentationSupported ? "sendmsg (GSO) failed" : "sendmsg failed");
+
+    if (ErrNum == EIO &&
+        SocketContext->Binding->Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION) {
+        //
+        // EIO generally indicates the GSO isn't supported by the NIC,
+        // so disable segmentation on the datapath globally.
+        //
+        QuicTraceEvent(
+            LibraryError,
+            "[ lib] ERROR, %s.",
+            "Disabling segmentation support globally");
+        SocketContext->Binding->Datapath->Features &=
+            ~CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION;
+    }
+
+    //
+    // Send unreachable notification to MsQuic if any related
+    // errors were received.
+    //
+    if (ErrNum == ECONNREFUSED ||
+        ErrNum == EHOSTUNREACH ||
+        ErrNum == ENETUNREACH) {
+        if (!SocketContext->Binding->PcpBinding &&
+            CxPlatRundownAcquire(&SocketContext->UpcallRundown)) {
+            SocketContext->Binding->Datapath->UdpHandlers.Unreachable(
+                SocketContext->Binding,
+                SocketContext->Binding->ClientContext,
+                &SocketContext->Binding->RemoteAddress);
+            CxPlatRundownRelease(&SocketContext->UpcallRundown);
+        }
+    }
+}
+
+void
+CxPlatSendDataProcessCqe(
+    _In_ CXPLAT_SEND_DATA* SendData,
+    _In_ const struct io_uring_cqe* Cqe
+    )
+{
+    if (Cqe->flags & IORING_CQE_F_MORE) {
+        //
+        // The zero-copy send completed, but the kernel still references the
+        // buffer until the notification arrives.
+        //
+        if (Cqe->res < 0) {
+            CxPlatSendDataHandleError(SendData, -Cqe->res);
+        } else {
+            SendData->SocketContext->DatapathPartition->SendZeroCopyCount++;
+        }
+        return;
+    }
+
+    if (!(Cqe->flags & IORING_CQE_F_NOTIF) && Cqe->res < 0) {
+        if (CxPlatSendDataRetry(SendData, -Cqe->res)) {
+            return;
+        }
+        CxPlatSendDataHandleError(SendData, -Cqe->res);
+    }
+
+    CXPLAT_DBG_ASSERT(SendData->PendingOps > 0);
+    if (--SendData->PendingOps == 0) {
+        CXPLAT_SOCKET_CONTEXT* SocketContext = SendData->SocketContext;
+        SendDataFree(SendData);
+        CxPlatSocketContextReleaseIo(SocketContext);
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatSocketGetTcpStatistics(
+    _In_ CXPLAT_SOCKET* Socket,
+    _Out_ CXPLAT_TCP_STATISTICS* Statistics
+    )
+{
+    UNREFERENCED_PARAMETER(Socket);
+    UNREFERENCED_PARAMETER(Statistics);
+    return QUIC_STATUS_NOT_SUPPORTED;
+}
+
+void
+DataPathProcessCqe(
+    _In_ CXPLAT_CQE* Cqe
+    )
+{
+    switch (CxPlatCqeType(Cqe)) {
+    case CXPLAT_CQE_TYPE_SOCKET_SHUTDOWN: {
+        //
+        // The cancellation of the multishot receive completed, which releases
+        // the socket's own reference on its outstanding IO.
+        //
+        CXPLAT_SOCKET_CONTEXT* SocketContext =
+            CXPLAT_CONTAINING_RECORD(CxPlatCqeUserData(Cqe), CXPLAT_SOCKET_CONTEXT, ShutdownSqe);
+        CxPlatSocketContextReleaseIo(SocketContext);
+        break;
+    }
+    case CXPLAT_CQE_TYPE_SOCKET_IO: {
+        CXPLAT_SOCKET_CONTEXT* SocketContext =
+            CXPLAT_CONTAINING_RECORD(CxPlatCqeUserData(Cqe), CXPLAT_SOCKET_CONTEXT, IoSqe);
+        CxPlatSocketContextProcessRecvCqe(SocketContext, *Cqe);
+        break;
+    }
+    case CXPLAT_CQE_TYPE_SOCKET_SEND: {
+        CXPLAT_SEND_DATA* SendData =
+            CXPLAT_CONTAINING_RECORD(CxPlatCqeUserData(Cqe), CXPLAT_SEND_DATA, Sqe);
+        CxPlatSendDataProcessCqe(SendData, *Cqe);
+        break;
+    }
+    }
+}
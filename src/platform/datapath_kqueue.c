@@ -590,6 +590,33 @@ CxPlatDataPathIsPaddingPreferred(
     return !!(Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION);
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatDataPathGetStatistics(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _Out_ CXPLAT_DATAPATH_STATISTICS* Statistics
+    )
+{
+    UNREFERENCED_PARAMETER(Datapath);
+    CxPlatZeroMemory(Statistics, sizeof(*Statistics));
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Success_(QUIC_SUCCEEDED(return))
+QUIC_STATUS
+CxPlatDataPathRssConfigGet(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _In_ const QUIC_ADDR* LocalAddress,
+    _Outptr_ _At_(*RssConfig, __drv_allocatesMem(Mem))
+        CXPLAT_RSS_CONFIG** RssConfig
+    )
+{
+    UNREFERENCED_PARAMETER(Datapath);
+    UNREFERENCED_PARAMETER(LocalAddress);
+    *RssConfig = NULL;
+    return QUIC_STATUS_NOT_SUPPORTED;
+}
+
 DATAPATH_RX_IO_BLOCK*
 CxPlatDataPathAllocRxIoBlock(
     _In_ CXPLAT_DATAPATH_PARTITION* DatapathPartition
@@ -10,6 +10,11 @@ Abstract:
 --*/
 
 #include "platform_internal.h"
+#include <ifaddrs.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <linux/ethtool.h>
+#include <linux/sockios.h>
 
 #ifdef QUIC_CLOG
 #include "datapath_linux.c.clog.h"
@@ -34,7 +39,8 @@ CxPlatDataPathProcessCqe(
     _In_ CXPLAT_CQE* Cqe
     )
 {
-    if (CXPLAT_CQE_TYPE_XDP_SHUTDOWN <= CxPlatCqeType(Cqe)) {
+    if (CXPLAT_CQE_TYPE_XDP_SHUTDOWN <= CxPlatCqeType(Cqe) &&
+        CxPlatCqeType(Cqe) <= CXPLAT_CQE_TYPE_XDP_FLUSH_TX) {
         RawDataPathProcessCqe(Cqe);
     } else {
         DataPathProcessCqe(Cqe);
@@ -54,3 +60,192 @@ CxPlatUpdateRoute(
         RawUpdateRoute(DstRoute, SrcRoute);
     }
 }
+
+//
+// Finds the name of the interface that owns the local address.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+BOOLEAN
+CxPlatGetInterfaceName(
+    _In_ const QUIC_ADDR* LocalAddress,
+    _Out_writes_(IFNAMSIZ) char* InterfaceName
+    )
+{
+    struct ifaddrs* IfAddrs;
+    BOOLEAN Found = FALSE;
+    if (getifaddrs(&IfAddrs) == -1) {
+        return FALSE;
+    }
+
+    for (struct ifaddrs* Iter = IfAddrs; Iter != NULL && !Found; Iter = Iter->ifa_next) {
+        if (Iter->ifa_addr == NULL ||
+            Iter->ifa_addr->sa_family != QuicAddrGetFamily(LocalAddress)) {
+            continue;
+        }
+        if (Iter->ifa_addr->sa_family == AF_INET) {
+            Found =
+                memcmp(
+                    &((struct sockaddr_in*)Iter->ifa_addr)->sin_addr,
+                    &LocalAddress->Ipv4.sin_addr,
+                    sizeof(LocalAddress->Ipv4.sin_addr)) == 0;
+        } else {
+            Found =
+                memcmp(
+                    &((struct sockaddr_in6*)Iter->ifa_addr)->sin6_addr,
+                    &LocalAddress->Ipv6.sin6_addr,
+                    sizeof(LocalAddress->Ipv6.sin6_addr)) == 0;
+        }
+        if (Found) {
+            strncpy(InterfaceName, Iter->ifa_name, IFNAMSIZ - 1);
+            InterfaceName[IFNAMSIZ - 1] = '\0';
+        }
+    }
+
+    freeifaddrs(IfAddrs);
+    return Found;
+}
+
+//
+// Queries whether the UDP ports are part of the RSS hash input for the flow
+// type.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+BOOLEAN
+CxPlatIsUdpPortHashed(
+    _In_ int Socket,
+    _Inout_ struct ifreq* IfReq,
+    _In_ uint32_t FlowType
+    )
+{
+    struct ethtool_rxnfc RxFlowHash = {0};
+    RxFlowHash.cmd = ETHTOOL_GRXFH;
+    RxFlowHash.flow_type = FlowType;
+    IfReq->ifr_data = (char*)&RxFlowHash;
+    return
+        ioctl(Socket, SIOCETHTOOL, IfReq) == 0 &&
+        (RxFlowHash.data & (RXH_L4_B_0_1 | RXH_L4_B_2_3)) == (RXH_L4_B_0_1 | RXH_L4_B_2_3);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Success_(QUIC_SUCCEEDED(return))
+QUIC_STATUS
+CxPlatDataPathRssConfigGet(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _In_ const QUIC_ADDR* LocalAddress,
+    _Outptr_ _At_(*RssConfig, __drv_allocatesMem(Mem))
+        CXPLAT_RSS_CONFIG** RssConfig
+    )
+{
+    UNREFERENCED_PARAMETER(Datapath);
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    struct ethtool_rxfh* RxFh = NULL;
+    struct ifreq IfReq = {0};
+    *RssConfig = NULL;
+
+    if (!CxPlatGetInterfaceName(LocalAddress, IfReq.ifr_name)) {
+        return QUIC_STATUS_NOT_FOUND;
+    }
+
+    int Socket = socket(AF_INET, SOCK_DGRAM, 0);
+    if (Socket == INVALID_SOCKET) {
+        Status = errno;
+        QuicTraceEvent(
+            LibraryErrorStatus,
+            "[ lib] ERROR, %u, %s.",
+            Status,
+            "socket failed");
+        return Status;
+    }
+
+    //
+    // The first query only returns the sizes of the indirection table and key.
+    //
+    struct ethtool_rxfh RxFhSizes = {0};
+    RxFhSizes.cmd = ETHTOOL_GRSSH;
+    IfReq.ifr_data = (char*)&RxFhSizes;
+    if (ioctl(Socket, SIOCETHTOOL, &IfReq) != 0) {
+        Status = errno == EOPNOTSUPP ? QUIC_STATUS_NOT_SUPPORTED : (QUIC_STATUS)errno;
+        goto Exit;
+    }
+
+    if (RxFhSizes.indir_size == 0 || RxFhSizes.key_size == 0) {
+        Status = QUIC_STATUS_NOT_SUPPORTED;
+        goto Exit;
+    }
+
+    const size_t RxFhLength =
+        sizeof(*RxFh) + RxFhSizes.indir_size * sizeof(uint32_t) + RxFhSizes.key_size;
+    RxFh = CXPLAT_ALLOC_PAGED(RxFhLength, QUIC_POOL_DATAPATH_RSS_CONFIG);
+    if (RxFh == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "ethtool_rxfh",
+            RxFhLength);
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        goto Exit;
+    }
+
+    CxPlatZeroMemory(RxFh, RxFhLength);
+    RxFh->cmd = ETHTOOL_GRSSH;
+    RxFh->indir_size = RxFhSizes.indir_size;
+    RxFh->key_size = RxFhSizes.key_size;
+    IfReq.ifr_data = (char*)RxFh;
+    if (ioctl(Socket, SIOCETHTOOL, &IfReq) != 0) {
+        Status = errno;
+        goto Exit;
+    }
+
+    //
+    // Only Toeplitz is supported (bit 0, ETH_RSS_HASH_TOP). Drivers that don't
+    // report the hash function are assumed to use it.
+    //
+    if (RxFh->hfunc != 0 && !(RxFh->hfunc & 0x1)) {
+        Status = QUIC_STATUS_NOT_SUPPORTED;
+        goto Exit;
+    }
+
+    const size_t RssConfigLength =
+        sizeof(CXPLAT_RSS_CONFIG) + RxFh->indir_size * sizeof(uint32_t) + RxFh->key_size;
+    CXPLAT_RSS_CONFIG* Config = CXPLAT_ALLOC_PAGED(RssConfigLength, QUIC_POOL_DATAPATH_RSS_CONFIG);
+    if (Config == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "CXPLAT_RSS_CONFIG",
+            RssConfigLength);
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        goto Exit;
+    }
+
+    Config->HashTypes = 0;
+    if (CxPlatIsUdpPortHashed(Socket, &IfReq, UDP_V4_FLOW)) {
+        Config->HashTypes |= CXPLAT_RSS_HASH_TYPE_UDP_IPV4;
+    }
+    if (CxPlatIsUdpPortHashed(Socket, &IfReq, UDP_V6_FLOW)) {
+        Config->HashTypes |= CXPLAT_RSS_HASH_TYPE_UDP_IPV6;
+    }
+    Config->RssIndirectionTableCount = RxFh->indir_size;
+    Config->RssIndirectionTable = (uint32_t*)(Config + 1);
+    CxPlatCopyMemory(
+        Config->RssIndirectionTable,
+        RxFh->rss_config,
+        RxFh->indir_size * sizeof(uint32_t));
+    Config->RssSecretKeyLength = RxFh->key_size;
+    Config->RssSecretKey = (uint8_t*)(Config->RssIndirectionTable + RxFh->indir_size);
+    CxPlatCopyMemory(
+        Config->RssSecretKey,
+        (uint8_t*)(RxFh->rss_config + RxFh->indir_size),
+        RxFh->key_size);
+    *RssConfig = Config;
+
+Exit:
+
+    if (RxFh != NULL) {
+        CXPLAT_FREE(RxFh, QUIC_POOL_DATAPATH_RSS_CONFIG);
+    }
+    close(Socket);
+    return Status;
+}
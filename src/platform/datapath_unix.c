@@ -51,6 +51,15 @@ CxPlatDataPathGetGatewayAddresses(
     return QUIC_STATUS_NOT_SUPPORTED;
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatDataPathRssConfigFree(
+    _In_ __drv_freesMem(Mem) CXPLAT_RSS_CONFIG* RssConfig
+    )
+{
+    CXPLAT_FREE(RssConfig, QUIC_POOL_DATAPATH_RSS_CONFIG);
+}
+
 // private func
 void
 CxPlatDataPathPopulateTargetAddress(
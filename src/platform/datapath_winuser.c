@@ -1081,6 +1081,17 @@ DataPathIsPaddingPreferred(
     return !!(Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION);
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+DataPathGetStatistics(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _Out_ CXPLAT_DATAPATH_STATISTICS* Statistics
+    )
+{
+    UNREFERENCED_PARAMETER(Datapath);
+    CxPlatZeroMemory(Statistics, sizeof(*Statistics));
+}
+
 void
 CxPlatSocketArmRioNotify(
     _In_ CXPLAT_SOCKET_PROC* SocketProc
@@ -123,6 +123,16 @@ CxPlatDataPathIsPaddingPreferred(
             DataPathIsPaddingPreferred(Datapath) : RawDataPathIsPaddingPreferred(Datapath);
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatDataPathGetStatistics(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _Out_ CXPLAT_DATAPATH_STATISTICS* Statistics
+    )
+{
+    DataPathGetStatistics(Datapath, Statistics);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 CxPlatSocketCreateUdp(
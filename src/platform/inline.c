@@ -55,6 +55,18 @@ CxPlatPoolFree(
     _In_ void* Entry
     );
 
+CXPLAT_POOL_MAGAZINE*
+CxPlatPoolCacheAcquire(
+    _Inout_ CXPLAT_POOL* Pool,
+    _Inout_ CXPLAT_POOL_CACHE* Cache
+    );
+
+void
+CxPlatPoolCacheRelease(
+    _Inout_ CXPLAT_POOL_CACHE* Cache,
+    _In_ CXPLAT_POOL_MAGAZINE* Magazine
+    );
+
 BOOLEAN
 CxPlatPoolPrune(
     _Inout_ CXPLAT_POOL* Pool
@@ -426,6 +438,18 @@ _CxPlatEventQEnqueue(
     );
 #endif
 
+#if CXPLAT_USE_IO_URING
+struct io_uring_sqe*
+CxPlatEventQGetSqe(
+    _In_ CXPLAT_EVENTQ* queue
+    );
+
+void
+CxPlatEventQSubmitPending(
+    _In_ CXPLAT_EVENTQ* queue
+    );
+#endif
+
 uint32_t
 CxPlatEventQDequeue(
     _In_ CXPLAT_EVENTQ* queue,
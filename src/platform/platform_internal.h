@@ -155,6 +155,11 @@ typedef struct CX_PLATFORM {
     // Count of allocations.
     //
     long AllocCounter;
+
+    //
+    // Time returned by the platform clock, in microseconds, if nonzero.
+    //
+    uint64_t TimeOverride;
 #endif
 
 } CX_PLATFORM;
@@ -194,6 +199,11 @@ typedef struct CX_PLATFORM {
     // Count of allocations.
     //
     long AllocCounter;
+
+    //
+    // Time returned by the platform clock, in microseconds, if nonzero.
+    //
+    uint64_t TimeOverride;
 #endif
 
 } CX_PLATFORM;
@@ -552,6 +562,11 @@ typedef struct CX_PLATFORM {
     // Count of allocations.
     //
     long AllocCounter;
+
+    //
+    // Time returned by the platform clock, in microseconds, if nonzero.
+    //
+    uint64_t TimeOverride;
 #endif
 
 } CX_PLATFORM;
@@ -691,6 +706,7 @@ CxPlatDpRawGetDatapathSize(
 #define CXPLAT_CQE_TYPE_XDP_SHUTDOWN        CXPLAT_CQE_TYPE_QUIC_BASE + 6
 #define CXPLAT_CQE_TYPE_XDP_IO              CXPLAT_CQE_TYPE_QUIC_BASE + 7
 #define CXPLAT_CQE_TYPE_XDP_FLUSH_TX        CXPLAT_CQE_TYPE_QUIC_BASE + 8
+#define CXPLAT_CQE_TYPE_SOCKET_SEND         CXPLAT_CQE_TYPE_QUIC_BASE + 9
 
 #if defined(CX_PLATFORM_LINUX)
 
@@ -763,6 +779,50 @@ typedef struct QUIC_CACHEALIGN CXPLAT_SOCKET_CONTEXT {
 
     CXPLAT_SOCKET* AcceptSocket;
 
+#if CXPLAT_USE_IO_URING
+    //
+    // Number of outstanding io_uring operations (the multishot receive,
+    // in-flight sends and the shutdown cancel) that reference this context.
+    //
+    long OutstandingIo;
+
+    //
+    // Indicates the socket is being shut down and the multishot receive must
+    // not be rearmed. Protected by the event queue lock.
+    //
+    BOOLEAN ShuttingDown;
+
+    //
+    // Template describing the name and control buffer layout of the
+    // multishot receive. Must stay valid while the receive is armed.
+    //
+    struct msghdr RecvMsgHdr;
+#else
+    //
+    // The head of the list of MSG_ZEROCOPY sends the kernel may still
+    // reference, in completion order.
+    //
+    CXPLAT_LIST_ENTRY ZeroCopyQueue;
+
+    //
+    // Serializes MSG_ZEROCOPY sends, so that the completion sequence numbers
+    // assigned by the kernel match ZeroCopyNextSequence, and protects the
+    // ZeroCopyQueue.
+    //
+    CXPLAT_LOCK ZeroCopyLock;
+
+    //
+    // The completion sequence number of the next MSG_ZEROCOPY send.
+    //
+    uint32_t ZeroCopyNextSequence;
+
+    //
+    // Indicates SO_ZEROCOPY is enabled on the socket and hasn't been turned
+    // off because the kernel reported it copied the data anyway.
+    //
+    BOOLEAN ZeroCopyEnabled;
+#endif
+
 } CXPLAT_SOCKET_CONTEXT;
 
 //
@@ -884,6 +944,28 @@ typedef struct QUIC_CACHEALIGN CXPLAT_DATAPATH_PARTITION {
     //
     CXPLAT_POOL SendBlockPool;
 
+    //
+    // The number of zero-copy sends on this core, and how many of those the
+    // kernel ended up copying.
+    //
+    uint64_t SendZeroCopyCount;
+    uint64_t SendZeroCopyCopiedCount;
+
+#if CXPLAT_USE_IO_URING
+    //
+    // Ring of provided buffers the kernel picks from to complete multishot
+    // receives on any socket of this partition, and the receive blocks that
+    // back it.
+    //
+    struct io_uring_buf_ring* RecvBufRing;
+    uint8_t* RecvBlocks;
+
+    //
+    // Serializes returning receive blocks to the provided buffer ring.
+    //
+    CXPLAT_LOCK RecvBufRingLock;
+#endif
+
 } CXPLAT_DATAPATH_PARTITION;
 
 //
@@ -946,6 +1028,19 @@ typedef struct CXPLAT_DATAPATH {
 
     uint8_t UseTcp : 1;
 
+    //
+    // Indicates large segmented sends should be done without copying the
+    // payload into the kernel.
+    //
+    BOOLEAN SendZeroCopySupported;
+
+#if CXPLAT_USE_IO_URING
+    //
+    // The provided buffer group ID used for receives on all partitions.
+    //
+    uint16_t RecvBufferGroup;
+#endif
+
     CXPLAT_DATAPATH_RAW* RawDataPath;
 
     //
@@ -1030,6 +1125,13 @@ DataPathIsPaddingPreferred(
     _In_ CXPLAT_DATAPATH* Datapath
     );
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+DataPathGetStatistics(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _Out_ CXPLAT_DATAPATH_STATISTICS* Statistics
+    );
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 RecvDataReturn(
@@ -458,6 +458,11 @@ CxPlatTimeUs64(
     void
     )
 {
+#ifdef DEBUG
+    if (CxPlatform.TimeOverride != 0) {
+        return CxPlatform.TimeOverride;
+    }
+#endif
     struct timespec CurrTime = {0};
     int ErrorCode = clock_gettime(CLOCK_MONOTONIC, &CurrTime);
     CXPLAT_DBG_ASSERT(ErrorCode == 0);
@@ -534,6 +539,179 @@ CxPlatProcCurrentNumber(
 #endif // CX_PLATFORM_DARWIN
 }
 
+_Ret_maybenull_
+CXPLAT_POOL_MAGAZINE*
+CxPlatPoolCachePopulate(
+    _Inout_ CXPLAT_POOL* Pool,
+    _Inout_ CXPLAT_POOL_CACHE* Cache
+    )
+{
+    CXPLAT_POOL_MAGAZINE* Magazine = NULL;
+    CxPlatLockAcquire(&Pool->Lock);
+    if (!Cache->Populated) {
+        if (Pool->DepotEmpty != NULL) {
+            Magazine = Pool->DepotEmpty;
+            Pool->DepotEmpty = Magazine->Next;
+        } else {
+            Magazine =
+                (CXPLAT_POOL_MAGAZINE*)CxPlatAlloc(
+                    sizeof(CXPLAT_POOL_MAGAZINE), QUIC_POOL_PLATFORM_POOL_CACHE);
+            if (Magazine != NULL) {
+                Magazine->Count = 0;
+            }
+        }
+        if (Magazine != NULL) {
+            Magazine->Next = NULL;
+            Cache->Populated = TRUE;
+        }
+    }
+    CxPlatLockRelease(&Pool->Lock);
+    return Magazine;
+}
+
+_Ret_notnull_
+CXPLAT_POOL_MAGAZINE*
+CxPlatPoolDepotExchangeEmpty(
+    _Inout_ CXPLAT_POOL* Pool,
+    _In_ CXPLAT_POOL_MAGAZINE* Empty
+    )
+{
+    CXPLAT_DBG_ASSERT(Empty->Count == 0);
+    CXPLAT_POOL_MAGAZINE* Full = NULL;
+    CxPlatLockAcquire(&Pool->Lock);
+    if (Pool->DepotFull != NULL) {
+        Full = Pool->DepotFull;
+        Pool->DepotFull = Full->Next;
+        Pool->DepotFullCount--;
+        Empty->Next = Pool->DepotEmpty;
+        Pool->DepotEmpty = Empty;
+        Pool->DepotTransfers++;
+    }
+    CxPlatLockRelease(&Pool->Lock);
+    return Full != NULL ? Full : Empty;
+}
+
+_Ret_notnull_
+CXPLAT_POOL_MAGAZINE*
+CxPlatPoolDepotExchangeFull(
+    _Inout_ CXPLAT_POOL* Pool,
+    _In_ CXPLAT_POOL_MAGAZINE* Full
+    )
+{
+    CXPLAT_DBG_ASSERT(Full->Count == CXPLAT_POOL_MAGAZINE_SIZE);
+    CXPLAT_POOL_MAGAZINE* Empty = NULL;
+    CxPlatLockAcquire(&Pool->Lock);
+    if (Pool->DepotFullCount < CXPLAT_POOL_DEPOT_MAXIMUM_DEPTH) {
+        if (Pool->DepotEmpty != NULL) {
+            Empty = Pool->DepotEmpty;
+            Pool->DepotEmpty = Empty->Next;
+        } else {
+            Empty =
+                (CXPLAT_POOL_MAGAZINE*)CxPlatAlloc(
+                    sizeof(CXPLAT_POOL_MAGAZINE), QUIC_POOL_PLATFORM_POOL_CACHE);
+            if (Empty != NULL) {
+                Empty->Count = 0;
+            }
+        }
+        if (Empty != NULL) {
+            Full->Next = Pool->DepotFull;
+            Pool->DepotFull = Full;
+            Pool->DepotFullCount++;
+            Pool->DepotTransfers++;
+        }
+    }
+    CxPlatLockRelease(&Pool->Lock);
+
+    if (Empty == NULL) {
+        //
+        // The depot is at capacity (or we're out of memory), so release the
+        // magazine's contents back to the heap and reuse it.
+        //
+        for (uint32_t i = 0; i < Full->Count; ++i) {
+            CxPlatFree(Full->Entries[i], Pool->Tag);
+        }
+        Full->Count = 0;
+        Empty = Full;
+    }
+
+    Empty->Next = NULL;
+    return Empty;
+}
+
+static
+void
+CxPlatPoolMagazineFree(
+    _In_ CXPLAT_POOL* Pool,
+    _In_ __drv_freesMem(Mem) CXPLAT_POOL_MAGAZINE* Magazine
+    )
+{
+    for (uint32_t i = 0; i < Magazine->Count; ++i) {
+        CxPlatFree(Magazine->Entries[i], Pool->Tag);
+    }
+    CxPlatFree(Magazine, QUIC_POOL_PLATFORM_POOL_CACHE);
+}
+
+void
+CxPlatPoolCacheUninitialize(
+    _Inout_ CXPLAT_POOL* Pool
+    )
+{
+    CXPLAT_POOL_MAGAZINE* Magazine;
+
+    for (uint32_t i = 0; i < Pool->CacheCount; ++i) {
+        Magazine = Pool->Caches[i].Magazine;
+        if (Magazine != NULL) {
+            CxPlatPoolMagazineFree(Pool, Magazine);
+        } else {
+            CXPLAT_DBG_ASSERT(!Pool->Caches[i].Populated);
+        }
+    }
+
+    while ((Magazine = Pool->DepotFull) != NULL) {
+        Pool->DepotFull = Magazine->Next;
+        CxPlatPoolMagazineFree(Pool, Magazine);
+    }
+
+    while ((Magazine = Pool->DepotEmpty) != NULL) {
+        Pool->DepotEmpty = Magazine->Next;
+        CxPlatPoolMagazineFree(Pool, Magazine);
+    }
+
+    Pool->DepotFullCount = 0;
+    CxPlatFree(Pool->CacheAllocation, QUIC_POOL_PLATFORM_POOL_CACHE);
+    Pool->CacheAllocation = NULL;
+    Pool->Caches = NULL;
+}
+
+void
+CxPlatPoolGetStats(
+    _In_ CXPLAT_POOL* Pool,
+    _Out_ CXPLAT_POOL_STATS* Stats
+    )
+{
+    CxPlatZeroMemory(Stats, sizeof(*Stats));
+
+    //
+    // The per-processor counters are read without synchronization, so the
+    // result is only a (very close) approximation while the pool is in use.
+    //
+    if (Pool->Caches != NULL) {
+        for (uint32_t i = 0; i < Pool->CacheCount; ++i) {
+            const CXPLAT_POOL_CACHE* Cache = &Pool->Caches[i];
+            Stats->AllocHits += Cache->AllocHits;
+            Stats->AllocMisses += Cache->AllocMisses;
+            Stats->FreeHits += Cache->FreeHits;
+            Stats->FreeMisses += Cache->FreeMisses;
+        }
+    }
+
+    CxPlatLockAcquire(&Pool->Lock);
+    Stats->AllocMisses += Pool->AllocMisses;
+    Stats->FreeMisses += Pool->FreeMisses;
+    Stats->DepotTransfers += Pool->DepotTransfers;
+    CxPlatLockRelease(&Pool->Lock);
+}
+
 QUIC_STATUS
 CxPlatRandom(
     _In_ uint32_t BufferLen,
@@ -603,6 +781,21 @@ CxPlatGetAllocFailDenominator(
 {
     return CxPlatform.AllocFailDenominator;
 }
+
+void
+CxPlatSetTimeOverride(
+    _In_ uint64_t TimeUs
+    )
+{
+    CxPlatform.TimeOverride = TimeUs;
+}
+
+uint64_t
+CxPlatGetTimeOverride(
+    )
+{
+    return CxPlatform.TimeOverride;
+}
 #endif
 
 #if defined(CX_PLATFORM_LINUX)
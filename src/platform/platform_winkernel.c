@@ -254,6 +254,21 @@ CxPlatGetAllocFailDenominator(
     return CxPlatform.AllocFailDenominator;
 }
 
+void
+CxPlatSetTimeOverride(
+    _In_ uint64_t TimeUs
+    )
+{
+    CxPlatform.TimeOverride = TimeUs;
+}
+
+uint64_t
+CxPlatGetTimeOverride(
+    )
+{
+    return CxPlatform.TimeOverride;
+}
+
 #endif
 
 #ifdef QUIC_EVENTS_MANIFEST_ETW
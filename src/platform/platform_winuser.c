@@ -608,6 +608,19 @@ CxPlatGetAllocFailDenominator(
 {
     return CxPlatform.AllocFailDenominator;
 }
+void
+CxPlatSetTimeOverride(
+    _In_ uint64_t TimeUs
+    )
+{
+    CxPlatform.TimeOverride = TimeUs;
+}
+uint64_t
+CxPlatGetTimeOverride(
+    )
+{
+    return CxPlatform.TimeOverride;
+}
 #endif
 
 QUIC_STATUS
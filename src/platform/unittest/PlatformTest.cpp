@@ -201,3 +201,36 @@ TEST(PlatformTest, EventQueueWorker)
 
     CxPlatEventQCleanup(&queue);
 }
+
+#ifdef CXPLAT_POOL_MAGAZINE_SIZE
+TEST(PlatformTest, PoolMagazineCache)
+{
+    const uint32_t EntryCount = 4 * CXPLAT_POOL_MAGAZINE_SIZE;
+    void* Entries[EntryCount];
+
+    CXPLAT_POOL Pool;
+    CxPlatPoolInitialize(FALSE, 64, QUIC_POOL_TEST, &Pool);
+
+    for (uint32_t Round = 0; Round < 2; ++Round) {
+        for (uint32_t i = 0; i < EntryCount; ++i) {
+            Entries[i] = CxPlatPoolAlloc(&Pool);
+            ASSERT_NE(nullptr, Entries[i]);
+        }
+        for (uint32_t i = 0; i < EntryCount; ++i) {
+            CxPlatPoolFree(&Pool, Entries[i]);
+        }
+    }
+
+    CXPLAT_POOL_STATS Stats;
+    CxPlatPoolGetStats(&Pool, &Stats);
+    ASSERT_EQ(2 * EntryCount, Stats.AllocHits + Stats.AllocMisses);
+    ASSERT_EQ(2 * EntryCount, Stats.FreeHits + Stats.FreeMisses);
+    if (Pool.Caches != NULL) {
+        ASSERT_EQ(0u, (uintptr_t)Pool.Caches % CXPLAT_POOL_CACHE_ALIGNMENT);
+        ASSERT_NE(0u, Stats.AllocHits);
+        ASSERT_NE(0u, Stats.DepotTransfers);
+    }
+
+    CxPlatPoolUninitialize(&Pool);
+}
+#endif // CXPLAT_POOL_MAGAZINE_SIZE
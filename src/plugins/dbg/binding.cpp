@@ -71,21 +71,23 @@ EXT_COMMAND(
             Conn.TypeStr());
     } else {
         for (UCHAR i = 0; i < PartitionCount; i++) {
-            HashTable Hash(Lookup.GetLookupTable(i).GetTablePtr());
-            Dml("\t<link cmd=\"dt msquic!CXPLAT_HASHTABLE 0x%I64X\">Hash Table %d</link> (%u entries)\n",
-                Hash.Addr,
+            LookupHashTable Table = Lookup.GetLookupTable(i);
+            ULONG SlotCount = Table.SlotCount();
+            Dml("\t<link cmd=\"dt msquic!QUIC_CID_TABLE 0x%I64X\">Hash Table %d</link> (%u entries)\n",
+                Table.GetCidTablePtr(),
                 i,
-                Hash.NumEntries());
-            ULONG64 EntryPtr;
-            while (!CheckControlC() && Hash.GetNextEntry(&EntryPtr)) {
-                CidHashEntry Entry = CidHashEntry::FromEntry(EntryPtr);
-                Cid Cid(Entry.GetCid());
-                Connection Conn(Entry.GetConnection());
+                Table.Count());
+            for (ULONG j = 0; !CheckControlC() && j < SlotCount; j++) {
+                CidSlot Slot = Table.GetSlot(j);
+                if (!Slot.InUse()) {
+                    continue;
+                }
+                Connection Conn(Slot.GetConnection());
                 Dml("\t  <link cmd=\"!quicconnection 0x%I64X\">Connection 0x%I64X</link> [%s] [%s]\n",
                     Conn.Addr,
                     Conn.Addr,
                     Conn.TypeStr(),
-                    Cid.Str().Data);
+                    Slot.Str().Data);
             }
         }
     }
@@ -192,6 +192,12 @@ typedef union QUIC_CONNECTION_STATE {
         //
         BOOLEAN UseRoundRobinStreamScheduling : 1;
 
+        //
+        // Indicates the connection is using the extensible priority (urgency
+        // and incremental) stream scheduling scheme.
+        //
+        BOOLEAN UseExtensiblePriorityStreamScheduling : 1;
+
         //
         // Indicates that this connection has resumption enabled and needs to
         // keep the TLS state and transport parameters until it is done sending
@@ -457,10 +463,6 @@ struct CidHashEntry : Struct {
 
     CidHashEntry(ULONG64 Addr) : Struct("msquic!QUIC_CID_HASH_ENTRY", Addr) { }
 
-    static CidHashEntry FromEntry(ULONG64 EntryAddr) {
-        return CidHashEntry(LinkEntryToType(EntryAddr, "msquic!QUIC_CID_HASH_ENTRY", "Entry"));
-    }
-
     static CidHashEntry FromLink(ULONG64 LinkAddr) {
         return CidHashEntry(LinkEntryToType(LinkAddr, "msquic!QUIC_CID_HASH_ENTRY", "Link"));
     }
@@ -992,6 +994,7 @@ typedef enum QUIC_API_TYPE {
     QUIC_API_TYPE_STRM_SEND,
     QUIC_API_TYPE_STRM_RECV_COMPLETE,
     QUIC_API_TYPE_STRM_RECV_SET_ENABLED,
+    QUIC_API_TYPE_STRM_PROVIDE_RECV_BUFFERS,
 
     QUIC_API_TYPE_SET_PARAM,
     QUIC_API_TYPE_GET_PARAM,
@@ -999,6 +1002,7 @@ typedef enum QUIC_API_TYPE {
     QUIC_API_TYPE_DATAGRAM_SEND,
     QUIC_API_TYPE_CONN_COMPLETE_RESUMPTION_TICKET_VALIDATION,
     QUIC_API_TYPE_CONN_COMPLETE_CERTIFICATE_VALIDATION,
+    QUIC_API_TYPE_CONN_SEND_BATCH,
 
 } QUIC_API_TYPE;
 
@@ -1034,6 +1038,8 @@ struct ApiCall : Struct {
             return "API_TYPE_STRM_RECV_COMPLETE";
         case QUIC_API_TYPE_STRM_RECV_SET_ENABLED:
             return "API_TYPE_STRM_RECV_SET_ENABLED";
+        case QUIC_API_TYPE_STRM_PROVIDE_RECV_BUFFERS:
+            return "API_TYPE_STRM_PROVIDE_RECV_BUFFERS";
         case QUIC_API_TYPE_SET_PARAM:
             return "API_SET_PARAM";
         case QUIC_API_TYPE_GET_PARAM:
@@ -1044,6 +1050,8 @@ struct ApiCall : Struct {
             return "API_TYPE_CONN_COMPLETE_RESUMPTION_TICKET_VALIDATION";
         case QUIC_API_TYPE_CONN_COMPLETE_CERTIFICATE_VALIDATION:
             return "API_TYPE_CONN_COMPLETE_CERTIFICATE_VALIDATION";
+        case QUIC_API_TYPE_CONN_SEND_BATCH:
+            return "API_TYPE_CONN_SEND_BATCH";
         default:
             return "INVALID API";
         }
@@ -1491,12 +1499,44 @@ struct Registration : Struct {
     }
 };
 
+struct CidSlot : Struct {
+
+    CidSlot(ULONG64 Addr) : Struct("msquic!QUIC_CID_SLOT", Addr) { }
+
+    ULONG64 GetConnection() {
+        return ReadPointer("Connection");
+    }
+
+    bool InUse() {
+        ULONG64 Connection = GetConnection();
+        return Connection != 0 && Connection != 1; // Empty or removed.
+    }
+
+    CidStr Str() {
+        return CidStr(AddrOf("Data"), ReadType<UCHAR>("Length"));
+    }
+};
+
 struct LookupHashTable : Struct {
 
     LookupHashTable(ULONG64 Addr) : Struct("msquic!QUIC_PARTITIONED_HASHTABLE", Addr) { }
 
-    ULONG64 GetTablePtr() {
-        return AddrOf("Table"); // TODO - Need Hash Table Enumeration.
+    UINT32 Count() {
+        return ReadType<UINT32>("Count");
+    }
+
+    ULONG64 GetCidTablePtr() {
+        return ReadPointer("Table");
+    }
+
+    ULONG SlotCount() {
+        Struct CidTable("msquic!QUIC_CID_TABLE", GetCidTablePtr());
+        return CidTable.ReadType<ULONG>("Mask") + 1;
+    }
+
+    CidSlot GetSlot(ULONG Index) {
+        Struct CidTable("msquic!QUIC_CID_TABLE", GetCidTablePtr());
+        return CidSlot(CidTable.AddrOf("Slots") + Index * GetTypeSize("msquic!QUIC_CID_SLOT"));
     }
 };
 
@@ -1517,11 +1557,11 @@ struct Lookup : Struct {
     }
 
     ULONG64 GetLookupPtr() {
-        return ReadPointer("LookupTable");
+        return ReadPointer("SINGLE.Connection");
     }
 
     LookupHashTable GetLookupTable(UCHAR Index) {
-        ULONG64 ArrayAddr = ReadPointer("LookupTable");
+        ULONG64 ArrayAddr = ReadPointer("HASH.Tables");
         ULONG TypeSize = GetTypeSize("msquic!QUIC_PARTITIONED_HASHTABLE");
         return LookupHashTable(ArrayAddr + Index * TypeSize);
     }
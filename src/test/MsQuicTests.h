@@ -97,6 +97,7 @@ void QuicTestCreateConnection();
 void QuicTestBindConnectionImplicit(_In_ int Family);
 void QuicTestBindConnectionExplicit(_In_ int Family);
 void QuicTestConnectionCloseFromCallback();
+void QuicTestConnectionPoolCreate(_In_ int Family);
 
 //
 // MTU tests
@@ -597,11 +598,33 @@ void
 QuicTestConnectionStreamStartSendPriority(
     );
 
+void
+QuicTestConnectionSendBatch(
+    );
+
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+void
+QuicTestAppCongestionControl(
+    );
+#endif
+
 void
 QuicTestEcn(
     _In_ int Family
     );
 
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+void
+QuicTestEcnL4s(
+    _In_ int Family
+    );
+
+void
+QuicTestScavengerCongestionControl(
+    _In_ int Family
+    );
+#endif
+
 //
 // QuicDrill tests
 //
@@ -1330,4 +1353,22 @@ typedef struct {
     QUIC_CTL_CODE(125, METHOD_BUFFERED, FILE_WRITE_DATA)
     // BOOLEAN - EnableResumption
 
-#define QUIC_MAX_IOCTL_FUNC_CODE 125
+#define IOCTL_QUIC_RUN_CONNECTION_POOL_CREATE \
+    QUIC_CTL_CODE(126, METHOD_BUFFERED, FILE_WRITE_DATA)
+    // int - Family
+
+#define IOCTL_QUIC_RUN_CONNECTION_SEND_BATCH \
+    QUIC_CTL_CODE(127, METHOD_BUFFERED, FILE_WRITE_DATA)
+
+#define IOCTL_QUIC_RUN_APP_CONGESTION_CONTROL \
+    QUIC_CTL_CODE(128, METHOD_BUFFERED, FILE_WRITE_DATA)
+
+#define IOCTL_QUIC_RUN_ECN_L4S \
+    QUIC_CTL_CODE(129, METHOD_BUFFERED, FILE_WRITE_DATA)
+    // int - Family
+
+#define IOCTL_QUIC_RUN_SCAVENGER_CONGESTION_CONTROL \
+    QUIC_CTL_CODE(130, METHOD_BUFFERED, FILE_WRITE_DATA)
+    // int - Family
+
+#define QUIC_MAX_IOCTL_FUNC_CODE 130
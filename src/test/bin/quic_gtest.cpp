@@ -607,6 +607,26 @@ TEST_P(WithFamilyArgs, Ecn) {
     }
 }
 
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+TEST_P(WithFamilyArgs, EcnL4s) {
+    TestLoggerT<ParamType> Logger("EcnL4s", GetParam());
+    if (TestingKernelMode) {
+        ASSERT_TRUE(DriverClient.Run(IOCTL_QUIC_RUN_ECN_L4S, GetParam().Family));
+    } else {
+        QuicTestEcnL4s(GetParam().Family);
+    }
+}
+
+TEST_P(WithFamilyArgs, ScavengerCongestionControl) {
+    TestLoggerT<ParamType> Logger("ScavengerCongestionControl", GetParam());
+    if (TestingKernelMode) {
+        ASSERT_TRUE(DriverClient.Run(IOCTL_QUIC_RUN_SCAVENGER_CONGESTION_CONTROL, GetParam().Family));
+    } else {
+        QuicTestScavengerCongestionControl(GetParam().Family);
+    }
+}
+#endif
+
 TEST_P(WithFamilyArgs, LocalPathChanges) {
     TestLoggerT<ParamType> Logger("QuicTestLocalPathChanges", GetParam());
     if (TestingKernelMode) {
@@ -696,6 +716,15 @@ TEST_P(WithFamilyArgs, BindConnectionExplicit) {
     }
 }
 
+TEST_P(WithFamilyArgs, ConnectionPoolCreate) {
+    TestLoggerT<ParamType> Logger("QuicTestConnectionPoolCreate", GetParam());
+    if (TestingKernelMode) {
+        ASSERT_TRUE(DriverClient.Run(IOCTL_QUIC_RUN_CONNECTION_POOL_CREATE, GetParam().Family));
+    } else {
+        QuicTestConnectionPoolCreate(GetParam().Family);
+    }
+}
+
 TEST_P(WithHandshakeArgs1, Connect) {
     TestLoggerT<ParamType> Logger("QuicTestConnect-Connect", GetParam());
     if (TestingKernelMode) {
@@ -2240,6 +2269,26 @@ TEST(Misc, StreamMultiReceive) {
 }
 #endif // QUIC_API_ENABLE_PREVIEW_FEATURES
 
+TEST(Misc, ConnectionSendBatch) {
+    TestLogger Logger("QuicTestConnectionSendBatch");
+    if (TestingKernelMode) {
+        ASSERT_TRUE(DriverClient.Run(IOCTL_QUIC_RUN_CONNECTION_SEND_BATCH));
+    } else {
+        QuicTestConnectionSendBatch();
+    }
+}
+
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+TEST(Misc, AppCongestionControl) {
+    TestLogger Logger("QuicTestAppCongestionControl");
+    if (TestingKernelMode) {
+        ASSERT_TRUE(DriverClient.Run(IOCTL_QUIC_RUN_APP_CONGESTION_CONTROL));
+    } else {
+        QuicTestAppCongestionControl();
+    }
+}
+#endif
+
 TEST(Misc, StreamBlockUnblockUnidiConnFlowControl) {
     TestLogger Logger("StreamBlockUnblockUnidiConnFlowControl");
     if (TestingKernelMode) {
@@ -524,6 +524,11 @@ size_t QUIC_IOCTL_BUFFER_SIZES[] =
     0,
     0,
     sizeof(BOOLEAN),
+    sizeof(INT32),
+    0,
+    0,
+    sizeof(INT32),
+    sizeof(INT32),
 };
 
 CXPLAT_STATIC_ASSERT(
@@ -1483,6 +1488,31 @@ QuicTestCtlEvtIoDeviceControl(
         QuicTestCtlRun(QuicTestTlsHandshakeInfo(Params->EnableResumption != 0));
         break;
 
+    case IOCTL_QUIC_RUN_CONNECTION_POOL_CREATE:
+        CXPLAT_FRE_ASSERT(Params != nullptr);
+        QuicTestCtlRun(QuicTestConnectionPoolCreate(Params->Family));
+        break;
+
+    case IOCTL_QUIC_RUN_CONNECTION_SEND_BATCH:
+        QuicTestCtlRun(QuicTestConnectionSendBatch());
+        break;
+
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+    case IOCTL_QUIC_RUN_APP_CONGESTION_CONTROL:
+        QuicTestCtlRun(QuicTestAppCongestionControl());
+        break;
+
+    case IOCTL_QUIC_RUN_ECN_L4S:
+        CXPLAT_FRE_ASSERT(Params != nullptr);
+        QuicTestCtlRun(QuicTestEcnL4s(Params->Family));
+        break;
+
+    case IOCTL_QUIC_RUN_SCAVENGER_CONGESTION_CONTROL:
+        CXPLAT_FRE_ASSERT(Params != nullptr);
+        QuicTestCtlRun(QuicTestScavengerCongestionControl(Params->Family));
+        break;
+#endif
+
     default:
         Status = STATUS_NOT_IMPLEMENTED;
         break;
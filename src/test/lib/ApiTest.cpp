@@ -2860,6 +2860,13 @@ void QuicTestRegistrationParam()
 #define SETTINGS_SIZE_THRU_FIELD(SettingsType, Field) \
     (FIELD_OFFSET(SettingsType, Field) + sizeof(((SettingsType*)0)->Field))
 
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+static void QUIC_API TestCcReset(void*, void*, const QUIC_CONGESTION_CONTROL_RESET_INFO*) { }
+static void QUIC_API TestCcOnDataAcknowledged(void*, void*, const QUIC_CONGESTION_CONTROL_ACK_INFO*) { }
+static void QUIC_API TestCcOnDataLost(void*, void*, const QUIC_CONGESTION_CONTROL_LOSS_INFO*) { }
+static uint32_t QUIC_API TestCcGetCongestionWindow(void*, const void*) { return 0; }
+#endif
+
 void QuicTestConfigurationParam()
 {
     MsQuicRegistration Registration;
@@ -3055,6 +3062,118 @@ void QuicTestConfigurationParam()
             TEST_EQUAL(Flag, ExpectedFlag);
         }
     }
+
+    //
+    // QUIC_PARAM_CONFIGURATION_CONGESTION_CONTROL
+    //
+    {
+        TestScopeLogger LogScope0("QUIC_PARAM_CONFIGURATION_CONGESTION_CONTROL");
+        QUIC_CONGESTION_CONTROL_CALLBACKS Callbacks;
+        CxPlatZeroMemory(&Callbacks, sizeof(Callbacks));
+        Callbacks.Version = QUIC_CONGESTION_CONTROL_CALLBACKS_VERSION;
+        Callbacks.StateSize = QUIC_CONGESTION_CONTROL_MAX_STATE_SIZE;
+        Callbacks.Reset = TestCcReset;
+        Callbacks.OnDataAcknowledged = TestCcOnDataAcknowledged;
+        Callbacks.OnDataLost = TestCcOnDataLost;
+        Callbacks.GetCongestionWindow = TestCcGetCongestionWindow;
+
+        //
+        // SetParam
+        //
+        {
+            TestScopeLogger LogScope1("SetParam");
+            MsQuicConfiguration Configuration(Registration, Alpn);
+            {
+                TestScopeLogger LogScope2("Invalid buffer");
+                TEST_QUIC_STATUS(
+                    QUIC_STATUS_INVALID_PARAMETER,
+                    MsQuic->SetParam(
+                        Configuration,
+                        QUIC_PARAM_CONFIGURATION_CONGESTION_CONTROL,
+                        sizeof(Callbacks),
+                        nullptr));
+                TEST_QUIC_STATUS(
+                    QUIC_STATUS_INVALID_PARAMETER,
+                    MsQuic->SetParam(
+                        Configuration,
+                        QUIC_PARAM_CONFIGURATION_CONGESTION_CONTROL,
+                        sizeof(Callbacks) - 1,
+                        &Callbacks));
+            }
+
+            {
+                TestScopeLogger LogScope2("Invalid version");
+                QUIC_CONGESTION_CONTROL_CALLBACKS Invalid = Callbacks;
+                Invalid.Version = QUIC_CONGESTION_CONTROL_CALLBACKS_VERSION + 1;
+                TEST_QUIC_STATUS(
+                    QUIC_STATUS_INVALID_PARAMETER,
+                    MsQuic->SetParam(
+                        Configuration,
+                        QUIC_PARAM_CONFIGURATION_CONGESTION_CONTROL,
+                        sizeof(Invalid),
+                        &Invalid));
+            }
+
+            {
+                TestScopeLogger LogScope2("State too large");
+                QUIC_CONGESTION_CONTROL_CALLBACKS Invalid = Callbacks;
+                Invalid.StateSize = QUIC_CONGESTION_CONTROL_MAX_STATE_SIZE + 1;
+                TEST_QUIC_STATUS(
+                    QUIC_STATUS_INVALID_PARAMETER,
+                    MsQuic->SetParam(
+                        Configuration,
+                        QUIC_PARAM_CONFIGURATION_CONGESTION_CONTROL,
+                        sizeof(Invalid),
+                        &Invalid));
+            }
+
+            {
+                TestScopeLogger LogScope2("Missing required callback");
+                QUIC_CONGESTION_CONTROL_CALLBACKS Invalid = Callbacks;
+                Invalid.GetCongestionWindow = nullptr;
+                TEST_QUIC_STATUS(
+                    QUIC_STATUS_INVALID_PARAMETER,
+                    MsQuic->SetParam(
+                        Configuration,
+                        QUIC_PARAM_CONFIGURATION_CONGESTION_CONTROL,
+                        sizeof(Invalid),
+                        &Invalid));
+            }
+
+            {
+                TestScopeLogger LogScope2("Only set once");
+                TEST_QUIC_SUCCEEDED(
+                    MsQuic->SetParam(
+                        Configuration,
+                        QUIC_PARAM_CONFIGURATION_CONGESTION_CONTROL,
+                        sizeof(Callbacks),
+                        &Callbacks));
+                TEST_QUIC_STATUS(
+                    QUIC_STATUS_INVALID_STATE,
+                    MsQuic->SetParam(
+                        Configuration,
+                        QUIC_PARAM_CONFIGURATION_CONGESTION_CONTROL,
+                        sizeof(Callbacks),
+                        &Callbacks));
+            }
+        }
+
+        //
+        // GetParam
+        //
+        {
+            TestScopeLogger LogScope1("GetParam is not allowed");
+            MsQuicConfiguration Configuration(Registration, Alpn);
+            uint32_t Length = sizeof(Callbacks);
+            TEST_QUIC_STATUS(
+                QUIC_STATUS_INVALID_PARAMETER,
+                MsQuic->GetParam(
+                    Configuration,
+                    QUIC_PARAM_CONFIGURATION_CONGESTION_CONTROL,
+                    &Length,
+                    &Callbacks));
+        }
+    }
 #endif
 }
 
@@ -5098,6 +5217,22 @@ void QuicTestStreamParam()
         MsQuicStream Stream(Connection, QUIC_STREAM_OPEN_FLAG_NONE);
         Stream.Start(QUIC_STREAM_START_FLAG_IMMEDIATE); // IMMEDIATE to set Stream->SendFlags != 0
         uint16_t Expected = 123;
+        //
+        // Default
+        //
+        {
+            TestScopeLogger LogScope1("Default");
+            uint16_t Priority = 0;
+            uint32_t Length = sizeof(Priority);
+            TEST_QUIC_SUCCEEDED(
+                MsQuic->GetParam(
+                    Stream.Handle,
+                    QUIC_PARAM_STREAM_PRIORITY,
+                    &Length,
+                    &Priority));
+            TEST_EQUAL(Priority, 0x7FFF);
+        }
+
         //
         // SetParam
         //
@@ -5137,6 +5272,91 @@ void QuicTestStreamParam()
         }
     }
 
+    //
+    // QUIC_PARAM_STREAM_EXTENSIBLE_PRIORITY
+    //
+    {
+        TestScopeLogger LogScope0("QUIC_PARAM_STREAM_EXTENSIBLE_PRIORITY");
+        MsQuicStream Stream(Connection, QUIC_STREAM_OPEN_FLAG_NONE);
+        Stream.Start(QUIC_STREAM_START_FLAG_IMMEDIATE); // IMMEDIATE to set Stream->SendFlags != 0
+        QUIC_STREAM_EXTENSIBLE_PRIORITY Expected = { 1, TRUE };
+        //
+        // Default
+        //
+        {
+            TestScopeLogger LogScope1("Default");
+            MsQuicConnection PriorityConnection(Registration);
+            TEST_QUIC_SUCCEEDED(PriorityConnection.GetInitStatus());
+            QUIC_STREAM_SCHEDULING_SCHEME Scheme = QUIC_STREAM_SCHEDULING_SCHEME_EXTENSIBLE_PRIORITY;
+            TEST_QUIC_SUCCEEDED(
+                MsQuic->SetParam(
+                    PriorityConnection.Handle,
+                    QUIC_PARAM_CONN_STREAM_SCHEDULING_SCHEME,
+                    sizeof(Scheme),
+                    &Scheme));
+            MsQuicStream PriorityStream(PriorityConnection, QUIC_STREAM_OPEN_FLAG_NONE);
+            TEST_QUIC_SUCCEEDED(PriorityStream.GetInitStatus());
+
+            QUIC_STREAM_EXTENSIBLE_PRIORITY Priority = { 0, TRUE };
+            uint32_t Length = sizeof(Priority);
+            TEST_QUIC_SUCCEEDED(
+                MsQuic->GetParam(
+                    PriorityStream.Handle,
+                    QUIC_PARAM_STREAM_EXTENSIBLE_PRIORITY,
+                    &Length,
+                    &Priority));
+            TEST_EQUAL(Priority.Urgency, QUIC_STREAM_URGENCY_DEFAULT);
+            TEST_EQUAL(Priority.Incremental, FALSE);
+        }
+
+        //
+        // SetParam
+        //
+        {
+            TestScopeLogger LogScope1("SetParam");
+            QUIC_STREAM_EXTENSIBLE_PRIORITY Invalid = { QUIC_STREAM_URGENCY_MAX + 1, FALSE };
+            TEST_QUIC_STATUS(
+                QUIC_STATUS_INVALID_PARAMETER,
+                MsQuic->SetParam(
+                    Stream.Handle,
+                    QUIC_PARAM_STREAM_EXTENSIBLE_PRIORITY,
+                    sizeof(Invalid),
+                    &Invalid));
+            TEST_QUIC_SUCCEEDED(
+                MsQuic->SetParam(
+                    Stream.Handle,
+                    QUIC_PARAM_STREAM_EXTENSIBLE_PRIORITY,
+                    sizeof(Expected),
+                    &Expected));
+        }
+
+        //
+        // GetParam
+        //
+        {
+            TestScopeLogger LogScope1("GetParam");
+            uint32_t Length = 0;
+            TEST_QUIC_STATUS(
+                QUIC_STATUS_BUFFER_TOO_SMALL,
+                MsQuic->GetParam(
+                    Stream.Handle,
+                    QUIC_PARAM_STREAM_EXTENSIBLE_PRIORITY,
+                    &Length,
+                    nullptr));
+            TEST_EQUAL(Length, sizeof(QUIC_STREAM_EXTENSIBLE_PRIORITY));
+
+            QUIC_STREAM_EXTENSIBLE_PRIORITY Priority = { 0, FALSE };
+            TEST_QUIC_SUCCEEDED(
+                MsQuic->GetParam(
+                    Stream.Handle,
+                    QUIC_PARAM_STREAM_EXTENSIBLE_PRIORITY,
+                    &Length,
+                    &Priority));
+            TEST_EQUAL(Priority.Urgency, Expected.Urgency);
+            TEST_EQUAL(Priority.Incremental, Expected.Incremental);
+        }
+    }
+
     //
     // QUIC_PARAM_STREAM_STATISTICS
     //
@@ -270,3 +270,108 @@ void QuicTestBindConnectionExplicit(_In_ int Family)
         TEST_QUIC_SUCCEEDED(Status);
     }
 }
+
+struct ConnectionPoolTestContext {
+    CxPlatEvent AllConnected;
+    long ConnectedCount {0};
+    long ExpectedCount;
+    ConnectionPoolTestContext(long Count) : AllConnected(true), ExpectedCount(Count) { }
+
+    static
+    _IRQL_requires_max_(PASSIVE_LEVEL)
+    _Function_class_(QUIC_CONNECTION_CALLBACK)
+    QUIC_STATUS
+    QUIC_API
+    ConnCallback(
+        _In_ HQUIC,
+        _In_opt_ void* Context,
+        _Inout_ QUIC_CONNECTION_EVENT* Event
+        ) {
+        auto TestContext = (ConnectionPoolTestContext*)Context;
+        if (Event->Type == QUIC_CONNECTION_EVENT_CONNECTED) {
+            if (InterlockedIncrement(&TestContext->ConnectedCount) == TestContext->ExpectedCount) {
+                TestContext->AllConnected.Set();
+            }
+        }
+        return QUIC_STATUS_SUCCESS;
+    }
+};
+
+void QuicTestConnectionPoolCreate(_In_ int Family)
+{
+    const uint16_t NumberOfConnections = 8;
+
+    MsQuicRegistration Registration(true);
+    TEST_QUIC_SUCCEEDED(Registration.GetInitStatus());
+
+    MsQuicConfiguration ServerConfiguration(Registration, "MsQuicTest", ServerSelfSignedCredConfig);
+    TEST_QUIC_SUCCEEDED(ServerConfiguration.GetInitStatus());
+
+    MsQuicConfiguration ClientConfiguration(Registration, "MsQuicTest", MsQuicCredentialConfig());
+    TEST_QUIC_SUCCEEDED(ClientConfiguration.GetInitStatus());
+
+    QUIC_ADDRESS_FAMILY QuicAddrFamily = (Family == 4) ? QUIC_ADDRESS_FAMILY_INET : QUIC_ADDRESS_FAMILY_INET6;
+    MsQuicAutoAcceptListener Listener(Registration, ServerConfiguration, MsQuicConnection::NoOpCallback);
+    TEST_QUIC_SUCCEEDED(Listener.GetInitStatus());
+    QuicAddr ServerLocalAddr(QuicAddrFamily);
+    TEST_QUIC_SUCCEEDED(Listener.Start("MsQuicTest", &ServerLocalAddr.SockAddr));
+    TEST_QUIC_SUCCEEDED(Listener.GetLocalAddr(ServerLocalAddr));
+
+    ConnectionPoolTestContext Context(NumberOfConnections);
+    void* Contexts[NumberOfConnections];
+    for (uint16_t i = 0; i < NumberOfConnections; ++i) {
+        Contexts[i] = &Context;
+    }
+    HQUIC Connections[NumberOfConnections];
+
+    QUIC_CONNECTION_POOL_CONFIG PoolConfig;
+    CxPlatZeroMemory(&PoolConfig, sizeof(PoolConfig));
+    PoolConfig.Registration = Registration;
+    PoolConfig.Configuration = ClientConfiguration;
+    PoolConfig.Handler = ConnectionPoolTestContext::ConnCallback;
+    PoolConfig.Context = Contexts;
+    PoolConfig.ServerName = QUIC_TEST_LOOPBACK_FOR_AF(QuicAddrFamily);
+    PoolConfig.Family = QuicAddrFamily;
+    PoolConfig.ServerPort = ServerLocalAddr.GetPort();
+    PoolConfig.NumberOfConnections = NumberOfConnections;
+    PoolConfig.Flags = QUIC_CONNECTION_POOL_FLAG_CLOSE_ON_FAILURE;
+
+    {
+        TestScopeLogger LogScope("Invalid parameters");
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            MsQuic->ConnectionPoolCreate(nullptr, Connections));
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            MsQuic->ConnectionPoolCreate(&PoolConfig, nullptr));
+
+        PoolConfig.NumberOfConnections = 0;
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            MsQuic->ConnectionPoolCreate(&PoolConfig, Connections));
+        PoolConfig.NumberOfConnections = NumberOfConnections;
+
+        PoolConfig.Handler = nullptr;
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            MsQuic->ConnectionPoolCreate(&PoolConfig, Connections));
+        PoolConfig.Handler = ConnectionPoolTestContext::ConnCallback;
+    }
+
+    {
+        TestScopeLogger LogScope("All connections connect");
+        TEST_QUIC_SUCCEEDED(MsQuic->ConnectionPoolCreate(&PoolConfig, Connections));
+        if (!Context.AllConnected.WaitTimeout(TestWaitTimeout)) {
+            TEST_FAILURE("Only %d of %u pooled connections connected", (int)Context.ConnectedCount, NumberOfConnections);
+        }
+        for (uint16_t i = 0; i < NumberOfConnections; ++i) {
+            TEST_NOT_EQUAL(nullptr, Connections[i]);
+            for (uint16_t j = 0; j < i; ++j) {
+                TEST_NOT_EQUAL(Connections[j], Connections[i]);
+            }
+        }
+        for (uint16_t i = 0; i < NumberOfConnections; ++i) {
+            MsQuic->ConnectionClose(Connections[i]);
+        }
+    }
+}
@@ -2740,6 +2740,168 @@ QuicTestEcn(
     }
 }
 
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+static
+void
+QuicTestEcnL4sTransfer(
+    _In_ QUIC_ADDRESS_FAMILY QuicAddrFamily,
+    _Out_ QUIC_STATISTICS_V2* Stats
+    )
+{
+    const uint32_t SendLength = 0x10000;
+
+    MsQuicRegistration Registration;
+    TEST_QUIC_SUCCEEDED(Registration.GetInitStatus());
+
+    MsQuicConfiguration ServerConfiguration(Registration, "MsQuicTest", MsQuicSettings().SetPeerUnidiStreamCount(1), ServerSelfSignedCredConfig);
+    TEST_QUIC_SUCCEEDED(ServerConfiguration.GetInitStatus());
+
+    MsQuicSettings ClientSettings;
+    ClientSettings.SetEcnEnabled(true);
+    ClientSettings.SetCongestionControlAlgorithm(QUIC_CONGESTION_CONTROL_ALGORITHM_PRAGUE);
+    MsQuicConfiguration ClientConfiguration(Registration, "MsQuicTest", ClientSettings, MsQuicCredentialConfig());
+    TEST_QUIC_SUCCEEDED(ClientConfiguration.GetInitStatus());
+
+    EcnTestContext Context;
+    MsQuicAutoAcceptListener Listener(Registration, ServerConfiguration, EcnTestContext::ConnCallback, &Context);
+    TEST_QUIC_SUCCEEDED(Listener.GetInitStatus());
+    TEST_QUIC_SUCCEEDED(Listener.Start("MsQuicTest"));
+    QuicAddr ServerLocalAddr;
+    TEST_QUIC_SUCCEEDED(Listener.GetLocalAddr(ServerLocalAddr));
+
+    UniquePtr<uint8_t[]> RawBuffer(new(std::nothrow) uint8_t[SendLength]);
+    TEST_NOT_EQUAL(nullptr, RawBuffer.get());
+    CxPlatZeroMemory(RawBuffer.get(), SendLength);
+    QUIC_BUFFER Buffer { SendLength, RawBuffer.get() };
+
+    MsQuicConnection Connection(Registration);
+    TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+    TEST_QUIC_SUCCEEDED(Connection.Start(ClientConfiguration, QuicAddrFamily, QUIC_TEST_LOOPBACK_FOR_AF(QuicAddrFamily), ServerLocalAddr.GetPort()));
+
+    MsQuicStream Stream(Connection, QUIC_STREAM_OPEN_FLAG_UNIDIRECTIONAL);
+    TEST_QUIC_SUCCEEDED(Stream.GetInitStatus());
+
+    //
+    // Send enough data for several round trips, and a FIN.
+    //
+    TEST_QUIC_SUCCEEDED(Stream.Send(&Buffer, 1, QUIC_SEND_FLAG_START | QUIC_SEND_FLAG_FIN));
+
+    TEST_TRUE(Context.ServerStreamRecv.WaitTimeout(TestWaitTimeout));
+    TEST_TRUE(Context.ServerStreamShutdown.WaitTimeout(TestWaitTimeout));
+    TEST_TRUE(Context.ServerStreamHasShutdown);
+    CxPlatSleep(50);
+
+    TEST_QUIC_SUCCEEDED(Connection.GetStatistics(Stats));
+}
+
+void
+QuicTestEcnL4s(
+    _In_ int Family
+    )
+{
+    QUIC_ADDRESS_FAMILY QuicAddrFamily = (Family == 4) ? QUIC_ADDRESS_FAMILY_INET : QUIC_ADDRESS_FAMILY_INET6;
+
+    //
+    // Packets are sent with ECT(1), which the peer's counts must reflect.
+    //
+    {
+        TestScopeLogger logScope("L4S ECN validation");
+        QUIC_STATISTICS_V2 Stats;
+        QuicTestEcnL4sTransfer(QuicAddrFamily, &Stats);
+        TEST_TRUE(Stats.EcnCapable);
+        TEST_NOT_EQUAL(0, Stats.SendEctPackets);
+        TEST_EQUAL(0, Stats.SendEcnCePackets);
+    }
+
+    //
+    // Every packet CE marked: the controller reacts and reports the ratio.
+    //
+    {
+        TestScopeLogger logScope("L4S CE marking");
+        EcnModifyHelper CeMarker;
+        CeMarker.SetEcnType(CXPLAT_ECN_CE);
+        QUIC_STATISTICS_V2 Stats;
+        QuicTestEcnL4sTransfer(QuicAddrFamily, &Stats);
+        TEST_TRUE(Stats.EcnCapable);
+        TEST_NOT_EQUAL(0, Stats.SendEcnCePackets);
+        TEST_NOT_EQUAL(0, Stats.SendEcnCongestionCount);
+        TEST_NOT_EQUAL(0, Stats.SendEcnCeRatio);
+    }
+
+    //
+    // The network rewriting ECT(1) to ECT(0) fails validation.
+    //
+    {
+        TestScopeLogger logScope("L4S ECT(1) rewritten to ECT(0)");
+        EcnModifyHelper EctRewriter;
+        EctRewriter.SetEcnType(CXPLAT_ECN_ECT_0);
+        QUIC_STATISTICS_V2 Stats;
+        QuicTestEcnL4sTransfer(QuicAddrFamily, &Stats);
+        TEST_FALSE(Stats.EcnCapable);
+    }
+}
+
+void
+QuicTestScavengerCongestionControl(
+    _In_ int Family
+    )
+{
+    QUIC_ADDRESS_FAMILY QuicAddrFamily = (Family == 4) ? QUIC_ADDRESS_FAMILY_INET : QUIC_ADDRESS_FAMILY_INET6;
+
+    MsQuicRegistration Registration("MsQuicTest", QUIC_EXECUTION_PROFILE_TYPE_SCAVENGER, true);
+    TEST_QUIC_SUCCEEDED(Registration.GetInitStatus());
+
+    MsQuicConfiguration ServerConfiguration(Registration, "MsQuicTest", ServerSelfSignedCredConfig);
+    TEST_QUIC_SUCCEEDED(ServerConfiguration.GetInitStatus());
+
+    MsQuicAutoAcceptListener Listener(Registration, ServerConfiguration, MsQuicConnection::NoOpCallback);
+    TEST_QUIC_SUCCEEDED(Listener.GetInitStatus());
+    TEST_QUIC_SUCCEEDED(Listener.Start("MsQuicTest"));
+    QuicAddr ServerLocalAddr;
+    TEST_QUIC_SUCCEEDED(Listener.GetLocalAddr(ServerLocalAddr));
+
+    //
+    // The execution profile doesn't change the congestion control algorithm;
+    // LEDBAT is only used when it is configured. How well it yields to other
+    // traffic is covered by the LedbatYields congestion control emulation
+    // scenario in msquiccoretest.
+    //
+    {
+        TestScopeLogger logScope("Default algorithm");
+        MsQuicConfiguration ClientConfiguration(Registration, "MsQuicTest", MsQuicCredentialConfig());
+        TEST_QUIC_SUCCEEDED(ClientConfiguration.GetInitStatus());
+
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        TEST_QUIC_SUCCEEDED(Connection.Start(ClientConfiguration, QuicAddrFamily, QUIC_TEST_LOOPBACK_FOR_AF(QuicAddrFamily), ServerLocalAddr.GetPort()));
+        TEST_TRUE(Connection.HandshakeCompleteEvent.WaitTimeout(TestWaitTimeout));
+        TEST_TRUE(Connection.HandshakeComplete);
+
+        MsQuicSettings Settings;
+        TEST_QUIC_SUCCEEDED(Connection.GetSettings(&Settings));
+        TEST_EQUAL(QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC, Settings.CongestionControlAlgorithm);
+    }
+
+    {
+        TestScopeLogger logScope("LEDBAT");
+        MsQuicSettings ClientSettings;
+        ClientSettings.SetCongestionControlAlgorithm(QUIC_CONGESTION_CONTROL_ALGORITHM_LEDBAT);
+        MsQuicConfiguration ClientConfiguration(Registration, "MsQuicTest", ClientSettings, MsQuicCredentialConfig());
+        TEST_QUIC_SUCCEEDED(ClientConfiguration.GetInitStatus());
+
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        TEST_QUIC_SUCCEEDED(Connection.Start(ClientConfiguration, QuicAddrFamily, QUIC_TEST_LOOPBACK_FOR_AF(QuicAddrFamily), ServerLocalAddr.GetPort()));
+        TEST_TRUE(Connection.HandshakeCompleteEvent.WaitTimeout(TestWaitTimeout));
+        TEST_TRUE(Connection.HandshakeComplete);
+
+        MsQuicSettings Settings;
+        TEST_QUIC_SUCCEEDED(Connection.GetSettings(&Settings));
+        TEST_EQUAL(QUIC_CONGESTION_CONTROL_ALGORITHM_LEDBAT, Settings.CongestionControlAlgorithm);
+    }
+}
+#endif
+
 struct SlowRecvTestContext {
     CxPlatEvent ServerStreamRecv;
     CxPlatEvent ServerStreamShutdown;
@@ -4483,3 +4645,307 @@ QuicTestStreamMultiReceive(
     }
 }
 #endif // QUIC_API_ENABLE_PREVIEW_FEATURES
+
+struct SendBatchTestContext {
+    static const uint32_t StreamCount = 8;
+    static const uint32_t SendLength = 100;
+    CxPlatEvent AllReceived;
+    CxPlatEvent AllSendsComplete;
+    long ServerStreamsFinished {0};
+    int64_t ServerBytesReceived {0};
+    long ClientSendsComplete {0};
+    long ClientSendsCanceled {0};
+
+    static QUIC_STATUS ServerStreamCallback(_In_ MsQuicStream*, _In_opt_ void* Context, _Inout_ QUIC_STREAM_EVENT* Event) {
+        auto TestContext = (SendBatchTestContext*)Context;
+        if (Event->Type == QUIC_STREAM_EVENT_RECEIVE) {
+            InterlockedExchangeAdd64(&TestContext->ServerBytesReceived, (int64_t)Event->RECEIVE.TotalBufferLength);
+        } else if (Event->Type == QUIC_STREAM_EVENT_PEER_SEND_SHUTDOWN) {
+            if (InterlockedIncrement(&TestContext->ServerStreamsFinished) == (long)StreamCount) {
+                TestContext->AllReceived.Set();
+            }
+        }
+        return QUIC_STATUS_SUCCESS;
+    }
+
+    static QUIC_STATUS ServerConnCallback(_In_ MsQuicConnection*, _In_opt_ void* Context, _Inout_ QUIC_CONNECTION_EVENT* Event) {
+        if (Event->Type == QUIC_CONNECTION_EVENT_PEER_STREAM_STARTED) {
+            new(std::nothrow) MsQuicStream(Event->PEER_STREAM_STARTED.Stream, CleanUpAutoDelete, ServerStreamCallback, Context);
+        }
+        return QUIC_STATUS_SUCCESS;
+    }
+
+    static QUIC_STATUS ClientStreamCallback(_In_ MsQuicStream*, _In_opt_ void* Context, _Inout_ QUIC_STREAM_EVENT* Event) {
+        auto TestContext = (SendBatchTestContext*)Context;
+        if (Event->Type == QUIC_STREAM_EVENT_SEND_COMPLETE) {
+            if (Event->SEND_COMPLETE.Canceled) {
+                InterlockedIncrement(&TestContext->ClientSendsCanceled);
+            }
+            if (InterlockedIncrement(&TestContext->ClientSendsComplete) == (long)(2 * StreamCount)) {
+                TestContext->AllSendsComplete.Set();
+            }
+        }
+        return QUIC_STATUS_SUCCESS;
+    }
+};
+
+void
+QuicTestConnectionSendBatch(
+    )
+{
+    const uint32_t StreamCount = SendBatchTestContext::StreamCount;
+
+    MsQuicRegistration Registration(true);
+    TEST_QUIC_SUCCEEDED(Registration.GetInitStatus());
+
+    MsQuicConfiguration ServerConfiguration(Registration, "MsQuicTest", MsQuicSettings().SetPeerUnidiStreamCount(StreamCount), ServerSelfSignedCredConfig);
+    TEST_QUIC_SUCCEEDED(ServerConfiguration.GetInitStatus());
+
+    MsQuicConfiguration ClientConfiguration(Registration, "MsQuicTest", MsQuicCredentialConfig());
+    TEST_QUIC_SUCCEEDED(ClientConfiguration.GetInitStatus());
+
+    SendBatchTestContext Context;
+    MsQuicAutoAcceptListener Listener(Registration, ServerConfiguration, SendBatchTestContext::ServerConnCallback, &Context);
+    TEST_QUIC_SUCCEEDED(Listener.GetInitStatus());
+    TEST_QUIC_SUCCEEDED(Listener.Start("MsQuicTest"));
+    QuicAddr ServerLocalAddr;
+    TEST_QUIC_SUCCEEDED(Listener.GetLocalAddr(ServerLocalAddr));
+
+    MsQuicConnection Connection(Registration);
+    TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+    TEST_QUIC_SUCCEEDED(Connection.Start(ClientConfiguration, ServerLocalAddr.GetFamily(), QUIC_TEST_LOOPBACK_FOR_AF(ServerLocalAddr.GetFamily()), ServerLocalAddr.GetPort()));
+    TEST_TRUE(Connection.HandshakeCompleteEvent.WaitTimeout(TestWaitTimeout));
+    TEST_TRUE(Connection.HandshakeComplete);
+
+    UniquePtr<MsQuicStream> Streams[StreamCount];
+    for (uint32_t i = 0; i < StreamCount; ++i) {
+        Streams[i].reset(new(std::nothrow) MsQuicStream(Connection, QUIC_STREAM_OPEN_FLAG_UNIDIRECTIONAL, CleanUpManual, SendBatchTestContext::ClientStreamCallback, &Context));
+        TEST_NOT_EQUAL(nullptr, Streams[i].get());
+        TEST_QUIC_SUCCEEDED(Streams[i]->GetInitStatus());
+    }
+
+    uint8_t RawBuffer[SendBatchTestContext::SendLength];
+    CxPlatZeroMemory(RawBuffer, sizeof(RawBuffer));
+    QUIC_BUFFER Buffer { sizeof(RawBuffer), RawBuffer };
+
+    {
+        TestScopeLogger LogScope("Invalid parameters");
+        QUIC_SEND_BATCH_ENTRY Entry;
+        CxPlatZeroMemory(&Entry, sizeof(Entry));
+        Entry.Stream = Streams[0]->Handle;
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            MsQuic->ConnectionSendBatch(nullptr, &Entry, 1));
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            MsQuic->ConnectionSendBatch(Connection, nullptr, 1));
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            MsQuic->ConnectionSendBatch(Connection, &Entry, 0));
+
+        Entry.BufferCount = 1; // Buffers is NULL.
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            MsQuic->ConnectionSendBatch(Connection, &Entry, 1));
+        TEST_EQUAL(QUIC_STATUS_INVALID_PARAMETER, Entry.Status);
+
+        Entry.Stream = Connection.Handle; // Not a stream.
+        Entry.Buffers = &Buffer;
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            MsQuic->ConnectionSendBatch(Connection, &Entry, 1));
+        TEST_EQUAL(QUIC_STATUS_INVALID_PARAMETER, Entry.Status);
+    }
+
+    {
+        TestScopeLogger LogScope("Send on all streams");
+        //
+        // Start, send and FIN every stream, with the two sends of each stream
+        // split across the batch. One extra invalid entry in the middle must
+        // not prevent the others from being queued.
+        //
+        QUIC_SEND_BATCH_ENTRY Entries[2 * StreamCount + 1];
+        CxPlatZeroMemory(Entries, sizeof(Entries));
+        for (uint32_t i = 0; i < StreamCount; ++i) {
+            Entries[i].Stream = Streams[i]->Handle;
+            Entries[i].Buffers = &Buffer;
+            Entries[i].BufferCount = 1;
+            Entries[i].Flags = QUIC_SEND_FLAG_START;
+            Entries[StreamCount + 1 + i].Stream = Streams[i]->Handle;
+            Entries[StreamCount + 1 + i].Buffers = &Buffer;
+            Entries[StreamCount + 1 + i].BufferCount = 1;
+            Entries[StreamCount + 1 + i].Flags = QUIC_SEND_FLAG_FIN;
+        }
+        Entries[StreamCount].Stream = Streams[0]->Handle;
+        Entries[StreamCount].BufferCount = 1; // Buffers is NULL.
+
+        TEST_QUIC_STATUS(
+            QUIC_STATUS_INVALID_PARAMETER,
+            MsQuic->ConnectionSendBatch(Connection, Entries, ARRAYSIZE(Entries)));
+        for (uint32_t i = 0; i < ARRAYSIZE(Entries); ++i) {
+            const QUIC_STATUS Expected =
+                (i == StreamCount) ? QUIC_STATUS_INVALID_PARAMETER : QUIC_STATUS_PENDING;
+            TEST_EQUAL(Expected, Entries[i].Status);
+        }
+
+        TEST_TRUE(Context.AllReceived.WaitTimeout(TestWaitTimeout));
+        TEST_TRUE(Context.AllSendsComplete.WaitTimeout(TestWaitTimeout));
+        TEST_EQUAL((int64_t)(2 * StreamCount * sizeof(RawBuffer)), Context.ServerBytesReceived);
+        TEST_EQUAL(0, Context.ClientSendsCanceled);
+    }
+}
+
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+//
+// A fixed window controller, counting how often each callback is invoked.
+//
+struct AppCcTestContext {
+    static const uint32_t CongestionWindow = 20000;
+    static const uint32_t SendLength = 1000000;
+
+    struct State {
+        uint32_t CongestionWindow;
+    };
+
+    CxPlatEvent AllReceived;
+    int64_t ServerBytesReceived {0};
+    long ResetCount {0};
+    long DataSentCount {0};
+    long DataAckedCount {0};
+    long DeliveryRateCount {0};
+    long RttSampleCount {0};
+    uint32_t MaxBytesInFlight {0};
+
+    static void QUIC_API Reset(void* Context, void* StateBuffer, const QUIC_CONGESTION_CONTROL_RESET_INFO* Info) {
+        auto TestContext = (AppCcTestContext*)Context;
+        auto CcState = (State*)StateBuffer;
+        if (Info->FullReset) {
+            InterlockedIncrement(&TestContext->ResetCount);
+        }
+        CcState->CongestionWindow = AppCcTestContext::CongestionWindow;
+    }
+
+    static void QUIC_API OnDataSent(void* Context, void*, uint32_t, uint32_t BytesInFlight) {
+        auto TestContext = (AppCcTestContext*)Context;
+        InterlockedIncrement(&TestContext->DataSentCount);
+        if (BytesInFlight > TestContext->MaxBytesInFlight) {
+            TestContext->MaxBytesInFlight = BytesInFlight;
+        }
+    }
+
+    static void QUIC_API OnDataAcknowledged(void* Context, void*, const QUIC_CONGESTION_CONTROL_ACK_INFO* Info) {
+        auto TestContext = (AppCcTestContext*)Context;
+        InterlockedIncrement(&TestContext->DataAckedCount);
+        if (Info->DeliveryRateValid && Info->DeliveryRate != 0) {
+            InterlockedIncrement(&TestContext->DeliveryRateCount);
+        }
+        if (Info->RttSampleValid) {
+            InterlockedIncrement(&TestContext->RttSampleCount);
+        }
+    }
+
+    static void QUIC_API OnDataLost(void*, void*, const QUIC_CONGESTION_CONTROL_LOSS_INFO*) { }
+
+    static uint32_t QUIC_API GetCongestionWindow(void*, const void* StateBuffer) {
+        return ((const State*)StateBuffer)->CongestionWindow;
+    }
+
+    static QUIC_STATUS ServerStreamCallback(_In_ MsQuicStream*, _In_opt_ void* Context, _Inout_ QUIC_STREAM_EVENT* Event) {
+        auto TestContext = (AppCcTestContext*)Context;
+        if (Event->Type == QUIC_STREAM_EVENT_RECEIVE) {
+            InterlockedExchangeAdd64(&TestContext->ServerBytesReceived, (int64_t)Event->RECEIVE.TotalBufferLength);
+        } else if (Event->Type == QUIC_STREAM_EVENT_PEER_SEND_SHUTDOWN) {
+            TestContext->AllReceived.Set();
+        }
+        return QUIC_STATUS_SUCCESS;
+    }
+
+    static QUIC_STATUS ServerConnCallback(_In_ MsQuicConnection*, _In_opt_ void* Context, _Inout_ QUIC_CONNECTION_EVENT* Event) {
+        if (Event->Type == QUIC_CONNECTION_EVENT_PEER_STREAM_STARTED) {
+            new(std::nothrow) MsQuicStream(Event->PEER_STREAM_STARTED.Stream, CleanUpAutoDelete, ServerStreamCallback, Context);
+        }
+        return QUIC_STATUS_SUCCESS;
+    }
+};
+
+void
+QuicTestAppCongestionControl(
+    )
+{
+    MsQuicRegistration Registration(true);
+    TEST_QUIC_SUCCEEDED(Registration.GetInitStatus());
+
+    MsQuicConfiguration ServerConfiguration(Registration, "MsQuicTest", MsQuicSettings().SetPeerUnidiStreamCount(1), ServerSelfSignedCredConfig);
+    TEST_QUIC_SUCCEEDED(ServerConfiguration.GetInitStatus());
+
+    AppCcTestContext Context;
+
+    QUIC_CONGESTION_CONTROL_CALLBACKS Callbacks;
+    CxPlatZeroMemory(&Callbacks, sizeof(Callbacks));
+    Callbacks.Version = QUIC_CONGESTION_CONTROL_CALLBACKS_VERSION;
+    Callbacks.StateSize = sizeof(AppCcTestContext::State);
+    Callbacks.Context = &Context;
+    Callbacks.Reset = AppCcTestContext::Reset;
+    Callbacks.OnDataSent = AppCcTestContext::OnDataSent;
+    Callbacks.OnDataAcknowledged = AppCcTestContext::OnDataAcknowledged;
+    Callbacks.OnDataLost = AppCcTestContext::OnDataLost;
+    Callbacks.GetCongestionWindow = AppCcTestContext::GetCongestionWindow;
+
+    MsQuicConfiguration ClientConfiguration(Registration, "MsQuicTest", MsQuicCredentialConfig());
+    TEST_QUIC_SUCCEEDED(ClientConfiguration.GetInitStatus());
+    TEST_QUIC_SUCCEEDED(
+        MsQuic->SetParam(
+            ClientConfiguration,
+            QUIC_PARAM_CONFIGURATION_CONGESTION_CONTROL,
+            sizeof(Callbacks),
+            &Callbacks));
+
+    MsQuicAutoAcceptListener Listener(Registration, ServerConfiguration, AppCcTestContext::ServerConnCallback, &Context);
+    TEST_QUIC_SUCCEEDED(Listener.GetInitStatus());
+    TEST_QUIC_SUCCEEDED(Listener.Start("MsQuicTest"));
+    QuicAddr ServerLocalAddr;
+    TEST_QUIC_SUCCEEDED(Listener.GetLocalAddr(ServerLocalAddr));
+
+    UniquePtr<uint8_t[]> RawBuffer(new(std::nothrow) uint8_t[AppCcTestContext::SendLength]);
+    TEST_NOT_EQUAL(nullptr, RawBuffer.get());
+    CxPlatZeroMemory(RawBuffer.get(), AppCcTestContext::SendLength);
+    QUIC_BUFFER Buffer { AppCcTestContext::SendLength, RawBuffer.get() };
+
+    {
+        //
+        // Closing the connection waits for it to shut down, so no callbacks
+        // run after this scope.
+        //
+        MsQuicConnection Connection(Registration);
+        TEST_QUIC_SUCCEEDED(Connection.GetInitStatus());
+        TEST_QUIC_SUCCEEDED(Connection.Start(ClientConfiguration, ServerLocalAddr.GetFamily(), QUIC_TEST_LOOPBACK_FOR_AF(ServerLocalAddr.GetFamily()), ServerLocalAddr.GetPort()));
+        TEST_TRUE(Connection.HandshakeCompleteEvent.WaitTimeout(TestWaitTimeout));
+        TEST_TRUE(Connection.HandshakeComplete);
+
+        MsQuicStream Stream(Connection, QUIC_STREAM_OPEN_FLAG_UNIDIRECTIONAL);
+        TEST_QUIC_SUCCEEDED(Stream.GetInitStatus());
+
+        TEST_QUIC_SUCCEEDED(Stream.Send(&Buffer, 1, QUIC_SEND_FLAG_START | QUIC_SEND_FLAG_FIN));
+
+        TEST_TRUE(Context.AllReceived.WaitTimeout(TestWaitTimeout));
+        TEST_EQUAL((int64_t)AppCcTestContext::SendLength, Context.ServerBytesReceived);
+    }
+
+    //
+    // The server uses the built-in algorithm, so every callback came from the
+    // single client connection.
+    //
+    TEST_EQUAL(1, Context.ResetCount);
+    TEST_NOT_EQUAL(0, Context.DataSentCount);
+    TEST_NOT_EQUAL(0, Context.DataAckedCount);
+    TEST_NOT_EQUAL(0, Context.RttSampleCount);
+    TEST_NOT_EQUAL(0, Context.DeliveryRateCount);
+
+    //
+    // The window must be enforced. Sends are only checked against the window
+    // before each packet, so allow for a packet of overshoot plus a couple of
+    // exempted probe packets.
+    //
+    TEST_TRUE(Context.MaxBytesInFlight < AppCcTestContext::CongestionWindow + 3 * 1500);
+}
+#endif // QUIC_API_ENABLE_PREVIEW_FEATURES
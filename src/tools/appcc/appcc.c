@@ -0,0 +1,904 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Reference application provided congestion controller.
+
+    The quicappcc app implements a simple upload protocol (ALPN "appcc") where
+    the client connects to the server, opens a single bidirectional stream,
+    sends a configurable amount of data and shuts down the stream. The server
+    discards everything it receives.
+
+    Unless -builtin is passed, the client registers a NewReno style AIMD
+    congestion controller on its configuration via
+    QUIC_PARAM_CONFIGURATION_CONGESTION_CONTROL. The controller keeps all of
+    its per connection state in the buffer MsQuic reserves for it, and only
+    uses the configuration wide context for statistics. Once the upload
+    completes, the client prints how often each callback was invoked along
+    with the connection statistics, so it can be compared with the built-in
+    algorithms.
+
+    The server needs a certificate, the same way as quicsample does.
+
+--*/
+
+#define _CRT_SECURE_NO_WARNINGS 1
+#define QUIC_API_ENABLE_PREVIEW_FEATURES 1
+
+#ifdef _WIN32
+//
+// The conformant preprocessor along with the newest SDK throws this warning for
+// a macro in C mode. As users might run into this exact bug, exclude this
+// warning here. This is not an MsQuic bug but a Windows SDK bug.
+//
+#pragma warning(disable:5105)
+#endif
+#include "msquic.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef UNREFERENCED_PARAMETER
+#define UNREFERENCED_PARAMETER(P) (void)(P)
+#endif
+
+const QUIC_REGISTRATION_CONFIG RegConfig = { "quicappcc", QUIC_EXECUTION_PROFILE_LOW_LATENCY };
+
+const QUIC_BUFFER Alpn = { sizeof("appcc") - 1, (uint8_t*)"appcc" };
+
+const uint16_t UdpPort = 4568;
+
+const uint64_t IdleTimeoutMs = 5000;
+
+//
+// The default number of bytes uploaded by the client.
+//
+const uint64_t DefaultUploadLength = 10 * 1000 * 1000;
+
+const QUIC_API_TABLE* MsQuic;
+
+HQUIC Registration;
+
+HQUIC Configuration;
+
+//
+// The minimum congestion window, in packets.
+//
+#define RENO_MIN_WINDOW_PACKETS 2
+
+//
+// The per connection state of the controller. Its size is passed as StateSize,
+// so MsQuic zeroes it in each connection before the first Reset call.
+//
+typedef struct RENO_STATE {
+
+    uint32_t CongestionWindow;      // bytes
+    uint32_t SlowStartThreshold;    // bytes
+
+    //
+    // The window before the last congestion event, restored if the loss turns
+    // out to be spurious.
+    //
+    uint32_t PrevCongestionWindow;
+    uint32_t PrevSlowStartThreshold;
+
+    //
+    // Bytes acknowledged since the window last grew in congestion avoidance.
+    //
+    uint32_t AckedBytesAccumulator;
+
+    uint16_t DatagramPayloadLength;
+
+    BOOLEAN InRecovery;
+
+    //
+    // Recovery ends once a packet sent after this one is acknowledged.
+    //
+    uint64_t RecoveryEndPacketNumber;
+
+    uint64_t SmoothedRtt;           // microseconds
+
+} RENO_STATE;
+
+//
+// Configuration wide statistics, passed to each callback as its context. The
+// client only ever has one connection, so no synchronization is needed.
+//
+typedef struct RENO_STATS {
+    uint64_t ResetCount;
+    uint64_t SentCount;
+    uint64_t AckedCount;
+    uint64_t LostCount;
+    uint64_t EcnCount;
+    uint64_t SpuriousCount;
+    uint64_t MaxCongestionWindow;
+    uint64_t MaxDeliveryRate;       // bytes per second
+} RENO_STATS;
+
+RENO_STATS RenoStats;
+
+void
+RenoOnCongestionEvent(
+    _Inout_ RENO_STATE* Reno,
+    _In_ uint64_t LargestSentPacketNumber,
+    _In_ BOOLEAN PersistentCongestion
+    )
+{
+    const uint32_t MinWindow = Reno->DatagramPayloadLength * RENO_MIN_WINDOW_PACKETS;
+
+    Reno->PrevCongestionWindow = Reno->CongestionWindow;
+    Reno->PrevSlowStartThreshold = Reno->SlowStartThreshold;
+    Reno->InRecovery = TRUE;
+    Reno->RecoveryEndPacketNumber = LargestSentPacketNumber;
+    Reno->AckedBytesAccumulator = 0;
+
+    Reno->SlowStartThreshold = Reno->CongestionWindow / 2;
+    if (Reno->SlowStartThreshold < MinWindow) {
+        Reno->SlowStartThreshold = MinWindow;
+    }
+    Reno->CongestionWindow =
+        PersistentCongestion ? MinWindow : Reno->SlowStartThreshold;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QUIC_API
+RenoReset(
+    _In_opt_ void* Context,
+    _Inout_ void* State,
+    _In_ const QUIC_CONGESTION_CONTROL_RESET_INFO* Info
+    )
+{
+    RENO_STATS* Stats = (RENO_STATS*)Context;
+    RENO_STATE* Reno = (RENO_STATE*)State;
+
+    Stats->ResetCount++;
+    if (Info->FullReset) {
+        memset(Reno, 0, sizeof(*Reno));
+    }
+    Reno->DatagramPayloadLength = Info->DatagramPayloadLength;
+    Reno->CongestionWindow = Info->InitialWindowPackets * Info->DatagramPayloadLength;
+    Reno->SlowStartThreshold = UINT32_MAX;
+    Reno->AckedBytesAccumulator = 0;
+    Reno->InRecovery = FALSE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QUIC_API
+RenoOnDataSent(
+    _In_opt_ void* Context,
+    _Inout_ void* State,
+    _In_ uint32_t SentBytes,
+    _In_ uint32_t BytesInFlight
+    )
+{
+    UNREFERENCED_PARAMETER(State);
+    UNREFERENCED_PARAMETER(SentBytes);
+    UNREFERENCED_PARAMETER(BytesInFlight);
+    ((RENO_STATS*)Context)->SentCount++;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QUIC_API
+RenoOnDataAcknowledged(
+    _In_opt_ void* Context,
+    _Inout_ void* State,
+    _In_ const QUIC_CONGESTION_CONTROL_ACK_INFO* Info
+    )
+{
+    RENO_STATS* Stats = (RENO_STATS*)Context;
+    RENO_STATE* Reno = (RENO_STATE*)State;
+
+    Stats->AckedCount++;
+    if (Info->DeliveryRateValid && Info->DeliveryRate > Stats->MaxDeliveryRate) {
+        Stats->MaxDeliveryRate = Info->DeliveryRate;
+    }
+
+    Reno->SmoothedRtt = Info->SmoothedRtt;
+    Reno->DatagramPayloadLength = Info->DatagramPayloadLength;
+
+    if (Reno->InRecovery) {
+        if (Info->LargestAck <= Reno->RecoveryEndPacketNumber) {
+            return;
+        }
+        Reno->InRecovery = FALSE;
+    }
+
+    if (Info->AckedBytes == 0 || Info->IsAppLimited) {
+        //
+        // Don't grow the window without evidence the network can take it.
+        //
+        return;
+    }
+
+    if (Reno->CongestionWindow < Reno->SlowStartThreshold) {
+        Reno->CongestionWindow += Info->AckedBytes;
+    } else {
+        Reno->AckedBytesAccumulator += Info->AckedBytes;
+        if (Reno->AckedBytesAccumulator >= Reno->CongestionWindow) {
+            Reno->AckedBytesAccumulator -= Reno->CongestionWindow;
+            Reno->CongestionWindow += Reno->DatagramPayloadLength;
+        }
+    }
+
+    if (Reno->CongestionWindow > Stats->MaxCongestionWindow) {
+        Stats->MaxCongestionWindow = Reno->CongestionWindow;
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QUIC_API
+RenoOnDataLost(
+    _In_opt_ void* Context,
+    _Inout_ void* State,
+    _In_ const QUIC_CONGESTION_CONTROL_LOSS_INFO* Info
+    )
+{
+    RENO_STATS* Stats = (RENO_STATS*)Context;
+    RENO_STATE* Reno = (RENO_STATE*)State;
+
+    Stats->LostCount++;
+
+    //
+    // Only back off once per round trip, unless this is persistent congestion.
+    //
+    if (!Reno->InRecovery ||
+        Info->LargestPacketNumberLost > Reno->RecoveryEndPacketNumber ||
+        Info->PersistentCongestion) {
+        RenoOnCongestionEvent(
+            Reno, Info->LargestSentPacketNumber, Info->PersistentCongestion);
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QUIC_API
+RenoOnEcn(
+    _In_opt_ void* Context,
+    _Inout_ void* State,
+    _In_ const QUIC_CONGESTION_CONTROL_ECN_INFO* Info
+    )
+{
+    RENO_STATS* Stats = (RENO_STATS*)Context;
+    RENO_STATE* Reno = (RENO_STATE*)State;
+
+    Stats->EcnCount++;
+    if (!Reno->InRecovery ||
+        Info->LargestPacketNumberAcked > Reno->RecoveryEndPacketNumber) {
+        RenoOnCongestionEvent(Reno, Info->LargestSentPacketNumber, FALSE);
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QUIC_API
+RenoOnSpuriousLoss(
+    _In_opt_ void* Context,
+    _Inout_ void* State
+    )
+{
+    RENO_STATS* Stats = (RENO_STATS*)Context;
+    RENO_STATE* Reno = (RENO_STATE*)State;
+
+    if (!Reno->InRecovery) {
+        return FALSE;
+    }
+
+    Stats->SpuriousCount++;
+    Reno->CongestionWindow = Reno->PrevCongestionWindow;
+    Reno->SlowStartThreshold = Reno->PrevSlowStartThreshold;
+    Reno->InRecovery = FALSE;
+    return TRUE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+QUIC_API
+RenoGetCongestionWindow(
+    _In_opt_ void* Context,
+    _In_ const void* State
+    )
+{
+    UNREFERENCED_PARAMETER(Context);
+    return ((const RENO_STATE*)State)->CongestionWindow;
+}
+
+//
+// Spread the window over the RTT. Like MsQuic's CUBIC, use the window expected
+// in the next round trip so pacing doesn't slow down the window growth: double
+// in slow start and 25% more in congestion avoidance.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+QUIC_API
+RenoGetPacingRate(
+    _In_opt_ void* Context,
+    _In_ const void* State
+    )
+{
+    UNREFERENCED_PARAMETER(Context);
+    const RENO_STATE* Reno = (const RENO_STATE*)State;
+    if (Reno->SmoothedRtt == 0) {
+        return 0;
+    }
+
+    uint64_t EstimatedWindow;
+    if (Reno->CongestionWindow < Reno->SlowStartThreshold) {
+        EstimatedWindow = (uint64_t)Reno->CongestionWindow * 2;
+        if (EstimatedWindow > Reno->SlowStartThreshold) {
+            EstimatedWindow = Reno->SlowStartThreshold;
+        }
+    } else {
+        EstimatedWindow = Reno->CongestionWindow + (Reno->CongestionWindow >> 2);
+    }
+    return EstimatedWindow * 1000000 / Reno->SmoothedRtt;
+}
+
+const QUIC_CONGESTION_CONTROL_CALLBACKS RenoCallbacks = {
+    QUIC_CONGESTION_CONTROL_CALLBACKS_VERSION,
+    sizeof(RENO_STATE),
+    &RenoStats,
+    RenoReset,
+    RenoOnDataSent,
+    RenoOnDataAcknowledged,
+    RenoOnDataLost,
+    RenoOnEcn,
+    RenoOnSpuriousLoss,
+    RenoGetCongestionWindow,
+    RenoGetPacingRate
+};
+
+void PrintUsage()
+{
+    printf(
+        "\n"
+        "quicappcc uploads data using an application provided congestion controller.\n"
+        "\n"
+        "Usage:\n"
+        "\n"
+        "  quicappcc -client -unsecure -target:{IPAddress|Hostname} [-upload:<bytes>] [-builtin]\n"
+        "  quicappcc -server -cert_hash:<...>\n"
+        "  quicappcc -server -cert_file:<...> -key_file:<...> [-password:<...>]\n"
+        );
+}
+
+BOOLEAN
+GetFlag(
+    _In_ int argc,
+    _In_reads_(argc) _Null_terminated_ char* argv[],
+    _In_z_ const char* name
+    )
+{
+    const size_t nameLen = strlen(name);
+    for (int i = 0; i < argc; i++) {
+        if (_strnicmp(argv[i] + 1, name, nameLen) == 0
+            && strlen(argv[i]) == nameLen + 1) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+_Ret_maybenull_ _Null_terminated_ const char*
+GetValue(
+    _In_ int argc,
+    _In_reads_(argc) _Null_terminated_ char* argv[],
+    _In_z_ const char* name
+    )
+{
+    const size_t nameLen = strlen(name);
+    for (int i = 0; i < argc; i++) {
+        if (_strnicmp(argv[i] + 1, name, nameLen) == 0
+            && strlen(argv[i]) > 1 + nameLen + 1
+            && *(argv[i] + 1 + nameLen) == ':') {
+            return argv[i] + 1 + nameLen + 1;
+        }
+    }
+    return NULL;
+}
+
+uint8_t
+DecodeHexChar(
+    _In_ char c
+    )
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return 10 + c - 'A';
+    if (c >= 'a' && c <= 'f') return 10 + c - 'a';
+    return 0;
+}
+
+uint32_t
+DecodeHexBuffer(
+    _In_z_ const char* HexBuffer,
+    _In_ uint32_t OutBufferLen,
+    _Out_writes_to_(OutBufferLen, return)
+        uint8_t* OutBuffer
+    )
+{
+    uint32_t HexBufferLen = (uint32_t)strlen(HexBuffer) / 2;
+    if (HexBufferLen > OutBufferLen) {
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < HexBufferLen; i++) {
+        OutBuffer[i] =
+            (DecodeHexChar(HexBuffer[i * 2]) << 4) |
+            DecodeHexChar(HexBuffer[i * 2 + 1]);
+    }
+
+    return HexBufferLen;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Function_class_(QUIC_STREAM_CALLBACK)
+QUIC_STATUS
+QUIC_API
+ServerStreamCallback(
+    _In_ HQUIC Stream,
+    _In_opt_ void* Context,
+    _Inout_ QUIC_STREAM_EVENT* Event
+    )
+{
+    UNREFERENCED_PARAMETER(Context);
+    switch (Event->Type) {
+    case QUIC_STREAM_EVENT_PEER_SEND_SHUTDOWN:
+        MsQuic->StreamShutdown(Stream, QUIC_STREAM_SHUTDOWN_FLAG_GRACEFUL, 0);
+        break;
+    case QUIC_STREAM_EVENT_PEER_SEND_ABORTED:
+        MsQuic->StreamShutdown(Stream, QUIC_STREAM_SHUTDOWN_FLAG_ABORT, 0);
+        break;
+    case QUIC_STREAM_EVENT_SHUTDOWN_COMPLETE:
+        MsQuic->StreamClose(Stream);
+        break;
+    default:
+        break;
+    }
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Function_class_(QUIC_CONNECTION_CALLBACK)
+QUIC_STATUS
+QUIC_API
+ServerConnectionCallback(
+    _In_ HQUIC Connection,
+    _In_opt_ void* Context,
+    _Inout_ QUIC_CONNECTION_EVENT* Event
+    )
+{
+    UNREFERENCED_PARAMETER(Context);
+    switch (Event->Type) {
+    case QUIC_CONNECTION_EVENT_CONNECTED:
+        printf("[conn][%p] Connected\n", Connection);
+        break;
+    case QUIC_CONNECTION_EVENT_SHUTDOWN_COMPLETE:
+        printf("[conn][%p] All done\n", Connection);
+        MsQuic->ConnectionClose(Connection);
+        break;
+    case QUIC_CONNECTION_EVENT_PEER_STREAM_STARTED:
+        MsQuic->SetCallbackHandler(Event->PEER_STREAM_STARTED.Stream, (void*)ServerStreamCallback, NULL);
+        break;
+    default:
+        break;
+    }
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Function_class_(QUIC_LISTENER_CALLBACK)
+QUIC_STATUS
+QUIC_API
+ServerListenerCallback(
+    _In_ HQUIC Listener,
+    _In_opt_ void* Context,
+    _Inout_ QUIC_LISTENER_EVENT* Event
+    )
+{
+    UNREFERENCED_PARAMETER(Listener);
+    UNREFERENCED_PARAMETER(Context);
+    QUIC_STATUS Status = QUIC_STATUS_NOT_SUPPORTED;
+    switch (Event->Type) {
+    case QUIC_LISTENER_EVENT_NEW_CONNECTION:
+        MsQuic->SetCallbackHandler(Event->NEW_CONNECTION.Connection, (void*)ServerConnectionCallback, NULL);
+        Status = MsQuic->ConnectionSetConfiguration(Event->NEW_CONNECTION.Connection, Configuration);
+        break;
+    default:
+        break;
+    }
+    return Status;
+}
+
+typedef struct QUIC_CREDENTIAL_CONFIG_HELPER {
+    QUIC_CREDENTIAL_CONFIG CredConfig;
+    union {
+        QUIC_CERTIFICATE_HASH CertHash;
+        QUIC_CERTIFICATE_FILE CertFile;
+        QUIC_CERTIFICATE_FILE_PROTECTED CertFileProtected;
+    };
+} QUIC_CREDENTIAL_CONFIG_HELPER;
+
+BOOLEAN
+ServerLoadConfiguration(
+    _In_ int argc,
+    _In_reads_(argc) _Null_terminated_ char* argv[]
+    )
+{
+    QUIC_SETTINGS Settings = {0};
+    Settings.IdleTimeoutMs = IdleTimeoutMs;
+    Settings.IsSet.IdleTimeoutMs = TRUE;
+    Settings.PeerBidiStreamCount = 1;
+    Settings.IsSet.PeerBidiStreamCount = TRUE;
+
+    QUIC_CREDENTIAL_CONFIG_HELPER Config;
+    memset(&Config, 0, sizeof(Config));
+    Config.CredConfig.Flags = QUIC_CREDENTIAL_FLAG_NONE;
+
+    const char* Cert;
+    const char* KeyFile;
+    if ((Cert = GetValue(argc, argv, "cert_hash")) != NULL) {
+        uint32_t CertHashLen =
+            DecodeHexBuffer(
+                Cert,
+                sizeof(Config.CertHash.ShaHash),
+                Config.CertHash.ShaHash);
+        if (CertHashLen != sizeof(Config.CertHash.ShaHash)) {
+            return FALSE;
+        }
+        Config.CredConfig.Type = QUIC_CREDENTIAL_TYPE_CERTIFICATE_HASH;
+        Config.CredConfig.CertificateHash = &Config.CertHash;
+
+    } else if ((Cert = GetValue(argc, argv, "cert_file")) != NULL &&
+               (KeyFile = GetValue(argc, argv, "key_file")) != NULL) {
+        const char* Password = GetValue(argc, argv, "password");
+        if (Password != NULL) {
+            Config.CertFileProtected.CertificateFile = (char*)Cert;
+            Config.CertFileProtected.PrivateKeyFile = (char*)KeyFile;
+            Config.CertFileProtected.PrivateKeyPassword = (char*)Password;
+            Config.CredConfig.Type = QUIC_CREDENTIAL_TYPE_CERTIFICATE_FILE_PROTECTED;
+            Config.CredConfig.CertificateFileProtected = &Config.CertFileProtected;
+        } else {
+            Config.CertFile.CertificateFile = (char*)Cert;
+            Config.CertFile.PrivateKeyFile = (char*)KeyFile;
+            Config.CredConfig.Type = QUIC_CREDENTIAL_TYPE_CERTIFICATE_FILE;
+            Config.CredConfig.CertificateFile = &Config.CertFile;
+        }
+
+    } else {
+        printf("Must specify ['-cert_hash'] or ['cert_file' and 'key_file' (and optionally 'password')]!\n");
+        return FALSE;
+    }
+
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    if (QUIC_FAILED(Status = MsQuic->ConfigurationOpen(Registration, &Alpn, 1, &Settings, sizeof(Settings), NULL, &Configuration))) {
+        printf("ConfigurationOpen failed, 0x%x!\n", Status);
+        return FALSE;
+    }
+
+    if (QUIC_FAILED(Status = MsQuic->ConfigurationLoadCredential(Configuration, &Config.CredConfig))) {
+        printf("ConfigurationLoadCredential failed, 0x%x!\n", Status);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+void
+RunServer(
+    _In_ int argc,
+    _In_reads_(argc) _Null_terminated_ char* argv[]
+    )
+{
+    QUIC_STATUS Status;
+    HQUIC Listener = NULL;
+
+    QUIC_ADDR Address = {0};
+    QuicAddrSetFamily(&Address, QUIC_ADDRESS_FAMILY_UNSPEC);
+    QuicAddrSetPort(&Address, UdpPort);
+
+    if (!ServerLoadConfiguration(argc, argv)) {
+        return;
+    }
+
+    if (QUIC_FAILED(Status = MsQuic->ListenerOpen(Registration, ServerListenerCallback, NULL, &Listener))) {
+        printf("ListenerOpen failed, 0x%x!\n", Status);
+        goto Error;
+    }
+
+    if (QUIC_FAILED(Status = MsQuic->ListenerStart(Listener, &Alpn, 1, &Address))) {
+        printf("ListenerStart failed, 0x%x!\n", Status);
+        goto Error;
+    }
+
+    printf("Press Enter to exit.\n\n");
+    getchar();
+
+Error:
+
+    if (Listener != NULL) {
+        MsQuic->ListenerClose(Listener);
+    }
+}
+
+void
+ClientPrintStatistics(
+    _In_ HQUIC Connection
+    )
+{
+    QUIC_STATISTICS_V2 Stats;
+    uint32_t StatsSize = sizeof(Stats);
+    QUIC_STATUS Status;
+    if (QUIC_FAILED(Status = MsQuic->GetParam(Connection, QUIC_PARAM_CONN_STATISTICS_V2, &StatsSize, &Stats))) {
+        printf("GetParam(QUIC_PARAM_CONN_STATISTICS_V2) failed, 0x%x!\n", Status);
+        return;
+    }
+
+    printf(
+        "Connection: Rtt=%u us MinRtt=%u us SentPackets=%llu LostPackets=%llu CongestionEvents=%u EcnCongestionEvents=%u\n",
+        Stats.Rtt,
+        Stats.MinRtt,
+        (unsigned long long)Stats.SendTotalPackets,
+        (unsigned long long)(Stats.SendSuspectedLostPackets - Stats.SendSpuriousLostPackets),
+        Stats.SendCongestionCount,
+        Stats.SendEcnCongestionCount);
+
+    if (RenoStats.ResetCount != 0) {
+        printf(
+            "Controller: Reset=%llu Sent=%llu Acked=%llu Lost=%llu Ecn=%llu Spurious=%llu MaxCwnd=%llu MaxDeliveryRate=%llu B/s\n",
+            (unsigned long long)RenoStats.ResetCount,
+            (unsigned long long)RenoStats.SentCount,
+            (unsigned long long)RenoStats.AckedCount,
+            (unsigned long long)RenoStats.LostCount,
+            (unsigned long long)RenoStats.EcnCount,
+            (unsigned long long)RenoStats.SpuriousCount,
+            (unsigned long long)RenoStats.MaxCongestionWindow,
+            (unsigned long long)RenoStats.MaxDeliveryRate);
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Function_class_(QUIC_STREAM_CALLBACK)
+QUIC_STATUS
+QUIC_API
+ClientStreamCallback(
+    _In_ HQUIC Stream,
+    _In_opt_ void* Context,
+    _Inout_ QUIC_STREAM_EVENT* Event
+    )
+{
+    HQUIC Connection = (HQUIC)Context;
+    switch (Event->Type) {
+    case QUIC_STREAM_EVENT_SEND_COMPLETE:
+        free(Event->SEND_COMPLETE.ClientContext);
+        printf("[strm][%p] Upload %s\n", Stream, Event->SEND_COMPLETE.Canceled ? "canceled" : "complete");
+        break;
+    case QUIC_STREAM_EVENT_SHUTDOWN_COMPLETE:
+        if (!Event->SHUTDOWN_COMPLETE.AppCloseInProgress) {
+            MsQuic->StreamClose(Stream);
+        }
+        MsQuic->ConnectionShutdown(Connection, QUIC_CONNECTION_SHUTDOWN_FLAG_NONE, 0);
+        break;
+    default:
+        break;
+    }
+    return QUIC_STATUS_SUCCESS;
+}
+
+void
+ClientSend(
+    _In_ HQUIC Connection,
+    _In_ uint32_t UploadLength
+    )
+{
+    QUIC_STATUS Status;
+    HQUIC Stream = NULL;
+    uint8_t* SendBufferRaw;
+    QUIC_BUFFER* SendBuffer;
+
+    if (QUIC_FAILED(Status = MsQuic->StreamOpen(Connection, QUIC_STREAM_OPEN_FLAG_NONE, ClientStreamCallback, Connection, &Stream))) {
+        printf("StreamOpen failed, 0x%x!\n", Status);
+        goto Error;
+    }
+
+    if (QUIC_FAILED(Status = MsQuic->StreamStart(Stream, QUIC_STREAM_START_FLAG_NONE))) {
+        printf("StreamStart failed, 0x%x!\n", Status);
+        MsQuic->StreamClose(Stream);
+        goto Error;
+    }
+
+    SendBufferRaw = (uint8_t*)malloc(sizeof(QUIC_BUFFER) + UploadLength);
+    if (SendBufferRaw == NULL) {
+        printf("SendBuffer allocation failed!\n");
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        goto Error;
+    }
+    SendBuffer = (QUIC_BUFFER*)SendBufferRaw;
+    SendBuffer->Buffer = SendBufferRaw + sizeof(QUIC_BUFFER);
+    SendBuffer->Length = UploadLength;
+    memset(SendBuffer->Buffer, 0, UploadLength);
+
+    printf("[strm][%p] Uploading %u bytes...\n", Stream, UploadLength);
+
+    if (QUIC_FAILED(Status = MsQuic->StreamSend(Stream, SendBuffer, 1, QUIC_SEND_FLAG_FIN, SendBuffer))) {
+        printf("StreamSend failed, 0x%x!\n", Status);
+        free(SendBufferRaw);
+        goto Error;
+    }
+
+Error:
+
+    if (QUIC_FAILED(Status)) {
+        MsQuic->ConnectionShutdown(Connection, QUIC_CONNECTION_SHUTDOWN_FLAG_NONE, 0);
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Function_class_(QUIC_CONNECTION_CALLBACK)
+QUIC_STATUS
+QUIC_API
+ClientConnectionCallback(
+    _In_ HQUIC Connection,
+    _In_opt_ void* Context,
+    _Inout_ QUIC_CONNECTION_EVENT* Event
+    )
+{
+    switch (Event->Type) {
+    case QUIC_CONNECTION_EVENT_CONNECTED:
+        printf("[conn][%p] Connected\n", Connection);
+        ClientSend(Connection, (uint32_t)(size_t)Context);
+        break;
+    case QUIC_CONNECTION_EVENT_SHUTDOWN_INITIATED_BY_TRANSPORT:
+        printf("[conn][%p] Shut down by transport, 0x%x\n", Connection, Event->SHUTDOWN_INITIATED_BY_TRANSPORT.Status);
+        break;
+    case QUIC_CONNECTION_EVENT_SHUTDOWN_COMPLETE:
+        ClientPrintStatistics(Connection);
+        if (!Event->SHUTDOWN_COMPLETE.AppCloseInProgress) {
+            MsQuic->ConnectionClose(Connection);
+        }
+        break;
+    default:
+        break;
+    }
+    return QUIC_STATUS_SUCCESS;
+}
+
+BOOLEAN
+ClientLoadConfiguration(
+    _In_ BOOLEAN Unsecure,
+    _In_ BOOLEAN Builtin
+    )
+{
+    QUIC_SETTINGS Settings = {0};
+    Settings.IdleTimeoutMs = IdleTimeoutMs;
+    Settings.IsSet.IdleTimeoutMs = TRUE;
+
+    QUIC_CREDENTIAL_CONFIG CredConfig;
+    memset(&CredConfig, 0, sizeof(CredConfig));
+    CredConfig.Type = QUIC_CREDENTIAL_TYPE_NONE;
+    CredConfig.Flags = QUIC_CREDENTIAL_FLAG_CLIENT;
+    if (Unsecure) {
+        CredConfig.Flags |= QUIC_CREDENTIAL_FLAG_NO_CERTIFICATE_VALIDATION;
+    }
+
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    if (QUIC_FAILED(Status = MsQuic->ConfigurationOpen(Registration, &Alpn, 1, &Settings, sizeof(Settings), NULL, &Configuration))) {
+        printf("ConfigurationOpen failed, 0x%x!\n", Status);
+        return FALSE;
+    }
+
+    //
+    // The controller must be registered before any connection is started with
+    // the configuration.
+    //
+    if (!Builtin &&
+        QUIC_FAILED(Status = MsQuic->SetParam(Configuration, QUIC_PARAM_CONFIGURATION_CONGESTION_CONTROL, sizeof(RenoCallbacks), &RenoCallbacks))) {
+        printf("SetParam(QUIC_PARAM_CONFIGURATION_CONGESTION_CONTROL) failed, 0x%x!\n", Status);
+        return FALSE;
+    }
+
+    if (QUIC_FAILED(Status = MsQuic->ConfigurationLoadCredential(Configuration, &CredConfig))) {
+        printf("ConfigurationLoadCredential failed, 0x%x!\n", Status);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+void
+RunClient(
+    _In_ int argc,
+    _In_reads_(argc) _Null_terminated_ char* argv[]
+    )
+{
+    if (!ClientLoadConfiguration(GetFlag(argc, argv, "unsecure"), GetFlag(argc, argv, "builtin"))) {
+        return;
+    }
+
+    QUIC_STATUS Status;
+    HQUIC Connection = NULL;
+
+    uint64_t UploadLength = DefaultUploadLength;
+    const char* UploadString = GetValue(argc, argv, "upload");
+    if (UploadString != NULL) {
+        UploadLength = strtoull(UploadString, NULL, 10);
+        if (UploadLength == 0 || UploadLength > UINT32_MAX - sizeof(QUIC_BUFFER)) {
+            printf("Invalid '-upload' argument!\n");
+            return;
+        }
+    }
+
+    if (QUIC_FAILED(Status = MsQuic->ConnectionOpen(Registration, ClientConnectionCallback, (void*)(size_t)UploadLength, &Connection))) {
+        printf("ConnectionOpen failed, 0x%x!\n", Status);
+        goto Error;
+    }
+
+    const char* Target;
+    if ((Target = GetValue(argc, argv, "target")) == NULL) {
+        printf("Must specify '-target' argument!\n");
+        Status = QUIC_STATUS_INVALID_PARAMETER;
+        goto Error;
+    }
+
+    printf("[conn][%p] Connecting...\n", Connection);
+
+    if (QUIC_FAILED(Status = MsQuic->ConnectionStart(Connection, Configuration, QUIC_ADDRESS_FAMILY_UNSPEC, Target, UdpPort))) {
+        printf("ConnectionStart failed, 0x%x!\n", Status);
+        goto Error;
+    }
+
+Error:
+
+    if (QUIC_FAILED(Status) && Connection != NULL) {
+        MsQuic->ConnectionClose(Connection);
+    }
+}
+
+int
+QUIC_MAIN_EXPORT
+main(
+    _In_ int argc,
+    _In_reads_(argc) _Null_terminated_ char* argv[]
+    )
+{
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+
+    if (QUIC_FAILED(Status = MsQuicOpen2(&MsQuic))) {
+        printf("MsQuicOpen2 failed, 0x%x!\n", Status);
+        goto Error;
+    }
+
+    if (QUIC_FAILED(Status = MsQuic->RegistrationOpen(&RegConfig, &Registration))) {
+        printf("RegistrationOpen failed, 0x%x!\n", Status);
+        goto Error;
+    }
+
+    if (GetFlag(argc, argv, "help") || GetFlag(argc, argv, "?")) {
+        PrintUsage();
+    } else if (GetFlag(argc, argv, "client")) {
+        RunClient(argc, argv);
+    } else if (GetFlag(argc, argv, "server")) {
+        RunServer(argc, argv);
+    } else {
+        PrintUsage();
+    }
+
+Error:
+
+    if (MsQuic != NULL) {
+        if (Configuration != NULL) {
+            MsQuic->ConfigurationClose(Configuration);
+        }
+        if (Registration != NULL) {
+            MsQuic->RegistrationClose(Registration);
+        }
+        MsQuicClose(MsQuic);
+    }
+
+    return (int)Status;
+}
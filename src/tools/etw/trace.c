@@ -311,6 +311,12 @@ QuicTraceGlobalEvent(
             case QUIC_PERF_COUNTER_CONN_LOAD_REJECT:
                 printf("    Total connections rejected due to worker load:      ");
                 break;
+            case QUIC_PERF_COUNTER_UDP_SEND_ZEROCOPY:
+                printf("    Total UDP send calls that didn't copy the payload:  ");
+                break;
+            case QUIC_PERF_COUNTER_UDP_SEND_ZEROCOPY_COPIED:
+                printf("    Total zero-copy UDP send calls that were copied:    ");
+                break;
             default:
                 printf("    Unknown:                                            ");
                 break;